@@ -96,12 +96,8 @@ capplet_model_remove_object(GtkTreeModel *model, GObject *object)
 {
 	GtkTreeIter iter;
 
-	if (capplet_model_find_object(model, object, &iter)) {
-		if (GTK_IS_LIST_STORE(model))
-			gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
-		else
-			gtk_tree_store_remove(GTK_TREE_STORE(model), &iter);
-	}
+	if (capplet_model_find_object(model, object, &iter))
+		capplet_model_remove_row(model, &iter);
 }
 
 void
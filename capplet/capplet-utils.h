@@ -157,6 +157,8 @@ void capplet_list_foreach_merge_to_tree_store(gpointer data, gpointer store);
 
 GList* capplet_model_to_list(GtkTreeModel *model);
 
+void capplet_model_remove_object(GtkTreeModel *model, GObject *object);
+
 /* Tree view, column and renderer */
 gboolean capplet_tree_view_expand_row(GtkTreeView *treeview,
     GtkTreeIter *iter,
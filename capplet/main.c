@@ -26,6 +26,7 @@
  */
 
 #include <stdlib.h>
+#include <signal.h>
 #include <gtk/gtk.h>
 #include <glib/gi18n.h>
 #include <libgnomeui/libgnomeui.h>
@@ -51,6 +52,7 @@ static gboolean     net_pref_view = FALSE;
 static gboolean     location_dialog = FALSE;
 static gboolean     wireless_chooser = FALSE;
 static gchar       *configure_interface = NULL;
+static gchar       *trace_file = NULL;
 
 #ifdef DEBUG_OPTS
 static gchar       *add_wireless_dialog = NULL;
@@ -66,6 +68,7 @@ GOptionEntry application_options[] = {
     { "wireless-chooser", NWAMUI_CAPPLET_OPT_WIFI_CHOOSER_DIALOG, 0, G_OPTION_ARG_NONE, &wireless_chooser, N_("Show 'Wireless Network Chooser' Dialog"), NULL },
     { "location-dialog", NWAMUI_CAPPLET_OPT_LOCATION_DIALOG, 0, G_OPTION_ARG_NONE, &location_dialog, N_("Show 'Location' Dialog"), NULL  },
     { "configure", 0, 0, G_OPTION_ARG_STRING, &configure_interface, N_("Configure a network interface"), NULL },
+    { "trace", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_FILENAME, &trace_file, N_("Write a Chrome trace of the hot paths to FILE on exit"), N_("FILE") },
 #ifdef DEBUG_OPTS
     { "add-wireless-dialog", 'w', 0, G_OPTION_ARG_STRING, &add_wireless_dialog, "Show 'Add Wireless' Dialog", "ESSID"},
     { "loc-pref-dialog", 'L', 0, G_OPTION_ARG_NONE, &loc_pref_dialog, "Show 'Location Preferences' Dialog", NULL  },
@@ -168,6 +171,12 @@ main(int argc, char** argv)
 
     nwamui_util_set_debug_mode( debug );
 
+    nwamui_log_install_dump_signal(SIGUSR1);
+
+    if ( trace_file ) {
+        nwamui_trace_start( trace_file );
+    }
+
     if (!nwamui_prof_check_ui_auth(nwamui_prof_get_instance_noref(), UI_AUTH_ALL)) {
         g_warning("User doesn't have the enough authorisations to run nwam-manager.");
         exit(0);
@@ -202,6 +211,19 @@ main(int argc, char** argv)
 
     glade_set_custom_handler(customwidgethandler, NULL);
 
+    /* Before anything creates the daemon: with the tray's snapshot only the
+     * active NCP and location are read up front, the dialogs show the rest
+     * as the snapshot has it until it is read.
+     */
+    {
+        nwamui_snapshot_t *snap = nwamui_snapshot_open(NULL);
+
+        if (snap != NULL) {
+            nwamui_daemon_set_staged_startup(TRUE, 0);
+            nwamui_daemon_set_startup_snapshot(snap);
+        }
+    }
+
     if( vpn_pref_dialog ) {
         capplet_dialog = NWAM_PREF_IFACE(nwam_vpn_pref_dialog_new());
         
@@ -282,7 +304,12 @@ main(int argc, char** argv)
  *
  *   gtk_main();
  */
-    
+
+    /* Any preference set since the main loop was last idle. */
+    nwamui_prof_commit(nwamui_prof_get_instance_noref());
+
+    nwamui_trace_stop();
+
     return (EXIT_SUCCESS);
 }
 
@@ -852,7 +852,7 @@ table_get_condition_ncu_list_model ()
     NwamuiDaemon   *daemon = nwamui_daemon_get_instance();
     NwamuiObject   *active_ncp = nwamui_daemon_get_active_ncp( daemon );
 
-	return (GTK_TREE_MODEL(nwamui_ncp_get_ncu_list_store(NWAMUI_NCP(active_ncp))));
+	return (nwamui_object_list_model_new_for_ncp(NWAMUI_NCP(active_ncp)));
 }
 
 extern GtkTreeModel *
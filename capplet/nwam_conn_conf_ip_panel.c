@@ -760,9 +760,25 @@ populate_panel( NwamConnConfIPPanel* self, gboolean set_initial_state )
     ipv6_prefix = nwamui_ncu_get_ipv6_prefix( NWAMUI_NCU(prv->ncu) );
     ipv6_default_route = nwamui_ncu_get_ipv6_default_route( NWAMUI_NCU(prv->ncu));
     
-    /* Update TreeView Models to be associated with NCU */
-	gtk_tree_view_set_model (prv->ipv4_tv, GTK_TREE_MODEL(nwamui_ncu_get_v4addresses(NWAMUI_NCU(prv->ncu))));
-	gtk_tree_view_set_model (prv->ipv6_tv, GTK_TREE_MODEL(nwamui_ncu_get_v6addresses(NWAMUI_NCU(prv->ncu))));
+    /* The address views edit their own stores, written back on apply */
+    {
+        GtkTreeModel    *model;
+        GList           *addrs;
+
+        model = GTK_TREE_MODEL(gtk_list_store_new(1, NWAMUI_TYPE_IP));
+        addrs = nwamui_ncu_get_v4addresses(NWAMUI_NCU(prv->ncu));
+        g_list_foreach(addrs, nwamui_util_foreach_nwam_object_add_to_list_store, (gpointer)model);
+        nwamui_util_free_obj_list(addrs);
+        gtk_tree_view_set_model (prv->ipv4_tv, model);
+        g_object_unref(model);
+
+        model = GTK_TREE_MODEL(gtk_list_store_new(1, NWAMUI_TYPE_IP));
+        addrs = nwamui_ncu_get_v6addresses(NWAMUI_NCU(prv->ncu));
+        g_list_foreach(addrs, nwamui_util_foreach_nwam_object_add_to_list_store, (gpointer)model);
+        nwamui_util_free_obj_list(addrs);
+        gtk_tree_view_set_model (prv->ipv6_tv, model);
+        g_object_unref(model);
+    }
 	
     if ( ncu_type == NWAMUI_NCU_TYPE_WIRELESS) {
         populate_wifi_fav( self, set_initial_state );
@@ -924,19 +940,36 @@ refresh(NwamPrefIFace *iface, gpointer user_data, gboolean force)
 }
 
 static gboolean
-cancel(NwamPrefIFace *iface, gpointer user_data)
+collect_ip_cb(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
 {
+    GList       **list = (GList**)data;
+    NwamuiIp     *ip = NULL;
+
+    gtk_tree_model_get(model, iter, 0, &ip, -1);
+    if (ip) {
+        *list = g_list_prepend(*list, ip);
+    }
+    return FALSE;
 }
 
+/*
+ * Write the rows of an address view back to the NCU; the NCU keeps its own
+ * list so the one built here is freed again.
+ */
 static void
-wifi_fav_set_prio_next( gpointer data, gpointer user_data)
+set_addresses_from_model(NwamuiNcu *ncu, GtkTreeModel *model, void (*setter)(NwamuiNcu*, GList*))
 {
-    NwamuiWifiNet  *wifi = NWAMUI_WIFI_NET(data);
-    guint64        *prio_p = (guint64*)user_data;
+    GList   *addrs = NULL;
 
-    nwamui_wifi_net_set_priority(wifi, *prio_p);
+    gtk_tree_model_foreach(model, collect_ip_cb, (gpointer)&addrs);
+    addrs = g_list_reverse(addrs);
+    setter(ncu, addrs);
+    nwamui_util_free_obj_list(addrs);
+}
 
-    *prio_p = *prio_p + 1;
+static gboolean
+cancel(NwamPrefIFace *iface, gpointer user_data)
+{
 }
 
 static gboolean
@@ -960,15 +993,17 @@ apply(NwamPrefIFace *iface, gpointer user_data)
     if ( ncu_type == NWAMUI_NCU_TYPE_WIRELESS) {
         GList*          fav_list;
         GtkTreeIter     iter;
-        guint64         prio = 0;
         
         wifi_info = nwamui_ncu_get_wifi_info( NWAMUI_NCU(prv->ncu) );
         
-        /* Populate WiFi Favourites */
+        /* Reprioritise WiFi Favourites, only the moved ones are committed. */
         model = GTK_TREE_MODEL( gtk_tree_view_get_model(GTK_TREE_VIEW(prv->wifi_fav_tv)));
         fav_list = capplet_model_to_list(model);
-        g_list_foreach( fav_list, wifi_fav_set_prio_next, &prio );
-        /* Commit daemon will commit fav wlan list on pref_dialog. */
+        if (!nwamui_known_wlan_reorder(fav_list)) {
+            nwamui_util_show_message (NULL, GTK_MESSAGE_ERROR, _("Commit Error"),
+              _("Failed to save the order of the wireless favourites."), TRUE );
+            rval = FALSE;
+        }
         if (fav_list) {
             nwamui_util_free_obj_list(fav_list);
         }
@@ -1013,6 +1048,8 @@ apply(NwamPrefIFace *iface, gpointer user_data)
                   "add_any_new_wifi_to_fav", prv->add_any_wifi,
                   NULL);
             }
+            /* OK exits the capplet before the main loop is idle again. */
+            nwamui_prof_commit (prof);
 
             g_object_unref (prof);
         }
@@ -1036,7 +1073,7 @@ apply(NwamPrefIFace *iface, gpointer user_data)
             nwamui_ncu_set_ipv4_has_dhcp( NWAMUI_NCU(prv->ncu), TRUE);
             model = GTK_TREE_MODEL( gtk_tree_view_get_model(GTK_TREE_VIEW(prv->ipv4_tv)));
             gtk_list_store_clear(GTK_LIST_STORE(model));
-            nwamui_ncu_set_v4addresses(NWAMUI_NCU(prv->ncu), GTK_LIST_STORE(model));
+            nwamui_ncu_set_v4addresses(NWAMUI_NCU(prv->ncu), NULL);
             nwamui_ncu_set_ipv4_default_route( NWAMUI_NCU(prv->ncu), default_route );
             break;
         case IPV4_COMBO_MANUALLY_ASSIGNED:
@@ -1045,7 +1082,7 @@ apply(NwamPrefIFace *iface, gpointer user_data)
             nwamui_ncu_set_ipv4_default_route( NWAMUI_NCU(prv->ncu), default_route );
             model = GTK_TREE_MODEL( gtk_tree_view_get_model(GTK_TREE_VIEW(prv->ipv4_tv)));
             if ( gtk_tree_model_iter_n_children( GTK_TREE_MODEL(model), NULL ) > 0 ) {
-                nwamui_ncu_set_v4addresses(NWAMUI_NCU(prv->ncu), GTK_LIST_STORE(model));
+                set_addresses_from_model(NWAMUI_NCU(prv->ncu), model, nwamui_ncu_set_v4addresses);
             }
             else {
                 gchar* message = g_strdup_printf(_("An error occurred validating the current NCU.\nThe device is configured to use static IPv4 addresses, but none exist."));
@@ -1059,7 +1096,7 @@ apply(NwamPrefIFace *iface, gpointer user_data)
             nwamui_ncu_set_ipv4_default_route( NWAMUI_NCU(prv->ncu), default_route );
             model = GTK_TREE_MODEL( gtk_tree_view_get_model(GTK_TREE_VIEW(prv->ipv4_tv)));
             if ( gtk_tree_model_iter_n_children( GTK_TREE_MODEL(model), NULL ) > 0 ) {
-                nwamui_ncu_set_v4addresses(NWAMUI_NCU(prv->ncu), GTK_LIST_STORE(model));
+                set_addresses_from_model(NWAMUI_NCU(prv->ncu), model, nwamui_ncu_set_v4addresses);
             }
             else {
                 gchar* message = g_strdup_printf(_("An error occurred validating the current NCU.\nThe device is configured to use static IPv4 addresses, but none exist."));
@@ -1089,7 +1126,7 @@ apply(NwamPrefIFace *iface, gpointer user_data)
                 nwamui_ncu_set_ipv6_has_dhcp( NWAMUI_NCU(prv->ncu), FALSE);
                 nwamui_ncu_set_ipv6_default_route( NWAMUI_NCU(prv->ncu), NULL);
                 gtk_list_store_clear(GTK_LIST_STORE(model));
-                nwamui_ncu_set_v6addresses(NWAMUI_NCU(prv->ncu), GTK_LIST_STORE(model));
+                nwamui_ncu_set_v6addresses(NWAMUI_NCU(prv->ncu), NULL);
                 break;
             case 1:
                 nwamui_ncu_set_ipv6_active( NWAMUI_NCU(prv->ncu), TRUE );
@@ -1099,7 +1136,7 @@ apply(NwamPrefIFace *iface, gpointer user_data)
                 if ( !ipv6_has_static ) {
                     gtk_list_store_clear(GTK_LIST_STORE(model));
                 }
-                nwamui_ncu_set_v6addresses(NWAMUI_NCU(prv->ncu), GTK_LIST_STORE(model));
+                set_addresses_from_model(NWAMUI_NCU(prv->ncu), model, nwamui_ncu_set_v6addresses);
                 break;
             default:
                 /* Disable ipv6 dhcp */
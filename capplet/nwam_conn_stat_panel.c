@@ -375,10 +375,13 @@ refresh(NwamPrefIFace *iface, gpointer user_data, gboolean force)
 	/* data could be null or ncp */
     if (user_data != NULL) {
         NwamuiNcp *ncp = NWAMUI_NCP(user_data);
+        GtkTreeModel *ncus;
         GtkTreeModel *model;
         GtkTreeModel *filter;
 
-        model = GTK_TREE_MODEL(nwamui_ncp_get_ncu_list_store(ncp));
+        ncus = nwamui_object_list_model_new_for_ncp(ncp);
+        model = gtk_tree_model_sort_new_with_model(ncus);
+        g_object_unref(ncus);
 
 /*         gtk_tree_sortable_set_default_sort_func(GTK_TREE_SORTABLE(model), */
 /*           nwam_ncu_compare_cb, */
@@ -641,7 +644,8 @@ repair_clicked_cb( GtkButton *button, gpointer data )
           &iter,
           &filter_iter);
 
-        gtk_tree_model_get(model, &iter, 0, &connection, -1);
+        gtk_tree_model_get(gtk_tree_model_filter_get_model(GTK_TREE_MODEL_FILTER(model)),
+          &iter, 0, &connection, -1);
         ncu  = NWAMUI_NCU( connection );
         
         /* TODO : Repair/renew the NCU */
@@ -36,6 +36,7 @@
 #include "capplet-utils.h"
 #include "nwam_tree_view.h"
 #include "nwam_rules_dialog.h"
+#include "nwam_location_why.h"
 
 /* Names of Widgets in Glade file */
 #define LOCATION_DIALOG                 "nwam_location"
@@ -48,6 +49,7 @@
 #define LOCATION_EDIT_BTN               "location_edit_btn"
 #define LOCATION_ACTIVATION_COMBO       "location_activation_combo"
 #define LOCATION_RULES_BTN              "location_rules_btn"
+#define LOCATION_WHY_BTN                "location_why_btn"
 #define LOCATION_SWITCH_LOC_AUTO_CB     "switch_loc_auto_cb"
 #define LOCATION_SWITCH_LOC_MANUALLY_CB "switch_loc_manually_cb"
 
@@ -66,11 +68,13 @@ struct _NwamLocationDialogPrivate {
 
     GtkComboBox*        location_activation_combo;
     GtkButton*          location_rules_btn;
+    GtkButton*          location_why_btn;
 
     GtkRadioButton*     location_switch_loc_auto_cb;
     GtkRadioButton*     location_switch_loc_manually_cb;
     gboolean            switch_loc_manually_flag;
     NwamuiObject*       toggled_env;
+    GHashTable         *sessions;       /* NwamuiEnv* -> nwamui_edit_session_t*, the unapplied edits */
 
 	/* Other Data */
     NwamuiDaemon       *daemon;
@@ -126,6 +130,8 @@ static void location_get_property (GObject         *object,
 static void response_cb( GtkWidget* widget, gint repsonseid, gpointer data );
 static void object_notify_cb( GObject *gobject, GParamSpec *arg1, gpointer data);
 static void daemon_env_selection_mode_changed(GObject *gobject, GParamSpec *arg1, gpointer data);
+static void daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
+static void daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
 static void nwam_location_connection_toggled_cell_sensitive_func(GtkTreeViewColumn *col,
   GtkCellRenderer   *renderer,
   GtkTreeModel      *model,
@@ -153,6 +159,7 @@ static void nwam_location_connection_enabled_toggled_cb(    GtkCellRendererToggl
 
 static void nwam_treeview_update_widget_cb(GtkTreeSelection *selection, gpointer user_data);
 static void on_button_clicked(GtkButton *button, gpointer user_data);
+static void location_why_btn_clicked(GtkButton *button, gpointer user_data);
 static void location_switch_loc_cb_toggled(GtkToggleButton *button, gpointer user_data);
 static void location_activation_combo_cell_cb(GtkCellLayout *cell_layout,
   GtkCellRenderer   *renderer,
@@ -183,6 +190,26 @@ nwam_pref_init (gpointer g_iface, gpointer iface_data)
     iface->dialog_get_window = dialog_get_window;
 }
 
+/* The edits of an object are kept in a session until apply() or cancel(). */
+static nwamui_edit_session_t*
+get_edit_session(NwamLocationDialog *self, GObject *obj)
+{
+	NwamLocationDialogPrivate *prv     = GET_PRIVATE(self);
+    nwamui_edit_session_t     *session = g_hash_table_lookup(prv->sessions, obj);
+
+    if (session == NULL) {
+        session = nwamui_edit_session_new(NWAMUI_OBJECT(obj));
+        g_hash_table_insert(prv->sessions, obj, session);
+    }
+    return session;
+}
+
+static void
+apply_edit_session(gpointer key, gpointer value, gpointer user_data)
+{
+    nwamui_edit_session_apply((nwamui_edit_session_t *)value);
+}
+
 static GObject*
 create_object(NwamObjectCtrlIFace *iface)
 {
@@ -231,6 +258,7 @@ remove_object(NwamObjectCtrlIFace *iface, GObject *obj)
             g_object_set(self, "toggled_env", NULL, NULL);
         }
 
+        g_hash_table_remove(prv->sessions, obj);
         nwamui_object_destroy(NWAMUI_OBJECT(obj));
         ret = TRUE;
     }
@@ -265,6 +293,12 @@ edit_object(NwamObjectCtrlIFace *iface, GObject *obj)
     if (env_pref_dialog == NULL)
         env_pref_dialog = nwam_env_pref_dialog_new();
 
+    /* The preferences are edited on the object, so set the edits made here
+     * on it first. A session also reads in an object still as the tray's
+     * snapshot has it.
+     */
+    nwamui_edit_session_apply(get_edit_session(self, obj));
+
     nwam_pref_refresh(NWAM_PREF_IFACE(env_pref_dialog), NWAMUI_OBJECT(obj), TRUE);
     nwam_pref_dialog_run(NWAM_PREF_IFACE(env_pref_dialog), GTK_WIDGET(prv->location_tree));
 }
@@ -278,6 +312,7 @@ dup_object(NwamObjectCtrlIFace *iface, GObject *obj)
     gchar *prefix;
     gchar *name;
     NwamuiObject *object;
+    nwamui_edit_session_t *session;
 
     prefix = capplet_get_original_name(_("Copy of"), sname);
 
@@ -287,6 +322,26 @@ dup_object(NwamObjectCtrlIFace *iface, GObject *obj)
 
     object = nwamui_object_clone(NWAMUI_OBJECT(obj), name, NWAMUI_OBJECT(prv->daemon));
 
+    /* The copy is of the location as edited, not as committed. */
+    if (object != NULL &&
+      (session = g_hash_table_lookup(prv->sessions, obj)) != NULL) {
+        GList *changes = nwamui_edit_session_get_changes(session);
+        GList *idx;
+
+        nwamui_object_begin_update(object);
+        for (idx = changes; idx; idx = idx->next) {
+            GParamSpec *pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(object), idx->data);
+            GValue      value = { 0 };
+
+            g_value_init(&value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+            nwamui_edit_session_get_property(session, pspec->name, &value);
+            g_object_set_property(G_OBJECT(object), pspec->name, &value);
+            g_value_unset(&value);
+        }
+        nwamui_object_end_update(object);
+        g_list_free(changes);
+    }
+
     g_free(name);
     g_free(prefix);
     return G_OBJECT(object);
@@ -441,6 +496,8 @@ nwam_location_dialog_init(NwamLocationDialog *self)
     self->prv = prv;
 	/* Iniialise pointers to important widgets */
     prv->daemon = nwamui_daemon_get_instance();
+    prv->sessions = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+      NULL, (GDestroyNotify)nwamui_edit_session_free);
     prv->location_dialog = GTK_DIALOG(nwamui_util_glade_get_widget(LOCATION_DIALOG));
     capplet_remove_gtk_dialog_escape_binding(GTK_DIALOG_GET_CLASS(prv->location_dialog));
 
@@ -453,6 +510,7 @@ nwam_location_dialog_init(NwamLocationDialog *self)
     prv->location_edit_btn = GTK_BUTTON(nwamui_util_glade_get_widget(LOCATION_EDIT_BTN));
 
     prv->location_rules_btn = GTK_BUTTON(nwamui_util_glade_get_widget(LOCATION_RULES_BTN));
+    prv->location_why_btn = GTK_BUTTON(nwamui_util_glade_get_widget(LOCATION_WHY_BTN));
 
     prv->location_switch_loc_auto_cb = GTK_RADIO_BUTTON(nwamui_util_glade_get_widget(LOCATION_SWITCH_LOC_AUTO_CB));
     prv->location_switch_loc_manually_cb = GTK_RADIO_BUTTON(nwamui_util_glade_get_widget(LOCATION_SWITCH_LOC_MANUALLY_CB));
@@ -462,6 +520,8 @@ nwam_location_dialog_init(NwamLocationDialog *self)
 
     g_signal_connect(prv->location_rules_btn,
       "clicked", G_CALLBACK(on_button_clicked), (gpointer)self);
+    g_signal_connect(prv->location_why_btn,
+      "clicked", G_CALLBACK(location_why_btn_clicked), (gpointer)self);
 
     g_signal_connect(prv->location_switch_loc_manually_cb,
       "clicked", G_CALLBACK(location_switch_loc_cb_toggled), (gpointer)self);
@@ -515,6 +575,8 @@ nwam_location_dialog_init(NwamLocationDialog *self)
 	g_signal_connect(G_OBJECT(self), "notify", (GCallback)object_notify_cb, NULL);
 
 	g_signal_connect(prv->daemon, "notify::env-selection-mode", (GCallback)daemon_env_selection_mode_changed, (gpointer)self);
+	g_signal_connect(prv->daemon, "add", G_CALLBACK(daemon_add_object), (gpointer)self);
+	g_signal_connect(prv->daemon, "remove", G_CALLBACK(daemon_remove_object), (gpointer)self);
 
     /* Initially refresh self */
     nwam_pref_refresh(NWAM_PREF_IFACE(self), NULL, TRUE);
@@ -592,6 +654,11 @@ cancel(NwamPrefIFace *iface, gpointer user_data)
      */
     g_object_set(self, "toggled_env", NULL, NULL);
 
+    /* The edits never reached the objects, what the preferences and rules
+     * dialogs edited on them, and new objects, still have to be reverted.
+     */
+    g_hash_table_remove_all(self->prv->sessions);
+
     /* Re-read objects from system 
      */
 	model = gtk_tree_view_get_model(self->prv->location_tree);
@@ -613,9 +680,21 @@ apply(NwamPrefIFace *iface, gpointer user_data)
     NwamuiObject              *obj;
     gboolean                   retval    = TRUE;
 
+    /* Committing must see every object, not only what a staged reload got to. */
+    {
+        NwamuiDaemon *daemon = nwamui_daemon_get_instance();
+        nwamui_daemon_hydrate_now(daemon);
+        g_object_unref(daemon);
+    }
+
     model = gtk_tree_view_get_model(prv->location_tree);
     selection = gtk_tree_view_get_selection(prv->location_tree);
 
+    /* Set the edits on the objects, untouched ones stay unmodified and
+     * aren't committed.
+     */
+    g_hash_table_foreach(prv->sessions, apply_edit_session, NULL);
+
     ForeachNwamuiObjectCommitData data;
     data.failone = NULL;
     data.prop_name = NULL;
@@ -690,6 +769,10 @@ nwam_location_dialog_finalize(NwamLocationDialog *self)
     if (prv->toggled_env)
         g_object_unref(prv->toggled_env);
 
+    g_hash_table_destroy(prv->sessions);
+
+    g_signal_handlers_disconnect_by_func(prv->daemon, (gpointer)daemon_add_object, (gpointer)self);
+    g_signal_handlers_disconnect_by_func(prv->daemon, (gpointer)daemon_remove_object, (gpointer)self);
     g_object_unref(prv->daemon);
 
 	self->prv = NULL;
@@ -832,7 +915,7 @@ nwam_treeview_update_widget_cb(GtkTreeSelection *selection, gpointer user_data)
         g_signal_handlers_block_by_func(G_OBJECT(prv->location_activation_combo), 
                                         (gpointer)location_activation_combo_changed_cb, (gpointer)self);
 
-        cond = nwamui_object_get_activation_mode(NWAMUI_OBJECT(env));
+        nwamui_edit_session_get(get_edit_session(self, G_OBJECT(env)), "activation_mode", &cond, NULL);
 
         gtk_widget_set_sensitive(GTK_WIDGET(prv->location_activation_combo), 
                                             cond != NWAMUI_COND_ACTIVATION_MODE_SYSTEM);
@@ -883,6 +966,11 @@ on_button_clicked(GtkButton *button, gpointer user_data)
             nwam_pref_refresh(rules_dialog, NWAMUI_OBJECT(env), TRUE);
             nwam_pref_dialog_run(rules_dialog, GTK_WIDGET(button));
             g_object_unref(rules_dialog);
+            /* The rules dialog sets the activation mode on the object
+             * itself, it replaces the one chosen here.
+             */
+            nwamui_edit_session_set(get_edit_session(self, G_OBJECT(env)),
+              "activation_mode", nwamui_object_get_activation_mode(NWAMUI_OBJECT(env)), NULL);
             /* Update the select row, since the activation may changed. */
             nwam_treeview_update_widget_cb(gtk_tree_view_get_selection(prv->location_tree), (gpointer)self);
         } else {
@@ -894,6 +982,15 @@ on_button_clicked(GtkButton *button, gpointer user_data)
     }
 }
 
+static void
+location_why_btn_clicked(GtkButton *button, gpointer user_data)
+{
+    NwamLocationDialog         *self = NWAM_LOCATION_DIALOG(user_data);
+    NwamLocationDialogPrivate  *prv = GET_PRIVATE(self);
+
+    nwam_location_why_run(GTK_WINDOW(prv->location_dialog));
+}
+
 static void
 location_switch_loc_cb_toggled(GtkToggleButton *button, gpointer user_data)
 {
@@ -946,26 +1043,28 @@ location_activation_combo_changed_cb(GtkComboBox* combo, gpointer user_data)
 
     if ( gtk_tree_selection_get_selected(gtk_tree_view_get_selection(prv->location_tree), &model, &iter ) ) {
         NwamuiObject                  *obj;
+        nwamui_edit_session_t         *session;
         nwamui_cond_activation_mode_t  cond;
 
         gtk_tree_model_get(model, &iter, 0, &obj, -1);
         
-        cond = nwamui_object_get_activation_mode(obj);
+        session = get_edit_session(self, G_OBJECT(obj));
+        nwamui_edit_session_get(session, "activation_mode", &cond, NULL);
         switch (gtk_combo_box_get_active(prv->location_activation_combo)) {
         case NWAMUI_LOC_ACTIVATION_MANUAL:
             if (cond != NWAMUI_COND_ACTIVATION_MODE_MANUAL) {
-                nwamui_object_set_activation_mode(obj, NWAMUI_COND_ACTIVATION_MODE_MANUAL);
+                nwamui_edit_session_set(session, "activation_mode", NWAMUI_COND_ACTIVATION_MODE_MANUAL, NULL);
             }
             break;
         case NWAMUI_LOC_ACTIVATION_BY_RULES:
             /* Default set to condition any when changing from others. */
             if (cond != NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY) {
-                nwamui_object_set_activation_mode(obj, NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY);
+                nwamui_edit_session_set(session, "activation_mode", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY, NULL);
             }
             break;
         case NWAMUI_LOC_ACTIVATION_BY_SYSTEM:
             if (cond != NWAMUI_COND_ACTIVATION_MODE_SYSTEM) {
-                nwamui_object_set_activation_mode(obj, NWAMUI_COND_ACTIVATION_MODE_SYSTEM);
+                nwamui_edit_session_set(session, "activation_mode", NWAMUI_COND_ACTIVATION_MODE_SYSTEM, NULL);
             }
             break;
         default:
@@ -1027,6 +1126,33 @@ daemon_env_selection_mode_changed(GObject *gobject, GParamSpec *arg1, gpointer d
     gtk_button_clicked(switch_cb);
 }
 
+/* Follow the locations read or pruned by the daemon, e.g. when it finishes
+ * loading after starting from the tray's snapshot, without losing the rows
+ * being edited.
+ */
+static void
+daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
+{
+	NwamLocationDialogPrivate *prv   = GET_PRIVATE(user_data);
+    GtkTreeModel              *model = gtk_tree_view_get_model(prv->location_tree);
+    GtkTreeIter                iter;
+
+    if (NWAMUI_IS_ENV(object) && !capplet_model_find_object(model, G_OBJECT(object), &iter)) {
+        CAPPLET_LIST_STORE_ADD(model, object, &iter);
+    }
+}
+
+static void
+daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
+{
+	NwamLocationDialogPrivate *prv = GET_PRIVATE(user_data);
+
+    if (NWAMUI_IS_ENV(object)) {
+        g_hash_table_remove(prv->sessions, object);
+        capplet_model_remove_object(gtk_tree_view_get_model(prv->location_tree), G_OBJECT(object));
+    }
+}
+
 static void
 nwam_location_connection_toggled_cell_sensitive_func(GtkTreeViewColumn *col,
   GtkCellRenderer   *renderer,
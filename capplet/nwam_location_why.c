@@ -0,0 +1,204 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwam_location_why.c
+ *
+ * "Why this location?": evaluates the conditions of every location against
+ * the current environment, or an edited one, and shows which location
+ * nwamd would select and why.
+ */
+
+#include <gtk/gtk.h>
+#include <glib/gi18n.h>
+
+#include "libnwamui.h"
+#include "nwam_location_why.h"
+
+enum {
+    WHY_COL_TEXT = 0,
+    WHY_COL_STATUS,
+    WHY_COL_SCORE,
+    WHY_COL_WEIGHT,
+    WHY_N_COLS
+};
+
+typedef struct {
+    nwamui_cond_sim_t  *sim;
+    GtkTreeStore       *store;
+    GtkTreeView        *view;
+} why_data_t;
+
+static void
+why_populate(why_data_t *data, const nwamui_cond_env_t *env)
+{
+    GList      *results;
+    GList      *idx;
+    GList      *reason;
+    GtkTreeIter parent;
+    GtkTreeIter child;
+    gchar      *score;
+
+    gtk_tree_store_clear(data->store);
+
+    results = nwamui_cond_sim_run(data->sim, env, TRUE);
+
+    for (idx = results; idx; idx = idx->next) {
+        nwamui_cond_sim_result_t *result = (nwamui_cond_sim_result_t *)idx->data;
+
+        score = result->matches ? g_strdup_printf("%" G_GUINT64_FORMAT, result->score) : g_strdup("");
+
+        gtk_tree_store_append(data->store, &parent, NULL);
+        gtk_tree_store_set(data->store, &parent,
+          WHY_COL_TEXT, result->name,
+          WHY_COL_STATUS, result->selected ? _("Selected") :
+          result->matches ? _("Matches") : _("Doesn't match"),
+          WHY_COL_SCORE, score,
+          WHY_COL_WEIGHT, result->selected ? PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL,
+          -1);
+        g_free(score);
+
+        for (reason = result->reasons; reason; reason = reason->next) {
+            gtk_tree_store_append(data->store, &child, &parent);
+            gtk_tree_store_set(data->store, &child,
+              WHY_COL_TEXT, (gchar *)reason->data,
+              WHY_COL_WEIGHT, PANGO_WEIGHT_NORMAL,
+              -1);
+        }
+    }
+
+    nwamui_cond_sim_free_results(results);
+
+    /* Only the selected location is expanded */
+    gtk_tree_view_collapse_all(data->view);
+    if (gtk_tree_model_get_iter_first(GTK_TREE_MODEL(data->store), &parent)) {
+        GtkTreePath *path = gtk_tree_model_get_path(GTK_TREE_MODEL(data->store), &parent);
+
+        gtk_tree_view_expand_row(data->view, path, FALSE);
+        gtk_tree_path_free(path);
+    }
+}
+
+static void
+env_entry_activate(GtkEntry *entry, gpointer user_data)
+{
+    why_data_t         *data = (why_data_t *)user_data;
+    nwamui_cond_env_t  *env = nwamui_cond_env_new();
+
+    if (nwamui_cond_env_parse(env, gtk_entry_get_text(entry))) {
+        why_populate(data, env);
+    } else {
+        gdk_display_beep(gtk_widget_get_display(GTK_WIDGET(entry)));
+    }
+    nwamui_cond_env_free(env);
+}
+
+static void
+why_append_column(GtkTreeView *view, const gchar *title, gint col, gboolean expand)
+{
+    GtkCellRenderer    *cell = gtk_cell_renderer_text_new();
+    GtkTreeViewColumn  *column;
+
+    column = gtk_tree_view_column_new_with_attributes(title, cell,
+      "text", col,
+      "weight", WHY_COL_WEIGHT,
+      NULL);
+    gtk_tree_view_column_set_expand(column, expand);
+    gtk_tree_view_column_set_resizable(column, TRUE);
+    gtk_tree_view_append_column(view, column);
+}
+
+/**
+ * nwam_location_why_run:
+ *
+ * Run the "why this location?" dialog. The environment starts as the
+ * current one and can be edited as "keyword=value,..." to see what would
+ * happen in another one.
+ **/
+extern void
+nwam_location_why_run(GtkWindow *parent)
+{
+    NwamuiDaemon       *daemon = nwamui_daemon_get_instance();
+    nwamui_cond_env_t  *env;
+    why_data_t          data;
+    GtkWidget          *dialog;
+    GtkWidget          *vbox;
+    GtkWidget          *label;
+    GtkWidget          *entry;
+    GtkWidget          *scrolled;
+    gchar              *spec;
+
+    env = nwamui_cond_env_new_from_daemon(daemon);
+    data.sim = nwamui_cond_sim_new_from_daemon(daemon);
+    data.store = gtk_tree_store_new(WHY_N_COLS,
+      G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT);
+    data.view = GTK_TREE_VIEW(gtk_tree_view_new_with_model(GTK_TREE_MODEL(data.store)));
+    g_object_unref(data.store);
+
+    why_append_column(data.view, _("Location"), WHY_COL_TEXT, TRUE);
+    why_append_column(data.view, _("Status"), WHY_COL_STATUS, FALSE);
+    why_append_column(data.view, _("Score"), WHY_COL_SCORE, FALSE);
+
+    dialog = gtk_dialog_new_with_buttons(_("Why This Location?"), parent,
+      GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT | GTK_DIALOG_NO_SEPARATOR,
+      GTK_STOCK_CLOSE, GTK_RESPONSE_CLOSE,
+      NULL);
+    gtk_window_set_default_size(GTK_WINDOW(dialog), 560, 400);
+
+    vbox = gtk_vbox_new(FALSE, 6);
+    gtk_container_set_border_width(GTK_CONTAINER(vbox), 12);
+
+    label = gtk_label_new_with_mnemonic(_("_Environment (keyword=value, separated by commas):"));
+    gtk_misc_set_alignment(GTK_MISC(label), 0.0, 0.5);
+    gtk_box_pack_start(GTK_BOX(vbox), label, FALSE, FALSE, 0);
+
+    entry = gtk_entry_new();
+    spec = nwamui_cond_env_to_string(env);
+    gtk_entry_set_text(GTK_ENTRY(entry), spec);
+    g_free(spec);
+    gtk_label_set_mnemonic_widget(GTK_LABEL(label), entry);
+    g_signal_connect(entry, "activate", G_CALLBACK(env_entry_activate), &data);
+    gtk_box_pack_start(GTK_BOX(vbox), entry, FALSE, FALSE, 0);
+
+    scrolled = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),
+      GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_shadow_type(GTK_SCROLLED_WINDOW(scrolled), GTK_SHADOW_IN);
+    gtk_container_add(GTK_CONTAINER(scrolled), GTK_WIDGET(data.view));
+    gtk_box_pack_start(GTK_BOX(vbox), scrolled, TRUE, TRUE, 0);
+
+    gtk_box_pack_start(GTK_BOX(GTK_DIALOG(dialog)->vbox), vbox, TRUE, TRUE, 0);
+
+    why_populate(&data, env);
+    nwamui_cond_env_free(env);
+
+    gtk_widget_show_all(dialog);
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+
+    nwamui_cond_sim_free(data.sim);
+    g_object_unref(daemon);
+}
@@ -312,6 +312,9 @@ apply(NwamPrefIFace *iface, gpointer user_data)
 
     daemon = nwamui_daemon_get_instance();
 
+    /* Committing must see every object, not only what a staged reload got to. */
+    nwamui_daemon_hydrate_now(daemon);
+
     /* Ensure we don't have unsaved data */
     if ( !nwam_pref_apply (NWAM_PREF_IFACE(NWAM_CAPPLET_DIALOG(self)->prv->panel[cur_idx]), NULL) ) {
         rval = FALSE;
@@ -604,7 +607,7 @@ ncp_remove_ncu(NwamuiNcp *ncp, NwamuiNcu* ncu, gpointer data)
     /* Find ncu directly */
     if (capplet_model_find_object(model, G_OBJECT(ncu), &iter)) {
         /* Delete NCU. */
-        gtk_tree_store_remove(GTK_TREE_STORE(model), &iter);
+        capplet_model_remove_row(model, &iter);
     }
 }
 
@@ -721,7 +721,11 @@ apply(NwamPrefIFace *iface, gpointer user_data)
 
         /* rename */
         if (GTK_WIDGET_IS_SENSITIVE(prv->profile_name_entry)) {
-            nwamui_object_set_name(prv->selected_ncp, gtk_entry_get_text(GTK_ENTRY(prv->profile_name_entry)));
+            nwamui_edit_session_t *session = nwamui_edit_session_new(prv->selected_ncp);
+
+            nwamui_edit_session_set(session, "name", gtk_entry_get_text(GTK_ENTRY(prv->profile_name_entry)), NULL);
+            nwamui_edit_session_apply(session);
+            nwamui_edit_session_free(session);
         }
         /* This will commit all NCU children. */
         nwamui_object_commit(prv->selected_ncp);
@@ -1655,18 +1659,29 @@ foreach_set_group_mode(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter
         gtk_tree_model_get(model, &child_iter, 0, &obj, -1);
         if (obj) {
             if (obj != fake_object_in_pri_group) {
+                /* Only what differs is set, so the NCUs left in their group
+                 * stay unmodified and aren't committed.
+                 */
+                nwamui_edit_session_t *session = nwamui_edit_session_new(obj);
+
                 switch (group_id) {
                 case ALWAYS_ON_GROUP_ID:
                 case ALWAYS_OFF_GROUP_ID:
-                    nwamui_object_set_activation_mode(obj, NWAMUI_COND_ACTIVATION_MODE_MANUAL);
-                    nwamui_object_set_enabled(NWAMUI_OBJECT(obj), group_id == ALWAYS_ON_GROUP_ID);
+                    nwamui_edit_session_set(session,
+                      "activation_mode", NWAMUI_COND_ACTIVATION_MODE_MANUAL,
+                      "enabled", group_id == ALWAYS_ON_GROUP_ID,
+                      NULL);
                     break;
                 default:
-                    nwamui_ncu_set_priority_group(NWAMUI_NCU(obj), group_id);
-                    nwamui_object_set_activation_mode(obj, NWAMUI_COND_ACTIVATION_MODE_PRIORITIZED);
-                    nwamui_ncu_set_priority_group_mode(NWAMUI_NCU(obj), mode);
+                    nwamui_edit_session_set(session,
+                      "priority_group", (guint)group_id,
+                      "activation_mode", NWAMUI_COND_ACTIVATION_MODE_PRIORITIZED,
+                      "priority_group_mode", mode,
+                      NULL);
                     break;
                 }
+                nwamui_edit_session_apply(session);
+                nwamui_edit_session_free(session);
             }
             g_object_unref(obj);
         }
@@ -1969,7 +1984,7 @@ connections_edit_btn_clicked(GtkButton *button, gpointer user_data )
     gint                       result;
 
     auto_ncp = nwamui_daemon_get_ncp_by_name(daemon, NWAM_NCP_NAME_AUTOMATIC);
-    model = GTK_TREE_MODEL(nwamui_ncp_get_ncu_list_store(NWAMUI_NCP(auto_ncp)));
+    model = nwamui_object_list_model_new_for_ncp(NWAMUI_NCP(auto_ncp));
     /* Selected ncus used for show toggle cells. */
     g_assert(prv->ncu_list == NULL);
     g_assert(prv->ncu_rm_list == NULL);
@@ -2020,10 +2035,17 @@ connections_edit_btn_clicked(GtkButton *button, gpointer user_data )
                 /* Should fire events to get it added to UI */
                 new_ncu = nwamui_object_clone(NWAMUI_OBJECT(selected->data), NULL, prv->selected_ncp);
                 if (new_ncu != NULL) {
-                    /* Needn't add, since we have monitor ::add/remove signals. */
-                    if (nwamui_object_commit(new_ncu)) {
-                        /* nwamui_object_add(prv->selected_ncp, new_ncu); */
+                    nwamui_edit_session_t *session = nwamui_edit_session_new(new_ncu);
+
+                    /* Validated before it is written. Needn't add, since we
+                     * have monitor ::add/remove signals.
+                     */
+                    if (!nwamui_edit_session_commit(session, NULL)) {
+                        nwamui_warning("Commit NCP %s NCU %s failed",
+                          nwamui_object_get_name(prv->selected_ncp),
+                          nwamui_object_get_name(new_ncu));
                     }
+                    nwamui_edit_session_free(session);
                     g_object_unref(new_ncu);
                 } else {
                     nwamui_warning("Clone NCP %s NCU %s failed",
@@ -2761,7 +2783,7 @@ ncu_pri_treeview_remove(GtkTreeView *treeview, NwamuiObject *object)
 
     if (capplet_model_find_object_with_parent(model, &parent,
         G_OBJECT(object), &temp)) {
-        gtk_tree_store_remove(GTK_TREE_STORE(model), &temp);
+        capplet_model_remove_row(model, &temp);
 
     }
     handle_ncu_group_node(model, group_rr);
@@ -115,6 +115,8 @@ static void nwam_profile_panel_set_toggled_row(NwamProfilePanel *self, GtkTreePa
 
 /* Callbacks */
 static void object_notify_cb( GObject *gobject, GParamSpec *arg1, gpointer data);
+static void daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
+static void daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
 
 static void nwam_object_toggled_cell_sensitive_func(GtkTreeViewColumn *col,
   GtkCellRenderer   *renderer,
@@ -482,6 +484,8 @@ nwam_profile_panel_init(NwamProfilePanel *self)
     nwam_compose_tree_view(self);
     
 	g_signal_connect(G_OBJECT(self), "notify", (GCallback)object_notify_cb, NULL);
+	g_signal_connect(prv->daemon, "add", G_CALLBACK(daemon_add_object), (gpointer)self);
+	g_signal_connect(prv->daemon, "remove", G_CALLBACK(daemon_remove_object), (gpointer)self);
 
     /* Initially refresh self */
     nwam_pref_refresh(NWAM_PREF_IFACE(self), NULL, TRUE);
@@ -627,6 +631,8 @@ nwam_profile_panel_finalize(NwamProfilePanel *self)
 
     g_object_unref(prv->pref_dialog);
 
+    g_signal_handlers_disconnect_by_func(prv->daemon, (gpointer)daemon_add_object, (gpointer)self);
+    g_signal_handlers_disconnect_by_func(prv->daemon, (gpointer)daemon_remove_object, (gpointer)self);
     g_object_unref(prv->daemon);
 
 	self->prv = NULL;
@@ -636,6 +642,35 @@ nwam_profile_panel_finalize(NwamProfilePanel *self)
 
 /* Callbacks */
 
+/* Follow the NCPs read or pruned by the daemon when it finishes loading
+ * after starting from the tray's snapshot. Later the NCPs this panel creates
+ * are added to the daemon before their rows.
+ */
+static void
+daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
+{
+	NwamProfilePanelPrivate *prv   = GET_PRIVATE(user_data);
+    GtkTreeModel            *model = gtk_tree_view_get_model(prv->object_view);
+    GtkTreeIter              iter;
+
+    if (nwamui_daemon_is_hydrated(daemon)) {
+        return;
+    }
+    if (NWAMUI_IS_NCP(object) && !capplet_model_find_object(model, G_OBJECT(object), &iter)) {
+        CAPPLET_LIST_STORE_ADD(model, object, &iter);
+    }
+}
+
+static void
+daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
+{
+	NwamProfilePanelPrivate *prv = GET_PRIVATE(user_data);
+
+    if (NWAMUI_IS_NCP(object)) {
+        capplet_model_remove_object(gtk_tree_view_get_model(prv->object_view), G_OBJECT(object));
+    }
+}
+
 /*
  * We don't need a comp here actually due to requirements
  */
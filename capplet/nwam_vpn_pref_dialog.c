@@ -86,6 +86,7 @@ struct _NwamVPNPrefDialogPrivate {
 	NwamuiDaemon *daemon;
 	//GList	*enm_list;
 	GObject	*cur_obj;           /* current selection of tree */
+    GHashTable *sessions;       /* NwamuiEnm* -> nwamui_edit_session_t*, the unapplied edits */
 };
 
 static void nwam_pref_init (gpointer g_iface, gpointer iface_data);
@@ -99,6 +100,7 @@ static GtkWindow* dialog_get_window(NwamPrefIFace *iface);
 static void nwam_vpn_pref_dialog_finalize(NwamVPNPrefDialog *self);
 static void nwam_compose_tree_view (NwamVPNPrefDialog *self);
 static gboolean nwam_update_obj (NwamVPNPrefDialog *self, GObject *obj);
+static nwamui_edit_session_t* get_edit_session(NwamVPNPrefDialog *self, GObject *obj);
 static void set_property (GObject         *object,
                           guint            prop_id,
                           const GValue    *value,
@@ -134,6 +136,8 @@ static void nwam_vpn_selection_changed(GtkTreeSelection *selection,
 static void on_rules_button_clicked(GtkButton *button, gpointer user_data);
 static void on_radio_button_toggled(GtkToggleButton *button, gpointer user_data);
 static void conditional_toggled_cb(GtkToggleButton *button, gpointer user_data);
+static void daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
+static void daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
 
 G_DEFINE_TYPE_EXTENDED(NwamVPNPrefDialog,
   nwam_vpn_pref_dialog,
@@ -189,6 +193,7 @@ remove_object(NwamObjectCtrlIFace *iface, GObject *obj)
         if (prv->cur_obj == (gpointer)obj) {
             prv->cur_obj = NULL;
         }
+        g_hash_table_remove(prv->sessions, obj);
         nwamui_object_destroy(NWAMUI_OBJECT(obj));
         return TRUE;
     }
@@ -250,6 +255,8 @@ nwam_vpn_pref_dialog_init(NwamVPNPrefDialog *self)
 
 	/* daemon */
 	prv->daemon = nwamui_daemon_get_instance ();
+    prv->sessions = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+      NULL, (GDestroyNotify)nwamui_edit_session_free);
 
 	/* Iniialise pointers to important widgets */
 	prv->vpn_pref_dialog = GTK_DIALOG(nwamui_util_glade_get_widget(VPN_PREF_DIALOG_NAME));
@@ -301,6 +308,8 @@ nwam_vpn_pref_dialog_init(NwamVPNPrefDialog *self)
 
 	g_signal_connect(self, "notify", (GCallback)object_notify_cb, NULL);
 	g_signal_connect(prv->vpn_pref_dialog, "response", (GCallback)response_cb, (gpointer)self);
+	g_signal_connect(prv->daemon, "add", G_CALLBACK(daemon_add_object), (gpointer)self);
+	g_signal_connect(prv->daemon, "remove", G_CALLBACK(daemon_remove_object), (gpointer)self);
 
     g_signal_connect(self->prv->vpn_rules_btn, "clicked",
       G_CALLBACK(on_rules_button_clicked), (gpointer)self);
@@ -318,6 +327,9 @@ nwam_vpn_pref_dialog_init(NwamVPNPrefDialog *self)
 static void
 nwam_vpn_pref_dialog_finalize(NwamVPNPrefDialog *self)
 {
+	g_hash_table_destroy(self->prv->sessions);
+    g_signal_handlers_disconnect_by_func(self->prv->daemon, (gpointer)daemon_add_object, (gpointer)self);
+    g_signal_handlers_disconnect_by_func(self->prv->daemon, (gpointer)daemon_remove_object, (gpointer)self);
 	g_object_unref (G_OBJECT(self->prv->daemon));
 
 	G_OBJECT_CLASS(nwam_vpn_pref_dialog_parent_class)->finalize(G_OBJECT(self));
@@ -436,91 +448,107 @@ nwam_compose_tree_view (NwamVPNPrefDialog *self)
       "row-changed", G_CALLBACK(capplet_tree_model_row_changed_func), (gpointer)self);
 }
 
+/* The edits of an object are kept in a session until apply() or cancel(). */
+static nwamui_edit_session_t*
+get_edit_session(NwamVPNPrefDialog *self, GObject *obj)
+{
+	NwamVPNPrefDialogPrivate *prv     = GET_PRIVATE(self);
+    nwamui_edit_session_t    *session = g_hash_table_lookup(prv->sessions, obj);
+
+    if (session == NULL) {
+        session = nwamui_edit_session_new(NWAMUI_OBJECT(obj));
+        g_hash_table_insert(prv->sessions, obj, session);
+    }
+    return session;
+}
+
+/* An empty entry unsets the property, as the setters do. */
+static const gchar*
+entry_get_value(GtkEntry *entry)
+{
+    const gchar *txt = gtk_entry_get_text(entry);
+
+    return (txt != NULL && *txt != '\0') ? txt : NULL;
+}
+
+/* If value is rejected by the setter of prop_name, popup dialog and return
+ * FALSE.
+ */
+static gboolean
+check_entry_value(NwamVPNPrefDialog *self, GObject *obj, const gchar *prop_name,
+  const gchar *value, const gchar *msg)
+{
+    if (nwamui_enm_validate_string_prop(NWAMUI_ENM(obj), prop_name, value)) {
+        return TRUE;
+    }
+
+    nwamui_util_show_message (GTK_WINDOW(self->prv->vpn_pref_dialog), GTK_MESSAGE_ERROR, _("Validation Error"),
+      msg, TRUE );
+    return FALSE;
+}
+
+static void
+apply_edit_session(gpointer key, gpointer value, gpointer user_data)
+{
+    nwamui_edit_session_apply((nwamui_edit_session_t *)value);
+}
+
 /* If update failed, popup dialog and return FALSE */
 static gboolean
 nwam_update_obj (NwamVPNPrefDialog *self, GObject *obj)
 {
 	NwamVPNPrefDialogPrivate       *prv = GET_PRIVATE(self);
-	const gchar                    *txt = NULL;
-    gchar                          *prev_txt = NULL;
+    nwamui_edit_session_t          *session;
     gboolean                        cli_value;
     gboolean                        manual_mode;
-    nwamui_cond_activation_mode_t   current_mode;
+    gint                            current_mode;
     GList                          *conditions_list;
 
     if (!NWAMUI_IS_ENM(obj)) {
         return( FALSE );
     }
 
-    /* Stop update GUI when commit changes one by one. */
-    g_object_freeze_notify(obj);
+    /* Values the object has already are dropped by the session, so only
+     * real changes are applied and committed later.
+     */
+    session = get_edit_session(self, obj);
+
     cli_value = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(prv->vpn_cli_rb));
     if (cli_value) {
-        if ( FALSE ) {
-                gchar *summary = g_strdup_printf(_("Cannot start '%s'"), nwamui_object_get_name(NWAMUI_OBJECT(obj)));
-                nwamui_util_show_message(GTK_WINDOW(self->prv->vpn_pref_dialog),
-                  GTK_MESSAGE_ERROR,
-                  summary,
-                  (_("The Fixed profile '%s' is currently active.\nNetwork modifiers can only be used with Reactive network profiles."), ""),
-                  FALSE);
-                g_free(summary);
-        }
-        prev_txt = nwamui_enm_get_start_command(NWAMUI_ENM(obj));
-        txt = gtk_entry_get_text(prv->start_cmd_entry);
-        if ( (prev_txt == NULL || strlen( prev_txt ) == 0 )
-              || strcmp( prev_txt?prev_txt:"", txt?txt:"") != 0 ) {
-            if ( !nwamui_enm_set_start_command(NWAMUI_ENM(obj), txt?txt:"") ) {
-                nwamui_util_show_message (GTK_WINDOW(self->prv->vpn_pref_dialog), GTK_MESSAGE_ERROR, _("Validation Error"),
-                  _("Invalid value specified for Start Command"), TRUE );
-                g_free(prev_txt);
-                return( FALSE );
-            }
-        }
-        g_free(prev_txt);
-
-        prev_txt = nwamui_enm_get_stop_command(NWAMUI_ENM(obj));
-        txt = gtk_entry_get_text(prv->stop_cmd_entry);
-        if ( (prev_txt == NULL || strlen( prev_txt ) == 0 )
-              || strcmp( prev_txt?prev_txt:"", txt?txt:"") != 0 ) {
-            if ( !nwamui_enm_set_stop_command(NWAMUI_ENM(obj), txt?txt:"") ) {
-                nwamui_util_show_message (GTK_WINDOW(self->prv->vpn_pref_dialog), GTK_MESSAGE_ERROR, _("Validation Error"),
-                  _("Invalid value specified for Stop Command"), TRUE );
-                g_free(prev_txt);
-                return( FALSE );
-            }
-        }
-        g_free(prev_txt);
-        if ( !nwamui_enm_set_smf_fmri(NWAMUI_ENM(obj), NULL) ) {
-            g_debug("Error deleting smf_fmri value");
+        const gchar *start_cmd = entry_get_value(prv->start_cmd_entry);
+        const gchar *stop_cmd = entry_get_value(prv->stop_cmd_entry);
+
+        if (!check_entry_value(self, obj, "start_command", start_cmd, _("Invalid value specified for Start Command")) ||
+          !check_entry_value(self, obj, "stop_command", stop_cmd, _("Invalid value specified for Stop Command"))) {
+            return( FALSE );
         }
+        nwamui_edit_session_set(session,
+          "start_command", start_cmd,
+          "stop_command", stop_cmd,
+          "smf_fmri", NULL,
+          NULL);
     } else {
-        prev_txt = nwamui_enm_get_smf_fmri(NWAMUI_ENM(obj));
-        txt = gtk_entry_get_text(prv->process_entry);
-        if ( strcmp( prev_txt?prev_txt:"", txt?txt:"") != 0 ) {
-            if ( !nwamui_enm_set_smf_fmri(NWAMUI_ENM(obj), txt?txt:"") ) {
-                nwamui_util_show_message (GTK_WINDOW(self->prv->vpn_pref_dialog), GTK_MESSAGE_ERROR, _("Validation Error"),
-                  _("Invalid value specified for SMF FMRI"), TRUE );
-                g_free(prev_txt);
-                return( FALSE );
-            }
-        }
-        g_free(prev_txt);
-        if ( !nwamui_enm_set_start_command(NWAMUI_ENM(obj), NULL) ) {
-            g_debug("Error deleting start_command value");
-        }
-        if ( !nwamui_enm_set_stop_command(NWAMUI_ENM(obj), NULL) ) {
-            g_debug("Error deleting stop_command value");
+        const gchar *fmri = entry_get_value(prv->process_entry);
+
+        if (!check_entry_value(self, obj, "smf_fmri", fmri, _("Invalid value specified for SMF FMRI"))) {
+            return( FALSE );
         }
+        nwamui_edit_session_set(session,
+          "smf_fmri", fmri,
+          "start_command", NULL,
+          "stop_command", NULL,
+          NULL);
     }
 
     /* Handle activation mode */
     manual_mode = !gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(prv->vpn_conditional_cb));
-    current_mode = nwamui_object_get_activation_mode( NWAMUI_OBJECT(obj) );
+    nwamui_edit_session_get(session, "activation_mode", &current_mode, NULL);
     conditions_list = nwamui_object_get_conditions( NWAMUI_OBJECT(obj) );
 
     if ( manual_mode ) {
         if ( current_mode != NWAMUI_COND_ACTIVATION_MODE_MANUAL ) {
-            nwamui_object_set_activation_mode( NWAMUI_OBJECT(obj), NWAMUI_COND_ACTIVATION_MODE_MANUAL );
+            nwamui_edit_session_set(session, "activation_mode", NWAMUI_COND_ACTIVATION_MODE_MANUAL, NULL);
+            /* The rules dialog edits the conditions on the object itself. */
             nwamui_object_set_conditions( NWAMUI_OBJECT(obj), NULL ); /* To delete conditions */
         }
     } else {
@@ -534,15 +562,12 @@ nwam_update_obj (NwamVPNPrefDialog *self, GObject *obj)
          * ALL is the desired choice */
         if ( current_mode != NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL &&
              current_mode != NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY ) {
-            nwamui_object_set_activation_mode( NWAMUI_OBJECT(obj), NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL );
+            nwamui_edit_session_set(session, "activation_mode", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL, NULL);
         }
     }
 
     nwamui_util_free_obj_list( conditions_list );
 
-    /* Update GUI */
-    g_object_thaw_notify(obj);
-
 	return TRUE;
 }
 
@@ -604,6 +629,11 @@ cancel(NwamPrefIFace *iface, gpointer user_data)
     /*     return FALSE; */
     /* } */
 
+    /* The edits never reached the objects, the conditions and new objects
+     * still have to be reverted.
+     */
+    g_hash_table_remove_all(prv->sessions);
+
     model = gtk_tree_view_get_model(prv->view);
     gtk_tree_model_foreach(model, capplet_tree_model_foreach_nwamui_object_reload, NULL);
 
@@ -623,6 +653,13 @@ apply(NwamPrefIFace *iface, gpointer user_data)
     gboolean retval = TRUE;
     ForeachNwamuiObjectCommitData data;
 
+    /* Committing must see every object, not only what a staged reload got to. */
+    {
+        NwamuiDaemon *daemon = nwamui_daemon_get_instance();
+        nwamui_daemon_hydrate_now(daemon);
+        g_object_unref(daemon);
+    }
+
     /* update the new one before close */
     if (prv->cur_obj) {
         /* Update object before validate and commit it. */
@@ -631,6 +668,11 @@ apply(NwamPrefIFace *iface, gpointer user_data)
         }
     }
 
+    /* Set the edits on the objects, untouched ones stay unmodified and
+     * aren't committed.
+     */
+    g_hash_table_foreach(prv->sessions, apply_edit_session, NULL);
+
     /* Call into separated panel/instance
      * apply all changes, if no errors, hide all
      */
@@ -674,6 +716,37 @@ help(NwamPrefIFace *iface, gpointer user_data)
 }
 
 /* call backs */
+
+/* Follow the ENMs read or pruned by the daemon, e.g. when it finishes
+ * loading after starting from the tray's snapshot, keeping the unapplied
+ * edits of the others.
+ */
+static void
+daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
+{
+	NwamVPNPrefDialogPrivate *prv   = GET_PRIVATE(user_data);
+    GtkTreeModel             *model = gtk_tree_view_get_model(prv->view);
+    GtkTreeIter               iter;
+
+    if (NWAMUI_IS_ENM(object) && !capplet_model_find_object(model, G_OBJECT(object), &iter)) {
+        CAPPLET_LIST_STORE_ADD(model, object, &iter);
+    }
+}
+
+static void
+daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
+{
+	NwamVPNPrefDialogPrivate *prv = GET_PRIVATE(user_data);
+
+    if (NWAMUI_IS_ENM(object)) {
+        if (prv->cur_obj == (gpointer)object) {
+            prv->cur_obj = NULL;
+        }
+        g_hash_table_remove(prv->sessions, object);
+        capplet_model_remove_object(gtk_tree_view_get_model(prv->view), G_OBJECT(object));
+    }
+}
+
 static void
 object_notify_cb( GObject *gobject, GParamSpec *arg1, gpointer data)
 {
@@ -718,43 +791,38 @@ command_entry_changed(GtkEditable *editable, gpointer data)
     gboolean                  active    = FALSE;
     gboolean                  has_cond  = FALSE;
     /* guint16                   len; */
-    gchar*                    prop_name = NULL;
+    const gchar*              prop_name = NULL;
     GtkWidget                *w         = NULL;
-    GtkTreeModel             *model     = gtk_tree_view_get_model(prv->view);
+    nwamui_edit_session_t    *session;
 
     g_assert(prv->cur_obj);
 
+    session = get_edit_session(NWAM_VPN_PREF_DIALOG(data), prv->cur_obj);
 
     /* len = gtk_entry_get_text_length(GTK_ENTRY(editable)); */
     /* g_signal_handlers_block_by_func(G_OBJECT(gtk_tree_view_get_selection(prv->view)), */
     /*   (gpointer)nwam_vpn_selection_changed, data); */
-    g_signal_handlers_disconnect_by_func(G_OBJECT(prv->cur_obj), (gpointer)capplet_util_object_notify_cb, (gpointer)model);
 
     has_cond = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(prv->vpn_conditional_cb));
     active = nwamui_object_get_active(NWAMUI_OBJECT(prv->cur_obj));
-    text = gtk_entry_get_text(GTK_ENTRY(editable));
+    text = entry_get_value(GTK_ENTRY(editable));
 
     if ( editable == GTK_EDITABLE(prv->start_cmd_entry ) ) {
         active = !active;
         w = GTK_WIDGET(prv->start_btn);
-        if (nwamui_enm_set_start_command(NWAMUI_ENM(prv->cur_obj), text)) {
-            visible = TRUE;
-        } else {
-            visible = FALSE;
-        }
+        prop_name = "start_command";
     } else if ( editable == GTK_EDITABLE(prv->stop_cmd_entry ) ) {
         w = GTK_WIDGET(prv->stop_btn);
-        if (nwamui_enm_set_stop_command(NWAMUI_ENM(prv->cur_obj), text)) {
-            visible = TRUE;
-        } else {
-            visible = FALSE;
-        }
+        prop_name = "stop_command";
     } else {
-        if (nwamui_enm_set_smf_fmri(NWAMUI_ENM(prv->cur_obj), text)) {
-            visible = TRUE;
-        } else {
-            visible = FALSE;
-        }
+        prop_name = "smf_fmri";
+    }
+    /* Only a value the setter would take goes into the session. */
+    if (nwamui_enm_validate_string_prop(NWAMUI_ENM(prv->cur_obj), prop_name, text)) {
+        nwamui_edit_session_set(session, prop_name, text, NULL);
+        visible = TRUE;
+    } else {
+        visible = FALSE;
     }
     /* Condition is not enabled. */
     visible = !has_cond && visible;
@@ -762,7 +830,6 @@ command_entry_changed(GtkEditable *editable, gpointer data)
     /* if (nwamui_enm_validate(NWAMUI_ENM(prv->cur_obj), NULL)) { */
     /*     visible = TRUE; */
     /* } */
-    g_signal_connect(G_OBJECT(prv->cur_obj), "notify", (GCallback)capplet_util_object_notify_cb, (gpointer)model);
     /* g_signal_handlers_unblock_by_func(G_OBJECT(gtk_tree_view_get_selection(prv->view)), */
     /*   (gpointer)nwam_vpn_selection_changed, data); */
 
@@ -832,7 +899,7 @@ vpn_pref_clicked_cb (GtkButton *button, gpointer data)
 
     /* Update object before validate and commit it. */
     if (nwam_update_obj(self, prv->cur_obj)) {
-        if (nwamui_object_commit(NWAMUI_OBJECT(prv->cur_obj))) {
+        if (nwamui_edit_session_commit(get_edit_session(self, prv->cur_obj), NULL)) {
             /* We must add it first, UI daemon can reuse this object instead of
              * creating a new one. Otherwise, we can't know the latest start/stop
              * status of the object.
@@ -949,10 +1016,13 @@ nwam_vpn_selection_changed(GtkTreeSelection *selection, gpointer data)
 		gtk_tree_model_get (model, &iter, 0, &obj, -1);
 
         if (obj) {
-            gchar    *title;
-            gboolean  is_active;
+            nwamui_edit_session_t *session = get_edit_session(NWAM_VPN_PREF_DIALOG(data), obj);
+            gchar                 *title;
+            gboolean               is_active;
+            gint                   mode;
 
             is_active = nwamui_object_get_active(NWAMUI_OBJECT(obj));
+            nwamui_edit_session_get(session, "activation_mode", &mode, NULL);
 
             title = g_strdup_printf(_("Start/stop '%s' according to rules"), nwamui_object_get_name(NWAMUI_OBJECT(obj)));
             g_object_set(prv->vpn_conditional_cb, "label", title, NULL);
@@ -961,8 +1031,8 @@ nwam_vpn_selection_changed(GtkTreeSelection *selection, gpointer data)
             g_free(title);
 
             /* State update, update at once. */
-            if (nwamui_object_get_activation_mode(NWAMUI_OBJECT(obj)) == NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY
-              || nwamui_object_get_activation_mode(NWAMUI_OBJECT(obj)) == NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL) {
+            if (mode == NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY
+              || mode == NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL) {
                 gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(prv->vpn_conditional_cb), TRUE);
                 gtk_widget_set_sensitive (GTK_WIDGET(prv->vpn_rules_btn), TRUE);
                 gtk_widget_set_sensitive (GTK_WIDGET(prv->start_btn), FALSE);
@@ -1003,7 +1073,7 @@ nwam_vpn_selection_changed(GtkTreeSelection *selection, gpointer data)
                 g_signal_handlers_block_by_func(prv->process_entry,
                   (gpointer)command_entry_changed, data);
 
-                txt = nwamui_enm_get_start_command (NWAMUI_ENM(obj));
+                nwamui_edit_session_get(session, "start_command", &txt, NULL);
 
                 gtk_entry_set_text(prv->start_cmd_entry, txt?txt:"");
 
@@ -1012,7 +1082,7 @@ nwam_vpn_selection_changed(GtkTreeSelection *selection, gpointer data)
                     cli_value = TRUE;
                 }
                 g_free (txt);
-                txt = nwamui_enm_get_stop_command (NWAMUI_ENM(obj));
+                nwamui_edit_session_get(session, "stop_command", &txt, NULL);
 
                 gtk_entry_set_text (prv->stop_cmd_entry, txt?txt:"");
 
@@ -1021,7 +1091,7 @@ nwam_vpn_selection_changed(GtkTreeSelection *selection, gpointer data)
                     cli_value = TRUE;
                 }
                 g_free (txt);
-                txt = nwamui_enm_get_smf_fmri (NWAMUI_ENM(obj));
+                nwamui_edit_session_get(session, "smf_fmri", &txt, NULL);
 
                 gtk_entry_set_text (prv->process_entry, txt?txt:"");
 
@@ -94,8 +94,6 @@ static void presistant_cb(GtkToggleButton* widget, gpointer data);
 /* Daemon */
 static void daemon_status_changed(NwamuiDaemon *daemon, GParamSpec *arg1, gpointer user_data);
 static void daemon_active_ncp_changed(NwamuiDaemon *daemon, GParamSpec *arg1, gpointer user_data);
-static void daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
-static void daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data);
 
 /* Prof */
 static void add_any_new_wifi_to_fav(GObject *gobject, GParamSpec *arg1, gpointer data);
@@ -134,8 +132,10 @@ nwam_compose_wifi_chooser_view (NwamWirelessChooser *self, GtkTreeView *view)
     GtkCellRenderer *renderer;
     GtkTreeModel *model;
 
-    model = GTK_TREE_MODEL(gtk_list_store_new (1, NWAMUI_TYPE_WIFI_NET));
+    /* Rows follow the scan results, see populate_panel. */
+    model = nwamui_object_list_model_new_for_daemon(self->prv->daemon, NWAMUI_TYPE_WIFI_NET);
     gtk_tree_view_set_model (view, model);
+    g_object_unref(model);
 
     g_object_set (G_OBJECT(view),
       "headers-clickable", FALSE,
@@ -251,59 +251,23 @@ nwam_wireless_chooser_init(NwamWirelessChooser *self)
 
     g_signal_connect(self->prv->daemon, "notify::status", G_CALLBACK(daemon_status_changed), (gpointer)self);
     g_signal_connect(self->prv->daemon, "notify::active-ncp", G_CALLBACK(daemon_active_ncp_changed), (gpointer) self);
-    g_signal_connect(self->prv->daemon, "add",
-                     G_CALLBACK(daemon_add_object), (gpointer)self);
-
-    g_signal_connect(self->prv->daemon, "remove",
-                     G_CALLBACK(daemon_remove_object), (gpointer)self);
 
     nwam_pref_refresh(NWAM_PREF_IFACE(self), NULL, TRUE);
 }
 
-static void
-foreach_wifi_in_ncu_add_to_list_store(gpointer key, gpointer value, gpointer user_data)
-{
-    NwamuiWifiNet          *wifi  = value;
-    GtkTreeModel           *model = (GtkTreeModel*)user_data;
-    GtkTreeIter             iter;
-
-    g_return_if_fail(NWAMUI_WIFI_NET(wifi));
-    g_debug("add '%s' to list store", nwamui_object_get_name(NWAMUI_OBJECT(wifi)));
-
-    if (nwamui_wifi_net_get_life_state(wifi) != NWAMUI_WIFI_LIFE_DEAD) {
-        gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-        gtk_list_store_set(GTK_LIST_STORE (model), &iter, 0, wifi, -1);
-    }
-}
-
 static void
 populate_panel( NwamWirelessChooser* self, gboolean set_initial_state )
 {
     g_assert( NWAM_IS_WIRELESS_CHOOSER(self));
 
     if (set_initial_state) {
-        NwamuiObject *ncp   = nwamui_daemon_get_active_ncp(self->prv->daemon);
         GtkTreeModel *model = gtk_tree_view_get_model(self->prv->wifi_tv);
 
-        gtk_widget_hide (GTK_WIDGET(self->prv->wifi_tv));
-
-        nwamui_util_set_busy_cursor( GTK_WIDGET(self->prv->wireless_chooser) );
-
-        gtk_widget_set_sensitive(GTK_WIDGET(self->prv->connect_wireless_refresh_btn), FALSE);
-
-        gtk_list_store_clear (GTK_LIST_STORE(model));
-
-        /* Init WiFis */
-        if (ncp) {
-            nwamui_ncp_foreach_ncu_foreach_wifi_info(NWAMUI_NCP(ncp), foreach_wifi_in_ncu_add_to_list_store, (gpointer)model);
-            g_object_unref(ncp);
-        }
-
-        gtk_widget_show (GTK_WIDGET(self->prv->wifi_tv));
-
-        nwamui_util_restore_default_cursor(GTK_WIDGET(self->prv->wireless_chooser));
-
-        gtk_widget_set_sensitive(GTK_WIDGET(self->prv->connect_wireless_refresh_btn), TRUE);
+        /* Only the networks which came or went are touched, the rows left
+         * and so the selection and the scroll position stay as they are.
+         * Scan results in between arrive through the model itself.
+         */
+        nwamui_object_list_model_reload(NWAMUI_OBJECT_LIST_MODEL(model));
     } else {
         /* Populate WiFis */
         nwamui_daemon_wifi_start_scan(self->prv->daemon);
@@ -655,37 +619,6 @@ daemon_active_ncp_changed(NwamuiDaemon *daemon, GParamSpec *arg1, gpointer data)
     nwam_pref_refresh(NWAM_PREF_IFACE(self), NULL, TRUE);
 }
 
-static void
-daemon_add_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
-{
-    NwamWirelessChooser        *self  = NWAM_WIRELESS_CHOOSER(user_data);
-    NwamWirelessChooserPrivate *prv   = self->prv;
-    GtkTreeModel               *model = gtk_tree_view_get_model(prv->wifi_tv);
-    GtkTreeIter                 iter;
-
-    if (NWAMUI_IS_WIFI_NET(object) && !NWAMUI_IS_KNOWN_WLAN(object)) {
-        if (!capplet_model_find_object(model, G_OBJECT(object), &iter)) {
-            gtk_list_store_prepend(GTK_LIST_STORE(model), &iter);
-            gtk_list_store_set(GTK_LIST_STORE(model), &iter, 0, object, -1);
-        }
-    }
-}
-
-static void
-daemon_remove_object(NwamuiDaemon *daemon, NwamuiObject* object, gpointer user_data)
-{
-    NwamWirelessChooser        *self  = NWAM_WIRELESS_CHOOSER(user_data);
-    NwamWirelessChooserPrivate *prv   = self->prv;
-    GtkTreeModel               *model = gtk_tree_view_get_model(prv->wifi_tv);
-    GtkTreeIter                 iter;
-
-    if (NWAMUI_IS_WIFI_NET(object) && !NWAMUI_IS_KNOWN_WLAN(object)) {
-        if (capplet_model_find_object(model, G_OBJECT(object), &iter)) {
-            gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
-        }
-    }
-}
-
 static void
 add_any_new_wifi_to_fav(GObject *gobject, GParamSpec *arg1, gpointer data)
 {
@@ -433,41 +433,69 @@ change_essid_cbentry_model(GtkComboBoxEntry *cbentry)
   gtk_cell_layout_add_attribute (GTK_CELL_LAYOUT (cbentry), pix_renderer, "pixbuf", 1);
 }
 
+/* Map the scanned WLANs to the columns of change_essid_cbentry_model. */
 static void
-foreach_wifi_in_ncu_add_to_list_store(gpointer key, gpointer value, gpointer user_data)
+essid_model_modify_func(GtkTreeModel *model,
+  GtkTreeIter *iter,
+  GValue *value,
+  gint column,
+  gpointer data)
 {
-    NwamuiWifiNet          *wifi  = (NwamuiWifiNet *)value;
-    GtkTreeModel           *model = (GtkTreeModel*)user_data;
-    GdkPixbuf              *icon;
-    GtkTreeIter             iter;
+    GtkTreeIter             child_iter;
+    NwamuiObject           *wifi;
     nwamui_wifi_security_t  sec;
-    const gchar*            essid;
 
-    g_return_if_fail(wifi && NWAMUI_WIFI_NET(wifi));
-    
-    if (nwamui_wifi_net_get_life_state(wifi) != NWAMUI_WIFI_LIFE_DEAD) {
-        essid = nwamui_object_get_name(NWAMUI_OBJECT(wifi));
-        sec = nwamui_wifi_net_get_security(wifi);
-        icon = nwamui_util_get_network_security_icon(sec, TRUE);
-    
-        gtk_list_store_append(GTK_LIST_STORE(model), &iter);
-        gtk_list_store_set(GTK_LIST_STORE (model), &iter, 0, essid, 1, icon, 2, (gint)sec, -1);
+    gtk_tree_model_filter_convert_iter_to_child_iter(GTK_TREE_MODEL_FILTER(model), &child_iter, iter);
+    wifi = nwamui_object_list_model_get_object(
+        NWAMUI_OBJECT_LIST_MODEL(gtk_tree_model_filter_get_model(GTK_TREE_MODEL_FILTER(model))),
+        &child_iter);
+    g_return_if_fail(wifi);
+
+    sec = nwamui_wifi_net_get_security(NWAMUI_WIFI_NET(wifi));
 
-        g_object_unref(icon);
+    switch (column) {
+    case 0:
+        g_value_set_string(value, nwamui_object_get_name(wifi));
+        break;
+    case 1:
+        g_value_take_object(value, nwamui_util_get_network_security_icon(sec, TRUE));
+        break;
+    case 2:
+        g_value_set_int(value, (gint)sec);
+        break;
+    default:
+        break;
     }
+    g_object_unref(wifi);
 }
 
 static void 
 populate_essid_combo(NwamWirelessDialog *self, GtkComboBoxEntry *cbentry)
 {
     GtkTreeModel    *model;
-    GList           *list = NULL;
     
-    model = gtk_combo_box_get_model(GTK_COMBO_BOX(cbentry));
-    gtk_list_store_clear (GTK_LIST_STORE (model)); /* Empry list */
-
     if (self->prv->ncu) {
-        nwamui_ncu_wifi_hash_foreach(self->prv->ncu, foreach_wifi_in_ncu_add_to_list_store, (gpointer)model);
+        GType        types[] = { G_TYPE_STRING, GDK_TYPE_PIXBUF, G_TYPE_INT };
+        GtkTreeModel *wifi_nets;
+
+        /* Rows follow the scan results of the NCU, nothing is copied. */
+        wifi_nets = nwamui_object_list_model_new_for_wifi_nets(self->prv->ncu);
+        model = gtk_tree_model_filter_new(wifi_nets, NULL);
+        gtk_tree_model_filter_set_modify_func(GTK_TREE_MODEL_FILTER(model),
+          G_N_ELEMENTS(types), types, essid_model_modify_func, NULL, NULL);
+        g_object_unref(wifi_nets);
+
+        gtk_combo_box_set_model(GTK_COMBO_BOX(cbentry), model);
+        g_object_unref(model);
+    } else {
+        model = gtk_combo_box_get_model(GTK_COMBO_BOX(cbentry));
+        if (GTK_IS_LIST_STORE(model)) {
+            gtk_list_store_clear (GTK_LIST_STORE (model)); /* Empry list */
+        } else {
+            model = GTK_TREE_MODEL(gtk_list_store_new (3, G_TYPE_STRING, GDK_TYPE_PIXBUF, G_TYPE_INT));
+            gtk_combo_box_set_model(GTK_COMBO_BOX(cbentry), model);
+            g_object_unref(model);
+        }
     }
 }
 
@@ -40,6 +40,11 @@ G_BEGIN_DECLS
 #include <libnwam.h>
 #endif /* _LIBNWAM_H */
 
+/*
+ * NWAMUI_CORE_ONLY builds against GLib and GObject alone, it is set for
+ * libnwamui-core and for headless consumers of the object model.
+ */
+#ifndef NWAMUI_CORE_ONLY
 #ifndef __GTK_H__
 #include <gtk/gtk.h>
 #endif /* __GTK_H__ */
@@ -47,11 +52,34 @@ G_BEGIN_DECLS
 #ifndef __GDK_PIXBUF_H__
 #include <gdk/gdkpixbuf.h>
 #endif /* __GDK_PIXBUF_H__ */
+#else
+#include <glib-object.h>
+#endif /* NWAMUI_CORE_ONLY */
         
+#ifndef _NWAMUI_SCHEDULER_H
+#include "nwamui_scheduler.h"
+#endif /*_NWAMUI_SCHEDULER_H */
+
+#ifndef _NWAMUI_TRACE_H
+#include "nwamui_trace.h"
+#endif /*_NWAMUI_TRACE_H */
+
+#ifndef _NWAMUI_INSTANCES_H
+#include "nwamui_instances.h"
+#endif /*_NWAMUI_INSTANCES_H */
+
+#ifndef _NWAMUI_FMRI_INDEX_H
+#include "nwamui_fmri_index.h"
+#endif /*_NWAMUI_FMRI_INDEX_H */
+
 #ifndef _NWAMUI_OBJECT_H
 #include "nwamui_object.h"
 #endif /*_NWAMUI_OBJECT_H */
 
+#ifndef _NWAMUI_PROF_STORE_H
+#include "nwamui_prof_store.h"
+#endif /*_NWAMUI_PROF_STORE_H */
+
 #ifndef _NWAMUI_PROF_H
 #include "nwamui_prof.h"
 #endif /*_NWAMUI_PROF_H */
@@ -92,10 +120,34 @@ G_BEGIN_DECLS
 #include "nwamui_enm.h"
 #endif /* _NWAMUI_ENM_H */
 
+#ifndef _NWAMUI_EVENT_SOURCE_H
+#include "nwamui_event_source.h"
+#endif /* _NWAMUI_EVENT_SOURCE_H */
+
 #ifndef _NWAMUI_DAEMON_H
 #include "nwamui_daemon.h"
 #endif /* _NWAMUI_DAEMON_H */
 
+#ifndef _NWAMUI_WIFI_CONNECT_H
+#include "nwamui_wifi_connect.h"
+#endif /* _NWAMUI_WIFI_CONNECT_H */
+
+#ifndef _NWAMUI_COND_SIM_H
+#include "nwamui_cond_sim.h"
+#endif /* _NWAMUI_COND_SIM_H */
+
+#ifndef _NWAMUI_CONFIG_H
+#include "nwamui_config.h"
+#endif /* _NWAMUI_CONFIG_H */
+
+#ifndef _NWAMUI_SNAPSHOT_H
+#include "nwamui_snapshot.h"
+#endif /* _NWAMUI_SNAPSHOT_H */
+
+#ifndef _NWAMUI_EDIT_SESSION_H
+#include "nwamui_edit_session.h"
+#endif /* _NWAMUI_EDIT_SESSION_H */
+
 #ifndef _HELP_REFS_H 
 #include "help_refs.h"
 #endif /* _HELP_REFS_H  */
@@ -182,6 +234,61 @@ typedef enum {
 #define nwamui_error        g_error
 #endif
 
+/* Categorised logging, recorded into an in-memory ring buffer which can be
+ * dumped on demand, see nwamui_log_dump(). The level of the category is
+ * checked before any of the arguments are evaluated, so a disabled
+ * nwamui_log_*() costs a single load and branch.
+ */
+typedef enum {
+    NWAMUI_LOG_CAT_EVENT = 0,
+    NWAMUI_LOG_CAT_SCAN,
+    NWAMUI_LOG_CAT_MENU,
+    NWAMUI_LOG_CAT_COMMIT,
+    NWAMUI_LOG_CAT_NOTIFY,
+    NWAMUI_LOG_CAT_MEM,
+    NWAMUI_LOG_CAT_LAST
+} nwamui_log_category_t;
+
+typedef enum {
+    NWAMUI_LOG_LEVEL_NONE = 0,
+    NWAMUI_LOG_LEVEL_INFO,
+    NWAMUI_LOG_LEVEL_DEBUG
+} nwamui_log_level_t;
+
+extern volatile gint nwamui_log_levels[NWAMUI_LOG_CAT_LAST];
+
+#define nwamui_log_enabled(_cat, _level)  (nwamui_log_levels[(_cat)] >= (_level))
+
+#ifdef G_HAVE_ISO_VARARGS
+#define nwamui_log_info(_cat, _fmt, ...)                                \
+    G_STMT_START {                                                      \
+        if (nwamui_log_enabled((_cat), NWAMUI_LOG_LEVEL_INFO))          \
+            nwamui_log_record((_cat), NWAMUI_LOG_LEVEL_INFO, __func__, _fmt, __VA_ARGS__); \
+    } G_STMT_END
+#define nwamui_log_debug(_cat, _fmt, ...)                               \
+    G_STMT_START {                                                      \
+        if (G_UNLIKELY(nwamui_log_enabled((_cat), NWAMUI_LOG_LEVEL_DEBUG))) \
+            nwamui_log_record((_cat), NWAMUI_LOG_LEVEL_DEBUG, __func__, _fmt, __VA_ARGS__); \
+    } G_STMT_END
+#elif defined(G_HAVE_GNUC_VARARGS)
+#define nwamui_log_info(_cat, _fmt, args...)                            \
+    G_STMT_START {                                                      \
+        if (nwamui_log_enabled((_cat), NWAMUI_LOG_LEVEL_INFO))          \
+            nwamui_log_record((_cat), NWAMUI_LOG_LEVEL_INFO, __func__, _fmt, args); \
+    } G_STMT_END
+#define nwamui_log_debug(_cat, _fmt, args...)                           \
+    G_STMT_START {                                                      \
+        if (G_UNLIKELY(nwamui_log_enabled((_cat), NWAMUI_LOG_LEVEL_DEBUG))) \
+            nwamui_log_record((_cat), NWAMUI_LOG_LEVEL_DEBUG, __func__, _fmt, args); \
+    } G_STMT_END
+#else
+/* Without variadic macros the arguments are always evaluated. */
+#define nwamui_log_info     nwamui_log_info_func
+#define nwamui_log_debug    nwamui_log_debug_func
+extern void nwamui_log_info_func(nwamui_log_category_t cat, const gchar *fmt, ...) G_GNUC_PRINTF(2, 3);
+extern void nwamui_log_debug_func(nwamui_log_category_t cat, const gchar *fmt, ...) G_GNUC_PRINTF(2, 3);
+#endif
+
 enum {
     NWAMUI_ENTRY_VALIDATION_IS_V4               = (1 << 1),     /* Validate IPv4 Style Address */
     NWAMUI_ENTRY_VALIDATION_IS_V6               = (1 << 2),     /* Validate IPv6 Style Address */
@@ -237,29 +344,6 @@ void marshal_VOID__OBJECT_POINTER(GClosure     *closure,
   gpointer      invocation_hint G_GNUC_UNUSED,
   gpointer      marshal_data);
 
-/* UI (GtkBuilder) Handling */
-typedef enum {
-    NWAMUI_UI_FILE_DEFAULT = 0,
-    NWAMUI_UI_FILE_WIRELESS,
-    NWAMUI_UI_FILE_LAST,
-}
-nwamui_ui_file_index_t;
-
-typedef struct _CappletForeachData {
-	GtkTreeModelForeachFunc foreach_func;
-	gpointer user_data;
-	gpointer user_data1;
-	gpointer ret_data;
-} CappletForeachData;
-
-extern GtkWidget*               nwamui_util_ui_get_widget_from( nwamui_ui_file_index_t  index,  
-                                                                const gchar*            widget_name );
-
-/*
- * (The glade name is kept for code compatibility, for now)
- */
-#define nwamui_util_glade_get_widget( x )   nwamui_util_ui_get_widget_from(NWAMUI_UI_FILE_DEFAULT, (x))
-
 /* Utility Functions */
 extern void                     nwamui_util_default_log_handler_init( void );
 
@@ -267,6 +351,19 @@ extern void                     nwamui_util_set_debug_mode( gboolean enabled );
 
 extern gboolean                 nwamui_util_is_debug_mode( void );
 
+extern void                     nwamui_log_record( nwamui_log_category_t cat,
+                                                   nwamui_log_level_t level,
+                                                   const gchar *func,
+                                                   const gchar *fmt, ... ) G_GNUC_PRINTF(4, 5);
+
+extern void                     nwamui_log_set_level( nwamui_log_category_t cat, nwamui_log_level_t level );
+
+extern void                     nwamui_log_parse_spec( const gchar *spec );
+
+extern void                     nwamui_log_dump( gint fd );
+
+extern gboolean                 nwamui_log_install_dump_signal( gint signo );
+
 extern gchar*                   nwamui_util_wifi_sec_to_string( nwamui_wifi_security_t wireless_sec );
 
 extern gchar*                   nwamui_util_wifi_sec_to_short_string( nwamui_wifi_security_t wireless_sec );
@@ -281,52 +378,6 @@ extern void                     nwamui_util_free_obj_list( GList* obj_list );
 
 extern GList*                   nwamui_util_copy_obj_list( GList* obj_list );
 
-extern GdkPixbuf*               nwamui_util_get_network_status_icon(nwamui_ncu_type_t ncu_type, nwamui_wifi_signal_strength_t strength, nwamui_daemon_status_t net_status, gint size);
-
-extern GdkPixbuf*               nwamui_util_get_ncu_status_icon( NwamuiNcu* ncu, gint size );
-
-extern const gchar*             nwamui_util_get_ncu_group_icon( NwamuiNcu* ncu  );
-
-extern const gchar*             nwamui_util_get_active_mode_icon( NwamuiObject *object  );
-
-extern GdkPixbuf*               nwamui_util_get_network_type_icon( nwamui_ncu_type_t ncu_type );
-
-extern GdkPixbuf*               nwamui_util_get_env_status_icon( GtkStatusIcon* status_icon, nwamui_daemon_status_t daemon_status, gint force_size );
-
-extern GdkPixbuf*               nwamui_util_get_wireless_strength_icon_with_size( nwamui_wifi_signal_strength_t signal_strength, 
-                                                                                  nwamui_wireless_icon_type_t icon_type,
-                                                                                  gint size);
-
-extern GdkPixbuf*               nwamui_util_get_network_security_icon( nwamui_wifi_security_t sec_type,
-                                                                        gboolean small);
-
-extern void                     nwamui_util_show_help( const gchar* link_name );
-
-extern gchar*                   nwamui_util_rename_dialog_run(GtkWindow* parent_window, const gchar* title, const gchar* current_name);
-
-extern gboolean                 nwamui_util_ask_yes_no(GtkWindow* parent_window, const gchar* title, const gchar* message);
-
-extern gboolean                 nwamui_util_confirm_removal(GtkWindow* parent_window, const gchar* title, const gchar* message);
-
-extern gboolean                 nwamui_util_ask_about_dup_obj(GtkWindow* parent_window, NwamuiObject* obj );
-
-extern void                     nwamui_util_show_message(   GtkWindow* parent_window, 
-                                                            GtkMessageType type, 
-                                                            const gchar* title, 
-                                                            const gchar* message, 
-                                                            gboolean block );
-
-extern void                     nwamui_util_set_busy_cursor( GtkWidget *widget );
-
-extern void                     nwamui_util_restore_default_cursor( GtkWidget *widget );
-
-extern void nwamui_util_set_widget_a11y_info(   GtkWidget      *widget, 
-                                                const gchar    *name,
-                                                const gchar    *description );
-
-extern void nwamui_util_set_a11y_label_for_widget(  GtkLabel       *label,
-                                                    GtkWidget      *widget );
-
 extern GList*                   nwamui_util_map_condition_strings_to_object_list( char** conditions );
 
 extern char**                   nwamui_util_map_object_list_to_condition_strings( GList* conditions, guint *len );
@@ -353,31 +404,6 @@ extern gboolean                 nwamui_util_get_interface_address(  const char
                                                                     gint        *prefixlen_p, 
                                                                     gboolean    *is_dhcp_p );
 
-extern gboolean                 nwamui_util_set_entry_smf_fmri_completion( GtkEntry* entry );
-
-extern void                     nwamui_util_set_entry_validation(   GtkEntry*           entry, 
-                                                                    nwamui_entry_validation_flags_t  flags,
-                                                                    gboolean            validate_on_focus_out );
-
-extern gboolean                 nwamui_util_validate_text_entry(    GtkWidget           *widget,
-                                                                    const gchar         *text,
-                                                                    nwamui_entry_validation_flags_t  flags,
-                                                                    gboolean            show_error_dialog,
-                                                                    gboolean            show_error_dialog_blocks );
-
-extern void                     nwamui_util_set_entry_validation_flags(  GtkEntry* entry, 
-                                                                         nwamui_entry_validation_flags_t  flags );
-
-extern void                     nwamui_util_unset_entry_validation( GtkEntry* entry );
-
-extern gboolean                 nwamui_util_validate_text_entry(    GtkWidget           *widget,
-                                                                    const gchar         *text,
-                                                                    nwamui_entry_validation_flags_t  flags,
-                                                                    gboolean            show_error_dialog,
-                                                                    gboolean            show_error_dialog_blocks );
-
-extern void                     nwamui_util_window_title_append_hostname( GtkDialog* dialog );
-
 extern GList*                   nwamui_util_parse_string_to_glist( const gchar* str );
 
 extern gchar*                   nwamui_util_glist_to_comma_string( GList* list );
@@ -394,19 +420,18 @@ extern gchar*                   nwamui_util_join_address_prefix( gboolean v6,
 extern void                     nwamui_util_foreach_nwam_object_dup_and_append_to_list(NwamuiObject *obj, GList **list);
 extern gint                     nwamui_util_find_nwamui_object_by_name(gconstpointer obj, gconstpointer name);
 extern gint                     nwamui_util_find_active_nwamui_object(gconstpointer data, gconstpointer user_data);
-extern void                     nwamui_util_foreach_nwam_object_add_to_list_store(gpointer object, gpointer list_store);
-
-gboolean capplet_model_find_object(GtkTreeModel *model, GObject *object, GtkTreeIter *iter);
-
-gboolean capplet_model_find_object_with_parent(GtkTreeModel *model, GtkTreeIter *parent, GObject *object, GtkTreeIter *iter);
-
-gboolean capplet_model_foreach(GtkTreeModel *model, GtkTreeModelForeachFunc func, gpointer user_data, GtkTreeIter *iter);
-
-gboolean capplet_model_1_level_foreach(GtkTreeModel *model, GtkTreeIter *parent, GtkTreeModelForeachFunc func, gpointer user_data, GtkTreeIter *iter);
 
 const gchar* debug_g_type_name(gpointer object);
 
-extern void debug_response_id( gint responseid );
+#ifndef NWAMUI_CORE_ONLY
+#ifndef _NWAMUI_GTK_H
+#include "nwamui_gtk.h"
+#endif /* _NWAMUI_GTK_H */
+
+#ifndef _NWAMUI_OBJECT_LIST_MODEL_H
+#include "nwamui_object_list_model.h"
+#endif /* _NWAMUI_OBJECT_LIST_MODEL_H */
+#endif /* NWAMUI_CORE_ONLY */
 
 G_END_DECLS
 
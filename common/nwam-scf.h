@@ -31,8 +31,10 @@
 #ifndef nwam_scf_H
 #define	nwam_scf_H
 
-// The below functions should be used directly from the
-// minilander "libnwam.h", but it's not yet available. 
+/*
+ * The below functions should be used directly from the
+ * minilander "libnwam.h", but it's not yet available.
+ */
 #define	NWAMUI_FMRI	"svc:/network/physical:default"
 #define	NWAM_NETCFG_PG		"netcfg"
 #define	NWAM_NETCFG_ACTIVE_NCP_PROP	"active_ncp"
@@ -55,5 +57,9 @@ typedef struct scf_resources {
 
 int get_active_ncp(char *namestr, size_t namelen, scf_error_t *serr);
 
+/* Private notification interfaces of libscf, from libscf_priv.h. */
+extern int _scf_notify_add_pgname(scf_handle_t *, const char *);
+extern int _scf_notify_wait(scf_propertygroup_t *, char *, size_t);
+
 #endif	/* nwam_scf_H */
 
@@ -673,6 +673,35 @@ nwamui_cond_get_object (NwamuiCond *self)
     return( object );
 }
 
+/**
+ * nwamui_cond_get_rating:
+ * @nwamui_cond: a #NwamuiCond.
+ * @returns: the rating nwamd gives the condition when it is satisfied, the
+ * best rated location wins.
+ *
+ **/
+extern guint64
+nwamui_cond_get_rating (NwamuiCond *self)
+{
+    nwam_error_t    nerr;
+    uint64_t        rating = 0;
+
+    g_return_val_if_fail (NWAMUI_IS_COND (self), 0);
+
+    if ( self->prv->field >= NWAMUI_COND_FIELD_LAST ) {
+        return( 0 );
+    }
+
+    if ( (nerr = nwam_condition_rate( map_field_to_condition_obj( self->prv->field ),
+                                      map_op_to_condition( self->prv->op ),
+                                      &rating )) != NWAM_SUCCESS ) {
+        nwamui_debug("Failed to rate condition: %s", nwam_strerror(nerr));
+        return( 0 );
+    }
+
+    return( (guint64)rating );
+}
+
 extern const gchar*
 nwamui_cond_field_to_str( nwamui_cond_field_t field )
 {
@@ -125,6 +125,8 @@ extern gchar*               nwamui_cond_get_value ( NwamuiCond *self );
 extern void                 nwamui_cond_set_object ( NwamuiCond *self, GObject* object );
 extern GObject*             nwamui_cond_get_object ( NwamuiCond *self );
 
+extern guint64              nwamui_cond_get_rating ( NwamuiCond *self );
+
 /* Utility functions to convert enum to a displayable string */
 extern const gchar*         nwamui_cond_op_to_str( nwamui_cond_op_t op );
 extern const gchar*         nwamui_cond_field_to_str( nwamui_cond_field_t field );
@@ -0,0 +1,851 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_cond_sim.c
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "libnwamui.h"
+
+typedef struct {
+    guint8      family;
+    guint8      bytes[16];
+} sim_addr_t;
+
+struct _nwamui_cond_env {
+    /* Normalised value -> itself, per field */
+    GHashTable *values[NWAMUI_COND_FIELD_LAST];
+    GArray     *addrs;                              /* sim_addr_t */
+};
+
+typedef enum {
+    SIM_MATCH_EQUAL,        /* Hash lookup of the value */
+    SIM_MATCH_SUBSTRING,    /* Any value contains the pattern */
+    SIM_MATCH_PREFIX,       /* Any address is in the prefix */
+    SIM_MATCH_NEVER         /* Can't be evaluated, e.g. a bad address */
+} sim_match_t;
+
+typedef struct {
+    nwamui_cond_field_t field;
+    nwamui_cond_op_t    op;
+    sim_match_t         match;
+    gboolean            negate;
+    gchar              *value;          /* Normalised */
+    guint8              family;
+    guint8              full_bytes;     /* Bytes of the prefix compared as is */
+    guint8              tail_mask;      /* Mask of the last, partial byte */
+    guint8              addr[16];       /* Masked by the prefix length */
+    guint64             rating;
+} sim_pred_t;
+
+typedef struct {
+    gchar                          *name;
+    nwamui_cond_activation_mode_t   activation_mode;
+    gboolean                        enabled;
+    sim_pred_t                     *preds;
+    guint                           n_preds;
+    guint64                         total_rating;
+} sim_loc_t;
+
+struct _nwamui_cond_sim {
+    GPtrArray  *locs;                               /* sim_loc_t* */
+};
+
+/* Same order as nwamui_cond_field_t, the libnwam condition keywords. */
+static const gchar *env_keywords[NWAMUI_COND_FIELD_LAST] = {
+    "ncp",
+    "ncu",
+    "enm",
+    "loc",
+    "ip-address",
+    "advertised-domain",
+    "system-domain",
+    "essid",
+    "bssid",
+};
+
+static gboolean
+parse_address(const gchar *str, sim_addr_t *addr, guint *prefix_len)
+{
+    gchar      *host = g_strstrip(g_strdup(str));
+    gchar      *slash;
+    gchar      *end;
+    guint       max_len;
+    gulong      len;
+
+    if ((slash = strchr(host, '/')) != NULL) {
+        *slash++ = '\0';
+    }
+
+    memset(addr, 0, sizeof(*addr));
+    if (inet_pton(AF_INET, host, addr->bytes) == 1) {
+        addr->family = AF_INET;
+        max_len = 32;
+    } else if (inet_pton(AF_INET6, host, addr->bytes) == 1) {
+        addr->family = AF_INET6;
+        max_len = 128;
+    } else {
+        g_free(host);
+        return FALSE;
+    }
+
+    *prefix_len = max_len;
+    if (slash != NULL && *slash != '\0') {
+        len = strtoul(slash, &end, 10);
+        if (*end != '\0' || len > max_len) {
+            g_free(host);
+            return FALSE;
+        }
+        *prefix_len = len;
+    }
+    g_free(host);
+    return TRUE;
+}
+
+static gchar*
+normalize_value(nwamui_cond_field_t field, const gchar *value)
+{
+    gchar  *str;
+    gsize   len;
+
+    switch (field) {
+    case NWAMUI_COND_FIELD_ADV_DOMAIN:
+    case NWAMUI_COND_FIELD_SYS_DOMAIN:
+        /* Domains compare case insensitively, without the root dot. */
+        str = g_strstrip(g_ascii_strdown(value, -1));
+        len = strlen(str);
+        if (len > 1 && str[len - 1] == '.') {
+            str[len - 1] = '\0';
+        }
+        return str;
+    case NWAMUI_COND_FIELD_BSSID:
+        return g_strstrip(g_ascii_strdown(value, -1));
+    default:
+        return g_strdup(value);
+    }
+}
+
+extern nwamui_cond_env_t*
+nwamui_cond_env_new(void)
+{
+    nwamui_cond_env_t  *env = g_new0(nwamui_cond_env_t, 1);
+    gint                i;
+
+    for (i = 0; i < NWAMUI_COND_FIELD_LAST; i++) {
+        env->values[i] = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+    env->addrs = g_array_new(FALSE, FALSE, sizeof(sim_addr_t));
+
+    return env;
+}
+
+extern void
+nwamui_cond_env_free(nwamui_cond_env_t *env)
+{
+    gint    i;
+
+    if (env == NULL) {
+        return;
+    }
+    for (i = 0; i < NWAMUI_COND_FIELD_LAST; i++) {
+        g_hash_table_destroy(env->values[i]);
+    }
+    g_array_free(env->addrs, TRUE);
+    g_free(env);
+}
+
+/**
+ * nwamui_cond_env_add:
+ *
+ * Add a value of a field to the simulated environment, e.g. an online NCU,
+ * an address or a visible BSSID. Addresses may carry a prefix length, it
+ * is ignored.
+ *
+ * @returns: FALSE if the value can't be parsed.
+ **/
+extern gboolean
+nwamui_cond_env_add(nwamui_cond_env_t *env, nwamui_cond_field_t field, const gchar *value)
+{
+    gchar      *str;
+    sim_addr_t  addr;
+    guint       prefix_len;
+
+    g_return_val_if_fail(env != NULL, FALSE);
+    g_return_val_if_fail(field < NWAMUI_COND_FIELD_LAST, FALSE);
+    g_return_val_if_fail(value != NULL, FALSE);
+
+    if (field == NWAMUI_COND_FIELD_IP_ADDRESS) {
+        if (!parse_address(value, &addr, &prefix_len)) {
+            return FALSE;
+        }
+        g_array_append_val(env->addrs, addr);
+    }
+
+    str = normalize_value(field, value);
+    g_hash_table_replace(env->values[field], str, str);
+    return TRUE;
+}
+
+/**
+ * nwamui_cond_env_parse:
+ *
+ * Add the values of a specification like
+ * "ncu=net0,ip-address=10.1.2.3,essid=home" to the environment. The keys
+ * are the libnwam condition keywords.
+ *
+ * @returns: FALSE if a key is unknown or a value can't be parsed.
+ **/
+extern gboolean
+nwamui_cond_env_parse(nwamui_cond_env_t *env, const gchar *spec)
+{
+    gchar     **items;
+    gchar     **item;
+    gchar      *eq;
+    gboolean    ret = TRUE;
+    gint        i;
+
+    g_return_val_if_fail(env != NULL, FALSE);
+    g_return_val_if_fail(spec != NULL, FALSE);
+
+    items = g_strsplit(spec, ",", 0);
+    for (item = items; *item != NULL; item++) {
+        g_strstrip(*item);
+        if (**item == '\0') {
+            continue;
+        }
+        if ((eq = strchr(*item, '=')) == NULL) {
+            nwamui_warning("Missing value of '%s'", *item);
+            ret = FALSE;
+            continue;
+        }
+        *eq++ = '\0';
+        g_strstrip(*item);
+
+        for (i = 0; i < NWAMUI_COND_FIELD_LAST; i++) {
+            if (g_ascii_strcasecmp(*item, env_keywords[i]) == 0) {
+                break;
+            }
+        }
+        if (i == NWAMUI_COND_FIELD_LAST) {
+            nwamui_warning("Unknown condition keyword '%s'", *item);
+            ret = FALSE;
+        } else if (!nwamui_cond_env_add(env, (nwamui_cond_field_t)i, eq)) {
+            nwamui_warning("Invalid %s '%s'", env_keywords[i], eq);
+            ret = FALSE;
+        }
+    }
+    g_strfreev(items);
+
+    return ret;
+}
+
+/**
+ * nwamui_cond_env_to_string:
+ * @returns: the environment in the form nwamui_cond_env_parse() takes.
+ **/
+extern gchar*
+nwamui_cond_env_to_string(const nwamui_cond_env_t *env)
+{
+    GString        *str = g_string_new(NULL);
+    GHashTableIter  iter;
+    gpointer        key;
+    gint            i;
+
+    g_return_val_if_fail(env != NULL, NULL);
+
+    for (i = 0; i < NWAMUI_COND_FIELD_LAST; i++) {
+        g_hash_table_iter_init(&iter, env->values[i]);
+        while (g_hash_table_iter_next(&iter, &key, NULL)) {
+            g_string_append_printf(str, "%s%s=%s",
+              str->len > 0 ? "," : "", env_keywords[i], (gchar *)key);
+        }
+    }
+
+    return g_string_free(str, FALSE);
+}
+
+static void
+env_add_ncu(gpointer data, gpointer user_data)
+{
+    NwamuiNcu          *ncu = NWAMUI_NCU(data);
+    nwamui_cond_env_t  *env = (nwamui_cond_env_t *)user_data;
+    NwamuiWifiNet      *wifi;
+    GList              *bssids;
+    GList              *idx;
+    gchar              *str;
+
+    if (!nwamui_object_get_active(NWAMUI_OBJECT(ncu))) {
+        return;
+    }
+
+    if ((str = nwamui_ncu_get_device_name(ncu)) != NULL) {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_NCU, str);
+        g_free(str);
+    }
+    if ((str = nwamui_ncu_get_ipv4_address(ncu)) != NULL) {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_IP_ADDRESS, str);
+        g_free(str);
+    }
+    if ((str = nwamui_ncu_get_ipv6_address(ncu)) != NULL) {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_IP_ADDRESS, str);
+        g_free(str);
+    }
+
+    if (nwamui_ncu_get_ncu_type(ncu) == NWAMUI_NCU_TYPE_WIRELESS &&
+      (wifi = nwamui_ncu_get_wifi_info(ncu)) != NULL) {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_ESSID,
+          nwamui_object_get_name(NWAMUI_OBJECT(wifi)));
+
+        bssids = nwamui_wifi_net_get_bssid_list(wifi);
+        for (idx = bssids; idx; idx = idx->next) {
+            nwamui_cond_env_add(env, NWAMUI_COND_FIELD_BSSID, (gchar *)idx->data);
+            g_free(idx->data);
+        }
+        g_list_free(bssids);
+        g_object_unref(wifi);
+    }
+}
+
+static void
+env_add_enm(gpointer data, gpointer user_data)
+{
+    NwamuiObject       *enm = NWAMUI_OBJECT(data);
+    nwamui_cond_env_t  *env = (nwamui_cond_env_t *)user_data;
+
+    if (nwamui_object_get_active(enm)) {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_ENM, nwamui_object_get_name(enm));
+    }
+}
+
+/**
+ * nwamui_cond_env_new_from_daemon:
+ *
+ * Snapshot the current environment: the active NCP and its online NCUs,
+ * with their addresses and wireless networks, the online ENMs, the
+ * current location and the system domain. The advertised domains are only
+ * known to nwamd, add them with nwamui_cond_env_add() if they matter.
+ **/
+extern nwamui_cond_env_t*
+nwamui_cond_env_new_from_daemon(NwamuiDaemon *daemon)
+{
+    nwamui_cond_env_t  *env;
+    NwamuiObject       *ncp;
+    NwamuiEnv          *loc;
+    gchar               domain[MAXHOSTNAMELEN];
+
+    g_return_val_if_fail(NWAMUI_IS_DAEMON(daemon), NULL);
+
+    env = nwamui_cond_env_new();
+
+    if ((ncp = nwamui_daemon_get_active_ncp(daemon)) != NULL) {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_NCP, nwamui_object_get_name(ncp));
+        nwamui_ncp_foreach_ncu(NWAMUI_NCP(ncp), env_add_ncu, env);
+        g_object_unref(ncp);
+    }
+
+    if ((loc = nwamui_daemon_get_active_env(daemon)) != NULL) {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_LOC,
+          nwamui_object_get_name(NWAMUI_OBJECT(loc)));
+        g_object_unref(loc);
+    }
+
+    nwamui_daemon_foreach_enm(daemon, env_add_enm, env);
+
+    if (getdomainname(domain, sizeof (domain)) == 0 && domain[0] != '\0') {
+        nwamui_cond_env_add(env, NWAMUI_COND_FIELD_SYS_DOMAIN, domain);
+    }
+
+    return env;
+}
+
+/*
+ * Compile one condition. The range and the equality of an address are both
+ * prefix matches, the equality being a full length one.
+ */
+static void
+pred_compile(sim_pred_t *pred, NwamuiCond *cond)
+{
+    sim_addr_t  addr;
+    guint       prefix_len;
+    gchar      *value;
+    guint       i;
+
+    memset(pred, 0, sizeof(*pred));
+    pred->field = nwamui_cond_get_field(cond);
+    pred->op = nwamui_cond_get_oper(cond);
+    pred->rating = nwamui_cond_get_rating(cond);
+    pred->negate = (pred->op == NWAMUI_COND_OP_IS_NOT ||
+      pred->op == NWAMUI_COND_OP_DOES_NOT_INCLUDE ||
+      pred->op == NWAMUI_COND_OP_IS_NOT_IN_RANGE ||
+      pred->op == NWAMUI_COND_OP_DOES_NOT_CONTAIN);
+
+    value = nwamui_cond_get_value(cond);
+    if (value == NULL) {
+        value = g_strdup("");
+    }
+
+    switch (pred->op) {
+    case NWAMUI_COND_OP_CONTAINS:
+    case NWAMUI_COND_OP_DOES_NOT_CONTAIN:
+        pred->match = SIM_MATCH_SUBSTRING;
+        break;
+    case NWAMUI_COND_OP_IS_IN_RANGE:
+    case NWAMUI_COND_OP_IS_NOT_IN_RANGE:
+        pred->match = SIM_MATCH_PREFIX;
+        break;
+    default:
+        pred->match = SIM_MATCH_EQUAL;
+        break;
+    }
+
+    if (pred->field == NWAMUI_COND_FIELD_IP_ADDRESS) {
+        if (pred->match == SIM_MATCH_SUBSTRING ||
+          !parse_address(value, &addr, &prefix_len)) {
+            pred->match = SIM_MATCH_NEVER;
+        } else {
+            if (pred->match == SIM_MATCH_EQUAL) {
+                prefix_len = (addr.family == AF_INET) ? 32 : 128;
+                pred->match = SIM_MATCH_PREFIX;
+            }
+            pred->family = addr.family;
+            pred->full_bytes = prefix_len / 8;
+            pred->tail_mask = (prefix_len % 8) ? (guint8)(0xff << (8 - prefix_len % 8)) : 0;
+            for (i = 0; i < pred->full_bytes; i++) {
+                pred->addr[i] = addr.bytes[i];
+            }
+            if (pred->tail_mask) {
+                pred->addr[i] = addr.bytes[i] & pred->tail_mask;
+            }
+        }
+        pred->value = value;
+    } else {
+        if (pred->match == SIM_MATCH_PREFIX) {
+            pred->match = SIM_MATCH_NEVER;
+        }
+        pred->value = normalize_value(pred->field, value);
+        g_free(value);
+    }
+}
+
+static gboolean
+pred_eval(const sim_pred_t *pred, const nwamui_cond_env_t *env)
+{
+    GHashTableIter      iter;
+    gpointer            key;
+    const sim_addr_t   *addr;
+    gboolean            found = FALSE;
+    guint               i;
+
+    switch (pred->match) {
+    case SIM_MATCH_EQUAL:
+        found = (g_hash_table_lookup(env->values[pred->field], pred->value) != NULL);
+        break;
+    case SIM_MATCH_SUBSTRING:
+        g_hash_table_iter_init(&iter, env->values[pred->field]);
+        while (!found && g_hash_table_iter_next(&iter, &key, NULL)) {
+            found = (strstr((const gchar *)key, pred->value) != NULL);
+        }
+        break;
+    case SIM_MATCH_PREFIX:
+        for (i = 0; !found && i < env->addrs->len; i++) {
+            addr = &g_array_index(env->addrs, sim_addr_t, i);
+            found = (addr->family == pred->family &&
+              memcmp(addr->bytes, pred->addr, pred->full_bytes) == 0 &&
+              (pred->tail_mask == 0 ||
+                (addr->bytes[pred->full_bytes] & pred->tail_mask) == pred->addr[pred->full_bytes]));
+        }
+        break;
+    default:
+        return FALSE;
+    }
+
+    return found != pred->negate;
+}
+
+static gint
+pred_cost(const sim_pred_t *pred)
+{
+    switch (pred->match) {
+    case SIM_MATCH_SUBSTRING:
+    case SIM_MATCH_PREFIX:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/*
+ * For "any" the first satisfied condition decides, so the best rated ones
+ * go first and that one's rating is the score. For "all" the first failing
+ * condition decides, so the cheapest ones go first.
+ */
+static gint
+pred_compare_any(gconstpointer a, gconstpointer b)
+{
+    const sim_pred_t *pa = (const sim_pred_t *)a;
+    const sim_pred_t *pb = (const sim_pred_t *)b;
+
+    if (pa->rating != pb->rating) {
+        return pa->rating > pb->rating ? -1 : 1;
+    }
+    return pred_cost(pa) - pred_cost(pb);
+}
+
+static gint
+pred_compare_all(gconstpointer a, gconstpointer b)
+{
+    return pred_cost((const sim_pred_t *)a) - pred_cost((const sim_pred_t *)b);
+}
+
+static gboolean
+loc_eval(const sim_loc_t *loc, const nwamui_cond_env_t *env, guint64 *score)
+{
+    guint   i;
+
+    *score = 0;
+
+    switch (loc->activation_mode) {
+    case NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY:
+        for (i = 0; i < loc->n_preds; i++) {
+            if (pred_eval(&loc->preds[i], env)) {
+                *score = loc->preds[i].rating;
+                return TRUE;
+            }
+        }
+        return FALSE;
+    case NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL:
+        if (loc->n_preds == 0) {
+            return FALSE;
+        }
+        for (i = 0; i < loc->n_preds; i++) {
+            if (!pred_eval(&loc->preds[i], env)) {
+                return FALSE;
+            }
+        }
+        *score = loc->total_rating;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static void
+sim_loc_free(gpointer data)
+{
+    sim_loc_t  *loc = (sim_loc_t *)data;
+    guint       i;
+
+    for (i = 0; i < loc->n_preds; i++) {
+        g_free(loc->preds[i].value);
+    }
+    g_free(loc->preds);
+    g_free(loc->name);
+    g_free(loc);
+}
+
+extern nwamui_cond_sim_t*
+nwamui_cond_sim_new(void)
+{
+    nwamui_cond_sim_t  *sim = g_new0(nwamui_cond_sim_t, 1);
+
+    sim->locs = g_ptr_array_new();
+    return sim;
+}
+
+extern void
+nwamui_cond_sim_free(nwamui_cond_sim_t *sim)
+{
+    if (sim == NULL) {
+        return;
+    }
+    g_ptr_array_foreach(sim->locs, (GFunc)sim_loc_free, NULL);
+    g_ptr_array_free(sim->locs, TRUE);
+    g_free(sim);
+}
+
+/**
+ * nwamui_cond_sim_add_location:
+ * @conditions: a list of #NwamuiCond, compiled now.
+ **/
+extern void
+nwamui_cond_sim_add_location(nwamui_cond_sim_t *sim,
+  const gchar *name,
+  nwamui_cond_activation_mode_t activation_mode,
+  gboolean enabled,
+  const GList *conditions)
+{
+    sim_loc_t      *loc;
+    const GList    *idx;
+    guint           i;
+
+    g_return_if_fail(sim != NULL);
+    g_return_if_fail(name != NULL);
+
+    loc = g_new0(sim_loc_t, 1);
+    loc->name = g_strdup(name);
+    loc->activation_mode = activation_mode;
+    loc->enabled = enabled;
+    loc->preds = g_new0(sim_pred_t, g_list_length((GList *)conditions));
+
+    for (idx = conditions; idx; idx = idx->next) {
+        /* Skip the "no conditions" place holder */
+        if (nwamui_cond_get_field(NWAMUI_COND(idx->data)) >= NWAMUI_COND_FIELD_LAST) {
+            continue;
+        }
+        pred_compile(&loc->preds[loc->n_preds++], NWAMUI_COND(idx->data));
+    }
+
+    for (i = 0; i < loc->n_preds; i++) {
+        loc->total_rating += loc->preds[i].rating;
+    }
+
+    if (loc->n_preds < 2) {
+        /* Nothing to order */
+    } else if (activation_mode == NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY) {
+        qsort(loc->preds, loc->n_preds, sizeof(sim_pred_t), pred_compare_any);
+    } else {
+        qsort(loc->preds, loc->n_preds, sizeof(sim_pred_t), pred_compare_all);
+    }
+
+    g_ptr_array_add(sim->locs, loc);
+}
+
+static void
+sim_add_daemon_loc(gpointer data, gpointer user_data)
+{
+    NwamuiObject       *obj = NWAMUI_OBJECT(data);
+    nwamui_cond_sim_t  *sim = (nwamui_cond_sim_t *)user_data;
+    GList              *conditions;
+
+    conditions = nwamui_object_get_conditions(obj);
+    nwamui_cond_sim_add_location(sim, nwamui_object_get_name(obj),
+      nwamui_object_get_activation_mode(obj),
+      nwamui_object_get_enabled(obj),
+      conditions);
+    nwamui_util_free_obj_list(conditions);
+}
+
+/**
+ * nwamui_cond_sim_new_from_daemon:
+ * @returns: a simulator of all the locations known to the daemon.
+ **/
+extern nwamui_cond_sim_t*
+nwamui_cond_sim_new_from_daemon(NwamuiDaemon *daemon)
+{
+    nwamui_cond_sim_t  *sim;
+
+    g_return_val_if_fail(NWAMUI_IS_DAEMON(daemon), NULL);
+
+    sim = nwamui_cond_sim_new();
+    nwamui_daemon_foreach_loc(daemon, sim_add_daemon_loc, sim);
+    return sim;
+}
+
+extern guint
+nwamui_cond_sim_get_size(const nwamui_cond_sim_t *sim)
+{
+    g_return_val_if_fail(sim != NULL, 0);
+
+    return sim->locs->len;
+}
+
+/**
+ * nwamui_cond_sim_select:
+ *
+ * Pick the location the way nwamd does: an enabled manual location, else
+ * the best rated conditional location that matches, else Automatic when
+ * there is an address, else NoNet.
+ *
+ * @score: the score of the selected location, may be NULL.
+ * @returns: the name of the selected location, owned by the simulator.
+ **/
+extern const gchar*
+nwamui_cond_sim_select(const nwamui_cond_sim_t *sim, const nwamui_cond_env_t *env, guint64 *score)
+{
+    const sim_loc_t    *loc;
+    const sim_loc_t    *best = NULL;
+    guint64             best_score = 0;
+    guint64             loc_score;
+    guint               i;
+
+    g_return_val_if_fail(sim != NULL, NULL);
+    g_return_val_if_fail(env != NULL, NULL);
+
+    for (i = 0; i < sim->locs->len; i++) {
+        loc = (const sim_loc_t *)g_ptr_array_index(sim->locs, i);
+
+        if (loc->activation_mode == NWAMUI_COND_ACTIVATION_MODE_MANUAL) {
+            if (loc->enabled) {
+                best = loc;
+                best_score = 0;
+                break;
+            }
+        } else if (loc_eval(loc, env, &loc_score) &&
+          (best == NULL || loc_score > best_score)) {
+            best = loc;
+            best_score = loc_score;
+        }
+    }
+
+    if (score) {
+        *score = best_score;
+    }
+
+    if (best != NULL) {
+        return best->name;
+    }
+    return env->addrs->len > 0 ? NWAM_LOC_NAME_AUTOMATIC : NWAM_LOC_NAME_NO_NET;
+}
+
+static gint
+result_compare(gconstpointer a, gconstpointer b)
+{
+    const nwamui_cond_sim_result_t *ra = (const nwamui_cond_sim_result_t *)a;
+    const nwamui_cond_sim_result_t *rb = (const nwamui_cond_sim_result_t *)b;
+
+    if (ra->selected != rb->selected) {
+        return ra->selected ? -1 : 1;
+    }
+    if (ra->matches != rb->matches) {
+        return ra->matches ? -1 : 1;
+    }
+    if (ra->score != rb->score) {
+        return ra->score > rb->score ? -1 : 1;
+    }
+    return g_strcmp0(ra->name, rb->name);
+}
+
+/**
+ * nwamui_cond_sim_run:
+ *
+ * Evaluate every location against the environment.
+ *
+ * @explain: also give the outcome of each condition.
+ * @returns: a list of #nwamui_cond_sim_result_t, the selected location
+ * first, then the matching ones by score. Free it with
+ * nwamui_cond_sim_free_results().
+ **/
+extern GList*
+nwamui_cond_sim_run(const nwamui_cond_sim_t *sim, const nwamui_cond_env_t *env, gboolean explain)
+{
+    const sim_loc_t            *loc;
+    const sim_pred_t           *pred;
+    nwamui_cond_sim_result_t   *result;
+    const gchar                *selected;
+    GList                      *results = NULL;
+    guint                       i;
+    guint                       j;
+
+    g_return_val_if_fail(sim != NULL, NULL);
+    g_return_val_if_fail(env != NULL, NULL);
+
+    selected = nwamui_cond_sim_select(sim, env, NULL);
+
+    for (i = 0; i < sim->locs->len; i++) {
+        loc = (const sim_loc_t *)g_ptr_array_index(sim->locs, i);
+
+        result = g_new0(nwamui_cond_sim_result_t, 1);
+        result->name = g_strdup(loc->name);
+        result->activation_mode = loc->activation_mode;
+        result->enabled = loc->enabled;
+        result->selected = (strcmp(loc->name, selected) == 0);
+
+        switch (loc->activation_mode) {
+        case NWAMUI_COND_ACTIVATION_MODE_MANUAL:
+            result->matches = loc->enabled;
+            if (explain) {
+                result->reasons = g_list_append(result->reasons,
+                  g_strdup(loc->enabled ? _("Enabled manually, it overrides all the conditions") :
+                    _("Only activated manually")));
+            }
+            break;
+        case NWAMUI_COND_ACTIVATION_MODE_SYSTEM:
+            result->matches = result->selected;
+            if (explain) {
+                result->reasons = g_list_append(result->reasons,
+                  g_strdup(strcmp(loc->name, NWAM_LOC_NAME_AUTOMATIC) == 0 ?
+                    _("Activated when no other location matches and there is an address") :
+                    _("Activated when no other location matches and there is no address")));
+            }
+            break;
+        default:
+            result->matches = loc_eval(loc, env, &result->score);
+            if (explain) {
+                for (j = 0; j < loc->n_preds; j++) {
+                    pred = &loc->preds[j];
+                    result->reasons = g_list_append(result->reasons,
+                      g_strdup_printf(_("%s %s %s: %s (rating %" G_GUINT64_FORMAT ")"),
+                        nwamui_cond_field_to_str(pred->field),
+                        nwamui_cond_op_to_str(pred->op),
+                        pred->value,
+                        pred->match == SIM_MATCH_NEVER ? _("can't be evaluated") :
+                        pred_eval(pred, env) ? _("satisfied") : _("not satisfied"),
+                        pred->rating));
+                }
+                if (loc->n_preds == 0) {
+                    result->reasons = g_list_append(result->reasons,
+                      g_strdup(_("No conditions")));
+                }
+            }
+            break;
+        }
+
+        results = g_list_prepend(results, result);
+    }
+
+    return g_list_sort(results, result_compare);
+}
+
+extern void
+nwamui_cond_sim_result_free(nwamui_cond_sim_result_t *result)
+{
+    if (result == NULL) {
+        return;
+    }
+    g_list_foreach(result->reasons, (GFunc)g_free, NULL);
+    g_list_free(result->reasons);
+    g_free(result->name);
+    g_free(result);
+}
+
+extern void
+nwamui_cond_sim_free_results(GList *results)
+{
+    g_list_foreach(results, (GFunc)nwamui_cond_sim_result_free, NULL);
+    g_list_free(results);
+}
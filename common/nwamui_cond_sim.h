@@ -0,0 +1,97 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_cond_sim.h
+ *
+ */
+
+#ifndef _NWAMUI_COND_SIM_H
+#define	_NWAMUI_COND_SIM_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * A what-if simulator for the location activation.
+ *
+ * The conditions of each location are compiled once into predicates with
+ * the string and IP prefix matchers precomputed. A simulated environment
+ * (the online NCUs, the addresses, the ESSIDs, the domains and so on) is
+ * then evaluated against all of them, and the location nwamd would select
+ * is reported together with the score of each location.
+ *
+ * The simulator is a snapshot, it doesn't follow later changes of the
+ * locations.
+ */
+
+typedef struct _nwamui_cond_env     nwamui_cond_env_t;
+typedef struct _nwamui_cond_sim     nwamui_cond_sim_t;
+
+typedef struct {
+    gchar                          *name;
+    nwamui_cond_activation_mode_t   activation_mode;
+    gboolean                        enabled;
+    gboolean                        matches;
+    gboolean                        selected;
+    guint64                         score;
+    GList                          *reasons;   /* gchar*, one per condition */
+} nwamui_cond_sim_result_t;
+
+extern nwamui_cond_env_t*   nwamui_cond_env_new(void);
+extern nwamui_cond_env_t*   nwamui_cond_env_new_from_daemon(NwamuiDaemon *daemon);
+extern void                 nwamui_cond_env_free(nwamui_cond_env_t *env);
+extern gboolean             nwamui_cond_env_add(nwamui_cond_env_t *env,
+                                                nwamui_cond_field_t field,
+                                                const gchar *value);
+extern gboolean             nwamui_cond_env_parse(nwamui_cond_env_t *env,
+                                                  const gchar *spec);
+extern gchar*               nwamui_cond_env_to_string(const nwamui_cond_env_t *env);
+
+extern nwamui_cond_sim_t*   nwamui_cond_sim_new(void);
+extern nwamui_cond_sim_t*   nwamui_cond_sim_new_from_daemon(NwamuiDaemon *daemon);
+extern void                 nwamui_cond_sim_free(nwamui_cond_sim_t *sim);
+extern void                 nwamui_cond_sim_add_location(nwamui_cond_sim_t *sim,
+                                                         const gchar *name,
+                                                         nwamui_cond_activation_mode_t activation_mode,
+                                                         gboolean enabled,
+                                                         const GList *conditions);
+extern guint                nwamui_cond_sim_get_size(const nwamui_cond_sim_t *sim);
+extern const gchar*         nwamui_cond_sim_select(const nwamui_cond_sim_t *sim,
+                                                   const nwamui_cond_env_t *env,
+                                                   guint64 *score);
+extern GList*               nwamui_cond_sim_run(const nwamui_cond_sim_t *sim,
+                                                const nwamui_cond_env_t *env,
+                                                gboolean explain);
+extern void                 nwamui_cond_sim_result_free(nwamui_cond_sim_result_t *result);
+extern void                 nwamui_cond_sim_free_results(GList *results);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_COND_SIM_H */
@@ -0,0 +1,1299 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_config.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "libnwamui.h"
+
+/* Also the order the sections are applied in */
+typedef enum {
+    CONFIG_SECTION_NCP = 0,
+    CONFIG_SECTION_ENM,
+    CONFIG_SECTION_LOC,
+    CONFIG_SECTION_KNOWN_WLAN,
+    CONFIG_SECTION_LAST
+} config_section_t;
+
+typedef int (*config_prop_cb_t)(const char *name, nwam_value_t value, void *data);
+
+typedef nwam_error_t (*config_get_prop_func_t)(gpointer handle, const char *name, nwam_value_t *value);
+typedef nwam_error_t (*config_set_prop_func_t)(gpointer handle, const char *name, nwam_value_t value);
+typedef nwam_error_t (*config_delete_prop_func_t)(gpointer handle, const char *name);
+typedef nwam_error_t (*config_read_only_func_t)(const char *name, boolean_t *read_only);
+typedef nwam_error_t (*config_walk_props_func_t)(gpointer handle, config_prop_cb_t cb, void *data, uint64_t flags, int *ret);
+typedef nwam_error_t (*config_validate_func_t)(gpointer handle, const char **errprop);
+typedef nwam_error_t (*config_commit_func_t)(gpointer handle, uint64_t flags);
+typedef void         (*config_free_func_t)(gpointer handle);
+
+typedef struct {
+    const gchar                *keyword;
+    config_get_prop_func_t      get_prop;
+    config_set_prop_func_t      set_prop;
+    config_delete_prop_func_t   delete_prop;
+    config_read_only_func_t     read_only;
+    config_walk_props_func_t    walk_props;
+    config_validate_func_t      validate;
+    config_commit_func_t        commit;
+    uint64_t                    commit_flags;
+    config_free_func_t          free;
+} config_ops_t;
+
+/* The NCP section holds NCUs, so it uses the NCU functions. */
+static const config_ops_t config_ops[CONFIG_SECTION_LAST] = {
+    { "ncp",
+      (config_get_prop_func_t)nwam_ncu_get_prop_value,
+      (config_set_prop_func_t)nwam_ncu_set_prop_value,
+      (config_delete_prop_func_t)nwam_ncu_delete_prop,
+      nwam_ncu_prop_read_only,
+      (config_walk_props_func_t)nwam_ncu_walk_props,
+      (config_validate_func_t)nwam_ncu_validate,
+      (config_commit_func_t)nwam_ncu_commit,
+      0,
+      (config_free_func_t)nwam_ncu_free },
+    { "enm",
+      (config_get_prop_func_t)nwam_enm_get_prop_value,
+      (config_set_prop_func_t)nwam_enm_set_prop_value,
+      (config_delete_prop_func_t)nwam_enm_delete_prop,
+      nwam_enm_prop_read_only,
+      (config_walk_props_func_t)nwam_enm_walk_props,
+      (config_validate_func_t)nwam_enm_validate,
+      (config_commit_func_t)nwam_enm_commit,
+      0,
+      (config_free_func_t)nwam_enm_free },
+    { "loc",
+      (config_get_prop_func_t)nwam_loc_get_prop_value,
+      (config_set_prop_func_t)nwam_loc_set_prop_value,
+      (config_delete_prop_func_t)nwam_loc_delete_prop,
+      nwam_loc_prop_read_only,
+      (config_walk_props_func_t)nwam_loc_walk_props,
+      (config_validate_func_t)nwam_loc_validate,
+      (config_commit_func_t)nwam_loc_commit,
+      0,
+      (config_free_func_t)nwam_loc_free },
+    { "known-wlan",
+      (config_get_prop_func_t)nwam_known_wlan_get_prop_value,
+      (config_set_prop_func_t)nwam_known_wlan_set_prop_value,
+      (config_delete_prop_func_t)nwam_known_wlan_delete_prop,
+      NULL,
+      (config_walk_props_func_t)nwam_known_wlan_walk_props,
+      (config_validate_func_t)nwam_known_wlan_validate,
+      (config_commit_func_t)nwam_known_wlan_commit,
+      NWAM_FLAG_KNOWN_WLAN_NO_COLLISION_CHECK,
+      (config_free_func_t)nwam_known_wlan_free },
+};
+
+typedef struct {
+    FILE               *fp;
+    guint               flags;
+    config_section_t    section;
+    GString            *line;
+    gboolean            ok;
+} config_export_t;
+
+typedef struct {
+    gchar          *name;
+    nwam_value_t    value;
+} config_prop_t;
+
+typedef struct {
+    config_section_t    section;
+    gchar              *ncp;        /* NCUs only */
+    gchar              *name;       /* As in the stream, e.g. "ip:net0" */
+    GList              *props;      /* config_prop_t* */
+    guint               line;
+    gpointer            handle;
+    gboolean            created;
+    gboolean            changed;
+} config_object_t;
+
+typedef struct {
+    GList          *objects[CONFIG_SECTION_LAST];   /* config_object_t* */
+    GHashTable     *ncps;                           /* Name -> handle, NULL if skipped */
+    GHashTable     *new_ncps;                       /* Names of the NCPs created on commit */
+    guint           flags;
+    GFunc           report;
+    gpointer        report_data;
+    guint           n_errors;
+} config_import_t;
+
+static gboolean
+config_prop_is_secret(config_section_t section, const gchar *name)
+{
+    return (section == CONFIG_SECTION_KNOWN_WLAN &&
+      (strcmp(name, NWAM_KNOWN_WLAN_PROP_KEYNAME) == 0 ||
+        strcmp(name, NWAM_KNOWN_WLAN_PROP_KEYSLOT) == 0));
+}
+
+static gboolean
+config_prop_is_read_only(config_section_t section, const gchar *name)
+{
+    boolean_t   read_only = B_FALSE;
+
+    if (config_ops[section].read_only == NULL ||
+      config_ops[section].read_only(name, &read_only) != NWAM_SUCCESS) {
+        return FALSE;
+    }
+    return read_only ? TRUE : FALSE;
+}
+
+/* Escaping */
+
+static void
+config_append_escaped(GString *str, const gchar *value)
+{
+    for (; *value != '\0'; value++) {
+        if (*value == '\\' || *value == ',' || *value == ';' || *value == '\t') {
+            g_string_append_c(str, '\\');
+        }
+        g_string_append_c(str, *value);
+    }
+}
+
+static gchar*
+config_unescape(const gchar *str)
+{
+    GString    *ret = g_string_new(NULL);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '\\' && str[1] != '\0') {
+            str++;
+        }
+        g_string_append_c(ret, *str);
+    }
+    return g_string_free(ret, FALSE);
+}
+
+/*
+ * Split at the unescaped separators. The escapes are kept, unless this is
+ * the last level of splitting.
+ */
+static gchar**
+config_split(const gchar *str, gchar sep, gboolean unescape)
+{
+    GPtrArray  *parts = g_ptr_array_new();
+    GString    *part = g_string_new(NULL);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '\\' && str[1] != '\0') {
+            if (!unescape) {
+                g_string_append_c(part, *str);
+            }
+            g_string_append_c(part, *++str);
+        } else if (*str == sep) {
+            g_ptr_array_add(parts, g_string_free(part, FALSE));
+            part = g_string_new(NULL);
+        } else {
+            g_string_append_c(part, *str);
+        }
+    }
+    g_ptr_array_add(parts, g_string_free(part, FALSE));
+    g_ptr_array_add(parts, NULL);
+
+    return (gchar **)g_ptr_array_free(parts, FALSE);
+}
+
+/* Values */
+
+static gboolean
+config_append_value(GString *str, nwam_value_t value)
+{
+    nwam_value_type_t   type;
+    boolean_t          *booleans;
+    int64_t            *int64s;
+    uint64_t           *uint64s;
+    char              **strings;
+    uint_t              n;
+    uint_t              i;
+
+    if (nwam_value_get_type(value, &type) != NWAM_SUCCESS) {
+        return FALSE;
+    }
+
+    switch (type) {
+    case NWAM_VALUE_TYPE_BOOLEAN:
+        if (nwam_value_get_boolean_array(value, &booleans, &n) != NWAM_SUCCESS) {
+            return FALSE;
+        }
+        g_string_append(str, "boolean");
+        for (i = 0; i < n; i++) {
+            g_string_append(str, booleans[i] ? ",true" : ",false");
+        }
+        break;
+    case NWAM_VALUE_TYPE_INT64:
+        if (nwam_value_get_int64_array(value, &int64s, &n) != NWAM_SUCCESS) {
+            return FALSE;
+        }
+        g_string_append(str, "int64");
+        for (i = 0; i < n; i++) {
+            g_string_append_printf(str, ",%" G_GINT64_FORMAT, (gint64)int64s[i]);
+        }
+        break;
+    case NWAM_VALUE_TYPE_UINT64:
+        if (nwam_value_get_uint64_array(value, &uint64s, &n) != NWAM_SUCCESS) {
+            return FALSE;
+        }
+        g_string_append(str, "uint64");
+        for (i = 0; i < n; i++) {
+            g_string_append_printf(str, ",%" G_GUINT64_FORMAT, (guint64)uint64s[i]);
+        }
+        break;
+    case NWAM_VALUE_TYPE_STRING:
+        if (nwam_value_get_string_array(value, &strings, &n) != NWAM_SUCCESS) {
+            return FALSE;
+        }
+        g_string_append(str, "string");
+        for (i = 0; i < n; i++) {
+            g_string_append_c(str, ',');
+            config_append_escaped(str, strings[i]);
+        }
+        break;
+    default:
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static nwam_value_t
+config_value_new(const gchar *type, gchar **values, guint n)
+{
+    nwam_value_t    value = NULL;
+    nwam_error_t    nerr = NWAM_INVALID_ARG;
+    gchar          *end;
+    guint           i;
+
+    if (n == 0) {
+        return NULL;
+    }
+
+    if (strcmp(type, "boolean") == 0) {
+        boolean_t  *booleans = g_new(boolean_t, n);
+
+        for (i = 0; i < n; i++) {
+            if (strcmp(values[i], "true") == 0) {
+                booleans[i] = B_TRUE;
+            } else if (strcmp(values[i], "false") == 0) {
+                booleans[i] = B_FALSE;
+            } else {
+                break;
+            }
+        }
+        if (i == n) {
+            nerr = nwam_value_create_boolean_array(booleans, n, &value);
+        }
+        g_free(booleans);
+    } else if (strcmp(type, "int64") == 0) {
+        int64_t    *int64s = g_new(int64_t, n);
+
+        for (i = 0; i < n; i++) {
+            int64s[i] = g_ascii_strtoll(values[i], &end, 10);
+            if (*values[i] == '\0' || *end != '\0') {
+                break;
+            }
+        }
+        if (i == n) {
+            nerr = nwam_value_create_int64_array(int64s, n, &value);
+        }
+        g_free(int64s);
+    } else if (strcmp(type, "uint64") == 0) {
+        uint64_t   *uint64s = g_new(uint64_t, n);
+
+        for (i = 0; i < n; i++) {
+            uint64s[i] = g_ascii_strtoull(values[i], &end, 10);
+            if (*values[i] == '\0' || *end != '\0') {
+                break;
+            }
+        }
+        if (i == n) {
+            nerr = nwam_value_create_uint64_array(uint64s, n, &value);
+        }
+        g_free(uint64s);
+    } else if (strcmp(type, "string") == 0) {
+        nerr = nwam_value_create_string_array(values, n, &value);
+    }
+
+    return (nerr == NWAM_SUCCESS) ? value : NULL;
+}
+
+static gboolean
+config_value_equal(nwam_value_t a, nwam_value_t b)
+{
+    nwam_value_type_t   type_a;
+    nwam_value_type_t   type_b;
+    uint_t              n_a;
+    uint_t              n_b;
+    uint_t              i;
+
+    if (nwam_value_get_type(a, &type_a) != NWAM_SUCCESS ||
+      nwam_value_get_type(b, &type_b) != NWAM_SUCCESS ||
+      type_a != type_b) {
+        return FALSE;
+    }
+
+    switch (type_a) {
+    case NWAM_VALUE_TYPE_BOOLEAN: {
+        boolean_t  *va;
+        boolean_t  *vb;
+
+        if (nwam_value_get_boolean_array(a, &va, &n_a) != NWAM_SUCCESS ||
+          nwam_value_get_boolean_array(b, &vb, &n_b) != NWAM_SUCCESS || n_a != n_b) {
+            return FALSE;
+        }
+        for (i = 0; i < n_a; i++) {
+            if (!va[i] != !vb[i]) {
+                return FALSE;
+            }
+        }
+    }
+        break;
+    case NWAM_VALUE_TYPE_INT64: {
+        int64_t    *va;
+        int64_t    *vb;
+
+        if (nwam_value_get_int64_array(a, &va, &n_a) != NWAM_SUCCESS ||
+          nwam_value_get_int64_array(b, &vb, &n_b) != NWAM_SUCCESS || n_a != n_b) {
+            return FALSE;
+        }
+        for (i = 0; i < n_a; i++) {
+            if (va[i] != vb[i]) {
+                return FALSE;
+            }
+        }
+    }
+        break;
+    case NWAM_VALUE_TYPE_UINT64: {
+        uint64_t   *va;
+        uint64_t   *vb;
+
+        if (nwam_value_get_uint64_array(a, &va, &n_a) != NWAM_SUCCESS ||
+          nwam_value_get_uint64_array(b, &vb, &n_b) != NWAM_SUCCESS || n_a != n_b) {
+            return FALSE;
+        }
+        for (i = 0; i < n_a; i++) {
+            if (va[i] != vb[i]) {
+                return FALSE;
+            }
+        }
+    }
+        break;
+    case NWAM_VALUE_TYPE_STRING: {
+        char      **va;
+        char      **vb;
+
+        if (nwam_value_get_string_array(a, &va, &n_a) != NWAM_SUCCESS ||
+          nwam_value_get_string_array(b, &vb, &n_b) != NWAM_SUCCESS || n_a != n_b) {
+            return FALSE;
+        }
+        for (i = 0; i < n_a; i++) {
+            if (strcmp(va[i], vb[i]) != 0) {
+                return FALSE;
+            }
+        }
+    }
+        break;
+    default:
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Export */
+
+static int
+export_prop(const char *name, nwam_value_t value, void *data)
+{
+    config_export_t    *export = (config_export_t *)data;
+    gsize               len = export->line->len;
+
+    if (!(export->flags & NWAMUI_CONFIG_SECRETS) &&
+      config_prop_is_secret(export->section, name)) {
+        return 0;
+    }
+
+    g_string_append(export->line, name);
+    g_string_append_c(export->line, '=');
+    if (!config_append_value(export->line, value)) {
+        nwamui_warning("Can't export property %s", name);
+        g_string_truncate(export->line, len);
+        return 0;
+    }
+    g_string_append_c(export->line, ';');
+
+    return 0;
+}
+
+static void
+export_object(config_export_t *export, const gchar *name, gpointer handle)
+{
+    nwam_error_t    nerr;
+    int             ret;
+
+    g_string_truncate(export->line, 0);
+    config_append_escaped(export->line, name);
+    g_string_append_c(export->line, '\t');
+
+    if ((nerr = config_ops[export->section].walk_props(handle, export_prop,
+          export, 0, &ret)) != NWAM_SUCCESS) {
+        nwamui_warning("Failed to walk the properties of %s: %s", name, nwam_strerror(nerr));
+        export->ok = FALSE;
+        return;
+    }
+
+    g_string_append_c(export->line, '\n');
+    if (fputs(export->line->str, export->fp) == EOF) {
+        export->ok = FALSE;
+    }
+}
+
+static int
+export_ncu(nwam_ncu_handle_t ncu, void *data)
+{
+    nwam_ncu_type_t     type;
+    char               *name;
+    gchar              *typed_name;
+
+    if (nwam_ncu_get_name(ncu, &name) != NWAM_SUCCESS) {
+        return 0;
+    }
+    if (nwam_ncu_get_ncu_type(ncu, &type) == NWAM_SUCCESS) {
+        typed_name = g_strdup_printf("%s:%s",
+          type == NWAM_NCU_TYPE_LINK ? "datalink" : "ip", name);
+        export_object((config_export_t *)data, typed_name, ncu);
+        g_free(typed_name);
+    }
+    free(name);
+
+    return 0;
+}
+
+static int
+export_ncp(nwam_ncp_handle_t ncp, void *data)
+{
+    config_export_t    *export = (config_export_t *)data;
+    nwam_error_t        nerr;
+    char               *name;
+    int                 ret;
+
+    if (nwam_ncp_get_name(ncp, &name) != NWAM_SUCCESS) {
+        return 0;
+    }
+
+    fprintf(export->fp, "[ncp %s]\n", name);
+    if ((nerr = nwam_ncp_walk_ncus(ncp, export_ncu, data,
+          NWAM_FLAG_NCU_TYPE_CLASS_ALL, &ret)) != NWAM_SUCCESS) {
+        nwamui_warning("Failed to walk the NCUs of %s: %s", name, nwam_strerror(nerr));
+        export->ok = FALSE;
+    }
+    free(name);
+
+    return 0;
+}
+
+static int
+export_enm(nwam_enm_handle_t enm, void *data)
+{
+    char   *name;
+
+    if (nwam_enm_get_name(enm, &name) == NWAM_SUCCESS) {
+        export_object((config_export_t *)data, name, enm);
+        free(name);
+    }
+    return 0;
+}
+
+static int
+export_loc(nwam_loc_handle_t loc, void *data)
+{
+    char   *name;
+
+    if (nwam_loc_get_name(loc, &name) == NWAM_SUCCESS) {
+        export_object((config_export_t *)data, name, loc);
+        free(name);
+    }
+    return 0;
+}
+
+static int
+export_known_wlan(nwam_known_wlan_handle_t wlan, void *data)
+{
+    char   *name;
+
+    if (nwam_known_wlan_get_name(wlan, &name) == NWAM_SUCCESS) {
+        export_object((config_export_t *)data, name, wlan);
+        free(name);
+    }
+    return 0;
+}
+
+/**
+ * nwamui_config_export:
+ * @fp: where to write, one line per object as the objects are walked.
+ * @flags: NWAMUI_CONFIG_SECRETS to include the key references of the known
+ * WLANs. The keys themselves stay in the dladm secure objects.
+ *
+ * Export the committed configuration.
+ *
+ * @returns: FALSE if something couldn't be exported or written.
+ **/
+extern gboolean
+nwamui_config_export(FILE *fp, guint flags)
+{
+    config_export_t     export;
+    nwam_error_t        nerr;
+    int                 ret;
+
+    g_return_val_if_fail(fp != NULL, FALSE);
+
+    export.fp = fp;
+    export.flags = flags;
+    export.line = g_string_sized_new(512);
+    export.ok = TRUE;
+
+    fputs("# NWAM configuration\n", fp);
+
+    export.section = CONFIG_SECTION_NCP;
+    if ((nerr = nwam_walk_ncps(export_ncp, &export, 0, &ret)) != NWAM_SUCCESS) {
+        nwamui_warning("nwam_walk_ncps %s", nwam_strerror(nerr));
+        export.ok = FALSE;
+    }
+
+    fputs("[enm]\n", fp);
+    export.section = CONFIG_SECTION_ENM;
+    if ((nerr = nwam_walk_enms(export_enm, &export, 0, &ret)) != NWAM_SUCCESS) {
+        nwamui_warning("nwam_walk_enms %s", nwam_strerror(nerr));
+        export.ok = FALSE;
+    }
+
+    fputs("[loc]\n", fp);
+    export.section = CONFIG_SECTION_LOC;
+    if ((nerr = nwam_walk_locs(export_loc, &export, 0, &ret)) != NWAM_SUCCESS) {
+        nwamui_warning("nwam_walk_locs %s", nwam_strerror(nerr));
+        export.ok = FALSE;
+    }
+
+    fputs("[known-wlan]\n", fp);
+    export.section = CONFIG_SECTION_KNOWN_WLAN;
+    if ((nerr = nwam_walk_known_wlans(export_known_wlan, &export,
+          NWAM_FLAG_KNOWN_WLAN_WALK_PRIORITY_ORDER, &ret)) != NWAM_SUCCESS) {
+        nwamui_warning("nwam_walk_known_wlans %s", nwam_strerror(nerr));
+        export.ok = FALSE;
+    }
+
+    g_string_free(export.line, TRUE);
+
+    return export.ok && !ferror(fp);
+}
+
+/* Import */
+
+static void
+config_report(config_import_t *import, const gchar *format, ...)
+{
+    va_list     args;
+    gchar      *msg;
+
+    if (import->report == NULL) {
+        return;
+    }
+
+    va_start(args, format);
+    msg = g_strdup_vprintf(format, args);
+    va_end(args);
+
+    import->report(msg, import->report_data);
+    g_free(msg);
+}
+
+static void
+config_error(config_import_t *import, guint line, const gchar *format, ...)
+{
+    va_list     args;
+    gchar      *msg;
+
+    import->n_errors++;
+
+    va_start(args, format);
+    msg = g_strdup_vprintf(format, args);
+    va_end(args);
+
+    if (line > 0) {
+        config_report(import, _("line %u: %s"), line, msg);
+    } else {
+        config_report(import, "%s", msg);
+    }
+    g_free(msg);
+}
+
+static void
+config_object_free(config_object_t *obj)
+{
+    GList  *idx;
+
+    for (idx = obj->props; idx; idx = idx->next) {
+        config_prop_t  *prop = (config_prop_t *)idx->data;
+
+        nwam_value_free(prop->value);
+        g_free(prop->name);
+        g_free(prop);
+    }
+    g_list_free(obj->props);
+
+    if (obj->handle != NULL) {
+        config_ops[obj->section].free(obj->handle);
+    }
+    g_free(obj->ncp);
+    g_free(obj->name);
+    g_free(obj);
+}
+
+static config_prop_t*
+config_object_find_prop(config_object_t *obj, const gchar *name)
+{
+    GList  *idx;
+
+    for (idx = obj->props; idx; idx = idx->next) {
+        if (strcmp(((config_prop_t *)idx->data)->name, name) == 0) {
+            return (config_prop_t *)idx->data;
+        }
+    }
+    return NULL;
+}
+
+static guint64
+config_object_get_uint64(config_object_t *obj, const gchar *name, guint64 fallback)
+{
+    config_prop_t  *prop = config_object_find_prop(obj, name);
+    uint64_t       *values;
+    uint_t          n;
+
+    if (prop == NULL ||
+      nwam_value_get_uint64_array(prop->value, &values, &n) != NWAM_SUCCESS || n == 0) {
+        return fallback;
+    }
+    return values[0];
+}
+
+static void
+config_parse_object(config_import_t *import, const gchar *str, guint line,
+  config_section_t section, const gchar *ncp)
+{
+    config_object_t    *obj;
+    config_prop_t      *prop;
+    gchar             **fields;
+    gchar             **props;
+    gchar             **tokens;
+    gchar              *eq;
+    gint                i;
+
+    fields = config_split(str, '\t', FALSE);
+    if (g_strv_length(fields) != 2 || *fields[0] == '\0') {
+        config_error(import, line, "%s", _("expected NAME<TAB>PROPERTIES"));
+        g_strfreev(fields);
+        return;
+    }
+
+    obj = g_new0(config_object_t, 1);
+    obj->section = section;
+    obj->ncp = g_strdup(ncp);
+    obj->name = config_unescape(fields[0]);
+    obj->line = line;
+
+    props = config_split(fields[1], ';', FALSE);
+    for (i = 0; props[i] != NULL; i++) {
+        if (*props[i] == '\0') {
+            continue;
+        }
+        if ((eq = strchr(props[i], '=')) == NULL) {
+            config_error(import, line, _("%s: expected PROPERTY=TYPE,VALUE"), props[i]);
+            continue;
+        }
+        *eq++ = '\0';
+
+        tokens = config_split(eq, ',', TRUE);
+        prop = g_new0(config_prop_t, 1);
+        prop->name = g_strdup(props[i]);
+        prop->value = config_value_new(tokens[0], tokens + 1, g_strv_length(tokens) - 1);
+        g_strfreev(tokens);
+
+        if (prop->value == NULL) {
+            config_error(import, line, _("%s: bad value"), prop->name);
+            g_free(prop->name);
+            g_free(prop);
+            continue;
+        }
+        obj->props = g_list_append(obj->props, prop);
+    }
+    g_strfreev(props);
+    g_strfreev(fields);
+
+    import->objects[section] = g_list_prepend(import->objects[section], obj);
+}
+
+static gboolean
+config_parse_section(const gchar *str, config_section_t *section, gchar **ncp)
+{
+    gint    i;
+
+    g_free(*ncp);
+    *ncp = NULL;
+
+    if (g_str_has_prefix(str, "ncp ") && str[4] != '\0') {
+        *section = CONFIG_SECTION_NCP;
+        *ncp = g_strstrip(g_strdup(str + 4));
+        return TRUE;
+    }
+    for (i = CONFIG_SECTION_ENM; i < CONFIG_SECTION_LAST; i++) {
+        if (strcmp(str, config_ops[i].keyword) == 0) {
+            *section = (config_section_t)i;
+            return TRUE;
+        }
+    }
+    *section = CONFIG_SECTION_LAST;
+    return FALSE;
+}
+
+static void
+config_parse_line(config_import_t *import, gchar *str, guint line,
+  config_section_t *section, gchar **ncp)
+{
+    gsize   len;
+
+    /* Only the line end, trailing blanks may belong to a value */
+    len = strlen(str);
+    while (len > 0 && (str[len - 1] == '\n' || str[len - 1] == '\r')) {
+        str[--len] = '\0';
+    }
+
+    if (*str == '\0' || *str == '#') {
+        return;
+    }
+
+    if (*str == '[') {
+        if (len < 2 || str[len - 1] != ']') {
+            config_error(import, line, _("bad section header %s"), str);
+            *section = CONFIG_SECTION_LAST;
+            return;
+        }
+        str[len - 1] = '\0';
+        if (!config_parse_section(g_strstrip(str + 1), section, ncp)) {
+            config_error(import, line, _("unknown section %s"), str + 1);
+        }
+        return;
+    }
+
+    if (*section == CONFIG_SECTION_LAST) {
+        config_error(import, line, "%s", _("object outside of a section"));
+        return;
+    }
+
+    config_parse_object(import, str, line, *section, *ncp);
+}
+
+/* Links before the interfaces on them, NCP by NCP */
+static gint
+config_ncu_compare(gconstpointer a, gconstpointer b)
+{
+    config_object_t    *oa = (config_object_t *)a;
+    config_object_t    *ob = (config_object_t *)b;
+    gint                rval;
+
+    if ((rval = strcmp(oa->ncp, ob->ncp)) != 0) {
+        return rval;
+    }
+    return (gint)config_object_get_uint64(oa, NWAM_NCU_PROP_TYPE, NWAM_NCU_TYPE_INTERFACE) -
+      (gint)config_object_get_uint64(ob, NWAM_NCU_PROP_TYPE, NWAM_NCU_TYPE_INTERFACE);
+}
+
+static gboolean
+config_parse(config_import_t *import, FILE *fp, const gchar *section_hint)
+{
+    config_section_t    section = CONFIG_SECTION_LAST;
+    gchar              *ncp = NULL;
+    GString            *str = g_string_new(NULL);
+    gchar               buf[1024];
+    guint               line = 0;
+    gint                i;
+
+    if (section_hint != NULL && !config_parse_section(section_hint, &section, &ncp)) {
+        config_error(import, line, _("unknown section %s"), section_hint);
+    }
+
+    while (fgets(buf, sizeof (buf), fp) != NULL) {
+        g_string_append(str, buf);
+        if (str->str[str->len - 1] != '\n') {
+            continue;
+        }
+        config_parse_line(import, str->str, ++line, &section, &ncp);
+        g_string_truncate(str, 0);
+    }
+    if (str->len > 0) {
+        config_parse_line(import, str->str, ++line, &section, &ncp);
+    }
+
+    g_string_free(str, TRUE);
+    g_free(ncp);
+
+    for (i = 0; i < CONFIG_SECTION_LAST; i++) {
+        import->objects[i] = g_list_reverse(import->objects[i]);
+    }
+    import->objects[CONFIG_SECTION_NCP] =
+      g_list_sort(import->objects[CONFIG_SECTION_NCP], config_ncu_compare);
+
+    return !ferror(fp);
+}
+
+static nwam_ncp_handle_t
+config_open_ncp(config_import_t *import, const gchar *name)
+{
+    nwam_ncp_handle_t   ncp = NULL;
+    gpointer            found;
+    nwam_error_t        nerr;
+    boolean_t           read_only = B_FALSE;
+
+    if (g_hash_table_lookup_extended(import->ncps, name, NULL, &found)) {
+        return (nwam_ncp_handle_t)found;
+    }
+
+    if ((nerr = nwam_ncp_read(name, 0, &ncp)) == NWAM_SUCCESS) {
+        if (nwam_ncp_get_read_only(ncp, &read_only) == NWAM_SUCCESS && read_only) {
+            config_report(import, _("ncp %s is read only, skipped"), name);
+            nwam_ncp_free(ncp);
+            ncp = NULL;
+        }
+    } else if (nerr == NWAM_ENTITY_NOT_FOUND) {
+        /* nwam_ncp_create() commits it, so it waits for the commits. */
+        config_report(import, _("create ncp %s"), name);
+        g_hash_table_insert(import->new_ncps, g_strdup(name), NULL);
+    } else {
+        config_error(import, 0, _("can't read ncp %s: %s"), name, nwam_strerror(nerr));
+        ncp = NULL;
+    }
+
+    g_hash_table_insert(import->ncps, g_strdup(name), ncp);
+    return ncp;
+}
+
+/* Only nwam_ncp_create() writes a new NCP, so it is created with its NCUs. */
+static nwam_ncp_handle_t
+config_create_ncp(config_import_t *import, const gchar *name)
+{
+    nwam_ncp_handle_t   ncp = NULL;
+    nwam_error_t        nerr;
+
+    if ((ncp = (nwam_ncp_handle_t)g_hash_table_lookup(import->ncps, name)) != NULL) {
+        return ncp;
+    }
+    if ((nerr = nwam_ncp_create(name, 0, &ncp)) != NWAM_SUCCESS) {
+        config_error(import, 0, _("can't create ncp %s: %s"), name, nwam_strerror(nerr));
+        return NULL;
+    }
+    g_hash_table_replace(import->ncps, g_strdup(name), ncp);
+    return ncp;
+}
+
+static void
+config_ncp_free(gpointer data)
+{
+    if (data != NULL) {
+        nwam_ncp_free((nwam_ncp_handle_t)data);
+    }
+}
+
+/*
+ * The NCUs of an NCP which doesn't exist yet have no handle until it is
+ * created, so their properties are checked against the stream alone: the
+ * names, the types and the values libnwam would take.
+ */
+static void
+config_check_ncu(config_import_t *import, config_object_t *obj)
+{
+    config_prop_t      *prop;
+    nwam_value_type_t   type;
+    nwam_value_type_t   value_type;
+    guint64             ncu_type;
+    GList              *idx;
+
+    ncu_type = config_object_get_uint64(obj, NWAM_NCU_PROP_TYPE,
+      g_str_has_prefix(obj->name, "ip:") ? NWAM_NCU_TYPE_INTERFACE : NWAM_NCU_TYPE_LINK);
+    if (ncu_type != NWAM_NCU_TYPE_LINK && ncu_type != NWAM_NCU_TYPE_INTERFACE) {
+        config_error(import, obj->line, _("can't open ncu %s: %s"), obj->name,
+          nwam_strerror(NWAM_INVALID_ARG));
+        return;
+    }
+
+    for (idx = obj->props; idx; idx = idx->next) {
+        prop = (config_prop_t *)idx->data;
+
+        if (config_prop_is_read_only(obj->section, prop->name)) {
+            continue;
+        }
+        if (nwam_ncu_get_prop_type(prop->name, &type) != NWAM_SUCCESS) {
+            config_error(import, obj->line, _("%s %s: can't set %s: %s"),
+              config_ops[obj->section].keyword, obj->name, prop->name,
+              nwam_strerror(NWAM_INVALID_ARG));
+        } else if (nwam_value_get_type(prop->value, &value_type) != NWAM_SUCCESS ||
+          value_type != type) {
+            config_error(import, obj->line, _("%s %s: can't set %s: %s"),
+              config_ops[obj->section].keyword, obj->name, prop->name,
+              nwam_strerror(NWAM_ENTITY_TYPE_MISMATCH));
+        }
+    }
+    obj->created = TRUE;
+}
+
+static void
+config_open_ncu(config_import_t *import, config_object_t *obj)
+{
+    nwam_ncp_handle_t   ncp;
+    nwam_ncu_handle_t   ncu = NULL;
+    nwam_ncu_type_t     type;
+    nwam_ncu_class_t    ncu_class;
+    nwam_error_t        nerr;
+    const gchar        *device;
+
+    if ((ncp = config_open_ncp(import, obj->ncp)) == NULL) {
+        if (g_hash_table_lookup_extended(import->new_ncps, obj->ncp, NULL, NULL)) {
+            config_check_ncu(import, obj);
+        }
+        return;
+    }
+
+    /* "datalink:net0" or "ip:net0" */
+    device = strchr(obj->name, ':');
+    device = (device != NULL) ? device + 1 : obj->name;
+
+    type = (nwam_ncu_type_t)config_object_get_uint64(obj, NWAM_NCU_PROP_TYPE,
+      g_str_has_prefix(obj->name, "ip:") ? NWAM_NCU_TYPE_INTERFACE : NWAM_NCU_TYPE_LINK);
+    ncu_class = (nwam_ncu_class_t)config_object_get_uint64(obj, NWAM_NCU_PROP_CLASS,
+      type == NWAM_NCU_TYPE_LINK ? NWAM_NCU_CLASS_PHYS : NWAM_NCU_CLASS_IP);
+
+    nerr = nwam_ncu_read(ncp, device, type, 0, &ncu);
+    if (nerr == NWAM_ENTITY_NOT_FOUND) {
+        nerr = nwam_ncu_create(ncp, device, type, ncu_class, &ncu);
+        obj->created = (nerr == NWAM_SUCCESS);
+    }
+    if (nerr != NWAM_SUCCESS) {
+        config_error(import, obj->line, _("can't open ncu %s: %s"), obj->name, nwam_strerror(nerr));
+        return;
+    }
+    obj->handle = ncu;
+}
+
+static void
+config_open_object(config_import_t *import, config_object_t *obj)
+{
+    nwam_error_t    nerr;
+    gpointer        handle = NULL;
+
+    switch (obj->section) {
+    case CONFIG_SECTION_NCP:
+        config_open_ncu(import, obj);
+        return;
+    case CONFIG_SECTION_ENM:
+        nerr = nwam_enm_read(obj->name, 0, (nwam_enm_handle_t *)&handle);
+        if (nerr == NWAM_ENTITY_NOT_FOUND) {
+            nerr = nwam_enm_create(obj->name, NULL, (nwam_enm_handle_t *)&handle);
+            obj->created = (nerr == NWAM_SUCCESS);
+        }
+        break;
+    case CONFIG_SECTION_LOC:
+        nerr = nwam_loc_read(obj->name, 0, (nwam_loc_handle_t *)&handle);
+        if (nerr == NWAM_ENTITY_NOT_FOUND) {
+            nerr = nwam_loc_create(obj->name, (nwam_loc_handle_t *)&handle);
+            obj->created = (nerr == NWAM_SUCCESS);
+        }
+        break;
+    case CONFIG_SECTION_KNOWN_WLAN:
+        nerr = nwam_known_wlan_read(obj->name, 0, (nwam_known_wlan_handle_t *)&handle);
+        if (nerr == NWAM_ENTITY_NOT_FOUND) {
+            nerr = nwam_known_wlan_create(obj->name, (nwam_known_wlan_handle_t *)&handle);
+            obj->created = (nerr == NWAM_SUCCESS);
+        }
+        break;
+    default:
+        g_assert_not_reached();
+        return;
+    }
+
+    if (nerr != NWAM_SUCCESS) {
+        config_error(import, obj->line, _("can't open %s %s: %s"),
+          config_ops[obj->section].keyword, obj->name, nwam_strerror(nerr));
+        return;
+    }
+    obj->handle = handle;
+}
+
+static int
+config_collect_prop_name(const char *name, nwam_value_t value, void *data)
+{
+    g_ptr_array_add((GPtrArray *)data, g_strdup(name));
+    return 0;
+}
+
+/*
+ * Bring the handle in line with the stream: set the properties which
+ * differ, delete the ones the stream doesn't have.
+ */
+static void
+config_diff_object(config_import_t *import, config_object_t *obj)
+{
+    const config_ops_t *ops = &config_ops[obj->section];
+    const gchar        *keyword = ops->keyword;
+    config_prop_t      *prop;
+    nwam_value_t        live;
+    nwam_error_t        nerr;
+    GPtrArray          *live_names;
+    GList              *idx;
+    gboolean            same;
+    guint               i;
+    int                 ret;
+
+    for (idx = obj->props; idx; idx = idx->next) {
+        prop = (config_prop_t *)idx->data;
+
+        if (config_prop_is_read_only(obj->section, prop->name)) {
+            continue;
+        }
+        if (!obj->created &&
+          ops->get_prop(obj->handle, prop->name, &live) == NWAM_SUCCESS) {
+            same = config_value_equal(live, prop->value);
+            nwam_value_free(live);
+            if (same) {
+                continue;
+            }
+        }
+        if ((nerr = ops->set_prop(obj->handle, prop->name, prop->value)) != NWAM_SUCCESS) {
+            config_error(import, obj->line, _("%s %s: can't set %s: %s"),
+              keyword, obj->name, prop->name, nwam_strerror(nerr));
+            continue;
+        }
+        obj->changed = TRUE;
+        if (!obj->created) {
+            config_report(import, _("modify %s %s: set %s"), keyword, obj->name, prop->name);
+        }
+    }
+
+    if (obj->created) {
+        return;
+    }
+
+    live_names = g_ptr_array_new();
+    ops->walk_props(obj->handle, config_collect_prop_name, live_names, 0, &ret);
+    for (i = 0; i < live_names->len; i++) {
+        const gchar *name = (const gchar *)g_ptr_array_index(live_names, i);
+
+        if (config_object_find_prop(obj, name) != NULL ||
+          config_prop_is_read_only(obj->section, name) ||
+          (!(import->flags & NWAMUI_CONFIG_SECRETS) &&
+            config_prop_is_secret(obj->section, name))) {
+            continue;
+        }
+        if ((nerr = ops->delete_prop(obj->handle, name)) != NWAM_SUCCESS) {
+            config_error(import, obj->line, _("%s %s: can't delete %s: %s"),
+              keyword, obj->name, name, nwam_strerror(nerr));
+            continue;
+        }
+        obj->changed = TRUE;
+        config_report(import, _("modify %s %s: delete %s"), keyword, obj->name, name);
+    }
+    g_ptr_array_foreach(live_names, (GFunc)g_free, NULL);
+    g_ptr_array_free(live_names, TRUE);
+}
+
+static void
+config_validate_object(config_import_t *import, config_object_t *obj)
+{
+    const char     *errprop = NULL;
+    nwam_error_t    nerr;
+
+    if ((obj->created || obj->changed) &&
+      (nerr = config_ops[obj->section].validate(obj->handle, &errprop)) != NWAM_SUCCESS) {
+        config_error(import, obj->line, _("%s %s is invalid (%s): %s"),
+          config_ops[obj->section].keyword, obj->name,
+          errprop ? errprop : "", nwam_strerror(nerr));
+    }
+}
+
+static void
+config_prepare_object(config_import_t *import, config_object_t *obj)
+{
+    config_open_object(import, obj);
+    if (obj->created) {
+        config_report(import, _("create %s %s"), config_ops[obj->section].keyword, obj->name);
+    }
+    if (obj->handle == NULL) {
+        return;
+    }
+
+    config_diff_object(import, obj);
+    config_validate_object(import, obj);
+}
+
+/* An NCU checked by config_check_ncu(), once its NCP is created. */
+static void
+config_prepare_new_ncu(config_import_t *import, config_object_t *obj)
+{
+    if (config_create_ncp(import, obj->ncp) == NULL) {
+        return;
+    }
+
+    obj->created = FALSE;
+    config_open_ncu(import, obj);
+    if (obj->handle == NULL) {
+        return;
+    }
+
+    config_diff_object(import, obj);
+    config_validate_object(import, obj);
+}
+
+/**
+ * nwamui_config_import:
+ * @fp: the stream to read.
+ * @section: the section of the lines before the first header, e.g. "loc"
+ * for a loc.conf, may be NULL.
+ * @flags: NWAMUI_CONFIG_SECRETS to also import and delete the key
+ * references of the known WLANs, NWAMUI_CONFIG_DRY_RUN to stop after the
+ * validation.
+ * @report: called with a description of each change and each error, may
+ * be NULL.
+ *
+ * Import a configuration exported by nwamui_config_export(). Nothing is
+ * committed unless the whole stream parses and validates. The commits are
+ * done in dependency order, and stop at the first failure. A new NCP is
+ * only created then, so until the commits its NCUs are validated against
+ * the stream rather than libnwam.
+ *
+ * @returns: TRUE if everything was, or in a dry run would be, applied.
+ **/
+extern gboolean
+nwamui_config_import(FILE *fp, const gchar *section, guint flags,
+  GFunc report, gpointer user_data)
+{
+    config_import_t     import;
+    config_object_t    *obj;
+    nwam_error_t        nerr;
+    GList              *idx;
+    guint               n_commits = 0;
+    gint                i;
+
+    g_return_val_if_fail(fp != NULL, FALSE);
+
+    memset(&import, 0, sizeof (import));
+    import.flags = flags;
+    import.report = report;
+    import.report_data = user_data;
+    import.ncps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, config_ncp_free);
+    import.new_ncps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    nwamui_trace_begin("config_import");
+
+    if (!config_parse(&import, fp, section)) {
+        config_error(&import, 0, "%s", _("read error"));
+    }
+
+    if (import.n_errors == 0) {
+        for (i = 0; i < CONFIG_SECTION_LAST; i++) {
+            for (idx = import.objects[i]; idx; idx = idx->next) {
+                config_prepare_object(&import, (config_object_t *)idx->data);
+            }
+        }
+    }
+
+    if (import.n_errors == 0 && !(flags & NWAMUI_CONFIG_DRY_RUN)) {
+        for (i = 0; import.n_errors == 0 && i < CONFIG_SECTION_LAST; i++) {
+            for (idx = import.objects[i]; idx; idx = idx->next) {
+                obj = (config_object_t *)idx->data;
+
+                if (obj->handle == NULL && obj->created) {
+                    config_prepare_new_ncu(&import, obj);
+                    if (import.n_errors > 0) {
+                        break;
+                    }
+                }
+                if (obj->handle == NULL || !(obj->created || obj->changed)) {
+                    continue;
+                }
+                if ((nerr = config_ops[i].commit(obj->handle, config_ops[i].commit_flags)) != NWAM_SUCCESS) {
+                    config_error(&import, obj->line, _("can't commit %s %s: %s"),
+                      config_ops[i].keyword, obj->name, nwam_strerror(nerr));
+                    break;
+                }
+                n_commits++;
+            }
+        }
+    }
+
+    nwamui_trace_end("config_import");
+
+    nwamui_debug("%u errors, %u commits", import.n_errors, n_commits);
+
+    for (i = 0; i < CONFIG_SECTION_LAST; i++) {
+        g_list_foreach(import.objects[i], (GFunc)config_object_free, NULL);
+        g_list_free(import.objects[i]);
+    }
+    g_hash_table_destroy(import.ncps);
+    g_hash_table_destroy(import.new_ncps);
+
+    return import.n_errors == 0;
+}
+
+/**
+ * nwamui_config_section_from_filename:
+ * @returns: the section of a libnwam conf file, e.g. "ncp Automatic" for
+ * ncp-Automatic.conf, or NULL.
+ **/
+extern gchar*
+nwamui_config_section_from_filename(const gchar *filename)
+{
+    gchar      *base = g_path_get_basename(filename);
+    gchar      *ret = NULL;
+    gsize       len = strlen(base);
+
+    if (g_str_has_prefix(base, "ncp-") && g_str_has_suffix(base, ".conf") && len > 9) {
+        ret = g_strdup_printf("ncp %.*s", (int)(len - 9), base + 4);
+    } else if (strcmp(base, "enm.conf") == 0) {
+        ret = g_strdup("enm");
+    } else if (strcmp(base, "loc.conf") == 0) {
+        ret = g_strdup("loc");
+    } else if (strcmp(base, "known-wlan.conf") == 0) {
+        ret = g_strdup("known-wlan");
+    }
+    g_free(base);
+
+    return ret;
+}
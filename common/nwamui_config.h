@@ -0,0 +1,80 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_config.h
+ *
+ */
+
+#ifndef _NWAMUI_CONFIG_H
+#define	_NWAMUI_CONFIG_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+#include <stdio.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Bulk export and import of the NWAM configuration: the NCPs with their
+ * NCUs, the ENMs, the locations and the known WLANs.
+ *
+ * The stream is a sequence of sections, each one headed by "[ncp NAME]",
+ * "[enm]", "[loc]" or "[known-wlan]" and followed by lines in the format
+ * of the libnwam files backend, i.e. of ncp-NAME.conf, enm.conf, loc.conf
+ * and known-wlan.conf:
+ *
+ *   NAME<TAB>PROP=TYPE,VALUE[,VALUE...];PROP=...;
+ *
+ * So a section is a valid conf file, and a conf file can be imported as
+ * is by giving its section, see nwamui_config_section_from_filename().
+ *
+ * Import parses and validates everything first, then only writes the
+ * objects and properties that differ from the live configuration, NCPs
+ * first, then ENMs, locations and known WLANs. Objects which aren't in
+ * the stream are left alone.
+ */
+
+typedef enum {
+    NWAMUI_CONFIG_SECRETS   = 1 << 0,   /* Include the known WLAN key references */
+    NWAMUI_CONFIG_DRY_RUN   = 1 << 1,   /* Import: validate and report only */
+} nwamui_config_flags_t;
+
+extern gboolean     nwamui_config_export(FILE *fp, guint flags);
+
+extern gboolean     nwamui_config_import(FILE *fp,
+                                         const gchar *section,
+                                         guint flags,
+                                         GFunc report,
+                                         gpointer user_data);
+
+extern gchar*       nwamui_config_section_from_filename(const gchar *filename);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_CONFIG_H */
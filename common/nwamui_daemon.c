@@ -38,6 +38,7 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <pthread.h>
+#include <sys/time.h>
 #include <libscf.h>
 
 
@@ -49,20 +50,74 @@ static NwamuiDaemon*    instance        = NULL;
 /* Use above mutex for accessing these variables */
 static GStaticMutex nwam_event_mutex = G_STATIC_MUTEX_INIT;
 static gboolean nwam_event_thread_terminate = FALSE; /* To tell event thread to terminate set to TRUE */
-static gboolean nwam_init_done = FALSE; /* Whether to call nwam_events_fini() or not */
+static gboolean nwam_init_done = FALSE; /* Whether to close the event source or not */
+static gboolean nwam_smf_changed = FALSE; /* SMF state of nwam changed since last connect attempt */
+static GCond   *nwam_event_cond = NULL; /* Wakes up the event thread in backoff */
 /* End of mutex protected variables */
 
+/* See nwamui_daemon_set_event_source() */
+static const nwamui_event_source_t *event_source = &nwamui_event_source_libnwam;
+static gpointer event_source_data = NULL;
+
+/* See nwamui_daemon_set_staged_startup() */
+static gboolean staged_startup = FALSE;
+static guint    hydrate_slice_msec = 0;
+static nwamui_snapshot_t *startup_snapshot = NULL;
+
+/* Reconnect backoff of the event thread, in seconds. */
+#define EVENTS_RECONNECT_BACKOFF_MIN_SEC (1)
+#define EVENTS_RECONNECT_BACKOFF_MAX_SEC (300)
+
+/* Default time budget of a background slice of a staged reload. */
+#define HYDRATE_SLICE_MSEC_DEFAULT (8)
+
 
 #define WLAN_TIMEOUT_SCAN_RATE_SEC (60)
 #define WEP_TIMEOUT_SEC (20)
 
 #define DEBUG_STATUS( name, state, aux_state, status_flag )             \
-    nwamui_debug("line: %d : name = %s : state = %d (%s) : aux_state = %d (%s) status_flag: %02x", \
+    nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "line: %d : name = %s : state = %d (%s) : aux_state = %d (%s) status_flag: %02x", \
       __LINE__, name,                                                   \
       (state), nwam_state_to_string(state),                             \
       (aux_state), nwam_aux_state_to_string(aux_state),                 \
       status_flag)
 
+/* Lanes of the event queue. Connectivity critical events are dispatched
+ * ahead of the plain state updates, both ahead of the UI refresh work queued
+ * at G_PRIORITY_DEFAULT_IDLE, e.g. menu reconstruction, while cosmetic ones
+ * like scan reports stay behind it.
+ *
+ * Idle sources of the same priority are dispatched in FIFO order, so the
+ * events of one lane keep their order. The actions on NCPs and locations
+ * are critical like their states, so an OBJECT_STATE of a location can
+ * never overtake the OBJECT_ACTION that created it.
+ */
+static const gint event_lane_priority[NWAMUI_DAEMON_EVENT_LANE_LAST] = {
+    G_PRIORITY_HIGH_IDLE + 25,  /* CRITICAL, after GTK+ resize/redraw */
+    G_PRIORITY_HIGH_IDLE + 30,  /* STATE */
+    G_PRIORITY_DEFAULT_IDLE     /* COSMETIC */
+};
+
+static const gchar *event_lane_names[NWAMUI_DAEMON_EVENT_LANE_LAST] = {
+    "critical",
+    "state",
+    "cosmetic"
+};
+
+static const gchar *stage_names[NWAMUI_DAEMON_STAGE_LAST] = {
+    "core",
+    "icon",
+    "menus",
+    "hydrated"
+};
+
+/* Per lane queueing delay, only touched from the main loop. */
+typedef struct _event_lane_stats {
+    guint       count;
+    hrtime_t    total_delay;
+    hrtime_t    max_delay;
+} event_lane_stats_t;
+
 typedef struct _to_emit {
     guint       event;
     gpointer    data;
@@ -74,7 +129,8 @@ enum {
     PROP_STATUS,
     PROP_NUM_SCANNED_WIFI,
     PROP_ONLINE_ENM_NUM,
-    PROP_ENV_SELECTION_MODE
+    PROP_ENV_SELECTION_MODE,
+    PROP_HYDRATED
 };
 
 /* Flags to track various reasons for a state not being ALL_OK
@@ -97,6 +153,23 @@ enum {
 	N_MANAGED
 };
 
+/* An object left to the background slices of a staged reload, N_MANAGED
+ * stands for dispatching the cached scan results and HYDRATE_RECONCILE plus
+ * a kind for looking for the objects of that kind a startup snapshot missed.
+ */
+#define HYDRATE_RECONCILE (N_MANAGED + 1)
+
+typedef struct _hydrate_item {
+    gint        managed;
+    gchar      *name;
+} hydrate_item_t;
+
+/* Walker data of the synchronous part of a staged reload */
+typedef struct _stage_walk {
+    NwamuiDaemon   *daemon;
+    GQueue         *deferred;
+} stage_walk_t;
+
 struct _NwamuiDaemonPrivate {
     NwamuiObject *active_env;
     NwamuiObject *active_ncp;
@@ -115,6 +188,17 @@ struct _NwamuiDaemonPrivate {
     GQueue                 *wlan_scan_queue;
     gint                    num_scanned_wifi;
     gint                    online_enm_num;
+    event_lane_stats_t      lane_stats[NWAMUI_DAEMON_EVENT_LANE_LAST];
+
+    /* Staged reload */
+    hrtime_t                created_at;
+    hrtime_t                stage_at[NWAMUI_DAEMON_STAGE_LAST];
+    GQueue                 *hydrate_queue;          /* hydrate_item_t* */
+    GList                  *hydrate_stale[N_MANAGED]; /* Not seen by the walks, yet */
+    guint                   hydrate_id;
+    guint                   hydrate_slices;
+    gpointer                hydrate_active_ncp;     /* Only compared */
+    gpointer                hydrate_active_env;
 };
 
 #define NWAMUI_DAEMON_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE((o), NWAMUI_TYPE_DAEMON, NwamuiDaemonPrivate))
@@ -123,6 +207,8 @@ typedef struct _NwamuiEvent {
     nwamui_daemon_info_t e;     /* ui daemon event type */
     nwam_event_t         nwamevent; /* daemon data */
     NwamuiDaemon*        daemon;
+    nwamui_daemon_event_lane_t lane;
+    hrtime_t             queued_at;
 } NwamuiEvent;
 
 
@@ -132,6 +218,10 @@ static NwamuiEvent* nwamui_event_new(NwamuiDaemon* daemon, int e, nwam_event_t e
 
 static void nwamui_event_free(NwamuiEvent *e);
 
+static void nwamui_event_queue(NwamuiDaemon* daemon, int e, nwam_event_t event);
+
+static nwamui_daemon_event_lane_t nwamui_event_classify(int e, nwam_event_t nwamevent);
+
 static void nwamui_daemon_set_property ( GObject         *object,
                                       guint            prop_id,
                                       const GValue    *value,
@@ -152,8 +242,7 @@ static void check_nwamui_object_online_num( gpointer obj, gpointer user_data );
 
 static void nwamui_daemon_update_status( NwamuiDaemon   *daemon );
 
-static gboolean nwamui_daemon_nwam_connect( gboolean block );
-static gboolean nwamui_is_nwam_enabled( void );
+static gboolean nwamui_daemon_nwam_connect( void );
 
 static void     nwamui_daemon_nwam_disconnect( void );
 
@@ -162,6 +251,9 @@ static void nwamui_daemon_handle_object_state_event( NwamuiDaemon   *daemon, nwa
 static void nwamui_daemon_set_status( NwamuiDaemon* self, nwamui_daemon_status_t status );
 
 static void     nwamui_object_real_reload(NwamuiObject* object);
+static void     nwamui_daemon_reload_staged(NwamuiDaemon *self);
+static void     nwamui_daemon_hydrate_cancel(NwamuiDaemon *self);
+static void     nwamui_daemon_hydrate_managed(NwamuiDaemon *self, gint managed);
 static gboolean nwamui_object_real_validate(NwamuiObject *object, gchar **prop_name_ret);
 static gboolean nwamui_object_real_commit(NwamuiObject *object);
 static void     nwamui_object_real_event(NwamuiObject *object, guint event, gpointer data);
@@ -171,6 +263,7 @@ static void     nwamui_object_real_remove(NwamuiObject *object, NwamuiObject *ch
 
 /* Callbacks */
 static gpointer nwam_events_thread ( gpointer daemon );
+static gpointer nwam_smf_watch_thread ( gpointer data );
 
 /* walkers */
 static int nwam_loc_walker_cb (nwam_loc_handle_t env, void *data);
@@ -246,6 +339,14 @@ nwamui_daemon_class_init (NwamuiDaemonClass *klass)
                                                           FALSE,
                                                           G_PARAM_READABLE));
 
+    g_object_class_install_property (gobject_class,
+      PROP_HYDRATED,
+      g_param_spec_boolean("hydrated",
+        _("hydrated"),
+        _("hydrated"),
+        FALSE,
+        G_PARAM_READABLE));
+
     g_object_class_install_property (gobject_class,
       PROP_ONLINE_ENM_NUM,
       g_param_spec_int("online_enm_num",
@@ -266,6 +367,18 @@ nwamui_daemon_init (NwamuiDaemon *self)
     nwam_error_t         nerr;
     
     self->prv = prv;
+    prv->created_at = gethrtime();
+    prv->hydrate_queue = g_queue_new();
+
+    if (nwam_event_cond == NULL) {
+        nwam_event_cond = g_cond_new();
+    }
+
+    /* Not joinable, it blocks in libscf for the life of the process. */
+    if (g_thread_create(nwam_smf_watch_thread, NULL, FALSE, &error) == NULL) {
+        g_debug("Error creating SMF watch thread: %s", (error && error->message)?error->message:"" );
+        g_clear_error(&error);
+    }
     
     prv->nwam_events_gthread = g_thread_create(nwam_events_thread, g_object_ref(self), TRUE, &error);
     if( prv->nwam_events_gthread == NULL ) {
@@ -277,7 +390,15 @@ nwamui_daemon_init (NwamuiDaemon *self)
      * daemon related info changes, e.g. NCP list changes, so it may lose info
      * without this dup call.
      */
-    nwamui_object_real_reload(NWAMUI_OBJECT(self));
+    if (staged_startup) {
+        nwamui_daemon_reload_staged(self);
+    } else {
+        nwamui_snapshot_close(startup_snapshot);
+        startup_snapshot = NULL;
+        nwamui_object_reload(NWAMUI_OBJECT(self));
+        nwamui_daemon_mark_stage(self, NWAMUI_DAEMON_STAGE_CORE);
+        nwamui_daemon_mark_stage(self, NWAMUI_DAEMON_STAGE_HYDRATED);
+    }
 }
 
 /**
@@ -297,6 +418,7 @@ nwamui_object_real_reload(NwamuiObject* object)
     /* Get list of Ncps from libnwam */
     prv->temp_list = g_list_copy( prv->managed_list[MANAGED_NCP] );
     g_debug ("### nwam_walk_ncps start ###");
+    nwamui_trace_begin("nwam_walk_ncps");
     nerr = nwam_walk_ncps (nwam_ncp_walker_cb, (void *)self, 0, &cbret);
     if (nerr == NWAM_SUCCESS) {
         for(;
@@ -309,11 +431,13 @@ nwamui_object_real_reload(NwamuiObject* object)
         g_list_free(prv->temp_list);
         prv->temp_list = NULL;
     }
+    nwamui_trace_end("nwam_walk_ncps");
     g_debug ("### nwam_walk_ncps  end ###");
 
     /* Env / Locations */
     prv->temp_list = g_list_copy( prv->managed_list[MANAGED_LOC] );
     g_debug ("### nwam_walk_locs start ###");
+    nwamui_trace_begin("nwam_walk_locs");
     nerr = nwam_walk_locs (nwam_loc_walker_cb, (void *)self, 0, &cbret);
     if (nerr == NWAM_SUCCESS) {
         for(;
@@ -326,11 +450,13 @@ nwamui_object_real_reload(NwamuiObject* object)
         g_list_free(prv->temp_list);
         prv->temp_list = NULL;
     }
+    nwamui_trace_end("nwam_walk_locs");
     g_debug ("### nwam_walk_locs  end ###");
 
     /* ENMs */
     prv->temp_list = g_list_copy( prv->managed_list[MANAGED_ENM] );
     g_debug ("### nwam_walk_enms start ###");
+    nwamui_trace_begin("nwam_walk_enms");
     nerr = nwam_walk_enms (nwam_enm_walker_cb, (void *)self, 0, &cbret);
     if (nerr == NWAM_SUCCESS) {
         for(;
@@ -343,6 +469,7 @@ nwamui_object_real_reload(NwamuiObject* object)
         g_list_free(prv->temp_list);
         prv->temp_list = NULL;
     }
+    nwamui_trace_end("nwam_walk_enms");
     g_debug ("### nwam_walk_enms  end ###");
 
     /* Will generate an event if status changes */
@@ -353,6 +480,7 @@ nwamui_object_real_reload(NwamuiObject* object)
     /* KnownWlans */
     prv->temp_list = g_list_copy(prv->managed_list[MANAGED_KNOWN_WLAN]);
     g_debug ("### nwam_walk_know_wlans start ###");
+    nwamui_trace_begin("nwam_walk_known_wlans");
     nerr = nwam_walk_known_wlans(nwam_known_wlan_walker_cb, (void *)self,
       NWAM_FLAG_KNOWN_WLAN_WALK_PRIORITY_ORDER, &cbret);
     if (nerr == NWAM_SUCCESS) {
@@ -366,9 +494,595 @@ nwamui_object_real_reload(NwamuiObject* object)
         g_list_free(prv->temp_list);
         prv->temp_list = NULL;
     }
+    nwamui_trace_end("nwam_walk_known_wlans");
     g_debug ("### nwam_walk_know_wlans  end ###");
 }
 
+static void
+hydrate_queue_push(GQueue *queue, gint managed, const gchar *name)
+{
+    hydrate_item_t *item = g_new(hydrate_item_t, 1);
+
+    item->managed = managed;
+    item->name = g_strdup(name);
+    g_queue_push_tail(queue, item);
+}
+
+static void
+hydrate_item_free(gpointer data, gpointer user_data)
+{
+    hydrate_item_t *item = (hydrate_item_t *)data;
+
+    g_free(item->name);
+    g_free(item);
+}
+
+static int
+nwam_ncp_stage_walker_cb(nwam_ncp_handle_t ncp, void *data)
+{
+    stage_walk_t        *walk = (stage_walk_t *)data;
+    NwamuiDaemonPrivate *prv  = walk->daemon->prv;
+    nwam_state_t         state = NWAM_STATE_OFFLINE;
+    nwam_aux_state_t     aux_state;
+    char                *name;
+
+    if (nwam_ncp_get_state(ncp, &state, &aux_state) == NWAM_SUCCESS &&
+      state == NWAM_STATE_ONLINE) {
+        prv->temp_list = prv->hydrate_stale[MANAGED_NCP];
+        nwam_ncp_walker_cb(ncp, walk->daemon);
+        prv->hydrate_stale[MANAGED_NCP] = prv->temp_list;
+        prv->temp_list = NULL;
+    } else if (nwam_ncp_get_name(ncp, &name) == NWAM_SUCCESS) {
+        hydrate_queue_push(walk->deferred, MANAGED_NCP, name);
+        free(name);
+    }
+    return 0;
+}
+
+static int
+nwam_loc_stage_walker_cb(nwam_loc_handle_t loc, void *data)
+{
+    stage_walk_t        *walk = (stage_walk_t *)data;
+    NwamuiDaemonPrivate *prv  = walk->daemon->prv;
+    nwam_state_t         state = NWAM_STATE_OFFLINE;
+    nwam_aux_state_t     aux_state;
+    char                *name;
+
+    if (nwam_loc_get_state(loc, &state, &aux_state) == NWAM_SUCCESS &&
+      state == NWAM_STATE_ONLINE) {
+        prv->temp_list = prv->hydrate_stale[MANAGED_LOC];
+        nwam_loc_walker_cb(loc, walk->daemon);
+        prv->hydrate_stale[MANAGED_LOC] = prv->temp_list;
+        prv->temp_list = NULL;
+    } else if (nwam_loc_get_name(loc, &name) == NWAM_SUCCESS) {
+        hydrate_queue_push(walk->deferred, MANAGED_LOC, name);
+        free(name);
+    }
+    return 0;
+}
+
+static int
+nwam_enm_name_walker_cb(nwam_enm_handle_t enm, void *data)
+{
+    char   *name;
+
+    if (nwam_enm_get_name(enm, &name) == NWAM_SUCCESS) {
+        hydrate_queue_push((GQueue *)data, MANAGED_ENM, name);
+        free(name);
+    }
+    return 0;
+}
+
+static int
+nwam_known_wlan_name_walker_cb(nwam_known_wlan_handle_t wlan_h, void *data)
+{
+    char   *name;
+
+    if (nwam_known_wlan_get_name(wlan_h, &name) == NWAM_SUCCESS) {
+        hydrate_queue_push((GQueue *)data, MANAGED_KNOWN_WLAN, name);
+        free(name);
+    }
+    return 0;
+}
+
+static int
+nwam_ncp_name_walker_cb(nwam_ncp_handle_t ncp, void *data)
+{
+    char   *name;
+
+    if (nwam_ncp_get_name(ncp, &name) == NWAM_SUCCESS) {
+        hydrate_queue_push((GQueue *)data, MANAGED_NCP, name);
+        free(name);
+    }
+    return 0;
+}
+
+static int
+nwam_loc_name_walker_cb(nwam_loc_handle_t loc, void *data)
+{
+    char   *name;
+
+    if (nwam_loc_get_name(loc, &name) == NWAM_SUCCESS) {
+        hydrate_queue_push((GQueue *)data, MANAGED_LOC, name);
+        free(name);
+    }
+    return 0;
+}
+
+static NwamuiObject*
+hydrate_lookup(NwamuiDaemon *self, gint managed, const gchar *name)
+{
+    switch (managed) {
+    case MANAGED_NCP:
+        return nwamui_daemon_get_ncp_by_name(self, name);
+    case MANAGED_LOC:
+        return nwamui_daemon_get_env_by_name(self, name);
+    case MANAGED_ENM:
+        return nwamui_daemon_get_enm_by_name(self, name);
+    case MANAGED_KNOWN_WLAN:
+        return nwamui_daemon_find_fav_wifi_net_by_name(self, name);
+    default:
+        g_assert_not_reached();
+        break;
+    }
+    return NULL;
+}
+
+/* A startup snapshot may be older than the configuration. Queue the objects
+ * of a kind created since, next, one per item, so the slices keep to their
+ * budget. Those destroyed since fail to read and are pruned by
+ * nwamui_daemon_hydrate_finish().
+ */
+static void
+hydrate_reconcile(NwamuiDaemon *self, gint managed)
+{
+    NwamuiDaemonPrivate *prv   = self->prv;
+    GQueue              *names = g_queue_new();
+    hydrate_item_t      *item;
+    NwamuiObject        *obj;
+    nwam_error_t         nerr  = NWAM_SUCCESS;
+    int                  cbret;
+
+    nwamui_trace_begin("hydrate_reconcile");
+
+    switch (managed) {
+    case MANAGED_NCP:
+        nerr = nwam_walk_ncps(nwam_ncp_name_walker_cb, names, 0, &cbret);
+        break;
+    case MANAGED_LOC:
+        nerr = nwam_walk_locs(nwam_loc_name_walker_cb, names, 0, &cbret);
+        break;
+    case MANAGED_ENM:
+        nerr = nwam_walk_enms(nwam_enm_name_walker_cb, names, 0, &cbret);
+        break;
+    case MANAGED_KNOWN_WLAN:
+        nerr = nwam_walk_known_wlans(nwam_known_wlan_name_walker_cb, names,
+          NWAM_FLAG_KNOWN_WLAN_WALK_PRIORITY_ORDER, &cbret);
+        break;
+    default:
+        g_assert_not_reached();
+        break;
+    }
+    if (nerr != NWAM_SUCCESS) {
+        nwamui_warning("Failed to walk the objects to reconcile: %s", nwam_strerror(nerr));
+    }
+
+    while ((item = (hydrate_item_t *)g_queue_pop_tail(names)) != NULL) {
+        if ((obj = hydrate_lookup(self, item->managed, item->name)) != NULL) {
+            g_object_unref(obj);
+            hydrate_item_free(item, NULL);
+        } else {
+            nwamui_debug("%s is not in the snapshot", item->name);
+            g_queue_push_head(prv->hydrate_queue, item);
+        }
+    }
+    g_queue_free(names);
+
+    nwamui_trace_end("hydrate_reconcile");
+}
+
+/* Read the object again by name, it may have gone meanwhile. */
+static void
+hydrate_load(NwamuiDaemon *self, hydrate_item_t *item)
+{
+    NwamuiDaemonPrivate *prv  = self->prv;
+    NwamuiObject        *obj;
+    nwam_error_t         nerr = NWAM_SUCCESS;
+
+    if (item->managed == N_MANAGED) {
+        nwamui_daemon_dispatch_wifi_scan_events_from_cache(self);
+        return;
+    }
+    if (item->managed >= HYDRATE_RECONCILE) {
+        hydrate_reconcile(self, item->managed - HYDRATE_RECONCILE);
+        return;
+    }
+
+    /* Loaded meanwhile and being edited, reading it again would lose the
+     * changes, as for the events.
+     */
+    if ((obj = hydrate_lookup(self, item->managed, item->name)) != NULL) {
+        gboolean    modified = nwamui_object_has_modifications(obj);
+
+        if (modified) {
+            prv->hydrate_stale[item->managed] = g_list_remove(prv->hydrate_stale[item->managed], obj);
+        }
+        g_object_unref(obj);
+        if (modified) {
+            return;
+        }
+    }
+
+    prv->temp_list = prv->hydrate_stale[item->managed];
+
+    switch (item->managed) {
+    case MANAGED_NCP: {
+        nwam_ncp_handle_t   h;
+
+        if ((nerr = nwam_ncp_read(item->name, 0, &h)) == NWAM_SUCCESS) {
+            nwam_ncp_walker_cb(h, self);
+            nwam_ncp_free(h);
+        }
+    }
+        break;
+    case MANAGED_LOC: {
+        nwam_loc_handle_t   h;
+
+        if ((nerr = nwam_loc_read(item->name, 0, &h)) == NWAM_SUCCESS) {
+            nwam_loc_walker_cb(h, self);
+            nwam_loc_free(h);
+        }
+    }
+        break;
+    case MANAGED_ENM: {
+        nwam_enm_handle_t   h;
+
+        if ((nerr = nwam_enm_read(item->name, 0, &h)) == NWAM_SUCCESS) {
+            nwam_enm_walker_cb(h, self);
+            nwam_enm_free(h);
+        }
+    }
+        break;
+    case MANAGED_KNOWN_WLAN: {
+        nwam_known_wlan_handle_t    h;
+
+        if ((nerr = nwam_known_wlan_read(item->name, 0, &h)) == NWAM_SUCCESS) {
+            nwam_known_wlan_walker_cb(h, self);
+            nwam_known_wlan_free(h);
+        }
+    }
+        break;
+    default:
+        g_assert_not_reached();
+        break;
+    }
+
+    prv->hydrate_stale[item->managed] = prv->temp_list;
+    prv->temp_list = NULL;
+
+    if (nerr != NWAM_SUCCESS && nerr != NWAM_ENTITY_NOT_FOUND) {
+        nwamui_warning("Failed to read %s: %s", item->name, nwam_strerror(nerr));
+    }
+}
+
+static void
+nwamui_daemon_hydrate_finish(NwamuiDaemon *self)
+{
+    NwamuiDaemonPrivate *prv = self->prv;
+    gint                 i;
+
+    for (i = 0; i < N_MANAGED; i++) {
+        for(;
+            prv->hydrate_stale[i] != NULL;
+            prv->hydrate_stale[i] = g_list_delete_link(prv->hydrate_stale[i], prv->hydrate_stale[i])) {
+            nwamui_object_remove(NWAMUI_OBJECT(self), NWAMUI_OBJECT(prv->hydrate_stale[i]->data));
+        }
+    }
+
+    nwamui_daemon_update_status(self);
+    nwamui_daemon_update_online_enm_num(self);
+
+    /* The walker callbacks set them silently, a snapshot may have been
+     * wrong about them.
+     */
+    if (prv->active_ncp != prv->hydrate_active_ncp) {
+        g_object_notify(G_OBJECT(self), "active_ncp");
+    }
+    if (prv->active_env != prv->hydrate_active_env) {
+        g_object_notify(G_OBJECT(self), "active_env");
+    }
+
+    nwamui_daemon_mark_stage(self, NWAMUI_DAEMON_STAGE_HYDRATED);
+    g_object_notify(G_OBJECT(self), "hydrated");
+}
+
+static gboolean
+nwamui_daemon_hydrate_slice(gpointer data)
+{
+    NwamuiDaemon        *self     = NWAMUI_DAEMON(data);
+    NwamuiDaemonPrivate *prv      = self->prv;
+    hrtime_t             deadline = gethrtime() + (hrtime_t)hydrate_slice_msec * 1000000;
+    hydrate_item_t      *item;
+
+    nwamui_trace_begin("hydrate_slice");
+    prv->hydrate_slices++;
+    nwamui_object_begin_update(NWAMUI_OBJECT(self));
+
+    /* At least one object per slice, however slow it is. */
+    while ((item = (hydrate_item_t *)g_queue_pop_head(prv->hydrate_queue)) != NULL) {
+        hydrate_load(self, item);
+        hydrate_item_free(item, NULL);
+        if (gethrtime() >= deadline) {
+            break;
+        }
+    }
+
+    nwamui_object_end_update(NWAMUI_OBJECT(self));
+    nwamui_trace_end("hydrate_slice");
+
+    if (!g_queue_is_empty(prv->hydrate_queue)) {
+        return TRUE;
+    }
+
+    prv->hydrate_id = 0;
+    nwamui_daemon_hydrate_finish(self);
+
+    return FALSE;
+}
+
+/* Load the pending objects of a kind now, e.g. the known WLANs when a WLAN
+ * event needs them before the background slices got to them.
+ */
+static void
+nwamui_daemon_hydrate_managed(NwamuiDaemon *self, gint managed)
+{
+    NwamuiDaemonPrivate *prv = self->prv;
+    GList               *idx;
+    GList               *next;
+
+    if (prv->hydrate_id == 0) {
+        return;
+    }
+
+    for (idx = prv->hydrate_queue->head; idx; idx = next) {
+        hydrate_item_t  *item = (hydrate_item_t *)idx->data;
+
+        next = idx->next;
+        if (item->managed == managed) {
+            g_queue_delete_link(prv->hydrate_queue, idx);
+            hydrate_load(self, item);
+            hydrate_item_free(item, NULL);
+        }
+    }
+}
+
+static void
+nwamui_daemon_hydrate_cancel(NwamuiDaemon *self)
+{
+    NwamuiDaemonPrivate *prv = self->prv;
+    gint                 i;
+
+    if (prv->hydrate_id != 0) {
+        g_source_remove(prv->hydrate_id);
+        prv->hydrate_id = 0;
+    }
+    g_queue_foreach(prv->hydrate_queue, hydrate_item_free, NULL);
+    g_queue_clear(prv->hydrate_queue);
+
+    for (i = 0; i < N_MANAGED; i++) {
+        g_list_free(prv->hydrate_stale[i]);
+        prv->hydrate_stale[i] = NULL;
+    }
+}
+
+/* An object as a startup snapshot has it, until hydrate_load() reads it. */
+static void
+hydrate_add_stand_in(NwamuiDaemon *self, gint managed, const nwamui_snapshot_entry_t *entry)
+{
+    NwamuiDaemonPrivate *prv = self->prv;
+    NwamuiObject        *obj;
+    GType                type;
+
+    switch (managed) {
+    case MANAGED_NCP:
+        type = NWAMUI_TYPE_NCP;
+        break;
+    case MANAGED_LOC:
+        type = NWAMUI_TYPE_ENV;
+        break;
+    case MANAGED_ENM:
+        type = NWAMUI_TYPE_ENM;
+        break;
+    case MANAGED_KNOWN_WLAN:
+        type = NWAMUI_TYPE_KNOWN_WLAN;
+        break;
+    default:
+        g_assert_not_reached();
+        return;
+    }
+
+    if ((obj = hydrate_lookup(self, managed, entry->name)) != NULL) {
+        g_object_unref(obj);
+        return;
+    }
+
+    obj = NWAMUI_OBJECT(g_object_new(type, NULL));
+    nwamui_object_set_name(obj, entry->name);
+    nwamui_object_set_stand_in(obj,
+      (entry->flags & NWAMUI_SNAPSHOT_FLAG_ACTIVE) != 0,
+      (entry->flags & NWAMUI_SNAPSHOT_FLAG_ENABLED) != 0,
+      entry->activation_mode, entry->priority);
+    nwamui_object_set_nwam_state(obj, entry->state, entry->aux_state);
+
+    nwamui_object_add(NWAMUI_OBJECT(self), obj);
+    /* Pruned unless it is read. */
+    prv->hydrate_stale[managed] = g_list_prepend(prv->hydrate_stale[managed], obj);
+    g_object_unref(obj);
+}
+
+/**
+ * Core stage from a startup snapshot instead of walking libnwam: read only
+ * the active location and NCP, and add the rest as stand-ins with the
+ * states, flags and priorities of the snapshot, see
+ * nwamui_object_set_stand_in(). They are queued by name to be read, ENMs to
+ * enms, known WLANs to known and the others to deferred.
+ */
+static void
+nwamui_daemon_reload_core_from_snapshot(NwamuiDaemon *self, nwamui_snapshot_t *snap,
+  GQueue *enms, GQueue *deferred, GQueue *known)
+{
+    nwamui_snapshot_entry_t  entry;
+    hydrate_item_t           item;
+    GQueue                  *ncps = g_queue_new();
+    GQueue                  *queue;
+    guint                    i;
+
+    for (i = 0; nwamui_snapshot_get_entry(snap, i, &entry); i++) {
+        switch (entry.kind) {
+        case NWAMUI_SNAPSHOT_NCP:
+            item.managed = MANAGED_NCP;
+            queue = ncps;
+            break;
+        case NWAMUI_SNAPSHOT_LOC:
+            item.managed = MANAGED_LOC;
+            queue = deferred;
+            break;
+        case NWAMUI_SNAPSHOT_ENM:
+            item.managed = MANAGED_ENM;
+            queue = enms;
+            break;
+        case NWAMUI_SNAPSHOT_KNOWN_WLAN:
+            item.managed = MANAGED_KNOWN_WLAN;
+            queue = known;
+            break;
+        default:
+            /* NCUs come with their NCP */
+            continue;
+        }
+
+        if ((entry.flags & NWAMUI_SNAPSHOT_FLAG_ACTIVE) &&
+          (item.managed == MANAGED_NCP || item.managed == MANAGED_LOC)) {
+            item.name = (gchar *)entry.name;
+            hydrate_load(self, &item);
+        } else {
+            hydrate_add_stand_in(self, item.managed, &entry);
+            hydrate_queue_push(queue, item.managed, entry.name);
+        }
+    }
+
+    /* Locations before NCPs, as the walks do. */
+    while (!g_queue_is_empty(ncps)) {
+        g_queue_push_tail(deferred, g_queue_pop_head(ncps));
+    }
+    g_queue_free(ncps);
+}
+
+/**
+ * Staged version of nwamui_object_real_reload(): load what the status icon
+ * shows, i.e. the active location and NCP, right away. Everything else is
+ * queued, ENMs first since they are in the menu, then the inactive
+ * locations and NCPs, the known WLANs and last the cached scan results,
+ * and loaded in idle slices of hydrate_slice_msec.
+ *
+ * The first pass may take the names from a startup snapshot rather than
+ * walking libnwam, its objects standing in until they are read. It then
+ * walks libnwam one kind at a time, before the scan results, for what was
+ * added since; what was destroyed fails to read and is pruned.
+ */
+static void
+nwamui_daemon_reload_staged(NwamuiDaemon *self)
+{
+    NwamuiDaemonPrivate *prv = self->prv;
+    stage_walk_t         walk;
+    GQueue              *known;
+    gboolean             reconcile = FALSE;
+    nwam_error_t         nerr;
+    int                  cbret;
+    gint                 i;
+
+    /* Drop the rest of an earlier pass, this one walks everything again. */
+    nwamui_daemon_hydrate_cancel(self);
+
+    for (i = 0; i < N_MANAGED; i++) {
+        prv->hydrate_stale[i] = g_list_copy(prv->managed_list[i]);
+    }
+    prv->hydrate_active_ncp = prv->active_ncp;
+    prv->hydrate_active_env = prv->active_env;
+
+    walk.daemon = self;
+    walk.deferred = g_queue_new();
+    known = g_queue_new();
+
+    nwamui_trace_begin("reload_core");
+    nwamui_object_begin_update(NWAMUI_OBJECT(self));
+
+    if (startup_snapshot != NULL) {
+        nwamui_daemon_reload_core_from_snapshot(self, startup_snapshot,
+          prv->hydrate_queue, walk.deferred, known);
+        nwamui_snapshot_close(startup_snapshot);
+        startup_snapshot = NULL;
+        reconcile = TRUE;
+    } else {
+        nerr = nwam_walk_locs(nwam_loc_stage_walker_cb, &walk, 0, &cbret);
+        if (nerr != NWAM_SUCCESS) {
+            g_warning("nwam_walk_locs %s", nwam_strerror(nerr));
+            g_list_free(prv->hydrate_stale[MANAGED_LOC]);
+            prv->hydrate_stale[MANAGED_LOC] = NULL;
+        }
+
+        nerr = nwam_walk_ncps(nwam_ncp_stage_walker_cb, &walk, 0, &cbret);
+        if (nerr != NWAM_SUCCESS) {
+            g_warning("nwam_walk_ncps %s", nwam_strerror(nerr));
+            g_list_free(prv->hydrate_stale[MANAGED_NCP]);
+            prv->hydrate_stale[MANAGED_NCP] = NULL;
+        }
+    }
+
+    /* Will generate an event if status changes */
+    nwamui_daemon_update_status(self);
+
+    nwamui_object_end_update(NWAMUI_OBJECT(self));
+    nwamui_trace_end("reload_core");
+    nwamui_daemon_mark_stage(self, NWAMUI_DAEMON_STAGE_CORE);
+
+    if (!reconcile) {
+        nerr = nwam_walk_enms(nwam_enm_name_walker_cb, prv->hydrate_queue, 0, &cbret);
+        if (nerr != NWAM_SUCCESS) {
+            g_warning("nwam_walk_enms %s", nwam_strerror(nerr));
+            g_list_free(prv->hydrate_stale[MANAGED_ENM]);
+            prv->hydrate_stale[MANAGED_ENM] = NULL;
+        }
+
+        nerr = nwam_walk_known_wlans(nwam_known_wlan_name_walker_cb, known,
+          NWAM_FLAG_KNOWN_WLAN_WALK_PRIORITY_ORDER, &cbret);
+        if (nerr != NWAM_SUCCESS) {
+            g_warning("nwam_walk_known_wlans %s", nwam_strerror(nerr));
+            g_list_free(prv->hydrate_stale[MANAGED_KNOWN_WLAN]);
+            prv->hydrate_stale[MANAGED_KNOWN_WLAN] = NULL;
+        }
+    }
+
+    while (!g_queue_is_empty(walk.deferred)) {
+        g_queue_push_tail(prv->hydrate_queue, g_queue_pop_head(walk.deferred));
+    }
+    g_queue_free(walk.deferred);
+
+    while (!g_queue_is_empty(known)) {
+        g_queue_push_tail(prv->hydrate_queue, g_queue_pop_head(known));
+    }
+    g_queue_free(known);
+
+    if (reconcile) {
+        for (i = 0; i < N_MANAGED; i++) {
+            hydrate_queue_push(prv->hydrate_queue, HYDRATE_RECONCILE + i, NULL);
+        }
+    }
+    hydrate_queue_push(prv->hydrate_queue, N_MANAGED, NULL);
+
+    prv->hydrate_id = g_idle_add_full(G_PRIORITY_LOW,
+      nwamui_daemon_hydrate_slice, self, NULL);
+}
+
 static void
 nwamui_daemon_set_property ( GObject         *object,
                                     guint            prop_id,
@@ -446,6 +1160,9 @@ nwamui_daemon_get_property (GObject         *object,
         case PROP_ENV_SELECTION_MODE:
             g_value_set_boolean(value, nwamui_daemon_env_selection_is_manual(self));
             break;
+        case PROP_HYDRATED:
+            g_value_set_boolean(value, nwamui_daemon_is_hydrated(self));
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
             break;
@@ -459,8 +1176,12 @@ nwamui_daemon_terminate_event_thread(NwamuiDaemon *self)
 
     g_static_mutex_lock (&nwam_event_mutex);
     nwam_event_thread_terminate = TRUE;
+    g_cond_broadcast (nwam_event_cond);
     g_static_mutex_unlock (&nwam_event_mutex);
 
+    /* Unblock the wait of the event source. */
+    nwamui_daemon_nwam_disconnect();
+
     (void)g_thread_join(self->prv->nwam_events_gthread);
     self->prv->nwam_events_gthread = NULL;
 }
@@ -485,11 +1206,21 @@ nwamui_daemon_finalize (NwamuiDaemon *self)
     int             err;
     nwam_error_t    nerr;
     
-    nwamui_daemon_nwam_disconnect();
-
     if ( prv->nwam_events_gthread != NULL ) {
         nwamui_daemon_terminate_event_thread( self );
+    } else {
+        nwamui_daemon_nwam_disconnect();
     }
+    nwamui_wifi_connect_shutdown();
+    event_source->free(event_source_data);
+    event_source = &nwamui_event_source_libnwam;
+    event_source_data = NULL;
+
+    nwamui_daemon_hydrate_cancel(self);
+    g_queue_free(prv->hydrate_queue);
+
+    nwamui_daemon_dump_event_lane_stats(self);
+    nwamui_daemon_dump_stage_times(self);
     
     if (prv->active_env != NULL ) {
         g_object_unref( G_OBJECT(prv->active_env) );
@@ -775,42 +1506,32 @@ nwamui_ncp_get_first_wireless_ncu_from_active_ncp(NwamuiDaemon *self)
 static void
 nwamui_object_real_event(NwamuiObject *object, guint event, gpointer data)
 {
-    gchar *msg = NULL;
-
     switch (event) {
     case NWAMUI_DAEMON_INFO_WLAN_CONNECTED:
-        msg = g_strdup_printf("%s connected", nwamui_object_get_name(data));
+        nwamui_log_info(NWAMUI_LOG_CAT_EVENT, "%s connected", nwamui_object_get_name(data));
         break;
     case NWAMUI_DAEMON_INFO_WLAN_CONNECT_FAILED:
-        msg = g_strdup_printf("%s connection to wireless lan failed", nwamui_object_get_name(data));
+        nwamui_log_info(NWAMUI_LOG_CAT_EVENT, "%s connection to wireless lan failed", nwamui_object_get_name(data));
         break;
     case NWAMUI_DAEMON_INFO_WLANS_CHANGED:
-        if (data) {
-            msg = g_strdup_printf("NCU %s: New wireless networks found.", nwamui_object_get_name(data));
-        } else {
-            msg = g_strdup_printf("New wireless networks found.");
-        }
+        nwamui_log_info(NWAMUI_LOG_CAT_SCAN, "NCU %s: New wireless networks found.", data ? nwamui_object_get_name(data) : "-");
         break;
     case NWAMUI_DAEMON_INFO_WIFI_SELECTION_NEEDED:
-        msg = g_strdup_printf("Wireless selection needed for network interface '%s'", nwamui_ncu_get_display_name(data));
+        nwamui_log_info(NWAMUI_LOG_CAT_EVENT, "Wireless selection needed for network interface '%s'", nwamui_ncu_get_display_name(data));
         break;
 
     case NWAMUI_DAEMON_INFO_WIFI_KEY_NEEDED:
-        msg = g_strdup_printf("Wireless key needed for network '%s'", nwamui_object_get_name(data));
+        nwamui_log_info(NWAMUI_LOG_CAT_EVENT, "Wireless key needed for network '%s'", nwamui_object_get_name(data));
         break;
 
     case NWAMUI_DAEMON_INFO_GENERIC:
-        msg = g_strdup(data);
+        nwamui_log_info(NWAMUI_LOG_CAT_EVENT, "%s", (const gchar *)data);
         break;
 
     default:
         g_warning("Unknown NWAM event type %d.", event);
-        return;
+        break;
     }
-
-    g_debug ("Daemon got information type %4d msg %s.", event, msg);
-	
-	g_free (msg);
 }
 
 /*
@@ -900,6 +1621,8 @@ nwamui_object_real_remove(NwamuiObject *object, NwamuiObject *child)
     if (nwamui_object_is_modifiable(child)) {
         g_assert(g_list_find(prv->managed_list[idx], child));
         prv->managed_list[idx] = g_list_remove(prv->managed_list[idx], (gpointer)child);
+        /* Not a candidate for removal by a pending staged reload anymore */
+        prv->hydrate_stale[idx] = g_list_remove(prv->hydrate_stale[idx], (gpointer)child);
         g_debug("Remove '%s(0x%p)' from '%s'", nwamui_object_get_name(child), child, nwamui_object_get_name(object));
         g_object_unref(child);
     } else {
@@ -1180,7 +1903,7 @@ dispatch_scan_results_from_wlan_array( NwamuiDaemon *daemon, NwamuiNcu* ncu,  ui
 
     g_return_val_if_fail(ncu && NWAMUI_IS_NCU(ncu), FALSE);
     
-    nwamui_debug("Dispatch scan events for i/f %s  = %s (%d), %d WLANs in cache.",
+    nwamui_log_debug(NWAMUI_LOG_CAT_SCAN, "Dispatch scan events for i/f %s  = %s (%d), %d WLANs in cache.",
       nwamui_object_get_name(NWAMUI_OBJECT(ncu)),
       nwamui_ncu_get_ncu_type(ncu) == NWAMUI_NCU_TYPE_WIRELESS ? "Wireless":"Wired",
       nwamui_ncu_get_ncu_type(ncu),
@@ -1201,7 +1924,7 @@ dispatch_scan_results_from_wlan_array( NwamuiDaemon *daemon, NwamuiNcu* ncu,  ui
         for (int i = 0; i < nwlan; i++) {
             nwam_wlan_t* wlan_p = sorted_wlans[i];
 
-            g_debug("- %3d: %s%s ESSID %s BSSID %s", i + 1,
+            nwamui_log_debug(NWAMUI_LOG_CAT_SCAN, "- %3d: %s%s ESSID %s BSSID %s", i + 1,
               wlan_p->nww_selected?"S":"-",
               wlan_p->nww_connected?"C":"-",
               wlan_p->nww_essid, wlan_p->nww_bssid);
@@ -1309,9 +2032,315 @@ nwamui_event_new(NwamuiDaemon* daemon, int e, nwam_event_t nwamevent)
     event->e = e;
     event->nwamevent = nwamevent;
     event->daemon = g_object_ref(daemon);
+    event->lane = nwamui_event_classify(e, nwamevent);
+    event->queued_at = gethrtime();
     return event;
 }
 
+/*
+ * Classify an event into its lane, SHUTDOWN/INIT, NCP/location actions and
+ * state changes and WLAN key/selection requests are critical, scan reports
+ * are cosmetic, everything else is a plain state update.
+ */
+static nwamui_daemon_event_lane_t
+nwamui_event_classify(int e, nwam_event_t nwamevent)
+{
+    if (e != NWAMUI_DAEMON_INFO_RAW) {
+        /* ACTIVE, INACTIVE, ERROR, etc. are all about the connection to
+         * nwamd.
+         */
+        return NWAMUI_DAEMON_EVENT_LANE_CRITICAL;
+    }
+
+    switch (nwamevent->nwe_type) {
+    case NWAM_EVENT_TYPE_INIT:
+    case NWAM_EVENT_TYPE_SHUTDOWN:
+    case NWAM_EVENT_TYPE_WLAN_NEED_CHOICE:
+    case NWAM_EVENT_TYPE_WLAN_NEED_KEY:
+        return NWAMUI_DAEMON_EVENT_LANE_CRITICAL;
+    case NWAM_EVENT_TYPE_OBJECT_STATE:
+        switch (nwamevent->nwe_data.nwe_object_state.nwe_object_type) {
+        case NWAM_OBJECT_TYPE_NCP:
+        case NWAM_OBJECT_TYPE_LOC:
+            return NWAMUI_DAEMON_EVENT_LANE_CRITICAL;
+        default:
+            return NWAMUI_DAEMON_EVENT_LANE_STATE;
+        }
+    case NWAM_EVENT_TYPE_OBJECT_ACTION:
+        /* In the lane of their states, see event_lane_priority. */
+        switch (nwamevent->nwe_data.nwe_object_action.nwe_object_type) {
+        case NWAM_OBJECT_TYPE_NCP:
+        case NWAM_OBJECT_TYPE_LOC:
+            return NWAMUI_DAEMON_EVENT_LANE_CRITICAL;
+        default:
+            return NWAMUI_DAEMON_EVENT_LANE_STATE;
+        }
+    case NWAM_EVENT_TYPE_WLAN_SCAN_REPORT:
+        return NWAMUI_DAEMON_EVENT_LANE_COSMETIC;
+    default:
+        return NWAMUI_DAEMON_EVENT_LANE_STATE;
+    }
+}
+
+/**
+ * nwamui_event_queue:
+ *
+ * Queue an event to the main loop in its lane. Can be called from the event
+ * thread.
+ */
+static void
+nwamui_event_queue(NwamuiDaemon* daemon, int e, nwam_event_t nwamevent)
+{
+    NwamuiEvent *event = nwamui_event_new(daemon, e, nwamevent);
+
+    g_idle_add_full(event_lane_priority[event->lane],
+      nwamd_event_handler,
+      (gpointer) event,
+      (GDestroyNotify) nwamui_event_free);
+}
+
+/* Account the queueing delay of an event which is going to be handled. */
+static void
+nwamui_event_account_delay(NwamuiDaemon *daemon, NwamuiEvent *event)
+{
+    event_lane_stats_t *stats = &daemon->prv->lane_stats[event->lane];
+    hrtime_t            delay = gethrtime() - event->queued_at;
+
+    stats->count++;
+    stats->total_delay += delay;
+    if (delay > stats->max_delay) {
+        stats->max_delay = delay;
+    }
+}
+
+/**
+ * nwamui_daemon_get_event_lane_stats:
+ * @self: NwamuiDaemon*
+ * @lane: nwamui_daemon_event_lane_t
+ * @count: (out) number of events handled in the lane.
+ * @avg_usec: (out) average queueing delay in microseconds.
+ * @max_usec: (out) maximal queueing delay in microseconds.
+ *
+ * Gets the queueing delay of the events of a lane, i.e. the time between
+ * an event being queued by the event thread and being handled in the main
+ * loop.
+ *
+ **/
+extern void
+nwamui_daemon_get_event_lane_stats(NwamuiDaemon *self,
+  nwamui_daemon_event_lane_t lane,
+  guint *count,
+  guint64 *avg_usec,
+  guint64 *max_usec)
+{
+    event_lane_stats_t *stats;
+
+    g_return_if_fail(NWAMUI_IS_DAEMON(self));
+    g_return_if_fail(lane < NWAMUI_DAEMON_EVENT_LANE_LAST);
+
+    stats = &self->prv->lane_stats[lane];
+
+    if (count) {
+        *count = stats->count;
+    }
+    if (avg_usec) {
+        *avg_usec = stats->count > 0 ? (stats->total_delay / stats->count) / 1000 : 0;
+    }
+    if (max_usec) {
+        *max_usec = stats->max_delay / 1000;
+    }
+}
+
+/**
+ * nwamui_daemon_dump_event_lane_stats:
+ * @self: NwamuiDaemon*
+ *
+ * Logs the queueing delay of each lane in debug mode.
+ *
+ **/
+extern void
+nwamui_daemon_dump_event_lane_stats(NwamuiDaemon *self)
+{
+    g_return_if_fail(NWAMUI_IS_DAEMON(self));
+
+    for (gint i = 0; i < NWAMUI_DAEMON_EVENT_LANE_LAST; i++) {
+        guint   count;
+        guint64 avg_usec;
+        guint64 max_usec;
+
+        nwamui_daemon_get_event_lane_stats(self, i, &count, &avg_usec, &max_usec);
+        nwamui_debug("lane %-8s events %6u delay avg %8" G_GUINT64_FORMAT " us max %8" G_GUINT64_FORMAT " us",
+          event_lane_names[i], count, avg_usec, max_usec);
+    }
+}
+
+/**
+ * nwamui_daemon_set_staged_startup:
+ * @staged: TRUE to load the configuration in stages.
+ * @slice_msec: time budget of a background slice, 0 for the default.
+ *
+ * Must be called before the first nwamui_daemon_get_instance(). A staged
+ * daemon loads the active NCP and location while being created, and the
+ * rest from idle slices of the main loop, see the "hydrated" property.
+ *
+ **/
+extern void
+nwamui_daemon_set_staged_startup(gboolean staged, guint slice_msec)
+{
+    g_return_if_fail(instance == NULL);
+
+    staged_startup = staged;
+    hydrate_slice_msec = slice_msec > 0 ? slice_msec : HYDRATE_SLICE_MSEC_DEFAULT;
+}
+
+/**
+ * nwamui_daemon_set_event_source:
+ * @source: where the event thread takes the nwamd events from.
+ * @data: the data of @source, owned by the daemon from now.
+ *
+ * Must be called before the first nwamui_daemon_get_instance(), the
+ * default is nwamui_event_source_libnwam.
+ *
+ **/
+extern void
+nwamui_daemon_set_event_source(const nwamui_event_source_t *source, gpointer data)
+{
+    g_return_if_fail(instance == NULL);
+    g_return_if_fail(source != NULL);
+
+    event_source->free(event_source_data);
+    event_source = source;
+    event_source_data = data;
+}
+
+/**
+ * nwamui_daemon_set_startup_snapshot:
+ * @snap: a snapshot published by the tray, owned by the daemon from now.
+ *
+ * Must be called before the first nwamui_daemon_get_instance(). A staged
+ * daemon then takes the names of the objects from @snap instead of walking
+ * them, and reconciles with libnwam in the background.
+ *
+ **/
+extern void
+nwamui_daemon_set_startup_snapshot(nwamui_snapshot_t *snap)
+{
+    g_return_if_fail(instance == NULL);
+
+    nwamui_snapshot_close(startup_snapshot);
+    startup_snapshot = snap;
+}
+
+/**
+ * nwamui_daemon_hydrate_now:
+ * @self: NwamuiDaemon*
+ *
+ * Loads whatever a staged reload has left right away, e.g. before applying
+ * changes that must see every object.
+ *
+ **/
+extern void
+nwamui_daemon_hydrate_now(NwamuiDaemon *self)
+{
+    NwamuiDaemonPrivate *prv;
+    hydrate_item_t      *item;
+
+    g_return_if_fail(NWAMUI_IS_DAEMON(self));
+    prv = self->prv;
+
+    if (prv->hydrate_id == 0) {
+        return;
+    }
+
+    g_source_remove(prv->hydrate_id);
+    prv->hydrate_id = 0;
+
+    while ((item = (hydrate_item_t *)g_queue_pop_head(prv->hydrate_queue)) != NULL) {
+        hydrate_load(self, item);
+        hydrate_item_free(item, NULL);
+    }
+    nwamui_daemon_hydrate_finish(self);
+}
+
+/**
+ * nwamui_daemon_is_hydrated:
+ * @self: NwamuiDaemon*
+ *
+ * @returns: FALSE while a staged reload is still loading objects.
+ *
+ **/
+extern gboolean
+nwamui_daemon_is_hydrated(NwamuiDaemon *self)
+{
+    g_return_val_if_fail(NWAMUI_IS_DAEMON(self), FALSE);
+
+    return self->prv->hydrate_id == 0;
+}
+
+/**
+ * nwamui_daemon_mark_stage:
+ * @self: NwamuiDaemon*
+ * @stage: nwamui_daemon_stage_t
+ *
+ * Records the time a startup stage was reached, only the first time. The
+ * daemon marks the CORE and HYDRATED stages, the UI the others.
+ *
+ **/
+extern void
+nwamui_daemon_mark_stage(NwamuiDaemon *self, nwamui_daemon_stage_t stage)
+{
+    g_return_if_fail(NWAMUI_IS_DAEMON(self));
+    g_return_if_fail(stage < NWAMUI_DAEMON_STAGE_LAST);
+
+    if (self->prv->stage_at[stage] == 0) {
+        self->prv->stage_at[stage] = gethrtime();
+        nwamui_debug("stage %s reached after %" G_GUINT64_FORMAT " us",
+          stage_names[stage], nwamui_daemon_get_stage_usec(self, stage));
+    }
+}
+
+/**
+ * nwamui_daemon_get_stage_usec:
+ * @self: NwamuiDaemon*
+ * @stage: nwamui_daemon_stage_t
+ *
+ * @returns: microseconds from the creation of the daemon to @stage, 0 if
+ * it wasn't reached.
+ *
+ **/
+extern guint64
+nwamui_daemon_get_stage_usec(NwamuiDaemon *self, nwamui_daemon_stage_t stage)
+{
+    g_return_val_if_fail(NWAMUI_IS_DAEMON(self), 0);
+    g_return_val_if_fail(stage < NWAMUI_DAEMON_STAGE_LAST, 0);
+
+    if (self->prv->stage_at[stage] == 0) {
+        return 0;
+    }
+    return (self->prv->stage_at[stage] - self->prv->created_at) / 1000;
+}
+
+/**
+ * nwamui_daemon_dump_stage_times:
+ * @self: NwamuiDaemon*
+ *
+ * Logs the time to each startup stage in debug mode.
+ *
+ **/
+extern void
+nwamui_daemon_dump_stage_times(NwamuiDaemon *self)
+{
+    gint    i;
+
+    g_return_if_fail(NWAMUI_IS_DAEMON(self));
+
+    for (i = 0; i < NWAMUI_DAEMON_STAGE_LAST; i++) {
+        nwamui_debug("stage %-8s %10" G_GUINT64_FORMAT " us",
+          stage_names[i], nwamui_daemon_get_stage_usec(self, i));
+    }
+    nwamui_debug("%u background slices", self->prv->hydrate_slices);
+}
+
 static void
 nwamui_event_free(NwamuiEvent *event)
 {
@@ -1426,8 +2455,7 @@ nwamui_daemon_setup_dhcp_or_wep_key_timeout( NwamuiDaemon* self, NwamuiNcu* ncu
                          self->prv->old_rx_packets = nwamui_daemon_get_ncu_received_packets( self, ncu );
 #endif
                          self->prv->wep_timeout_id = 
-                           g_timeout_add_seconds_full(G_PRIORITY_DEFAULT,
-                             WEP_TIMEOUT_SEC,
+                           nwamui_scheduler_add_seconds(WEP_TIMEOUT_SEC,
                              wep_key_timeout_handler,
                              g_object_ref(ncu),
                              (GDestroyNotify)g_object_unref);
@@ -1449,7 +2477,7 @@ nwamui_daemon_disable_dhcp_or_wep_key_timeout( NwamuiDaemon* self, NwamuiNcu* nc
     if ( self->prv->wep_timeout_id == 0 ) 
         return;
 
-    g_source_remove(self->prv->wep_timeout_id);
+    nwamui_scheduler_remove(self->prv->wep_timeout_id);
 
     self->prv->wep_timeout_id = 0;
 }
@@ -1463,6 +2491,10 @@ nwamd_event_handler(gpointer data)
 	nwam_event_t         nwamevent = event->nwamevent;
     nwam_error_t         err;
 
+    nwamui_trace_begin("nwamd_event_handler");
+
+    nwamui_event_account_delay(daemon, event);
+
     switch (event->e) {
     case NWAMUI_DAEMON_INFO_UNKNOWN:
     case NWAMUI_DAEMON_INFO_ERROR:
@@ -1478,10 +2510,21 @@ nwamd_event_handler(gpointer data)
         nwamui_daemon_set_status(daemon, NWAMUI_DAEMON_STATUS_UNINITIALIZED);
 
 		/* Now repopulate data here */
-        nwamui_object_real_reload(NWAMUI_OBJECT(daemon));
-
-        /* Populate wifi list. */
-        nwamui_daemon_dispatch_wifi_scan_events_from_cache(daemon);
+        if (!staged_startup) {
+            nwamui_object_reload(NWAMUI_OBJECT(daemon));
+
+            /* Populate wifi list. */
+            nwamui_daemon_dispatch_wifi_scan_events_from_cache(daemon);
+        } else if (prv->hydrate_id != 0) {
+            /* Connected while the startup pass is still loading, which
+             * reads the rest by then. The states are not cached, only the
+             * status has to be worked out again.
+             */
+            nwamui_daemon_update_status(daemon);
+        } else {
+            /* The last slice dispatches the cached scan results. */
+            nwamui_daemon_reload_staged(daemon);
+        }
 
         /* Trigger notification of active_ncp/env to ensure widgets update */
         /* g_object_notify(G_OBJECT(daemon), "active_ncp"); */
@@ -1490,28 +2533,39 @@ nwamd_event_handler(gpointer data)
         break;
     case NWAMUI_DAEMON_INFO_RAW:
     {
+        /* The WLAN events look up the favourites, which a staged reload
+         * may not have got to yet.
+         */
+        switch (nwamevent->nwe_type) {
+        case NWAM_EVENT_TYPE_WLAN_SCAN_REPORT:
+        case NWAM_EVENT_TYPE_WLAN_NEED_CHOICE:
+        case NWAM_EVENT_TYPE_WLAN_NEED_KEY:
+        case NWAM_EVENT_TYPE_WLAN_CONNECTION_REPORT:
+            nwamui_daemon_hydrate_managed(daemon, MANAGED_KNOWN_WLAN);
+            break;
+        default:
+            break;
+        }
+
+        /* Time the wireless connection attempts on their way. */
+        nwamui_wifi_connect_handle_event(nwamevent);
+
         switch (nwamevent->nwe_type) {
         case NWAM_EVENT_TYPE_INIT:
             /* should repopulate data here */
-            g_debug("%s  NWAM", nwam_event_type_to_string(nwamevent->nwe_type));
+            nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  NWAM", nwam_event_type_to_string(nwamevent->nwe_type));
                 
             /* Redispatch as INFO_ACTIVE */
-            g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-              nwamd_event_handler,
-              (gpointer) nwamui_event_new(daemon, NWAMUI_DAEMON_INFO_ACTIVE, NULL),
-              (GDestroyNotify) nwamui_event_free);
+            nwamui_event_queue(daemon, NWAMUI_DAEMON_INFO_ACTIVE, NULL);
             break;
         case NWAM_EVENT_TYPE_SHUTDOWN:
-            g_debug("%s  NWAM", nwam_event_type_to_string(nwamevent->nwe_type));
+            nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  NWAM", nwam_event_type_to_string(nwamevent->nwe_type));
 
             /* Redispatch as INFO_INACTIVE */
-            g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-              nwamd_event_handler,
-              (gpointer) nwamui_event_new(daemon, NWAMUI_DAEMON_INFO_INACTIVE, NULL),
-              (GDestroyNotify) nwamui_event_free);
+            nwamui_event_queue(daemon, NWAMUI_DAEMON_INFO_INACTIVE, NULL);
             break;
         case NWAM_EVENT_TYPE_PRIORITY_GROUP: {
-            g_debug("%s  %d",
+            nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  %d",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwamevent->nwe_data.nwe_priority_group_info.nwe_priority);
 
@@ -1530,7 +2584,7 @@ nwamd_event_handler(gpointer data)
             break;
         case NWAM_EVENT_TYPE_IF_STATE:
             if (!nwamevent->nwe_data.nwe_if_state.nwe_addr_valid) {
-                g_debug("%s  %s flag(%8X) valid(%u) added(%u)",
+                nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  %s flag(%8X) valid(%u) added(%u)",
                   nwam_event_type_to_string(nwamevent->nwe_type),
                   nwamevent->nwe_data.nwe_if_state.nwe_name,
                   nwamevent->nwe_data.nwe_if_state.nwe_flags,
@@ -1589,7 +2643,7 @@ nwamd_event_handler(gpointer data)
                     nwamui_warning("NCP %s found NCU %s FAILED", nwamui_object_get_name(prv->active_ncp), nwamevent->nwe_data.nwe_if_state.nwe_name);
                 }
 
-                g_debug("%s  %s flag(%8X) valid(%u) added(%u) address %s",
+                nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  %s flag(%8X) valid(%u) added(%u) address %s",
                   nwam_event_type_to_string(nwamevent->nwe_type),
                   nwamevent->nwe_data.nwe_if_state.nwe_name,
                   nwamevent->nwe_data.nwe_if_state.nwe_flags,
@@ -1601,7 +2655,7 @@ nwamd_event_handler(gpointer data)
             break;
 
         case NWAM_EVENT_TYPE_LINK_STATE: {
-            g_debug("%s  %s %s",
+            nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  %s %s",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwamevent->nwe_data.nwe_link_state.nwe_name,
               nwamevent->nwe_data.nwe_link_state.nwe_link_up? "up" : "down");
@@ -1631,7 +2685,7 @@ nwamd_event_handler(gpointer data)
             /* } */
             /*     break; */
             default:
-                g_debug("%s  %s %s",
+                nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  %s %s",
                   nwam_event_type_to_string(nwamevent->nwe_type),
                   nwamevent->nwe_data.nwe_link_action.nwe_name,
                   nwam_action_to_string(nwamevent->nwe_data.nwe_link_action.nwe_action));
@@ -1641,7 +2695,7 @@ nwamd_event_handler(gpointer data)
             break;
             
         case NWAM_EVENT_TYPE_OBJECT_STATE:
-            g_debug( "%s  %s %s -> %s, %s (parent %s)",
+            nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  %s %s -> %s, %s (parent %s)",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwam_object_type_to_string(nwamevent->nwe_data.nwe_object_state.nwe_object_type),
               nwamevent->nwe_data.nwe_object_state.nwe_name,
@@ -1655,7 +2709,7 @@ nwamd_event_handler(gpointer data)
             break;
 
 		case NWAM_EVENT_TYPE_OBJECT_ACTION:
-            g_debug( "%s  %s %s %s (parent %s)",
+            nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s  %s %s %s (parent %s)",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwam_object_type_to_string(nwamevent->nwe_data.nwe_object_action.nwe_object_type),
               nwamevent->nwe_data.nwe_object_action.nwe_name,
@@ -1670,7 +2724,7 @@ nwamd_event_handler(gpointer data)
 		case NWAM_EVENT_TYPE_WLAN_SCAN_REPORT: {
             NwamuiObject * ncu = NULL;
 
-            g_debug( "%s  %s found %u (connected %d)",
+            nwamui_log_debug(NWAMUI_LOG_CAT_SCAN, "%s  %s found %u (connected %d)",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwamevent->nwe_data.nwe_wlan_info.nwe_name,
               nwamevent->nwe_data.nwe_wlan_info.nwe_num_wlans,
@@ -1713,7 +2767,7 @@ nwamd_event_handler(gpointer data)
         case NWAM_EVENT_TYPE_WLAN_NEED_CHOICE: {
             NwamuiObject *ncu    = NULL;
 
-            g_debug( "%s  %s found %u (connected %d)",
+            nwamui_log_debug(NWAMUI_LOG_CAT_SCAN, "%s  %s found %u (connected %d)",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwamevent->nwe_data.nwe_wlan_info.nwe_name,
               nwamevent->nwe_data.nwe_wlan_info.nwe_num_wlans,
@@ -1752,7 +2806,7 @@ nwamd_event_handler(gpointer data)
         case NWAM_EVENT_TYPE_WLAN_CONNECTION_REPORT: {
             NwamuiObject  *ncu       = NULL;
 
-            g_debug( "%s  %s found %u connect to %s (connected %d)",
+            nwamui_log_debug(NWAMUI_LOG_CAT_SCAN, "%s  %s found %u connect to %s (connected %d)",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwamevent->nwe_data.nwe_wlan_info.nwe_name,
               nwamevent->nwe_data.nwe_wlan_info.nwe_num_wlans,
@@ -1803,7 +2857,7 @@ nwamd_event_handler(gpointer data)
         case NWAM_EVENT_TYPE_WLAN_NEED_KEY: {
             NwamuiObject  *ncu  = NULL;
 
-            g_debug( "%s  %s found %u (connected %d)",
+            nwamui_log_debug(NWAMUI_LOG_CAT_SCAN, "%s  %s found %u (connected %d)",
               nwam_event_type_to_string(nwamevent->nwe_type),
               nwamevent->nwe_data.nwe_wlan_info.nwe_name,
               nwamevent->nwe_data.nwe_wlan_info.nwe_num_wlans,
@@ -1842,7 +2896,7 @@ nwamd_event_handler(gpointer data)
 #endif
 
         default:
-            g_debug("NWAMUI_DAEMON_INFO_RAW event type %d (%s)", 
+            nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "NWAMUI_DAEMON_INFO_RAW event type %d (%s)", 
               nwamevent->nwe_type,
               nwam_event_type_to_string(nwamevent->nwe_type));
 
@@ -1855,6 +2909,8 @@ nwamd_event_handler(gpointer data)
     default:
         g_warning("Unsupport UI daemon event %d", event->e);
     }
+
+    nwamui_trace_end("nwamd_event_handler");
     
     return FALSE;
 }
@@ -2281,11 +3337,13 @@ nwamui_daemon_handle_object_state_event( NwamuiDaemon   *daemon, nwam_event_t nw
                 /* Work around since ncu signals of inactive ncp may be received by
                  * active ncp. So ncu may not exist. */
                 if (obj) {
+                    nwamui_object_begin_update(obj);
                     if (nwam_ncu_type == NWAM_NCU_TYPE_INTERFACE) {
                         nwamui_object_set_nwam_state(obj, object_state, object_aux_state);
                     } else {
                         nwamui_ncu_set_link_nwam_state(NWAMUI_NCU(obj), object_state, object_aux_state);
                     }
+                    nwamui_object_end_update(obj);
                     g_object_unref(obj);
                 }
             }
@@ -2294,6 +3352,8 @@ nwamui_daemon_handle_object_state_event( NwamuiDaemon   *daemon, nwam_event_t nw
         case NWAM_OBJECT_TYPE_NCP:
             obj = nwamui_daemon_get_ncp_by_name(daemon, object_name);
             if (obj) {
+                /* The state and the reload below reach the UI as one change. */
+                nwamui_object_begin_update(obj);
                 nwamui_object_set_nwam_state(obj, object_state, object_aux_state);
                 if ( object_state == NWAM_STATE_ONLINE && object_aux_state == NWAM_AUX_STATE_ACTIVE ) {
                     /* Don't use nwamui_object_set_active() since it will
@@ -2309,9 +3369,11 @@ nwamui_daemon_handle_object_state_event( NwamuiDaemon   *daemon, nwam_event_t nw
                      * returns true.
                      */
                     nwamui_object_reload(obj);
+                    nwamui_object_end_update(obj);
 
                     g_object_notify(G_OBJECT(daemon), "active_ncp");
                 } else {
+                    nwamui_object_end_update(obj);
                     status_flags |= STATUS_REASON_NCP;
                 }
                 g_object_unref(obj);
@@ -2450,67 +3512,29 @@ nwamui_deamon_status_to_string( nwamui_daemon_status_t status )
 }
 
 static gboolean
-nwamui_is_nwam_enabled ( void )
-{
-    gboolean            is_nwam_enabled = FALSE;
-    char                *smf_state;
-    char                activencp[NWAM_MAX_NAME_LEN];
-    scf_error_t         serr;    
-    
-    smf_state = smf_get_state(NWAMUI_FMRI);
-    
-    if (strcmp(smf_state, SCF_STATE_STRING_ONLINE) != 0) {
-        g_debug("%s: NWAM service appears to be off-line", __func__);
-    } else {
-        if (get_active_ncp(activencp, sizeof (activencp), &serr) != 0) {
-                g_debug("Failed to retrieve active NCP from SMF: %s", 
-                        scf_strerror(serr));
-        } else {
-            is_nwam_enabled = !NWAM_NCP_DEF_FIXED(activencp);
-        }
-    }
-
-    free(smf_state);
-    
-    return is_nwam_enabled;
-}
-
-static gboolean
-nwamui_daemon_nwam_connect( gboolean block )
+nwamui_daemon_nwam_connect( void )
 {
-    gboolean      rval = FALSE;
-    gboolean      not_done;
-    nwam_error_t  nerr;
+    gboolean      rval;
+    gboolean      terminated;
 
     g_static_mutex_lock (&nwam_event_mutex);
-    nwam_init_done = rval;
+    nwam_init_done = FALSE;
+    nwam_smf_changed = FALSE;
     g_static_mutex_unlock (&nwam_event_mutex);
 
-    do {
-
-        if ( ! nwamui_is_nwam_enabled() ) {
-            g_debug("NWAM not enabled" );
-        }
-        else if ( (nerr = nwam_events_init()) == NWAM_SUCCESS) {
-            g_debug("%s: Connected to nwam daemon", __func__);
-            rval = TRUE;
-        }
-        else {
-            g_debug("%s: nwam_events_init() returned %d (%s)", 
-                    __func__, nerr, nwam_strerror(nerr) );
-        }
-
-        not_done = (block && !rval );
-        if ( not_done ) {
-            g_debug("%s: sleeping...", __func__);
-            sleep( 5 );
-        }
-    } while ( not_done );
+    rval = event_source->open(event_source_data);
 
     g_static_mutex_lock (&nwam_event_mutex);
-    nwam_init_done = rval;
+    terminated = nwam_event_thread_terminate;
+    nwam_init_done = rval && !terminated;
     g_static_mutex_unlock (&nwam_event_mutex);
 
+    /* Terminated while opening, nobody would close it to unblock wait. */
+    if ( rval && terminated ) {
+        event_source->close(event_source_data);
+        rval = FALSE;
+    }
+
     return( rval );
 }
 
@@ -2521,19 +3545,106 @@ nwamui_daemon_nwam_disconnect( void )
 
     g_static_mutex_lock (&nwam_event_mutex);
     _init_done = nwam_init_done;
+    nwam_init_done = FALSE;
     g_static_mutex_unlock (&nwam_event_mutex);
 
     if ( _init_done ) {
-        g_debug( "%s: Closing connection to nwam daemon", __func__ );
-        (void) nwam_events_fini();
+        event_source->close(event_source_data);
+    }
+}
+
+/**
+ * nwam_events_backoff_wait:
+ * @backoff: seconds to wait before the next connect attempt.
+ *
+ * Sleeps for @backoff seconds plus/minus 25% of jitter, so a fleet of
+ * desktops won't hammer a restarting nwamd in lock step. Returns early if
+ * the event thread is terminated, or the SMF state of nwam changes.
+ */
+static void
+nwam_events_backoff_wait( guint backoff )
+{
+    GTimeVal    deadline;
+    glong       msec;
+
+    msec = (glong)(backoff * 1000 * g_random_double_range(0.75, 1.25));
+
+    g_get_current_time(&deadline);
+    g_time_val_add(&deadline, msec * 1000);
+
+    g_debug("%s: next connect attempt in %ld ms", __func__, msec);
+
+    g_static_mutex_lock (&nwam_event_mutex);
+    while (!nwam_event_thread_terminate && !nwam_smf_changed) {
+        if (!g_cond_timed_wait(nwam_event_cond,
+            g_static_mutex_get_mutex(&nwam_event_mutex), &deadline)) {
+            break;
+        }
     }
+    g_static_mutex_unlock (&nwam_event_mutex);
 }
 
+/**
+ * nwam_smf_watch_thread:
+ *
+ * Blocks on state changes of the restarter property group of any SMF
+ * instance, and wakes up the event thread when it is nwam's, so it can
+ * reconnect immediately instead of waiting for its backoff.
+ */
+static gpointer
+nwam_smf_watch_thread ( gpointer data )
+{
+    scf_handle_t        *h;
+    scf_propertygroup_t *pg = NULL;
+    ssize_t              fmri_len = scf_limit(SCF_LIMIT_MAX_FMRI_LENGTH) + 1;
+    char                *fmri = g_malloc0(fmri_len);
+
+    if ((h = scf_handle_create(SCF_VERSION)) == NULL ||
+      scf_handle_bind(h) != 0 ||
+      (pg = scf_pg_create(h)) == NULL ||
+      _scf_notify_add_pgname(h, SCF_PG_RESTARTER) != SCF_SUCCESS) {
+        g_debug("%s: can't watch SMF state changes: %s", __func__, scf_strerror(scf_error()));
+        goto cleanup;
+    }
+
+    while (event_thread_running()) {
+        if (_scf_notify_wait(pg, fmri, fmri_len) < 0) {
+            g_debug("%s: _scf_notify_wait failed: %s", __func__, scf_strerror(scf_error()));
+            break;
+        }
+        if (g_str_has_prefix(fmri, NWAMUI_FMRI)) {
+            g_debug("%s: %s changed", __func__, NWAMUI_FMRI);
+
+            g_static_mutex_lock (&nwam_event_mutex);
+            nwam_smf_changed = TRUE;
+            g_cond_broadcast (nwam_event_cond);
+            g_static_mutex_unlock (&nwam_event_mutex);
+        }
+    }
+
+cleanup:
+    if (pg) {
+        scf_pg_destroy(pg);
+    }
+    if (h) {
+        (void) scf_handle_unbind(h);
+        scf_handle_destroy(h);
+    }
+    g_free(fmri);
+    return NULL;
+}
 
 /**
  * nwam_events_thread:
  *
  * This callback is needed to be MT safe.
+ *
+ * While connected it waits for the nwamd events of the event source,
+ * libnwam unless nwamui_daemon_set_event_source() was called, and queues
+ * them to the main loop. Once the connection is lost a single INACTIVE is queued, and it
+ * reconnects with a capped exponential backoff, or immediately when the
+ * SMF state of nwam changes. The backoff starts over once an event is
+ * received, not on connect.
  */
 static gpointer
 nwam_events_thread ( gpointer data )
@@ -2542,33 +3653,35 @@ nwam_events_thread ( gpointer data )
 	nwam_event_t            nwamevent = NULL;
     nwam_error_t            err;
     gboolean                connected_to_nwamd = FALSE;
+    gboolean                inactive_reported = FALSE;
+    guint                   backoff = EVENTS_RECONNECT_BACKOFF_MIN_SEC;
 
     g_debug ("nwam_events_thread");
     
-    if ( nwamui_daemon_nwam_connect( FALSE ) ) {
-		/*
-         * We can emit NWAMUI_DAEMON_INFO_ACTIVE here, so we can populate all
-         * the info in nwamd_event_handler
-		 */
-        connected_to_nwamd = TRUE;
-
-		g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-		  nwamd_event_handler,
-		  (gpointer) nwamui_event_new(daemon, NWAMUI_DAEMON_INFO_ACTIVE, NULL),
-		  (GDestroyNotify) nwamui_event_free);
-    }
-	
 	while (event_thread_running()) {
-        if ( (err = nwam_event_wait( &nwamevent)) != NWAM_SUCCESS ) {
-			g_debug("Event wait error: %s", nwam_strerror(err));
+        if ( !connected_to_nwamd ) {
+            if ( nwamui_daemon_nwam_connect() ) {
+                /*
+                 * We can emit NWAMUI_DAEMON_INFO_ACTIVE here, so we can
+                 * populate all the info in nwamd_event_handler
+                 */
+                nwamui_event_queue(daemon, NWAMUI_DAEMON_INFO_ACTIVE, NULL);
+                connected_to_nwamd = TRUE;
+                inactive_reported = FALSE;
+            } else {
+                /* Tell UI only once, then stay quiet until reconnected. */
+                if ( !inactive_reported ) {
+                    nwamui_event_queue(daemon, NWAMUI_DAEMON_INFO_INACTIVE, NULL);
+                    inactive_reported = TRUE;
+                }
+                nwam_events_backoff_wait(backoff);
+                backoff = MIN(backoff * 2, EVENTS_RECONNECT_BACKOFF_MAX_SEC);
+                continue;
+            }
+        }
 
-            /* Send event to tell UI there was an error */
-            g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-              nwamd_event_handler,
-              (gpointer) nwamui_event_new(daemon, NWAMUI_DAEMON_INFO_ERROR, NULL),
-              (GDestroyNotify) nwamui_event_free);
-              
-            connected_to_nwamd = FALSE;
+        if ( (err = event_source->wait(event_source_data, &nwamevent)) != NWAM_SUCCESS ) {
+			g_debug("Event wait error: %s", nwam_strerror(err));
 
             if ( ! event_thread_running() ) {
                 /* If we were waiting for an event and we got an error, make
@@ -2576,53 +3689,34 @@ nwam_events_thread ( gpointer data )
                  */
                 continue;
             }
-			if (err != NWAM_SUCCESS ) {
-                /* Try again */
-                if ( (err = nwam_event_wait( &nwamevent)) != NWAM_SUCCESS ) {
-                    g_debug("Attempting to reopen connection to daemon");
-                    nwamui_daemon_nwam_disconnect();
-                    if ( nwamui_daemon_nwam_connect( TRUE ) ) {
-                        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-                          nwamd_event_handler,
-                          (gpointer) nwamui_event_new(daemon, NWAMUI_DAEMON_INFO_ACTIVE, NULL),
-                          (GDestroyNotify) nwamui_event_free);
-
-                        connected_to_nwamd = TRUE;
-
-                        continue;
-                    }
-                }
-                else {
-                    g_debug("nwam_event_wait() error: %s", nwam_strerror(err));
-                }
-			}
-			/* Rather than just breaking out here, it is better if we sleep
-             * and then retry things again so long as event_thread_running()
-             * is TRUE.
-             */
-            sleep(1);
+
+            g_debug("Attempting to reopen connection to daemon");
+            nwamui_daemon_nwam_disconnect();
+            connected_to_nwamd = FALSE;
+            /* The backoff is only reset by an event, so a source which
+             * opens fine but fails every wait isn't reopened in a loop. */
+            nwam_events_backoff_wait(backoff);
+            backoff = MIN(backoff * 2, EVENTS_RECONNECT_BACKOFF_MAX_SEC);
             continue;
 		}
         else if ( nwamevent->nwe_type == NWAM_EVENT_TYPE_SHUTDOWN ) {
-            /* NWAM has done a clean shutdown, remember this, so we can reset
-             * to connected on next event.
+            /* NWAM has done a clean shutdown, the handler redispatches it
+             * as INACTIVE, remember this, so we can reset to connected on
+             * next event.
              */
-            connected_to_nwamd = FALSE;
+            inactive_reported = TRUE;
         }
-        else if ( !connected_to_nwamd ) {
-            g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-              nwamd_event_handler,
-              (gpointer) nwamui_event_new(daemon, NWAMUI_DAEMON_INFO_ACTIVE, NULL),
-              (GDestroyNotify) nwamui_event_free);
-            connected_to_nwamd = TRUE;
+        else if ( inactive_reported ) {
+            nwamui_event_queue(daemon, NWAMUI_DAEMON_INFO_ACTIVE, NULL);
+            inactive_reported = FALSE;
         }
         
-        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
-          nwamd_event_handler,
-          (gpointer) nwamui_event_new(daemon, NWAMUI_DAEMON_INFO_RAW, nwamevent),
-          (GDestroyNotify) nwamui_event_free);
+        backoff = EVENTS_RECONNECT_BACKOFF_MIN_SEC;
+        nwamui_event_queue(daemon, NWAMUI_DAEMON_INFO_RAW, nwamevent);
     }
-    
+
+    nwamui_daemon_nwam_disconnect();
+
     g_object_unref (daemon);
 
     g_debug("Exiting event thread");
@@ -72,6 +72,21 @@ typedef enum {
 } nwamui_daemon_info_t;
 
 
+typedef enum {
+    NWAMUI_DAEMON_EVENT_LANE_CRITICAL = 0,  /* Connection, NCP/Loc, WLAN key/selection */
+    NWAMUI_DAEMON_EVENT_LANE_STATE,         /* Other object and interface state changes */
+    NWAMUI_DAEMON_EVENT_LANE_COSMETIC,      /* Scan reports, signal updates */
+    NWAMUI_DAEMON_EVENT_LANE_LAST /* Not to be used directly */
+} nwamui_daemon_event_lane_t;
+
+typedef enum {
+    NWAMUI_DAEMON_STAGE_CORE = 0,           /* Active NCP and location loaded */
+    NWAMUI_DAEMON_STAGE_ICON,               /* Status icon shows the status */
+    NWAMUI_DAEMON_STAGE_MENUS,              /* Menus built */
+    NWAMUI_DAEMON_STAGE_HYDRATED,           /* All objects loaded */
+    NWAMUI_DAEMON_STAGE_LAST /* Not to be used directly */
+} nwamui_daemon_stage_t;
+
 typedef enum {
     NWAMUI_DAEMON_EVENT_CAUSE_NONE,
     NWAMUI_DAEMON_EVENT_CAUSE_DHCP_DOWN,
@@ -142,8 +157,6 @@ extern NwamuiEnv*                   nwamui_daemon_get_active_env(NwamuiDaemon *s
 
 extern gchar*                       nwamui_daemon_get_active_env_name(NwamuiDaemon *self);
 
-extern GtkTreeModel *               nwamui_get_default_svcs (NwamuiDaemon *self);
-
 extern gint                         nwamui_daemon_get_online_enm_num(NwamuiDaemon *self);
 
 extern void                         nwamui_daemon_wifi_start_scan(NwamuiDaemon *self);
@@ -158,6 +171,33 @@ extern nwamui_daemon_status_t       nwamui_daemon_get_status_icon_type( NwamuiDa
 
 extern const gchar*                 nwamui_deamon_status_to_string( nwamui_daemon_status_t status );
 
+extern void                         nwamui_daemon_get_event_lane_stats(NwamuiDaemon *self,
+                                                                       nwamui_daemon_event_lane_t lane,
+                                                                       guint *count,
+                                                                       guint64 *avg_usec,
+                                                                       guint64 *max_usec);
+
+extern void                         nwamui_daemon_dump_event_lane_stats(NwamuiDaemon *self);
+
+extern void                         nwamui_daemon_set_staged_startup(gboolean staged, guint slice_msec);
+
+extern void                         nwamui_daemon_set_event_source(const nwamui_event_source_t *source, gpointer data);
+
+/* nwamui_snapshot_t, nwamui_snapshot.h comes after this header. */
+struct _nwamui_snapshot;
+
+extern void                         nwamui_daemon_set_startup_snapshot(struct _nwamui_snapshot *snap);
+
+extern void                         nwamui_daemon_hydrate_now(NwamuiDaemon *self);
+
+extern gboolean                     nwamui_daemon_is_hydrated(NwamuiDaemon *self);
+
+extern void                         nwamui_daemon_mark_stage(NwamuiDaemon *self, nwamui_daemon_stage_t stage);
+
+extern guint64                      nwamui_daemon_get_stage_usec(NwamuiDaemon *self, nwamui_daemon_stage_t stage);
+
+extern void                         nwamui_daemon_dump_stage_times(NwamuiDaemon *self);
+
 extern void                         nwamui_daemon_foreach_ncp(NwamuiDaemon *self, GFunc func, gpointer user_data);
 extern void                         nwamui_daemon_foreach_loc(NwamuiDaemon *self, GFunc func, gpointer user_data);
 extern void                         nwamui_daemon_foreach_enm(NwamuiDaemon *self, GFunc func, gpointer user_data);
@@ -0,0 +1,443 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_edit_session.c
+ *
+ */
+
+#include <string.h>
+#include <sys/time.h>
+#include <glib-object.h>
+#include <gobject/gvaluecollector.h>
+
+#include "libnwamui.h"
+
+typedef struct {
+    GParamSpec     *pspec;
+    GValue          value;
+} edit_change_t;
+
+struct _nwamui_edit_session {
+    NwamuiObject   *base;
+    GList          *changes;    /* edit_change_t*, in the order first made */
+};
+
+static void
+edit_change_free(gpointer data, gpointer user_data)
+{
+    edit_change_t  *change = (edit_change_t *)data;
+
+    g_value_unset(&change->value);
+    g_free(change);
+}
+
+static GList*
+edit_session_find(nwamui_edit_session_t *session, GParamSpec *pspec)
+{
+    GList  *idx;
+
+    for (idx = session->changes; idx; idx = idx->next) {
+        if (((edit_change_t *)idx->data)->pspec == pspec) {
+            return idx;
+        }
+    }
+    return NULL;
+}
+
+static GParamSpec*
+edit_session_find_pspec(nwamui_edit_session_t *session, const gchar *property_name)
+{
+    GParamSpec *pspec;
+
+    pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(session->base), property_name);
+    if (pspec == NULL) {
+        g_warning("%s: `%s' has no property named `%s'", G_STRFUNC,
+          G_OBJECT_TYPE_NAME(session->base), property_name);
+    }
+    return pspec;
+}
+
+/* Takes over value. */
+static void
+edit_session_set_value(nwamui_edit_session_t *session, GParamSpec *pspec, GValue *value)
+{
+    GValue          current = { 0 };
+    GList          *found;
+    edit_change_t  *change;
+
+    if (!(pspec->flags & G_PARAM_WRITABLE)) {
+        g_warning("%s: property `%s' of `%s' is not writable", G_STRFUNC,
+          pspec->name, G_OBJECT_TYPE_NAME(session->base));
+        g_value_unset(value);
+        return;
+    }
+
+    found = edit_session_find(session, pspec);
+
+    /* Back to what the object has is no change. */
+    g_value_init(&current, G_PARAM_SPEC_VALUE_TYPE(pspec));
+    g_object_get_property(G_OBJECT(session->base), pspec->name, &current);
+    if (g_param_values_cmp(pspec, value, &current) == 0) {
+        if (found) {
+            edit_change_free(found->data, NULL);
+            session->changes = g_list_delete_link(session->changes, found);
+        }
+        g_value_unset(&current);
+        g_value_unset(value);
+        return;
+    }
+    g_value_unset(&current);
+
+    if (found) {
+        change = (edit_change_t *)found->data;
+        g_value_unset(&change->value);
+    } else {
+        change = g_new0(edit_change_t, 1);
+        change->pspec = pspec;
+        session->changes = g_list_append(session->changes, change);
+    }
+    /* A bitwise move, value is not to be unset by the caller. */
+    memcpy(&change->value, value, sizeof (GValue));
+}
+
+/**
+ * nwamui_edit_session_new:
+ * @base: the object to edit.
+ * @returns: a session without changes, which holds a reference on @base.
+ **/
+extern nwamui_edit_session_t*
+nwamui_edit_session_new(NwamuiObject *base)
+{
+    nwamui_edit_session_t  *session;
+
+    g_return_val_if_fail(NWAMUI_IS_OBJECT(base), NULL);
+
+    /* The properties are read from the configuration. */
+    if (nwamui_object_is_stand_in(base)) {
+        nwamui_object_reload(base);
+    }
+
+    session = g_new0(nwamui_edit_session_t, 1);
+    session->base = NWAMUI_OBJECT(g_object_ref(base));
+
+    return session;
+}
+
+extern void
+nwamui_edit_session_free(nwamui_edit_session_t *session)
+{
+    if (session == NULL) {
+        return;
+    }
+    nwamui_edit_session_discard(session);
+    g_object_unref(session->base);
+    g_free(session);
+}
+
+extern NwamuiObject*
+nwamui_edit_session_get_base(nwamui_edit_session_t *session)
+{
+    g_return_val_if_fail(session != NULL, NULL);
+
+    return session->base;
+}
+
+/**
+ * nwamui_edit_session_set:
+ * @first_property_name: as for g_object_set().
+ *
+ * Changes properties in the session, the object is not touched.
+ **/
+extern void
+nwamui_edit_session_set(nwamui_edit_session_t *session, const gchar *first_property_name, ...)
+{
+    const gchar    *name;
+    va_list         args;
+
+    g_return_if_fail(session != NULL);
+
+    va_start(args, first_property_name);
+
+    for (name = first_property_name; name; name = va_arg(args, const gchar *)) {
+        GParamSpec *pspec = edit_session_find_pspec(session, name);
+        GValue      value = { 0 };
+        gchar      *error = NULL;
+
+        if (pspec == NULL) {
+            break;
+        }
+
+        g_value_init(&value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+        G_VALUE_COLLECT(&value, args, 0, &error);
+        if (error) {
+            g_warning("%s: %s", G_STRFUNC, error);
+            g_free(error);
+            /* The arguments can't be walked any further. */
+            break;
+        }
+        edit_session_set_value(session, pspec, &value);
+    }
+
+    va_end(args);
+}
+
+/**
+ * nwamui_edit_session_get:
+ * @first_property_name: as for g_object_get().
+ *
+ * Reads properties as changed in the session, else from the object.
+ **/
+extern void
+nwamui_edit_session_get(nwamui_edit_session_t *session, const gchar *first_property_name, ...)
+{
+    const gchar    *name;
+    va_list         args;
+
+    g_return_if_fail(session != NULL);
+
+    va_start(args, first_property_name);
+
+    for (name = first_property_name; name; name = va_arg(args, const gchar *)) {
+        GParamSpec *pspec = edit_session_find_pspec(session, name);
+        GValue      value = { 0 };
+        gchar      *error = NULL;
+
+        if (pspec == NULL) {
+            break;
+        }
+
+        g_value_init(&value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+        nwamui_edit_session_get_property(session, name, &value);
+        G_VALUE_LCOPY(&value, args, 0, &error);
+        g_value_unset(&value);
+        if (error) {
+            g_warning("%s: %s", G_STRFUNC, error);
+            g_free(error);
+            break;
+        }
+    }
+
+    va_end(args);
+}
+
+extern void
+nwamui_edit_session_set_property(nwamui_edit_session_t *session, const gchar *property_name,
+  const GValue *value)
+{
+    GParamSpec *pspec;
+    GValue      copy = { 0 };
+
+    g_return_if_fail(session != NULL);
+    g_return_if_fail(G_IS_VALUE(value));
+
+    if ((pspec = edit_session_find_pspec(session, property_name)) == NULL) {
+        return;
+    }
+
+    g_value_init(&copy, G_PARAM_SPEC_VALUE_TYPE(pspec));
+    if (!g_value_transform(value, &copy)) {
+        g_warning("%s: can't set `%s' from a value of type `%s'", G_STRFUNC,
+          property_name, G_VALUE_TYPE_NAME(value));
+        g_value_unset(&copy);
+        return;
+    }
+    edit_session_set_value(session, pspec, &copy);
+}
+
+/**
+ * nwamui_edit_session_get_property:
+ * @value: initialized to the type of the property, or one it transforms to.
+ **/
+extern void
+nwamui_edit_session_get_property(nwamui_edit_session_t *session, const gchar *property_name,
+  GValue *value)
+{
+    GParamSpec *pspec;
+    GList      *found;
+
+    g_return_if_fail(session != NULL);
+    g_return_if_fail(G_IS_VALUE(value));
+
+    if ((pspec = edit_session_find_pspec(session, property_name)) == NULL) {
+        return;
+    }
+
+    if ((found = edit_session_find(session, pspec)) != NULL) {
+        g_value_transform(&((edit_change_t *)found->data)->value, value);
+    } else {
+        g_object_get_property(G_OBJECT(session->base), property_name, value);
+    }
+}
+
+extern gboolean
+nwamui_edit_session_has_changes(nwamui_edit_session_t *session)
+{
+    g_return_val_if_fail(session != NULL, FALSE);
+
+    return session->changes != NULL;
+}
+
+/**
+ * nwamui_edit_session_get_changes:
+ * @returns: the names of the changed properties, in the order first
+ * changed. Free the list only.
+ **/
+extern GList*
+nwamui_edit_session_get_changes(nwamui_edit_session_t *session)
+{
+    GList  *names = NULL;
+    GList  *idx;
+
+    g_return_val_if_fail(session != NULL, NULL);
+
+    for (idx = session->changes; idx; idx = idx->next) {
+        names = g_list_prepend(names, (gpointer)((edit_change_t *)idx->data)->pspec->name);
+    }
+    return g_list_reverse(names);
+}
+
+extern void
+nwamui_edit_session_discard(nwamui_edit_session_t *session)
+{
+    g_return_if_fail(session != NULL);
+
+    g_list_foreach(session->changes, edit_change_free, NULL);
+    g_list_free(session->changes);
+    session->changes = NULL;
+}
+
+/*
+ * Sets the changes on the object as one update, keeping them. If saved_ret
+ * is non-NULL it gets the values the object had, to restore them with
+ * edit_session_restore().
+ */
+static guint
+edit_session_set_on_base(nwamui_edit_session_t *session, GList **saved_ret)
+{
+    GList  *idx;
+    guint   n = 0;
+
+    nwamui_object_begin_update(session->base);
+    for (idx = session->changes; idx; idx = idx->next) {
+        edit_change_t  *change = (edit_change_t *)idx->data;
+
+        if (saved_ret) {
+            edit_change_t  *saved = g_new0(edit_change_t, 1);
+
+            saved->pspec = change->pspec;
+            g_value_init(&saved->value, G_PARAM_SPEC_VALUE_TYPE(change->pspec));
+            g_object_get_property(G_OBJECT(session->base), change->pspec->name, &saved->value);
+            *saved_ret = g_list_prepend(*saved_ret, saved);
+        }
+        g_object_set_property(G_OBJECT(session->base), change->pspec->name, &change->value);
+        n++;
+    }
+    nwamui_object_end_update(session->base);
+
+    return n;
+}
+
+/* Puts back the values saved by edit_session_set_on_base() and frees them. */
+static void
+edit_session_restore(nwamui_edit_session_t *session, GList *saved)
+{
+    GList  *idx;
+
+    nwamui_object_begin_update(session->base);
+    for (idx = saved; idx; idx = idx->next) {
+        edit_change_t  *change = (edit_change_t *)idx->data;
+
+        g_object_set_property(G_OBJECT(session->base), change->pspec->name, &change->value);
+    }
+    nwamui_object_end_update(session->base);
+
+    g_list_foreach(saved, edit_change_free, NULL);
+    g_list_free(saved);
+}
+
+/**
+ * nwamui_edit_session_apply:
+ * @returns: the number of properties set on the object.
+ *
+ * Sets the changes on the object, as one update, and empties the session.
+ * They are not committed.
+ **/
+extern guint
+nwamui_edit_session_apply(nwamui_edit_session_t *session)
+{
+    guint   n;
+
+    g_return_val_if_fail(session != NULL, 0);
+
+    n = edit_session_set_on_base(session, NULL);
+    nwamui_edit_session_discard(session);
+
+    return n;
+}
+
+/**
+ * nwamui_edit_session_commit:
+ * @prop_name_ret: if non-NULL, the property failing validation, to be
+ * freed by the caller.
+ * @returns: TRUE on success.
+ *
+ * Applies the changes, then validates and commits the object. An object
+ * without changes or earlier modifications, e.g. a new one, isn't
+ * committed at all. On failure the object gets back the values it had
+ * and the session keeps the changes, so they can be corrected and
+ * committed again.
+ **/
+extern gboolean
+nwamui_edit_session_commit(nwamui_edit_session_t *session, gchar **prop_name_ret)
+{
+    hrtime_t    start;
+    guint       n;
+    GList      *saved = NULL;
+
+    g_return_val_if_fail(session != NULL, FALSE);
+
+    if (session->changes == NULL && !nwamui_object_has_modifications(session->base)) {
+        return TRUE;
+    }
+
+    start = gethrtime();
+    n = edit_session_set_on_base(session, &saved);
+
+    if (!nwamui_object_validate(session->base, prop_name_ret) ||
+      !nwamui_object_commit(session->base)) {
+        edit_session_restore(session, saved);
+        return FALSE;
+    }
+    g_list_foreach(saved, edit_change_free, NULL);
+    g_list_free(saved);
+    nwamui_edit_session_discard(session);
+
+    nwamui_debug("%s: committed %u changed properties in %" G_GINT64_FORMAT " us",
+      nwamui_object_get_name(session->base), n, (gint64)((gethrtime() - start) / 1000));
+
+    return TRUE;
+}
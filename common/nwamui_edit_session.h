@@ -0,0 +1,86 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_edit_session.h
+ *
+ */
+
+#ifndef _NWAMUI_EDIT_SESSION_H
+#define	_NWAMUI_EDIT_SESSION_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * An edit session keeps the property changes of a dialog apart from the
+ * object they are made to. Nothing is copied up front: reads fall through
+ * to the object unless the property was changed, and setting a property
+ * back to the object's value drops the change. Discarding forgets the
+ * changes, applying sets only the remaining ones on the object.
+ */
+
+typedef struct _nwamui_edit_session nwamui_edit_session_t;
+
+extern nwamui_edit_session_t*   nwamui_edit_session_new(NwamuiObject *base);
+
+extern void                     nwamui_edit_session_free(nwamui_edit_session_t *session);
+
+extern NwamuiObject*            nwamui_edit_session_get_base(nwamui_edit_session_t *session);
+
+extern void                     nwamui_edit_session_set(nwamui_edit_session_t *session,
+                                                        const gchar *first_property_name,
+                                                        ...) G_GNUC_NULL_TERMINATED;
+
+extern void                     nwamui_edit_session_get(nwamui_edit_session_t *session,
+                                                        const gchar *first_property_name,
+                                                        ...) G_GNUC_NULL_TERMINATED;
+
+extern void                     nwamui_edit_session_set_property(nwamui_edit_session_t *session,
+                                                                 const gchar *property_name,
+                                                                 const GValue *value);
+
+extern void                     nwamui_edit_session_get_property(nwamui_edit_session_t *session,
+                                                                 const gchar *property_name,
+                                                                 GValue *value);
+
+extern gboolean                 nwamui_edit_session_has_changes(nwamui_edit_session_t *session);
+
+extern GList*                   nwamui_edit_session_get_changes(nwamui_edit_session_t *session);
+
+extern void                     nwamui_edit_session_discard(nwamui_edit_session_t *session);
+
+extern guint                    nwamui_edit_session_apply(nwamui_edit_session_t *session);
+
+extern gboolean                 nwamui_edit_session_commit(nwamui_edit_session_t *session,
+                                                           gchar **prop_name_ret);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_EDIT_SESSION_H */
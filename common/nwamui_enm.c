@@ -1041,6 +1041,54 @@ nwamui_enm_get_smf_fmri (NwamuiEnm *self)
     return( smf_fmri );
 }
 
+/** 
+ * nwamui_enm_validate_string_prop:
+ * @nwamui_enm: a #NwamuiEnm.
+ * @property_name: "start_command", "stop_command" or "smf_fmri".
+ * @value: the value to check, NULL or empty for none.
+ * @returns: whether the property can be set to @value, the ENM is not changed.
+ * 
+ **/ 
+extern gboolean
+nwamui_enm_validate_string_prop ( NwamuiEnm *self, const gchar* property_name, const gchar* value )
+{
+    const char*     prop_name;
+    nwam_value_t    nwam_data;
+    nwam_error_t    nerr;
+
+    g_return_val_if_fail (NWAMUI_IS_ENM (self), FALSE);
+    g_return_val_if_fail (property_name != NULL, FALSE);
+
+    if ( strcmp( property_name, "start_command" ) == 0 ) {
+        prop_name = NWAM_ENM_PROP_START;
+    } else if ( strcmp( property_name, "stop_command" ) == 0 ) {
+        prop_name = NWAM_ENM_PROP_STOP;
+    } else if ( strcmp( property_name, "smf_fmri" ) == 0 ) {
+        prop_name = NWAM_ENM_PROP_FMRI;
+    } else {
+        g_warning("Unexpected enm property %s", property_name );
+        return( FALSE );
+    }
+
+    /* Deleted by the setter rather than set to empty. */
+    if ( value == NULL || *value == '\0' ) {
+        return( TRUE );
+    }
+    if ( self->prv->nwam_enm == NULL ) {
+        g_warning("Unexpected null enm handle");
+        return( FALSE );
+    }
+
+    if ( (nerr = nwam_value_create_string( (char*)value, &nwam_data )) != NWAM_SUCCESS ) {
+        g_debug("Error creating a string value for string %s", value );
+        return( FALSE );
+    }
+    nerr = nwam_enm_validate_prop( self->prv->nwam_enm, prop_name, nwam_data );
+    nwam_value_free( nwam_data );
+
+    return( nerr == NWAM_SUCCESS );
+}
+
 static void
 nwamui_object_real_set_activation_mode ( NwamuiObject *object, gint activation_mode )
 {
@@ -80,6 +80,8 @@ extern gchar*               nwamui_enm_get_stop_command ( NwamuiEnm *self );
 extern gboolean             nwamui_enm_set_smf_fmri ( NwamuiEnm *self, const gchar* smf_frmi );
 extern gchar*               nwamui_enm_get_smf_fmri ( NwamuiEnm *self );
 
+extern gboolean             nwamui_enm_validate_string_prop ( NwamuiEnm *self, const gchar* property_name, const gchar* value );
+
 G_END_DECLS
 
 #endif	/* _NWAMUI_ENM_H */
@@ -35,19 +35,13 @@
 
 #include "libnwamui.h"
 
-enum {
-    SVC_OBJECT = 0,
-    SVC_N_COL,
-};
-
 struct _NwamuiEnvPrivate {
     gchar*                      name;
     nwam_loc_handle_t			nwam_loc;
     gboolean                    nwam_loc_modified;
     gboolean                    enabled; /* Cache state we we can "enable" on commit */
 
-    GtkListStore*               svcs_model;
-    GtkListStore*               sys_svcs_model;
+    GList*                      svcs;       /* Of NwamuiSvc */
 
     /* Not used for Phase 1 any more */
 #ifdef ENABLE_PROXY
@@ -181,10 +175,6 @@ static gboolean     nwamui_object_real_has_modifications(NwamuiObject* object);
 static gboolean nwamui_env_svc_commit (NwamuiEnv *self, NwamuiSvc *svc);
 #endif /* 0 */
 
-/* Callbacks */
-static void svc_row_inserted_or_changed_cb (GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer user_data); 
-static void svc_row_deleted_cb (GtkTreeModel *tree_model, GtkTreePath *path, gpointer user_data);
-
 #if 0
 /* These are not needed right now since we don't support property templates,
  * but would like to keep around for when we do.
@@ -420,11 +410,10 @@ nwamui_env_class_init (NwamuiEnvClass *klass)
 
     g_object_class_install_property (gobject_class,
                                      PROP_SVCS,
-                                     g_param_spec_object ("svcs",
-                                                          _("smf services"),
-                                                          _("smf services"),
-                                                          GTK_TYPE_TREE_MODEL,
-                                                          G_PARAM_READABLE));
+                                     g_param_spec_pointer ("svcs",
+                                                           _("smf services"),
+                                                           _("smf services"),
+                                                           G_PARAM_READABLE));
     
 #ifdef ENABLE_PROXY
     g_object_class_install_property (gobject_class,
@@ -576,8 +565,6 @@ nwamui_env_init (NwamuiEnv *self)
     NwamuiEnvPrivate *prv      = NWAMUI_ENV_GET_PRIVATE(self);
     self->prv = prv;
     
-    prv->svcs_model = gtk_list_store_new(SVC_N_COL, G_TYPE_OBJECT);
-
 #ifdef ENABLE_PROXY
     prv->proxy_type = NWAMUI_ENV_PROXY_TYPE_DIRECT;
     prv->proxy_http_port = 80;
@@ -586,12 +573,6 @@ nwamui_env_init (NwamuiEnv *self)
     prv->proxy_gopher_port = 80;
     prv->proxy_socks_port = 1080;
 #endif /* ENABLE_PROXY */
-
-    /*
-    g_signal_connect(G_OBJECT(prv->svcs_model), "row-deleted", (GCallback)svc_row_deleted_cb, (gpointer)self);
-    g_signal_connect(G_OBJECT(prv->svcs_model), "row-changed", (GCallback)svc_row_inserted_or_changed_cb, (gpointer)self);
-    g_signal_connect(G_OBJECT(prv->svcs_model), "row-inserted", (GCallback)svc_row_inserted_or_changed_cb, (gpointer)self);
-    */
 }
 
 static void
@@ -982,7 +963,7 @@ nwamui_env_get_property (GObject         *object,
 #endif /* ENABLE_NETSERVICES */
 
         case PROP_SVCS: {
-                g_value_set_object (value, self->prv->svcs_model);
+                g_value_set_pointer (value, nwamui_util_copy_obj_list (self->prv->svcs));
             }
             break;
 
@@ -3547,101 +3528,62 @@ nwamui_object_real_get_conditions(NwamuiObject *object)
 /* These are not needed right now since we don't support property templates,
  * but would like to keep around for when we do.
  */
-extern GtkTreeModel *
+extern GList*
 nwamui_env_get_svcs (NwamuiEnv *self)
 {
-    GtkTreeModel *model;
+    GList *svcs = NULL;
     
     g_object_get (G_OBJECT (self),
-      "svcs", &model,
+      "svcs", &svcs,
       NULL);
 
-    return model;
+    return svcs;
 }
 
-extern NwamuiSvc*
-nwamui_env_get_svc (NwamuiEnv *self, GtkTreeIter *iter)
+static gint
+find_svc_by_name (gconstpointer data, gconstpointer user_data)
 {
-    NwamuiSvc *svcobj = NULL;
-
-    g_return_val_if_fail (NWAMUI_IS_ENV (self), svcobj);
+    gchar *name = nwamui_svc_get_name (NWAMUI_SVC (data));
+    gint   ret  = g_ascii_strcasecmp (name, (const gchar *)user_data);
 
-    gtk_tree_model_get (GTK_TREE_MODEL (self->prv->svcs_model), iter, SVC_OBJECT, &svcobj, -1);
-
-    return svcobj;
+    g_free (name);
+    return ret;
 }
 
 extern NwamuiSvc*
 nwamui_env_find_svc (NwamuiEnv *self, const gchar *svc)
 {
-    NwamuiSvc *svcobj = NULL;
-    GtkTreeIter iter;
+    GList *found;
 
     g_return_val_if_fail (svc, NULL);
-    g_return_val_if_fail (NWAMUI_IS_ENV (self), svcobj);
+    g_return_val_if_fail (NWAMUI_IS_ENV (self), NULL);
 
-    if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL(self->prv->svcs_model), &iter)) {
-        do {
-            gchar *name;
-            
-            gtk_tree_model_get (GTK_TREE_MODEL(self->prv->svcs_model), &iter, SVC_OBJECT, &svcobj, -1);
-            name = nwamui_svc_get_name (svcobj);
-            
-            if (g_ascii_strcasecmp (name, svc) == 0) {
-                g_free (name);
-                return svcobj;
-            }
-            g_free (name);
-            g_object_unref (svcobj);
-        } while (gtk_tree_model_iter_next(GTK_TREE_MODEL(self->prv->svcs_model), &iter));
-    }
-    return NULL;
-}
+    found = g_list_find_custom (self->prv->svcs, svc, find_svc_by_name);
 
-extern void
-nwamui_env_svc_remove (NwamuiEnv *self, GtkTreeIter *iter)
-{
-    gtk_list_store_remove (GTK_LIST_STORE(self->prv->svcs_model), iter);
+    return found ? NWAMUI_SVC (g_object_ref (found->data)) : NULL;
 }
 
 extern void
-nwamui_env_svc_foreach (NwamuiEnv *self, GtkTreeModelForeachFunc func, gpointer data)
+nwamui_env_svc_remove (NwamuiEnv *self, NwamuiSvc *svc)
 {
-    gtk_tree_model_foreach (GTK_TREE_MODEL(self->prv->svcs_model), func, data);
-}
+    GList *found = g_list_find (self->prv->svcs, svc);
 
-extern gboolean
-nwamui_env_svc_insert (NwamuiEnv *self, NwamuiSvc *svc)
-{
-	GtkTreeIter iter;
-    NwamuiSvc *svcobj;
-    nwam_error_t nerr;
-
-    gtk_list_store_append (GTK_LIST_STORE(self->prv->svcs_model), &iter);
-    gtk_list_store_set (GTK_LIST_STORE(self->prv->svcs_model), &iter,
-      SVC_OBJECT, svcobj, -1);
-    
-    return TRUE;
+    if (found) {
+        self->prv->svcs = g_list_delete_link (self->prv->svcs, found);
+        g_object_notify (G_OBJECT (self), "svcs");
+        g_object_unref (svc);
+    }
 }
 
-extern gboolean
-nwamui_env_svc_delete (NwamuiEnv *self, NwamuiSvc *svc)
+extern void
+nwamui_env_svc_foreach (NwamuiEnv *self, GFunc func, gpointer data)
 {
-	GtkTreeIter iter;
-    NwamuiSvc *svcobj;
-    nwam_error_t nerr;
-
-    gtk_list_store_append (GTK_LIST_STORE(self->prv->svcs_model), &iter);
-    gtk_list_store_set (GTK_LIST_STORE(self->prv->svcs_model), &iter,
-      SVC_OBJECT, svcobj, -1);
-   
-    return TRUE;
+    g_list_foreach (self->prv->svcs, func, data);
 }
 
 extern NwamuiSvc*
 nwamui_env_svc_add (NwamuiEnv *self, nwam_loc_prop_template_t svc)
 {
-	GtkTreeIter iter;
     NwamuiSvc *svcobj = NULL;
     nwam_error_t err;
     const char* fmri = NULL;
@@ -3649,9 +3591,8 @@ nwamui_env_svc_add (NwamuiEnv *self, nwam_loc_prop_template_t svc)
     if ( ( err = nwam_loc_prop_template_get_fmri( svc, &fmri )) == NWAM_SUCCESS ) {
         if ( fmri != NULL && (svcobj = nwamui_env_find_svc (self, fmri)) == NULL) {
             svcobj = nwamui_svc_new (svc);
-            gtk_list_store_append (GTK_LIST_STORE(self->prv->svcs_model), &iter);
-            gtk_list_store_set (GTK_LIST_STORE(self->prv->svcs_model), &iter,
-              SVC_OBJECT, svcobj, -1);
+            self->prv->svcs = g_list_append (self->prv->svcs, g_object_ref (svcobj));
+            g_object_notify (G_OBJECT (self), "svcs");
         }
     }
     return svcobj;
@@ -3867,9 +3808,7 @@ nwamui_env_finalize (NwamuiEnv *self)
         g_free( self->prv->proxy_bypass_list );
     }
 
-    if (self->prv->svcs_model != NULL ) {
-        g_object_unref( self->prv->svcs_model );
-    }
+    nwamui_util_free_obj_list( self->prv->svcs );
 
     if (self->prv->proxy_username != NULL ) {
         g_free( self->prv->proxy_username );
@@ -3921,26 +3860,6 @@ nwamui_object_real_get_nwam_state(NwamuiObject *object, nwam_aux_state_t* aux_st
     return(rstate);
 }
 
-/* Callbacks */
-
-static void 
-svc_row_inserted_or_changed_cb (GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
-{
-    NwamuiNcu* self = NWAMUI_NCU(data);
-
-    /* Chain events in the tree to the NCU object*/
-    g_object_notify(G_OBJECT(self), "svcs_model");
-}
-
-static void 
-svc_row_deleted_cb (GtkTreeModel *tree_model, GtkTreePath *path, gpointer data)
-{
-    NwamuiNcu* self = NWAMUI_NCU(data);
-
-    /* Chain events in the tree to the NCU object*/
-    g_object_notify(G_OBJECT(self), "svcs_model");
-}
-
 #if 0
 /* These are not needed right now since we don't support property templates,
  * but would like to keep around for when we do.
@@ -3962,15 +3881,7 @@ nwam_loc_sys_svc_walker_cb (nwam_loc_handle_t env, nwam_loc_prop_template_t svc,
     NwamuiEnv* self = NWAMUI_ENV(data);
     NwamuiEnvPrivate* prv = NWAMUI_ENV(data)->prv;
 
-    /* TODO: status, is default? */
-	GtkTreeIter iter;
-    NwamuiSvc *svcobj;
-
-    svcobj = nwamui_svc_new (svc);
-    gtk_list_store_append (GTK_LIST_STORE(self->prv->sys_svcs_model), &iter);
-    gtk_list_store_set (GTK_LIST_STORE(self->prv->sys_svcs_model), &iter,
-      SVC_OBJECT, svcobj, -1);
-    g_object_unref (svcobj);
+    /* TODO: status, is default? System services aren't kept yet. */
 }
 #endif /* 0 */
 
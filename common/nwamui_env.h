@@ -240,7 +240,7 @@ extern gchar*               nwamui_env_get_proxy_password ( NwamuiEnv *self );
 #endif /* ENABLE_PROXY */
 
 #if 0
-extern GtkTreeModel *       nwamui_env_get_svcs (NwamuiEnv *self);
+extern GList*               nwamui_env_get_svcs (NwamuiEnv *self);
 
 extern NwamuiSvc*           nwamui_env_svc_add (NwamuiEnv *self, nwam_loc_prop_template_t svc);
 
@@ -248,9 +248,9 @@ extern void                 nwamui_env_svc_add_full (NwamuiEnv *self,
   nwam_loc_prop_template_t svc,
   gboolean is_default,
   gboolean status);
-extern void                 nwamui_env_svc_remove (NwamuiEnv *self, GtkTreeIter *iter);
+extern void                 nwamui_env_svc_remove (NwamuiEnv *self, NwamuiSvc *svc);
 
-extern void                 nwamui_env_svc_foreach (NwamuiEnv *self, GtkTreeModelForeachFunc func, gpointer data);
+extern void                 nwamui_env_svc_foreach (NwamuiEnv *self, GFunc func, gpointer data);
 #endif
 
 const gchar*                nwam_nameservices_enum_to_string(nwam_nameservices_t ns);
@@ -0,0 +1,912 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_event_source.c
+ *
+ */
+
+#include <libnwam.h>
+#include <libscf.h>
+#include <glib-object.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#ifdef __linux__
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif
+
+#include "libnwamui.h"
+#include "nwam-scf.h"
+
+/* Speed of nwamui_event_source_parse() replays, as recorded. */
+#define REPLAY_SPEED_DEFAULT    (1.0)
+
+#ifdef __linux__
+#define RTNETLINK_BUFSIZE       (32 * 1024)
+/* Room for bursts of thousands of messages between two waits. */
+#define RTNETLINK_RCVBUF        (1024 * 1024)
+#endif
+
+/*
+ * Events. They are freed with nwam_event_free(), so they are malloc()ed.
+ */
+static nwam_event_t
+event_new(int type)
+{
+    nwam_event_t    event = calloc(1, sizeof (struct nwam_event));
+
+    if (event != NULL) {
+        event->nwe_type = type;
+        event->nwe_size = sizeof (struct nwam_event);
+    }
+    return event;
+}
+
+static nwam_event_t
+event_copy(nwam_event_t event)
+{
+    nwam_event_t    copy = malloc(event->nwe_size);
+
+    if (copy != NULL) {
+        memcpy(copy, event, event->nwe_size);
+    }
+    return copy;
+}
+
+static nwam_event_t
+object_state_event_new(nwam_object_type_t type, const gchar *parent,
+  const gchar *name, nwam_state_t state, nwam_aux_state_t aux_state)
+{
+    nwam_event_t    event = event_new(NWAM_EVENT_TYPE_OBJECT_STATE);
+
+    if (event != NULL) {
+        event->nwe_data.nwe_object_state.nwe_object_type = type;
+        event->nwe_data.nwe_object_state.nwe_state = state;
+        event->nwe_data.nwe_object_state.nwe_aux_state = aux_state;
+        (void) g_strlcpy(event->nwe_data.nwe_object_state.nwe_name, name,
+          sizeof (event->nwe_data.nwe_object_state.nwe_name));
+        /* An empty parent is the active NCP. */
+        (void) g_strlcpy(event->nwe_data.nwe_object_state.nwe_parent, parent ? parent : "",
+          sizeof (event->nwe_data.nwe_object_state.nwe_parent));
+    }
+    return event;
+}
+
+static nwam_event_t
+link_state_event_new(const gchar *device, gboolean up)
+{
+    nwam_event_t    event = event_new(NWAM_EVENT_TYPE_LINK_STATE);
+
+    if (event != NULL) {
+        (void) g_strlcpy(event->nwe_data.nwe_link_state.nwe_name, device,
+          sizeof (event->nwe_data.nwe_link_state.nwe_name));
+        event->nwe_data.nwe_link_state.nwe_link_up = up ? B_TRUE : B_FALSE;
+    }
+    return event;
+}
+
+static void
+prefix_to_netmask(int family, guint prefix_len, struct sockaddr_storage *mask)
+{
+    guint8 *bytes;
+    guint   len;
+    guint   i;
+
+    memset(mask, 0, sizeof (*mask));
+    mask->ss_family = family;
+    if (family == AF_INET) {
+        bytes = (guint8 *)&((struct sockaddr_in *)mask)->sin_addr;
+        len = 4;
+    } else {
+        bytes = (guint8 *)&((struct sockaddr_in6 *)mask)->sin6_addr;
+        len = 16;
+    }
+    for (i = 0; i < len && prefix_len > 0; i++) {
+        guint bits = MIN(prefix_len, 8);
+
+        bytes[i] = (guint8)(0xff << (8 - bits));
+        prefix_len -= bits;
+    }
+}
+
+/* @address is a struct in_addr or in6_addr, as for inet_ntop(). */
+static nwam_event_t
+if_state_event_new(const gchar *device, int family, const void *address,
+  guint prefix_len, gboolean added)
+{
+    nwam_event_t                event = event_new(NWAM_EVENT_TYPE_IF_STATE);
+    struct sockaddr_storage    *addr;
+    uint32_t                    flags = IFF_UP | IFF_RUNNING;
+
+    if (event == NULL) {
+        return NULL;
+    }
+    addr = &event->nwe_data.nwe_if_state.nwe_addr;
+    addr->ss_family = family;
+    if (family == AF_INET) {
+        memcpy(&((struct sockaddr_in *)addr)->sin_addr, address, sizeof (struct in_addr));
+        prefix_to_netmask(AF_INET, MIN(prefix_len, 32), &event->nwe_data.nwe_if_state.nwe_netmask);
+#ifdef IFF_IPV4
+        flags |= IFF_IPV4;
+#endif
+    } else {
+        memcpy(&((struct sockaddr_in6 *)addr)->sin6_addr, address, sizeof (struct in6_addr));
+        prefix_to_netmask(AF_INET6, MIN(prefix_len, 128), &event->nwe_data.nwe_if_state.nwe_netmask);
+#ifdef IFF_IPV6
+        flags |= IFF_IPV6;
+#endif
+    }
+    (void) g_strlcpy(event->nwe_data.nwe_if_state.nwe_name, device,
+      sizeof (event->nwe_data.nwe_if_state.nwe_name));
+    event->nwe_data.nwe_if_state.nwe_flags = flags;
+    event->nwe_data.nwe_if_state.nwe_addr_valid = B_TRUE;
+    event->nwe_data.nwe_if_state.nwe_addr_added = added ? B_TRUE : B_FALSE;
+    return event;
+}
+
+/*
+ * libnwam source.
+ */
+static gboolean
+libnwam_is_nwam_enabled(void)
+{
+    gboolean            is_nwam_enabled = FALSE;
+    char                *smf_state;
+    char                activencp[NWAM_MAX_NAME_LEN];
+    scf_error_t         serr;    
+    
+    smf_state = smf_get_state(NWAMUI_FMRI);
+    
+    if (strcmp(smf_state, SCF_STATE_STRING_ONLINE) != 0) {
+        g_debug("%s: NWAM service appears to be off-line", __func__);
+    } else {
+        if (get_active_ncp(activencp, sizeof (activencp), &serr) != 0) {
+                g_debug("Failed to retrieve active NCP from SMF: %s", 
+                        scf_strerror(serr));
+        } else {
+            is_nwam_enabled = !NWAM_NCP_DEF_FIXED(activencp);
+        }
+    }
+
+    free(smf_state);
+    
+    return is_nwam_enabled;
+}
+
+static gboolean
+libnwam_open(gpointer data)
+{
+    nwam_error_t    nerr;
+
+    if (!libnwam_is_nwam_enabled()) {
+        g_debug("NWAM not enabled");
+        return FALSE;
+    }
+    if ((nerr = nwam_events_init()) != NWAM_SUCCESS) {
+        g_debug("%s: nwam_events_init() returned %d (%s)",
+          __func__, nerr, nwam_strerror(nerr));
+        return FALSE;
+    }
+    g_debug("%s: Connected to nwam daemon", __func__);
+    return TRUE;
+}
+
+static nwam_error_t
+libnwam_wait(gpointer data, nwam_event_t *event)
+{
+    return nwam_event_wait(event);
+}
+
+static void
+libnwam_close(gpointer data)
+{
+    g_debug("%s: Closing connection to nwam daemon", __func__);
+    (void) nwam_events_fini();
+}
+
+static void
+libnwam_free(gpointer data)
+{
+}
+
+const nwamui_event_source_t nwamui_event_source_libnwam = {
+    libnwam_open,
+    libnwam_wait,
+    libnwam_close,
+    libnwam_free
+};
+
+/*
+ * Replay source. The script has one event per line, in the syntax of the
+ * event scripts of the test fixtures:
+ *
+ *  [+<msec>] init | shutdown
+ *  [+<msec>] object-state <type> <name> <state> [<aux state>]
+ *  [+<msec>] link-state <device> up|down
+ *  [+<msec>] if-state <device> <address>/<prefix length>
+ *
+ * where <msec> is the delay after the previous event, and NCUs are given
+ * as "[<ncp>/]<typed name>", the active NCP if there's no <ncp>. Blank
+ * lines and lines starting with '#' are ignored. At the end of the script
+ * the source is idle until closed, like a quiet nwamd.
+ */
+typedef struct {
+    const gchar    *name;
+    gint            value;
+} replay_keyword_t;
+
+static const replay_keyword_t replay_object_types[] = {
+    { "ncp",            NWAM_OBJECT_TYPE_NCP },
+    { "ncu",            NWAM_OBJECT_TYPE_NCU },
+    { "loc",            NWAM_OBJECT_TYPE_LOC },
+    { "enm",            NWAM_OBJECT_TYPE_ENM },
+    { "wlan",           NWAM_OBJECT_TYPE_KNOWN_WLAN },
+    { NULL }
+};
+
+static const replay_keyword_t replay_states[] = {
+    { "uninitialized",  NWAM_STATE_UNINITIALIZED },
+    { "initialized",    NWAM_STATE_INITIALIZED },
+    { "offline",        NWAM_STATE_OFFLINE },
+    { "offline*",       NWAM_STATE_OFFLINE_TO_ONLINE },
+    { "online*",        NWAM_STATE_ONLINE_TO_OFFLINE },
+    { "online",         NWAM_STATE_ONLINE },
+    { "maintenance",    NWAM_STATE_MAINTENANCE },
+    { "degraded",       NWAM_STATE_DEGRADED },
+    { "disabled",       NWAM_STATE_DISABLED },
+    { NULL }
+};
+
+static const replay_keyword_t replay_aux_states[] = {
+    { "uninitialized",  NWAM_AUX_STATE_UNINITIALIZED },
+    { "conditions-not-met", NWAM_AUX_STATE_CONDITIONS_NOT_MET },
+    { "manual-disable", NWAM_AUX_STATE_MANUAL_DISABLE },
+    { "active",         NWAM_AUX_STATE_ACTIVE },
+    { "up",             NWAM_AUX_STATE_UP },
+    { "down",           NWAM_AUX_STATE_DOWN },
+    { "scanning",       NWAM_AUX_STATE_LINK_WIFI_SCANNING },
+    { "need-selection", NWAM_AUX_STATE_LINK_WIFI_NEED_SELECTION },
+    { "need-key",       NWAM_AUX_STATE_LINK_WIFI_NEED_KEY },
+    { "connecting",     NWAM_AUX_STATE_LINK_WIFI_CONNECTING },
+    { "waiting-for-addr", NWAM_AUX_STATE_IF_WAITING_FOR_ADDR },
+    { "dhcp-timed-out", NWAM_AUX_STATE_IF_DHCP_TIMED_OUT },
+    { "duplicate-addr", NWAM_AUX_STATE_IF_DUPLICATE_ADDR },
+    { NULL }
+};
+
+typedef struct {
+    guint           delay_msec;
+    nwam_event_t    event;
+} replay_event_t;
+
+typedef struct {
+    GArray         *events;
+    gdouble         speed;
+    GMutex         *mutex;
+    GCond          *cond;
+    /* Protected by mutex */
+    gboolean        opened;
+    guint           next;
+} replay_source_t;
+
+static gboolean
+replay_lookup(const replay_keyword_t *keywords, const gchar *name, gint *value)
+{
+    for (; keywords->name != NULL; keywords++) {
+        if (g_ascii_strcasecmp(keywords->name, name) == 0) {
+            *value = keywords->value;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static nwam_event_t
+replay_parse_object_state(gint argc, gchar **argv)
+{
+    gint            type;
+    gint            state;
+    gint            aux = NWAM_AUX_STATE_UNINITIALIZED;
+    const gchar    *slash;
+    gchar          *parent = NULL;
+    const gchar    *name = argv[2];
+    nwam_event_t    event;
+
+    if (!replay_lookup(replay_object_types, argv[1], &type) ||
+      !replay_lookup(replay_states, argv[3], &state) ||
+      (argc == 5 && !replay_lookup(replay_aux_states, argv[4], &aux))) {
+        return NULL;
+    }
+    if (type == NWAM_OBJECT_TYPE_NCU && (slash = strchr(name, '/')) != NULL) {
+        parent = g_strndup(name, slash - name);
+        name = slash + 1;
+    }
+    event = object_state_event_new(type, parent, name, state, aux);
+    g_free(parent);
+    return event;
+}
+
+static nwam_event_t
+replay_parse_if_state(const gchar *device, const gchar *arg)
+{
+    gchar         **addr = g_strsplit(arg, "/", 2);
+    struct in6_addr in6;
+    struct in_addr  in;
+    nwam_event_t    event = NULL;
+
+    if (addr[1] != NULL) {
+        guint   prefix_len = (guint)strtoul(addr[1], NULL, 10);
+
+        if (inet_pton(AF_INET, addr[0], &in) == 1) {
+            event = if_state_event_new(device, AF_INET, &in, prefix_len, TRUE);
+        } else if (inet_pton(AF_INET6, addr[0], &in6) == 1) {
+            event = if_state_event_new(device, AF_INET6, &in6, prefix_len, TRUE);
+        }
+    }
+    g_strfreev(addr);
+    return event;
+}
+
+static nwam_event_t
+replay_parse_line(const gchar *line, guint *delay_msec)
+{
+    gchar         **argv = NULL;
+    gchar         **args;
+    gint            argc = 0;
+    nwam_event_t    event = NULL;
+
+    *delay_msec = 0;
+    if (!g_shell_parse_argv(line, &argc, &argv, NULL)) {
+        return NULL;
+    }
+    args = argv;
+    if (args[0][0] == '+') {
+        *delay_msec = (guint)strtoul(args[0] + 1, NULL, 10);
+        args++;
+        argc--;
+    }
+
+    if (argc == 1 && strcmp(args[0], "init") == 0) {
+        event = event_new(NWAM_EVENT_TYPE_INIT);
+    } else if (argc == 1 && strcmp(args[0], "shutdown") == 0) {
+        event = event_new(NWAM_EVENT_TYPE_SHUTDOWN);
+    } else if ((argc == 4 || argc == 5) && strcmp(args[0], "object-state") == 0) {
+        event = replay_parse_object_state(argc, args);
+    } else if (argc == 3 && strcmp(args[0], "link-state") == 0) {
+        if (strcmp(args[2], "up") == 0 || strcmp(args[2], "down") == 0) {
+            event = link_state_event_new(args[1], strcmp(args[2], "up") == 0);
+        }
+    } else if (argc == 3 && strcmp(args[0], "if-state") == 0) {
+        event = replay_parse_if_state(args[1], args[2]);
+    }
+
+    g_strfreev(argv);
+    return event;
+}
+
+static void
+replay_free(gpointer data)
+{
+    replay_source_t    *src = (replay_source_t *)data;
+    guint               i;
+
+    for (i = 0; i < src->events->len; i++) {
+        nwam_event_free(g_array_index(src->events, replay_event_t, i).event);
+    }
+    g_array_free(src->events, TRUE);
+    g_cond_free(src->cond);
+    g_mutex_free(src->mutex);
+    g_free(src);
+}
+
+/**
+ * nwamui_event_source_replay_new:
+ * @path: the script.
+ * @speed: 1.0 to keep the delays of the script, 2.0 to halve them, and 0
+ * to replay as fast as the daemon takes the events.
+ *
+ * Returns: the data of a nwamui_event_source_replay, or NULL if @path
+ * can't be read or parsed.
+ **/
+extern gpointer
+nwamui_event_source_replay_new(const gchar *path, gdouble speed)
+{
+    replay_source_t    *src;
+    gchar              *contents = NULL;
+    gchar             **lines;
+    gchar             **line;
+    GError             *error = NULL;
+    replay_event_t      rev;
+    guint               lineno = 0;
+
+    if (!g_file_get_contents(path, &contents, NULL, &error)) {
+        g_warning("Unable to read the event script: %s", error->message);
+        g_error_free(error);
+        return NULL;
+    }
+
+    src = g_new0(replay_source_t, 1);
+    src->events = g_array_new(FALSE, FALSE, sizeof (replay_event_t));
+    src->speed = MAX(speed, 0.0);
+    src->mutex = g_mutex_new();
+    src->cond = g_cond_new();
+
+    lines = g_strsplit(contents, "\n", -1);
+    g_free(contents);
+
+    for (line = lines; *line != NULL; line++) {
+        const gchar    *text = *line + strspn(*line, " \t");
+
+        lineno++;
+        if (*text == '\0' || *text == '#') {
+            continue;
+        }
+        if ((rev.event = replay_parse_line(text, &rev.delay_msec)) == NULL) {
+            g_warning("%s:%u: can't parse '%s'", path, lineno, text);
+            g_strfreev(lines);
+            replay_free(src);
+            return NULL;
+        }
+        g_array_append_val(src->events, rev);
+    }
+    g_strfreev(lines);
+
+    return src;
+}
+
+/* The number of events of a replay. */
+extern guint
+nwamui_event_source_replay_get_length(gpointer data)
+{
+    return ((replay_source_t *)data)->events->len;
+}
+
+/* Every connection replays the script from its start. */
+static gboolean
+replay_open(gpointer data)
+{
+    replay_source_t    *src = (replay_source_t *)data;
+
+    g_mutex_lock(src->mutex);
+    src->opened = TRUE;
+    src->next = 0;
+    g_mutex_unlock(src->mutex);
+    return TRUE;
+}
+
+static nwam_error_t
+replay_wait(gpointer data, nwam_event_t *event)
+{
+    replay_source_t    *src = (replay_source_t *)data;
+    replay_event_t     *rev;
+    GTimeVal            deadline;
+    nwam_error_t        rval = NWAM_ERROR_BIND;
+
+    g_mutex_lock(src->mutex);
+    while (src->opened && src->next >= src->events->len) {
+        g_cond_wait(src->cond, src->mutex);
+    }
+    if (src->opened) {
+        rev = &g_array_index(src->events, replay_event_t, src->next);
+        if (rev->delay_msec > 0 && src->speed > 0) {
+            g_get_current_time(&deadline);
+            g_time_val_add(&deadline, (glong)(rev->delay_msec * 1000 / src->speed));
+            while (src->opened && g_cond_timed_wait(src->cond, src->mutex, &deadline))
+                ;
+        }
+        if (src->opened) {
+            if ((*event = event_copy(rev->event)) != NULL) {
+                src->next++;
+                rval = NWAM_SUCCESS;
+            } else {
+                rval = NWAM_NO_MEMORY;
+            }
+        }
+    }
+    g_mutex_unlock(src->mutex);
+
+    return rval;
+}
+
+static void
+replay_close(gpointer data)
+{
+    replay_source_t    *src = (replay_source_t *)data;
+
+    g_mutex_lock(src->mutex);
+    src->opened = FALSE;
+    g_cond_broadcast(src->cond);
+    g_mutex_unlock(src->mutex);
+}
+
+const nwamui_event_source_t nwamui_event_source_replay = {
+    replay_open,
+    replay_wait,
+    replay_close,
+    replay_free
+};
+
+#ifdef __linux__
+/*
+ * rtnetlink source, the kernel reports the changes of the links, the
+ * addresses and the routes of the host, which are turned into what nwamd
+ * would send for them:
+ *
+ *  link up or down     LINK_STATE, and OBJECT_STATE of the link NCU
+ *  address added/gone  IF_STATE
+ *  default route       OBJECT_STATE of the interface NCU
+ *
+ * The NCUs are those of the active NCP. Only the event thread uses the
+ * socket, close only writes to a pipe the wait polls too, and the socket
+ * is replaced on the next open.
+ */
+typedef struct {
+    int             fd;
+    int             wake[2];
+    GQueue         *pending;
+    /* ifindex to the last reported up state */
+    GHashTable     *links;
+    gchar          *buf;
+} rtnetlink_source_t;
+
+static void
+rtnetlink_queue_ncu_state(rtnetlink_source_t *src, const gchar *device,
+  nwam_ncu_type_t ncu_type, nwam_state_t state, nwam_aux_state_t aux_state)
+{
+    char           *typed = NULL;
+    nwam_event_t    event;
+
+    if (nwam_ncu_name_to_typed_name(device, ncu_type, &typed) != NWAM_SUCCESS) {
+        return;
+    }
+    if ((event = object_state_event_new(NWAM_OBJECT_TYPE_NCU, NULL, typed,
+      state, aux_state)) != NULL) {
+        g_queue_push_tail(src->pending, event);
+    }
+    free(typed);
+}
+
+static void
+rtnetlink_link(rtnetlink_source_t *src, struct nlmsghdr *nlh)
+{
+    struct ifinfomsg   *ifi = NLMSG_DATA(nlh);
+    struct rtattr      *rta;
+    int                 len = IFLA_PAYLOAD(nlh);
+    const gchar        *name = NULL;
+    gpointer            key = GINT_TO_POINTER(ifi->ifi_index);
+    gpointer            last;
+    gboolean            known;
+    gboolean            up;
+    nwam_event_t        event;
+
+    for (rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == IFLA_IFNAME) {
+            name = (const gchar *)RTA_DATA(rta);
+        }
+    }
+    if (name == NULL || (ifi->ifi_flags & IFF_LOOPBACK)) {
+        return;
+    }
+
+    up = (nlh->nlmsg_type == RTM_NEWLINK &&
+      (ifi->ifi_flags & (IFF_UP | IFF_RUNNING)) == (IFF_UP | IFF_RUNNING));
+
+    /* Most of the NEWLINK only carry statistics, report the changes of up. */
+    known = g_hash_table_lookup_extended(src->links, key, NULL, &last);
+    if (nlh->nlmsg_type == RTM_DELLINK) {
+        g_hash_table_remove(src->links, key);
+    } else if (known && GPOINTER_TO_INT(last) == up) {
+        return;
+    } else {
+        g_hash_table_insert(src->links, key, GINT_TO_POINTER(up));
+    }
+
+    if ((event = link_state_event_new(name, up)) != NULL) {
+        g_queue_push_tail(src->pending, event);
+    }
+    rtnetlink_queue_ncu_state(src, name, NWAM_NCU_TYPE_LINK,
+      up ? NWAM_STATE_ONLINE : NWAM_STATE_OFFLINE_TO_ONLINE,
+      up ? NWAM_AUX_STATE_UP : NWAM_AUX_STATE_DOWN);
+}
+
+static void
+rtnetlink_addr(rtnetlink_source_t *src, struct nlmsghdr *nlh)
+{
+    struct ifaddrmsg   *ifa = NLMSG_DATA(nlh);
+    struct rtattr      *rta;
+    int                 len = IFA_PAYLOAD(nlh);
+    const void         *local = NULL;
+    const void         *address = NULL;
+    char                name[IF_NAMESIZE];
+    nwam_event_t        event;
+
+    /* IFA_ADDRESS is the peer of a point-to-point link, IFA_LOCAL ours. */
+    for (rta = IFA_RTA(ifa); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == IFA_LOCAL) {
+            local = RTA_DATA(rta);
+        } else if (rta->rta_type == IFA_ADDRESS) {
+            address = RTA_DATA(rta);
+        }
+    }
+    if (local != NULL) {
+        address = local;
+    }
+    if (address == NULL || ifa->ifa_scope == RT_SCOPE_HOST ||
+      (ifa->ifa_family != AF_INET && ifa->ifa_family != AF_INET6) ||
+      if_indextoname(ifa->ifa_index, name) == NULL) {
+        return;
+    }
+
+    if ((event = if_state_event_new(name, ifa->ifa_family, address,
+      ifa->ifa_prefixlen, nlh->nlmsg_type == RTM_NEWADDR)) != NULL) {
+        g_queue_push_tail(src->pending, event);
+    }
+}
+
+static void
+rtnetlink_route(rtnetlink_source_t *src, struct nlmsghdr *nlh)
+{
+    struct rtmsg       *rtm = NLMSG_DATA(nlh);
+    struct rtattr      *rta;
+    int                 len = RTM_PAYLOAD(nlh);
+    int                 oif = 0;
+    char                name[IF_NAMESIZE];
+    gboolean            added = (nlh->nlmsg_type == RTM_NEWROUTE);
+
+    /* Only a default route of the main table makes an interface usable. */
+    if (rtm->rtm_table != RT_TABLE_MAIN || rtm->rtm_dst_len != 0 ||
+      rtm->rtm_type != RTN_UNICAST) {
+        return;
+    }
+    for (rta = RTM_RTA(rtm); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == RTA_OIF) {
+            oif = *(int *)RTA_DATA(rta);
+        }
+    }
+    if (oif == 0 || if_indextoname(oif, name) == NULL) {
+        return;
+    }
+
+    rtnetlink_queue_ncu_state(src, name, NWAM_NCU_TYPE_INTERFACE,
+      added ? NWAM_STATE_ONLINE : NWAM_STATE_OFFLINE_TO_ONLINE,
+      added ? NWAM_AUX_STATE_UP : NWAM_AUX_STATE_IF_WAITING_FOR_ADDR);
+}
+
+static void
+rtnetlink_clear_pending(rtnetlink_source_t *src)
+{
+    nwam_event_t    event;
+
+    while ((event = g_queue_pop_head(src->pending)) != NULL) {
+        nwam_event_free(event);
+    }
+}
+
+static void
+rtnetlink_drain_wake(rtnetlink_source_t *src)
+{
+    char    c[16];
+
+    while (read(src->wake[0], c, sizeof (c)) > 0)
+        ;
+}
+
+/**
+ * nwamui_event_source_rtnetlink_new:
+ *
+ * Returns: the data of a nwamui_event_source_rtnetlink, or NULL.
+ **/
+extern gpointer
+nwamui_event_source_rtnetlink_new(void)
+{
+    rtnetlink_source_t *src = g_new0(rtnetlink_source_t, 1);
+
+    if (pipe(src->wake) != 0) {
+        g_warning("%s: pipe: %s", __func__, g_strerror(errno));
+        g_free(src);
+        return NULL;
+    }
+    (void) fcntl(src->wake[0], F_SETFL, O_NONBLOCK);
+    (void) fcntl(src->wake[0], F_SETFD, FD_CLOEXEC);
+    (void) fcntl(src->wake[1], F_SETFD, FD_CLOEXEC);
+
+    src->fd = -1;
+    src->pending = g_queue_new();
+    src->links = g_hash_table_new(g_direct_hash, g_direct_equal);
+    src->buf = g_malloc(RTNETLINK_BUFSIZE);
+
+    return src;
+}
+
+static gboolean
+rtnetlink_open(gpointer data)
+{
+    rtnetlink_source_t *src = (rtnetlink_source_t *)data;
+    struct sockaddr_nl  addr;
+    int                 rcvbuf = RTNETLINK_RCVBUF;
+
+    if (src->fd >= 0) {
+        (void) close(src->fd);
+    }
+    rtnetlink_drain_wake(src);
+    rtnetlink_clear_pending(src);
+    g_hash_table_remove_all(src->links);
+
+    if ((src->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE)) < 0) {
+        g_debug("%s: socket: %s", __func__, g_strerror(errno));
+        return FALSE;
+    }
+    (void) fcntl(src->fd, F_SETFD, FD_CLOEXEC);
+    (void) setsockopt(src->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof (rcvbuf));
+
+    memset(&addr, 0, sizeof (addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR |
+      RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+    if (bind(src->fd, (struct sockaddr *)&addr, sizeof (addr)) != 0) {
+        g_debug("%s: bind: %s", __func__, g_strerror(errno));
+        (void) close(src->fd);
+        src->fd = -1;
+        return FALSE;
+    }
+    g_debug("%s: Listening to rtnetlink", __func__);
+    return TRUE;
+}
+
+static nwam_error_t
+rtnetlink_wait(gpointer data, nwam_event_t *event)
+{
+    rtnetlink_source_t *src = (rtnetlink_source_t *)data;
+    struct pollfd       fds[2];
+    struct nlmsghdr    *nlh;
+    int                 len;
+
+    while (g_queue_is_empty(src->pending)) {
+        fds[0].fd = src->fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = src->wake[0];
+        fds[1].events = POLLIN;
+        fds[0].revents = fds[1].revents = 0;
+
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return NWAM_ERROR_INTERNAL;
+        }
+        if (fds[1].revents != 0) {
+            return NWAM_ERROR_BIND;
+        }
+        if ((len = recv(src->fd, src->buf, RTNETLINK_BUFSIZE, 0)) < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            /* ENOBUFS, messages were lost, reconnecting makes the daemon
+             * reload everything. */
+            g_debug("%s: recv: %s", __func__, g_strerror(errno));
+            return NWAM_ERROR_INTERNAL;
+        }
+
+        for (nlh = (struct nlmsghdr *)src->buf; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            switch (nlh->nlmsg_type) {
+            case RTM_NEWLINK:
+            case RTM_DELLINK:
+                rtnetlink_link(src, nlh);
+                break;
+            case RTM_NEWADDR:
+            case RTM_DELADDR:
+                rtnetlink_addr(src, nlh);
+                break;
+            case RTM_NEWROUTE:
+            case RTM_DELROUTE:
+                rtnetlink_route(src, nlh);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    *event = g_queue_pop_head(src->pending);
+    return NWAM_SUCCESS;
+}
+
+static void
+rtnetlink_close(gpointer data)
+{
+    rtnetlink_source_t *src = (rtnetlink_source_t *)data;
+
+    (void) write(src->wake[1], "x", 1);
+}
+
+static void
+rtnetlink_free(gpointer data)
+{
+    rtnetlink_source_t *src = (rtnetlink_source_t *)data;
+
+    if (src->fd >= 0) {
+        (void) close(src->fd);
+    }
+    (void) close(src->wake[0]);
+    (void) close(src->wake[1]);
+    rtnetlink_clear_pending(src);
+    g_queue_free(src->pending);
+    g_hash_table_destroy(src->links);
+    g_free(src->buf);
+    g_free(src);
+}
+
+const nwamui_event_source_t nwamui_event_source_rtnetlink = {
+    rtnetlink_open,
+    rtnetlink_wait,
+    rtnetlink_close,
+    rtnetlink_free
+};
+#endif /* __linux__ */
+
+/**
+ * nwamui_event_source_parse:
+ * @spec: "libnwam", "replay:FILE" or, on Linux, "rtnetlink".
+ * @source: returns the source.
+ * @data: returns its data, for nwamui_daemon_set_event_source().
+ *
+ * Returns: FALSE, with a warning, if @spec is unknown or the source can't
+ * be created.
+ **/
+extern gboolean
+nwamui_event_source_parse(const gchar *spec, const nwamui_event_source_t **source,
+  gpointer *data)
+{
+    *data = NULL;
+
+    if (strcmp(spec, "libnwam") == 0) {
+        *source = &nwamui_event_source_libnwam;
+        return TRUE;
+    }
+    if (g_str_has_prefix(spec, "replay:")) {
+        *source = &nwamui_event_source_replay;
+        *data = nwamui_event_source_replay_new(spec + strlen("replay:"), REPLAY_SPEED_DEFAULT);
+        return *data != NULL;
+    }
+#ifdef __linux__
+    if (strcmp(spec, "rtnetlink") == 0) {
+        *source = &nwamui_event_source_rtnetlink;
+        *data = nwamui_event_source_rtnetlink_new();
+        return *data != NULL;
+    }
+#endif
+    g_warning("Unknown event source '%s'", spec);
+    return FALSE;
+}
@@ -0,0 +1,83 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_event_source.h
+ *
+ */
+
+#ifndef _NWAMUI_EVENT_SOURCE_H
+#define	_NWAMUI_EVENT_SOURCE_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Where the event thread of NwamuiDaemon takes the nwamd events from. The
+ * thread owns the reconnect backoff and the ACTIVE/INACTIVE reports, so a
+ * source only opens, waits and closes, all from the event thread except
+ * close, which may also be called from the main thread to unblock wait.
+ *
+ * Events are freed with nwam_event_free(), sources other than libnwam
+ * allocate them with malloc().
+ *
+ * The default source is libnwam. The replay source reads a script of
+ * events from a file, the rtnetlink source, on Linux only, turns the link,
+ * address and route changes of the kernel into nwamd events.
+ */
+
+typedef struct {
+    /* Connect, FALSE to be retried after a backoff. */
+    gboolean        (*open)(gpointer data);
+    /* Block for the next event, an error drops the connection. */
+    nwam_error_t    (*wait)(gpointer data, nwam_event_t *event);
+    /* Disconnect, makes a blocked wait return an error. */
+    void            (*close)(gpointer data);
+    void            (*free)(gpointer data);
+} nwamui_event_source_t;
+
+extern const nwamui_event_source_t nwamui_event_source_libnwam;
+extern const nwamui_event_source_t nwamui_event_source_replay;
+#ifdef __linux__
+extern const nwamui_event_source_t nwamui_event_source_rtnetlink;
+#endif
+
+extern gpointer     nwamui_event_source_replay_new(const gchar *path, gdouble speed);
+extern guint        nwamui_event_source_replay_get_length(gpointer data);
+#ifdef __linux__
+extern gpointer     nwamui_event_source_rtnetlink_new(void);
+#endif
+
+extern gboolean     nwamui_event_source_parse(const gchar *spec,
+                                              const nwamui_event_source_t **source,
+                                              gpointer *data);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_EVENT_SOURCE_H */
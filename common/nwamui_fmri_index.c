@@ -0,0 +1,442 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_fmri_index.c
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <libscf.h>
+
+#include "libnwamui.h"
+
+typedef struct {
+    gchar      *text;       /* All the FMRIs, sorted and NUL separated */
+    guint      *starts;     /* Offset of each FMRI in text */
+    guint       n;
+    guint      *sa;         /* Offsets of all the suffixes, sorted */
+    guint       n_sa;
+} fmri_index_t;
+
+typedef struct {
+    GSourceFunc     func;
+    gpointer        data;
+    GDestroyNotify  notify;
+} fmri_index_waiter_t;
+
+static void foreach_service(GFunc callback, gpointer callback_data, gpointer user_data);
+
+static nwamui_fmri_index_enum_func_t    enum_func = foreach_service;
+static gpointer                         enum_data = NULL;
+
+/* Mutex protected variables */
+static GStaticMutex     index_mutex = G_STATIC_MUTEX_INIT;
+static fmri_index_t    *fmri_index = NULL;
+static gboolean         building = FALSE;
+static GList           *waiters = NULL;
+/* End of mutex protected variables */
+
+/*
+ * The default backend, all the instances of the local scope.
+ */
+static void
+foreach_service(GFunc callback, gpointer callback_data, gpointer user_data)
+{
+    scf_handle_t   *handle = scf_handle_create( SCF_VERSION );
+	ssize_t         max_scf_name_length = scf_limit(SCF_LIMIT_MAX_NAME_LENGTH);
+	ssize_t         max_scf_fmri_length = scf_limit(SCF_LIMIT_MAX_FMRI_LENGTH);
+    scf_scope_t    *scope = scf_scope_create( handle );
+    scf_service_t  *service = scf_service_create( handle );
+    scf_instance_t *instance = scf_instance_create( handle );
+    scf_iter_t     *svc_iter = scf_iter_create(handle);
+    scf_iter_t     *inst_iter = scf_iter_create(handle);
+    char           *name = malloc( max_scf_name_length + 1 );
+    char           *sname = malloc( max_scf_name_length + 1 );
+    char           *fmri = malloc( max_scf_fmri_length + 1 );
+
+    if ( !handle  || !scope  || !service  || !instance || !svc_iter || !inst_iter ||
+      !name || !sname || !fmri ) {
+        g_warning("Couldn't allocation SMF handles" );
+        goto L_exit;
+    }
+
+    if (scf_handle_bind(handle) == -1 ) {
+        g_warning("Couldn't bind to smf service: %s\n", scf_strerror(scf_error()) );
+        goto L_exit;
+    }
+
+    if ( scf_handle_get_scope( handle, SCF_SCOPE_LOCAL, scope ) == 0 ) {
+        if ( scf_iter_scope_services( svc_iter, scope ) == 0 ) {
+            for ( int r = scf_iter_next_service( svc_iter, service );
+                  r == 1;
+                  r = scf_iter_next_service( svc_iter, service ) ) {
+                if( scf_service_get_name( service, sname, max_scf_name_length + 1) != -1 ) {
+                    if ( scf_iter_service_instances( inst_iter, service ) == 0 ) {
+                        for ( int rv = scf_iter_next_instance( inst_iter, instance );
+                              rv == 1;
+                              rv = scf_iter_next_instance( inst_iter, instance ) ) {
+                            if ( scf_instance_get_name( instance, name, max_scf_name_length + 1) != -1 ) {
+                                snprintf( fmri, max_scf_fmri_length, "svc:/%s:%s", sname, name );
+                                (*callback)( (gpointer)fmri, callback_data );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+L_exit:
+    scf_iter_destroy(inst_iter);
+    scf_iter_destroy(svc_iter);
+    scf_instance_destroy(instance);
+    scf_service_destroy(service);
+    scf_scope_destroy(scope);
+    if (handle) {
+        (void) scf_handle_unbind(handle);
+        scf_handle_destroy(handle);
+    }
+    free(name);
+    free(sname);
+    free(fmri);
+}
+
+static void
+collect_fmri(gpointer data, gpointer user_data)
+{
+    GHashTable *set = (GHashTable *)user_data;
+
+    if (data && *(gchar *)data != '\0' && !g_hash_table_lookup(set, data)) {
+        gchar *fmri = g_strdup((gchar *)data);
+        g_hash_table_insert(set, fmri, fmri);
+    }
+}
+
+static gint
+compare_fmri(gconstpointer a, gconstpointer b)
+{
+    return strcmp(*(const gchar **)a, *(const gchar **)b);
+}
+
+static gint
+compare_suffix(gconstpointer a, gconstpointer b, gpointer text)
+{
+    return strcmp((const gchar *)text + *(const guint *)a,
+      (const gchar *)text + *(const guint *)b);
+}
+
+static fmri_index_t*
+fmri_index_new(GHashTable *set)
+{
+    fmri_index_t   *idx = g_new0(fmri_index_t, 1);
+    GPtrArray      *fmris = g_ptr_array_sized_new(g_hash_table_size(set));
+    GHashTableIter  iter;
+    gpointer        key;
+    gsize           len = 0;
+    gchar          *p;
+
+    g_hash_table_iter_init(&iter, set);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        g_ptr_array_add(fmris, key);
+        len += strlen((gchar *)key) + 1;
+    }
+    g_ptr_array_sort(fmris, compare_fmri);
+
+    idx->n = fmris->len;
+    idx->text = p = g_malloc(len + 1);
+    idx->starts = g_new(guint, idx->n);
+    for (guint i = 0; i < idx->n; i++) {
+        gsize l = strlen(fmris->pdata[i]) + 1;
+
+        idx->starts[i] = p - idx->text;
+        memcpy(p, fmris->pdata[i], l);
+        p += l;
+    }
+    *p = '\0';
+    g_ptr_array_free(fmris, TRUE);
+
+    /* One suffix per character, each ends at the NUL of its FMRI. */
+    idx->n_sa = len - idx->n;
+    idx->sa = g_new(guint, idx->n_sa);
+    for (guint off = 0, j = 0; off < len; off++) {
+        if (idx->text[off] != '\0') {
+            idx->sa[j++] = off;
+        }
+    }
+    g_qsort_with_data(idx->sa, idx->n_sa, sizeof (guint), compare_suffix, idx->text);
+
+    return idx;
+}
+
+/* Index of the FMRI holding the character at off. */
+static guint
+fmri_index_owner(fmri_index_t *idx, guint off)
+{
+    guint lo = 0;
+    guint hi = idx->n;
+
+    while (hi - lo > 1) {
+        guint mid = (lo + hi) / 2;
+
+        if (idx->starts[mid] <= off) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static gboolean
+fmri_index_ready_idle(gpointer data)
+{
+    GList *l;
+
+    g_static_mutex_lock(&index_mutex);
+    l = waiters;
+    waiters = NULL;
+    g_static_mutex_unlock(&index_mutex);
+
+    for (GList *i = l; i; i = i->next) {
+        fmri_index_waiter_t *w = i->data;
+
+        w->func(w->data);
+        if (w->notify) {
+            w->notify(w->data);
+        }
+        g_free(w);
+    }
+    g_list_free(l);
+
+    return FALSE;
+}
+
+static gpointer
+fmri_index_build_thread(gpointer data)
+{
+    GHashTable     *set = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    fmri_index_t   *idx;
+
+    enum_func(collect_fmri, set, enum_data);
+    idx = fmri_index_new(set);
+    g_hash_table_destroy(set);
+
+    g_debug("SMF FMRI index: %u FMRIs, %u suffixes", idx->n, idx->n_sa);
+
+    g_static_mutex_lock(&index_mutex);
+    fmri_index = idx;
+    building = FALSE;
+    g_static_mutex_unlock(&index_mutex);
+
+    g_idle_add(fmri_index_ready_idle, NULL);
+
+    return NULL;
+}
+
+/**
+ * nwamui_fmri_index_set_backend:
+ * @func: the enumeration function, NULL for libscf.
+ * @user_data: passed to @func.
+ *
+ * Has no effect once the index has been built.
+ **/
+extern void
+nwamui_fmri_index_set_backend(nwamui_fmri_index_enum_func_t func, gpointer user_data)
+{
+    enum_func = func ? func : foreach_service;
+    enum_data = user_data;
+}
+
+/**
+ * nwamui_fmri_index_build_async:
+ * @ready_func: called from the main loop once the index is ready.
+ * @data: passed to @ready_func.
+ * @notify: called on @data after @ready_func, or NULL.
+ *
+ * Start building the index unless it is built or being built already.
+ **/
+extern void
+nwamui_fmri_index_build_async(GSourceFunc ready_func, gpointer data, GDestroyNotify notify)
+{
+    GError *error = NULL;
+
+    g_static_mutex_lock(&index_mutex);
+    if (ready_func) {
+        fmri_index_waiter_t *w = g_new(fmri_index_waiter_t, 1);
+
+        w->func = ready_func;
+        w->data = data;
+        w->notify = notify;
+        waiters = g_list_append(waiters, w);
+    }
+
+    if (fmri_index != NULL) {
+        g_idle_add(fmri_index_ready_idle, NULL);
+    } else if (!building) {
+        building = TRUE;
+        if (g_thread_create(fmri_index_build_thread, NULL, FALSE, &error) == NULL) {
+            g_warning("Error creating SMF FMRI index thread: %s",
+              (error && error->message) ? error->message : "");
+            g_clear_error(&error);
+            building = FALSE;
+        }
+    }
+    g_static_mutex_unlock(&index_mutex);
+}
+
+extern gboolean
+nwamui_fmri_index_is_ready(void)
+{
+    gboolean ready;
+
+    g_static_mutex_lock(&index_mutex);
+    ready = (fmri_index != NULL);
+    g_static_mutex_unlock(&index_mutex);
+
+    return ready;
+}
+
+extern guint
+nwamui_fmri_index_get_size(void)
+{
+    return nwamui_fmri_index_is_ready() ? fmri_index->n : 0;
+}
+
+/**
+ * nwamui_fmri_index_lookup:
+ * @key: the string to look for.
+ * @prefix_only: only match the FMRIs starting with @key.
+ * @max: stop after this many matches, 0 for no limit.
+ * @callback: called with each matching FMRI, in sorted order.
+ * @user_data: passed to @callback.
+ *
+ * Substring matches take the suffixes starting with @key unless there are
+ * more of them than FMRIs, as for a key of a letter or two. With a @max,
+ * the FMRIs are then scanned in order instead, until @max of them match.
+ *
+ * @returns: the number of matches passed to @callback, 0 while the index
+ * isn't ready.
+ **/
+extern guint
+nwamui_fmri_index_lookup(const gchar *key,
+  gboolean prefix_only,
+  guint max,
+  GFunc callback,
+  gpointer user_data)
+{
+    fmri_index_t   *idx;
+    gsize           klen;
+    guint           lo;
+    guint           hi;
+    guint           found = 0;
+
+    g_return_val_if_fail(key != NULL && callback != NULL, 0);
+
+    if (!nwamui_fmri_index_is_ready()) {
+        return 0;
+    }
+    idx = fmri_index;
+    klen = strlen(key);
+
+    if (prefix_only) {
+        /* The FMRIs are sorted, so the matches are a range. */
+        for (lo = 0, hi = idx->n; lo < hi; ) {
+            guint mid = (lo + hi) / 2;
+
+            if (strncmp(idx->text + idx->starts[mid], key, klen) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        for (; lo < idx->n && (max == 0 || found < max); lo++) {
+            const gchar *fmri = idx->text + idx->starts[lo];
+
+            if (strncmp(fmri, key, klen) != 0) {
+                break;
+            }
+            callback((gpointer)fmri, user_data);
+            found++;
+        }
+    } else {
+        guint   end;
+
+        /* The suffixes starting with key are a range too. */
+        for (lo = 0, hi = idx->n_sa; lo < hi; ) {
+            guint mid = (lo + hi) / 2;
+
+            if (strncmp(idx->text + idx->sa[mid], key, klen) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        for (end = lo, hi = idx->n_sa; end < hi; ) {
+            guint mid = (end + hi) / 2;
+
+            if (strncmp(idx->text + idx->sa[mid], key, klen) <= 0) {
+                end = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        if (max > 0 && end - lo > idx->n) {
+            /* A short key matches most FMRIs, often several times each, so
+             * the range would cost more than the FMRIs themselves. Those are
+             * sorted, the scan stops at max. */
+            for (guint i = 0; i < idx->n && found < max; i++) {
+                const gchar *fmri = idx->text + idx->starts[i];
+
+                if (strstr(fmri, key) != NULL) {
+                    callback((gpointer)fmri, user_data);
+                    found++;
+                }
+            }
+        } else {
+            guint8 *hits = g_new0(guint8, (idx->n + 7) / 8);
+
+            for (; lo < end; lo++) {
+                guint owner = fmri_index_owner(idx, idx->sa[lo]);
+
+                hits[owner / 8] |= 1 << (owner % 8);
+            }
+
+            for (guint i = 0; i < idx->n && (max == 0 || found < max); i++) {
+                if (hits[i / 8] & (1 << (i % 8))) {
+                    callback((gpointer)(idx->text + idx->starts[i]), user_data);
+                    found++;
+                }
+            }
+            g_free(hits);
+        }
+    }
+
+    return found;
+}
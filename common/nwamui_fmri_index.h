@@ -0,0 +1,77 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_fmri_index.h
+ *
+ */
+
+#ifndef _NWAMUI_FMRI_INDEX_H
+#define	_NWAMUI_FMRI_INDEX_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * A process wide, deduplicated index of the SMF instance FMRIs, built once
+ * on a worker thread, answering prefix and substring queries through a
+ * suffix array.
+ *
+ * The enumeration backend walks libscf by default. It can be replaced,
+ * e.g. by a fixture list, before the index is first built. The backend is
+ * run on the worker thread and calls callback(fmri, callback_data) for
+ * each FMRI, duplicates are fine.
+ *
+ * Except for the backend, everything is called from the main loop.
+ */
+
+typedef void (*nwamui_fmri_index_enum_func_t)(GFunc callback,
+                                              gpointer callback_data,
+                                              gpointer user_data);
+
+extern void     nwamui_fmri_index_set_backend(nwamui_fmri_index_enum_func_t func,
+                                              gpointer user_data);
+
+extern void     nwamui_fmri_index_build_async(GSourceFunc ready_func,
+                                              gpointer data,
+                                              GDestroyNotify notify);
+
+extern gboolean nwamui_fmri_index_is_ready(void);
+
+extern guint    nwamui_fmri_index_get_size(void);
+
+extern guint    nwamui_fmri_index_lookup(const gchar *key,
+                                         gboolean prefix_only,
+                                         guint max,
+                                         GFunc callback,
+                                         gpointer user_data);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_FMRI_INDEX_H */
@@ -0,0 +1,2336 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_gtk.c
+ *
+ * The GTK side of libnwamui: GtkBuilder UI files, icons, dialogs, entry
+ * validation and tree model helpers. None of the NWAM objects call into
+ * here, they live in libnwamui-core which only needs GLib and GObject.
+ */
+
+#include <gtk/gtk.h>
+#include <gdk/gdkx.h>
+#include <glib/gi18n.h>
+#include <libnwamui.h>
+#include <libgnome/libgnome.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+
+#define NWAM_ENVIRONMENT_RENAME     "nwam_environment_rename"
+#define RENAME_ENVIRONMENT_ENTRY    "rename_environment_entry"
+#define RENAME_ENVIRONMENT_OK_BTN   "rename_environment_ok_btn"
+
+#define PIXBUF_COMPOSITE_NO_SCALE(src, dest)                            \
+    gdk_pixbuf_composite(GDK_PIXBUF(src), GDK_PIXBUF(dest),             \
+      0, 0,                                                             \
+      gdk_pixbuf_get_width(dest),                                       \
+      gdk_pixbuf_get_height(dest),                                      \
+      (double)0.0, (double)0.0,                                         \
+      (double)gdk_pixbuf_get_width(dest)/gdk_pixbuf_get_width(src),     \
+      (double)gdk_pixbuf_get_height(dest)/gdk_pixbuf_get_height(src),   \
+      GDK_INTERP_NEAREST, 255)
+
+/* Use GtkBuilder */
+
+const   gchar* nwamui_ui_file_names[NWAMUI_UI_FILE_LAST + 1] = {
+    "nwam-manager-properties.ui",
+    "nwam-manager-wireless.ui",
+    NULL
+};
+
+/*
+ * The objects of a UI file are only built when first asked for, one top
+ * level object (e.g. a dialog) at a time along with the top level objects it
+ * refers to, like its models and adjustments. To know which top level holds
+ * a widget, the file is scanned once with GMarkup, which is much cheaper than
+ * building all of its dialogs.
+ */
+typedef struct {
+    gchar       *path;          /* Resolved path of the UI file */
+    GHashTable  *toplevel_of;   /* Object id -> id of its top level object */
+    GHashTable  *refs;          /* Top level id -> GPtrArray of referenced ids */
+    gboolean     partially_loaded;
+    gboolean     fully_loaded;
+} ui_file_info_t;
+
+typedef struct {
+    ui_file_info_t  *info;
+    gint             depth;     /* Of <object> elements */
+    gchar           *toplevel;
+    GString         *property;  /* Text of the current <property>, or NULL */
+    GPtrArray       *members;   /* Pairs of size group member and top level */
+} ui_scan_data_t;
+
+static GtkBuilder      *gtk_builder[NWAMUI_UI_FILE_LAST] = { NULL };
+static ui_file_info_t   ui_file_info[NWAMUI_UI_FILE_LAST] = { { NULL } };
+
+/* Where the first UI file was found, the others are expected there too. */
+static gchar           *ui_data_dir = NULL;
+
+static gboolean         ui_load_on_demand = TRUE;
+
+static gchar*
+find_ui_file( const gchar *name )
+{
+    const gchar * const *sys_data_dirs;
+    GPtrArray           *dirs;
+    gchar               *path = NULL;
+    guint                i;
+
+    if ( ui_data_dir != NULL ) {
+        path = g_build_filename( ui_data_dir, name, NULL );
+        if ( g_file_test( path, G_FILE_TEST_IS_REGULAR ) ) {
+            return( path );
+        }
+        g_free( path );
+        path = NULL;
+    }
+
+    /* With and without the package name in the path. */
+    dirs = g_ptr_array_new();
+    g_ptr_array_add( dirs, g_build_filename( NWAM_MANAGER_DATADIR, PACKAGE, NULL ) );
+    g_ptr_array_add( dirs, g_strdup( NWAM_MANAGER_DATADIR ) );
+    sys_data_dirs = g_get_system_data_dirs ();
+    for ( i = 0; sys_data_dirs[i] != NULL; i++ ) {
+        g_ptr_array_add( dirs, g_build_filename( sys_data_dirs[i], PACKAGE, NULL ) );
+        g_ptr_array_add( dirs, g_strdup( sys_data_dirs[i] ) );
+    }
+
+    for ( i = 0; i < dirs->len && path == NULL; i++ ) {
+        path = g_build_filename( dirs->pdata[i], name, NULL );
+        nwamui_debug("Attempting to load : %s", path);
+        if ( g_file_test( path, G_FILE_TEST_IS_REGULAR ) ) {
+            nwamui_debug("Found gtk builder file at : %s", path );
+            if ( ui_data_dir == NULL ) {
+                ui_data_dir = g_strdup( dirs->pdata[i] );
+            }
+        } else {
+            g_free( path );
+            path = NULL;
+        }
+    }
+
+    for ( i = 0; i < dirs->len; i++ ) {
+        g_free( dirs->pdata[i] );
+    }
+    g_ptr_array_free( dirs, TRUE );
+
+    return( path );
+}
+
+static const gchar*
+ui_scan_attribute( const gchar **attribute_names,
+                   const gchar **attribute_values,
+                   const gchar  *name )
+{
+    gint i;
+
+    for ( i = 0; attribute_names[i] != NULL; i++ ) {
+        if ( strcmp( attribute_names[i], name ) == 0 ) {
+            return( attribute_values[i] );
+        }
+    }
+    return( NULL );
+}
+
+/* Building toplevel needs the object id, whose own top level is looked up
+ * once the whole file is scanned.
+ */
+static void
+ui_scan_add_ref( ui_file_info_t *info, const gchar *toplevel, const gchar *id )
+{
+    GPtrArray *refs = g_hash_table_lookup( info->refs, toplevel );
+
+    if ( refs == NULL ) {
+        refs = g_ptr_array_new();
+        g_hash_table_insert( info->refs, g_strdup( toplevel ), refs );
+    }
+    g_ptr_array_add( refs, g_strdup( id ) );
+}
+
+/*
+ * Objects nested in a top level, including its <child internal-child>, are
+ * built with it. Other objects are referred to by a <property> value, the
+ * object of a <signal>, or the <group> of the <accel-groups> of a window.
+ * A size group lists its <widget> members, so it is built along with them.
+ */
+static void
+ui_scan_start_element( GMarkupParseContext *context,
+                       const gchar         *element_name,
+                       const gchar        **attribute_names,
+                       const gchar        **attribute_values,
+                       gpointer             user_data,
+                       GError             **error )
+{
+    ui_scan_data_t  *data = (ui_scan_data_t *)user_data;
+    const gchar     *ref = NULL;
+
+    if ( strcmp( element_name, "object" ) == 0 ) {
+        const gchar *id = ui_scan_attribute( attribute_names, attribute_values, "id" );
+
+        if ( data->depth++ == 0 ) {
+            g_free( data->toplevel );
+            data->toplevel = g_strdup( id );
+        }
+        if ( id != NULL && data->toplevel != NULL ) {
+            g_hash_table_insert( data->info->toplevel_of, g_strdup( id ), g_strdup( data->toplevel ) );
+        }
+    } else if ( data->depth == 0 || data->toplevel == NULL ) {
+        return;
+    } else if ( strcmp( element_name, "property" ) == 0 ) {
+        data->property = g_string_new( NULL );
+    } else if ( strcmp( element_name, "signal" ) == 0 ) {
+        ref = ui_scan_attribute( attribute_names, attribute_values, "object" );
+    } else if ( strcmp( element_name, "group" ) == 0 ) {
+        ref = ui_scan_attribute( attribute_names, attribute_values, "name" );
+    } else if ( strcmp( element_name, "widget" ) == 0 ) {
+        const gchar *member = ui_scan_attribute( attribute_names, attribute_values, "name" );
+
+        if ( member != NULL ) {
+            g_ptr_array_add( data->members, g_strdup( member ) );
+            g_ptr_array_add( data->members, g_strdup( data->toplevel ) );
+        }
+    }
+
+    if ( ref != NULL ) {
+        ui_scan_add_ref( data->info, data->toplevel, ref );
+    }
+}
+
+static void
+ui_scan_end_element( GMarkupParseContext *context,
+                     const gchar         *element_name,
+                     gpointer             user_data,
+                     GError             **error )
+{
+    ui_scan_data_t  *data = (ui_scan_data_t *)user_data;
+
+    if ( strcmp( element_name, "object" ) == 0 ) {
+        data->depth--;
+    } else if ( strcmp( element_name, "property" ) == 0 && data->property != NULL ) {
+        /* Any property value might name an object. */
+        if ( data->property->len > 0 && data->toplevel != NULL ) {
+            ui_scan_add_ref( data->info, data->toplevel, g_strstrip( data->property->str ) );
+        }
+        g_string_free( data->property, TRUE );
+        data->property = NULL;
+    }
+}
+
+static void
+ui_scan_text( GMarkupParseContext *context,
+              const gchar         *text,
+              gsize                text_len,
+              gpointer             user_data,
+              GError             **error )
+{
+    ui_scan_data_t  *data = (ui_scan_data_t *)user_data;
+
+    if ( data->property != NULL ) {
+        g_string_append_len( data->property, text, text_len );
+    }
+}
+
+static void
+ui_refs_free( gpointer data )
+{
+    GPtrArray *refs = (GPtrArray *)data;
+    guint      i;
+
+    for ( i = 0; i < refs->len; i++ ) {
+        g_free( refs->pdata[i] );
+    }
+    g_ptr_array_free( refs, TRUE );
+}
+
+static gboolean
+ui_file_scan( ui_file_info_t *info )
+{
+    static const GMarkupParser parser = {
+        ui_scan_start_element,
+        ui_scan_end_element,
+        ui_scan_text,
+        NULL,
+        NULL
+    };
+    GMarkupParseContext *context;
+    ui_scan_data_t       data = { info, 0, NULL, NULL, NULL };
+    gchar               *contents;
+    gsize                length;
+    GError              *err = NULL;
+    gboolean             ret;
+    guint                i;
+
+    if ( !g_file_get_contents( info->path, &contents, &length, &err ) ) {
+        nwamui_warning("Error reading UI file : %s", err->message);
+        g_error_free( err );
+        return( FALSE );
+    }
+
+    info->toplevel_of = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, g_free );
+    info->refs = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, ui_refs_free );
+
+    data.members = g_ptr_array_new();
+    context = g_markup_parse_context_new( &parser, 0, &data, NULL );
+    ret = g_markup_parse_context_parse( context, contents, length, &err ) &&
+      g_markup_parse_context_end_parse( context, &err );
+    if ( !ret ) {
+        nwamui_warning("Error scanning UI file : %s", err->message);
+        g_error_free( err );
+    }
+    g_markup_parse_context_free( context );
+
+    /* The top level of a size group member brings the size group in. */
+    for ( i = 0; i + 1 < data.members->len; i += 2 ) {
+        const gchar *toplevel = g_hash_table_lookup( info->toplevel_of, data.members->pdata[i] );
+
+        if ( toplevel != NULL && strcmp( toplevel, data.members->pdata[i + 1] ) != 0 ) {
+            ui_scan_add_ref( info, toplevel, data.members->pdata[i + 1] );
+        }
+    }
+    ui_refs_free( data.members );
+    g_free( data.toplevel );
+    if ( data.property ) {
+        g_string_free( data.property, TRUE );
+    }
+    g_free( contents );
+
+    return( ret );
+}
+
+/* Add toplevel and, first, the not yet built top levels it refers to. */
+static void
+ui_collect_toplevels( GtkBuilder *builder, ui_file_info_t *info,
+                      const gchar *toplevel, GPtrArray *ids )
+{
+    GPtrArray *refs;
+    guint      i;
+
+    for ( i = 0; i < ids->len; i++ ) {
+        if ( strcmp( ids->pdata[i], toplevel ) == 0 ) {
+            return;
+        }
+    }
+    if ( gtk_builder_get_object( builder, toplevel ) != NULL ) {
+        return;
+    }
+    g_ptr_array_add( ids, (gpointer)toplevel );
+
+    if ( (refs = g_hash_table_lookup( info->refs, toplevel )) != NULL ) {
+        for ( i = 0; i < refs->len; i++ ) {
+            const gchar *ref = g_hash_table_lookup( info->toplevel_of, refs->pdata[i] );
+
+            if ( ref != NULL ) {
+                ui_collect_toplevels( builder, info, ref, ids );
+            }
+        }
+    }
+}
+
+/* Build whatever is not built yet of the file. GtkBuilder fails on an id
+ * it has already built, so after a partial load only the remaining top
+ * levels are added, the scan knows all of them then.
+ */
+static void
+ui_load_all( nwamui_ui_file_index_t index )
+{
+    GtkBuilder     *builder = gtk_builder[index];
+    ui_file_info_t *info = &ui_file_info[index];
+    GError         *err = NULL;
+
+    nwamui_debug("Loading all of %s", info->path);
+    info->fully_loaded = TRUE;
+
+    if ( !info->partially_loaded ) {
+        if ( gtk_builder_add_from_file( builder, info->path, &err ) == 0 ) {
+            nwamui_warning("Error loading glade file : %s", err->message);
+            g_clear_error( &err );
+        }
+    } else {
+        GPtrArray      *ids = g_ptr_array_new();
+        GHashTableIter  iter;
+        gpointer        id;
+        gpointer        toplevel;
+
+        g_hash_table_iter_init( &iter, info->toplevel_of );
+        while ( g_hash_table_iter_next( &iter, &id, &toplevel ) ) {
+            if ( strcmp( id, toplevel ) == 0 && gtk_builder_get_object( builder, id ) == NULL ) {
+                g_ptr_array_add( ids, id );
+            }
+        }
+        if ( ids->len > 0 ) {
+            g_ptr_array_add( ids, NULL );
+            if ( gtk_builder_add_objects_from_file( builder, info->path, (gchar **)ids->pdata, &err ) == 0 ) {
+                nwamui_warning("Error loading glade file : %s", err->message);
+                g_clear_error( &err );
+            }
+        }
+        g_ptr_array_free( ids, TRUE );
+    }
+}
+
+static GtkBuilder* 
+get_gtk_builder( nwamui_ui_file_index_t index ) {
+    ui_file_info_t *info = &ui_file_info[index];
+
+    if ( gtk_builder[index] == NULL ) {
+        if ( (info->path = find_ui_file( nwamui_ui_file_names[index] )) == NULL ) {
+            nwamui_error("Error locating UI file %s", nwamui_ui_file_names[index] );
+            return( NULL );
+        }
+        gtk_builder[index] = gtk_builder_new();
+
+        /* Without the scan there is no knowing what to build on demand. */
+        if ( !ui_load_on_demand || !ui_file_scan( info ) ) {
+            ui_load_all( index );
+        }
+    }
+    return gtk_builder[index];
+}
+
+/* Build the top level object holding object_id, if not yet. */
+static void
+ui_load_object( nwamui_ui_file_index_t index, const gchar *object_id )
+{
+    GtkBuilder     *builder = gtk_builder[index];
+    ui_file_info_t *info = &ui_file_info[index];
+    const gchar    *toplevel;
+    GPtrArray      *ids;
+    GError         *err = NULL;
+
+    if ( info->fully_loaded || gtk_builder_get_object( builder, object_id ) != NULL ) {
+        return;
+    }
+
+    nwamui_trace_begin("ui_load_object");
+
+    toplevel = g_hash_table_lookup( info->toplevel_of, object_id );
+    ids = g_ptr_array_new();
+    if ( toplevel != NULL ) {
+        ui_collect_toplevels( builder, info, toplevel, ids );
+    }
+
+    if ( ids->len > 0 ) {
+        g_ptr_array_add( ids, NULL );
+        nwamui_debug("Loading %s from %s", toplevel, info->path);
+        info->partially_loaded = TRUE;
+        if ( gtk_builder_add_objects_from_file( builder, info->path, (gchar **)ids->pdata, &err ) == 0 ) {
+            nwamui_warning("Error loading %s from glade file : %s", toplevel, err->message);
+            g_clear_error( &err );
+        }
+    }
+    g_ptr_array_free( ids, TRUE );
+
+    /* Not found by the scan, fall back to building everything. */
+    if ( gtk_builder_get_object( builder, object_id ) == NULL ) {
+        nwamui_debug("%s not found by the scan", object_id);
+        ui_load_all( index );
+    }
+
+    nwamui_trace_end("ui_load_object");
+}
+
+/**
+ * nwamui_util_ui_set_load_on_demand:
+ * @on_demand: FALSE to build all of a UI file on its first use.
+ *
+ * On demand by default. Only has effect on the UI files not used yet, it
+ * is there to compare both.
+ **/
+extern void
+nwamui_util_ui_set_load_on_demand( gboolean on_demand )
+{
+    ui_load_on_demand = on_demand;
+}
+
+/**
+ * nwamui_util_ui_get_widget_from:
+ * @index: nwamui_ui_file_index_t index of file to load widget from.
+ * @widget_name: name of the widget to load.
+ * @returns: the widget loaded from the GktBuilder file.
+ *
+ * Only the dialog holding the widget is built, on first use.
+ **/
+extern GtkWidget*
+nwamui_util_ui_get_widget_from( nwamui_ui_file_index_t index,  const gchar* widget_name ) 
+{
+    GtkBuilder* builder;;
+    GtkWidget*  widget;
+
+    g_assert( widget_name != NULL );
+    
+    g_return_val_if_fail( widget_name != NULL, NULL );
+    
+    builder = get_gtk_builder( index );
+    g_return_val_if_fail( builder != NULL, NULL );
+
+    ui_load_object( index, widget_name );
+    
+    widget = GTK_WIDGET(gtk_builder_get_object(builder, widget_name ));
+    
+    if ( widget == NULL )
+        g_error("Failed to get widget by name %s", widget_name );
+    
+    return widget;
+}
+        
+static gint             small_icon_size = -1;
+static gint             normal_icon_size = -1;
+static gint             theme_changed_id = -1;
+static GtkIconTheme*    icon_theme = NULL;
+
+static void
+icon_theme_changed ( GtkIconTheme  *_icon_theme, gpointer data )
+{
+    g_debug("Theme Changed");
+    if ( theme_changed_id != -1 && _icon_theme != icon_theme ) {
+        g_signal_handler_disconnect( icon_theme, theme_changed_id );
+        theme_changed_id = -1;
+        g_object_unref(icon_theme);
+        icon_theme = NULL;
+
+        icon_theme = GTK_ICON_THEME(g_object_ref( _icon_theme ));
+        theme_changed_id = g_signal_connect (  icon_theme, "changed",
+                                               G_CALLBACK (icon_theme_changed), NULL);
+    }
+
+    /* Invalidate known sizes now */
+    small_icon_size = -1;
+    normal_icon_size = -1;
+}
+
+static GdkPixbuf*   
+get_pixbuf_with_size( const gchar* stock_id, gint size )
+{
+    GdkPixbuf*      pixbuf = NULL;
+    GError*         error = NULL;
+
+
+    if ( icon_theme == NULL ) {
+        icon_theme = GTK_ICON_THEME(g_object_ref(gtk_icon_theme_get_default()));
+        theme_changed_id = g_signal_connect (  icon_theme, "changed",
+                                               G_CALLBACK (icon_theme_changed), NULL);
+
+    }
+
+    nwamui_trace_begin("icon_load");
+    pixbuf = gtk_icon_theme_load_icon( icon_theme, stock_id, 
+                                       (size > 0)?(size):(32), 0, &error );
+    nwamui_trace_end("icon_load");
+
+    if ( pixbuf == NULL ) {
+        g_debug("get_pixbuf_with_size failed: pixbuf = NULL stockid = %s", stock_id);
+    } else {
+        nwamui_instances_track(pixbuf);
+    }
+    return( pixbuf );
+}
+
+static GdkPixbuf*   
+get_pixbuf( const gchar* stock_id, gboolean small )
+{
+
+    if ( small_icon_size == -1 ) {
+        gint dummy;
+        if ( !gtk_icon_size_lookup(GTK_ICON_SIZE_MENU, &small_icon_size, &dummy) ) {
+            small_icon_size=16;
+        }
+        if ( !gtk_icon_size_lookup(GTK_ICON_SIZE_LARGE_TOOLBAR, &normal_icon_size, &dummy) ) {
+            normal_icon_size=24;
+        }
+        g_debug("get_pixbuf: small_icon_size = %d", small_icon_size );
+        g_debug("get_pixbuf: normal_icon_size = %d", normal_icon_size );
+    }
+
+    return (get_pixbuf_with_size( stock_id, small?small_icon_size:normal_icon_size ));
+}
+
+struct info_for_env_status_icon {
+    gint   activate_wired_num;
+    gint   activate_wireless_num;
+    gint   average_signal_strength;
+    gint64 ncp_prio;
+};
+
+extern gint
+foreach_gather_info_for_env_status_icon_from_ncp(gconstpointer data, gconstpointer user_data)
+{
+	NwamuiNcu                       *ncu            = (NwamuiNcu *)data;
+    struct info_for_env_status_icon *info           = (struct info_for_env_status_icon *)user_data;
+    gint64                           ncu_prio;
+    gint                             found_excl_ncu = 1;
+	
+    g_return_val_if_fail(NWAMUI_IS_NCU(ncu), 1);
+    g_return_val_if_fail(info, 0);
+    
+    ncu_prio = nwamui_ncu_get_priority_group(ncu);
+
+    /* Only care about current prio ncus, and first exclusive NCU
+     * that's in UP state 
+     */
+    if ( ncu_prio == info->ncp_prio) {
+        if (nwamui_object_get_active(NWAMUI_OBJECT(ncu))) {
+            nwam_state_t            state;
+            nwam_aux_state_t        aux_state;
+            nwamui_cond_activation_mode_t 
+              activation_mode;
+            nwamui_cond_priority_group_mode_t 
+              prio_group_mode;
+                    
+            state = nwamui_object_get_nwam_state( NWAMUI_OBJECT(ncu), &aux_state, NULL);
+            activation_mode = nwamui_object_get_activation_mode(NWAMUI_OBJECT(ncu));
+            prio_group_mode = nwamui_ncu_get_priority_group_mode( ncu );
+
+            if ( activation_mode == NWAMUI_COND_ACTIVATION_MODE_PRIORITIZED ) {
+                if ( prio_group_mode == NWAMUI_COND_PRIORITY_GROUP_MODE_EXCLUSIVE ) {
+                    if ( state == NWAM_STATE_ONLINE && aux_state == NWAM_AUX_STATE_UP ) {
+                        /* Stop here. */
+                        found_excl_ncu = 0;
+                    }
+                }
+            }
+
+            switch(nwamui_ncu_get_ncu_type(ncu)) {
+#ifdef TUNNEL_SUPPORT
+            case NWAMUI_NCU_TYPE_TUNNEL:
+#endif /* TUNNEL_SUPPORT */
+            case NWAMUI_NCU_TYPE_WIRED:
+                info->activate_wired_num++;
+                break;
+            case NWAMUI_NCU_TYPE_WIRELESS:
+                info->activate_wireless_num++;
+                info->average_signal_strength += nwamui_ncu_get_wifi_signal_strength(ncu);
+                break;
+            default:
+                g_assert_not_reached();
+                break;
+            }
+        }
+    }
+
+    return found_excl_ncu;
+}
+
+/* 
+ * Returns a GdkPixbuf that reflects the status of the overall environment
+ * If force_size equals 0, uses the size of status icon.
+ */
+extern GdkPixbuf*
+nwamui_util_get_env_status_icon( GtkStatusIcon* status_icon, nwamui_daemon_status_t daemon_status, gint force_size )
+{
+    struct info_for_env_status_icon info;
+    nwamui_ncu_type_t               ncu_type;
+    nwamui_connection_state_t       connection_state = NWAMUI_STATE_UNKNOWN;
+
+    if (force_size == 0) {
+        if (status_icon != NULL && gtk_status_icon_is_embedded(status_icon)) {
+            force_size = gtk_status_icon_get_size( status_icon );
+        }
+        else {
+            return( NULL );
+        }
+    }
+    {
+        NwamuiDaemon *daemon         = nwamui_daemon_get_instance();
+        NwamuiObject *ncp            = nwamui_daemon_get_active_ncp(daemon);
+
+        g_object_unref(daemon);
+
+        if ( ncp ) {
+            /* Clean */
+            bzero(&info, sizeof(info));
+
+            info.ncp_prio = nwamui_ncp_get_prio_group(NWAMUI_NCP(ncp));
+            nwamui_ncp_find_ncu(NWAMUI_NCP(ncp), foreach_gather_info_for_env_status_icon_from_ncp, &info);
+            g_object_unref(ncp);
+        }
+    }
+
+    if (info.activate_wireless_num > 0) {
+        ncu_type = NWAMUI_NCU_TYPE_WIRELESS;
+        info.average_signal_strength /= info.activate_wireless_num;
+    } else {
+        ncu_type = NWAMUI_NCU_TYPE_WIRED;
+        info.average_signal_strength = NWAMUI_WIFI_STRENGTH_NONE;
+    }
+
+    return nwamui_util_get_network_status_icon(ncu_type, 
+      info.average_signal_strength,
+      daemon_status,
+      force_size);
+}
+
+/* 
+ * Returns a GdkPixbuf that reflects the type of the network.
+ */
+extern GdkPixbuf*
+nwamui_util_get_network_type_icon( nwamui_ncu_type_t ncu_type )
+{
+        static GdkPixbuf       *wireless_icon = NULL;
+        static GdkPixbuf       *wired_icon = NULL;
+
+        if ( wireless_icon == NULL ) {
+            wireless_icon = get_pixbuf("network-wireless", FALSE);
+        }
+        if (wired_icon == NULL ) {
+            wired_icon = get_pixbuf("network-idle", FALSE);
+        }
+        
+        switch (ncu_type) {
+            case NWAMUI_NCU_TYPE_WIRELESS:
+                return( GDK_PIXBUF(g_object_ref(G_OBJECT(wireless_icon) )) );
+            case NWAMUI_NCU_TYPE_WIRED: 
+                /* Fall-through */
+            default:
+                return( GDK_PIXBUF(g_object_ref(G_OBJECT(wired_icon) )) );
+        }
+}
+       
+/* 
+ * Returns a GdkPixbuf that reflects the security type of the network.
+ */
+extern GdkPixbuf*
+nwamui_util_get_network_security_icon( nwamui_wifi_security_t sec_type, gboolean small )
+{
+    static GdkPixbuf       *secured_icon = NULL;
+    static GdkPixbuf       *open_icon = NULL;
+
+    if ( secured_icon == NULL ) {
+        secured_icon = get_pixbuf(NWAM_ICON_NETWORK_SECURE, small);
+    }
+    if ( open_icon == NULL ) {
+        open_icon = get_pixbuf(NWAM_ICON_NETWORK_INSECURE, small);
+    }
+
+    switch (sec_type) {
+#ifdef WEP_ASCII_EQ_HEX 
+        case NWAMUI_WIFI_SEC_WEP:
+#else
+        case NWAMUI_WIFI_SEC_WEP_ASCII:
+        case NWAMUI_WIFI_SEC_WEP_HEX:
+#endif /* WEP_ASCII_EQ_HEX */
+        /* case NWAMUI_WIFI_SEC_WPA_ENTERPRISE: - Currently not supported */
+        case NWAMUI_WIFI_SEC_WPA_PERSONAL:
+            return( GDK_PIXBUF(g_object_ref(G_OBJECT(secured_icon) )) );
+        case NWAMUI_WIFI_SEC_NONE: 
+            /* Fall-through */
+        default:
+            return( GDK_PIXBUF(g_object_ref(G_OBJECT(open_icon) )) );
+    }
+}
+       
+/* 
+ * Returns a GdkPixbuf that reflects the status of the network.
+ */
+extern GdkPixbuf*
+nwamui_util_get_network_status_icon(nwamui_ncu_type_t ncu_type,
+  nwamui_wifi_signal_strength_t strength,
+  nwamui_daemon_status_t daemon_status,
+  gint size)
+{
+    static GdkPixbuf*   network_status_icons[NWAMUI_DAEMON_STATUS_LAST][NWAMUI_NCU_TYPE_LAST][NWAMUI_WIFI_STRENGTH_LAST][4] = {NULL};
+
+    GdkPixbuf* env_status_icon = NULL;
+    gchar *stock_id = NULL;
+    gint icon_size;
+
+    g_return_val_if_fail(ncu_type < NWAMUI_NCU_TYPE_LAST, NULL);
+    g_return_val_if_fail(daemon_status < NWAMUI_DAEMON_STATUS_LAST, NULL);
+    g_return_val_if_fail(strength < NWAMUI_WIFI_STRENGTH_LAST, NULL);
+
+    if (size <= 16) {size = 16; icon_size = 0;}
+    else if (size <= 24) {size = 24; icon_size = 1;}
+    else if (size <= 32) {size = 32; icon_size = 2;}
+    else {size = 48; icon_size = 3;}
+
+/*     g_debug("%s: returning icon for status = %d; ncu_type = %d, signal = %d; size = %d", __func__,  */
+/*             daemon_status, ncu_type, strength, size ); */
+
+    if (network_status_icons[daemon_status][ncu_type][strength][icon_size] == NULL ) {
+        GdkPixbuf* inf_icon = NULL;
+        GdkPixbuf* temp_icon = NULL;
+
+        switch(ncu_type) {
+#ifdef TUNNEL_SUPPORT
+        case NWAMUI_NCU_TYPE_TUNNEL:
+#endif /* TUNNEL_SUPPORT */
+        case NWAMUI_NCU_TYPE_WIRED:
+            temp_icon = get_pixbuf_with_size(NWAM_ICON_NETWORK_WIRED, size);
+            break;
+        case NWAMUI_NCU_TYPE_WIRELESS:
+            temp_icon = nwamui_util_get_wireless_strength_icon_with_size(strength, NWAMUI_WIRELESS_ICON_TYPE_RADAR, size);
+            break;
+        default:
+            g_assert_not_reached();
+        }
+
+        inf_icon = gdk_pixbuf_copy(temp_icon);
+        nwamui_instances_track(inf_icon);
+        g_object_unref(temp_icon);
+
+        switch( daemon_status ) {
+        case NWAMUI_DAEMON_STATUS_ALL_OK:
+            stock_id = NWAM_ICON_CONNECTED;
+            break;
+        case NWAMUI_DAEMON_STATUS_NEEDS_ATTENTION:
+            stock_id = NWAM_ICON_WARNING;
+            break;
+        case NWAMUI_DAEMON_STATUS_ERROR:
+            stock_id = NWAM_ICON_ERROR;
+            break;
+        default:
+            g_assert_not_reached();
+            break;
+        }
+        env_status_icon = get_pixbuf_with_size(stock_id, size);
+        PIXBUF_COMPOSITE_NO_SCALE(env_status_icon, inf_icon);
+        g_object_unref(env_status_icon);
+
+        network_status_icons[daemon_status][ncu_type][strength][icon_size] = inf_icon;
+    }
+
+    return(GDK_PIXBUF(g_object_ref(network_status_icons[daemon_status][ncu_type][strength][icon_size])));
+}
+
+extern GdkPixbuf*
+nwamui_util_get_ncu_status_icon( NwamuiNcu* ncu, gint size )
+{
+    nwamui_ncu_type_t             ncu_type;
+    nwamui_wifi_signal_strength_t strength         = NWAMUI_WIFI_STRENGTH_NONE;
+    nwamui_connection_state_t     connection_state = NWAMUI_STATE_UNKNOWN;
+    gboolean                      active           = FALSE;
+    nwamui_daemon_status_t        daemon_state     = NWAMUI_DAEMON_STATUS_ERROR;
+
+/*     g_debug("%s",  __func__); */
+
+    if ( ncu != NULL ) {
+        ncu_type = nwamui_ncu_get_ncu_type(ncu);
+        strength = nwamui_ncu_get_wifi_signal_strength(ncu);
+        active = nwamui_object_get_active(NWAMUI_OBJECT(ncu));
+    }
+    else {
+        /* Fallback to a Wired connection */
+        ncu_type = NWAMUI_NCU_TYPE_WIRED;
+        active = FALSE;
+    }
+    if ( active ) {
+        /* Double check the state using nwam state */
+        connection_state = nwamui_ncu_get_connection_state( ncu);
+        if ( connection_state == NWAMUI_STATE_CONNECTED 
+           || connection_state == NWAMUI_STATE_CONNECTED_ESSID ) {
+            daemon_state = NWAMUI_DAEMON_STATUS_ALL_OK;
+        }
+        else if ( connection_state == NWAMUI_STATE_CONNECTING 
+                || connection_state == NWAMUI_STATE_WAITING_FOR_ADDRESS
+                || connection_state == NWAMUI_STATE_DHCP_TIMED_OUT
+                || connection_state == NWAMUI_STATE_DHCP_DUPLICATE_ADDR
+                || connection_state == NWAMUI_STATE_CONNECTING_ESSID ) {
+            daemon_state = NWAMUI_DAEMON_STATUS_NEEDS_ATTENTION;
+        }
+        else {
+            daemon_state = NWAMUI_DAEMON_STATUS_ERROR;
+        }
+    }
+
+    return nwamui_util_get_network_status_icon(ncu_type, strength, daemon_state, size);
+}
+       
+extern const gchar*
+nwamui_util_get_ncu_group_icon( NwamuiNcu* ncu  )
+{
+    switch (nwamui_ncu_get_priority_group_mode(ncu)) {
+    case NWAMUI_COND_PRIORITY_GROUP_MODE_EXCLUSIVE:
+        return NWAM_ICON_COND_PRIORITY_GROUP_MODE_EXCLUSIVE;
+    case NWAMUI_COND_PRIORITY_GROUP_MODE_SHARED:
+        return NWAM_ICON_COND_PRIORITY_GROUP_MODE_SHARED;
+    case NWAMUI_COND_PRIORITY_GROUP_MODE_ALL:
+        return NWAM_ICON_COND_PRIORITY_GROUP_MODE_ALL;
+    default:
+        g_assert_not_reached();
+        return NULL;
+    }
+}
+
+extern const gchar*
+nwamui_util_get_active_mode_icon( NwamuiObject *object  )
+{
+    switch (nwamui_object_get_activation_mode(object)) {
+    case NWAMUI_COND_ACTIVATION_MODE_MANUAL:
+        return NWAM_ICON_COND_ACT_MODE_MANUAL;
+    case NWAMUI_COND_ACTIVATION_MODE_SYSTEM:
+        return NWAM_ICON_COND_ACT_MODE_SYSTEM;
+    case NWAMUI_COND_ACTIVATION_MODE_PRIORITIZED:
+        return NWAM_ICON_COND_ACT_MODE_PRIORITIZED;
+    case NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY:
+        return NWAM_ICON_COND_ACT_MODE_CONDITIONAL_ANY;
+    case NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL:
+        return NWAM_ICON_COND_ACT_MODE_CONDITIONAL_ALL;
+    default:
+        g_assert_not_reached();
+        break;
+    }
+}
+
+extern GdkPixbuf*
+nwamui_util_get_wireless_strength_icon_with_size( nwamui_wifi_signal_strength_t signal_strength, 
+                                                  nwamui_wireless_icon_type_t icon_type,
+                                                  gint size)
+{
+    static GdkPixbuf*   enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_LAST][NWAMUI_WIRELESS_ICON_TYPE_LAST][4];
+    gint icon_size;
+
+    if (size <= 16) {size = 16; icon_size = 0;}
+    else if (size <= 24) {size = 24; icon_size = 1;}
+    else if (size <= 32) {size = 32; icon_size = 2;}
+    else {size = 48; icon_size = 3;}
+
+    if ( enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_NONE][NWAMUI_WIRELESS_ICON_TYPE_RADAR][icon_size] == NULL ) {
+        GdkPixbuf* inf_icon = NULL;
+        GdkPixbuf* wireless_strength_icon = NULL;
+        GdkPixbuf* composed_icon = NULL;
+
+        /* Basic interface icon. */
+/*         inf_icon = gdk_pixbuf_new(GDK_COLORSPACE_RGB, */
+/*           TRUE, */
+/*           8, */
+/*           24, */
+/*           24); */
+
+        /* Create Composed RADAR icons */
+
+        inf_icon = get_pixbuf_with_size(NWAM_ICON_NETWORK_WIRELESS, size);
+/*         size = (size - 16)/2 + 16; */
+
+        /* Compose icon. */
+        composed_icon = gdk_pixbuf_copy(inf_icon);
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_RADAR_ICON_WIRELESS_STRENGTH_NONE, size);
+        PIXBUF_COMPOSITE_NO_SCALE(wireless_strength_icon, composed_icon);
+        g_object_unref(wireless_strength_icon);
+
+        /* Mapping : NONE = NONE */
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_NONE][NWAMUI_WIRELESS_ICON_TYPE_RADAR][icon_size] = composed_icon;
+          
+        composed_icon = gdk_pixbuf_copy(inf_icon);
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_RADAR_ICON_WIRELESS_STRENGTH_POOR, size);
+        PIXBUF_COMPOSITE_NO_SCALE(wireless_strength_icon, composed_icon);
+        g_object_unref(wireless_strength_icon);
+
+        /* Mapping : VERY_WEAK = POOR */
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_VERY_WEAK][NWAMUI_WIRELESS_ICON_TYPE_RADAR][icon_size] = composed_icon;
+
+        composed_icon = gdk_pixbuf_copy(inf_icon);
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_RADAR_ICON_WIRELESS_STRENGTH_FAIR, size);
+        PIXBUF_COMPOSITE_NO_SCALE(wireless_strength_icon, composed_icon);
+        g_object_unref(wireless_strength_icon);
+
+        /* Mapping : WEAK = FAIR */
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_WEAK][NWAMUI_WIRELESS_ICON_TYPE_RADAR][icon_size] = composed_icon;
+
+        composed_icon = gdk_pixbuf_copy(inf_icon);
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_RADAR_ICON_WIRELESS_STRENGTH_GOOD, size);
+        PIXBUF_COMPOSITE_NO_SCALE(wireless_strength_icon, composed_icon);
+        g_object_unref(wireless_strength_icon);
+
+        /* Mapping : GOOD = GOOD */
+        /* Mapping : VERY_GOOD = GOOD */
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_GOOD][NWAMUI_WIRELESS_ICON_TYPE_RADAR][icon_size] = composed_icon;
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_VERY_GOOD][NWAMUI_WIRELESS_ICON_TYPE_RADAR][icon_size]= g_object_ref(composed_icon);
+
+        composed_icon = gdk_pixbuf_copy(inf_icon);
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_RADAR_ICON_WIRELESS_STRENGTH_EXCELLENT, size);
+        PIXBUF_COMPOSITE_NO_SCALE(wireless_strength_icon, composed_icon);
+        g_object_unref(wireless_strength_icon);
+
+        /* Mapping : EXCELLENT = EXCELLENT */
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_EXCELLENT][NWAMUI_WIRELESS_ICON_TYPE_RADAR][icon_size]= composed_icon;
+
+        g_object_unref(inf_icon);
+
+        /* Create simpler Bar Icons */
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_BAR_ICON_WIRELESS_STRENGTH_NONE, size);
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_NONE][NWAMUI_WIRELESS_ICON_TYPE_BARS][icon_size] = wireless_strength_icon;
+          
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_BAR_ICON_WIRELESS_STRENGTH_POOR, size);
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_VERY_WEAK][NWAMUI_WIRELESS_ICON_TYPE_BARS][icon_size] = wireless_strength_icon;
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_WEAK][NWAMUI_WIRELESS_ICON_TYPE_BARS][icon_size] = g_object_ref(wireless_strength_icon);
+
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_BAR_ICON_WIRELESS_STRENGTH_FAIR, size);
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_GOOD][NWAMUI_WIRELESS_ICON_TYPE_BARS][icon_size] = wireless_strength_icon;
+
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_BAR_ICON_WIRELESS_STRENGTH_GOOD, size);
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_VERY_GOOD][NWAMUI_WIRELESS_ICON_TYPE_BARS][icon_size]= wireless_strength_icon;
+
+        wireless_strength_icon = get_pixbuf_with_size(NWAM_BAR_ICON_WIRELESS_STRENGTH_EXCELLENT, size);
+        enabled_wireless_icons[NWAMUI_WIFI_STRENGTH_EXCELLENT][NWAMUI_WIRELESS_ICON_TYPE_BARS][icon_size]= wireless_strength_icon;
+    }
+
+    return( GDK_PIXBUF(g_object_ref( G_OBJECT(enabled_wireless_icons[signal_strength][icon_type][icon_size]) )) );
+}
+
+/* 
+ * Shows Help Dialog - the link_name refers to either the anchor or sectionid in the help file.
+ */
+extern void
+nwamui_util_show_help( const gchar* link_name )
+{
+  GError *error = NULL;
+  
+  gnome_help_display(PACKAGE, (link_name?link_name:""), &error);
+  
+  if (error) {
+    GtkWidget *dialog;
+    dialog = gtk_message_dialog_new_with_markup (NULL, GTK_DIALOG_MODAL, 
+                   GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+                   "<span weight=\"bold\" size=\"larger\">%s</span>\n\n%s",
+                   _("Could not display help"),
+                   error->message);
+    g_signal_connect (G_OBJECT (dialog), "response",
+          G_CALLBACK (gtk_widget_destroy),
+          NULL);
+    gtk_window_set_resizable (GTK_WINDOW (dialog), FALSE);
+    gtk_widget_show (dialog);
+
+    g_error_free (error);
+  }
+}
+
+static void
+disable_widget_if_empty (GtkEditable *editable, gpointer  user_data)  
+{
+    const gchar* text = gtk_entry_get_text(GTK_ENTRY(editable));
+
+    if ( text == NULL || strlen(text) == 0 ) {
+        gtk_widget_set_sensitive( GTK_WIDGET(user_data), FALSE);
+    }
+    else {
+        gtk_widget_set_sensitive( GTK_WIDGET(user_data), TRUE);
+    }
+}
+
+/*
+ * Shows a dialog with a single entry like:
+ * 
+ *      Name: [     ] 
+ *
+ *      [Cancel] [OK]
+ *
+ */
+gchar* 
+nwamui_util_rename_dialog_run(GtkWindow* parent_window, const gchar* title, const gchar* current_name) 
+{
+    static GtkWidget*   dialog = NULL;
+    static GtkWidget*   entry  = NULL;
+    static GtkWidget*   ok_btn  = NULL;
+    
+    gint                response;
+    gchar*              outstr;
+
+    g_assert( title != NULL && current_name != NULL );
+
+    g_return_val_if_fail( (title != NULL && current_name != NULL), NULL );
+
+    if ( dialog == NULL ) {
+        dialog = nwamui_util_glade_get_widget(NWAM_ENVIRONMENT_RENAME);
+        entry = nwamui_util_glade_get_widget(RENAME_ENVIRONMENT_ENTRY);
+        ok_btn = nwamui_util_glade_get_widget(RENAME_ENVIRONMENT_OK_BTN);
+    }
+
+    if (parent_window != NULL) {
+        gtk_window_set_transient_for (GTK_WINDOW(dialog), parent_window);
+        gtk_window_set_modal (GTK_WINDOW(dialog), TRUE);
+    }
+    else {
+        gtk_window_set_transient_for (GTK_WINDOW(dialog), NULL);
+        gtk_window_set_modal (GTK_WINDOW(dialog), FALSE);
+    }
+
+    gtk_window_set_title(GTK_WINDOW(dialog), title );
+    g_signal_connect(G_OBJECT(entry), "changed", G_CALLBACK(disable_widget_if_empty), (gpointer)ok_btn );
+    gtk_entry_set_text(GTK_ENTRY(entry), current_name );
+
+    gtk_widget_show_all(dialog);
+    response = gtk_dialog_run( GTK_DIALOG(dialog) );
+
+    switch( response ) {
+       case GTK_RESPONSE_OK:
+           outstr = g_strdup(gtk_entry_get_text( GTK_ENTRY(entry) ));
+           gtk_widget_hide_all(dialog);
+           return( outstr );
+       default:
+           gtk_widget_hide_all(dialog);
+           return( NULL );
+    }
+}
+
+extern gboolean
+nwamui_util_ask_yes_no(GtkWindow* parent_window, const gchar* title, const gchar* message) 
+{
+    GtkWidget*          message_dialog;
+    gint                response;
+    gchar*              outstr;
+
+    g_assert( message != NULL );
+
+    g_return_val_if_fail( message != NULL, FALSE );
+
+    message_dialog = gtk_message_dialog_new(parent_window, GTK_DIALOG_MODAL |GTK_DIALOG_DESTROY_WITH_PARENT,
+                                            GTK_MESSAGE_QUESTION, GTK_BUTTONS_YES_NO, message );
+    
+    if ( title != NULL ) {
+        gtk_window_set_title(GTK_WINDOW(message_dialog), title);
+    }
+    
+    gtk_message_dialog_format_secondary_text( GTK_MESSAGE_DIALOG(message_dialog), _("This operation cannot be undone.") );
+    
+    switch( gtk_dialog_run(GTK_DIALOG(message_dialog)) ) {
+        case GTK_RESPONSE_YES:
+            gtk_widget_destroy(message_dialog);
+            return( TRUE );
+        default:
+            gtk_widget_destroy(message_dialog);
+            return( FALSE );
+    }
+}
+
+static GdkCursor    *busy_cursor = NULL;
+
+extern void
+nwamui_util_set_busy_cursor( GtkWidget *widget )
+{
+    GdkWindow   *window = NULL;
+
+    if ( busy_cursor == NULL ) {
+        GdkDisplay *display = gtk_widget_get_display( widget );
+        if ( display != NULL ) {
+            busy_cursor = gdk_cursor_new_for_display( display, GDK_WATCH );
+        }
+    }
+
+    if ( widget != NULL ) {
+        window = gtk_widget_get_window( widget );
+    }
+
+    if ( window != NULL ) {
+        gdk_window_set_cursor( window, busy_cursor );
+    }
+    else if ( g_object_get_data(G_OBJECT(widget), "nwamui_signal_realize_id" ) == 0 ) {
+        /* Add a handler to do it when realized, but avoid duplicate addition! */
+        gulong signal_id = g_signal_connect( widget, "realize", (GCallback)nwamui_util_set_busy_cursor,  NULL );
+        g_object_set_data(G_OBJECT(widget), "nwamui_signal_realize_id", (gpointer)signal_id );
+    }
+}
+
+extern void
+nwamui_util_restore_default_cursor( GtkWidget *widget )
+{
+    GdkWindow   *window = NULL;
+    gulong       signal_id;
+
+    if ( widget != NULL ) {
+        window = gtk_widget_get_window( widget );
+    }
+
+    if ((signal_id = (gulong) g_object_get_data(G_OBJECT(widget),
+            "nwamui_signal_realize_id")) != 0) {
+        g_signal_handler_disconnect(widget, signal_id);
+        g_object_set_data(G_OBJECT(widget), "nwamui_signal_realize_id", 0);
+    }
+
+    if ( window != NULL ) {
+        gdk_window_set_cursor( window, NULL );
+    }
+}
+
+extern gboolean
+nwamui_util_confirm_removal(GtkWindow* parent_window, const gchar* title, const gchar* message) 
+{
+    GtkWidget          *message_dialog;
+    GtkWidget          *action_area;
+    gint                response;
+    gchar*              outstr;
+
+    g_assert( message != NULL );
+
+    g_return_val_if_fail( message != NULL, FALSE );
+
+    message_dialog = gtk_message_dialog_new(parent_window, GTK_DIALOG_MODAL |GTK_DIALOG_DESTROY_WITH_PARENT,
+                                            GTK_MESSAGE_QUESTION, GTK_BUTTONS_OK_CANCEL, message );
+    
+    if ( title != NULL ) {
+        gtk_window_set_title(GTK_WINDOW(message_dialog), title);
+    }
+    
+    gtk_message_dialog_format_secondary_text( GTK_MESSAGE_DIALOG(message_dialog), _("This operation cannot be undone.") );
+    
+    /* Change OK to be Remove button */
+    if ( (action_area = gtk_dialog_get_action_area( GTK_DIALOG(message_dialog) )) != NULL ) {
+        GList*  buttons = gtk_container_get_children( GTK_CONTAINER( action_area ) );
+
+        for ( GList *elem = buttons; buttons != NULL; elem = g_list_next(elem) ) {
+            if ( GTK_IS_BUTTON( elem->data ) ) {
+                const gchar* label = gtk_button_get_label( GTK_BUTTON( elem->data ) );
+                if ( label != NULL && strcmp( label, GTK_STOCK_OK )  == 0 ) {
+                    gtk_button_set_label( GTK_BUTTON( elem->data ), GTK_STOCK_REMOVE );
+                    break;
+                }
+            }
+        }
+
+        g_list_free( buttons );
+    }
+    switch( gtk_dialog_run(GTK_DIALOG(message_dialog)) ) {
+        case GTK_RESPONSE_OK:
+            gtk_widget_destroy(message_dialog);
+            return( TRUE );
+        default:
+            gtk_widget_destroy(message_dialog);
+            return( FALSE );
+    }
+}
+
+extern gboolean
+nwamui_util_ask_about_dup_obj(GtkWindow* parent_window, NwamuiObject* obj )
+{
+    GtkWidget          *message_dialog;
+    GtkWidget          *action_area;
+    gchar              *summary = NULL;
+    const gchar        *obj_name = NULL;
+    const gchar        *obj_type_caps;
+    const gchar        *obj_type_lower;
+    gint                response;
+    gchar*              outstr;
+
+    g_return_val_if_fail( NWAMUI_IS_OBJECT(obj), FALSE );
+
+    obj_name = nwamui_object_get_name( obj );
+
+    if ( NWAMUI_IS_ENV( obj ) ) {
+        obj_type_caps = _("Locations");
+        obj_type_lower = _("location");
+    } else if ( NWAMUI_IS_NCP( obj ) ) {
+        obj_type_caps = _("Profiles");
+        obj_type_lower = _("profile");
+    } else {
+        g_assert_not_reached();
+    }
+
+    summary = g_strdup_printf(_("Cannot rename '%s'"), obj_name?obj_name:"" );
+
+    message_dialog = gtk_message_dialog_new(parent_window, GTK_DIALOG_MODAL |GTK_DIALOG_DESTROY_WITH_PARENT,
+                                            GTK_MESSAGE_QUESTION, GTK_BUTTONS_OK_CANCEL, summary );
+
+    gtk_window_set_title(GTK_WINDOW(message_dialog), summary);
+
+    gtk_message_dialog_format_secondary_text( GTK_MESSAGE_DIALOG(message_dialog), 
+            _("%s can only be renamed immeditately\nafter they have been created. However, you\ncan duplicate this %s then immediately\nrename the duplicate."),
+            obj_type_caps, obj_type_lower);
+
+    /* Change OK to be Duplicate button */
+    if ( (action_area = gtk_dialog_get_action_area( GTK_DIALOG(message_dialog) )) != NULL ) {
+        GList*  buttons = gtk_container_get_children( GTK_CONTAINER( action_area ) );
+
+        for ( GList *elem = buttons; buttons != NULL; elem = g_list_next(elem) ) {
+            if ( GTK_IS_BUTTON( elem->data ) ) {
+                const gchar* label = gtk_button_get_label( GTK_BUTTON( elem->data ) );
+                if ( label != NULL && strcmp( label, GTK_STOCK_OK )  == 0 ) {
+                    gtk_button_set_label( GTK_BUTTON( elem->data ), _("_Duplicate") );
+                    break;
+                }
+            }
+        }
+
+        g_list_free( buttons );
+    }
+
+    g_free( summary );
+
+    switch( gtk_dialog_run(GTK_DIALOG(message_dialog)) ) {
+        case GTK_RESPONSE_OK:
+            gtk_widget_destroy(message_dialog);
+            return( TRUE );
+        default:
+            gtk_widget_destroy(message_dialog);
+            return( FALSE );
+    }
+}
+
+extern void
+nwamui_util_show_message(GtkWindow* parent_window, GtkMessageType type, const gchar* title, const gchar* message, gboolean block )
+{
+    GtkWidget*          message_dialog;
+    gint                response;
+    gchar*              outstr;
+
+    g_assert( message != NULL );
+    
+    g_assert( type != GTK_MESSAGE_QUESTION ); /* Should use nwamui_util_ask_yes_no() for this type */
+
+    g_return_if_fail( message != NULL );
+
+    message_dialog = gtk_message_dialog_new(parent_window, GTK_DIALOG_MODAL |GTK_DIALOG_DESTROY_WITH_PARENT,
+                                            type, GTK_BUTTONS_CLOSE, message );
+    
+    if ( title != NULL ) {
+        gtk_window_set_title(GTK_WINDOW(message_dialog), title);
+    }
+    
+    /* Ensure dialog is destroryed when user closes it */
+    g_signal_connect_swapped (message_dialog, "response", G_CALLBACK (gtk_widget_destroy), message_dialog);
+    
+    if ( block ) {
+       (void)gtk_dialog_run(GTK_DIALOG(message_dialog));
+    }
+    else {
+        gtk_widget_show( GTK_WIDGET(g_object_ref(message_dialog)) );
+    }
+
+}
+
+extern void
+nwamui_util_set_a11y_label_for_widget(  GtkLabel       *label,
+                                        GtkWidget      *widget )
+{
+    AtkObject       *atk_widget, *atk_label;
+    AtkRelationSet  *relation_set;
+    AtkRelation     *relation;
+    AtkObject       *targets[1];
+
+    atk_widget = gtk_widget_get_accessible(widget);
+    atk_label = gtk_widget_get_accessible (GTK_WIDGET(label));
+
+    relation_set = atk_object_ref_relation_set (atk_label);
+
+    targets[0] = atk_widget;
+    relation = atk_relation_new(targets,1, ATK_RELATION_LABEL_FOR);
+
+    atk_relation_set_add(relation_set,relation);
+
+    g_object_unref(G_OBJECT(relation));
+}
+
+extern void
+nwamui_util_set_widget_a11y_info(   GtkWidget      *widget, 
+                                    const gchar    *name,
+                                    const gchar    *description )
+{
+    AtkObject *obj;
+
+    g_return_if_fail( widget != NULL && GTK_IS_WIDGET(widget) );
+
+    obj = gtk_widget_get_accessible(widget);
+
+    if ( obj ) {
+        if ( name != NULL ) {
+            atk_object_set_name(obj, name );
+        }
+        if ( description != NULL ) {
+            atk_object_set_description(obj, description);
+        }
+    }
+}
+
+/* Rows of the completion popup of SMF FMRIs. */
+#define SMF_FMRI_COMPLETION_MAX_ROWS    (200)
+
+static void
+add_smf_fmri( gpointer data, gpointer user_data )
+{
+    gchar          *name = (gchar*)data;
+    GtkListStore   *lstore = GTK_LIST_STORE(user_data);
+    GtkTreeIter     iter;
+
+    gtk_list_store_append( lstore, &iter );
+    gtk_list_store_set( lstore, &iter, 0, name, -1 );
+}
+
+/*
+ * The model of the completion only holds the matches of the current text,
+ * as answered by the FMRI index, so every row matches.
+ */
+static gboolean
+partial_smf_completion_func(GtkEntryCompletion *completion,
+                            const gchar *key,
+                            GtkTreeIter *iter,
+                            gpointer user_data)
+{
+    return( TRUE );
+}
+
+static void
+smf_fmri_completion_refill( GtkEntry *entry )
+{
+    GtkEntryCompletion *completion = gtk_entry_get_completion( entry );
+    GtkListStore       *lstore;
+    const gchar        *key;
+
+    if ( completion == NULL ) {
+        return;
+    }
+
+    lstore = GTK_LIST_STORE(gtk_entry_completion_get_model( completion ));
+    key = gtk_entry_get_text( entry );
+
+    gtk_list_store_clear( lstore );
+    if ( strlen(key) >= gtk_entry_completion_get_minimum_key_length( completion ) ) {
+        nwamui_fmri_index_lookup( key, FALSE, SMF_FMRI_COMPLETION_MAX_ROWS, add_smf_fmri, lstore );
+    }
+}
+
+/* Connected before the completion is set, so it runs before it refilters. */
+static void
+smf_fmri_entry_changed( GtkEditable *editable, gpointer user_data )
+{
+    smf_fmri_completion_refill( GTK_ENTRY(editable) );
+}
+
+static gboolean
+smf_fmri_index_ready( gpointer data )
+{
+    GtkEntry *entry = GTK_ENTRY(data);
+
+    smf_fmri_completion_refill( entry );
+    if ( GTK_WIDGET_HAS_FOCUS(entry) ) {
+        gtk_entry_completion_complete( gtk_entry_get_completion( entry ) );
+    }
+    return( FALSE );
+}
+
+/* 
+ * Utility function to attach an FNRI completion support to a GtkEntry.
+ *
+ * The FMRIs come from the shared index, which is built in the background the
+ * first time.
+ */
+extern gboolean
+nwamui_util_set_entry_smf_fmri_completion( GtkEntry* entry )
+{
+    GtkEntryCompletion     *completion = NULL;
+    GtkListStore           *fmri_model = NULL;
+
+    if ( entry == NULL || !GTK_IS_ENTRY( entry ) ) {
+        return( FALSE );
+    }
+
+    fmri_model = gtk_list_store_new( 1, G_TYPE_STRING );
+
+    g_signal_connect( entry, "changed", G_CALLBACK(smf_fmri_entry_changed), NULL );
+
+    completion = gtk_entry_completion_new();
+
+    gtk_entry_completion_set_model( completion, GTK_TREE_MODEL(fmri_model) );
+    gtk_entry_completion_set_minimum_key_length( completion, 3 );
+    gtk_entry_completion_set_text_column( completion, 0 );
+    gtk_entry_completion_set_inline_completion( completion, FALSE );
+    gtk_entry_completion_set_match_func( completion, partial_smf_completion_func, NULL, NULL );
+    gtk_entry_set_completion( entry, completion );
+
+    g_object_unref( fmri_model );
+    g_object_unref( completion );
+
+    nwamui_fmri_index_build_async( smf_fmri_index_ready, g_object_ref(entry), g_object_unref );
+
+    return( TRUE );
+}
+
+static void
+insert_entry_valid_text_handler (GtkEditable *editable,
+                             const gchar *text,
+                             gint         length,
+                             gint        *position,
+                             gpointer     data)
+{
+    gboolean    is_v4;
+    gboolean    is_v6;
+    gboolean    is_prefix_only;
+    gboolean    is_ethers;
+    gboolean    allow_list;
+    gboolean    allow_prefix;
+    gboolean    is_valid = TRUE;
+    gchar      *lower = g_ascii_strdown(text, length);
+    nwamui_entry_validation_flags_t  flags;
+
+    flags = (gboolean)g_object_get_data( G_OBJECT(editable), "validation_flags" );
+
+    is_v4 = (flags & NWAMUI_ENTRY_VALIDATION_IS_V4);
+    is_v6 = (flags & NWAMUI_ENTRY_VALIDATION_IS_V6);
+    is_prefix_only = (flags & NWAMUI_ENTRY_VALIDATION_IS_PREFIX_ONLY);
+    is_ethers = (flags & NWAMUI_ENTRY_VALIDATION_IS_ETHERS);
+    allow_list = (flags & NWAMUI_ENTRY_VALIDATION_ALLOW_LIST);
+    allow_prefix = (flags & NWAMUI_ENTRY_VALIDATION_ALLOW_PREFIX);
+
+    for ( int i = 0; i < length && is_valid; i++ ) {
+        if ( allow_list && (text[i] == ',' || text[i] == ' ') ) {
+            /* Allow comma-separated list mode to be entered */
+            is_valid = TRUE;
+        }
+        else if ( allow_prefix && (text[i] == '/' ) ) {
+            /* Allow comma-separated list mode to be entered */
+            is_valid = TRUE;
+        }
+        else if ( is_v6 ) {
+            if ( is_prefix_only ) {
+                /* Valid chars for v6 prefix are ASCII [0-9] */
+                is_valid = g_ascii_isdigit( lower[i] );
+            }
+            else {
+                /* Valid chars for v6 are ASCII [0-9a-f:.] */
+                is_valid = (g_ascii_isxdigit( lower[i] ) || text[i] == ':' || text[i] == '.' );   
+            }
+        }
+        else if ( is_v4 ) { /* Also handles is_prefix_only for IPv4 subnet */
+            /* Valid chars for v4 are ASCII [0-9.] */
+            is_valid = (g_ascii_isdigit( lower[i] ) || text[i] == '.' );   
+        }
+        else if ( is_ethers ) {
+            /* Valid chars for ethers are ASCII [0-9a-f:] */
+            is_valid = (g_ascii_isxdigit( lower[i] ) || text[i] == ':' );
+        }
+    }
+    
+    if ( is_valid ) {
+        g_signal_handlers_block_by_func (editable,
+                       (gpointer) insert_entry_valid_text_handler, data);
+
+        gtk_editable_insert_text (editable, lower, length, position);
+        g_signal_handlers_unblock_by_func (editable,
+                                         (gpointer) insert_entry_valid_text_handler, data);
+    }
+    g_signal_stop_emission_by_name (editable, "insert_text");
+    g_free (lower);
+}
+
+/* Validate a text entry
+ * 
+ * If show_error_dialog is TRUE, then a message dialog will be shown to the
+ * user.
+ *
+ * Returns whether the entry was valid or not.
+ */
+extern gboolean
+nwamui_util_validate_text_entry(    GtkWidget           *widget,
+                                    const gchar         *text,
+                                    nwamui_entry_validation_flags_t  flags,
+                                    gboolean            show_error_dialog,
+                                    gboolean            show_error_dialog_blocks )
+{
+    struct lifreq           lifr;
+    struct sockaddr_in     *sin = (struct sockaddr_in *)&lifr.lifr_addr;
+    struct sockaddr_in6    *sin6 = (struct sockaddr_in6 *)&lifr.lifr_addr;
+    GtkWindow              *top_level = NULL;
+    gboolean                is_v4 = (flags & NWAMUI_ENTRY_VALIDATION_IS_V4);
+    gboolean                is_v6 = (flags & NWAMUI_ENTRY_VALIDATION_IS_V6);
+    gboolean                is_prefix_only = (flags & NWAMUI_ENTRY_VALIDATION_IS_PREFIX_ONLY);
+    gboolean                is_ethers = (flags & NWAMUI_ENTRY_VALIDATION_IS_ETHERS);
+    gboolean                allow_list = (flags & NWAMUI_ENTRY_VALIDATION_ALLOW_LIST);
+    gboolean                allow_prefix = (flags & NWAMUI_ENTRY_VALIDATION_ALLOW_PREFIX);
+    gboolean                allow_empty = (flags & NWAMUI_ENTRY_VALIDATION_ALLOW_EMPTY);
+    gboolean                is_valid = TRUE;
+    gchar                  *error_string = NULL;
+
+    if ( widget != NULL ) {
+        top_level = GTK_WINDOW(gtk_widget_get_toplevel(widget));
+    }
+
+    if ( (widget != NULL && !GTK_WIDGET_IS_SENSITIVE(widget)) ||
+         (top_level != NULL && !gtk_window_has_toplevel_focus (top_level)) ) {
+        /* Assume valid */
+        return( TRUE );;
+    }
+
+    if ( text == NULL || strlen (text) == 0 ) {
+        if ( !allow_empty ) {
+            is_valid = FALSE;
+            error_string = g_strdup(_("Empty values are not permitted"));
+        }
+    }
+    else if ( allow_list ) {
+        /* Split list and call self recursively */
+        nwamui_entry_validation_flags_t     no_list_flags;
+        gchar                             **entries = NULL;
+
+        no_list_flags = flags & (~ NWAMUI_ENTRY_VALIDATION_ALLOW_LIST); /* Turn off allow list flag */
+        entries = g_strsplit_set(text, ", ", 0 );
+
+        for( int i = 0; entries && entries[i] != NULL; i++ ) {
+            /* Skip blank entries caused by combination of comma and space */
+            if ( strlen( entries[i] ) == 0 ) {
+                continue;
+            }
+            if ( ! nwamui_util_validate_text_entry( widget, entries[i], no_list_flags, FALSE, FALSE) ) {
+                error_string = g_strdup_printf(_("The value '%s' is invalid."), entries[i] );
+                gtk_widget_grab_focus( widget );
+                is_valid = FALSE;
+                break;
+            }
+        }
+        if ( entries ) {
+            g_strfreev( entries );
+        }
+    }
+    else { /* Not list and not empty */
+        gchar **strs =  NULL;
+
+        /* Allow for address in format "addr/prefix" */
+        strs = g_strsplit(text, "/", 2 );
+
+        if ( strs == NULL || strs[0] == NULL ) {
+            is_valid = FALSE;
+        }
+        else if ( !allow_prefix && strs[1] != NULL ) {
+            /* Prefix found, but it's not allowed here */
+            is_valid = FALSE;
+            error_string = g_strdup(_("Specifying a network prefix value is not permitted in this context."));
+        }
+        else {
+            if ( is_prefix_only ) { /* Need to check first since can conflict with IPv4/6 flag */
+                if ( is_v4 )  {
+                    if ( ! inet_pton ( AF_INET, strs[0], (void*)(&sin->sin_addr) ) ) {
+                        is_valid = FALSE;
+                        error_string = g_strdup_printf(_("The value '%s' is not a valid IPv4 subnet."), strs[0] );
+                    }
+                }
+                else if ( is_v6 ) {
+                    gchar *endptr;
+                    gint64 prefix = g_ascii_strtoll( strs[0], &endptr, 10 );
+                    if ( *endptr != '\0' || prefix == 0 || prefix > 128 ) {
+                        is_valid = FALSE;
+                        error_string = g_strdup_printf(_("The value '%s' is not a valid IPv6 network prefix."), strs[0] );
+                    }
+                }
+            }
+            else if ( is_ethers ) {
+                struct ether_addr *ether = ether_aton( strs[0] );
+                if ( ether == NULL ) {
+                    is_valid = FALSE;
+                    error_string = g_strdup_printf(_("The value '%s' is not a valid ethernet address."), strs[0] );
+                }
+            }
+            else {  /* Is either V4 ot V6 address, could allow either, so need to check both */
+                if ( is_v4 ) {
+                    /* Validate an IPv4 Address */
+                    if ( ! inet_pton ( AF_INET, strs[0], (void*)(&sin->sin_addr) ) ) {
+                        is_valid = FALSE;
+                        error_string = g_strdup_printf(_("The value '%s' is not a valid IPv4 address."), strs[0] );
+                    }
+                    if ( is_valid && strs[1] != NULL ) { /* Handle /N */
+                        gint64 prefix = g_ascii_strtoll( strs[1], NULL, 10 );
+                        if ( prefix == 0 || prefix > 32 ) {
+                            is_valid = FALSE;
+                            error_string = g_strdup_printf(_("The value '%s' is not a valid IPv4 network prefix."), strs[1] );
+                        }
+                    }
+                }
+                /* Only check v6 if we've not checked v4 address or we have
+                 * checked the v4 address and it's not valid.
+                 */
+                if ( is_v6 && (!is_v4 || (is_v4 && !is_valid)) ) {
+                    /* Validate an IPv6 Address */
+                    if ( ! inet_pton ( AF_INET6, strs[0], (void*)(&sin6->sin6_addr) ) ) {
+                        is_valid = FALSE;
+                        if ( is_v4 ) {
+                            error_string = g_strdup_printf(_("The value '%s' is not a valid IPv4 or IPv6 address."), strs[0] );
+                        }
+                        else {
+                            error_string = g_strdup_printf(_("The value '%s' is not a valid IPv6 address."), strs[0] );
+                        }
+                    }
+                    else {
+                        is_valid = TRUE; /* Need to reset since could have been set to FALSE by v4 check */
+                    }
+                    if ( is_valid && strs[1] != NULL ) { /* Handle /N */
+                        gchar *endptr;
+                        gint64 prefix = g_ascii_strtoll( strs[1], &endptr, 10 );
+                        if ( *endptr != '\0' || prefix == 0 || prefix > 128 ) {
+                            is_valid = FALSE;
+                            error_string = g_strdup_printf(_("The value '%s' is not a valid IPv6 network prefix."), strs[1] );
+                        }
+                    }
+                }
+            }
+        }
+        if ( strs != NULL) {
+            g_strfreev( strs );
+        }
+    }
+
+    if ( ! is_valid && show_error_dialog ) {
+        GString*        message_str;
+
+        if ( error_string != NULL ) {
+            message_str = g_string_new(error_string);
+            g_string_append(message_str, "\n\n");
+        }
+        else {
+            message_str = g_string_new("");
+        }
+
+        if ( is_prefix_only ) {
+            if ( is_v6 ) {
+                g_string_append( message_str, _("IPv6 prefix length must be a decimal value between 1 and 128\n\n"));
+            }
+            else {
+                g_string_append( message_str, _("Subnets must be in the format:\n\n    w.x.y.z\n\n"));
+            }
+        }
+        else if ( is_ethers ) {
+            g_string_append( message_str, _("Valid ethernet addresses or BSSIDs must be in the format:\n\n    xx:xx:xx:xx:xx:xx:xx:xx\n\n"));
+        }
+        else {
+            if ( is_v4 ) {
+                g_string_append( message_str,_("IPv4 addresses must be in the format:\n\n    w.x.y.z\n\n"));
+                if ( allow_prefix ) {
+                    g_string_append( message_str, _("If specifying a network prefix, you may append /N to the address:\n\n    w.x.y.z/N\n\nwhere N is between 1 and 32\n\n"));
+                }
+            }
+            if ( is_v6 ) {
+                g_string_append( message_str,_("IPv6 addresses must be in one of the formats :\n\n   x:x:x:x:x:x:x:x\n   x:x::x, etc.\n\n"));
+
+                if ( allow_prefix ) {
+                    g_string_append( message_str, _("If specifying a network prefix, you may append /N to the address:\n\n   x:x:x:x:x:x:x:x\n   x:x:x:x:x:x:x:x/N\n\nwhere N is between 1 and 128\n\n"));
+                }
+            }
+        }
+
+        if ( message_str != NULL ) {
+            if ( allow_list ) {
+                g_string_append(message_str, "You may also specify a list by separating entries using a comma (,) or space ( )");
+            }
+            nwamui_util_show_message(GTK_WINDOW(top_level), 
+                                     GTK_MESSAGE_ERROR, _("Invalid Value"), message_str->str, show_error_dialog_blocks);
+
+            g_string_free( message_str, TRUE );
+        }
+    }
+
+    if ( error_string != NULL ) {
+        g_free( error_string );
+    }
+
+    return( is_valid );
+}
+
+static gboolean
+validate_text_entry_on_focus_exit(GtkWidget     *widget,
+                          GdkEventFocus *event,
+                          gpointer       data)
+{
+    gboolean                is_valid = TRUE;
+    GtkWindow              *top_level = GTK_WINDOW(gtk_widget_get_toplevel(widget));
+    const gchar            *text_str;
+    nwamui_entry_validation_flags_t     
+                            validation_flags;
+
+    validation_flags = (gboolean)g_object_get_data( G_OBJECT(widget), "validation_flags" );
+
+    if ( !GTK_WIDGET_IS_SENSITIVE(widget) || !gtk_window_has_toplevel_focus (top_level)) {
+        /* If not sensitive, do nothing, since user can't edit it */
+        return(FALSE);
+    }
+
+    g_signal_handlers_block_by_func (widget,
+                   (gpointer) validate_text_entry_on_focus_exit, data);
+
+    text_str = gtk_entry_get_text(GTK_ENTRY(widget));
+
+    if ( ! nwamui_util_validate_text_entry( widget, text_str, validation_flags, TRUE, FALSE) ) {
+        gtk_widget_grab_focus( widget );
+    }
+
+    g_signal_handlers_unblock_by_func (widget,
+                   (gpointer) validate_text_entry_on_focus_exit, data);
+
+    return(FALSE); /* Must return FALSE since GtkEntry expects it */
+}
+
+/* 
+ * Utility function to attach an insert-text handler to a GtkEntry to limit
+ * it's input to be characters acceptable to a valid IP address format.
+ */
+extern void
+nwamui_util_set_entry_validation(   GtkEntry                        *entry, 
+                                    nwamui_entry_validation_flags_t  flags,
+                                    gboolean                         validate_on_focus_out )
+{
+    if ( entry != NULL ) {
+        g_object_set_data( G_OBJECT(entry), "validation_flags", (gpointer)flags );
+
+        g_signal_connect(G_OBJECT(entry), "insert_text", 
+                         (GCallback)insert_entry_valid_text_handler, NULL);
+        if ( validate_on_focus_out ) {
+            g_signal_connect(G_OBJECT(entry), "focus-out-event", 
+                             (GCallback)validate_text_entry_on_focus_exit, NULL);
+        }
+    }
+}
+
+/*
+ * Change the flags set when checking ip address.
+ */
+extern void
+nwamui_util_set_entry_validation_flags(  GtkEntry                        *entry, 
+                                         nwamui_entry_validation_flags_t  flags )
+{
+    if ( entry != NULL ) {
+        g_object_set_data( G_OBJECT(entry), "validation_flags", (gpointer)flags );
+    }
+}
+
+extern void
+nwamui_util_unset_entry_validation( GtkEntry* entry )
+{
+    if ( entry != NULL ) {
+        g_signal_handlers_disconnect_by_func( G_OBJECT(entry), (gpointer)insert_entry_valid_text_handler, NULL );
+        g_signal_handlers_disconnect_by_func( G_OBJECT(entry), (gpointer)validate_text_entry_on_focus_exit, NULL );
+    }
+}
+
+
+extern void
+nwamui_util_window_title_append_hostname( GtkDialog* dialog )
+{
+    const gchar    *current_title = NULL;
+    gchar           hostname[MAXHOSTNAMELEN+1];
+    gchar          *new_title = NULL;
+
+    if ( dialog == NULL || !GTK_WINDOW(dialog)) {
+        return;
+    }
+    if ( gethostname(hostname, MAXHOSTNAMELEN) != 0 ) {
+        g_debug("gethostname returned error: %s", strerror( errno ) );
+        return;
+    }
+
+    hostname[MAXHOSTNAMELEN] = '\0'; /* Just in case */
+
+    current_title = gtk_window_get_title( GTK_WINDOW(dialog) );
+
+    new_title = g_strdup_printf(_("%s (%s)"), current_title?current_title:" ", hostname);
+
+    gtk_window_set_title( GTK_WINDOW(dialog), new_title );
+
+    g_debug("Setting Window title: %s", new_title?new_title:"NULL" );
+
+    g_free( new_title );
+}
+
+extern void
+nwamui_util_foreach_nwam_object_add_to_list_store(gpointer object, gpointer list_store)
+{
+    GtkTreeIter   iter;
+    NwamuiObject* obj = NWAMUI_OBJECT(object);
+    
+    gtk_list_store_append(GTK_LIST_STORE(list_store), &iter);
+    gtk_list_store_set(GTK_LIST_STORE(list_store), &iter, 0, obj, -1);
+}
+
+static gboolean
+capplet_tree_model_foreach(GtkTreeModel *model,
+  GtkTreePath *path,
+  GtkTreeIter *iter,
+  gpointer user_data)
+{
+	CappletForeachData *data = (CappletForeachData *)user_data;
+
+    if (data->foreach_func(model, path, iter, data->user_data)) {
+        *(GtkTreeIter *)data->user_data1 = *iter;
+        /* flag */
+        data->ret_data = data->user_data1;
+        return TRUE;
+    }
+	return FALSE;
+}
+
+static gboolean
+capplet_model_foreach_find_object(GtkTreeModel *model,
+    GtkTreePath *path,
+    GtkTreeIter *iter,
+    gpointer user_data)
+{
+	CappletForeachData *data = (CappletForeachData *)user_data;
+	GObject *object;
+
+    gtk_tree_model_get( GTK_TREE_MODEL(model), iter, 0, &object, -1);
+
+    if (object == data->user_data) {
+        /* Fill in passed GtkTreeIter */
+        *(GtkTreeIter *)data->user_data1 = *iter;
+        /* return value now */
+        data->ret_data = data->user_data1;
+    }
+
+	if (object)
+		g_object_unref(object);
+
+	return data->ret_data != NULL;
+}
+
+/*
+ * Object to row index of a GtkListStore or GtkTreeStore, attached on the
+ * first lookup so that finding an object no longer walks the model. Both
+ * stores have persistent iters, so each object maps to the iters of the rows
+ * holding it. Rows set through the model signals are added as they come, a
+ * row found to hold another object is dropped on lookup. A row removed by
+ * capplet_model_remove_row() is forgotten right away, any other removal
+ * marks the index dirty and it is rebuilt on the next lookup.
+ */
+#define CAPPLET_MODEL_INDEX_KEY "capplet_model_index"
+
+typedef struct {
+    GHashTable  *rows;          /* GObject* -> GSList of GtkTreeIter* */
+    gboolean     dirty;
+    gboolean     expect_delete;
+} CappletModelIndex;
+
+static void
+capplet_model_index_rows_free(gpointer data)
+{
+    GSList *rows = (GSList *)data;
+
+    g_slist_foreach(rows, (GFunc)gtk_tree_iter_free, NULL);
+    g_slist_free(rows);
+}
+
+static void
+capplet_model_index_free(gpointer data)
+{
+    CappletModelIndex *index = (CappletModelIndex *)data;
+
+    g_hash_table_destroy(index->rows);
+    g_free(index);
+}
+
+static void
+capplet_model_index_add(CappletModelIndex *index, GtkTreeModel *model, GtkTreeIter *iter)
+{
+    GObject *object;
+    GSList  *rows;
+    GSList  *i;
+
+    gtk_tree_model_get(model, iter, 0, &object, -1);
+    if (object == NULL)
+        return;
+
+    rows = g_hash_table_lookup(index->rows, object);
+    for (i = rows; i; i = i->next) {
+        if (((GtkTreeIter *)i->data)->user_data == iter->user_data)
+            break;
+    }
+    if (i == NULL) {
+        /* The list head is the hash value, steal before prepending. */
+        g_hash_table_steal(index->rows, object);
+        g_hash_table_insert(index->rows, object, g_slist_prepend(rows, gtk_tree_iter_copy(iter)));
+    }
+    g_object_unref(object);
+}
+
+static void
+capplet_model_index_forget(CappletModelIndex *index, GtkTreeModel *model, GtkTreeIter *iter)
+{
+    GObject     *object;
+    GSList      *rows;
+    GSList      *i;
+    GtkTreeIter  child;
+    gboolean     valid;
+
+    /* A removed tree store row takes its children along. */
+    for (valid = gtk_tree_model_iter_children(model, &child, iter);
+         valid;
+         valid = gtk_tree_model_iter_next(model, &child)) {
+        capplet_model_index_forget(index, model, &child);
+    }
+
+    gtk_tree_model_get(model, iter, 0, &object, -1);
+    if (object == NULL)
+        return;
+
+    rows = g_hash_table_lookup(index->rows, object);
+    for (i = rows; i; i = i->next) {
+        if (((GtkTreeIter *)i->data)->user_data == iter->user_data) {
+            gtk_tree_iter_free((GtkTreeIter *)i->data);
+            g_hash_table_steal(index->rows, object);
+            rows = g_slist_delete_link(rows, i);
+            if (rows)
+                g_hash_table_insert(index->rows, object, rows);
+            break;
+        }
+    }
+    g_object_unref(object);
+}
+
+static gboolean
+capplet_model_index_foreach_add(GtkTreeModel *model,
+    GtkTreePath *path,
+    GtkTreeIter *iter,
+    gpointer user_data)
+{
+    capplet_model_index_add((CappletModelIndex *)user_data, model, iter);
+    return FALSE;
+}
+
+static void
+capplet_model_index_row_changed(GtkTreeModel *model,
+    GtkTreePath *path,
+    GtkTreeIter *iter,
+    gpointer user_data)
+{
+    CappletModelIndex *index = (CappletModelIndex *)user_data;
+
+    if (!index->dirty)
+        capplet_model_index_add(index, model, iter);
+}
+
+static void
+capplet_model_index_row_deleted(GtkTreeModel *model,
+    GtkTreePath *path,
+    gpointer user_data)
+{
+    CappletModelIndex *index = (CappletModelIndex *)user_data;
+
+    /* Can't tell which object went away, start over on the next lookup. */
+    if (!index->expect_delete)
+        index->dirty = TRUE;
+}
+
+static CappletModelIndex *
+capplet_model_get_index(GtkTreeModel *model)
+{
+    CappletModelIndex *index;
+
+    index = g_object_get_data(G_OBJECT(model), CAPPLET_MODEL_INDEX_KEY);
+
+    if (index == NULL) {
+        if (!(GTK_IS_LIST_STORE(model) || GTK_IS_TREE_STORE(model)) ||
+          !g_type_is_a(gtk_tree_model_get_column_type(model, 0), G_TYPE_OBJECT))
+            return NULL;
+
+        index = g_new0(CappletModelIndex, 1);
+        index->rows = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+          NULL, capplet_model_index_rows_free);
+        index->dirty = TRUE;
+        g_object_set_data_full(G_OBJECT(model), CAPPLET_MODEL_INDEX_KEY,
+          index, capplet_model_index_free);
+
+        /* Insert with values doesn't emit row-changed. */
+        g_signal_connect(model, "row-inserted",
+          G_CALLBACK(capplet_model_index_row_changed), index);
+        g_signal_connect(model, "row-changed",
+          G_CALLBACK(capplet_model_index_row_changed), index);
+        g_signal_connect(model, "row-deleted",
+          G_CALLBACK(capplet_model_index_row_deleted), index);
+    }
+
+    if (index->dirty) {
+        g_hash_table_remove_all(index->rows);
+        index->dirty = FALSE;
+        gtk_tree_model_foreach(model, capplet_model_index_foreach_add, index);
+    }
+    return index;
+}
+
+/*
+ * Find a row holding @object whose parent is @parent, or any row if
+ * @any_parent. Stale rows are dropped on the way. Like the walk of the model
+ * it replaces, the first matching row in the model order is returned, not
+ * the last one indexed.
+ */
+static gboolean
+capplet_model_index_lookup(CappletModelIndex *index, GtkTreeModel *model,
+    GObject *object, gboolean any_parent, GtkTreeIter *parent, GtkTreeIter *iter)
+{
+    GSList      *rows;
+    GSList      *i;
+    GSList      *next;
+    GtkTreePath *found_path = NULL;
+    GtkTreePath *path;
+    gboolean     found = FALSE;
+    gboolean     match;
+
+    rows = g_hash_table_lookup(index->rows, object);
+    g_hash_table_steal(index->rows, object);
+
+    for (i = rows; i; i = next) {
+        GtkTreeIter *row = (GtkTreeIter *)i->data;
+        GObject     *row_object;
+        GtkTreeIter  row_parent;
+
+        next = i->next;
+        gtk_tree_model_get(model, row, 0, &row_object, -1);
+        if (row_object)
+            g_object_unref(row_object);
+
+        if (row_object != object) {
+            gtk_tree_iter_free(row);
+            rows = g_slist_delete_link(rows, i);
+            continue;
+        }
+
+        if (any_parent)
+            match = TRUE;
+        else if (gtk_tree_model_iter_parent(model, &row_parent, row))
+            match = (parent != NULL && row_parent.user_data == parent->user_data);
+        else
+            match = (parent == NULL);
+
+        if (!match)
+            continue;
+
+        /* Paths are only compared for an object held by several rows. */
+        if (!found) {
+            *iter = *row;
+            found = TRUE;
+        } else {
+            if (found_path == NULL)
+                found_path = gtk_tree_model_get_path(model, iter);
+            path = gtk_tree_model_get_path(model, row);
+            if (gtk_tree_path_compare(path, found_path) < 0) {
+                *iter = *row;
+                gtk_tree_path_free(found_path);
+                found_path = path;
+            } else {
+                gtk_tree_path_free(path);
+            }
+        }
+    }
+
+    if (found_path)
+        gtk_tree_path_free(found_path);
+
+    if (rows)
+        g_hash_table_insert(index->rows, object, rows);
+
+    return found;
+}
+
+/*
+ * capplet_model_remove_row:
+ * @iter: row to remove from the list or tree store
+ *
+ * Remove the row keeping the object index of the model, if any, up to date.
+ * Returns like gtk_list_store_remove().
+ */
+extern gboolean
+capplet_model_remove_row(GtkTreeModel *model, GtkTreeIter *iter)
+{
+    CappletModelIndex *index;
+    gboolean           ret;
+
+    index = g_object_get_data(G_OBJECT(model), CAPPLET_MODEL_INDEX_KEY);
+    if (index != NULL && !index->dirty) {
+        capplet_model_index_forget(index, model, iter);
+        index->expect_delete = TRUE;
+    }
+
+    if (GTK_IS_LIST_STORE(model))
+        ret = gtk_list_store_remove(GTK_LIST_STORE(model), iter);
+    else
+        ret = gtk_tree_store_remove(GTK_TREE_STORE(model), iter);
+
+    if (index != NULL)
+        index->expect_delete = FALSE;
+
+    return ret;
+}
+
+/*
+ * capplet_model_find_object:
+ * @object: Could be null
+ * @iter: output var
+ * 
+ * Find the position of the @object, return its iterator.
+ */
+extern gboolean
+capplet_model_find_object(GtkTreeModel *model, GObject *object, GtkTreeIter *iter)
+{
+	CappletForeachData data;
+	CappletModelIndex *index;
+	GtkTreeIter temp_iter;
+
+    if (object != NULL && (index = capplet_model_get_index(model)) != NULL) {
+        return capplet_model_index_lookup(index, model, object, TRUE, NULL,
+          iter != NULL ? iter : &temp_iter);
+    }
+
+	data.user_data = (gpointer)object;
+    if (iter != NULL) {
+        data.user_data1 = (gpointer)iter;
+    } else {
+        data.user_data1 = &temp_iter;
+    }
+	data.ret_data = NULL;
+
+	gtk_tree_model_foreach(model, capplet_model_foreach_find_object,
+      (gpointer)&data);
+
+	return data.ret_data != NULL;
+}
+
+/*
+ * capplet_model_find_object:
+ * @object: Could be null
+ * @iter: output var
+ * 
+ * Find the position of the @object, return its iterator.
+ */
+extern gboolean
+capplet_model_find_object_with_parent(GtkTreeModel *model, GtkTreeIter *parent, GObject *object, GtkTreeIter *iter)
+{
+	CappletForeachData data;
+	CappletModelIndex *index;
+	GtkTreeIter temp_iter;
+    GtkTreeIter i;
+    gboolean valid;
+
+    if (object != NULL && (index = capplet_model_get_index(model)) != NULL) {
+        return capplet_model_index_lookup(index, model, object, FALSE, parent,
+          iter != NULL ? iter : &temp_iter);
+    }
+
+	data.user_data = (gpointer)object;
+    if (iter != NULL) {
+        data.user_data1 = (gpointer)iter;
+    } else {
+        data.user_data1 = &temp_iter;
+    }
+	data.ret_data = NULL;
+
+    for (valid = gtk_tree_model_iter_children(model, &i, parent);
+         valid;
+         valid = gtk_tree_model_iter_next(model, &i)) {
+        if (capplet_model_foreach_find_object(model, NULL, &i, (gpointer)&data))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/*
+ * capplet_model_find_object:
+ * @object: Could be null
+ * @iter: output var
+ *
+ * Customize foreach function by @fun and @user_data, find the correct position,
+ * return its iterator.
+ */
+extern gboolean
+capplet_model_foreach(GtkTreeModel *model, GtkTreeModelForeachFunc func, gpointer user_data, GtkTreeIter *iter)
+{
+	CappletForeachData data;
+	GtkTreeIter temp_iter;
+
+    data.foreach_func = func;
+	data.user_data = user_data;
+    if (iter != NULL) {
+        data.user_data1 = (gpointer)iter;
+    } else {
+        data.user_data1 = &temp_iter;
+    }
+	data.ret_data = NULL;
+
+	gtk_tree_model_foreach(model, capplet_tree_model_foreach, (gpointer)&data);
+
+	return data.ret_data != NULL;
+}
+
+/*
+ * capplet_model_find_object:
+ * @object: Could be null
+ * @iter: output var
+ *
+ * Customize foreach function by @fun and @user_data, find the correct position,
+ * return its iterator.
+ */
+extern gboolean
+capplet_model_1_level_foreach(GtkTreeModel *model, GtkTreeIter *parent, GtkTreeModelForeachFunc func, gpointer user_data, GtkTreeIter *iter)
+{
+    gboolean valid;
+	GtkTreeIter temp_iter;
+	GtkTreePath *path = NULL;
+
+    if (parent) {
+        path = gtk_tree_model_get_path(model, parent);
+    } else {
+        path = gtk_tree_path_new_first();
+    }
+
+    if (iter == NULL)
+        iter = &temp_iter;
+
+    for (valid = gtk_tree_model_iter_children(model, iter, parent), gtk_tree_path_down(path);
+         valid;
+         valid = gtk_tree_model_iter_next(model, iter), gtk_tree_path_next(path)) {
+        if (func(model, path, iter, user_data))
+            break;
+    }
+    gtk_tree_path_free(path);
+    return valid;
+}
+
+extern void
+debug_response_id( gint responseid ) 
+{
+    g_debug("Dialog returned response : %d ", responseid );
+    switch (responseid) {
+    case GTK_RESPONSE_NONE:
+        g_debug("GTK_RESPONSE_NONE");
+        break;
+    case GTK_RESPONSE_REJECT:
+        g_debug("GTK_RESPONSE_REJECT");
+        break;
+    case GTK_RESPONSE_ACCEPT:
+        g_debug("GTK_RESPONSE_ACCEPT");
+        break;
+    case GTK_RESPONSE_DELETE_EVENT:
+        g_debug("GTK_RESPONSE_DELETE_EVENT");
+        break;
+    case GTK_RESPONSE_OK:
+        g_debug("GTK_RESPONSE_OK");
+        break;
+    case GTK_RESPONSE_CANCEL:
+        g_debug("GTK_RESPONSE_CANCEL");
+        break;
+    case GTK_RESPONSE_CLOSE:
+        g_debug("GTK_RESPONSE_CLOSE");
+        break;
+    case GTK_RESPONSE_YES:
+        g_debug("GTK_RESPONSE_YES");
+        break;
+    case GTK_RESPONSE_NO:
+        g_debug("GTK_RESPONSE_NO");
+        break;
+    case GTK_RESPONSE_APPLY:
+        g_debug("GTK_RESPONSE_APPLY");
+        break;
+    case GTK_RESPONSE_HELP:
+        g_debug("GTK_RESPONSE_HELP");
+        break;
+    }
+}
@@ -0,0 +1,153 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_gtk.h
+ *
+ */
+
+#ifndef _NWAMUI_GTK_H
+#define	_NWAMUI_GTK_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/* UI (GtkBuilder) Handling */
+typedef enum {
+    NWAMUI_UI_FILE_DEFAULT = 0,
+    NWAMUI_UI_FILE_WIRELESS,
+    NWAMUI_UI_FILE_LAST,
+}
+nwamui_ui_file_index_t;
+
+typedef struct _CappletForeachData {
+	GtkTreeModelForeachFunc foreach_func;
+	gpointer user_data;
+	gpointer user_data1;
+	gpointer ret_data;
+} CappletForeachData;
+
+extern GtkWidget*               nwamui_util_ui_get_widget_from( nwamui_ui_file_index_t  index,  
+                                                                const gchar*            widget_name );
+
+extern void                     nwamui_util_ui_set_load_on_demand( gboolean on_demand );
+
+/*
+ * (The glade name is kept for code compatibility, for now)
+ */
+#define nwamui_util_glade_get_widget( x )   nwamui_util_ui_get_widget_from(NWAMUI_UI_FILE_DEFAULT, (x))
+
+extern GdkPixbuf*               nwamui_util_get_network_status_icon(nwamui_ncu_type_t ncu_type, nwamui_wifi_signal_strength_t strength, nwamui_daemon_status_t net_status, gint size);
+
+extern GdkPixbuf*               nwamui_util_get_ncu_status_icon( NwamuiNcu* ncu, gint size );
+
+extern const gchar*             nwamui_util_get_ncu_group_icon( NwamuiNcu* ncu  );
+
+extern const gchar*             nwamui_util_get_active_mode_icon( NwamuiObject *object  );
+
+extern GdkPixbuf*               nwamui_util_get_network_type_icon( nwamui_ncu_type_t ncu_type );
+
+extern GdkPixbuf*               nwamui_util_get_env_status_icon( GtkStatusIcon* status_icon, nwamui_daemon_status_t daemon_status, gint force_size );
+
+extern GdkPixbuf*               nwamui_util_get_wireless_strength_icon_with_size( nwamui_wifi_signal_strength_t signal_strength, 
+                                                                                  nwamui_wireless_icon_type_t icon_type,
+                                                                                  gint size);
+
+extern GdkPixbuf*               nwamui_util_get_network_security_icon( nwamui_wifi_security_t sec_type,
+                                                                        gboolean small);
+
+extern void                     nwamui_util_show_help( const gchar* link_name );
+
+extern gchar*                   nwamui_util_rename_dialog_run(GtkWindow* parent_window, const gchar* title, const gchar* current_name);
+
+extern gboolean                 nwamui_util_ask_yes_no(GtkWindow* parent_window, const gchar* title, const gchar* message);
+
+extern gboolean                 nwamui_util_confirm_removal(GtkWindow* parent_window, const gchar* title, const gchar* message);
+
+extern gboolean                 nwamui_util_ask_about_dup_obj(GtkWindow* parent_window, NwamuiObject* obj );
+
+extern void                     nwamui_util_show_message(   GtkWindow* parent_window, 
+                                                            GtkMessageType type, 
+                                                            const gchar* title, 
+                                                            const gchar* message, 
+                                                            gboolean block );
+
+extern void                     nwamui_util_set_busy_cursor( GtkWidget *widget );
+
+extern void                     nwamui_util_restore_default_cursor( GtkWidget *widget );
+
+extern void nwamui_util_set_widget_a11y_info(   GtkWidget      *widget, 
+                                                const gchar    *name,
+                                                const gchar    *description );
+
+extern void nwamui_util_set_a11y_label_for_widget(  GtkLabel       *label,
+                                                    GtkWidget      *widget );
+
+extern gboolean                 nwamui_util_set_entry_smf_fmri_completion( GtkEntry* entry );
+
+extern void                     nwamui_util_set_entry_validation(   GtkEntry*           entry, 
+                                                                    nwamui_entry_validation_flags_t  flags,
+                                                                    gboolean            validate_on_focus_out );
+
+extern gboolean                 nwamui_util_validate_text_entry(    GtkWidget           *widget,
+                                                                    const gchar         *text,
+                                                                    nwamui_entry_validation_flags_t  flags,
+                                                                    gboolean            show_error_dialog,
+                                                                    gboolean            show_error_dialog_blocks );
+
+extern void                     nwamui_util_set_entry_validation_flags(  GtkEntry* entry, 
+                                                                         nwamui_entry_validation_flags_t  flags );
+
+extern void                     nwamui_util_unset_entry_validation( GtkEntry* entry );
+
+extern gboolean                 nwamui_util_validate_text_entry(    GtkWidget           *widget,
+                                                                    const gchar         *text,
+                                                                    nwamui_entry_validation_flags_t  flags,
+                                                                    gboolean            show_error_dialog,
+                                                                    gboolean            show_error_dialog_blocks );
+
+extern void                     nwamui_util_window_title_append_hostname( GtkDialog* dialog );
+
+extern void                     nwamui_util_foreach_nwam_object_add_to_list_store(gpointer object, gpointer list_store);
+
+gboolean capplet_model_find_object(GtkTreeModel *model, GObject *object, GtkTreeIter *iter);
+
+gboolean capplet_model_find_object_with_parent(GtkTreeModel *model, GtkTreeIter *parent, GObject *object, GtkTreeIter *iter);
+
+gboolean capplet_model_remove_row(GtkTreeModel *model, GtkTreeIter *iter);
+
+gboolean capplet_model_foreach(GtkTreeModel *model, GtkTreeModelForeachFunc func, gpointer user_data, GtkTreeIter *iter);
+
+gboolean capplet_model_1_level_foreach(GtkTreeModel *model, GtkTreeIter *parent, GtkTreeModelForeachFunc func, gpointer user_data, GtkTreeIter *iter);
+
+extern void debug_response_id( gint responseid );
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_GTK_H */
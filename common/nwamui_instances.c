@@ -0,0 +1,445 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_instances.c
+ *
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "libnwamui.h"
+
+/* Sites of references remembered per instance of a ref type. */
+#define MAX_REF_SITES       (16)
+
+typedef struct {
+    GType           type;
+    guint           live;
+    guint           high_water;
+    guint           logged_high_water;
+    guint64         created;
+    guint64         finalized;
+} type_stats_t;
+
+typedef struct {
+    const gchar    *where;
+    guint           count;
+} ref_site_t;
+
+typedef struct {
+    GType           type;
+    const gchar    *created_at;
+    guint           n_sites;
+    ref_site_t      sites[MAX_REF_SITES];
+    guint           other_refs;     /* Taken at sites beyond MAX_REF_SITES */
+} instance_info_t;
+
+static GStaticMutex instances_mutex = G_STATIC_MUTEX_INIT;
+static GHashTable  *type_stats = NULL;      /* GType -> type_stats_t*, never freed */
+static GHashTable  *ref_types = NULL;       /* Type names */
+static GHashTable  *ref_instances = NULL;   /* GObject* -> instance_info_t* */
+static guint        log_id = 0;
+
+static GQuark
+tracked_quark(void)
+{
+    static GQuark quark = 0;
+
+    if (G_UNLIKELY(quark == 0)) {
+        quark = g_quark_from_static_string("nwamui-instances-tracked");
+    }
+    return quark;
+}
+
+static type_stats_t*
+type_stats_get_locked(GType type)
+{
+    type_stats_t *stats;
+
+    if (type_stats == NULL) {
+        type_stats = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+    if ((stats = g_hash_table_lookup(type_stats, GSIZE_TO_POINTER(type))) == NULL) {
+        stats = g_new0(type_stats_t, 1);
+        stats->type = type;
+        g_hash_table_insert(type_stats, GSIZE_TO_POINTER(type), stats);
+    }
+    return stats;
+}
+
+/* A type, or one of its ancestors, was named by nwamui_instances_set_ref_types(). */
+static gboolean
+is_ref_type_locked(GType type)
+{
+    if (ref_types == NULL) {
+        return FALSE;
+    }
+    for (; type != 0; type = g_type_parent(type)) {
+        if (g_hash_table_lookup(ref_types, g_type_name(type)) != NULL) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void
+instance_finalized(gpointer data, GObject *where_the_object_was)
+{
+    type_stats_t *stats = (type_stats_t *)data;
+
+    g_static_mutex_lock(&instances_mutex);
+    stats->live--;
+    stats->finalized++;
+    if (ref_instances != NULL) {
+        g_hash_table_remove(ref_instances, where_the_object_was);
+    }
+    g_static_mutex_unlock(&instances_mutex);
+}
+
+/**
+ * nwamui_instances_track_at:
+ * @object: a #GObject.
+ * @where: where it is tracked, a string literal.
+ *
+ * Count @object in the live instances of its type until it is finalized.
+ * Tracking an object more than once has no effect, so both a base class
+ * and a creation site may track the same instance.
+ **/
+extern void
+nwamui_instances_track_at(GObject *object, const gchar *where)
+{
+    type_stats_t    *stats;
+    instance_info_t *info;
+
+    g_return_if_fail(G_IS_OBJECT(object));
+
+    if (g_object_get_qdata(object, tracked_quark()) != NULL) {
+        return;
+    }
+
+    g_static_mutex_lock(&instances_mutex);
+    stats = type_stats_get_locked(G_OBJECT_TYPE(object));
+    stats->live++;
+    stats->created++;
+    if (stats->live > stats->high_water) {
+        stats->high_water = stats->live;
+    }
+    if (is_ref_type_locked(stats->type)) {
+        if (ref_instances == NULL) {
+            ref_instances = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+        }
+        info = g_new0(instance_info_t, 1);
+        info->type = stats->type;
+        info->created_at = where;
+        g_hash_table_insert(ref_instances, object, info);
+    }
+    g_static_mutex_unlock(&instances_mutex);
+
+    g_object_set_qdata(object, tracked_quark(), stats);
+    g_object_weak_ref(object, instance_finalized, stats);
+}
+
+/**
+ * nwamui_instances_ref_at:
+ * @object: a #GObject.
+ * @where: where the reference is taken, a string literal.
+ *
+ * g_object_ref() which remembers @where for instances of the ref types.
+ *
+ * @returns: @object
+ **/
+extern gpointer
+nwamui_instances_ref_at(GObject *object, const gchar *where)
+{
+    instance_info_t *info;
+    guint            i;
+
+    g_return_val_if_fail(G_IS_OBJECT(object), NULL);
+
+    g_object_ref(object);
+
+    g_static_mutex_lock(&instances_mutex);
+    if (ref_instances != NULL &&
+      (info = g_hash_table_lookup(ref_instances, object)) != NULL) {
+        for (i = 0; i < info->n_sites; i++) {
+            if (strcmp(info->sites[i].where, where) == 0) {
+                break;
+            }
+        }
+        if (i < info->n_sites) {
+            info->sites[i].count++;
+        } else if (info->n_sites < MAX_REF_SITES) {
+            info->sites[info->n_sites].where = where;
+            info->sites[info->n_sites].count = 1;
+            info->n_sites++;
+        } else {
+            info->other_refs++;
+        }
+    }
+    g_static_mutex_unlock(&instances_mutex);
+
+    return object;
+}
+
+/**
+ * nwamui_instances_set_ref_types:
+ * @type_names: comma separated type names, e.g. "NwamuiWifiNet,NwamMenuItem",
+ * or NULL for none.
+ *
+ * Remember where the instances of these types, and of their subclasses,
+ * are created and referenced. Only instances tracked from now on are
+ * covered.
+ **/
+extern void
+nwamui_instances_set_ref_types(const gchar *type_names)
+{
+    gchar **names;
+
+    g_static_mutex_lock(&instances_mutex);
+    if (ref_types != NULL) {
+        g_hash_table_destroy(ref_types);
+        ref_types = NULL;
+    }
+    if (type_names != NULL && *type_names != '\0') {
+        ref_types = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        names = g_strsplit(type_names, ",", 0);
+        for (gint i = 0; names[i] != NULL; i++) {
+            g_strstrip(names[i]);
+            if (*names[i] != '\0') {
+                g_hash_table_insert(ref_types, g_strdup(names[i]), GINT_TO_POINTER(TRUE));
+            }
+        }
+        g_strfreev(names);
+    }
+    g_static_mutex_unlock(&instances_mutex);
+}
+
+/**
+ * nwamui_instances_get_stats:
+ * @type: a #GType.
+ * @live: (out) instances alive.
+ * @high_water: (out) most instances ever alive at once.
+ * @created: (out) instances tracked.
+ * @finalized: (out) instances finalized.
+ *
+ * Gets the counters of @type, all zero if it was never tracked.
+ **/
+extern void
+nwamui_instances_get_stats(GType type,
+  guint *live,
+  guint *high_water,
+  guint64 *created,
+  guint64 *finalized)
+{
+    type_stats_t   *stats = NULL;
+
+    g_static_mutex_lock(&instances_mutex);
+    if (type_stats != NULL) {
+        stats = g_hash_table_lookup(type_stats, GSIZE_TO_POINTER(type));
+    }
+    if (live) {
+        *live = stats ? stats->live : 0;
+    }
+    if (high_water) {
+        *high_water = stats ? stats->high_water : 0;
+    }
+    if (created) {
+        *created = stats ? stats->created : 0;
+    }
+    if (finalized) {
+        *finalized = stats ? stats->finalized : 0;
+    }
+    g_static_mutex_unlock(&instances_mutex);
+}
+
+static void
+copy_live_count(gpointer key, gpointer value, gpointer user_data)
+{
+    type_stats_t *stats = (type_stats_t *)value;
+
+    g_hash_table_insert((GHashTable *)user_data, (gpointer)g_type_name(stats->type),
+      GUINT_TO_POINTER(stats->live));
+}
+
+/**
+ * nwamui_instances_get_live_counts:
+ *
+ * @returns: a new #GHashTable of the live instances of every tracked type,
+ * by type name, to be compared with a later one. Free with
+ * g_hash_table_destroy().
+ **/
+extern GHashTable*
+nwamui_instances_get_live_counts(void)
+{
+    GHashTable *counts = g_hash_table_new(g_str_hash, g_str_equal);
+
+    g_static_mutex_lock(&instances_mutex);
+    if (type_stats != NULL) {
+        g_hash_table_foreach(type_stats, copy_live_count, counts);
+    }
+    g_static_mutex_unlock(&instances_mutex);
+
+    return counts;
+}
+
+static void
+collect_stats(gpointer key, gpointer value, gpointer user_data)
+{
+    GArray *array = (GArray *)user_data;
+
+    g_array_append_vals(array, value, 1);
+}
+
+static gint
+compare_stats_by_name(gconstpointer a, gconstpointer b)
+{
+    return strcmp(g_type_name(((const type_stats_t *)a)->type),
+      g_type_name(((const type_stats_t *)b)->type));
+}
+
+static void
+dump_instance(gpointer key, gpointer value, gpointer user_data)
+{
+    GObject         *object = (GObject *)key;
+    instance_info_t *info = (instance_info_t *)value;
+    GString         *out = (GString *)user_data;
+
+    /* Still alive, the weak reference would have removed it. */
+    g_string_append_printf(out, "  %s %p refs %u, created at %s\n",
+      g_type_name(info->type), (gpointer)object, object->ref_count, info->created_at);
+    for (guint i = 0; i < info->n_sites; i++) {
+        g_string_append_printf(out, "    %6u x ref at %s\n",
+          info->sites[i].count, info->sites[i].where);
+    }
+    if (info->other_refs > 0) {
+        g_string_append_printf(out, "    %6u x ref elsewhere\n", info->other_refs);
+    }
+}
+
+/**
+ * nwamui_instances_dump:
+ * @fd: file descriptor to write to.
+ *
+ * Write out the counters of every tracked type, then the instances of the
+ * ref types still alive with where they were created and referenced.
+ **/
+extern void
+nwamui_instances_dump(gint fd)
+{
+    GArray     *stats = g_array_new(FALSE, FALSE, sizeof (type_stats_t));
+    GString    *out = g_string_new(NULL);
+
+    g_static_mutex_lock(&instances_mutex);
+    if (type_stats != NULL) {
+        g_hash_table_foreach(type_stats, collect_stats, stats);
+    }
+    g_array_sort(stats, compare_stats_by_name);
+
+    g_string_append_printf(out, "--- %s: live instances ---\n", g_get_prgname());
+    g_string_append_printf(out, "%-32s %8s %8s %10s %10s\n",
+      "type", "live", "high", "created", "finalized");
+    for (guint i = 0; i < stats->len; i++) {
+        type_stats_t *s = &g_array_index(stats, type_stats_t, i);
+
+        g_string_append_printf(out, "%-32s %8u %8u %10" G_GUINT64_FORMAT " %10" G_GUINT64_FORMAT "\n",
+          g_type_name(s->type), s->live, s->high_water, s->created, s->finalized);
+    }
+    if (ref_instances != NULL && g_hash_table_size(ref_instances) > 0) {
+        g_string_append(out, "references:\n");
+        g_hash_table_foreach(ref_instances, dump_instance, out);
+    }
+    g_static_mutex_unlock(&instances_mutex);
+
+    g_string_append(out, "--- end of instances ---\n");
+
+    for (gsize off = 0; off < out->len; ) {
+        ssize_t n = write(fd, out->str + off, out->len - off);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        off += n;
+    }
+
+    g_string_free(out, TRUE);
+    g_array_free(stats, TRUE);
+}
+
+static void
+log_type_high_water(gpointer key, gpointer value, gpointer user_data)
+{
+    type_stats_t *stats = (type_stats_t *)value;
+
+    if (stats->high_water > stats->logged_high_water) {
+        nwamui_log_info(NWAMUI_LOG_CAT_MEM, "%s: high water %u (was %u), %u live",
+          g_type_name(stats->type), stats->high_water, stats->logged_high_water, stats->live);
+        stats->logged_high_water = stats->high_water;
+    }
+}
+
+static gboolean
+log_high_water(gpointer data)
+{
+    g_static_mutex_lock(&instances_mutex);
+    if (type_stats != NULL) {
+        g_hash_table_foreach(type_stats, log_type_high_water, NULL);
+    }
+    g_static_mutex_unlock(&instances_mutex);
+
+    return TRUE;
+}
+
+/**
+ * nwamui_instances_start_log:
+ * @interval_secs: how often to check.
+ *
+ * Log the types whose high water mark rose since the last check, in the
+ * "mem" log category.
+ **/
+extern void
+nwamui_instances_start_log(guint interval_secs)
+{
+    g_return_if_fail(interval_secs > 0);
+
+    nwamui_instances_stop_log();
+    log_id = nwamui_scheduler_add_seconds(interval_secs, log_high_water, NULL, NULL);
+}
+
+extern void
+nwamui_instances_stop_log(void)
+{
+    if (log_id != 0) {
+        nwamui_scheduler_remove(log_id);
+        log_id = 0;
+    }
+}
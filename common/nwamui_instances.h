@@ -0,0 +1,78 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_instances.h
+ *
+ */
+
+#ifndef _NWAMUI_INSTANCES_H
+#define	_NWAMUI_INSTANCES_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Accounting of the live instances of each tracked GType, to tell leaks
+ * from caches in a long running process. Objects are tracked once, with a
+ * weak reference, the NwamuiObject and NwamMenuItem constructors track
+ * every instance of their subclasses.
+ *
+ * For the types named in nwamui_instances_set_ref_types(), each instance
+ * also remembers where it was tracked and where nwamui_instances_ref()
+ * took references on it, which nwamui_instances_dump() lists for the
+ * instances still alive.
+ */
+
+#define nwamui_instances_track(_obj)    nwamui_instances_track_at(G_OBJECT(_obj), G_STRLOC)
+#define nwamui_instances_ref(_obj)      nwamui_instances_ref_at(G_OBJECT(_obj), G_STRLOC)
+
+extern void         nwamui_instances_track_at(GObject *object, const gchar *where);
+
+extern gpointer     nwamui_instances_ref_at(GObject *object, const gchar *where);
+
+extern void         nwamui_instances_set_ref_types(const gchar *type_names);
+
+extern void         nwamui_instances_get_stats(GType type,
+                                               guint *live,
+                                               guint *high_water,
+                                               guint64 *created,
+                                               guint64 *finalized);
+
+extern GHashTable*  nwamui_instances_get_live_counts(void);
+
+extern void         nwamui_instances_dump(gint fd);
+
+extern void         nwamui_instances_start_log(guint interval_secs);
+
+extern void         nwamui_instances_stop_log(void);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_INSTANCES_H */
@@ -51,6 +51,17 @@ struct _NwamuiKnownWlanPrivate {
 
 #define NWAMUI_KNOWN_WLAN_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE((o), NWAMUI_TYPE_KNOWN_WLAN, NwamuiKnownWlanPrivate))
 
+/* Spacing of the priorities when they have to be renumbered */
+#define PRIO_GAP                        (1024)
+
+typedef struct {
+    NwamuiKnownWlan    *wlan;
+    guint64             old_prio;
+    guint64             new_prio;
+    gboolean            old_modified;
+    gboolean            committed;
+} prio_slot_t;
+
 static void nwamui_known_wlan_set_property (  GObject         *object,
                                             guint            prop_id,
                                             const GValue    *value,
@@ -271,7 +282,11 @@ nwamui_known_wlan_get_property (GObject         *object,
     case PROP_PRIORITY: {
         guint64 rval = 0;
 
-        rval = get_nwam_known_wlan_uint64_prop( self->prv->known_wlan_h, NWAM_KNOWN_WLAN_PROP_PRIORITY );
+        if (nwamui_object_is_stand_in(NWAMUI_OBJECT(self))) {
+            rval = nwamui_object_get_stand_in_priority(NWAMUI_OBJECT(self));
+        } else {
+            rval = get_nwam_known_wlan_uint64_prop( self->prv->known_wlan_h, NWAM_KNOWN_WLAN_PROP_PRIORITY );
+        }
         g_value_set_uint64( value, rval );
     }
         break;
@@ -436,6 +451,200 @@ nwamui_known_wlan_new_with_handle(nwam_known_wlan_handle_t known_wlan)
     return object;
 }
 
+/*
+ * Mark the slots which can keep their priority: the longest strictly
+ * increasing run of the current priorities, found in O(n log n).
+ */
+static gboolean*
+prio_find_kept(const prio_slot_t *slots, guint n)
+{
+    guint      *tails = g_new(guint, n);   /* Last slot of the best run of length i + 1 */
+    guint      *prev = g_new(guint, n);
+    gboolean   *kept = g_new0(gboolean, n);
+    guint       len = 0;
+    guint       lo;
+    guint       hi;
+    guint       mid;
+    guint       i;
+
+    for (i = 0; i < n; i++) {
+        lo = 0;
+        hi = len;
+        while (lo < hi) {
+            mid = (lo + hi) / 2;
+            if (slots[tails[mid]].old_prio < slots[i].old_prio) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        prev[i] = (lo > 0) ? tails[lo - 1] : G_MAXUINT;
+        tails[lo] = i;
+        if (lo == len) {
+            len++;
+        }
+    }
+
+    for (i = (len > 0) ? tails[len - 1] : G_MAXUINT; i != G_MAXUINT; i = prev[i]) {
+        kept[i] = TRUE;
+    }
+
+    g_free(tails);
+    g_free(prev);
+    return kept;
+}
+
+/*
+ * Spread the slots which can't keep their priority over the gaps between
+ * the kept ones.
+ *
+ * @returns: FALSE if a gap is too small, everything has to be renumbered.
+ */
+static gboolean
+prio_fill_gaps(prio_slot_t *slots, guint n, const gboolean *kept)
+{
+    guint64     first = 0;      /* Lowest free priority of the current gap */
+    guint64     span;
+    guint       start;
+    guint       k;
+    guint       i = 0;
+    guint       j;
+
+    while (i < n) {
+        if (kept[i]) {
+            slots[i].new_prio = slots[i].old_prio;
+            first = slots[i].old_prio + 1;
+            i++;
+            continue;
+        }
+
+        for (start = i; i < n && !kept[i]; i++)
+            ;
+        k = i - start;
+
+        if (i == n) {
+            /* After the last kept slot nothing is in the way. */
+            if (first - 1 > G_MAXUINT64 - (guint64)PRIO_GAP * k) {
+                return FALSE;
+            }
+            for (j = 0; j < k; j++) {
+                slots[start + j].new_prio = first - 1 + (guint64)PRIO_GAP * (j + 1);
+            }
+        } else {
+            if (slots[i].old_prio < first || slots[i].old_prio - first < k) {
+                return FALSE;
+            }
+            span = slots[i].old_prio - first;
+            for (j = 0; j < k; j++) {
+                slots[start + j].new_prio = first + j + ((span - k) / (k + 1)) * (j + 1);
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+static void
+prio_slot_set(prio_slot_t *slot, guint64 prio)
+{
+    NwamuiKnownWlanPrivate *prv = slot->wlan->prv;
+
+    set_nwam_known_wlan_uint64_prop(prv->known_wlan_h, NWAM_KNOWN_WLAN_PROP_PRIORITY, prio);
+    g_object_notify(G_OBJECT(slot->wlan), "priority");
+}
+
+/**
+ * nwamui_known_wlan_reorder:
+ * @known_wlans: the #NwamuiKnownWlan in order of preference, most preferred
+ * first.
+ *
+ * Give the known WLANs priorities in the order of the list. Priorities are
+ * spaced, so moving one WLAN usually changes only its own priority, and
+ * the others are renumbered only when there is no room left between two
+ * neighbours. Only the WLANs whose priority changed are committed, in one
+ * pass; if a commit fails the ones already committed are put back, and any
+ * which can't be is read again, with the priority it was committed with.
+ *
+ * @returns: TRUE if all the changes were committed.
+ **/
+extern gboolean
+nwamui_known_wlan_reorder(GList *known_wlans)
+{
+    prio_slot_t    *slots;
+    gboolean       *kept;
+    GList          *idx;
+    guint           n = 0;
+    guint           n_changed = 0;
+    guint           i;
+    gboolean        rval = TRUE;
+
+    slots = g_new0(prio_slot_t, g_list_length(known_wlans));
+
+    for (idx = known_wlans; idx; idx = idx->next) {
+        if (!NWAMUI_IS_KNOWN_WLAN(idx->data)) {
+            continue;
+        }
+        slots[n].wlan = NWAMUI_KNOWN_WLAN(idx->data);
+        slots[n].old_prio = get_nwam_known_wlan_uint64_prop(slots[n].wlan->prv->known_wlan_h,
+          NWAM_KNOWN_WLAN_PROP_PRIORITY);
+        slots[n].old_modified = slots[n].wlan->prv->modified;
+        n++;
+    }
+
+    if (n == 0) {
+        g_free(slots);
+        return TRUE;
+    }
+
+    kept = prio_find_kept(slots, n);
+    if (!prio_fill_gaps(slots, n, kept)) {
+        nwamui_debug("No room between priorities, renumbering %u known WLANs", n);
+        for (i = 0; i < n; i++) {
+            slots[i].new_prio = (guint64)PRIO_GAP * i;
+        }
+    }
+    g_free(kept);
+
+    for (i = 0; i < n; i++) {
+        if (slots[i].new_prio != slots[i].old_prio) {
+            prio_slot_set(&slots[i], slots[i].new_prio);
+            slots[i].wlan->prv->modified = TRUE;
+            n_changed++;
+        }
+    }
+
+    for (i = 0; rval && i < n; i++) {
+        if (slots[i].new_prio != slots[i].old_prio) {
+            slots[i].committed = nwamui_object_commit(NWAMUI_OBJECT(slots[i].wlan));
+            rval = slots[i].committed;
+        }
+    }
+
+    if (!rval) {
+        for (i = 0; i < n; i++) {
+            if (slots[i].new_prio == slots[i].old_prio) {
+                continue;
+            }
+            prio_slot_set(&slots[i], slots[i].old_prio);
+            if (slots[i].committed) {
+                if (!nwamui_object_commit(NWAMUI_OBJECT(slots[i].wlan))) {
+                    /* Show the priority it kept in the configuration. */
+                    nwamui_warning("Failed to restore the priority of KnownWlan %s", slots[i].wlan->prv->essid);
+                    nwamui_object_reload(NWAMUI_OBJECT(slots[i].wlan));
+                }
+            } else {
+                slots[i].wlan->prv->modified = slots[i].old_modified;
+            }
+        }
+    }
+
+    nwamui_debug("%u of %u known WLANs changed priority, %s", n_changed, n,
+      rval ? "committed" : "rolled back");
+
+    g_free(slots);
+    return rval;
+}
+
 /** 
  * Compare WifiNet objects, returns values like strcmp().
  */
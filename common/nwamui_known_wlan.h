@@ -73,6 +73,8 @@ extern  void                        nwamui_known_wlan_update_from_wlan_t(NwamuiK
 
 extern  NwamuiObject*               nwamui_known_wlan_new_with_handle(nwam_known_wlan_handle_t known_wlan);
 
+extern  gboolean                    nwamui_known_wlan_reorder(GList *known_wlans);
+
 
 G_END_DECLS
         
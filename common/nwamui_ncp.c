@@ -31,8 +31,6 @@
 #include <glib-object.h>
 #include <glib/gi18n.h>
 #include <strings.h>
-#include <gtk/gtkliststore.h>
-#include <gtk/gtktreestore.h>
 
 #include "libnwamui.h"
 
@@ -46,7 +44,6 @@ static gint _num_wireless = 0; /* Count wireless i/fs */
 enum {
     PROP_PRIORITY_GROUP = 1,
     PROP_NCU_LIST,
-    PROP_NCU_LIST_STORE,
     PROP_ACTIVE_NCU,
     PROP_WIRELESS_LINK_NUM
 };
@@ -76,7 +73,6 @@ struct _NwamuiNcpPrivate {
     gint              wireless_link_num;
 
     GList*        ncu_list;
-    GtkListStore* ncu_list_store;
 
     GList* temp_list; /* Used to temporarily track not found objects in walkers */
 
@@ -117,10 +113,6 @@ static void          nwamui_object_real_remove(NwamuiObject *object, NwamuiObjec
 
 /* Callbacks */
 static int nwam_ncu_walker_cb (nwam_ncu_handle_t ncu, void *data);
-static void ncu_notify_cb( GObject *gobject, GParamSpec *arg1, gpointer data);
-static void row_deleted_cb (GtkTreeModel *tree_model, GtkTreePath *path, gpointer user_data);
-static void row_inserted_cb (GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer user_data);
-static void rows_reordered_cb(GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer arg3, gpointer user_data);
 
 /* GList callbacks */
 static gint find_ncu_by_device_name(gconstpointer data, gconstpointer user_data);
@@ -179,14 +171,6 @@ nwamui_ncp_class_init (NwamuiNcpClass *klass)
                                                           _("GList of NCUs in the NCP"),
                                                            G_PARAM_READABLE));
 
-    g_object_class_install_property (gobject_class,
-                                     PROP_NCU_LIST_STORE,
-                                     g_param_spec_object ("ncu_list_store",
-                                                          _("ListStore of NCUs in the NCP"),
-                                                          _("ListStore of NCUs in the NCP"),
-                                                          GTK_TYPE_LIST_STORE,
-                                                          G_PARAM_READABLE));
-
 
     g_object_class_install_property (gobject_class,
                                      PROP_WIRELESS_LINK_NUM,
@@ -222,12 +206,6 @@ nwamui_ncp_init ( NwamuiNcp *self)
         nwamui_debug("Error getting active priortiy group: %d (%s)", 
           nerr, nwam_strerror(nerr) );
     }
-
-    prv->ncu_list_store = gtk_list_store_new ( 1, NWAMUI_TYPE_NCU);
-
-    g_signal_connect(prv->ncu_list_store, "row_deleted", G_CALLBACK(row_deleted_cb), (gpointer)self);
-    g_signal_connect(prv->ncu_list_store, "row_inserted", G_CALLBACK(row_inserted_cb), (gpointer)self);
-    g_signal_connect(prv->ncu_list_store, "rows_reordered", G_CALLBACK(rows_reordered_cb), (gpointer)self);
 }
 
 static void
@@ -272,10 +250,6 @@ nwamui_ncp_get_property (   GObject         *object,
                 g_value_set_pointer( value, nwamui_util_copy_obj_list( self->prv->ncu_list ) );
             }
             break;
-        case PROP_NCU_LIST_STORE: {
-                g_value_set_object( value, self->prv->ncu_list_store );
-            }
-            break;
         case PROP_WIRELESS_LINK_NUM:
             g_value_set_int( value, nwamui_ncp_get_wireless_link_num(self));
             break;
@@ -295,11 +269,6 @@ nwamui_ncp_finalize (NwamuiNcp *self)
         nwamui_util_free_obj_list(self->prv->ncu_list);
     }
     
-    if ( self->prv->ncu_list_store != NULL ) {
-        gtk_list_store_clear(self->prv->ncu_list_store);
-        g_object_unref(self->prv->ncu_list_store);
-    }
-
     if ( self->prv->nwam_ncp != NULL ) {
         nwam_ncp_free( self->prv->nwam_ncp );
     }
@@ -450,7 +419,6 @@ nwamui_object_real_reload(NwamuiObject* object)
     g_return_if_fail(prv->nwam_ncp != NULL );
 
     g_object_freeze_notify(G_OBJECT(object));
-    g_object_freeze_notify(G_OBJECT(prv->ncu_list_store));
 
     prv->temp_list = g_list_copy(prv->ncu_list);
 
@@ -477,7 +445,6 @@ nwamui_object_real_reload(NwamuiObject* object)
         g_object_notify(G_OBJECT(object), "wireless_link_num" );
     }
 
-    g_object_thaw_notify(G_OBJECT(prv->ncu_list_store));
     g_object_thaw_notify(G_OBJECT(object));
 }
 
@@ -737,7 +704,9 @@ check_ncu_online( gpointer obj, gpointer user_data )
         online = TRUE;
     }
 
-    g_string_append_printf(info_p->report, " %s(%s),", nwamui_object_get_name(NWAMUI_OBJECT(ncu)), online?"ON":"OFF");
+    if (info_p->report) {
+        g_string_append_printf(info_p->report, " %s(%s),", nwamui_object_get_name(NWAMUI_OBJECT(ncu)), online?"ON":"OFF");
+    }
 
     switch (activation_mode) { 
         case NWAMUI_COND_ACTIVATION_MODE_MANUAL: {
@@ -835,11 +804,16 @@ nwamui_ncp_all_ncus_online (NwamuiNcp       *self,
         return( FALSE );
     }
 
-    info.report = g_string_new("");
-    g_string_append_printf(info.report, "NCP %s:", nwamui_object_get_name(NWAMUI_OBJECT(self)));
+    /* Only build the report if someone is going to read it. */
+    if (nwamui_log_enabled(NWAMUI_LOG_CAT_EVENT, NWAMUI_LOG_LEVEL_DEBUG)) {
+        info.report = g_string_new("");
+        g_string_append_printf(info.report, "NCP %s:", nwamui_object_get_name(NWAMUI_OBJECT(self)));
+    }
     g_list_foreach(self->prv->ncu_list, check_ncu_online, &info );
-    nwamui_debug("%s", info.report->str);
-    g_string_free(info.report, TRUE);
+    if (info.report) {
+        nwamui_log_debug(NWAMUI_LOG_CAT_EVENT, "%s", info.report->str);
+        g_string_free(info.report, TRUE);
+    }
 
     if ( info.num_manual_enabled != info.num_manual_online ) {
         all_online = FALSE;
@@ -898,30 +872,6 @@ nwamui_ncp_find_ncu( NwamuiNcp *self, GCompareFunc func, gconstpointer data)
         return g_list_find(self->prv->ncu_list, data);
 }
 
-/**
- * nwamui_ncp_get_ncu_list_store_store:
- * @returns: GList containing NwamuiNcu elements
- *
- **/
-extern GtkListStore*
-nwamui_ncp_get_ncu_list_store( NwamuiNcp *self )
-{
-    GtkListStore* ncu_list_store = NULL;
-    
-    if ( self == NULL ) {
-        return( NULL );
-    }
-
-    g_return_val_if_fail (NWAMUI_IS_NCP(self), ncu_list_store); 
-    
-    g_object_get (G_OBJECT (self),
-                  "ncu_list_store", &ncu_list_store,
-                  NULL);
-
-    return( ncu_list_store );
-}
-
-
 /**
  * nwamui_ncp_foreach_ncu
  * 
@@ -992,42 +942,26 @@ nwamui_object_real_remove(NwamuiObject *object, NwamuiObject *child)
 {
     NwamuiNcpPrivate *prv        = NWAMUI_NCP_GET_PRIVATE(object);
     NwamuiNcp        *self       = NWAMUI_NCP(object);
-    GtkTreeIter       iter;
-    gboolean          valid_iter = FALSE;
 
     g_return_if_fail (NWAMUI_IS_NCP(self) && NWAMUI_IS_NCU(child) );
 
-    g_object_freeze_notify(G_OBJECT(self));
-    g_object_freeze_notify(G_OBJECT(prv->ncu_list_store));
-
-    for (valid_iter = gtk_tree_model_get_iter_first( GTK_TREE_MODEL(prv->ncu_list_store), &iter);
-         valid_iter;
-         valid_iter = gtk_tree_model_iter_next( GTK_TREE_MODEL(prv->ncu_list_store), &iter)) {
-        NwamuiNcu      *_ncu;
-
-        gtk_tree_model_get( GTK_TREE_MODEL(prv->ncu_list_store), &iter, 0, &_ncu, -1);
-
-
-        if ( _ncu == (gpointer)child ) {
-            gtk_list_store_remove(GTK_LIST_STORE(prv->ncu_list_store), &iter);
+    if (!g_list_find(prv->ncu_list, child)) {
+        nwamui_warning("Not found '%s(0x%p)' in '%s'", nwamui_object_get_name(child), child, nwamui_object_get_name(object));
+        g_signal_stop_emission_by_name(object, "remove");
+        return;
+    }
 
-            if ( nwamui_ncu_get_ncu_type( _ncu ) == NWAMUI_NCU_TYPE_WIRELESS ) {
-                prv->wireless_link_num--;
-                g_object_notify(G_OBJECT(self), "wireless_link_num" );
-            }
+    g_object_freeze_notify(G_OBJECT(self));
 
-            g_object_notify(G_OBJECT(self), "ncu_list_store" );
-            g_object_unref(_ncu);
-            break;
-        }
-        g_object_unref(_ncu);
+    if ( nwamui_ncu_get_ncu_type(NWAMUI_NCU(child)) == NWAMUI_NCU_TYPE_WIRELESS ) {
+        prv->wireless_link_num--;
+        g_object_notify(G_OBJECT(self), "wireless_link_num" );
     }
 
     prv->ncu_list = g_list_remove(prv->ncu_list, child);
     g_debug("Remove '%s(0x%p)' from '%s'", nwamui_object_get_name(child), child, nwamui_object_get_name(object));
     g_object_unref(child);
 
-    g_object_thaw_notify(G_OBJECT(prv->ncu_list_store));
     g_object_thaw_notify(G_OBJECT(self));
 }
 
@@ -1036,8 +970,6 @@ nwamui_object_real_add(NwamuiObject *object, NwamuiObject *child)
 {
     NwamuiNcpPrivate *prv         = NWAMUI_NCP_GET_PRIVATE(object);
     NwamuiNcp        *self        = NWAMUI_NCP(object);
-    GtkTreeIter       iter;
-    gboolean          valid_iter  = FALSE;
 
     g_return_if_fail (NWAMUI_IS_NCP(self) && NWAMUI_IS_NCU(child) );
 
@@ -1048,7 +980,6 @@ nwamui_object_real_add(NwamuiObject *object, NwamuiObject *child)
     }
 
     g_object_freeze_notify(G_OBJECT(self));
-    g_object_freeze_notify(G_OBJECT(prv->ncu_list_store));
 
     if ( nwamui_ncu_get_ncu_type(NWAMUI_NCU(child)) == NWAMUI_NCU_TYPE_WIRELESS ) {
         prv->wireless_link_num++;
@@ -1059,14 +990,6 @@ nwamui_object_real_add(NwamuiObject *object, NwamuiObject *child)
     prv->ncu_list = g_list_insert_sorted(prv->ncu_list, g_object_ref(child), (GCompareFunc)nwamui_object_sort_by_name);
     g_debug("Add '%s(0x%p)' to '%s'", nwamui_object_get_name(child), child, nwamui_object_get_name(object));
 
-    gtk_list_store_append( prv->ncu_list_store, &iter );
-    gtk_list_store_set( prv->ncu_list_store, &iter, 0, child, -1 );
-
-    g_signal_connect(G_OBJECT(child), "notify",
-                     (GCallback)ncu_notify_cb, (gpointer)self);
-
-
-    g_object_thaw_notify(G_OBJECT(prv->ncu_list_store));
     g_object_thaw_notify(G_OBJECT(self));
 }
 
@@ -1220,7 +1143,6 @@ nwam_ncu_walker_cb (nwam_ncu_handle_t ncu, void *data)
     char*               name;
     nwam_error_t        nerr;
     NwamuiObject*       new_ncu;
-    GtkTreeIter         iter;
     NwamuiNcp*          ncp = NWAMUI_NCP(data);
     NwamuiNcpPrivate*   prv = ncp->prv;
     nwam_ncu_type_t     nwam_ncu_type;
@@ -1379,69 +1301,3 @@ nwamui_ncp_thaw_notify_ncus( NwamuiNcp* self )
     nwamui_ncp_foreach_ncu( self, (GFunc)freeze_thaw, (gpointer)FALSE );
 }
 
-/* Callbacks */
-
-static void
-ncu_notify_cb( GObject *gobject, GParamSpec *arg1, gpointer data)
-{
-    NwamuiNcp* self = NWAMUI_NCP(data);
-    GtkTreeIter     iter;
-    gboolean        valid_iter = FALSE;
-
-    for (valid_iter = gtk_tree_model_get_iter_first( GTK_TREE_MODEL(self->prv->ncu_list_store), &iter);
-         valid_iter;
-         valid_iter = gtk_tree_model_iter_next( GTK_TREE_MODEL(self->prv->ncu_list_store), &iter)) {
-        NwamuiNcu      *ncu;
-
-        gtk_tree_model_get( GTK_TREE_MODEL(self->prv->ncu_list_store), &iter, 0, &ncu, -1);
-
-        if ( (gpointer)ncu == (gpointer)gobject ) {
-            GtkTreePath *path;
-
-            valid_iter = FALSE;
-
-            path = gtk_tree_model_get_path(GTK_TREE_MODEL(self->prv->ncu_list_store),
-              &iter);
-            gtk_tree_model_row_changed(GTK_TREE_MODEL(self->prv->ncu_list_store),
-              path,
-              &iter);
-            gtk_tree_path_free(path);
-        }
-        if ( ncu )
-            g_object_unref(ncu);
-    }
-}
-
-static void
-row_deleted_cb (GtkTreeModel *model, GtkTreePath *path, gpointer user_data) 
-{
-    NwamuiNcp     *ncp = NWAMUI_NCP(user_data);
-
-    if ( model == GTK_TREE_MODEL(ncp->prv->ncu_list_store )) {
-        g_debug("NCU Removed from List, but not propagated.");
-    }
-}
-
-static void
-row_inserted_cb(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer user_data)
-{
-    NwamuiNcp     *ncp = NWAMUI_NCP(user_data);
-
-    if ( model == GTK_TREE_MODEL(ncp->prv->ncu_list_store )) {
-        g_debug("NCU Inserted in List, but not propagated.");
-    }
-}
-
-static void
-rows_reordered_cb(GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer arg3, gpointer user_data)   
-{
-    NwamuiNcp     *ncp = NWAMUI_NCP(user_data);
-    gchar         *path_str = gtk_tree_path_to_string(path);
-
-    g_debug("NwamuiNcp: NCU List: Rows Reordered: %s", path_str?path_str:"NULL");
-
-    if ( tree_model == GTK_TREE_MODEL(ncp->prv->ncu_list_store )) {
-        g_debug("NCU Re-ordered in List, but not propagated.");
-    }
-}
-
@@ -79,8 +79,6 @@ extern gint                     nwamui_ncp_get_ncu_num(NwamuiNcp *self);
 
 extern  GList*                  nwamui_ncp_find_ncu(NwamuiNcp *self, GCompareFunc func, gconstpointer data);
 
-extern	GtkListStore*           nwamui_ncp_get_ncu_list_store ( NwamuiNcp *self );
-
 extern  NwamuiObject*           nwamui_ncp_get_ncu_by_device_name( NwamuiNcp *self, const gchar* device_name );
 
 extern void                     nwamui_ncp_foreach_ncu(NwamuiNcp *self, GFunc func, gpointer user_data);
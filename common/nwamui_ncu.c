@@ -29,7 +29,6 @@
 
 #include <glib-object.h>
 #include <glib/gi18n.h>
-#include <gtk/gtkliststore.h>
 #include <strings.h>
 #include <string.h>
 #include <stdlib.h>
@@ -78,7 +77,7 @@ struct _NwamuiNcuPrivate {
         gboolean                        ipv4_active;
         gboolean                        ipv4_has_dhcp;
         NwamuiIp*                       ipv4_zero_ip;
-        GtkListStore*                   v4addresses;
+        GList*                          v4addresses;    /* Of NwamuiIp */
     GList *ipv4_acquired;       /* For the addresses of logical links */
         gboolean                        need_ipv4_dhcp;
 
@@ -86,7 +85,7 @@ struct _NwamuiNcuPrivate {
         gboolean                        ipv6_has_dhcp; 
         gboolean                        ipv6_has_auto_conf; 
         NwamuiIp*                       ipv6_zero_ip;
-        GtkListStore*                   v6addresses;
+        GList*                          v6addresses;    /* Of NwamuiIp */
     GList *ipv6_acquired;       /* For the addresses of logical links */
         gboolean                        need_ipv6_dhcp;
 
@@ -197,9 +196,6 @@ static void         nwamui_object_set_interface_nwam_state(NwamuiObject *object,
 
 /* Callbacks */
 static gint find_first_dhcp_address(gconstpointer a, gconstpointer b);
-static void ip_row_inserted_or_changed_cb (GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer user_data); 
-
-static void ip_row_deleted_cb (GtkTreeModel *tree_model, GtkTreePath *path, gpointer user_data);
 
 static void wireless_notify_cb(GObject *gobject, GParamSpec *arg1, gpointer user_data);
 
@@ -397,19 +393,17 @@ nwamui_ncu_class_init(NwamuiNcuClass *klass)
 
     g_object_class_install_property (gobject_class,
                                      PROP_V4ADDRESSES,
-                                     g_param_spec_object ("v4addresses",
-                                                          _("v4addresses"),
-                                                          _("v4addresses"),
-                                                          GTK_TYPE_LIST_STORE,
-                                                          G_PARAM_READWRITE));
+                                     g_param_spec_pointer ("v4addresses",
+                                                           _("GList of static IPv4 addresses"),
+                                                           _("GList of static IPv4 addresses"),
+                                                           G_PARAM_READWRITE));
 
     g_object_class_install_property (gobject_class,
                                      PROP_V6ADDRESSES,
-                                     g_param_spec_object ("v6addresses",
-                                                          _("v6addresses"),
-                                                          _("v6addresses"),
-                                                          GTK_TYPE_LIST_STORE,
-                                                          G_PARAM_READWRITE));
+                                     g_param_spec_pointer ("v6addresses",
+                                                           _("GList of static IPv6 addresses"),
+                                                           _("GList of static IPv6 addresses"),
+                                                           G_PARAM_READWRITE));
 
     g_object_class_install_property (gobject_class,
                                      PROP_WIFI_INFO,
@@ -451,11 +445,9 @@ nwamui_ncu_init(NwamuiNcu *self)
     prv->initialisation = TRUE;
 
     prv->ncu_type = NWAMUI_NCU_TYPE_WIRED;
-    prv->v4addresses = gtk_list_store_new ( 1, NWAMUI_TYPE_IP);
 
     prv->ipv6_has_dhcp = TRUE; /* Always assume present, since it is in Phase 1 */
     prv->ipv6_has_auto_conf = TRUE; /* Always assume present, since it is in Phase 1 */
-    prv->v6addresses = gtk_list_store_new ( 1, NWAMUI_TYPE_IP);
 
     prv->link_state = NWAM_STATE_UNINITIALIZED;
     prv->link_aux_state = NWAM_AUX_STATE_UNINITIALIZED;
@@ -479,12 +471,6 @@ nwamui_ncu_init(NwamuiNcu *self)
     
 
 /*     g_signal_connect(G_OBJECT(self), "notify", (GCallback)object_notify_cb, (gpointer)self); */
-    g_signal_connect(G_OBJECT(prv->v4addresses), "row-deleted", (GCallback)ip_row_deleted_cb, (gpointer)self);
-    g_signal_connect(G_OBJECT(prv->v4addresses), "row-changed", (GCallback)ip_row_inserted_or_changed_cb, (gpointer)self);
-    g_signal_connect(G_OBJECT(prv->v4addresses), "row-inserted", (GCallback)ip_row_inserted_or_changed_cb, (gpointer)self);
-    g_signal_connect(G_OBJECT(prv->v6addresses), "row-deleted", (GCallback)ip_row_deleted_cb, (gpointer)self);
-    g_signal_connect(G_OBJECT(prv->v6addresses), "row-changed", (GCallback)ip_row_inserted_or_changed_cb, (gpointer)self);
-    g_signal_connect(G_OBJECT(prv->v6addresses), "row-inserted", (GCallback)ip_row_inserted_or_changed_cb, (gpointer)self);
 }
 
 static void
@@ -605,13 +591,19 @@ nwamui_ncu_set_property ( GObject         *object,
             }
             break;
         case PROP_V4ADDRESSES: {
-                self->prv->v4addresses = GTK_LIST_STORE(g_value_dup_object( value ));
+                GList *old = self->prv->v4addresses;
+
+                self->prv->v4addresses = nwamui_util_copy_obj_list( (GList*)g_value_get_pointer( value ) );
+                nwamui_util_free_obj_list( old );
                 set_modified_flag( self, NWAM_NCU_CLASS_IP, TRUE );
             }
             break;
 
         case PROP_V6ADDRESSES: {
-                self->prv->v6addresses = GTK_LIST_STORE(g_value_dup_object( value ));
+                GList *old = self->prv->v6addresses;
+
+                self->prv->v6addresses = nwamui_util_copy_obj_list( (GList*)g_value_get_pointer( value ) );
+                nwamui_util_free_obj_list( old );
                 set_modified_flag( self, NWAM_NCU_CLASS_IP, TRUE );
             }
             break;
@@ -750,12 +742,12 @@ nwamui_ncu_get_property (GObject         *object,
             }
             break;
         case PROP_V4ADDRESSES: {
-                g_value_set_object( value, (gpointer)self->prv->v4addresses);
+                g_value_set_pointer( value, nwamui_util_copy_obj_list( self->prv->v4addresses ) );
             }
             break;
 
         case PROP_V6ADDRESSES: {
-                g_value_set_object( value, (gpointer)self->prv->v6addresses);
+                g_value_set_pointer( value, nwamui_util_copy_obj_list( self->prv->v6addresses ) );
             }
             break;
         case PROP_WIFI_INFO: {
@@ -900,14 +892,13 @@ populate_ip_ncu_data( NwamuiNcu *ncu, nwam_ncu_handle_t nwam_ncu )
                                                  NWAM_NCU_PROP_IP_VERSION, 
                                                  &ip_version_num );
 
-    g_object_freeze_notify(G_OBJECT(prv->v4addresses));
-    g_object_freeze_notify(G_OBJECT(prv->v6addresses));
-
     prv->ipv4_active = FALSE;
-    gtk_list_store_clear(prv->v4addresses);
+    nwamui_util_free_obj_list(prv->v4addresses);
+    prv->v4addresses = NULL;
 
     prv->ipv6_active = FALSE;
-    gtk_list_store_clear(prv->v6addresses);
+    nwamui_util_free_obj_list(prv->v6addresses);
+    prv->v6addresses = NULL;
 
     for ( int ip_n = 0; ip_n < ip_version_num; ip_n++ ) {
         if (ip_version[ip_n] == IPV4_VERSION) {
@@ -948,14 +939,8 @@ populate_ip_ncu_data( NwamuiNcu *ncu, nwam_ncu_handle_t nwam_ncu )
                         g_free(address);
                         g_free(subnet);
 
-                        GtkTreeIter iter;
-
-                        g_signal_handlers_block_by_func(G_OBJECT(prv->v4addresses), (gpointer)ip_row_inserted_or_changed_cb, (gpointer)ncu);
-                        gtk_list_store_insert(prv->v4addresses, &iter, 0 );
-                        gtk_list_store_set(prv->v4addresses, &iter, 0, ip, -1 );
-                        g_signal_handlers_unblock_by_func(G_OBJECT(prv->v4addresses), (gpointer)ip_row_inserted_or_changed_cb, (gpointer)ncu);
-
-                        g_object_unref(ip);
+                        /* Takes the reference of ip */
+                        prv->v4addresses = g_list_prepend(prv->v4addresses, ip);
 
                         /* Free up memory as we go */
                         g_free(*ptr);
@@ -1026,14 +1011,8 @@ populate_ip_ncu_data( NwamuiNcu *ncu, nwam_ncu_handle_t nwam_ncu )
                         g_free(address);
                         g_free(prefix);
 
-                        GtkTreeIter iter;
-
-                        g_signal_handlers_block_by_func(G_OBJECT(prv->v6addresses), (gpointer)ip_row_inserted_or_changed_cb, (gpointer)ncu);
-                        gtk_list_store_insert(prv->v6addresses, &iter, 0 );
-                        gtk_list_store_set(prv->v6addresses, &iter, 0, ip, -1 );
-                        g_signal_handlers_unblock_by_func(G_OBJECT(prv->v6addresses), (gpointer)ip_row_inserted_or_changed_cb, (gpointer)ncu);
-
-                        g_object_unref(ip);
+                        /* Takes the reference of ip */
+                        prv->v6addresses = g_list_prepend(prv->v6addresses, ip);
 
                         /* Free up memory as we go */
                         g_free(*ptr);
@@ -1055,10 +1034,6 @@ populate_ip_ncu_data( NwamuiNcu *ncu, nwam_ncu_handle_t nwam_ncu )
         }
     }
     g_free(ip_version);
-
-    g_object_thaw_notify(G_OBJECT(prv->v4addresses));
-    g_object_thaw_notify(G_OBJECT(prv->v6addresses));
-
 }
 
 static void
@@ -1074,57 +1049,6 @@ populate_phys_ncu_data(NwamuiNcu *ncu, nwam_ncu_handle_t nwam_ncu)
     }
 }
 
-static gboolean 
-append_to_glist( GtkTreeModel *model,
-                 GtkTreePath *path,
-                 GtkTreeIter *iter,
-                 gpointer data )
-{
-    GList     **list_p = (GList**)data;
-    GList      *list = *list_p;
-	NwamuiIp   *ip;
-
-    gtk_tree_model_get( GTK_TREE_MODEL(model), iter, 0, &ip, -1);
-    if ( ip ) {
-        list = g_list_append( list, (gpointer)g_object_ref(G_OBJECT(ip)) );
-    }
-
-    *list_p = list;
-
-    return(FALSE);
-}
-
-
-static GList*
-convert_gtk_list_store_to_g_list( GtkListStore *ls ) 
-{
-    GList*  new_list = NULL;
-
-    if ( ls != NULL ) {
-        gtk_tree_model_foreach( GTK_TREE_MODEL(ls), append_to_glist, &new_list );
-    }
-
-    return( new_list );
-}
-    
-static gboolean 
-set_address_source( GtkTreeModel *model,
-                    GtkTreePath *path,
-                    GtkTreeIter *iter,
-                    gpointer data )
-{
-    NwamuiIp   *ip = NULL;
-	gboolean    is_dhcp = (gboolean)data;
-
-    gtk_tree_model_get( GTK_TREE_MODEL(model), iter, 0, &ip, -1);
-    if ( ip && NWAMUI_IS_IP(ip) ) {
-        nwamui_ip_set_dhcp( ip, is_dhcp );
-    }
-
-    return(FALSE);
-}
-
-
 #define MAX_ADDRSRC_NUM (NWAM_ADDRSRC_STATIC + 1)     
 
 static void
@@ -1145,7 +1069,7 @@ nwamui_ncu_sync_handle_with_ip_data( NwamuiNcu *self )
         ip_version[ip_version_num] = (uint64_t)IPV4_VERSION;
         ip_version_num++;
 
-        ipv4_list = convert_gtk_list_store_to_g_list( self->prv->v4addresses );
+        ipv4_list = nwamui_util_copy_obj_list( self->prv->v4addresses );
         ipv4_addr_num = g_list_length( ipv4_list );
 
         ipv4_addrsrc_num = 0;
@@ -1212,7 +1136,7 @@ nwamui_ncu_sync_handle_with_ip_data( NwamuiNcu *self )
         ip_version[ip_version_num] = (uint64_t)IPV6_VERSION;
         ip_version_num++;
 
-        ipv6_list = convert_gtk_list_store_to_g_list( self->prv->v6addresses );
+        ipv6_list = nwamui_util_copy_obj_list( self->prv->v6addresses );
         ipv6_addr_num = g_list_length( ipv6_list );
 
         ipv6_addrsrc_num = 0;
@@ -1391,6 +1315,8 @@ nwamui_object_real_clone(NwamuiObject *object, const gchar *name, NwamuiObject *
     NwamuiNcuPrivate  *new_prv = NULL;
     nwam_ncp_handle_t  nwam_ncp;
     nwam_error_t       nerr;
+    gboolean           created[NWAM_NCU_CLASS_ANY] = { FALSE };
+    nwam_ncu_class_t   i;
 
     g_assert(NWAMUI_IS_NCU(object));
     g_assert(NWAMUI_IS_NCP(parent));
@@ -1405,7 +1331,7 @@ nwamui_object_real_clone(NwamuiObject *object, const gchar *name, NwamuiObject *
 
     nwam_ncp = nwamui_ncp_get_nwam_handle( ncp );
 
-    for (nwam_ncu_class_t i = 0; i < NWAM_NCU_CLASS_ANY; i++) {
+    for (i = 0; i < NWAM_NCU_CLASS_ANY; i++) {
         if (prv->ncu_handles[i] != NULL) {
             nwam_ncu_handle_t  nwam_ncu_handle;
 
@@ -1436,25 +1362,32 @@ nwamui_object_real_clone(NwamuiObject *object, const gchar *name, NwamuiObject *
                 }
                 new_prv->ncu_handles[i] = nwam_ncu_handle;
                 new_prv->ncu_modified[i] = TRUE;
+                created[i] = TRUE;
+            } else {
+                /* Already in the target NCP, as it is there. */
+                new_prv->ncu_handles[i] = nwam_ncu_handle;
             }
         } else {
             g_warning("Original NCU doesn't have phys handle");
         }
     }
 
-    /* Reload data, otherwise the elements of prv will overwrite the in-mem
-     * data on committing.
+    /* Fill prv from the handles, otherwise its elements would overwrite
+     * them on committing. Unlike a reload, nothing is read again.
      */
-    nwamui_object_real_reload(NWAMUI_OBJECT(new_ncu));
+    g_object_freeze_notify(G_OBJECT(new_ncu));
+    populate_phys_ncu_data(new_ncu, new_prv->ncu_handles[NWAM_NCU_CLASS_PHYS]);
+    populate_ip_ncu_data(new_ncu, new_prv->ncu_handles[NWAM_NCU_CLASS_IP]);
+#ifdef TUNNEL_SUPPORT
+    populate_iptun_ncu_data(new_ncu, new_prv->ncu_handles[NWAM_NCU_CLASS_IPTUN]);
+#endif /* TUNNEL_SUPPORT */
+    g_object_thaw_notify(G_OBJECT(new_ncu));
 
-    /* Actually the fix should be also applied to other
-     * objects. nwamui_object_reload shouldn't be called if the object has
-     * modifications. Can't put this code in real_reload for NCU right now,
-     * because ncu clone also call reload, then will cause the cloned object
-     * can't be committed.
+    /* Only the classes created above need a commit, those read from the
+     * target NCP already are as they should be.
      */
-    for (nwam_ncu_class_t i = 0; i < NWAM_NCU_CLASS_ANY; i++) {
-        new_prv->ncu_modified[i] = TRUE;
+    for (i = 0; i < NWAM_NCU_CLASS_ANY; i++) {
+        new_prv->ncu_modified[i] = created[i];
     }
 
     return NWAMUI_OBJECT(new_ncu);
@@ -1539,7 +1472,7 @@ static gboolean
 nwamui_object_real_has_modifications(NwamuiObject* object)
 {
     NwamuiNcuPrivate *prv = NWAMUI_NCU_GET_PRIVATE(object);
-    gboolean modified;
+    gboolean modified = FALSE;
 
     g_return_val_if_fail(NWAMUI_IS_NCU(object), FALSE);
 
@@ -2213,7 +2146,7 @@ nwamui_ncu_get_ipv4_has_static (NwamuiNcu *self)
 
     g_return_val_if_fail (NWAMUI_IS_NCU (self), FALSE);
 
-    num_static = gtk_tree_model_iter_n_children( GTK_TREE_MODEL(self->prv->v4addresses), NULL );
+    num_static = g_list_length( self->prv->v4addresses );
 
     return( num_static > 0 );
 }
@@ -2448,7 +2381,7 @@ nwamui_ncu_get_ipv6_has_static (NwamuiNcu *self)
 
     g_return_val_if_fail (NWAMUI_IS_NCU (self), FALSE);
 
-    num_static = gtk_tree_model_iter_n_children( GTK_TREE_MODEL(self->prv->v6addresses), NULL );
+    num_static = g_list_length( self->prv->v6addresses );
 
     return( num_static > 0 );
 }
@@ -2544,33 +2477,31 @@ nwamui_ncu_get_ipv6_default_route (NwamuiNcu *self)
 /** 
  * nwamui_ncu_set_v4addresses:
  * @nwamui_ncu: a #NwamuiNcu.
- * @v4addresses: Value to set v4addresses to.
+ * @v4addresses: GList of #NwamuiIp, copied, NULL removes all static addresses.
  * 
  **/ 
 extern void
 nwamui_ncu_set_v4addresses (   NwamuiNcu *self,
-                              GtkListStore*  v4addresses )
+                              GList*  v4addresses )
 {
     g_return_if_fail (NWAMUI_IS_NCU (self));
-    g_assert (v4addresses != NULL );
 
-    if ( v4addresses != NULL ) {
-        g_object_set (G_OBJECT (self),
-                      "v4addresses", v4addresses,
-                      NULL);
-    }
+    g_object_set (G_OBJECT (self),
+                  "v4addresses", v4addresses,
+                  NULL);
 }
 
 /**
  * nwamui_ncu_get_v4addresses:
  * @nwamui_ncu: a #NwamuiNcu.
- * @returns: the v4addresses.
+ * @returns: a copy of the GList of static #NwamuiIp, free with
+ * nwamui_util_free_obj_list().
  *
  **/
-extern GtkListStore*
+extern GList*
 nwamui_ncu_get_v4addresses (NwamuiNcu *self)
 {
-    GtkListStore*  v4addresses = NULL; 
+    GList*  v4addresses = NULL; 
 
     g_return_val_if_fail (NWAMUI_IS_NCU (self), v4addresses);
 
@@ -2584,33 +2515,31 @@ nwamui_ncu_get_v4addresses (NwamuiNcu *self)
 /** 
  * nwamui_ncu_set_v6addresses:
  * @nwamui_ncu: a #NwamuiNcu.
- * @v6addresses: Value to set v6addresses to.
+ * @v6addresses: GList of #NwamuiIp, copied, NULL removes all static addresses.
  * 
  **/ 
 extern void
 nwamui_ncu_set_v6addresses (   NwamuiNcu *self,
-                              GtkListStore*  v6addresses )
+                              GList*  v6addresses )
 {
     g_return_if_fail (NWAMUI_IS_NCU (self));
-    g_assert (v6addresses != NULL );
 
-    if ( v6addresses != NULL ) {
-        g_object_set (G_OBJECT (self),
-                      "v6addresses", v6addresses,
-                      NULL);
-    }
+    g_object_set (G_OBJECT (self),
+                  "v6addresses", v6addresses,
+                  NULL);
 }
 
 /**
  * nwamui_ncu_get_v6addresses:
  * @nwamui_ncu: a #NwamuiNcu.
- * @returns: the v6addresses.
+ * @returns: a copy of the GList of static #NwamuiIp, free with
+ * nwamui_util_free_obj_list().
  *
  **/
-extern GtkListStore*
+extern GList*
 nwamui_ncu_get_v6addresses (NwamuiNcu *self)
 {
-    GtkListStore*  v6addresses = NULL; 
+    GList*  v6addresses = NULL; 
 
     g_return_val_if_fail (NWAMUI_IS_NCU (self), v6addresses);
 
@@ -2954,7 +2883,7 @@ nwamui_ncu_wifi_hash_insert_wifi_net( NwamuiNcu     *self,
     if ( essid != NULL ) {
         if ( (value = g_hash_table_lookup( self->prv->wifi_hash_table, essid )) == NULL ) {
             g_hash_table_insert(self->prv->wifi_hash_table, g_strdup(essid),
-              g_object_ref(wifi_net) );
+              nwamui_instances_ref(wifi_net) );
 
             nwamui_wifi_net_set_life_state(NWAMUI_WIFI_NET(wifi_net), NWAMUI_WIFI_LIFE_NEW);
             /* hash table taken ownership of essid */
@@ -3053,13 +2982,8 @@ nwamui_ncu_finalize (NwamuiNcu *self)
 {
     NwamuiNcuPrivate *prv  = NWAMUI_NCU_GET_PRIVATE(self);
 
-    if (prv->v4addresses != NULL ) {
-        g_object_unref( G_OBJECT(prv->v4addresses) );
-    }
-
-    if (prv->v6addresses != NULL ) {
-        g_object_unref( G_OBJECT(prv->v6addresses) );
-    }
+    nwamui_util_free_obj_list( prv->v4addresses );
+    nwamui_util_free_obj_list( prv->v6addresses );
 
     if ( prv->wifi_hash_table != NULL ) {
         g_hash_table_destroy(prv->wifi_hash_table);
@@ -3218,25 +3142,10 @@ nwamui_ncu_set_link_nwam_state(NwamuiNcu *self, nwam_state_t state, nwam_aux_sta
     g_object_thaw_notify(G_OBJECT(self));
 }
 
-static gboolean
-foreach_v4_tree_model_find_static_addr(GtkTreeModel *model,
-  GtkTreePath *path,
-  GtkTreeIter *iter,
-  gpointer user_data)
+static gint
+find_static_addr(gconstpointer data, gconstpointer user_data)
 {
-    NwamuiObject *ip;
-    gchar *address = user_data;
-
-    gtk_tree_model_get( GTK_TREE_MODEL(model), iter, 0, &ip, -1);
-
-    if (ip) {
-        if (g_strcmp0(nwamui_object_get_name(ip), address) == 0) {
-            g_object_unref(ip);
-            return TRUE;
-        }
-        g_object_unref(ip);
-    }
-	return FALSE;
+    return g_strcmp0(nwamui_object_get_name(NWAMUI_OBJECT(data)), (const gchar *)user_data);
 }
 
 extern void
@@ -3246,7 +3155,7 @@ nwamui_ncu_add_acquired(NwamuiNcu *self,
   uint32_t flags)
 {
     NwamuiNcuPrivate  *prv       = NWAMUI_NCU_GET_PRIVATE(self);
-    GtkTreeModel      *m         = NULL;
+    GList             *statics   = NULL;
     GList            **l         = NULL;
     GList             *found     = NULL;
     gboolean           is_static = FALSE;
@@ -3258,14 +3167,13 @@ nwamui_ncu_add_acquired(NwamuiNcu *self,
 
     if (is_ipv4) {
         l = &prv->ipv4_acquired;
-        m = GTK_TREE_MODEL(prv->v4addresses);
+        statics = prv->v4addresses;
     } else {
         l = &prv->ipv6_acquired;
-        m = GTK_TREE_MODEL(prv->v6addresses);
+        statics = prv->v6addresses;
     }
 
-    if (capplet_model_foreach(m, foreach_v4_tree_model_find_static_addr,
-        (gpointer)address, NULL)) {
+    if (g_list_find_custom(statics, address, find_static_addr)) {
         /* This is static address, ignore flags. See Darren's comments:
          */
         /* It is possible for the DHCPRUNNING flag to be true, yet DHCP is not
@@ -4447,7 +4355,7 @@ nwamui_ncu_get_configuration_summary_string( NwamuiNcu* self )
         GList  *ipv4_list = NULL;
         guint   count;
 
-        ipv4_list = convert_gtk_list_store_to_g_list( self->prv->v4addresses );
+        ipv4_list = nwamui_util_copy_obj_list( self->prv->v4addresses );
 
         count = g_list_length( ipv4_list );
 
@@ -4496,7 +4404,7 @@ nwamui_ncu_get_configuration_summary_string( NwamuiNcu* self )
         GList  *ipv6_list = NULL;
         guint   count;
 
-        ipv6_list = convert_gtk_list_store_to_g_list( self->prv->v6addresses );
+        ipv6_list = nwamui_util_copy_obj_list( self->prv->v6addresses );
 
         count = g_list_length( ipv6_list );
 
@@ -4588,30 +4496,6 @@ find_first_dhcp_address(gconstpointer a, gconstpointer b)
     return 1;
 }
 
-static void 
-ip_row_inserted_or_changed_cb (GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
-{
-    NwamuiNcu* self = NWAMUI_NCU(data);
-    gboolean is_v6 = (tree_model == GTK_TREE_MODEL(self->prv->v6addresses));
-
-    set_modified_flag( self, NWAM_NCU_CLASS_IP, TRUE );
-
-    /* Chain events in the tree to the NCU object*/
-    g_object_notify(G_OBJECT(self), is_v6?"v6addresses":"v4addresses");
-}
-
-static void 
-ip_row_deleted_cb (GtkTreeModel *tree_model, GtkTreePath *path, gpointer data)
-{
-    NwamuiNcu* self = NWAMUI_NCU(data);
-    gboolean is_v6 = (tree_model == GTK_TREE_MODEL(self->prv->v6addresses));
-
-    set_modified_flag( self, NWAM_NCU_CLASS_IP, TRUE );
-
-    /* Chain events in the tree to the NCU object*/
-    g_object_notify(G_OBJECT(self), is_v6?"v6addresses":"v4addresses");
-}
-
 static void
 wireless_notify_cb(GObject *gobject, GParamSpec *arg1, gpointer user_data)
 {
@@ -154,12 +154,12 @@ extern void                 nwamui_ncu_set_ipv6_default_route ( NwamuiNcu *self,
                                                                 const gchar*  ipv6_default_route );
 extern gchar*               nwamui_ncu_get_ipv6_default_route (NwamuiNcu *self);
 
-extern void                 nwamui_ncu_set_v4addresses ( NwamuiNcu *self, GtkListStore* v4addresses );
-extern GtkListStore*        nwamui_ncu_get_v4addresses ( NwamuiNcu *self );
+extern void                 nwamui_ncu_set_v4addresses ( NwamuiNcu *self, GList* v4addresses );
+extern GList*               nwamui_ncu_get_v4addresses ( NwamuiNcu *self );
 
 
-extern void                 nwamui_ncu_set_v6addresses ( NwamuiNcu *self, GtkListStore* v6addresses );
-extern GtkListStore*        nwamui_ncu_get_v6addresses ( NwamuiNcu *self );
+extern void                 nwamui_ncu_set_v6addresses ( NwamuiNcu *self, GList* v6addresses );
+extern GList*               nwamui_ncu_get_v6addresses ( NwamuiNcu *self );
 
 extern NwamuiWifiNet*       nwamui_ncu_get_wifi_info ( NwamuiNcu *self );
 extern void                 nwamui_ncu_set_wifi_info ( NwamuiNcu *self, NwamuiWifiNet* wifi_info );
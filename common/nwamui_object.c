@@ -47,6 +47,7 @@ enum {
     ADD,
     REMOVE,
     MODIFIED,
+    CHANGED,
 	LAST_SIGNAL
 };
 
@@ -58,6 +59,17 @@ struct _NwamuiObjectPrivate {
     gint              activation_mode;
     nwam_state_t      nwam_state;
     nwam_aux_state_t  nwam_aux_state;
+
+    /* See nwamui_object_set_stand_in() */
+    gboolean          stand_in;
+    gboolean          stand_in_active;
+    gboolean          stand_in_enabled;
+    guint64           stand_in_priority;
+
+    /* See nwamui_object_begin_update() */
+    guint             update_depth;
+    gboolean          update_ending;
+    GList            *pending_modified; /* Children, each once */
 };
 
 static GObject* nwamui_object_constructor(GType type,
@@ -76,6 +88,12 @@ static void nwamui_object_get_property(GObject         *object,
 
 static void nwamui_object_finalize(NwamuiObject *self);
 
+static void nwamui_object_load_stand_in(NwamuiObject *object);
+
+static void nwamui_object_dispatch_properties_changed(GObject *object,
+  guint n_pspecs,
+  GParamSpec **pspecs);
+
 /* Callbacks */
 static void nwamui_object_notify_cb( GObject *gobject, GParamSpec *arg1, gpointer data);
 
@@ -289,6 +307,7 @@ nwamui_object_class_init(NwamuiObjectClass *klass)
 	gobject_class->finalize = (void (*)(GObject*)) nwamui_object_finalize;
 	gobject_class->set_property = nwamui_object_set_property;
 	gobject_class->get_property = nwamui_object_get_property;
+	gobject_class->dispatch_properties_changed = nwamui_object_dispatch_properties_changed;
 
     klass->get_name = default_nwamui_object_get_name;
     klass->can_rename = default_nwamui_object_can_rename;
@@ -415,6 +434,18 @@ nwamui_object_class_init(NwamuiObjectClass *klass)
         G_TYPE_NONE,                  /* Return Type */
         1,                            /* Number of Args */
         NWAMUI_TYPE_OBJECT);               /* Types of Args */
+
+    nwamui_object_signals[CHANGED] =
+      g_signal_new ("changed",
+        G_TYPE_FROM_CLASS (klass),
+        G_SIGNAL_RUN_FIRST,
+        G_STRUCT_OFFSET (NwamuiObjectClass, changed),
+        NULL, NULL,
+        g_cclosure_marshal_VOID__UINT_POINTER,
+        G_TYPE_NONE,                  /* Return Type */
+        2,                            /* Number of Args */
+        G_TYPE_UINT,                  /* Number of properties */
+        G_TYPE_POINTER);              /* GParamSpec** */
 }
 
 static void
@@ -510,12 +541,24 @@ nwamui_object_constructor(GType type,
 	    construct_properties);
 	self = NWAMUI_OBJECT(object);
 
+	nwamui_instances_track(object);
+
 	return object;
 }
 
 static void
 nwamui_object_finalize(NwamuiObject *self)
 {
+    NwamuiObjectPrivate *prv = NWAMUI_OBJECT_GET_PRIVATE(self);
+    GList               *idx;
+
+    for (idx = prv->pending_modified; idx; idx = idx->next) {
+        if (idx->data) {
+            g_object_unref(idx->data);
+        }
+    }
+    g_list_free(prv->pending_modified);
+
 	G_OBJECT_CLASS(nwamui_object_parent_class)->finalize(G_OBJECT (self));
 }
 
@@ -556,6 +599,7 @@ nwamui_object_can_rename (NwamuiObject *object)
 {
     g_return_val_if_fail (NWAMUI_IS_OBJECT (object), FALSE);
 
+    nwamui_object_load_stand_in(object);
     return NWAMUI_OBJECT_GET_CLASS (object)->can_rename(object);
 }
 
@@ -573,6 +617,7 @@ nwamui_object_set_name(NwamuiObject *object, const gchar* name )
     g_return_val_if_fail(NWAMUI_IS_OBJECT(object), FALSE);
 
     if (prv->name == NULL || g_strcmp0(prv->name, name) != 0) {
+        nwamui_object_load_stand_in(object);
         if (NWAMUI_OBJECT_GET_CLASS (object)->set_name(object, name)) {
             /* Must cache the return value of name */
             prv->name = NWAMUI_OBJECT_GET_CLASS (object)->get_name(object);
@@ -595,6 +640,7 @@ nwamui_object_set_conditions (   NwamuiObject *object,
 {
     g_return_if_fail (NWAMUI_IS_OBJECT (object));
 
+    nwamui_object_load_stand_in(object);
     NWAMUI_OBJECT_GET_CLASS (object)->set_conditions(object, conditions);
 }
 
@@ -609,6 +655,7 @@ nwamui_object_get_conditions (NwamuiObject *object)
 {
     g_return_val_if_fail (NWAMUI_IS_OBJECT (object), NULL);
 
+    nwamui_object_load_stand_in(object);
     return NWAMUI_OBJECT_GET_CLASS (object)->get_conditions(object);
 }
 
@@ -619,7 +666,9 @@ nwamui_object_get_activation_mode(NwamuiObject *object)
 
     g_return_val_if_fail (NWAMUI_IS_OBJECT(object), NWAMUI_COND_ACTIVATION_MODE_LAST);
 
-    prv->activation_mode = NWAMUI_OBJECT_GET_CLASS(object)->get_activation_mode(object);
+    if (!prv->stand_in) {
+        prv->activation_mode = NWAMUI_OBJECT_GET_CLASS(object)->get_activation_mode(object);
+    }
 
     return prv->activation_mode;
 }
@@ -631,6 +680,7 @@ nwamui_object_set_activation_mode(NwamuiObject *object, gint activation_mode)
 
     g_return_if_fail (NWAMUI_IS_OBJECT (object));
 
+    nwamui_object_load_stand_in(object);
     if (prv->activation_mode != activation_mode) {
         g_object_freeze_notify(G_OBJECT(object));
 
@@ -649,6 +699,9 @@ nwamui_object_get_active(NwamuiObject *object)
 {
     g_return_val_if_fail (NWAMUI_IS_OBJECT (object), FALSE);
 
+    if (NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in) {
+        return NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in_active;
+    }
     return NWAMUI_OBJECT_GET_CLASS (object)->get_active(object);
 }
 
@@ -657,6 +710,7 @@ nwamui_object_set_active(NwamuiObject *object, gboolean active)
 {
     g_return_if_fail (NWAMUI_IS_OBJECT (object));
 
+    nwamui_object_load_stand_in(object);
     NWAMUI_OBJECT_GET_CLASS (object)->set_active(object, active);
 }
 
@@ -665,6 +719,9 @@ nwamui_object_get_enabled(NwamuiObject *object)
 {
     g_return_val_if_fail (NWAMUI_IS_OBJECT (object), FALSE);
 
+    if (NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in) {
+        return NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in_enabled;
+    }
     return NWAMUI_OBJECT_GET_CLASS (object)->get_enabled(object);
 }
 
@@ -673,6 +730,7 @@ nwamui_object_set_enabled(NwamuiObject *object, gboolean enabled)
 {
     g_return_if_fail (NWAMUI_IS_OBJECT (object));
 
+    nwamui_object_load_stand_in(object);
     NWAMUI_OBJECT_GET_CLASS (object)->set_enabled(object, enabled);
 }
 
@@ -699,7 +757,8 @@ nwamui_object_validate(NwamuiObject *object, gchar **prop_name_ret)
 {
     g_return_val_if_fail (NWAMUI_IS_OBJECT (object), FALSE);
 
-    g_debug("Validate %s '%s(0x%p)'", g_type_name(G_TYPE_FROM_INSTANCE(object)), nwamui_object_get_name(object), object);
+    nwamui_object_load_stand_in(object);
+    nwamui_log_debug(NWAMUI_LOG_CAT_COMMIT, "Validate %s '%s(0x%p)'", g_type_name(G_TYPE_FROM_INSTANCE(object)), nwamui_object_get_name(object), object);
 
     return NWAMUI_OBJECT_GET_CLASS (object)->validate(object, prop_name_ret);
 }
@@ -717,11 +776,18 @@ nwamui_object_validate(NwamuiObject *object, gchar **prop_name_ret)
 extern gboolean
 nwamui_object_commit(NwamuiObject *object)
 {
+    gboolean ret;
+
     g_return_val_if_fail (NWAMUI_IS_OBJECT (object), FALSE);
 
-    g_debug("Commit %s '%s(0x%p)'", g_type_name(G_TYPE_FROM_INSTANCE(object)), nwamui_object_get_name(object), object);
+    nwamui_object_load_stand_in(object);
+    nwamui_log_debug(NWAMUI_LOG_CAT_COMMIT, "Commit %s '%s(0x%p)'", g_type_name(G_TYPE_FROM_INSTANCE(object)), nwamui_object_get_name(object), object);
+
+    nwamui_trace_begin("nwamui_object_commit");
+    ret = NWAMUI_OBJECT_GET_CLASS (object)->commit(object);
+    nwamui_trace_end("nwamui_object_commit");
 
-    return NWAMUI_OBJECT_GET_CLASS (object)->commit(object);
+    return ret;
 }
 
 /**
@@ -739,15 +805,49 @@ nwamui_object_destroy(NwamuiObject *object)
 {
     g_return_val_if_fail (NWAMUI_IS_OBJECT (object), FALSE);
 
+    nwamui_object_load_stand_in(object);
     return NWAMUI_OBJECT_GET_CLASS (object)->destroy(object);
 }
 
+/**
+ * nwamui_object_reload:
+ * @object: a #NwamuiObject.
+ *
+ * Reads @object again from the configuration. A stand-in, see
+ * nwamui_object_set_stand_in(), answers from the configuration from now on,
+ * its state too.
+ *
+ * The class reload always runs inside nwamui_object_begin_update(), so it
+ * needs no update of its own: however many properties it sets, each is
+ * notified once at the end, followed by a single "changed".
+ */
 extern void
 nwamui_object_reload(NwamuiObject *object)
 {
+    NwamuiObjectPrivate *prv;
+    gboolean             stand_in;
+
     g_return_if_fail (NWAMUI_IS_OBJECT (object));
+    prv = NWAMUI_OBJECT_GET_PRIVATE(object);
+
+    nwamui_object_begin_update(object);
+
+    stand_in = prv->stand_in;
+    prv->stand_in = FALSE;
 
     NWAMUI_OBJECT_GET_CLASS (object)->reload(object);
+
+    if (stand_in) {
+        nwam_state_t        state;
+        nwam_aux_state_t    aux_state = NWAM_AUX_STATE_UNINITIALIZED;
+
+        state = NWAMUI_OBJECT_GET_CLASS(object)->get_nwam_state(object, &aux_state, NULL);
+        nwamui_object_set_nwam_state(object, state, aux_state);
+        g_object_notify(G_OBJECT(object), "activation-mode");
+        g_object_notify(G_OBJECT(object), "enabled");
+    }
+
+    nwamui_object_end_update(object);
 }
 
 extern nwam_state_t         
@@ -810,6 +910,9 @@ nwamui_object_is_modifiable(NwamuiObject *object)
 {
     g_return_val_if_fail(NWAMUI_IS_OBJECT(object), FALSE);
 
+    if (NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in) {
+        return NWAMUI_OBJECT_GET_PRIVATE(object)->activation_mode != NWAMUI_COND_ACTIVATION_MODE_SYSTEM;
+    }
     return NWAMUI_OBJECT_GET_CLASS(object)->is_modifiable(object);
 }
 
@@ -824,6 +927,10 @@ nwamui_object_has_modifications(NwamuiObject *object)
 {
     g_return_val_if_fail(NWAMUI_IS_OBJECT(object), FALSE);
 
+    /* Nothing to save before it was even read */
+    if (NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in) {
+        return FALSE;
+    }
     return NWAMUI_OBJECT_GET_CLASS(object)->has_modifications(object);
 }
 
@@ -838,13 +945,175 @@ nwamui_object_has_modifications(NwamuiObject *object)
  * flag and the user need call nwamui_object_commit() manually. The class
  * implemetations should not call nwamui_object_add(), because
  * nwamui_object_commit() will cause that happens.
+ *
+ * A clone is a new object, there is no base an edit session could diff it
+ * against, so it is committed whole. Locations, ENMs and NCPs are cloned
+ * with one copy of their libnwam handle. An NCU clone only creates the
+ * classes @parent doesn't have yet, and only those are committed.
  */
 extern NwamuiObject*
 nwamui_object_clone(NwamuiObject *object, const gchar *name, NwamuiObject *parent)
 {
+    NwamuiObject *clone;
+
     g_return_val_if_fail (NWAMUI_IS_OBJECT(object), NULL);
 
-    return NWAMUI_OBJECT_GET_CLASS (object)->clone(object, name, parent);
+    nwamui_object_load_stand_in(object);
+    nwamui_trace_begin("nwamui_object_clone");
+    clone = NWAMUI_OBJECT_GET_CLASS (object)->clone(object, name, parent);
+    nwamui_trace_end("nwamui_object_clone");
+
+    return clone;
+}
+
+/**
+ * nwamui_object_set_stand_in:
+ * @object: a #NwamuiObject which has a name but hasn't been opened.
+ * @active: answer of nwamui_object_get_active().
+ * @enabled: answer of nwamui_object_get_enabled().
+ * @activation_mode: answer of nwamui_object_get_activation_mode().
+ * @priority: see nwamui_object_get_stand_in_priority().
+ *
+ * Lets @object stand in for a configuration object which isn't read yet,
+ * e.g. from the tray's snapshot, see nwamui_snapshot.h. The state is set
+ * with nwamui_object_set_nwam_state() as usual. Until nwamui_object_reload()
+ * the getters above answer from these values, has no modifications, and
+ * anything else which needs the configuration reloads it first.
+ */
+extern void
+nwamui_object_set_stand_in(NwamuiObject *object, gboolean active, gboolean enabled,
+  gint activation_mode, guint64 priority)
+{
+    NwamuiObjectPrivate *prv;
+
+    g_return_if_fail(NWAMUI_IS_OBJECT(object));
+    prv = NWAMUI_OBJECT_GET_PRIVATE(object);
+
+    prv->stand_in = TRUE;
+    prv->stand_in_active = active;
+    prv->stand_in_enabled = enabled;
+    prv->stand_in_priority = priority;
+    prv->activation_mode = activation_mode;
+}
+
+/**
+ * nwamui_object_is_stand_in:
+ * @object: a #NwamuiObject.
+ * @returns: TRUE if @object is a stand-in which hasn't been reloaded yet.
+ */
+extern gboolean
+nwamui_object_is_stand_in(NwamuiObject *object)
+{
+    g_return_val_if_fail(NWAMUI_IS_OBJECT(object), FALSE);
+
+    return NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in;
+}
+
+/**
+ * nwamui_object_get_stand_in_priority:
+ * @object: a #NwamuiObject.
+ * @returns: the priority a stand-in was given, for the subclasses which have
+ * one, e.g. known WLANs.
+ */
+extern guint64
+nwamui_object_get_stand_in_priority(NwamuiObject *object)
+{
+    g_return_val_if_fail(NWAMUI_IS_OBJECT(object), 0);
+
+    return NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in_priority;
+}
+
+/* Read a stand-in before what needs the configuration. */
+static void
+nwamui_object_load_stand_in(NwamuiObject *object)
+{
+    if (NWAMUI_OBJECT_GET_PRIVATE(object)->stand_in) {
+        nwamui_object_reload(object);
+    }
+}
+
+/**
+ * nwamui_object_begin_update:
+ * @object: a #NwamuiObject.
+ *
+ * Starts a batch of changes, e.g. a reload. Until the matching
+ * nwamui_object_end_update() the property notifications of @object are
+ * held back and merged, and "modified" is recorded once per child. Updates
+ * nest, only the outermost end delivers them.
+ */
+extern void
+nwamui_object_begin_update(NwamuiObject *object)
+{
+    NwamuiObjectPrivate *prv;
+
+    g_return_if_fail(NWAMUI_IS_OBJECT(object));
+    prv = NWAMUI_OBJECT_GET_PRIVATE(object);
+
+    if (prv->update_depth++ == 0) {
+        g_object_freeze_notify(G_OBJECT(object));
+    }
+}
+
+/**
+ * nwamui_object_end_update:
+ * @object: a #NwamuiObject.
+ *
+ * Ends a nwamui_object_begin_update(). The outermost end emits "notify" for
+ * each changed property, then "changed" with all of them, then the held
+ * back "modified" signals.
+ */
+extern void
+nwamui_object_end_update(NwamuiObject *object)
+{
+    NwamuiObjectPrivate *prv;
+    GList               *modified;
+    GList               *idx;
+    gboolean             ending;
+
+    g_return_if_fail(NWAMUI_IS_OBJECT(object));
+    prv = NWAMUI_OBJECT_GET_PRIVATE(object);
+    g_return_if_fail(prv->update_depth > 0);
+
+    if (--prv->update_depth > 0) {
+        return;
+    }
+
+    g_object_ref(object);
+
+    /* Handlers may start updates of their own. */
+    ending = prv->update_ending;
+    prv->update_ending = TRUE;
+    g_object_thaw_notify(G_OBJECT(object));
+    prv->update_ending = ending;
+
+    modified = prv->pending_modified;
+    prv->pending_modified = NULL;
+    for (idx = modified; idx; idx = idx->next) {
+        g_signal_emit(object,
+          nwamui_object_signals[MODIFIED],
+          0, /* details */
+          idx->data,
+          NULL);
+        if (idx->data) {
+            g_object_unref(idx->data);
+        }
+    }
+    g_list_free(modified);
+
+    g_object_unref(object);
+}
+
+/**
+ * nwamui_object_in_update:
+ * @object: a #NwamuiObject.
+ * @returns: TRUE between nwamui_object_begin_update() and its end.
+ */
+extern gboolean
+nwamui_object_in_update(NwamuiObject *object)
+{
+    g_return_val_if_fail(NWAMUI_IS_OBJECT(object), FALSE);
+
+    return NWAMUI_OBJECT_GET_PRIVATE(object)->update_depth > 0;
 }
 
 /* Signals */
@@ -906,6 +1175,16 @@ nwamui_object_remove(NwamuiObject *object, NwamuiObject *child)
 void
 nwamui_object_modified(NwamuiObject *object, NwamuiObject *child)
 {
+    NwamuiObjectPrivate *prv = NWAMUI_OBJECT_GET_PRIVATE(object);
+
+    if (prv->update_depth > 0) {
+        if (g_list_find(prv->pending_modified, child) == NULL) {
+            prv->pending_modified = g_list_append(prv->pending_modified,
+              child ? g_object_ref(child) : NULL);
+        }
+        return;
+    }
+
     g_signal_emit(object,
       nwamui_object_signals[MODIFIED],
       0, /* details */
@@ -913,6 +1192,26 @@ nwamui_object_modified(NwamuiObject *object, NwamuiObject *child)
       NULL);
 }
 
+/* GObject emits "notify" here, at thaw with all the frozen properties. */
+static void
+nwamui_object_dispatch_properties_changed(GObject *object,
+  guint n_pspecs,
+  GParamSpec **pspecs)
+{
+    NwamuiObjectPrivate *prv = NWAMUI_OBJECT_GET_PRIVATE(object);
+
+    G_OBJECT_CLASS(nwamui_object_parent_class)->dispatch_properties_changed(object, n_pspecs, pspecs);
+
+    if (prv->update_ending) {
+        g_signal_emit(object,
+          nwamui_object_signals[CHANGED],
+          0, /* details */
+          n_pspecs,
+          pspecs,
+          NULL);
+    }
+}
+
 /* Callbacks */
 static void
 nwamui_object_notify_cb( GObject *gobject, GParamSpec *arg1, gpointer data)
@@ -79,7 +79,7 @@ struct _NwamuiObjectClass
     gint (*sort)(NwamuiObject *object, NwamuiObject *other, guint sort_by);
     gboolean (*validate)(NwamuiObject *object, gchar **prop_name_ret);
     gboolean (*commit)(NwamuiObject *object);
-    void (*reload)(NwamuiObject *object);
+    void (*reload)(NwamuiObject *object); /* Inside an update */
     gboolean (*destroy)(NwamuiObject *object);
     gboolean (*is_modifiable)(NwamuiObject *object);
     gboolean (*has_modifications)(NwamuiObject *object);
@@ -91,6 +91,8 @@ struct _NwamuiObjectClass
 	void (*add)(NwamuiObject *object, NwamuiObject *child);
 	void (*remove)(NwamuiObject *object, NwamuiObject *child);
 	void (*modified)(NwamuiObject *object, NwamuiObject *child);
+    /* The properties notified during an update, once at its end. */
+	void (*changed)(NwamuiObject *object, guint n_pspecs, GParamSpec **pspecs);
 };
 
 enum {
@@ -129,6 +131,12 @@ extern gboolean      nwamui_object_destroy(NwamuiObject *object);
 extern gboolean      nwamui_object_is_modifiable(NwamuiObject *object);
 extern gboolean      nwamui_object_has_modifications(NwamuiObject *object);
 extern NwamuiObject* nwamui_object_clone(NwamuiObject *object, const gchar *name, NwamuiObject *parent);
+extern void          nwamui_object_begin_update(NwamuiObject *object);
+extern void          nwamui_object_end_update(NwamuiObject *object);
+extern gboolean      nwamui_object_in_update(NwamuiObject *object);
+extern void          nwamui_object_set_stand_in(NwamuiObject *object, gboolean active, gboolean enabled, gint activation_mode, guint64 priority);
+extern gboolean      nwamui_object_is_stand_in(NwamuiObject *object);
+extern guint64       nwamui_object_get_stand_in_priority(NwamuiObject *object);
 
 /* Signals */
 void nwamui_object_event(NwamuiObject *object, guint event, gpointer data);
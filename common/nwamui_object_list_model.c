@@ -0,0 +1,631 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_object_list_model.c
+ *
+ * A GtkTreeModel listing the objects of a daemon collection, i.e. NCPs,
+ * locations, ENMs, known WLANs, the NCUs of an NCP or the scanned WLANs.
+ * Rows follow the "add" and "remove" signals of the container and each
+ * object's "notify", so panels no longer copy objects into a list store and
+ * keep it in sync by hand. The single column holds the object itself, wrap
+ * the model in a GtkTreeModelFilter or GtkTreeModelSort to get a view.
+ */
+
+#include <glib-object.h>
+#include <glib/gi18n.h>
+
+#include "libnwamui.h"
+
+struct _NwamuiObjectListModelPrivate {
+    NwamuiObject                        *container;
+    GType                                type;
+    NwamuiObjectListModelForeachFunc     foreach_func;
+    NwamuiNcu                           *ncu;       /* Owner of listed WLANs, or NULL */
+    GSequence                           *rows;      /* Of ref'ed NwamuiObject */
+    GHashTable                          *index;     /* NwamuiObject -> GSequenceIter */
+    GHashTable                          *changed;   /* Objects notified since the last flush */
+    guint                                changed_id;
+    gint                                 stamp;
+};
+
+#define NWAMUI_OBJECT_LIST_MODEL_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE((o), NWAMUI_TYPE_OBJECT_LIST_MODEL, NwamuiObjectListModelPrivate))
+
+static void nwamui_object_list_model_tree_model_init (GtkTreeModelIface *iface);
+static void nwamui_object_list_model_finalize (NwamuiObjectListModel *self);
+
+/* Callbacks */
+static void container_add (NwamuiObject *container, NwamuiObject *object, gpointer data);
+static void container_remove (NwamuiObject *container, NwamuiObject *object, gpointer data);
+static void row_object_notify (GObject *gobject, GParamSpec *arg1, gpointer data);
+
+G_DEFINE_TYPE_EXTENDED (NwamuiObjectListModel,
+  nwamui_object_list_model,
+  G_TYPE_OBJECT,
+  0,
+  G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_MODEL, nwamui_object_list_model_tree_model_init))
+
+static void
+nwamui_object_list_model_class_init (NwamuiObjectListModelClass *klass)
+{
+    /* Pointer to GObject Part of Class */
+    GObjectClass *gobject_class = (GObjectClass*) klass;
+        
+    /* Override Some Function Pointers */
+    gobject_class->finalize = (void (*)(GObject*)) nwamui_object_list_model_finalize;
+
+	g_type_class_add_private(klass, sizeof(NwamuiObjectListModelPrivate));
+}
+
+static void
+nwamui_object_list_model_init (NwamuiObjectListModel *self)
+{
+    NwamuiObjectListModelPrivate *prv = NWAMUI_OBJECT_LIST_MODEL_GET_PRIVATE(self);
+    self->prv = prv;
+
+    prv->rows = g_sequence_new(NULL);
+    prv->index = g_hash_table_new(g_direct_hash, g_direct_equal);
+    prv->changed = g_hash_table_new(g_direct_hash, g_direct_equal);
+    prv->stamp = g_random_int();
+}
+
+static void
+row_object_release (gpointer data, gpointer user_data)
+{
+    g_signal_handlers_disconnect_by_func(data, (gpointer)row_object_notify, user_data);
+    g_object_unref(data);
+}
+
+static void
+nwamui_object_list_model_finalize (NwamuiObjectListModel *self)
+{
+    NwamuiObjectListModelPrivate *prv = self->prv;
+
+    if (prv->container) {
+        g_signal_handlers_disconnect_by_func(prv->container, (gpointer)container_add, (gpointer)self);
+        g_signal_handlers_disconnect_by_func(prv->container, (gpointer)container_remove, (gpointer)self);
+        g_object_unref(prv->container);
+    }
+    if (prv->ncu) {
+        g_object_unref(prv->ncu);
+    }
+
+    if (prv->changed_id) {
+        g_source_remove(prv->changed_id);
+    }
+    g_hash_table_destroy(prv->changed);
+
+    g_sequence_foreach(prv->rows, row_object_release, (gpointer)self);
+    g_sequence_free(prv->rows);
+    g_hash_table_destroy(prv->index);
+
+	G_OBJECT_CLASS(nwamui_object_list_model_parent_class)->finalize(G_OBJECT(self));
+}
+
+/* Whether @object belongs to the listed collection. */
+static gboolean
+accept_object (NwamuiObjectListModel *self, NwamuiObject *object)
+{
+    NwamuiObjectListModelPrivate *prv = self->prv;
+
+    /* Exact type, known WLANs are wifi nets too. */
+    if (G_TYPE_FROM_INSTANCE(object) != prv->type)
+        return FALSE;
+
+    if (prv->type == NWAMUI_TYPE_WIFI_NET) {
+        NwamuiNcu *ncu;
+        gboolean   mine = TRUE;
+
+        if (nwamui_wifi_net_get_life_state(NWAMUI_WIFI_NET(object)) == NWAMUI_WIFI_LIFE_DEAD)
+            return FALSE;
+
+        if (prv->ncu) {
+            ncu = nwamui_wifi_net_get_ncu(NWAMUI_WIFI_NET(object));
+            mine = (ncu == prv->ncu);
+            if (ncu)
+                g_object_unref(ncu);
+        }
+        return mine;
+    }
+    return TRUE;
+}
+
+static void
+fill_iter (NwamuiObjectListModel *self, GSequenceIter *seq_iter, GtkTreeIter *iter)
+{
+    iter->stamp = self->prv->stamp;
+    iter->user_data = seq_iter;
+}
+
+static void
+row_append (NwamuiObjectListModel *self, NwamuiObject *object)
+{
+    NwamuiObjectListModelPrivate *prv = self->prv;
+    GSequenceIter                *seq_iter;
+    GtkTreeIter                   iter;
+    GtkTreePath                  *path;
+
+    if (g_hash_table_lookup(prv->index, object))
+        return;
+
+    seq_iter = g_sequence_append(prv->rows, g_object_ref(object));
+    g_hash_table_insert(prv->index, object, seq_iter);
+    g_signal_connect(object, "notify", G_CALLBACK(row_object_notify), (gpointer)self);
+
+    fill_iter(self, seq_iter, &iter);
+    path = gtk_tree_path_new_from_indices(g_sequence_iter_get_position(seq_iter), -1);
+    gtk_tree_model_row_inserted(GTK_TREE_MODEL(self), path, &iter);
+    gtk_tree_path_free(path);
+}
+
+static void
+row_remove (NwamuiObjectListModel *self, NwamuiObject *object)
+{
+    NwamuiObjectListModelPrivate *prv = self->prv;
+    GSequenceIter                *seq_iter;
+    GtkTreePath                  *path;
+
+    if ((seq_iter = g_hash_table_lookup(prv->index, object)) == NULL)
+        return;
+
+    path = gtk_tree_path_new_from_indices(g_sequence_iter_get_position(seq_iter), -1);
+    g_hash_table_remove(prv->index, object);
+    g_sequence_remove(seq_iter);
+    gtk_tree_model_row_deleted(GTK_TREE_MODEL(self), path);
+    gtk_tree_path_free(path);
+
+    row_object_release(object, (gpointer)self);
+}
+
+static void
+container_add (NwamuiObject *container, NwamuiObject *object, gpointer data)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(data);
+
+    if (accept_object(self, object))
+        row_append(self, object);
+}
+
+static void
+container_remove (NwamuiObject *container, NwamuiObject *object, gpointer data)
+{
+    row_remove(NWAMUI_OBJECT_LIST_MODEL(data), object);
+}
+
+static void
+flush_changed_row (gpointer key, gpointer value, gpointer user_data)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(user_data);
+    GSequenceIter         *seq_iter;
+    GtkTreeIter            iter;
+    GtkTreePath           *path;
+
+    /* Removed since. */
+    if ((seq_iter = g_hash_table_lookup(self->prv->index, key)) == NULL)
+        return;
+
+    fill_iter(self, seq_iter, &iter);
+    path = gtk_tree_path_new_from_indices(g_sequence_iter_get_position(seq_iter), -1);
+    gtk_tree_model_row_changed(GTK_TREE_MODEL(self), path, &iter);
+    gtk_tree_path_free(path);
+}
+
+static gboolean
+flush_changed_rows (gpointer data)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(data);
+
+    self->prv->changed_id = 0;
+    g_hash_table_foreach(self->prv->changed, flush_changed_row, (gpointer)self);
+    g_hash_table_remove_all(self->prv->changed);
+
+    return FALSE;
+}
+
+/*
+ * An update, e.g. from a scan, notifies several properties in a row. They
+ * are collapsed into a single row-changed emitted when idle.
+ */
+static void
+row_object_notify (GObject *gobject, GParamSpec *arg1, gpointer data)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(data);
+
+    g_hash_table_insert(self->prv->changed, gobject, gobject);
+
+    if (self->prv->changed_id == 0) {
+        self->prv->changed_id = g_idle_add(flush_changed_rows, (gpointer)self);
+    }
+}
+
+static void
+foreach_collect (gpointer data, gpointer user_data)
+{
+    GPtrArray *objects = (GPtrArray *)user_data;
+
+    g_ptr_array_add(objects, data);
+}
+
+typedef struct {
+    GFunc       func;
+    gpointer    user_data;
+} foreach_wifi_data_t;
+
+static void
+foreach_wifi (gpointer key, gpointer value, gpointer user_data)
+{
+    foreach_wifi_data_t *data = (foreach_wifi_data_t *)user_data;
+
+    data->func(value, data->user_data);
+}
+
+static void
+foreach_ncu_foreach_wifi (NwamuiObject *container, GFunc func, gpointer user_data)
+{
+    NwamuiObject        *ncp = nwamui_daemon_get_active_ncp(NWAMUI_DAEMON(container));
+    foreach_wifi_data_t  data = { func, user_data };
+
+    if (ncp) {
+        nwamui_ncp_foreach_ncu_foreach_wifi_info(NWAMUI_NCP(ncp), foreach_wifi, &data);
+        g_object_unref(ncp);
+    }
+}
+
+/**
+ * nwamui_object_list_model_reload:
+ * @self: a #NwamuiObjectListModel.
+ *
+ * Walk the collection again and apply the difference to the rows. Rows
+ * of objects still listed are kept in place.
+ **/
+extern void
+nwamui_object_list_model_reload (NwamuiObjectListModel *self)
+{
+    NwamuiObjectListModelPrivate *prv;
+    GPtrArray                    *objects;
+    GHashTable                   *found;
+    GSequenceIter                *seq_iter;
+    GSList                       *gone = NULL;
+    guint                         i;
+
+    g_return_if_fail(NWAMUI_IS_OBJECT_LIST_MODEL(self));
+    prv = self->prv;
+
+    objects = g_ptr_array_new();
+    if (prv->ncu) {
+        foreach_wifi_data_t data = { foreach_collect, objects };
+
+        nwamui_ncu_wifi_hash_foreach(prv->ncu, foreach_wifi, &data);
+    } else {
+        prv->foreach_func(prv->container, foreach_collect, objects);
+    }
+
+    found = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (i = 0; i < objects->len; i++) {
+        if (accept_object(self, NWAMUI_OBJECT(objects->pdata[i]))) {
+            g_hash_table_insert(found, objects->pdata[i], objects->pdata[i]);
+        }
+    }
+
+    for (seq_iter = g_sequence_get_begin_iter(prv->rows);
+         !g_sequence_iter_is_end(seq_iter);
+         seq_iter = g_sequence_iter_next(seq_iter)) {
+        gpointer object = g_sequence_get(seq_iter);
+
+        if (!g_hash_table_lookup(found, object))
+            gone = g_slist_prepend(gone, object);
+    }
+    while (gone) {
+        row_remove(self, NWAMUI_OBJECT(gone->data));
+        gone = g_slist_delete_link(gone, gone);
+    }
+
+    for (i = 0; i < objects->len; i++) {
+        if (g_hash_table_lookup(found, objects->pdata[i]))
+            row_append(self, NWAMUI_OBJECT(objects->pdata[i]));
+    }
+
+    g_hash_table_destroy(found);
+    g_ptr_array_free(objects, TRUE);
+}
+
+static GtkTreeModel*
+object_list_model_new (NwamuiObject *container,
+  GType type,
+  NwamuiObjectListModelForeachFunc foreach_func,
+  NwamuiNcu *ncu)
+{
+    NwamuiObjectListModel *self;
+
+    self = NWAMUI_OBJECT_LIST_MODEL(g_object_new(NWAMUI_TYPE_OBJECT_LIST_MODEL, NULL));
+    self->prv->container = g_object_ref(container);
+    self->prv->type = type;
+    self->prv->foreach_func = foreach_func;
+    self->prv->ncu = ncu ? g_object_ref(ncu) : NULL;
+
+    g_signal_connect(container, "add", G_CALLBACK(container_add), (gpointer)self);
+    g_signal_connect(container, "remove", G_CALLBACK(container_remove), (gpointer)self);
+
+    nwamui_object_list_model_reload(self);
+
+    return GTK_TREE_MODEL(self);
+}
+
+/**
+ * nwamui_object_list_model_new:
+ * @container: the #NwamuiObject emitting "add" and "remove" for the collection.
+ * @type: the exact type of the listed objects.
+ * @foreach_func: walks the current objects of the collection.
+ * @returns: a new #GtkTreeModel with a single column holding the objects.
+ **/
+extern GtkTreeModel*
+nwamui_object_list_model_new (NwamuiObject *container,
+  GType type,
+  NwamuiObjectListModelForeachFunc foreach_func)
+{
+    g_return_val_if_fail(NWAMUI_IS_OBJECT(container), NULL);
+    g_return_val_if_fail(foreach_func != NULL, NULL);
+
+    return object_list_model_new(container, type, foreach_func, NULL);
+}
+
+/**
+ * nwamui_object_list_model_new_for_daemon:
+ * @type: one of NWAMUI_TYPE_NCP, NWAMUI_TYPE_ENV, NWAMUI_TYPE_ENM,
+ * NWAMUI_TYPE_KNOWN_WLAN, or NWAMUI_TYPE_WIFI_NET for the WLANs scanned by
+ * the active NCP.
+ * @returns: a new #GtkTreeModel listing the daemon objects of @type.
+ **/
+extern GtkTreeModel*
+nwamui_object_list_model_new_for_daemon (NwamuiDaemon *daemon, GType type)
+{
+    NwamuiObjectListModelForeachFunc foreach_func;
+
+    g_return_val_if_fail(NWAMUI_IS_DAEMON(daemon), NULL);
+
+    if (type == NWAMUI_TYPE_NCP) {
+        foreach_func = (NwamuiObjectListModelForeachFunc)nwamui_daemon_foreach_ncp;
+    } else if (type == NWAMUI_TYPE_ENV) {
+        foreach_func = (NwamuiObjectListModelForeachFunc)nwamui_daemon_foreach_loc;
+    } else if (type == NWAMUI_TYPE_ENM) {
+        foreach_func = (NwamuiObjectListModelForeachFunc)nwamui_daemon_foreach_enm;
+    } else if (type == NWAMUI_TYPE_KNOWN_WLAN) {
+        foreach_func = (NwamuiObjectListModelForeachFunc)nwamui_daemon_foreach_fav_wifi;
+    } else if (type == NWAMUI_TYPE_WIFI_NET) {
+        foreach_func = foreach_ncu_foreach_wifi;
+    } else {
+        g_warning("Unsupported object %s", g_type_name(type));
+        return NULL;
+    }
+
+    return nwamui_object_list_model_new(NWAMUI_OBJECT(daemon), type, foreach_func);
+}
+
+/**
+ * nwamui_object_list_model_new_for_ncp:
+ * @returns: a new #GtkTreeModel listing the NCUs of @ncp.
+ **/
+extern GtkTreeModel*
+nwamui_object_list_model_new_for_ncp (NwamuiNcp *ncp)
+{
+    g_return_val_if_fail(NWAMUI_IS_NCP(ncp), NULL);
+
+    return nwamui_object_list_model_new(NWAMUI_OBJECT(ncp), NWAMUI_TYPE_NCU,
+      (NwamuiObjectListModelForeachFunc)nwamui_ncp_foreach_ncu);
+}
+
+/**
+ * nwamui_object_list_model_new_for_wifi_nets:
+ * @ncu: a wireless #NwamuiNcu.
+ * @returns: a new #GtkTreeModel listing the WLANs scanned by @ncu.
+ **/
+extern GtkTreeModel*
+nwamui_object_list_model_new_for_wifi_nets (NwamuiNcu *ncu)
+{
+    NwamuiDaemon *daemon;
+    GtkTreeModel *model;
+
+    g_return_val_if_fail(NWAMUI_IS_NCU(ncu), NULL);
+
+    /* Scan results are added and removed through the daemon. */
+    daemon = nwamui_daemon_get_instance();
+    model = object_list_model_new(NWAMUI_OBJECT(daemon), NWAMUI_TYPE_WIFI_NET,
+      foreach_ncu_foreach_wifi, ncu);
+    g_object_unref(daemon);
+
+    return model;
+}
+
+/**
+ * nwamui_object_list_model_get_object:
+ * @returns: the ref'ed #NwamuiObject of the row at @iter.
+ **/
+extern NwamuiObject*
+nwamui_object_list_model_get_object (NwamuiObjectListModel *self, GtkTreeIter *iter)
+{
+    g_return_val_if_fail(NWAMUI_IS_OBJECT_LIST_MODEL(self), NULL);
+    g_return_val_if_fail(iter->stamp == self->prv->stamp, NULL);
+
+    return NWAMUI_OBJECT(g_object_ref(g_sequence_get((GSequenceIter *)iter->user_data)));
+}
+
+/**
+ * nwamui_object_list_model_get_iter:
+ * @returns: TRUE and fills @iter if @object is listed.
+ **/
+extern gboolean
+nwamui_object_list_model_get_iter (NwamuiObjectListModel *self,
+  NwamuiObject *object,
+  GtkTreeIter *iter)
+{
+    GSequenceIter *seq_iter;
+
+    g_return_val_if_fail(NWAMUI_IS_OBJECT_LIST_MODEL(self), FALSE);
+
+    if ((seq_iter = g_hash_table_lookup(self->prv->index, object)) == NULL)
+        return FALSE;
+
+    fill_iter(self, seq_iter, iter);
+    return TRUE;
+}
+
+/* GtkTreeModel implementation */
+static GtkTreeModelFlags
+nwamui_object_list_model_get_flags (GtkTreeModel *model)
+{
+    return GTK_TREE_MODEL_ITERS_PERSIST | GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint
+nwamui_object_list_model_get_n_columns (GtkTreeModel *model)
+{
+    return 1;
+}
+
+static GType
+nwamui_object_list_model_get_column_type (GtkTreeModel *model, gint index)
+{
+    g_return_val_if_fail(index == 0, G_TYPE_INVALID);
+
+    return NWAMUI_OBJECT_LIST_MODEL(model)->prv->type;
+}
+
+static gboolean
+nwamui_object_list_model_get_iter_from_path (GtkTreeModel *model, GtkTreeIter *iter, GtkTreePath *path)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(model);
+    gint                   i;
+
+    g_return_val_if_fail(gtk_tree_path_get_depth(path) > 0, FALSE);
+
+    i = gtk_tree_path_get_indices(path)[0];
+    if (i < 0 || i >= g_sequence_get_length(self->prv->rows))
+        return FALSE;
+
+    fill_iter(self, g_sequence_get_iter_at_pos(self->prv->rows, i), iter);
+    return TRUE;
+}
+
+static GtkTreePath *
+nwamui_object_list_model_get_path (GtkTreeModel *model, GtkTreeIter *iter)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(model);
+
+    g_return_val_if_fail(iter->stamp == self->prv->stamp, NULL);
+
+    if (g_sequence_iter_is_end((GSequenceIter *)iter->user_data))
+        return NULL;
+
+    return gtk_tree_path_new_from_indices(g_sequence_iter_get_position((GSequenceIter *)iter->user_data), -1);
+}
+
+static void
+nwamui_object_list_model_get_value (GtkTreeModel *model, GtkTreeIter *iter, gint column, GValue *value)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(model);
+
+    g_return_if_fail(column == 0);
+    g_return_if_fail(iter->stamp == self->prv->stamp);
+
+    g_value_init(value, self->prv->type);
+    g_value_set_object(value, g_sequence_get((GSequenceIter *)iter->user_data));
+}
+
+static gboolean
+nwamui_object_list_model_iter_next (GtkTreeModel *model, GtkTreeIter *iter)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(model);
+
+    g_return_val_if_fail(iter->stamp == self->prv->stamp, FALSE);
+
+    iter->user_data = g_sequence_iter_next((GSequenceIter *)iter->user_data);
+
+    return !g_sequence_iter_is_end((GSequenceIter *)iter->user_data);
+}
+
+static gboolean
+nwamui_object_list_model_iter_children (GtkTreeModel *model, GtkTreeIter *iter, GtkTreeIter *parent)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(model);
+
+    if (parent || g_sequence_get_length(self->prv->rows) == 0)
+        return FALSE;
+
+    fill_iter(self, g_sequence_get_begin_iter(self->prv->rows), iter);
+    return TRUE;
+}
+
+static gboolean
+nwamui_object_list_model_iter_has_child (GtkTreeModel *model, GtkTreeIter *iter)
+{
+    return FALSE;
+}
+
+static gint
+nwamui_object_list_model_iter_n_children (GtkTreeModel *model, GtkTreeIter *iter)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(model);
+
+    if (iter)
+        return 0;
+
+    return g_sequence_get_length(self->prv->rows);
+}
+
+static gboolean
+nwamui_object_list_model_iter_nth_child (GtkTreeModel *model, GtkTreeIter *iter, GtkTreeIter *parent, gint n)
+{
+    NwamuiObjectListModel *self = NWAMUI_OBJECT_LIST_MODEL(model);
+
+    if (parent || n < 0 || n >= g_sequence_get_length(self->prv->rows))
+        return FALSE;
+
+    fill_iter(self, g_sequence_get_iter_at_pos(self->prv->rows, n), iter);
+    return TRUE;
+}
+
+static gboolean
+nwamui_object_list_model_iter_parent (GtkTreeModel *model, GtkTreeIter *iter, GtkTreeIter *child)
+{
+    return FALSE;
+}
+
+static void
+nwamui_object_list_model_tree_model_init (GtkTreeModelIface *iface)
+{
+    iface->get_flags = nwamui_object_list_model_get_flags;
+    iface->get_n_columns = nwamui_object_list_model_get_n_columns;
+    iface->get_column_type = nwamui_object_list_model_get_column_type;
+    iface->get_iter = nwamui_object_list_model_get_iter_from_path;
+    iface->get_path = nwamui_object_list_model_get_path;
+    iface->get_value = nwamui_object_list_model_get_value;
+    iface->iter_next = nwamui_object_list_model_iter_next;
+    iface->iter_children = nwamui_object_list_model_iter_children;
+    iface->iter_has_child = nwamui_object_list_model_iter_has_child;
+    iface->iter_n_children = nwamui_object_list_model_iter_n_children;
+    iface->iter_nth_child = nwamui_object_list_model_iter_nth_child;
+    iface->iter_parent = nwamui_object_list_model_iter_parent;
+}
@@ -0,0 +1,93 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_object_list_model.h
+ *
+ */
+
+#ifndef _NWAMUI_OBJECT_LIST_MODEL_H
+#define	_NWAMUI_OBJECT_LIST_MODEL_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+#define NWAMUI_TYPE_OBJECT_LIST_MODEL               (nwamui_object_list_model_get_type ())
+#define NWAMUI_OBJECT_LIST_MODEL(obj)               (G_TYPE_CHECK_INSTANCE_CAST ((obj), NWAMUI_TYPE_OBJECT_LIST_MODEL, NwamuiObjectListModel))
+#define NWAMUI_OBJECT_LIST_MODEL_CLASS(klass)       (G_TYPE_CHECK_CLASS_CAST ((klass), NWAMUI_TYPE_OBJECT_LIST_MODEL, NwamuiObjectListModelClass))
+#define NWAMUI_IS_OBJECT_LIST_MODEL(obj)            (G_TYPE_CHECK_INSTANCE_TYPE ((obj), NWAMUI_TYPE_OBJECT_LIST_MODEL))
+#define NWAMUI_IS_OBJECT_LIST_MODEL_CLASS(klass)    (G_TYPE_CHECK_CLASS_TYPE ((klass), NWAMUI_TYPE_OBJECT_LIST_MODEL))
+#define NWAMUI_OBJECT_LIST_MODEL_GET_CLASS(obj)     (G_TYPE_INSTANCE_GET_CLASS ((obj), NWAMUI_TYPE_OBJECT_LIST_MODEL, NwamuiObjectListModelClass))
+
+typedef struct _NwamuiObjectListModel           NwamuiObjectListModel;
+typedef struct _NwamuiObjectListModelClass      NwamuiObjectListModelClass;
+typedef struct _NwamuiObjectListModelPrivate    NwamuiObjectListModelPrivate;
+
+struct _NwamuiObjectListModel
+{
+	GObject                          object;
+
+	/*< private >*/
+	NwamuiObjectListModelPrivate    *prv;
+};
+
+struct _NwamuiObjectListModelClass
+{
+	GObjectClass                     parent_class;
+};
+
+/*
+ * Walks the objects of a collection, e.g. nwamui_daemon_foreach_ncp() or
+ * nwamui_ncp_foreach_ncu().
+ */
+typedef void (*NwamuiObjectListModelForeachFunc)(NwamuiObject *container, GFunc func, gpointer user_data);
+
+extern GType          nwamui_object_list_model_get_type (void) G_GNUC_CONST;
+
+extern GtkTreeModel*  nwamui_object_list_model_new (NwamuiObject *container,
+                                                    GType type,
+                                                    NwamuiObjectListModelForeachFunc foreach_func);
+
+extern GtkTreeModel*  nwamui_object_list_model_new_for_daemon (NwamuiDaemon *daemon, GType type);
+
+extern GtkTreeModel*  nwamui_object_list_model_new_for_ncp (NwamuiNcp *ncp);
+
+extern GtkTreeModel*  nwamui_object_list_model_new_for_wifi_nets (NwamuiNcu *ncu);
+
+extern void           nwamui_object_list_model_reload (NwamuiObjectListModel *self);
+
+extern NwamuiObject*  nwamui_object_list_model_get_object (NwamuiObjectListModel *self, GtkTreeIter *iter);
+
+extern gboolean       nwamui_object_list_model_get_iter (NwamuiObjectListModel *self,
+                                                         NwamuiObject *object,
+                                                         GtkTreeIter *iter);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_OBJECT_LIST_MODEL_H */
@@ -35,7 +35,6 @@
 
 #include <glib-object.h>
 #include <glib/gi18n.h>
-#include <gconf/gconf-client.h>
 
 #include "libnwamui.h"
 
@@ -64,6 +63,7 @@ enum {
     PROP_NOTIFICATION_NCP_CHANGED,
     PROP_NOTIFICATION_LOCATION_CHANGED,
     PROP_NOTIFICATION_NWAM_UNAVAILABLE,
+    PROP_LAST
 };
 
 static guint nwamui_prof_signals [LAST_SIGNAL] = { 0 };
@@ -123,10 +123,46 @@ struct auth_data {
     PROF_GCONF_NOTIFICATION_ROOT "/nwam_unavailable"
 
 
+typedef struct {
+    guint        prop_id;
+    const gchar *key;
+} prof_key_t;
+
+/* The properties kept in the store, their type is the one of their pspec. */
+static const prof_key_t prof_keys[] = {
+    { PROP_JOIN_WIFI_NOT_IN_FAV, PROF_BOOL_JOIN_WIFI_NOT_IN_FAV },
+    { PROP_JOIN_ANY_FAV_WIFI, PROF_BOOL_JOIN_ANY_FAV_WIFI },
+    { PROP_ADD_ANY_NEW_WIFI_TO_FAV, PROF_BOOL_ADD_ANY_NEW_WIFI_TO_FAV },
+    { PROP_ACTION_ON_NO_FAV_NETWORKS, PROF_STRING_ACTION_ON_NO_FAV_NETWORKS },
+    { PROP_NOTIFICATION_DEFAULT_TIMEOUT, PROF_INT_NOTIFICATION_DEFAULT_TIMEOUT },
+    { PROP_NOTIFICATION_NCU_CONNECTED, PROF_BOOL_NOTIFICATION_NCU_CONNECTED },
+    { PROP_NOTIFICATION_NCU_DISCONNECTED, PROF_BOOL_NOTIFICATION_NCU_DISCONNECTED },
+    { PROP_NOTIFICATION_NCU_WIFI_CONNECT_FAILED, PROF_BOOL_NOTIFICATION_NCU_WIFI_CONNECT_FAILED },
+    { PROP_NOTIFICATION_NCU_WIFI_SELECTION_NEEDED, PROF_BOOL_NOTIFICATION_NCU_WIFI_SELECTION_NEEDED },
+    { PROP_NOTIFICATION_NCU_WIFI_KEY_NEEDED, PROF_BOOL_NOTIFICATION_NCU_WIFI_KEY_NEEDED },
+    { PROP_NOTIFICATION_NO_WIFI_NETWORKS, PROF_BOOL_NOTIFICATION_NO_WIFI_NETWORKS },
+    { PROP_NOTIFICATION_NCP_CHANGED, PROF_BOOL_NOTIFICATION_NCP_CHANGED },
+    { PROP_NOTIFICATION_LOCATION_CHANGED, PROF_BOOL_NOTIFICATION_LOCATION_CHANGED },
+    { PROP_NOTIFICATION_NWAM_UNAVAILABLE, PROF_BOOL_NOTIFICATION_NWAM_UNAVAILABLE },
+};
+
+static GParamSpec  *prof_pspecs[PROP_LAST] = { NULL };
+static GHashTable  *prof_key_table = NULL;     /* Key -> prof_key_t* */
+
+/* Store used by the instance, the default unless set before it is created. */
+static const nwamui_prof_store_t *default_store = NULL;
+static gpointer                   default_store_data = NULL;
+
 struct _NwamuiProfPrivate {
-    GConfClient *client;
-    guint        gconf_notify_id;
-    guint        ui_auth;
+    const nwamui_prof_store_t  *store;
+    gpointer                    store_data;
+    guint                       ui_auth;
+
+    /* The mirror of the store, by property id. */
+    GValue                      values[PROP_LAST];
+    /* Properties set since the last commit, a bit per property id. */
+    guint32                     dirty;
+    guint                       commit_id;
 };
 
 static void nwamui_prof_set_property ( GObject         *object,
@@ -141,9 +177,8 @@ static void nwamui_prof_get_property ( GObject         *object,
 
 static void nwamui_prof_finalize (NwamuiProf *self);
 
-static void gconf_notify_cb (GConfClient *client,
-  guint cnxn_id,
-  GConfEntry *entry,
+static void store_changed_cb (const gchar *key,
+  const GValue *value,
   gpointer user_data);
 
 static gboolean user_has_autoconf_auth(NwamuiProf *self);
@@ -158,6 +193,9 @@ nwamui_prof_class_init (NwamuiProfClass *klass)
 {
     /* Pointer to GObject Part of Class */
     GObjectClass *gobject_class = (GObjectClass*) klass;
+    GParamSpec  **pspecs;
+    guint         n_pspecs;
+    guint         i;
         
     /* Override Some Function Pointers */
     gobject_class->set_property = nwamui_prof_set_property;
@@ -292,33 +330,93 @@ nwamui_prof_class_init (NwamuiProfClass *klass)
         TRUE,
         G_PARAM_READWRITE));
 
+    /* Dispatch store changes by key rather than comparing every key. */
+    prof_key_table = g_hash_table_new(g_str_hash, g_str_equal);
+    pspecs = g_object_class_list_properties(gobject_class, &n_pspecs);
+    for (i = 0; i < n_pspecs; i++) {
+        if (pspecs[i]->owner_type == NWAMUI_TYPE_PROF && pspecs[i]->param_id < PROP_LAST) {
+            prof_pspecs[pspecs[i]->param_id] = pspecs[i];
+        }
+    }
+    g_free(pspecs);
+    for (i = 0; i < G_N_ELEMENTS(prof_keys); i++) {
+        g_assert(prof_pspecs[prof_keys[i].prop_id] != NULL);
+        g_hash_table_insert(prof_key_table, (gpointer)prof_keys[i].key, (gpointer)&prof_keys[i]);
+    }
 }
 
+/* Clamps a value read from the store or set to what the property allows. */
+static void
+prof_value_validate(guint prop_id, GValue *value)
+{
+    if (prop_id == PROP_ACTION_ON_NO_FAV_NETWORKS) {
+        gint conf_value = g_value_get_int(value);
+
+        if ( conf_value < (gint)NWAMUI_NO_FAV_ACTION_NONE ||
+             conf_value >= (gint)NWAMUI_NO_FAV_ACTION_LAST ) {
+            g_value_set_int(value, (gint)NWAMUI_NO_FAV_ACTION_NONE);
+        }
+    } else {
+        (void) g_param_value_validate(prof_pspecs[prop_id], value);
+    }
+}
 
 static void
 nwamui_prof_init (NwamuiProf *self)
 {
 	NwamuiProfPrivate *prv = GET_PRIVATE(self);
-    GError            *err = NULL;
+    guint              i;
+
 	self->prv              = prv;
     
     user_has_autoconf_auth(self);
 
-    prv->client = gconf_client_get_default ();
+    if (default_store != NULL) {
+        prv->store = default_store;
+        prv->store_data = default_store_data;
+        default_store = NULL;
+        default_store_data = NULL;
+    } else {
+#ifdef HAVE_GCONF
+        prv->store = &nwamui_prof_store_gconf;
+        prv->store_data = nwamui_prof_store_gconf_new(PROF_GCONF_ROOT);
+#else
+        gchar  *path = g_build_filename(g_get_user_config_dir(),
+          PACKAGE, "preferences", NULL);
+
+        prv->store = &nwamui_prof_store_keyfile;
+        prv->store_data = nwamui_prof_store_keyfile_new(path);
+        g_free(path);
+#endif /* HAVE_GCONF */
+    }
 
-    gconf_client_add_dir (prv->client,
-      PROF_GCONF_ROOT,
-      GCONF_CLIENT_PRELOAD_RECURSIVE,
-      &err);
+    /* Read everything once, later reads come from the mirror. */
+    for (i = 0; i < G_N_ELEMENTS(prof_keys); i++) {
+        guint       prop_id = prof_keys[i].prop_id;
+        GParamSpec *pspec = prof_pspecs[prop_id];
+        GValue     *value = &prv->values[prop_id];
 
-    if (err) {
-        g_error ("Unable to call gconf_client_add_dir: %s\n", err->message);
-        g_error_free (err);
+        g_value_init(value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+        if (!prv->store->get(prv->store_data, prof_keys[i].key, value)) {
+            g_param_value_set_default(pspec, value);
+        }
+        prof_value_validate(prop_id, value);
     }
 
     nwamui_prof_notify_begin(self);
 }
 
+static gboolean
+commit_idle(gpointer data)
+{
+    NwamuiProf *self = NWAMUI_PROF(data);
+
+    self->prv->commit_id = 0;
+    nwamui_prof_commit(self);
+
+    return FALSE;
+}
+
 static void
 nwamui_prof_set_property (GObject         *object,
   guint            prop_id,
@@ -326,133 +424,31 @@ nwamui_prof_set_property (GObject         *object,
   GParamSpec      *pspec)
 {
 	NwamuiProfPrivate *prv = GET_PRIVATE(object);
-    GError *err = NULL;
-
-    switch (prop_id) {
-    case PROP_JOIN_WIFI_NOT_IN_FAV: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_JOIN_WIFI_NOT_IN_FAV,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
+    GValue             new_value = { 0 };
 
-    case PROP_JOIN_ANY_FAV_WIFI: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_JOIN_ANY_FAV_WIFI,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_ADD_ANY_NEW_WIFI_TO_FAV: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_ADD_ANY_NEW_WIFI_TO_FAV,
-          g_value_get_boolean (value),
-          &err);
+    if (prop_id >= PROP_LAST || prof_pspecs[prop_id] == NULL ||
+      !G_IS_VALUE(&prv->values[prop_id])) {
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        return;
     }
-        break;
 
-    case PROP_ACTION_ON_NO_FAV_NETWORKS: {
-        gint conf_value;
+    g_value_init(&new_value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+    g_value_copy(value, &new_value);
+    prof_value_validate(prop_id, &new_value);
 
-        conf_value = g_value_get_int (value);
+    if (g_param_values_cmp(pspec, &new_value, &prv->values[prop_id]) != 0) {
+        g_value_copy(&new_value, &prv->values[prop_id]);
 
-        if ( conf_value < (gint)NWAMUI_NO_FAV_ACTION_NONE ||
-             conf_value >= (gint)NWAMUI_NO_FAV_ACTION_LAST ) {
-            conf_value = (gint)NWAMUI_NO_FAV_ACTION_NONE;
+        prv->dirty |= (1 << prop_id);
+        if (g_main_depth() == 0) {
+            /* No main loop to run the idle, e.g. a tool or after exit. */
+            nwamui_prof_commit(NWAMUI_PROF(object));
+        } else if (prv->commit_id == 0) {
+            /* Written on idle, with whatever else is set until then. */
+            prv->commit_id = g_idle_add(commit_idle, (gpointer)object);
         }
-
-        gconf_client_set_int (prv->client, PROF_STRING_ACTION_ON_NO_FAV_NETWORKS,
-                              conf_value, &err);
-    }
-        break;
-
-    case PROP_ACTIVE_INTERFACE: {
-        gconf_client_set_string (prv->client, PROF_STRING_ACTIVE_INTERFACE,
-          g_value_get_string (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_DEFAULT_TIMEOUT: {
-        gconf_client_set_int (prv->client,
-          PROF_INT_NOTIFICATION_DEFAULT_TIMEOUT,
-          g_value_get_int (value),
-          &err);
-    }
-        break;
-
-
-    case PROP_NOTIFICATION_NCU_CONNECTED: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NCU_CONNECTED,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_NCU_DISCONNECTED: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NCU_DISCONNECTED,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_NCU_WIFI_CONNECT_FAILED: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NCU_WIFI_CONNECT_FAILED,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_NCU_WIFI_SELECTION_NEEDED: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NCU_WIFI_SELECTION_NEEDED,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_NCU_WIFI_KEY_NEEDED: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NCU_WIFI_KEY_NEEDED,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_NO_WIFI_NETWORKS: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NO_WIFI_NETWORKS,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_NCP_CHANGED: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NCP_CHANGED,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_LOCATION_CHANGED: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_LOCATION_CHANGED,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    case PROP_NOTIFICATION_NWAM_UNAVAILABLE: {
-        gconf_client_set_bool (prv->client, PROF_BOOL_NOTIFICATION_NWAM_UNAVAILABLE,
-          g_value_get_boolean (value),
-          &err);
-    }
-        break;
-
-    default:
-        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
-        break;
-    }
-
-    if (err) {
-        g_error ("Unable to call gconf_client_set_xxx: %s\n", err->message);
-        g_error_free (err);
     }
+    g_value_unset(&new_value);
 }
 
 static void
@@ -462,133 +458,13 @@ nwamui_prof_get_property (GObject         *object,
   GParamSpec      *pspec)
 {
 	NwamuiProfPrivate *prv = GET_PRIVATE(object);
-    GError *err = NULL;
 
-    switch (prop_id) {
-    case PROP_UI_AUTH:
+    if (prop_id == PROP_UI_AUTH) {
         g_value_set_uint(value, nwamui_prof_get_ui_auth(NWAMUI_PROF(object)));
-        break;
-
-    case PROP_JOIN_WIFI_NOT_IN_FAV: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_JOIN_WIFI_NOT_IN_FAV,
-                                   &err));
-        }
-        break;
-
-    case PROP_JOIN_ANY_FAV_WIFI: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_JOIN_ANY_FAV_WIFI,
-                                   &err));
-        }
-        break;
-
-    case PROP_ADD_ANY_NEW_WIFI_TO_FAV: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_ADD_ANY_NEW_WIFI_TO_FAV,
-                                   &err));
-        }
-        break;
-
-    case PROP_ACTION_ON_NO_FAV_NETWORKS: {
-            gint conf_value;
-
-            conf_value = gconf_client_get_int (prv->client, PROF_STRING_ACTION_ON_NO_FAV_NETWORKS, &err);
-
-            if ( conf_value < (gint)NWAMUI_NO_FAV_ACTION_NONE ||
-                 conf_value >= (gint)NWAMUI_NO_FAV_ACTION_LAST ) {
-                conf_value = (gint)NWAMUI_NO_FAV_ACTION_NONE;
-            }
-
-            g_value_set_int (value, conf_value );
-        }
-        break;
-
-    case PROP_ACTIVE_INTERFACE: {
-            g_value_set_string (value, gconf_client_get_string (prv->client,
-                               PROF_STRING_ACTION_ON_NO_FAV_NETWORKS,
-                               &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_DEFAULT_TIMEOUT: {
-            g_value_set_int (value, gconf_client_get_int (prv->client,
-                PROF_INT_NOTIFICATION_DEFAULT_TIMEOUT,
-                &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NCU_CONNECTED: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NCU_CONNECTED,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NCU_DISCONNECTED: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NCU_DISCONNECTED,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NCU_WIFI_CONNECT_FAILED: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NCU_WIFI_CONNECT_FAILED,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NCU_WIFI_SELECTION_NEEDED: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NCU_WIFI_SELECTION_NEEDED,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NCU_WIFI_KEY_NEEDED: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NCU_WIFI_KEY_NEEDED,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NO_WIFI_NETWORKS: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NO_WIFI_NETWORKS,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NCP_CHANGED: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NCP_CHANGED,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_LOCATION_CHANGED: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_LOCATION_CHANGED,
-                                   &err));
-        }
-        break;
-
-    case PROP_NOTIFICATION_NWAM_UNAVAILABLE: {
-            g_value_set_boolean (value, gconf_client_get_bool (prv->client,
-                                   PROF_BOOL_NOTIFICATION_NWAM_UNAVAILABLE,
-                                   &err));
-        }
-        break;
-
-    default:
+    } else if (prop_id < PROP_LAST && G_IS_VALUE(&prv->values[prop_id])) {
+        g_value_copy(&prv->values[prop_id], value);
+    } else {
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
-        break;
-    }
-
-    if (err) {
-        g_error ("Unable to call gconf_client_get_xxx: %s\n", err->message);
-        g_error_free (err);
     }
 }
 
@@ -596,24 +472,20 @@ static void
 nwamui_prof_finalize (NwamuiProf *self)
 {
 	NwamuiProfPrivate *prv = GET_PRIVATE(self);
-    GError *err = NULL;
+    guint              i;
 
-    /* we may not need to remove notify */
-    if (prv->gconf_notify_id) {
-        gconf_client_notify_remove (prv->client, prv->gconf_notify_id);
+    if (prv->commit_id) {
+        g_source_remove(prv->commit_id);
+        prv->commit_id = 0;
     }
+    nwamui_prof_commit(self);
 
-    gconf_client_remove_dir (self->prv->client,
-      PROF_GCONF_ROOT,
-      &err);
-
-    if (err) {
-        g_error ("Unable to call gconf_client_remove_dir: %s\n", err->message);
-        g_error_free (err);
-    }
+    prv->store->free(prv->store_data);
 
-    if (prv->client) {
-        g_object_unref (prv->client);
+    for (i = 0; i < PROP_LAST; i++) {
+        if (G_IS_VALUE(&prv->values[i])) {
+            g_value_unset(&prv->values[i]);
+        }
     }
 
 	G_OBJECT_CLASS(nwamui_prof_parent_class)->finalize(G_OBJECT(self));
@@ -624,64 +496,46 @@ nwamui_prof_finalize (NwamuiProf *self)
 }
 
 static void
-gconf_notify_cb (GConfClient *client, guint cnxn_id, GConfEntry *entry, gpointer user_data)
+store_changed_cb (const gchar *key, const GValue *value, gpointer user_data)
 {
-    NwamuiProf *self = NWAMUI_PROF(user_data);
-    const char *key;
-    GConfValue *value;
-    gchar *basename;
-    
-    key = gconf_entry_get_key (entry);
-    value = gconf_entry_get_value (entry);
-    basename = g_path_get_basename(key);
-    
-    /* Broadcase the changes. */
-    g_object_notify(G_OBJECT(self), basename);
-    g_free(basename);
-
-    if (g_ascii_strcasecmp (key, PROF_BOOL_JOIN_WIFI_NOT_IN_FAV) == 0) {
-        nwamui_debug( "join_wifi_not_in_fav set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_JOIN_ANY_FAV_WIFI) == 0) {
-        nwamui_debug( "join_any_fav_wifi set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_ADD_ANY_NEW_WIFI_TO_FAV) == 0) {
-        nwamui_debug( "add_any_new_wifi_to_fav set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_STRING_ACTION_ON_NO_FAV_NETWORKS) == 0) {
-        nwamui_debug( "action_on_no_fav_networks set to %d",
-          gconf_value_get_int(value));
-    } else if (g_ascii_strcasecmp (key, PROF_INT_NOTIFICATION_DEFAULT_TIMEOUT ) == 0) {
-        nwamui_debug( "notification_default_timeout set to %d",
-          gconf_value_get_int(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NCU_CONNECTED) == 0) {
-        nwamui_debug( "ncu_connected set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NCU_DISCONNECTED) == 0) {
-        nwamui_debug( "ncu_disconnected set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NCU_WIFI_CONNECT_FAILED) == 0) {
-        nwamui_debug( "ncu_wifi_connect_failed set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NCU_WIFI_SELECTION_NEEDED) == 0) {
-        nwamui_debug( "ncu_wifi_selection_needed set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NCU_WIFI_KEY_NEEDED) == 0) {
-        nwamui_debug( "ncu_wifi_key_needed set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NO_WIFI_NETWORKS) == 0) {
-        nwamui_debug( "no_wifi_networks set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NCP_CHANGED) == 0) {
-        nwamui_debug( "ncp_changed set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_LOCATION_CHANGED) == 0) {
-        nwamui_debug( "location_changed set to %d",
-          gconf_value_get_bool(value));
-    } else if (g_ascii_strcasecmp (key, PROF_BOOL_NOTIFICATION_NWAM_UNAVAILABLE) == 0) {
-        nwamui_debug( "nwam_unavailable set to %d",
-          gconf_value_get_bool(value));
+    NwamuiProf          *self = NWAMUI_PROF(user_data);
+    NwamuiProfPrivate   *prv = self->prv;
+    const prof_key_t    *entry;
+    GParamSpec          *pspec;
+    GValue               new_value = { 0 };
+
+    if ((entry = g_hash_table_lookup(prof_key_table, key)) == NULL) {
+        return;
+    }
+
+    /* Our own pending write wins, the store will get it on commit. */
+    if (prv->dirty & (1 << entry->prop_id)) {
+        return;
+    }
+
+    pspec = prof_pspecs[entry->prop_id];
+    g_value_init(&new_value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+    if (value == NULL) {
+        g_param_value_set_default(pspec, &new_value);
+    } else if (!g_value_transform(value, &new_value)) {
+        nwamui_warning("%s: unexpected value type %s", key, G_VALUE_TYPE_NAME(value));
+        g_value_unset(&new_value);
+        return;
+    }
+    prof_value_validate(entry->prop_id, &new_value);
+
+    /* Which includes the echo of our own commits. */
+    if (g_param_values_cmp(pspec, &new_value, &prv->values[entry->prop_id]) != 0) {
+        gchar *contents = g_strdup_value_contents(&new_value);
+
+        nwamui_debug("%s set to %s", g_param_spec_get_name(pspec), contents);
+        g_free(contents);
+
+        g_value_copy(&new_value, &prv->values[entry->prop_id]);
+        /* Broadcast the changes. */
+        g_object_notify(G_OBJECT(self), g_param_spec_get_name(pspec));
     }
+    g_value_unset(&new_value);
 }
 
 static gboolean
@@ -799,19 +653,61 @@ nwamui_prof_check_ui_auth(NwamuiProf *self, gint auth)
 extern void
 nwamui_prof_notify_begin (NwamuiProf* self)
 {
-    GError *err = NULL;
-
-    self->prv->gconf_notify_id = gconf_client_notify_add (self->prv->client,
-      PROF_GCONF_ROOT,
-      gconf_notify_cb,
-      (gpointer) self,
-      NULL,
-      &err);
-    
-    if (err) {
-        g_error ("Unable to call gconf_client_notify_add: %s\n", err->message);
-        g_error_free (err);
+    g_return_if_fail (NWAMUI_IS_PROF(self));
+
+    if (self->prv->store->watch != NULL) {
+        self->prv->store->watch(self->prv->store_data, PROF_GCONF_ROOT,
+          store_changed_cb, (gpointer) self);
+    }
+}
+
+/**
+ * nwamui_prof_commit:
+ *
+ * Write the properties set since the last commit to the store now, rather
+ * than when the main loop is next idle. The instance is never finalized, so
+ * call it before exiting after setting properties from the main loop.
+ **/
+extern void
+nwamui_prof_commit (NwamuiProf* self)
+{
+    NwamuiProfPrivate *prv;
+    guint              i;
+
+    g_return_if_fail (NWAMUI_IS_PROF(self));
+
+    prv = self->prv;
+    if (prv->dirty == 0) {
+        return;
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(prof_keys); i++) {
+        if (prv->dirty & (1 << prof_keys[i].prop_id)) {
+            prv->store->set(prv->store_data, prof_keys[i].key, &prv->values[prof_keys[i].prop_id]);
+        }
     }
+    prv->dirty = 0;
+    prv->store->commit(prv->store_data);
+}
+
+/**
+ * nwamui_prof_set_store:
+ * @store: the store functions.
+ * @store_data: the store, e.g. from nwamui_prof_store_keyfile_new(), owned
+ * by the instance from then on.
+ *
+ * Sets the store of the #NwamuiProf instance, to be called before it is
+ * created. The default is GConf, or a keyfile in the user's config
+ * directory when built without GConf.
+ **/
+extern void
+nwamui_prof_set_store (const nwamui_prof_store_t *store, gpointer store_data)
+{
+    g_return_if_fail (instance == NULL);
+    g_return_if_fail (store != NULL);
+
+    default_store = store;
+    default_store_data = store_data;
 }
 
 const gchar*
@@ -101,6 +101,10 @@ extern gboolean             nwamui_prof_check_ui_auth(NwamuiProf *self, gint aut
 
 extern void                 nwamui_prof_notify_begin (NwamuiProf* self);
 
+extern void                 nwamui_prof_commit (NwamuiProf* self);
+
+extern void                 nwamui_prof_set_store (const nwamui_prof_store_t *store, gpointer store_data);
+
 extern void                 nwamui_prof_set_notification_default_timeout ( NwamuiProf *self, gint notification_default_timeout );
 
 extern gint                 nwamui_prof_get_notification_default_timeout (NwamuiProf* self);
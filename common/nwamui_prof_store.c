@@ -0,0 +1,373 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_prof_store.c
+ *
+ */
+
+#include <glib-object.h>
+#include <glib/gstdio.h>
+
+#include "libnwamui.h"
+
+#ifdef HAVE_GCONF
+#include <gconf/gconf-client.h>
+
+/*
+ * GConf store.
+ */
+typedef struct {
+    GConfClient                    *client;
+    gchar                          *root;
+    guint                           notify_id;
+    nwamui_prof_store_changed_func  func;
+    gpointer                        user_data;
+} gconf_store_t;
+
+static gboolean
+gconf_value_to_gvalue(const GConfValue *conf_value, GValue *value)
+{
+    switch (conf_value->type) {
+    case GCONF_VALUE_BOOL:
+        g_value_init(value, G_TYPE_BOOLEAN);
+        g_value_set_boolean(value, gconf_value_get_bool(conf_value));
+        return TRUE;
+    case GCONF_VALUE_INT:
+        g_value_init(value, G_TYPE_INT);
+        g_value_set_int(value, gconf_value_get_int(conf_value));
+        return TRUE;
+    case GCONF_VALUE_STRING:
+        g_value_init(value, G_TYPE_STRING);
+        g_value_set_string(value, gconf_value_get_string(conf_value));
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+extern gpointer
+nwamui_prof_store_gconf_new(const gchar *root)
+{
+    gconf_store_t  *store = g_new0(gconf_store_t, 1);
+    GError         *err = NULL;
+
+    store->client = gconf_client_get_default();
+    store->root = g_strdup(root);
+
+    gconf_client_add_dir(store->client, root, GCONF_CLIENT_PRELOAD_RECURSIVE, &err);
+    if (err) {
+        g_warning("Unable to call gconf_client_add_dir: %s", err->message);
+        g_error_free(err);
+    }
+    return store;
+}
+
+static gboolean
+gconf_store_get(gpointer data, const gchar *key, GValue *value)
+{
+    gconf_store_t  *store = (gconf_store_t *)data;
+    GConfValue     *conf_value;
+    GValue          read = { 0 };
+    GError         *err = NULL;
+    gboolean        rval = FALSE;
+
+    if ((conf_value = gconf_client_get(store->client, key, &err)) == NULL) {
+        if (err) {
+            g_warning("Unable to get %s: %s", key, err->message);
+            g_error_free(err);
+        }
+        return FALSE;
+    }
+
+    if (gconf_value_to_gvalue(conf_value, &read)) {
+        if (G_VALUE_TYPE(&read) == G_VALUE_TYPE(value)) {
+            g_value_copy(&read, value);
+            rval = TRUE;
+        } else {
+            g_warning("%s is a %s, expected a %s", key,
+              G_VALUE_TYPE_NAME(&read), G_VALUE_TYPE_NAME(value));
+        }
+        g_value_unset(&read);
+    }
+    gconf_value_free(conf_value);
+
+    return rval;
+}
+
+static void
+gconf_store_set(gpointer data, const gchar *key, const GValue *value)
+{
+    gconf_store_t  *store = (gconf_store_t *)data;
+    GError         *err = NULL;
+
+    switch (G_VALUE_TYPE(value)) {
+    case G_TYPE_BOOLEAN:
+        gconf_client_set_bool(store->client, key, g_value_get_boolean(value), &err);
+        break;
+    case G_TYPE_INT:
+        gconf_client_set_int(store->client, key, g_value_get_int(value), &err);
+        break;
+    case G_TYPE_STRING:
+        if (g_value_get_string(value) != NULL) {
+            gconf_client_set_string(store->client, key, g_value_get_string(value), &err);
+        } else {
+            gconf_client_unset(store->client, key, &err);
+        }
+        break;
+    default:
+        g_warning("Unable to store %s of type %s", key, G_VALUE_TYPE_NAME(value));
+        break;
+    }
+
+    if (err) {
+        g_warning("Unable to set %s: %s", key, err->message);
+        g_error_free(err);
+    }
+}
+
+static void
+gconf_store_commit(gpointer data)
+{
+    gconf_store_t  *store = (gconf_store_t *)data;
+    GError         *err = NULL;
+
+    gconf_client_suggest_sync(store->client, &err);
+    if (err) {
+        g_warning("Unable to call gconf_client_suggest_sync: %s", err->message);
+        g_error_free(err);
+    }
+}
+
+static void
+gconf_store_notify_cb(GConfClient *client, guint cnxn_id, GConfEntry *entry, gpointer user_data)
+{
+    gconf_store_t      *store = (gconf_store_t *)user_data;
+    const GConfValue   *conf_value = gconf_entry_get_value(entry);
+    GValue              value = { 0 };
+
+    if (conf_value == NULL) {
+        /* Unset, back to the default. */
+        store->func(gconf_entry_get_key(entry), NULL, store->user_data);
+    } else if (gconf_value_to_gvalue(conf_value, &value)) {
+        store->func(gconf_entry_get_key(entry), &value, store->user_data);
+        g_value_unset(&value);
+    }
+}
+
+static void
+gconf_store_watch(gpointer data, const gchar *root, nwamui_prof_store_changed_func func, gpointer user_data)
+{
+    gconf_store_t  *store = (gconf_store_t *)data;
+    GError         *err = NULL;
+
+    store->func = func;
+    store->user_data = user_data;
+    store->notify_id = gconf_client_notify_add(store->client, root,
+      gconf_store_notify_cb, store, NULL, &err);
+
+    if (err) {
+        g_warning("Unable to call gconf_client_notify_add: %s", err->message);
+        g_error_free(err);
+    }
+}
+
+static void
+gconf_store_free(gpointer data)
+{
+    gconf_store_t  *store = (gconf_store_t *)data;
+    GError         *err = NULL;
+
+    if (store->notify_id) {
+        gconf_client_notify_remove(store->client, store->notify_id);
+    }
+
+    gconf_client_remove_dir(store->client, store->root, &err);
+    if (err) {
+        g_warning("Unable to call gconf_client_remove_dir: %s", err->message);
+        g_error_free(err);
+    }
+
+    g_object_unref(store->client);
+    g_free(store->root);
+    g_free(store);
+}
+
+const nwamui_prof_store_t nwamui_prof_store_gconf = {
+    gconf_store_get,
+    gconf_store_set,
+    gconf_store_commit,
+    gconf_store_watch,
+    gconf_store_free
+};
+#endif /* HAVE_GCONF */
+
+/*
+ * Keyfile store, the directory of a key is its group and the basename its
+ * key, e.g. "[/apps/nwam-manager/notifications]" "ncu_connected=true".
+ * Nobody else writes the file while it's in use, so it isn't watched.
+ */
+typedef struct {
+    gchar      *path;
+    GKeyFile   *keyfile;
+    gboolean    dirty;
+} keyfile_store_t;
+
+extern gpointer
+nwamui_prof_store_keyfile_new(const gchar *path)
+{
+    keyfile_store_t    *store = g_new0(keyfile_store_t, 1);
+    GError             *err = NULL;
+
+    store->path = g_strdup(path);
+    store->keyfile = g_key_file_new();
+
+    if (!g_key_file_load_from_file(store->keyfile, path, G_KEY_FILE_KEEP_COMMENTS, &err)) {
+        if (!g_error_matches(err, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+            g_warning("Unable to load %s: %s", path, err->message);
+        }
+        g_error_free(err);
+    }
+    return store;
+}
+
+static gboolean
+keyfile_store_get(gpointer data, const gchar *key, GValue *value)
+{
+    keyfile_store_t    *store = (keyfile_store_t *)data;
+    gchar              *group = g_path_get_dirname(key);
+    gchar              *name = g_path_get_basename(key);
+    GError             *err = NULL;
+
+    if (g_key_file_has_key(store->keyfile, group, name, NULL)) {
+        switch (G_VALUE_TYPE(value)) {
+        case G_TYPE_BOOLEAN:
+            g_value_set_boolean(value, g_key_file_get_boolean(store->keyfile, group, name, &err));
+            break;
+        case G_TYPE_INT:
+            g_value_set_int(value, g_key_file_get_integer(store->keyfile, group, name, &err));
+            break;
+        case G_TYPE_STRING:
+            g_value_take_string(value, g_key_file_get_string(store->keyfile, group, name, &err));
+            break;
+        default:
+            g_set_error(&err, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+              "unsupported type %s", G_VALUE_TYPE_NAME(value));
+            break;
+        }
+    } else {
+        g_free(group);
+        g_free(name);
+        return FALSE;
+    }
+
+    g_free(group);
+    g_free(name);
+
+    if (err) {
+        g_warning("Unable to get %s: %s", key, err->message);
+        g_error_free(err);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void
+keyfile_store_set(gpointer data, const gchar *key, const GValue *value)
+{
+    keyfile_store_t    *store = (keyfile_store_t *)data;
+    gchar              *group = g_path_get_dirname(key);
+    gchar              *name = g_path_get_basename(key);
+
+    switch (G_VALUE_TYPE(value)) {
+    case G_TYPE_BOOLEAN:
+        g_key_file_set_boolean(store->keyfile, group, name, g_value_get_boolean(value));
+        break;
+    case G_TYPE_INT:
+        g_key_file_set_integer(store->keyfile, group, name, g_value_get_int(value));
+        break;
+    case G_TYPE_STRING:
+        if (g_value_get_string(value) != NULL) {
+            g_key_file_set_string(store->keyfile, group, name, g_value_get_string(value));
+        } else {
+            (void) g_key_file_remove_key(store->keyfile, group, name, NULL);
+        }
+        break;
+    default:
+        g_warning("Unable to store %s of type %s", key, G_VALUE_TYPE_NAME(value));
+        break;
+    }
+    store->dirty = TRUE;
+
+    g_free(group);
+    g_free(name);
+}
+
+static void
+keyfile_store_commit(gpointer data)
+{
+    keyfile_store_t    *store = (keyfile_store_t *)data;
+    gchar              *contents;
+    gchar              *dir;
+    gsize               length;
+    GError             *err = NULL;
+
+    if (!store->dirty) {
+        return;
+    }
+
+    dir = g_path_get_dirname(store->path);
+    (void) g_mkdir_with_parents(dir, 0700);
+    g_free(dir);
+
+    contents = g_key_file_to_data(store->keyfile, &length, NULL);
+    if (!g_file_set_contents(store->path, contents, length, &err)) {
+        g_warning("Unable to write %s: %s", store->path, err->message);
+        g_error_free(err);
+    } else {
+        store->dirty = FALSE;
+    }
+    g_free(contents);
+}
+
+static void
+keyfile_store_free(gpointer data)
+{
+    keyfile_store_t    *store = (keyfile_store_t *)data;
+
+    keyfile_store_commit(store);
+    g_key_file_free(store->keyfile);
+    g_free(store->path);
+    g_free(store);
+}
+
+const nwamui_prof_store_t nwamui_prof_store_keyfile = {
+    keyfile_store_get,
+    keyfile_store_set,
+    keyfile_store_commit,
+    NULL,
+    keyfile_store_free
+};
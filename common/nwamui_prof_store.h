@@ -0,0 +1,81 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_prof_store.h
+ *
+ */
+
+#ifndef _NWAMUI_PROF_STORE_H
+#define	_NWAMUI_PROF_STORE_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Where NwamuiProf keeps the preferences. NwamuiProf reads every key once
+ * into its mirror, writes the changed keys in one batch and is told about
+ * changes made by others, so a store is only a few calls. Keys are the
+ * full GConf paths, e.g. "/apps/nwam-manager/notification_default_timeout".
+ *
+ * The default store is GConf, the keyfile store lets the preferences be
+ * exercised without a GConf daemon and is the default when built without
+ * GConf.
+ */
+
+typedef void (*nwamui_prof_store_changed_func)(const gchar *key,
+  const GValue *value,
+  gpointer user_data);
+
+typedef struct {
+    /* Read a key into value, initialized to its type. FALSE if unset. */
+    gboolean    (*get)(gpointer data, const gchar *key, GValue *value);
+    /* Write a key, it may only be stored on commit. */
+    void        (*set)(gpointer data, const gchar *key, const GValue *value);
+    /* End of a batch of set. */
+    void        (*commit)(gpointer data);
+    /* Report changes below root made by others, may be NULL. */
+    void        (*watch)(gpointer data,
+                         const gchar *root,
+                         nwamui_prof_store_changed_func func,
+                         gpointer user_data);
+    void        (*free)(gpointer data);
+} nwamui_prof_store_t;
+
+#ifdef HAVE_GCONF
+extern const nwamui_prof_store_t nwamui_prof_store_gconf;
+extern gpointer     nwamui_prof_store_gconf_new(const gchar *root);
+#endif /* HAVE_GCONF */
+
+extern const nwamui_prof_store_t nwamui_prof_store_keyfile;
+extern gpointer     nwamui_prof_store_keyfile_new(const gchar *path);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_PROF_STORE_H */
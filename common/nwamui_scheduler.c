@@ -0,0 +1,349 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_scheduler.c
+ *
+ */
+
+#include <glib.h>
+#include <sys/time.h>
+
+#include "libnwamui.h"
+
+#define NSEC_PER_MSEC       (1000000LL)
+#define NSEC_PER_SEC        (1000000000LL)
+
+/* Coarse consumers due within this window are run along with an earlier
+ * wakeup.
+ */
+#define COALESCE_SLACK_MSEC (250)
+
+/* Window of the wakeups accounting, one bucket per second. */
+#define WAKEUP_BUCKETS      (60)
+
+typedef struct _sched_entry {
+    guint           id;
+    guint           interval;   /* In msec */
+    gboolean        coarse;
+    gboolean        suspended;
+    gboolean        removed;    /* Removed while dispatching */
+    hrtime_t        deadline;
+    GSourceFunc     func;
+    gpointer        data;
+    GDestroyNotify  notify;
+} sched_entry_t;
+
+static GList    *entries        = NULL;
+static guint     next_id        = 1;
+static guint     source_id      = 0;
+static hrtime_t  armed_deadline = 0;
+static gboolean  dispatching    = FALSE;
+
+static struct {
+    hrtime_t    second;
+    guint       count;
+} wakeups[WAKEUP_BUCKETS];
+
+static void     scheduler_rearm(void);
+static gboolean scheduler_dispatch(gpointer data);
+
+static hrtime_t
+scheduler_next_deadline(sched_entry_t *e, hrtime_t now)
+{
+    hrtime_t deadline = now + e->interval * NSEC_PER_MSEC;
+
+    if (e->coarse) {
+        /* Round up to the next second boundary. */
+        deadline = ((deadline + NSEC_PER_SEC - 1) / NSEC_PER_SEC) * NSEC_PER_SEC;
+    }
+    return deadline;
+}
+
+static sched_entry_t*
+scheduler_lookup(guint id)
+{
+    for (GList *l = entries; l; l = l->next) {
+        sched_entry_t *e = (sched_entry_t *)l->data;
+
+        if (e->id == id && !e->removed) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void
+scheduler_entry_free(sched_entry_t *e)
+{
+    if (e->notify) {
+        e->notify(e->data);
+    }
+    g_free(e);
+}
+
+static void
+scheduler_account_wakeup(hrtime_t now)
+{
+    hrtime_t second = now / NSEC_PER_SEC;
+    gint     idx    = (gint)(second % WAKEUP_BUCKETS);
+
+    if (wakeups[idx].second != second) {
+        wakeups[idx].second = second;
+        wakeups[idx].count = 0;
+    }
+    wakeups[idx].count++;
+}
+
+static void
+scheduler_rearm(void)
+{
+    hrtime_t now      = gethrtime();
+    hrtime_t earliest = 0;
+    hrtime_t delay;
+
+    if (dispatching) {
+        /* scheduler_dispatch() rearms when it's done. */
+        return;
+    }
+
+    for (GList *l = entries; l; l = l->next) {
+        sched_entry_t *e = (sched_entry_t *)l->data;
+
+        if (!e->suspended && (earliest == 0 || e->deadline < earliest)) {
+            earliest = e->deadline;
+        }
+    }
+
+    if (source_id > 0) {
+        if (earliest == armed_deadline) {
+            return;
+        }
+        g_source_remove(source_id);
+        source_id = 0;
+    }
+
+    armed_deadline = earliest;
+    if (earliest == 0) {
+        /* Nothing to do, stay asleep. */
+        return;
+    }
+
+    delay = earliest > now ? (earliest - now + NSEC_PER_MSEC - 1) / NSEC_PER_MSEC : 0;
+    source_id = g_timeout_add_full(G_PRIORITY_DEFAULT, (guint)delay,
+      scheduler_dispatch, NULL, NULL);
+}
+
+static gboolean
+scheduler_dispatch(gpointer data)
+{
+    hrtime_t  now = gethrtime();
+    GList    *due = NULL;
+    GList    *l;
+
+    source_id = 0;
+    armed_deadline = 0;
+    scheduler_account_wakeup(now);
+
+    for (l = entries; l; l = l->next) {
+        sched_entry_t *e     = (sched_entry_t *)l->data;
+        hrtime_t       slack = e->coarse ? COALESCE_SLACK_MSEC * NSEC_PER_MSEC : 0;
+
+        if (!e->suspended && e->deadline <= now + slack) {
+            due = g_list_prepend(due, e);
+        }
+    }
+    due = g_list_reverse(due);
+
+    /* Callbacks may add or remove consumers. */
+    dispatching = TRUE;
+    for (l = due; l; l = l->next) {
+        sched_entry_t *e = (sched_entry_t *)l->data;
+
+        if (e->removed || e->suspended) {
+            continue;
+        }
+        if (e->func(e->data)) {
+            e->deadline = scheduler_next_deadline(e, gethrtime());
+        } else {
+            e->removed = TRUE;
+        }
+    }
+    dispatching = FALSE;
+    g_list_free(due);
+
+    for (l = entries; l; ) {
+        GList         *next = l->next;
+        sched_entry_t *e    = (sched_entry_t *)l->data;
+
+        if (e->removed) {
+            entries = g_list_delete_link(entries, l);
+            scheduler_entry_free(e);
+        }
+        l = next;
+    }
+
+    scheduler_rearm();
+
+    return FALSE;
+}
+
+/**
+ * nwamui_scheduler_add:
+ * @interval_msec: interval in milliseconds.
+ * @coarse: TRUE if the consumer doesn't need precision, it is then aligned
+ * to second boundaries and coalesced with the others.
+ * @func: function to call, return FALSE to be removed.
+ * @data: data passed to @func.
+ * @notify: called on @data when the consumer is removed, or NULL.
+ * @returns: the id of the consumer.
+ *
+ * Adds a consumer to the scheduler, the same way as g_timeout_add_full().
+ *
+ **/
+extern guint
+nwamui_scheduler_add(guint          interval_msec,
+                     gboolean       coarse,
+                     GSourceFunc    func,
+                     gpointer       data,
+                     GDestroyNotify notify)
+{
+    sched_entry_t *e;
+
+    g_return_val_if_fail(func != NULL, 0);
+
+    e = g_new0(sched_entry_t, 1);
+    e->id = next_id++;
+    e->interval = interval_msec;
+    e->coarse = coarse;
+    e->func = func;
+    e->data = data;
+    e->notify = notify;
+    e->deadline = scheduler_next_deadline(e, gethrtime());
+
+    entries = g_list_append(entries, e);
+
+    scheduler_rearm();
+
+    return e->id;
+}
+
+/**
+ * nwamui_scheduler_add_seconds:
+ * @interval_sec: interval in seconds.
+ *
+ * Adds a coarse consumer, the same way as g_timeout_add_seconds_full().
+ *
+ **/
+extern guint
+nwamui_scheduler_add_seconds(guint          interval_sec,
+                             GSourceFunc    func,
+                             gpointer       data,
+                             GDestroyNotify notify)
+{
+    return nwamui_scheduler_add(interval_sec * 1000, TRUE, func, data, notify);
+}
+
+/**
+ * nwamui_scheduler_remove:
+ * @id: id of the consumer.
+ * @returns: TRUE if the consumer was found and removed.
+ *
+ **/
+extern gboolean
+nwamui_scheduler_remove(guint id)
+{
+    sched_entry_t *e = scheduler_lookup(id);
+
+    if (e == NULL) {
+        return FALSE;
+    }
+
+    if (dispatching) {
+        e->removed = TRUE;
+    } else {
+        entries = g_list_remove(entries, e);
+        scheduler_entry_free(e);
+        scheduler_rearm();
+    }
+    return TRUE;
+}
+
+/**
+ * nwamui_scheduler_set_suspended:
+ * @id: id of the consumer.
+ * @suspended: TRUE to suspend.
+ *
+ * Suspends a consumer which has nobody interested in its work, e.g. no
+ * wireless interface to refresh. A resumed consumer restarts its interval.
+ *
+ **/
+extern void
+nwamui_scheduler_set_suspended(guint id, gboolean suspended)
+{
+    sched_entry_t *e = scheduler_lookup(id);
+
+    g_return_if_fail(e != NULL);
+
+    if (e->suspended == suspended) {
+        return;
+    }
+
+    e->suspended = suspended;
+    if (!suspended) {
+        e->deadline = scheduler_next_deadline(e, gethrtime());
+    }
+    scheduler_rearm();
+}
+
+extern gboolean
+nwamui_scheduler_is_suspended(guint id)
+{
+    sched_entry_t *e = scheduler_lookup(id);
+
+    g_return_val_if_fail(e != NULL, FALSE);
+
+    return e->suspended;
+}
+
+/**
+ * nwamui_scheduler_get_wakeups_per_minute:
+ * @returns: number of wakeups of the scheduler in the last minute.
+ *
+ **/
+extern guint
+nwamui_scheduler_get_wakeups_per_minute(void)
+{
+    hrtime_t second = gethrtime() / NSEC_PER_SEC;
+    guint    count  = 0;
+
+    for (gint i = 0; i < WAKEUP_BUCKETS; i++) {
+        if (second - wakeups[i].second < WAKEUP_BUCKETS) {
+            count += wakeups[i].count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,75 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_scheduler.h
+ *
+ */
+
+#ifndef _NWAMUI_SCHEDULER_H
+#define	_NWAMUI_SCHEDULER_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * A single timer multiplexing all the periodic work of the UI, so the tray
+ * wakes up once for everything due at the same time instead of once per
+ * GSource.
+ *
+ * Coarse consumers are aligned to second boundaries, and are run early if
+ * the timer wakes up for somebody else shortly before they are due. Precise
+ * consumers fire on their own deadline. Suspended consumers don't arm the
+ * timer at all, with nothing pending the process makes no wakeups.
+ *
+ * All functions must be called from the main loop.
+ */
+
+extern guint    nwamui_scheduler_add(guint          interval_msec,
+                                     gboolean       coarse,
+                                     GSourceFunc    func,
+                                     gpointer       data,
+                                     GDestroyNotify notify);
+
+extern guint    nwamui_scheduler_add_seconds(guint          interval_sec,
+                                             GSourceFunc    func,
+                                             gpointer       data,
+                                             GDestroyNotify notify);
+
+extern gboolean nwamui_scheduler_remove(guint id);
+
+extern void     nwamui_scheduler_set_suspended(guint id, gboolean suspended);
+
+extern gboolean nwamui_scheduler_is_suspended(guint id);
+
+extern guint    nwamui_scheduler_get_wakeups_per_minute(void);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_SCHEDULER_H */
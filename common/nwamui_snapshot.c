@@ -0,0 +1,622 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_snapshot.c
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "libnwamui.h"
+
+#define SNAPSHOT_MAGIC          (0x4e575353)    /* "NWSS" */
+#define SNAPSHOT_VERSION        (1)
+#define SNAPSHOT_NO_STRING      (G_MAXUINT32)
+#define SNAPSHOT_FILE_NAME      "nwam-manager.snapshot"
+
+/* Changes are published at most once per this period. */
+#define SNAPSHOT_PUBLISH_DELAY_SEC  (1)
+
+/*
+ * File layout: the header, n_records records, strings_size bytes of NUL
+ * terminated strings the records point into, and the generation again.
+ */
+typedef struct {
+    guint32     magic;
+    guint32     version;
+    guint64     generation;
+    guint64     timestamp;      /* Seconds since the epoch */
+    guint32     pid;            /* Of the writer */
+    guint32     n_records;
+    guint32     strings_size;
+    guint32     checksum;       /* Of the records and the strings */
+} snapshot_header_t;
+
+typedef struct {
+    guint32     kind;
+    guint32     flags;
+    gint32      state;
+    gint32      aux_state;
+    gint32      activation_mode;
+    guint32     name;           /* Offsets into the strings */
+    guint32     parent;
+    guint32     reserved;
+    guint64     priority;
+} snapshot_record_t;
+
+struct _nwamui_snapshot {
+    gchar                      *path;
+    GMappedFile                *file;
+    struct stat                 st;
+    const snapshot_header_t    *header;
+    const snapshot_record_t    *records;
+    const gchar                *strings;
+};
+
+typedef struct {
+    GArray         *records;
+    GString        *strings;
+    GHashTable     *offsets;    /* String -> offset + 1 */
+    const gchar    *parent;
+} snapshot_builder_t;
+
+static guint64       snapshot_generation = 0;
+
+static NwamuiDaemon *publish_daemon = NULL;
+static gchar        *publish_path = NULL;
+static guint         publish_id = 0;
+
+/* FNV-1a */
+static guint32
+snapshot_checksum(const guint8 *data, gsize len)
+{
+    guint32 hash = 2166136261U;
+    gsize   i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/* Writer */
+
+static guint32
+builder_add_string(snapshot_builder_t *b, const gchar *str)
+{
+    gpointer    found;
+    guint32     offset;
+
+    if (str == NULL) {
+        return SNAPSHOT_NO_STRING;
+    }
+    if ((found = g_hash_table_lookup(b->offsets, str)) != NULL) {
+        return GPOINTER_TO_UINT(found) - 1;
+    }
+
+    offset = b->strings->len;
+    g_string_append_len(b->strings, str, strlen(str) + 1);
+    g_hash_table_insert(b->offsets, g_strdup(str), GUINT_TO_POINTER(offset + 1));
+
+    return offset;
+}
+
+static void
+builder_add_object(snapshot_builder_t *b, nwamui_snapshot_kind_t kind,
+  NwamuiObject *object, guint64 priority)
+{
+    snapshot_record_t   rec;
+    nwam_aux_state_t    aux_state = NWAM_AUX_STATE_UNINITIALIZED;
+
+    memset(&rec, 0, sizeof (rec));
+    rec.kind = kind;
+    rec.state = nwamui_object_get_nwam_state(object, &aux_state, NULL);
+    rec.aux_state = aux_state;
+    rec.activation_mode = nwamui_object_get_activation_mode(object);
+    rec.name = builder_add_string(b, nwamui_object_get_name(object));
+    rec.parent = builder_add_string(b, kind == NWAMUI_SNAPSHOT_NCU ? b->parent : NULL);
+    rec.priority = priority;
+
+    /* Neither NCPs nor known WLANs implement all of them */
+    if (kind != NWAMUI_SNAPSHOT_KNOWN_WLAN && nwamui_object_get_active(object)) {
+        rec.flags |= NWAMUI_SNAPSHOT_FLAG_ACTIVE;
+    }
+    if (kind != NWAMUI_SNAPSHOT_NCP && nwamui_object_get_enabled(object)) {
+        rec.flags |= NWAMUI_SNAPSHOT_FLAG_ENABLED;
+    }
+
+    g_array_append_val(b->records, rec);
+}
+
+static void
+snapshot_add_ncu(gpointer data, gpointer user_data)
+{
+    builder_add_object((snapshot_builder_t *)user_data, NWAMUI_SNAPSHOT_NCU,
+      NWAMUI_OBJECT(data), nwamui_ncu_get_priority_group(NWAMUI_NCU(data)));
+}
+
+static void
+snapshot_add_ncp(gpointer data, gpointer user_data)
+{
+    snapshot_builder_t *b = (snapshot_builder_t *)user_data;
+
+    builder_add_object(b, NWAMUI_SNAPSHOT_NCP, NWAMUI_OBJECT(data), 0);
+
+    b->parent = nwamui_object_get_name(NWAMUI_OBJECT(data));
+    nwamui_ncp_foreach_ncu(NWAMUI_NCP(data), snapshot_add_ncu, b);
+    b->parent = NULL;
+}
+
+static void
+snapshot_add_loc(gpointer data, gpointer user_data)
+{
+    builder_add_object((snapshot_builder_t *)user_data, NWAMUI_SNAPSHOT_LOC,
+      NWAMUI_OBJECT(data), 0);
+}
+
+static void
+snapshot_add_enm(gpointer data, gpointer user_data)
+{
+    builder_add_object((snapshot_builder_t *)user_data, NWAMUI_SNAPSHOT_ENM,
+      NWAMUI_OBJECT(data), 0);
+}
+
+static void
+snapshot_add_known_wlan(gpointer data, gpointer user_data)
+{
+    builder_add_object((snapshot_builder_t *)user_data, NWAMUI_SNAPSHOT_KNOWN_WLAN,
+      NWAMUI_OBJECT(data), nwamui_wifi_net_get_priority(NWAMUI_WIFI_NET(data)));
+}
+
+static gboolean
+write_all(int fd, const void *buf, gsize len)
+{
+    const guint8   *p = (const guint8 *)buf;
+    ssize_t         n;
+
+    while (len > 0) {
+        if ((n = write(fd, p, len)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return FALSE;
+        }
+        p += n;
+        len -= n;
+    }
+    return TRUE;
+}
+
+/**
+ * nwamui_snapshot_get_default_path:
+ * @returns: the file the tray publishes its snapshot in, under
+ * $XDG_RUNTIME_DIR or else the user's cache directory.
+ **/
+extern gchar*
+nwamui_snapshot_get_default_path(void)
+{
+    const gchar    *dir = g_getenv("XDG_RUNTIME_DIR");
+
+    if (dir == NULL || *dir == '\0') {
+        dir = g_get_user_cache_dir();
+    }
+    return g_build_filename(dir, SNAPSHOT_FILE_NAME, NULL);
+}
+
+/**
+ * nwamui_snapshot_write:
+ * @daemon: the objects to write.
+ * @path: where to, NULL for the default.
+ *
+ * Writes a snapshot to a temporary file and renames it over @path, so
+ * readers never see it half written.
+ *
+ * @returns: TRUE on success.
+ **/
+extern gboolean
+nwamui_snapshot_write(NwamuiDaemon *daemon, const gchar *path)
+{
+    snapshot_builder_t  b;
+    snapshot_header_t   header;
+    gchar              *default_path = NULL;
+    gchar              *dir;
+    gchar              *tmp_path;
+    gint                fd;
+    gboolean            ok;
+
+    g_return_val_if_fail(NWAMUI_IS_DAEMON(daemon), FALSE);
+
+    if (path == NULL) {
+        path = default_path = nwamui_snapshot_get_default_path();
+    }
+
+    nwamui_trace_begin("snapshot_write");
+
+    /* Keep counting up from the last snapshot, even across restarts. */
+    if (snapshot_generation == 0) {
+        nwamui_snapshot_t  *old = nwamui_snapshot_open(path);
+
+        if (old != NULL) {
+            snapshot_generation = nwamui_snapshot_get_generation(old);
+            nwamui_snapshot_close(old);
+        }
+    }
+
+    b.records = g_array_new(FALSE, FALSE, sizeof (snapshot_record_t));
+    b.strings = g_string_new(NULL);
+    b.offsets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    b.parent = NULL;
+
+    nwamui_daemon_foreach_ncp(daemon, snapshot_add_ncp, &b);
+    nwamui_daemon_foreach_loc(daemon, snapshot_add_loc, &b);
+    nwamui_daemon_foreach_enm(daemon, snapshot_add_enm, &b);
+    nwamui_daemon_foreach_fav_wifi(daemon, snapshot_add_known_wlan, &b);
+
+    memset(&header, 0, sizeof (header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.generation = ++snapshot_generation;
+    header.timestamp = (guint64)time(NULL);
+    header.pid = (guint32)getpid();
+    header.n_records = b.records->len;
+    header.strings_size = b.strings->len;
+    {
+        GString    *body = g_string_new_len(b.records->data,
+          b.records->len * sizeof (snapshot_record_t));
+
+        g_string_append_len(body, b.strings->str, b.strings->len);
+        header.checksum = snapshot_checksum((const guint8 *)body->str, body->len);
+        g_string_free(body, TRUE);
+    }
+
+    dir = g_path_get_dirname(path);
+    (void) g_mkdir_with_parents(dir, 0700);
+    g_free(dir);
+
+    tmp_path = g_strdup_printf("%s.XXXXXX", path);
+    if ((fd = g_mkstemp(tmp_path)) < 0) {
+        nwamui_warning("Can't create %s: %s", tmp_path, g_strerror(errno));
+        ok = FALSE;
+    } else {
+        ok = write_all(fd, &header, sizeof (header)) &&
+          write_all(fd, b.records->data, b.records->len * sizeof (snapshot_record_t)) &&
+          write_all(fd, b.strings->str, b.strings->len) &&
+          write_all(fd, &header.generation, sizeof (header.generation));
+        if (close(fd) != 0) {
+            ok = FALSE;
+        }
+        if (!ok || g_rename(tmp_path, path) != 0) {
+            nwamui_warning("Can't write %s: %s", path, g_strerror(errno));
+            (void) g_unlink(tmp_path);
+            ok = FALSE;
+        }
+    }
+
+    nwamui_debug("generation %" G_GUINT64_FORMAT ", %u objects", header.generation, header.n_records);
+
+    g_free(tmp_path);
+    g_array_free(b.records, TRUE);
+    g_string_free(b.strings, TRUE);
+    g_hash_table_destroy(b.offsets);
+    g_free(default_path);
+
+    nwamui_trace_end("snapshot_write");
+
+    return ok;
+}
+
+static gboolean
+snapshot_publish_timeout(gpointer data)
+{
+    publish_id = 0;
+
+    /* A half loaded daemon would make a half snapshot, the "hydrated"
+     * notification brings us back.
+     */
+    if (nwamui_daemon_is_hydrated(publish_daemon)) {
+        nwamui_snapshot_write(publish_daemon, publish_path);
+    }
+    return FALSE;
+}
+
+static void
+snapshot_schedule_publish(void)
+{
+    if (publish_id == 0) {
+        publish_id = nwamui_scheduler_add_seconds(SNAPSHOT_PUBLISH_DELAY_SEC,
+          snapshot_publish_timeout, NULL, NULL);
+    }
+}
+
+static void
+snapshot_on_object(NwamuiObject *object, NwamuiObject *child, gpointer data)
+{
+    snapshot_schedule_publish();
+}
+
+static void
+snapshot_on_notify(GObject *gobject, GParamSpec *arg1, gpointer data)
+{
+    snapshot_schedule_publish();
+}
+
+/**
+ * nwamui_snapshot_publish:
+ * @daemon: the daemon to publish.
+ *
+ * Keeps a snapshot of @daemon in the default path, rewritten shortly
+ * after objects are added or removed and the status or the active NCP or
+ * location change. Only one daemon is published at a time.
+ **/
+extern void
+nwamui_snapshot_publish(NwamuiDaemon *daemon)
+{
+    g_return_if_fail(NWAMUI_IS_DAEMON(daemon));
+    g_return_if_fail(publish_daemon == NULL);
+
+    publish_daemon = NWAMUI_DAEMON(g_object_ref(daemon));
+    publish_path = nwamui_snapshot_get_default_path();
+
+    g_signal_connect(daemon, "add", G_CALLBACK(snapshot_on_object), NULL);
+    g_signal_connect(daemon, "remove", G_CALLBACK(snapshot_on_object), NULL);
+    g_signal_connect(daemon, "notify::status", G_CALLBACK(snapshot_on_notify), NULL);
+    g_signal_connect(daemon, "notify::active-ncp", G_CALLBACK(snapshot_on_notify), NULL);
+    g_signal_connect(daemon, "notify::active-env", G_CALLBACK(snapshot_on_notify), NULL);
+    g_signal_connect(daemon, "notify::hydrated", G_CALLBACK(snapshot_on_notify), NULL);
+
+    snapshot_schedule_publish();
+}
+
+/**
+ * nwamui_snapshot_unpublish:
+ *
+ * Stops publishing and removes the snapshot, e.g. when the tray exits.
+ **/
+extern void
+nwamui_snapshot_unpublish(void)
+{
+    if (publish_daemon == NULL) {
+        return;
+    }
+
+    if (publish_id != 0) {
+        nwamui_scheduler_remove(publish_id);
+        publish_id = 0;
+    }
+    g_signal_handlers_disconnect_by_func(publish_daemon, (gpointer)snapshot_on_object, NULL);
+    g_signal_handlers_disconnect_by_func(publish_daemon, (gpointer)snapshot_on_notify, NULL);
+
+    (void) g_unlink(publish_path);
+
+    g_object_unref(publish_daemon);
+    publish_daemon = NULL;
+    g_free(publish_path);
+    publish_path = NULL;
+}
+
+/* Reader */
+
+static gboolean
+snapshot_writer_is_alive(const snapshot_header_t *header)
+{
+    return !(kill((pid_t)header->pid, 0) != 0 && errno == ESRCH);
+}
+
+static const gchar*
+snapshot_validate(nwamui_snapshot_t *snap)
+{
+    const gchar        *data = g_mapped_file_get_contents(snap->file);
+    gsize               len = g_mapped_file_get_length(snap->file);
+    gsize               body;
+    guint64             trailer;
+    guint32             i;
+
+    if (len < sizeof (snapshot_header_t) + sizeof (trailer)) {
+        return "short file";
+    }
+
+    snap->header = (const snapshot_header_t *)data;
+    if (snap->header->magic != SNAPSHOT_MAGIC) {
+        return "not a snapshot";
+    }
+    if (snap->header->version != SNAPSHOT_VERSION) {
+        return "other version";
+    }
+
+    body = len - sizeof (snapshot_header_t) - sizeof (trailer);
+    if (snap->header->n_records > body / sizeof (snapshot_record_t) ||
+      (gsize)snap->header->n_records * sizeof (snapshot_record_t) +
+      snap->header->strings_size != body) {
+        return "torn, size";
+    }
+
+    memcpy(&trailer, data + len - sizeof (trailer), sizeof (trailer));
+    if (trailer != snap->header->generation) {
+        return "torn, generation";
+    }
+    if (snapshot_checksum((const guint8 *)data + sizeof (snapshot_header_t), body) !=
+      snap->header->checksum) {
+        return "torn, checksum";
+    }
+
+    snap->records = (const snapshot_record_t *)(data + sizeof (snapshot_header_t));
+    snap->strings = (const gchar *)(snap->records + snap->header->n_records);
+
+    if (snap->header->strings_size > 0 &&
+      snap->strings[snap->header->strings_size - 1] != '\0') {
+        return "bad strings";
+    }
+    for (i = 0; i < snap->header->n_records; i++) {
+        const snapshot_record_t *rec = &snap->records[i];
+
+        if (rec->kind >= NWAMUI_SNAPSHOT_KIND_LAST ||
+          rec->name >= snap->header->strings_size ||
+          (rec->parent != SNAPSHOT_NO_STRING && rec->parent >= snap->header->strings_size)) {
+            return "bad record";
+        }
+    }
+
+    if (!snapshot_writer_is_alive(snap->header)) {
+        return "stale, writer is gone";
+    }
+
+    return NULL;
+}
+
+/**
+ * nwamui_snapshot_open:
+ * @path: the snapshot, NULL for the default.
+ *
+ * @returns: the mapped snapshot, or NULL if there is none, or it is of
+ * another version, torn or stale.
+ **/
+extern nwamui_snapshot_t*
+nwamui_snapshot_open(const gchar *path)
+{
+    nwamui_snapshot_t  *snap = g_new0(nwamui_snapshot_t, 1);
+    GError             *error = NULL;
+    const gchar        *reason;
+
+    snap->path = path ? g_strdup(path) : nwamui_snapshot_get_default_path();
+
+    /* Before mapping, so a newer file makes is_current() fail, not pass. */
+    if (g_stat(snap->path, &snap->st) != 0) {
+        nwamui_debug("No snapshot %s", snap->path);
+        nwamui_snapshot_close(snap);
+        return NULL;
+    }
+
+    if ((snap->file = g_mapped_file_new(snap->path, FALSE, &error)) == NULL) {
+        nwamui_warning("Can't map %s: %s", snap->path, error->message);
+        g_error_free(error);
+        nwamui_snapshot_close(snap);
+        return NULL;
+    }
+
+    if ((reason = snapshot_validate(snap)) != NULL) {
+        nwamui_debug("Ignoring snapshot %s: %s", snap->path, reason);
+        nwamui_snapshot_close(snap);
+        return NULL;
+    }
+
+    nwamui_debug("Snapshot %s generation %" G_GUINT64_FORMAT ", %u objects",
+      snap->path, snap->header->generation, snap->header->n_records);
+
+    return snap;
+}
+
+extern void
+nwamui_snapshot_close(nwamui_snapshot_t *snap)
+{
+    if (snap == NULL) {
+        return;
+    }
+    if (snap->file != NULL) {
+        g_mapped_file_free(snap->file);
+    }
+    g_free(snap->path);
+    g_free(snap);
+}
+
+/**
+ * nwamui_snapshot_is_current:
+ * @returns: FALSE if the snapshot was replaced since it was opened, or its
+ * writer is gone.
+ **/
+extern gboolean
+nwamui_snapshot_is_current(nwamui_snapshot_t *snap)
+{
+    struct stat     st;
+
+    g_return_val_if_fail(snap != NULL, FALSE);
+
+    if (g_stat(snap->path, &st) != 0 ||
+      st.st_ino != snap->st.st_ino ||
+      st.st_dev != snap->st.st_dev ||
+      st.st_mtime != snap->st.st_mtime ||
+      st.st_size != snap->st.st_size) {
+        return FALSE;
+    }
+    return snapshot_writer_is_alive(snap->header);
+}
+
+extern guint64
+nwamui_snapshot_get_generation(nwamui_snapshot_t *snap)
+{
+    g_return_val_if_fail(snap != NULL, 0);
+
+    return snap->header->generation;
+}
+
+extern guint
+nwamui_snapshot_get_size(nwamui_snapshot_t *snap)
+{
+    g_return_val_if_fail(snap != NULL, 0);
+
+    return snap->header->n_records;
+}
+
+/**
+ * nwamui_snapshot_get_entry:
+ * @entry: filled in, the strings point into the mapping and are valid
+ * until the snapshot is closed.
+ *
+ * @returns: FALSE if @index is out of range.
+ **/
+extern gboolean
+nwamui_snapshot_get_entry(nwamui_snapshot_t *snap, guint index, nwamui_snapshot_entry_t *entry)
+{
+    const snapshot_record_t *rec;
+
+    g_return_val_if_fail(snap != NULL && entry != NULL, FALSE);
+
+    if (index >= snap->header->n_records) {
+        return FALSE;
+    }
+
+    rec = &snap->records[index];
+    entry->kind = (nwamui_snapshot_kind_t)rec->kind;
+    entry->flags = rec->flags;
+    entry->state = (nwam_state_t)rec->state;
+    entry->aux_state = (nwam_aux_state_t)rec->aux_state;
+    entry->activation_mode = rec->activation_mode;
+    entry->priority = rec->priority;
+    entry->name = snap->strings + rec->name;
+    entry->parent = rec->parent != SNAPSHOT_NO_STRING ? snap->strings + rec->parent : NULL;
+
+    return TRUE;
+}
@@ -0,0 +1,105 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_snapshot.h
+ *
+ */
+
+#ifndef _NWAMUI_SNAPSHOT_H
+#define	_NWAMUI_SNAPSHOT_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Read-only snapshot of the objects nwam-manager has loaded, their names,
+ * states and priorities, published by the tray in a file under the user's
+ * runtime directory. nwam-manager-properties maps it to start from what
+ * the tray already knows, and checks it against libnwam in the
+ * background, see nwamui_daemon_set_startup_snapshot().
+ *
+ * The file is replaced atomically. A version, a generation repeated at
+ * both ends and a checksum catch snapshots of another version or which
+ * are torn, and the writer's pid ones left behind by a tray which is
+ * gone.
+ */
+
+typedef enum {
+    NWAMUI_SNAPSHOT_NCP = 0,
+    NWAMUI_SNAPSHOT_NCU,
+    NWAMUI_SNAPSHOT_LOC,
+    NWAMUI_SNAPSHOT_ENM,
+    NWAMUI_SNAPSHOT_KNOWN_WLAN,
+    NWAMUI_SNAPSHOT_KIND_LAST /* Not to be used directly */
+} nwamui_snapshot_kind_t;
+
+typedef enum {
+    NWAMUI_SNAPSHOT_FLAG_ACTIVE     = 1 << 0,
+    NWAMUI_SNAPSHOT_FLAG_ENABLED    = 1 << 1,
+} nwamui_snapshot_flags_t;
+
+typedef struct {
+    nwamui_snapshot_kind_t  kind;
+    guint                   flags;
+    nwam_state_t            state;
+    nwam_aux_state_t        aux_state;
+    gint                    activation_mode;
+    guint64                 priority;   /* NCU priority group, known WLAN priority */
+    const gchar            *name;
+    const gchar            *parent;     /* The NCP of an NCU, else NULL */
+} nwamui_snapshot_entry_t;
+
+typedef struct _nwamui_snapshot nwamui_snapshot_t;
+
+extern gchar*               nwamui_snapshot_get_default_path(void);
+
+extern gboolean             nwamui_snapshot_write(NwamuiDaemon *daemon, const gchar *path);
+
+extern void                 nwamui_snapshot_publish(NwamuiDaemon *daemon);
+
+extern void                 nwamui_snapshot_unpublish(void);
+
+extern nwamui_snapshot_t*   nwamui_snapshot_open(const gchar *path);
+
+extern void                 nwamui_snapshot_close(nwamui_snapshot_t *snap);
+
+extern gboolean             nwamui_snapshot_is_current(nwamui_snapshot_t *snap);
+
+extern guint64              nwamui_snapshot_get_generation(nwamui_snapshot_t *snap);
+
+extern guint                nwamui_snapshot_get_size(nwamui_snapshot_t *snap);
+
+extern gboolean             nwamui_snapshot_get_entry(nwamui_snapshot_t *snap,
+                                                      guint index,
+                                                      nwamui_snapshot_entry_t *entry);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_SNAPSHOT_H */
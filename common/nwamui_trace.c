@@ -0,0 +1,179 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_trace.c
+ *
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "libnwamui.h"
+
+/* Events kept per thread, the oldest are overwritten. */
+#define TRACE_RING_SIZE     (8192)
+
+typedef struct {
+    const gchar    *name;
+    hrtime_t        time;
+    gchar           phase;
+} trace_event_t;
+
+/* Each ring has a single writer, its thread, so recording only needs to
+ * publish the new head. Rings are chained onto a lock-free list at the
+ * first event of a thread and live as long as the process.
+ */
+typedef struct _trace_ring {
+    struct _trace_ring *next;
+    gint                tid;
+    volatile gint       head;       /* Events ever recorded */
+    trace_event_t       events[TRACE_RING_SIZE];
+} trace_ring_t;
+
+gboolean                nwamui_trace_enabled = FALSE;
+
+static gchar           *trace_filename = NULL;
+static hrtime_t         trace_start_time = 0;
+static trace_ring_t    *volatile trace_rings = NULL;
+static volatile gint    trace_next_tid = 1;
+static GStaticPrivate   trace_ring_key = G_STATIC_PRIVATE_INIT;
+
+static trace_ring_t*
+trace_ring_get(void)
+{
+    trace_ring_t *ring = (trace_ring_t *)g_static_private_get(&trace_ring_key);
+
+    if (G_UNLIKELY(ring == NULL)) {
+        trace_ring_t *head;
+
+        ring = g_new0(trace_ring_t, 1);
+        ring->tid = g_atomic_int_exchange_and_add(&trace_next_tid, 1);
+
+        do {
+            head = (trace_ring_t *)g_atomic_pointer_get(&trace_rings);
+            ring->next = head;
+        } while (!g_atomic_pointer_compare_and_exchange((gpointer *)&trace_rings, head, ring));
+
+        g_static_private_set(&trace_ring_key, ring, NULL);
+    }
+    return ring;
+}
+
+extern void
+nwamui_trace_record(const gchar *name, gchar phase)
+{
+    trace_ring_t    *ring = trace_ring_get();
+    gint             head = ring->head;
+    trace_event_t   *ev = &ring->events[head % TRACE_RING_SIZE];
+
+    ev->name = name;
+    ev->time = gethrtime();
+    ev->phase = phase;
+
+    /* Publish the event after it is completely written. */
+    g_atomic_int_set(&ring->head, head + 1);
+}
+
+/**
+ * nwamui_trace_start:
+ * @filename: where nwamui_trace_stop() writes the trace to.
+ *
+ * Start recording spans.
+ **/
+extern void
+nwamui_trace_start(const gchar *filename)
+{
+    g_return_if_fail(filename != NULL);
+
+    g_free(trace_filename);
+    trace_filename = g_strdup(filename);
+    trace_start_time = gethrtime();
+    nwamui_trace_enabled = TRUE;
+}
+
+static void
+trace_ring_append_json(trace_ring_t *ring, GString *out, gboolean *first)
+{
+    gint    head = g_atomic_int_get(&ring->head);
+    gint    count = MIN(head, TRACE_RING_SIZE);
+
+    for (gint i = head - count; i < head; i++) {
+        trace_event_t *ev = &ring->events[i % TRACE_RING_SIZE];
+
+        g_string_append_printf(out, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+          *first ? "" : ",",
+          ev->name,
+          ev->phase,
+          (gdouble)(ev->time - trace_start_time) / 1000.0,
+          (gint)getpid(),
+          ring->tid);
+        *first = FALSE;
+    }
+}
+
+/**
+ * nwamui_trace_stop:
+ *
+ * Stop recording and write out the recorded spans as Chrome trace event
+ * JSON, to the file given to nwamui_trace_start().
+ *
+ * @returns: TRUE if the file was written.
+ **/
+extern gboolean
+nwamui_trace_stop(void)
+{
+    GString        *out;
+    gboolean        first = TRUE;
+    gboolean        ret;
+    GError         *error = NULL;
+
+    if (!nwamui_trace_enabled) {
+        return FALSE;
+    }
+    nwamui_trace_enabled = FALSE;
+
+    out = g_string_new("{\"traceEvents\":[");
+    for (trace_ring_t *ring = (trace_ring_t *)g_atomic_pointer_get(&trace_rings);
+         ring != NULL;
+         ring = ring->next) {
+        trace_ring_append_json(ring, out, &first);
+    }
+    g_string_append(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    ret = g_file_set_contents(trace_filename, out->str, out->len, &error);
+    if (!ret) {
+        g_warning("Failed to write trace to %s: %s", trace_filename, error->message);
+        g_error_free(error);
+    } else {
+        g_debug("Trace written to %s", trace_filename);
+    }
+    g_string_free(out, TRUE);
+
+    return ret;
+}
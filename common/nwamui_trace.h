@@ -0,0 +1,72 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_trace.h
+ *
+ */
+
+#ifndef _NWAMUI_TRACE_H
+#define	_NWAMUI_TRACE_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Begin/end spans of the hot paths, recorded into a per-thread ring and
+ * written out in the Chrome trace event format, to be loaded into
+ * chrome://tracing.
+ *
+ * Span names must be string literals, only the pointer is recorded. While
+ * tracing isn't started a span costs a single branch.
+ */
+
+extern gboolean nwamui_trace_enabled;
+
+#define nwamui_trace_begin(_name)                                       \
+    G_STMT_START {                                                      \
+        if (G_UNLIKELY(nwamui_trace_enabled))                           \
+            nwamui_trace_record((_name), 'B');                          \
+    } G_STMT_END
+
+#define nwamui_trace_end(_name)                                         \
+    G_STMT_START {                                                      \
+        if (G_UNLIKELY(nwamui_trace_enabled))                           \
+            nwamui_trace_record((_name), 'E');                          \
+    } G_STMT_END
+
+extern void     nwamui_trace_record(const gchar *name, gchar phase);
+
+extern void     nwamui_trace_start(const gchar *filename);
+
+extern gboolean nwamui_trace_stop(void);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_TRACE_H */
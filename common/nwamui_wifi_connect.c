@@ -0,0 +1,782 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_wifi_connect.c
+ *
+ */
+
+#include <libnwam.h>
+#include <glib-object.h>
+#include <glib/gi18n.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <net/if.h>
+
+#include "libnwamui.h"
+
+#define CONNECT_TIMEOUT_SECS    (60)
+/* Bucket 0 is below 1 msec, bucket i below 2^i msec, the last is open. */
+#define HISTOGRAM_BUCKETS       (18)
+
+typedef enum {
+    JOB_SELECT,
+    JOB_KEY,
+    JOB_QUIT
+} job_type_t;
+
+typedef enum {
+    RESULT_DONE = 0,
+    RESULT_FAILED,
+    RESULT_TIMED_OUT,
+    RESULT_CANCELLED
+} op_result_t;
+
+/* Everything a libnwam call needs, owned by the worker until it is done. */
+typedef struct {
+    job_type_t      type;
+    guint           op_id;              /* 0 if not part of an attempt */
+    gchar          *device;
+    gchar          *essid;
+    uint32_t        secmode;
+    gboolean        add_to_favourites;  /* JOB_SELECT */
+    guint           keyslot;            /* JOB_KEY */
+    gchar          *key;                /* JOB_KEY */
+    hrtime_t        queued_at;
+    hrtime_t        done_at;
+    nwam_error_t    nerr;
+} connect_job_t;
+
+typedef struct {
+    guint                       id;
+    gchar                      *device;
+    gchar                      *essid;
+    nwamui_wifi_connect_stage_t stage;      /* Waiting for */
+    hrtime_t                    started_at;
+    hrtime_t                    stage_at;   /* When the previous stage was reached */
+    hrtime_t                    reached_at[NWAMUI_WIFI_CONNECT_STAGE_LAST];
+    guint                       timeout_id;
+    gboolean                    selecting;  /* Until the select returns */
+    gboolean                    need_key;   /* WLAN_NEED_KEY was seen */
+} connect_op_t;
+
+typedef struct {
+    guint           count;
+    guint           failed;
+    guint           timed_out;
+    guint           cancelled;
+    hrtime_t        total;
+    hrtime_t        max;
+    guint           buckets[HISTOGRAM_BUCKETS];
+} stage_stats_t;
+
+static const gchar *stage_names[NWAMUI_WIFI_CONNECT_STAGE_LAST + 1] = {
+    "select",
+    "key",
+    "associate",
+    "link-up",
+    "address",
+    "total"
+};
+
+static const gchar *result_names[] = {
+    "done",
+    "failed",
+    "timed out",
+    "cancelled"
+};
+
+static GAsyncQueue     *job_queue = NULL;
+static GThread         *worker = NULL;
+static gboolean         shut_down = FALSE;
+static GHashTable      *ops = NULL;             /* Device -> connect_op_t* */
+static guint            last_op_id = 0;
+static guint            timeout_secs = CONNECT_TIMEOUT_SECS;
+static stage_stats_t    stage_stats[NWAMUI_WIFI_CONNECT_STAGE_LAST + 1];
+
+static gboolean job_done_idle(gpointer data);
+static gboolean op_timeout(gpointer data);
+
+static void
+job_free(connect_job_t *job)
+{
+    g_free(job->device);
+    g_free(job->essid);
+    if (job->key != NULL) {
+        /* Don't leave the key around in freed memory. */
+        memset(job->key, 0, strlen(job->key));
+        g_free(job->key);
+    }
+    g_free(job);
+}
+
+static void
+run_job(connect_job_t *job)
+{
+    switch (job->type) {
+    case JOB_SELECT:
+        job->nerr = nwam_wlan_select(job->device, job->essid, NULL, job->secmode,
+          job->add_to_favourites ? B_TRUE : B_FALSE);
+        break;
+    case JOB_KEY:
+        job->nerr = nwam_wlan_set_key(job->device, job->essid, NULL, job->secmode,
+          job->keyslot, job->key);
+        break;
+    case JOB_QUIT:
+        break;
+    }
+    job->done_at = gethrtime();
+}
+
+/* One worker, so the key of a network is set before it is selected. */
+static gpointer
+connect_worker_thread(gpointer data)
+{
+    for (;;) {
+        connect_job_t *job = (connect_job_t *)g_async_queue_pop(job_queue);
+
+        if (job->type == JOB_QUIT) {
+            job_free(job);
+            break;
+        }
+        run_job(job);
+        g_idle_add(job_done_idle, job);
+    }
+    return NULL;
+}
+
+static void
+queue_job(connect_job_t *job)
+{
+    GError *error = NULL;
+
+    job->queued_at = gethrtime();
+    shut_down = FALSE;
+
+    if (job_queue == NULL) {
+        job_queue = g_async_queue_new();
+        if ((worker = g_thread_create(connect_worker_thread, NULL, TRUE, &error)) == NULL) {
+            nwamui_warning("Unable to create the wireless connect thread: %s", error->message);
+            g_error_free(error);
+            g_async_queue_unref(job_queue);
+            job_queue = NULL;
+        }
+    }
+
+    if (job_queue != NULL) {
+        g_async_queue_push(job_queue, job);
+    } else {
+        /* Block as we used to rather than not connect at all. */
+        run_job(job);
+        g_idle_add(job_done_idle, job);
+    }
+}
+
+static void
+stats_record(nwamui_wifi_connect_stage_t stage, hrtime_t delay)
+{
+    stage_stats_t  *s = &stage_stats[stage];
+    guint64         msec = (guint64)delay / 1000000;
+    guint           bucket = 0;
+
+    while (msec > 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+        msec >>= 1;
+        bucket++;
+    }
+
+    s->count++;
+    s->total += delay;
+    s->max = MAX(s->max, delay);
+    s->buckets[bucket]++;
+}
+
+static void
+stats_record_result(nwamui_wifi_connect_stage_t stage, op_result_t result)
+{
+    stage_stats_t  *s = &stage_stats[stage];
+
+    switch (result) {
+    case RESULT_FAILED:
+        s->failed++;
+        break;
+    case RESULT_TIMED_OUT:
+        s->timed_out++;
+        break;
+    case RESULT_CANCELLED:
+        s->cancelled++;
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+op_free(gpointer data)
+{
+    connect_op_t   *op = (connect_op_t *)data;
+
+    if (op->timeout_id != 0) {
+        g_source_remove(op->timeout_id);
+    }
+    g_free(op->device);
+    g_free(op->essid);
+    g_free(op);
+}
+
+static connect_op_t*
+op_lookup(const gchar *device)
+{
+    return ops != NULL ? (connect_op_t *)g_hash_table_lookup(ops, device) : NULL;
+}
+
+static void
+op_finish(connect_op_t *op, op_result_t result)
+{
+    hrtime_t    now = gethrtime();
+
+    if (result == RESULT_DONE) {
+        stats_record(NWAMUI_WIFI_CONNECT_STAGE_LAST, op->stage_at - op->started_at);
+    } else {
+        stats_record_result(op->stage, result);
+        stats_record_result(NWAMUI_WIFI_CONNECT_STAGE_LAST, result);
+    }
+
+    nwamui_log_debug(NWAMUI_LOG_CAT_SCAN, "connect %s on %s %s at %s after %llu ms",
+      op->essid, op->device, result_names[result], stage_names[op->stage],
+      (unsigned long long)((result == RESULT_DONE ? op->stage_at : now) - op->started_at) / 1000000);
+
+    /* Frees op. */
+    g_hash_table_remove(ops, op->device);
+}
+
+/* Records the stages reached, in order, the key stage is optional. */
+static void
+op_advance(connect_op_t *op)
+{
+    while (op->stage < NWAMUI_WIFI_CONNECT_STAGE_LAST) {
+        if (op->reached_at[op->stage] != 0) {
+            hrtime_t at = MAX(op->reached_at[op->stage], op->stage_at);
+
+            stats_record(op->stage, at - op->stage_at);
+            op->stage_at = at;
+            op->stage++;
+        } else if (op->stage == NWAMUI_WIFI_CONNECT_STAGE_KEY &&
+          op->reached_at[NWAMUI_WIFI_CONNECT_STAGE_ASSOCIATE] != 0) {
+            /* No key was needed. */
+            op->stage++;
+        } else {
+            break;
+        }
+    }
+
+    if (op->stage == NWAMUI_WIFI_CONNECT_STAGE_LAST) {
+        op_finish(op, RESULT_DONE);
+    }
+}
+
+static void
+op_reached(connect_op_t *op, nwamui_wifi_connect_stage_t stage)
+{
+    if (op->reached_at[stage] == 0) {
+        op->reached_at[stage] = gethrtime();
+    }
+    op_advance(op);
+}
+
+static gboolean
+op_timeout(gpointer data)
+{
+    connect_op_t   *op = (connect_op_t *)data;
+
+    op->timeout_id = 0;
+    op_finish(op, RESULT_TIMED_OUT);
+
+    return FALSE;
+}
+
+static void
+op_reset_timeout(connect_op_t *op)
+{
+    if (op->timeout_id != 0) {
+        g_source_remove(op->timeout_id);
+    }
+    op->timeout_id = g_timeout_add_seconds(timeout_secs, op_timeout, op);
+}
+
+/*
+ * Times the attempt from @stage again, under a new id so the calls made
+ * for it before are ignored. Once nwamd asked for a key, the time taken to
+ * enter it isn't part of any stage.
+ */
+static void
+op_restart(connect_op_t *op, nwamui_wifi_connect_stage_t stage)
+{
+    op->id = ++last_op_id;
+    op->stage = stage;
+    memset(op->reached_at, 0, sizeof (op->reached_at));
+    op->started_at = op->stage_at = gethrtime();
+    op->selecting = FALSE;
+    op->need_key = FALSE;
+    op_reset_timeout(op);
+}
+
+static void
+report_error(const gchar *message)
+{
+    NwamuiDaemon   *daemon = nwamui_daemon_get_instance();
+
+    nwamui_object_event(NWAMUI_OBJECT(daemon), NWAMUI_DAEMON_INFO_GENERIC, message);
+    g_object_unref(daemon);
+}
+
+static gboolean
+job_done_idle(gpointer data)
+{
+    connect_job_t  *job = (connect_job_t *)data;
+    connect_op_t   *op = op_lookup(job->device);
+
+    if (op != NULL && op->id != job->op_id) {
+        /* Cancelled, timed out or restarted meanwhile. */
+        op = NULL;
+    }
+    if (shut_down) {
+        job_free(job);
+        return FALSE;
+    }
+
+    switch (job->type) {
+    case JOB_SELECT:
+        if (op == NULL) {
+            break;
+        }
+        op->selecting = FALSE;
+        if (job->nerr != NWAM_SUCCESS) {
+            if (job->nerr == NWAM_ENTITY_INVALID_STATE) {
+                report_error(_("Failed to connect to wireless network, please try it later."));
+            } else {
+                g_warning("Error selecting network with NWAM : %s", nwam_strerror(job->nerr));
+            }
+            op_finish(op, RESULT_FAILED);
+        } else {
+            op->reached_at[NWAMUI_WIFI_CONNECT_STAGE_SELECT] = job->done_at;
+            op_advance(op);
+        }
+        break;
+
+    case JOB_KEY:
+        if (job->nerr != NWAM_SUCCESS) {
+            g_warning("Error saving network key NWAM : %s", nwam_strerror(job->nerr));
+            report_error(_("Failed to store network key."));
+            if (op != NULL) {
+                op_finish(op, RESULT_FAILED);
+            } else {
+                stats_record_result(NWAMUI_WIFI_CONNECT_STAGE_KEY, RESULT_FAILED);
+            }
+        } else if (op != NULL) {
+            /* Set while connecting, usually on WLAN_NEED_KEY. */
+            op->reached_at[NWAMUI_WIFI_CONNECT_STAGE_KEY] = job->done_at;
+            op_advance(op);
+        } else {
+            stats_record(NWAMUI_WIFI_CONNECT_STAGE_KEY, job->done_at - job->queued_at);
+        }
+        break;
+
+    case JOB_QUIT:
+        break;
+    }
+
+    job_free(job);
+
+    return FALSE;
+}
+
+/**
+ * nwamui_wifi_connect_start:
+ * @device: the wireless link.
+ * @essid: the network.
+ * @secmode: a dladm_wlan_secmode_t.
+ * @add_to_favourites: add the network to the known WLANs.
+ *
+ * Start an attempt to connect @device to @essid. An attempt to another
+ * network is cancelled. One to the same network is only left alone while
+ * its select is in progress, after that nwamd needs another select, e.g.
+ * once it asked for a key, so the attempt starts over.
+ **/
+extern void
+nwamui_wifi_connect_start(const gchar *device,
+  const gchar *essid,
+  uint32_t secmode,
+  gboolean add_to_favourites)
+{
+    connect_op_t   *op;
+    connect_job_t  *job;
+
+    g_return_if_fail(device != NULL && essid != NULL);
+
+    if (ops == NULL) {
+        ops = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, op_free);
+    }
+
+    if ((op = op_lookup(device)) != NULL && strcmp(op->essid, essid) != 0) {
+        op_finish(op, RESULT_CANCELLED);
+        op = NULL;
+    }
+
+    if (op == NULL) {
+        op = g_new0(connect_op_t, 1);
+        op->device = g_strdup(device);
+        op->essid = g_strdup(essid);
+        g_hash_table_insert(ops, op->device, op);
+    } else if (op->selecting && !op->need_key) {
+        nwamui_debug("Already selecting %s on %s", essid, device);
+        return;
+    }
+    op_restart(op, NWAMUI_WIFI_CONNECT_STAGE_SELECT);
+    op->selecting = TRUE;
+
+    job = g_new0(connect_job_t, 1);
+    job->type = JOB_SELECT;
+    job->op_id = op->id;
+    job->device = g_strdup(device);
+    job->essid = g_strdup(essid);
+    job->secmode = secmode;
+    job->add_to_favourites = add_to_favourites;
+    queue_job(job);
+}
+
+/**
+ * nwamui_wifi_connect_store_key:
+ *
+ * Set the key of a network on the worker, after the requests queued before.
+ * Failures are reported as a NWAMUI_DAEMON_INFO_GENERIC daemon event. An
+ * attempt to the network on @device is timed from the key on.
+ **/
+extern void
+nwamui_wifi_connect_store_key(const gchar *device,
+  const gchar *essid,
+  uint32_t secmode,
+  guint keyslot,
+  const gchar *key)
+{
+    connect_op_t   *op;
+    connect_job_t  *job;
+
+    g_return_if_fail(device != NULL && essid != NULL);
+
+    job = g_new0(connect_job_t, 1);
+    if ((op = op_lookup(device)) != NULL && strcmp(op->essid, essid) == 0) {
+        op_restart(op, NWAMUI_WIFI_CONNECT_STAGE_KEY);
+        job->op_id = op->id;
+    }
+    job->type = JOB_KEY;
+    job->device = g_strdup(device);
+    job->essid = g_strdup(essid);
+    job->secmode = secmode;
+    job->keyslot = keyslot;
+    job->key = g_strdup(key ? key : "");
+    queue_job(job);
+}
+
+/**
+ * nwamui_wifi_connect_cancel:
+ * @device: the wireless link.
+ *
+ * Stop tracking the attempt on @device. The libnwam call in progress, if
+ * any, still completes.
+ *
+ * @returns: TRUE if an attempt was in flight.
+ **/
+extern gboolean
+nwamui_wifi_connect_cancel(const gchar *device)
+{
+    connect_op_t   *op = op_lookup(device);
+
+    if (op == NULL) {
+        return FALSE;
+    }
+    op_finish(op, RESULT_CANCELLED);
+    return TRUE;
+}
+
+/**
+ * nwamui_wifi_connect_get_stage:
+ * @device: the wireless link.
+ *
+ * @returns: the stage the attempt on @device waits for, or
+ * NWAMUI_WIFI_CONNECT_STAGE_LAST if none is in flight.
+ **/
+extern nwamui_wifi_connect_stage_t
+nwamui_wifi_connect_get_stage(const gchar *device)
+{
+    connect_op_t   *op = op_lookup(device);
+
+    return op != NULL ? op->stage : NWAMUI_WIFI_CONNECT_STAGE_LAST;
+}
+
+/**
+ * nwamui_wifi_connect_handle_event:
+ * @event: an event from nwamd.
+ *
+ * Moves the attempts on the link of @event along, called by the daemon for
+ * every event, in the main loop.
+ **/
+extern void
+nwamui_wifi_connect_handle_event(nwam_event_t event)
+{
+    connect_op_t   *op;
+
+    if (ops == NULL || g_hash_table_size(ops) == 0) {
+        return;
+    }
+
+    switch (event->nwe_type) {
+    case NWAM_EVENT_TYPE_WLAN_CONNECTION_REPORT: {
+        const nwam_wlan_t  *wlan = &event->nwe_data.nwe_wlan_info.nwe_wlans[0];
+
+        if ((op = op_lookup(event->nwe_data.nwe_wlan_info.nwe_name)) == NULL) {
+            break;
+        }
+        if (event->nwe_data.nwe_wlan_info.nwe_num_wlans > 0 &&
+          strcmp(wlan->nww_essid, op->essid) != 0) {
+            /* Connected elsewhere, or the failure of an earlier attempt. */
+            if (event->nwe_data.nwe_wlan_info.nwe_connected) {
+                op_finish(op, RESULT_FAILED);
+            }
+        } else if (event->nwe_data.nwe_wlan_info.nwe_connected) {
+            op_reached(op, NWAMUI_WIFI_CONNECT_STAGE_ASSOCIATE);
+        } else {
+            op_finish(op, RESULT_FAILED);
+        }
+    }
+        break;
+
+    case NWAM_EVENT_TYPE_WLAN_NEED_KEY:
+        if ((op = op_lookup(event->nwe_data.nwe_wlan_info.nwe_name)) != NULL &&
+          event->nwe_data.nwe_wlan_info.nwe_num_wlans > 0 &&
+          strcmp(event->nwe_data.nwe_wlan_info.nwe_wlans[0].nww_essid, op->essid) == 0) {
+            /* Up to the user now, who gets the whole timeout. */
+            op->need_key = TRUE;
+            op_reset_timeout(op);
+        }
+        break;
+
+    case NWAM_EVENT_TYPE_LINK_STATE:
+        if (event->nwe_data.nwe_link_state.nwe_link_up &&
+          (op = op_lookup(event->nwe_data.nwe_link_state.nwe_name)) != NULL) {
+            op_reached(op, NWAMUI_WIFI_CONNECT_STAGE_LINK_UP);
+        }
+        break;
+
+    case NWAM_EVENT_TYPE_IF_STATE:
+        if (event->nwe_data.nwe_if_state.nwe_addr_valid &&
+          (event->nwe_data.nwe_if_state.nwe_flags & IFF_UP)) {
+            /* The link of a logical interface, e.g. net0:1. */
+            gchar *device = g_strdup(event->nwe_data.nwe_if_state.nwe_name);
+            gchar *colon = strchr(device, ':');
+
+            if (colon != NULL) {
+                *colon = '\0';
+            }
+            if ((op = op_lookup(device)) != NULL) {
+                op_reached(op, NWAMUI_WIFI_CONNECT_STAGE_ADDRESS);
+            }
+            g_free(device);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * nwamui_wifi_connect_set_timeout:
+ * @secs: how long an attempt may take, for the attempts started from now.
+ **/
+extern void
+nwamui_wifi_connect_set_timeout(guint secs)
+{
+    g_return_if_fail(secs > 0);
+
+    timeout_secs = secs;
+}
+
+extern const gchar*
+nwamui_wifi_connect_stage_to_string(nwamui_wifi_connect_stage_t stage)
+{
+    g_return_val_if_fail(stage <= NWAMUI_WIFI_CONNECT_STAGE_LAST, NULL);
+
+    return stage_names[stage];
+}
+
+/**
+ * nwamui_wifi_connect_get_stage_stats:
+ * @stage: a stage, or NWAMUI_WIFI_CONNECT_STAGE_LAST for whole attempts.
+ * @count: (out) times the stage was reached.
+ * @failed: (out) attempts which failed, timed out or were cancelled while
+ * waiting for the stage.
+ * @avg_usec: (out) average latency.
+ * @max_usec: (out) worst latency.
+ **/
+extern void
+nwamui_wifi_connect_get_stage_stats(nwamui_wifi_connect_stage_t stage,
+  guint *count,
+  guint *failed,
+  guint64 *avg_usec,
+  guint64 *max_usec)
+{
+    stage_stats_t  *s;
+
+    g_return_if_fail(stage <= NWAMUI_WIFI_CONNECT_STAGE_LAST);
+
+    s = &stage_stats[stage];
+    if (count) {
+        *count = s->count;
+    }
+    if (failed) {
+        *failed = s->failed + s->timed_out + s->cancelled;
+    }
+    if (avg_usec) {
+        *avg_usec = s->count > 0 ? (guint64)s->total / s->count / 1000 : 0;
+    }
+    if (max_usec) {
+        *max_usec = (guint64)s->max / 1000;
+    }
+}
+
+/**
+ * nwamui_wifi_connect_dump:
+ * @fd: file descriptor to write to.
+ *
+ * Write out the counters and latency histogram of each stage, and the
+ * attempts in flight.
+ **/
+extern void
+nwamui_wifi_connect_dump(gint fd)
+{
+    GString        *out = g_string_new(NULL);
+    GHashTableIter  iter;
+    gpointer        value;
+    guint           stage;
+    guint           i;
+    gsize           off;
+    ssize_t         n;
+
+    g_string_append_printf(out, "--- %s: wireless connect ---\n", g_get_prgname());
+    g_string_append_printf(out, "%-10s %8s %8s %8s %8s %10s %10s\n",
+      "stage", "count", "failed", "timeout", "cancel", "avg ms", "max ms");
+
+    for (stage = 0; stage <= NWAMUI_WIFI_CONNECT_STAGE_LAST; stage++) {
+        stage_stats_t  *s = &stage_stats[stage];
+
+        g_string_append_printf(out, "%-10s %8u %8u %8u %8u %10.1f %10.1f\n",
+          stage_names[stage], s->count, s->failed, s->timed_out, s->cancelled,
+          s->count > 0 ? (gdouble)s->total / s->count / 1000000 : 0.0,
+          (gdouble)s->max / 1000000);
+    }
+
+    for (stage = 0; stage <= NWAMUI_WIFI_CONNECT_STAGE_LAST; stage++) {
+        stage_stats_t  *s = &stage_stats[stage];
+
+        if (s->count == 0) {
+            continue;
+        }
+        g_string_append_printf(out, "%s:", stage_names[stage]);
+        for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            if (s->buckets[i] == 0) {
+                continue;
+            }
+            if (i < HISTOGRAM_BUCKETS - 1) {
+                g_string_append_printf(out, " <%u ms %u,", 1U << i, s->buckets[i]);
+            } else {
+                g_string_append_printf(out, " >=%u ms %u,", 1U << (i - 1), s->buckets[i]);
+            }
+        }
+        /* Drop the last comma. */
+        g_string_truncate(out, out->len - 1);
+        g_string_append_c(out, '\n');
+    }
+
+    if (ops != NULL) {
+        hrtime_t now = gethrtime();
+
+        g_hash_table_iter_init(&iter, ops);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            connect_op_t *op = (connect_op_t *)value;
+
+            g_string_append_printf(out, "in flight: %s on %s, waiting for %s for %llu ms%s\n",
+              op->essid, op->device, stage_names[op->stage],
+              (unsigned long long)(now - op->stage_at) / 1000000,
+              op->need_key ? ", needs a key" : "");
+        }
+    }
+
+    g_string_append(out, "--- end of wireless connect ---\n");
+
+    for (off = 0; off < out->len; ) {
+        n = write(fd, out->str + off, out->len - off);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        off += n;
+    }
+
+    g_string_free(out, TRUE);
+}
+
+/**
+ * nwamui_wifi_connect_shutdown:
+ *
+ * Stop the worker once the calls queued before are made, and forget the
+ * attempts in flight. Called as the daemon goes away.
+ **/
+extern void
+nwamui_wifi_connect_shutdown(void)
+{
+    connect_job_t  *job;
+
+    if (worker != NULL) {
+        job = g_new0(connect_job_t, 1);
+        job->type = JOB_QUIT;
+        g_async_queue_push(job_queue, job);
+        (void) g_thread_join(worker);
+        worker = NULL;
+        g_async_queue_unref(job_queue);
+        job_queue = NULL;
+    }
+
+    /* The results still on idle only free their jobs. */
+    shut_down = TRUE;
+    if (ops != NULL) {
+        g_hash_table_destroy(ops);
+        ops = NULL;
+    }
+}
@@ -0,0 +1,92 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   nwamui_wifi_connect.h
+ *
+ */
+
+#ifndef _NWAMUI_WIFI_CONNECT_H
+#define	_NWAMUI_WIFI_CONNECT_H
+
+#ifndef _libnwamui_H
+#error "Please include libnwamui.h header instead."
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Wireless connection attempts, tracked from the request to an address.
+ *
+ * The libnwam calls, nwam_wlan_select() and nwam_wlan_set_key(), are made
+ * in order on a worker thread. The later stages are reached on the events
+ * handed to nwamui_wifi_connect_handle_event() by the daemon. A link has a
+ * single attempt in flight, a new one for another ESSID cancels it. Once
+ * its select returned, selecting the same ESSID again or setting its key
+ * starts the attempt over, as after WLAN_NEED_KEY. The key stage is only
+ * there when a key is set during the attempt.
+ *
+ * The latency of each stage is kept in a histogram, see
+ * nwamui_wifi_connect_dump(). Everything but the worker runs in the main
+ * loop.
+ */
+
+typedef enum {
+    NWAMUI_WIFI_CONNECT_STAGE_SELECT = 0,
+    NWAMUI_WIFI_CONNECT_STAGE_KEY,
+    NWAMUI_WIFI_CONNECT_STAGE_ASSOCIATE,
+    NWAMUI_WIFI_CONNECT_STAGE_LINK_UP,
+    NWAMUI_WIFI_CONNECT_STAGE_ADDRESS,
+    NWAMUI_WIFI_CONNECT_STAGE_LAST      /* Done, or the whole attempt */
+} nwamui_wifi_connect_stage_t;
+
+extern void         nwamui_wifi_connect_start(const gchar *device,
+                                              const gchar *essid,
+                                              uint32_t secmode,
+                                              gboolean add_to_favourites);
+extern void         nwamui_wifi_connect_store_key(const gchar *device,
+                                                  const gchar *essid,
+                                                  uint32_t secmode,
+                                                  guint keyslot,
+                                                  const gchar *key);
+extern gboolean     nwamui_wifi_connect_cancel(const gchar *device);
+extern nwamui_wifi_connect_stage_t
+                    nwamui_wifi_connect_get_stage(const gchar *device);
+extern void         nwamui_wifi_connect_handle_event(nwam_event_t event);
+extern void         nwamui_wifi_connect_set_timeout(guint secs);
+extern void         nwamui_wifi_connect_shutdown(void);
+
+extern const gchar* nwamui_wifi_connect_stage_to_string(nwamui_wifi_connect_stage_t stage);
+extern void         nwamui_wifi_connect_get_stage_stats(nwamui_wifi_connect_stage_t stage,
+                                                        guint *count,
+                                                        guint *failed,
+                                                        guint64 *avg_usec,
+                                                        guint64 *max_usec);
+extern void         nwamui_wifi_connect_dump(gint fd);
+
+G_END_DECLS
+
+#endif	/* _NWAMUI_WIFI_CONNECT_H */
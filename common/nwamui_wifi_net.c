@@ -551,10 +551,18 @@ nwamui_wifi_net_new(NwamuiNcu *ncu, const gchar *essid)
     return( self );
 }
 
+/*
+ * Only the properties which differ from the scan result are set, so a
+ * network scanned again unchanged notifies nothing and its row isn't
+ * redrawn.
+ */
 extern gboolean
 nwamui_wifi_net_update_from_wlan_t(NwamuiWifiNet* self, nwam_wlan_t *wlan)
 {
+    g_return_val_if_fail(NWAMUI_IS_WIFI_NET(self), FALSE);
+
     if ( wlan != NULL ) {
+        NwamuiWifiNetPrivate           *prv = self->prv;
         const gchar*                    essid = wlan->nww_essid;
         nwamui_wifi_security_t          security;
         GList                          *bssid_list;
@@ -562,6 +570,7 @@ nwamui_wifi_net_update_from_wlan_t(NwamuiWifiNet* self, nwam_wlan_t *wlan)
         nwamui_wifi_signal_strength_t   signal_strength;
         guint                           channel;
         guint                           speed;
+        gboolean                        new_bssid = FALSE;
         
         bssid_list = nwamui_wifi_net_real_get_bssid_list( self );
         if ( wlan->nww_bssid != NULL ) {
@@ -569,6 +578,7 @@ nwamui_wifi_net_update_from_wlan_t(NwamuiWifiNet* self, nwam_wlan_t *wlan)
             GList *match = g_list_find_custom(bssid_list, wlan->nww_bssid, (GCompareFunc)g_strcmp0);
             if ( match == NULL ) {
                 bssid_list = g_list_append(bssid_list, g_strdup(wlan->nww_bssid));
+                new_bssid = TRUE;
             }
         }
         security = nwamui_wifi_net_security_map(wlan->nww_security_mode);
@@ -577,20 +587,36 @@ nwamui_wifi_net_update_from_wlan_t(NwamuiWifiNet* self, nwam_wlan_t *wlan)
         bss_type = nwamui_wifi_net_bss_type_map(wlan->nww_bsstype);
         signal_strength = nwamui_wifi_net_strength_map(wlan->nww_signal_strength);
 
-        if ( self != NULL ) {
-            g_object_set (G_OBJECT (self),
-              "name", essid,
-              "security", security,
-              "bssid_list", bssid_list,
-              "bss_type", bss_type,
-              "channel", channel,
-              "speed", speed,
-              "signal_strength", signal_strength,
-              NULL);
-            
-            /* Not modified by user */
-            self->prv->modified = FALSE;
+        g_object_freeze_notify(G_OBJECT(self));
+        if ( g_strcmp0(prv->essid, essid) != 0 ) {
+            g_object_set(G_OBJECT(self), "name", essid, NULL);
+        }
+        if ( prv->security != security ) {
+            g_object_set(G_OBJECT(self), "security", security, NULL);
+        }
+        if ( new_bssid ) {
+            g_object_set(G_OBJECT(self), "bssid_list", bssid_list, NULL);
         }
+        if ( prv->bss_type != bss_type ) {
+            g_object_set(G_OBJECT(self), "bss_type", bss_type, NULL);
+        }
+        if ( prv->channel != channel ) {
+            g_object_set(G_OBJECT(self), "channel", channel, NULL);
+        }
+        if ( prv->speed != speed ) {
+            g_object_set(G_OBJECT(self), "speed", speed, NULL);
+        }
+        if ( prv->signal_strength != signal_strength ) {
+            g_object_set(G_OBJECT(self), "signal_strength", signal_strength, NULL);
+        }
+        g_object_thaw_notify(G_OBJECT(self));
+
+        g_list_foreach(bssid_list, (GFunc)g_free, NULL);
+        g_list_free(bssid_list);
+            
+        /* Not modified by user */
+        prv->modified = FALSE;
+
         return( TRUE );
     }
 
@@ -715,7 +741,8 @@ nwamui_object_real_get_enabled(NwamuiObject *object)
 }
 
 /**
- * Ask NWAM to store the password information
+ * Ask NWAM to store the password information, the key is set on the
+ * wireless connect worker, see nwamui_wifi_connect_store_key().
  **/
 extern void
 nwamui_wifi_net_store_key(NwamuiWifiNet *self)
@@ -741,25 +768,18 @@ nwamui_wifi_net_store_key(NwamuiWifiNet *self)
     case NWAMUI_WIFI_SEC_WPA_PERSONAL: {
         NwamuiDaemon*  daemon = nwamui_daemon_get_instance();
         gchar         *device = NULL;
-        nwam_error_t   nerr;
 
         if (prv->ncu == NULL) {
             prv->ncu = nwamui_ncp_get_first_wireless_ncu_from_active_ncp(daemon);
         }
         device = nwamui_ncu_get_device_name(prv->ncu);
         /* Make sure we use the correct info of the wifi_net or known_wlan. */
-        nerr = nwam_wlan_set_key(device,
+        nwamui_wifi_connect_store_key(device,
           nwamui_object_get_name(NWAMUI_OBJECT(self)),
-          NULL,
           nwamui_wifi_net_security_map_to_nwam(security),
           nwamui_wifi_net_get_wep_key_index(self),
           prv->wep_password?prv->wep_password:"");
 
-        if (nerr != NWAM_SUCCESS) {
-            g_warning("Error saving network key NWAM : %s", nwam_strerror(nerr));
-            nwamui_object_event(NWAMUI_OBJECT(daemon), NWAMUI_DAEMON_INFO_GENERIC, _("Failed to store network key."));
-        }
-                    
         g_object_unref(daemon);
         g_free(device);
     }
@@ -787,13 +807,12 @@ nwamui_wifi_net_store_key(NwamuiWifiNet *self)
 
 
 /**
- * Ask NWAM to connect to this network.
+ * Ask NWAM to connect to this network, see nwamui_wifi_connect_start().
  **/
 extern void
 nwamui_wifi_net_connect(NwamuiWifiNet *self, gboolean add_to_favourites)
 {
     gchar          *device = nwamui_ncu_get_device_name(self->prv->ncu);
-    nwam_error_t    nerr;
     uint32_t        sec_mode; /* maps to dladm_wlan_secmode_t */
     const gchar*    sec_mode_str;
 
@@ -818,20 +837,9 @@ nwamui_wifi_net_connect(NwamuiWifiNet *self, gboolean add_to_favourites)
       sec_mode_str, sec_mode,
       add_to_favourites?"TRUE":"FALSE");
 
-    nerr = nwam_wlan_select(device, self->prv->essid, NULL, sec_mode, add_to_favourites?B_TRUE:B_FALSE);
-
-    if (nerr != NWAM_SUCCESS) {
-        NwamuiDaemon*   daemon = nwamui_daemon_get_instance();
+    /* Select, then follow the attempt, off the main thread. */
+    nwamui_wifi_connect_start(device, self->prv->essid, sec_mode, add_to_favourites);
 
-        if (nerr == NWAM_ENTITY_INVALID_STATE) {
-            nwamui_object_event(NWAMUI_OBJECT(daemon), NWAMUI_DAEMON_INFO_GENERIC, _("Failed to connect to wireless network, please try it later."));
-        } else {
-            g_warning("Error selecting network with NWAM : %s", nwam_strerror(nerr));
-        }
-
-        g_object_unref(daemon);
-    }
-    
     g_free(device);
 }
 
@@ -39,19 +39,37 @@
 #include "status_icon.h"
 #include "notify.h"
 
-#define DETECT_ICON_EMBEDDING_INTERVAL 2 /* In seconds */
+/* Time budget of each background slice loading the configuration. */
+#define STARTUP_SLICE_MSEC (8)
+
+/* Unique commands, beyond the ones predefined by libunique. */
+enum {
+    NWAM_MANAGER_COMMAND_DUMP_LOG = 1
+};
 
 /* Command-line options */
 static gboolean debug = FALSE;
 static gboolean notify_reuse = FALSE;
 static gboolean notify_create_always = FALSE;
 static gboolean notify_create_nostatus = FALSE;
+static gboolean dump_log = FALSE;
+static gchar   *log_spec = NULL;
+static gchar   *trace_file = NULL;
+static gchar   *track_refs = NULL;
+static gint     instance_log_secs = 0;
+static gchar   *event_source_spec = NULL;
 
 static GOptionEntry option_entries[] = {
     {"debug", 'D', G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE, &debug, N_("Enable debugging messages"), NULL },
     {"notify-reuse", 'a', G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE, &notify_reuse, N_("Always re-use notification message"), NULL },
     {"notify-create-always", 'a', G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE, &notify_create_always, N_("Always create notification message, rather than re-use"), NULL },
     {"notify-create-always-nostatus", 'n', G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE, &notify_create_nostatus, N_("Always create notification message, rather than re-use, and don't link to status icon"), NULL },
+    {"dump-log", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE, &dump_log, N_("Ask the running instance to dump its log buffer to stderr"), NULL },
+    {"log", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_STRING, &log_spec, N_("Set log levels, e.g. all=info,scan=debug"), N_("SPEC") },
+    {"trace", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_FILENAME, &trace_file, N_("Write a Chrome trace of the hot paths to FILE on exit"), N_("FILE") },
+    {"track-refs", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_STRING, &track_refs, N_("Record where instances of these types are referenced, e.g. NwamuiWifiNet,NwamMenuItem"), N_("TYPES") },
+    {"instance-log", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_INT, &instance_log_secs, N_("Log instance high water marks every SECS seconds"), N_("SECS") },
+    {"event-source", 0, G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_STRING, &event_source_spec, N_("Take the nwamd events from SOURCE: libnwam, replay:FILE or rtnetlink"), N_("SOURCE") },
     {NULL}
 };
 
@@ -61,29 +79,46 @@ cleanup_and_exit(int sig, siginfo_t *sip, void *data)
     gtk_main_quit ();
 }
 
-static gboolean
-init_wait_for_embedding_idle(gpointer data)
+static UniqueResponse
+unique_message_handler(UniqueApp *app,
+  gint command,
+  UniqueMessageData *message_data,
+  guint time_,
+  gpointer user_data)
+{
+    switch (command) {
+    case NWAM_MANAGER_COMMAND_DUMP_LOG:
+        nwamui_log_dump(STDERR_FILENO);
+        nwamui_instances_dump(STDERR_FILENO);
+        nwamui_wifi_connect_dump(STDERR_FILENO);
+        return UNIQUE_RESPONSE_OK;
+    default:
+        break;
+    }
+    return UNIQUE_RESPONSE_PASSTHROUGH;
+}
+
+static void
+on_status_icon_embedded(GObject *gobject, GParamSpec *arg1, gpointer data)
 {
-    GtkStatusIcon* status_icon = GTK_STATUS_ICON(data);
+    GtkStatusIcon* status_icon = GTK_STATUS_ICON(gobject);
 
     if (gtk_status_icon_is_embedded(status_icon)) {
+        g_signal_handlers_disconnect_by_func(gobject,
+          (gpointer)on_status_icon_embedded, data);
         nwam_status_icon_run(NWAM_STATUS_ICON(status_icon));
-        return FALSE;
     }
-    return TRUE;
 }
 
 static gboolean
 init_wait_for_embedding(gpointer data)
 {
-    /* Run it first because we may avoid the first interval. */
-    if (init_wait_for_embedding_idle(data)) {
-        g_timeout_add_seconds_full(G_PRIORITY_DEFAULT,
-          DETECT_ICON_EMBEDDING_INTERVAL,
-          init_wait_for_embedding_idle,
-          g_object_ref(data),
-          g_object_unref);
-    }
+    g_signal_connect(data, "notify::embedded",
+      G_CALLBACK(on_status_icon_embedded), NULL);
+
+    /* Run it first because it may be embedded already. */
+    on_status_icon_embedded(G_OBJECT(data), NULL, NULL);
+
     return( TRUE );
 }
 
@@ -120,6 +155,32 @@ main( int argc, char* argv[] )
 
     nwamui_util_set_debug_mode( debug );
 
+    if ( log_spec ) {
+        nwamui_log_parse_spec( log_spec );
+    }
+
+    if ( trace_file ) {
+        nwamui_trace_start( trace_file );
+    }
+
+    if ( track_refs ) {
+        nwamui_instances_set_ref_types( track_refs );
+    }
+
+    if ( instance_log_secs > 0 ) {
+        nwamui_instances_start_log( (guint)instance_log_secs );
+    }
+
+    if ( event_source_spec ) {
+        const nwamui_event_source_t *source;
+        gpointer                     source_data;
+
+        if ( !nwamui_event_source_parse( event_source_spec, &source, &source_data ) ) {
+            exit(1);
+        }
+        nwamui_daemon_set_event_source( source, source_data );
+    }
+
     if ( notify_reuse ) {
         notify_notification_set_notification_style( NOTIFICATION_STYLE_REUSE );
     }
@@ -139,6 +200,8 @@ main( int argc, char* argv[] )
     sigaction (SIGKILL, &act, NULL);
     sigaction (SIGTERM, &act, NULL);
 
+    nwamui_log_install_dump_signal(SIGUSR1);
+
 #if 0
     if (!nwamui_prof_check_ui_auth(nwamui_prof_get_instance_noref(), UI_AUTH_LEAST)) {
         g_warning("User doesn't have the enough authorisations to run nwam-manager.");
@@ -149,16 +212,22 @@ main( int argc, char* argv[] )
     if ( !nwamui_util_is_debug_mode() ) {
         UniqueApp       *app            = NULL;
 
-        app = unique_app_new("com.sun.nwam-manager", NULL);
+        app = unique_app_new_with_commands("com.sun.nwam-manager", NULL,
+          "dump-log", NWAM_MANAGER_COMMAND_DUMP_LOG,
+          NULL);
         if (unique_app_is_running(app)) {
-/*         unique_app_add_command(app, "", 1); */
-/*         unique_app_send_message(app, 1, NULL); */
+            if ( dump_log ) {
+                unique_app_send_message(app, NWAM_MANAGER_COMMAND_DUMP_LOG, NULL);
+                exit(0);
+            }
             nwamui_util_show_message( NULL, GTK_MESSAGE_INFO, _("NWAM Manager"),
                                       _("\nAnother instance is running.\nThis instance will exit now."), TRUE );
             g_debug("Another instance is running, exiting.");
             exit(0);
         }
 
+        g_signal_connect(app, "message-received", G_CALLBACK(unique_message_handler), NULL);
+
         client = gnome_master_client ();
         gnome_client_set_restart_command (client, argc, argv);
         gnome_client_set_restart_style (client, GNOME_RESTART_IMMEDIATELY);
@@ -167,6 +236,11 @@ main( int argc, char* argv[] )
         g_debug("Auto restart and uniqueness disabled while in debug mode.");
     }
 
+    if ( dump_log ) {
+        g_printerr("No running instance of %s to dump the log of.\n", PACKAGE);
+        exit(1);
+    }
+
     gtk_init( &argc, &argv );
 
     /* Initialise Thread Support */
@@ -181,16 +255,32 @@ main( int argc, char* argv[] )
      * this is to avoid confusion when calling gtk_main_iteration to get to
      * the point where the status icon's embedded flag is correctly set
      */
+    /* Only the active NCP and location are loaded before the icon is
+     * shown, the rest while idle.
+     */
+    nwamui_daemon_set_staged_startup(TRUE, STARTUP_SLICE_MSEC);
+
     status_icon = nwam_status_icon_new();
     gtk_init_add(init_wait_for_embedding, (gpointer)status_icon);
     if ( nwamui_util_is_debug_mode() ) {
         g_message("Show status icon initially on debug mode.");
     }
 
+    /* Lets the properties dialog start from what the tray has loaded. */
+    {
+        NwamuiDaemon *daemon = nwamui_daemon_get_instance();
+        nwamui_snapshot_publish(daemon);
+        g_object_unref(daemon);
+    }
+
     gtk_main();
 
     g_debug ("exiting...");
 
+    nwamui_snapshot_unpublish();
+
+    nwamui_trace_stop();
+
     g_object_unref(status_icon);
     g_object_unref (G_OBJECT (program));
     
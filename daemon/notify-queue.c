@@ -0,0 +1,543 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   notify-queue.c
+ *
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "notify-queue.h"
+
+/* A bubble is cut to half of the default timeout if others are waiting. */
+#define TIGHT_TIMEOUT(t)            ((gint)(0.5 * (t)))
+
+/* Token bucket of each key, a burst of up to BUCKET_SIZE messages, then one
+ * per BUCKET_REFILL_MSEC.
+ */
+#define BUCKET_SIZE                 (3)
+#define BUCKET_REFILL_MSEC          (10000)
+#define BUCKET_PRUNE_THRESHOLD      (64)
+
+/* Rate limited messages are summarized this long after the first of them. */
+#define BURST_WINDOW_MSEC           (10000)
+
+/* More pending messages than this are folded into a summary. */
+#define MAX_PENDING                 (3)
+
+/* Lines of a summary bubble. */
+#define SUMMARY_MAX_LINES           (5)
+
+typedef struct {
+    notify_kind_t   kind;
+    GObject        *subject;    /* Only compared, never dereferenced */
+    gdouble         tokens;
+    gint64          last;
+} bucket_t;
+
+struct _notify_queue {
+    const notify_queue_backend_t   *backend;
+    gpointer                        backend_data;
+    gboolean                        visible;
+    gint                            default_timeout;
+
+    notify_msg_t                   *current;
+    gint64                          current_expire; /* Cut short at, if others wait */
+    GQueue                          pending;
+
+    GQueue                          burst;          /* Rate limited, latest per key */
+    guint                           burst_count;
+    gint64                          burst_deadline;
+
+    GHashTable                     *buckets;
+    gint64                          armed;          /* 0 if not armed */
+};
+
+#define SAME_KEY(a, b)  ((a)->kind == (b)->kind && (a)->subject == (b)->subject)
+
+static void     notify_queue_update_timer(notify_queue_t *q, gint64 now);
+
+extern notify_msg_t*
+notify_msg_new(notify_kind_t kind,
+  GObject *subject,
+  const gchar *summary,
+  const gchar *body,
+  const GdkPixbuf *icon,
+  const gchar *action,
+  const gchar *label,
+  NotifyActionCallback callback,
+  gpointer user_data,
+  GFreeFunc free_func,
+  gint timeout)
+{
+    notify_msg_t *m = g_new0(notify_msg_t, 1);
+
+    m->kind = kind;
+    if (subject)
+        m->subject = g_object_ref(subject);
+    m->count = 1;
+    m->summary = g_strdup(summary);
+    m->body = g_strdup(body);
+    if (icon)
+        m->icon = g_object_ref(G_OBJECT(icon));
+    m->action = g_strdup(action);
+    m->label = g_strdup(label);
+    m->cb = callback;
+    m->user_data = user_data;
+    m->free_func = free_func;
+    m->timeout = timeout;
+
+    return m;
+}
+
+static void
+notify_msg_free(notify_msg_t *m)
+{
+    /* Once shown, libnotify owns user_data through the action. */
+    if (m->shown_at == 0 && m->free_func && m->user_data)
+        m->free_func(m->user_data);
+
+    if (m->subject)
+        g_object_unref(m->subject);
+    g_free(m->summary);
+    g_free(m->body);
+    if (m->icon)
+        g_object_unref(m->icon);
+    g_free(m->action);
+    g_free(m->label);
+    g_free(m);
+}
+
+static guint
+bucket_hash(gconstpointer key)
+{
+    const bucket_t *b = key;
+
+    return g_direct_hash(b->subject) ^ (guint)b->kind;
+}
+
+static gboolean
+bucket_equal(gconstpointer a, gconstpointer b)
+{
+    return SAME_KEY((const bucket_t *)a, (const bucket_t *)b);
+}
+
+static void
+bucket_refill(bucket_t *b, gint64 now)
+{
+    b->tokens = MIN((gdouble)BUCKET_SIZE,
+      b->tokens + (gdouble)(now - b->last) / BUCKET_REFILL_MSEC);
+    b->last = now;
+}
+
+static gboolean
+bucket_prune_full(gpointer key, gpointer value, gpointer data)
+{
+    bucket_t *b = value;
+
+    bucket_refill(b, *(gint64 *)data);
+    return b->tokens >= BUCKET_SIZE;
+}
+
+static gboolean
+notify_queue_take_token(notify_queue_t *q, notify_msg_t *m, gint64 now)
+{
+    bucket_t    key = { m->kind, m->subject };
+    bucket_t   *b;
+
+    if (m->kind == NOTIFY_KIND_SUMMARY)
+        return TRUE;
+
+    if ((b = g_hash_table_lookup(q->buckets, &key)) == NULL) {
+        /* Forget the keys which have been quiet for long enough. */
+        if (g_hash_table_size(q->buckets) > BUCKET_PRUNE_THRESHOLD)
+            g_hash_table_foreach_remove(q->buckets, bucket_prune_full, &now);
+
+        b = g_new(bucket_t, 1);
+        *b = key;
+        b->tokens = BUCKET_SIZE;
+        b->last = now;
+        g_hash_table_insert(q->buckets, b, b);
+    }
+
+    bucket_refill(b, now);
+    if (b->tokens < 1.0)
+        return FALSE;
+
+    b->tokens -= 1.0;
+    return TRUE;
+}
+
+/* Whether the rate limited messages include one of the key of m. */
+static gboolean
+notify_queue_in_burst(notify_queue_t *q, notify_msg_t *m)
+{
+    GList *i;
+
+    for (i = q->burst.head; i; i = i->next) {
+        if (SAME_KEY((notify_msg_t *)i->data, m))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static gint
+notify_queue_msg_timeout(notify_queue_t *q, notify_msg_t *m)
+{
+    return m->timeout == NOTIFY_EXPIRES_DEFAULT ? q->default_timeout : m->timeout;
+}
+
+/* Replace the message of the same key in l, or append m to it. Summaries
+ * are never replaced, their lines would be lost.
+ */
+static void
+notify_queue_collapse_into(GQueue *l, notify_msg_t *m)
+{
+    GList *i;
+
+    for (i = l->head; i && m->kind != NOTIFY_KIND_SUMMARY; i = i->next) {
+        notify_msg_t *old = i->data;
+
+        if (SAME_KEY(old, m)) {
+            m->count += old->count;
+            notify_msg_free(old);
+            i->data = m;
+            return;
+        }
+    }
+    g_queue_push_tail(l, m);
+}
+
+/* Build one message out of msgs, representing count events. */
+static notify_msg_t*
+notify_msg_new_summary(GList *msgs, guint count)
+{
+    notify_msg_t   *sum;
+    GString        *body = g_string_new(NULL);
+    GdkPixbuf      *icon = NULL;
+    gchar          *summary;
+    guint           lines = 0;
+    GList          *i;
+
+    for (i = msgs; i; i = i->next) {
+        notify_msg_t   *m = i->data;
+        const gchar    *line = (m->kind == NOTIFY_KIND_SUMMARY) ? m->body : m->summary;
+
+        icon = m->icon;
+        if (line == NULL || *line == '\0' || lines >= SUMMARY_MAX_LINES)
+            continue;
+        g_string_append_printf(body, "%s%s", body->len > 0 ? "\n" : "", line);
+        lines++;
+    }
+
+    summary = g_strdup_printf(ngettext("%u network change", "%u network changes", count), count);
+    sum = notify_msg_new(NOTIFY_KIND_SUMMARY, NULL, summary, body->str, icon,
+      NULL, NULL, NULL, NULL, NULL, NOTIFY_EXPIRES_DEFAULT);
+    sum->count = count;
+
+    g_free(summary);
+    g_string_free(body, TRUE);
+    return sum;
+}
+
+/* Fold the pending messages which have no action into a summary. */
+static void
+notify_queue_fold_pending(notify_queue_t *q)
+{
+    GList  *folded = NULL;
+    guint   count = 0;
+    GList  *i;
+
+    for (i = q->pending.head; i; ) {
+        GList          *next = i->next;
+        notify_msg_t   *m = i->data;
+
+        if (m->cb == NULL) {
+            folded = g_list_append(folded, m);
+            count += m->count;
+            g_queue_delete_link(&q->pending, i);
+        }
+        i = next;
+    }
+
+    if (folded == NULL)
+        return;
+
+    if (folded->next == NULL) {
+        g_queue_push_tail(&q->pending, folded->data);
+    } else {
+        g_queue_push_tail(&q->pending, notify_msg_new_summary(folded, count));
+        g_list_foreach(folded, (GFunc)notify_msg_free, NULL);
+    }
+    g_list_free(folded);
+}
+
+static void
+notify_queue_flush_burst(notify_queue_t *q, gint64 now)
+{
+    notify_msg_t   *m;
+    GList          *i;
+
+    /* The summary is the turn of each key in it. */
+    for (i = q->burst.head; i; i = i->next)
+        (void) notify_queue_take_token(q, i->data, now);
+
+    if (q->burst.length == 1) {
+        m = g_queue_pop_head(&q->burst);
+        m->count = q->burst_count;
+    } else {
+        m = notify_msg_new_summary(q->burst.head, q->burst_count);
+        g_queue_foreach(&q->burst, (GFunc)notify_msg_free, NULL);
+        g_queue_clear(&q->burst);
+    }
+    q->burst_count = 0;
+    q->burst_deadline = 0;
+
+    notify_queue_collapse_into(&q->pending, m);
+}
+
+static void
+notify_queue_retire_current(notify_queue_t *q)
+{
+    notify_msg_t *m = q->current;
+
+    q->current = NULL;
+    q->current_expire = 0;
+    if (m->backend_data)
+        q->backend->hide(m, q->backend_data);
+    notify_msg_free(m);
+}
+
+static void
+notify_queue_show_current(notify_queue_t *q, gint64 now)
+{
+    gint timeout = notify_queue_msg_timeout(q, q->current);
+
+    if (!g_queue_is_empty(&q->pending))
+        timeout = TIGHT_TIMEOUT(timeout);
+
+    q->current->shown_at = now;
+    q->current_expire = now + timeout;
+    q->backend->show(q->current, timeout, q->backend_data);
+}
+
+static void
+notify_queue_show_next(notify_queue_t *q, gint64 now)
+{
+    if (q->current || !q->visible || g_queue_is_empty(&q->pending))
+        return;
+
+    q->current = g_queue_pop_head(&q->pending);
+    notify_queue_show_current(q, now);
+}
+
+static void
+notify_queue_update_timer(notify_queue_t *q, gint64 now)
+{
+    gint64 deadline = 0;
+
+    /* Only cut the showing bubble if someone is waiting, otherwise the
+     * notification server expires it and we get notify_queue_closed().
+     */
+    if (q->current && !g_queue_is_empty(&q->pending))
+        deadline = q->current_expire;
+
+    if (q->burst_deadline > 0 && (deadline == 0 || q->burst_deadline < deadline))
+        deadline = q->burst_deadline;
+
+    if (deadline == q->armed)
+        return;
+
+    q->armed = deadline;
+    q->backend->arm(deadline > 0 ? MAX(deadline - now, 0) : -1, q->backend_data);
+}
+
+extern notify_queue_t*
+notify_queue_new(const notify_queue_backend_t *backend,
+  gpointer backend_data,
+  gint default_timeout)
+{
+    notify_queue_t *q = g_new0(notify_queue_t, 1);
+
+    q->backend = backend;
+    q->backend_data = backend_data;
+    q->default_timeout = default_timeout;
+    q->visible = TRUE;
+    g_queue_init(&q->pending);
+    g_queue_init(&q->burst);
+    q->buckets = g_hash_table_new_full(bucket_hash, bucket_equal, g_free, NULL);
+
+    return q;
+}
+
+extern void
+notify_queue_free(notify_queue_t *q)
+{
+    if (q->armed > 0)
+        q->backend->arm(-1, q->backend_data);
+    if (q->current)
+        notify_queue_retire_current(q);
+    g_queue_foreach(&q->pending, (GFunc)notify_msg_free, NULL);
+    g_queue_clear(&q->pending);
+    g_queue_foreach(&q->burst, (GFunc)notify_msg_free, NULL);
+    g_queue_clear(&q->burst);
+    g_hash_table_destroy(q->buckets);
+    g_free(q);
+}
+
+/**
+ * notify_queue_push:
+ * @q: a #notify_queue_t.
+ * @m: a message, owned by @q from now on.
+ *
+ * Queue up @m, or use it to supersede the pending or showing message of the
+ * same key.
+ **/
+extern void
+notify_queue_push(notify_queue_t *q, notify_msg_t *m)
+{
+    gint64 now = q->backend->now(q->backend_data);
+
+    /* Once rate limited, a key goes on into the summary until it is shown,
+     * otherwise a refilled token would show a state older than the summary.
+     */
+    if ((m->kind != NOTIFY_KIND_SUMMARY && notify_queue_in_burst(q, m)) ||
+      !notify_queue_take_token(q, m, now)) {
+        /* Rate limited, keep only the latest state for the summary. */
+        q->burst_count++;
+        m->count = 0;
+        notify_queue_collapse_into(&q->burst, m);
+        if (q->burst_deadline == 0)
+            q->burst_deadline = now + BURST_WINDOW_MSEC;
+
+    } else if (q->current && m->kind != NOTIFY_KIND_SUMMARY && SAME_KEY(q->current, m)) {
+        /* Superseded while showing, update the bubble in place. */
+        m->backend_data = q->current->backend_data;
+        q->current->backend_data = NULL;
+        notify_msg_free(q->current);
+        q->current = m;
+        notify_queue_show_current(q, now);
+
+    } else {
+        notify_queue_collapse_into(&q->pending, m);
+
+        if (g_queue_get_length(&q->pending) > MAX_PENDING)
+            notify_queue_fold_pending(q);
+
+        /* Make room for the pending ones. */
+        if (q->current) {
+            gint64 tight = q->current->shown_at +
+              TIGHT_TIMEOUT(notify_queue_msg_timeout(q, q->current));
+
+            q->current_expire = MIN(q->current_expire, tight);
+        }
+    }
+
+    notify_queue_show_next(q, now);
+    notify_queue_update_timer(q, now);
+}
+
+/**
+ * notify_queue_closed:
+ * @q: a #notify_queue_t.
+ * @backend_data: the backend_data of the closed bubble.
+ *
+ * Tell @q that a bubble was closed by the user or the notification server.
+ **/
+extern void
+notify_queue_closed(notify_queue_t *q, gpointer backend_data)
+{
+    gint64 now = q->backend->now(q->backend_data);
+
+    /* Late signal of a bubble we have already taken down. */
+    if (q->current == NULL || q->current->backend_data != backend_data)
+        return;
+
+    notify_queue_retire_current(q);
+    notify_queue_show_next(q, now);
+    notify_queue_update_timer(q, now);
+}
+
+/**
+ * notify_queue_timeout:
+ * @q: a #notify_queue_t.
+ *
+ * Called by the backend when the delay given to its arm() has elapsed.
+ **/
+extern void
+notify_queue_timeout(notify_queue_t *q)
+{
+    gint64 now = q->backend->now(q->backend_data);
+
+    q->armed = 0;
+
+    if (q->burst_deadline > 0 && now >= q->burst_deadline)
+        notify_queue_flush_burst(q, now);
+
+    if (q->current && !g_queue_is_empty(&q->pending) && now >= q->current_expire)
+        notify_queue_retire_current(q);
+
+    notify_queue_show_next(q, now);
+    notify_queue_update_timer(q, now);
+}
+
+/**
+ * notify_queue_set_visible:
+ * @q: a #notify_queue_t.
+ * @visible: whether bubbles can be shown, e.g. the status icon is embedded.
+ *
+ * Nothing is shown while invisible, the messages keep collapsing until then.
+ **/
+extern void
+notify_queue_set_visible(notify_queue_t *q, gboolean visible)
+{
+    gint64 now;
+
+    if (q->visible == visible)
+        return;
+
+    q->visible = visible;
+    if (visible) {
+        now = q->backend->now(q->backend_data);
+        notify_queue_show_next(q, now);
+        notify_queue_update_timer(q, now);
+    }
+}
+
+extern void
+notify_queue_set_default_timeout(notify_queue_t *q, gint timeout)
+{
+    q->default_timeout = timeout;
+}
+
+extern guint
+notify_queue_get_length(notify_queue_t *q)
+{
+    return g_queue_get_length(&q->pending) + q->burst.length + (q->current ? 1 : 0);
+}
@@ -0,0 +1,131 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   notify-queue.h
+ *
+ */
+
+#ifndef _notify_queue_H
+#define	_notify_queue_H
+
+#include <glib.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <libnotify/notification.h>
+
+G_BEGIN_DECLS
+
+/*
+ * The queue of notification messages of the status icon.
+ *
+ * Messages are keyed by their kind and subject (an NCU, a WLAN, or NULL for
+ * the daemon wide ones like location and NCP changes). A message supersedes
+ * the pending or showing message of the same key instead of queueing up
+ * behind it. Each key has a token bucket, the messages it rejects are folded
+ * into a single summary bubble at the end of the burst, and so are the
+ * pending messages when too many of them pile up.
+ *
+ * The queue doesn't talk to libnotify or the main loop itself, everything
+ * goes through a notify_queue_backend_t, so it can be driven by a fake
+ * backend with a virtual clock.
+ */
+
+typedef enum {
+    NOTIFY_KIND_NWAM_STATE = 0,
+    NOTIFY_KIND_NCU_STATE,          /* Connected, disconnected */
+    NOTIFY_KIND_NCU_WIFI_FAILED,
+    NOTIFY_KIND_NCU_WIFI_SELECTION,
+    NOTIFY_KIND_WIFI_KEY,
+    NOTIFY_KIND_NO_WIFI,
+    NOTIFY_KIND_NCP_CHANGED,
+    NOTIFY_KIND_LOC_CHANGED,
+    NOTIFY_KIND_SUMMARY
+} notify_kind_t;
+
+typedef struct _notify_msg
+{
+    notify_kind_t           kind;
+    GObject                *subject;
+    guint                   count;          /* Events represented */
+    gchar                  *summary;
+    gchar                  *body;
+    GdkPixbuf              *icon;
+    gchar                  *action;
+    gchar                  *label;
+    NotifyActionCallback    cb;
+    gpointer                user_data;
+    GFreeFunc               free_func;
+    gint                    timeout;        /* msec or NOTIFY_EXPIRES_DEFAULT */
+    gint64                  shown_at;       /* msec, 0 if never shown */
+    gpointer                backend_data;
+} notify_msg_t;
+
+typedef struct _notify_queue notify_queue_t;
+
+typedef struct {
+    /* Monotonic time in msec. */
+    gint64  (*now)(gpointer data);
+    /* Show or update in place (backend_data already set) the bubble. */
+    void    (*show)(notify_msg_t *m, gint timeout, gpointer data);
+    /* Take down the bubble of a message, called once for each shown one. */
+    void    (*hide)(notify_msg_t *m, gpointer data);
+    /* Call notify_queue_timeout() in delay msec, or cancel if delay < 0. */
+    void    (*arm)(gint64 delay, gpointer data);
+} notify_queue_backend_t;
+
+extern notify_msg_t*    notify_msg_new(notify_kind_t kind,
+                                       GObject *subject,
+                                       const gchar *summary,
+                                       const gchar *body,
+                                       const GdkPixbuf *icon,
+                                       const gchar *action,
+                                       const gchar *label,
+                                       NotifyActionCallback callback,
+                                       gpointer user_data,
+                                       GFreeFunc free_func,
+                                       gint timeout);
+
+extern notify_queue_t*  notify_queue_new(const notify_queue_backend_t *backend,
+                                         gpointer backend_data,
+                                         gint default_timeout);
+
+extern void             notify_queue_free(notify_queue_t *q);
+
+extern void             notify_queue_push(notify_queue_t *q, notify_msg_t *m);
+
+extern void             notify_queue_closed(notify_queue_t *q, gpointer backend_data);
+
+extern void             notify_queue_timeout(notify_queue_t *q);
+
+extern void             notify_queue_set_visible(notify_queue_t *q, gboolean visible);
+
+extern void             notify_queue_set_default_timeout(notify_queue_t *q, gint timeout);
+
+extern guint            notify_queue_get_length(notify_queue_t *q);
+
+G_END_DECLS
+
+#endif	/* _notify_queue_H */
@@ -26,7 +26,9 @@
  */
 #include <gtk/gtk.h>
 #include <glib/gi18n.h>
+#include <sys/time.h>
 #include "notify.h"
+#include "notify-queue.h"
 
 #define     TEST_PROF_SET_OR_RETURN(pref) \
     { \
@@ -39,59 +41,18 @@
 static NotifyNotification*   notification           = NULL;
 static GtkStatusIcon*        parent_status_icon     = NULL;
 static GdkPixbuf            *default_icon           = NULL;
-static GQueue                msg_q                  = G_QUEUE_INIT;
+static notify_queue_t       *msg_q                  = NULL;
 
 static guint adjust_source_id = 0;
 static gint gconf_exp_time;
 #define DEFAULT_EXP_TIME	gconf_exp_time
-#define TIGHT_EXP_TIME	((gint) (0.5 * DEFAULT_EXP_TIME))
-
-#define NOTIFY_EXP_DEFAULT_FLAG	(NOTIFY_EXPIRES_DEFAULT)
-#define NOTIFY_EXP_ADJUSTED_FLAG	(NOTIFY_EXP_DEFAULT_FLAG - 1)
-#define NOTIFY_POLL_STATUS_ICON_INVISIBLE	(1000)
+/* Used while the preference is unset or invalid. */
+#define FALLBACK_EXP_TIME	(3000)
 
 #define NOTIFY_ICON_SIZE    (32)
 
 #define NOTIFY_DELAY_SECONDS_FOR_NCU_CONNECTION	(5)
 
-typedef struct _msg
-{
-    NotifyNotification *n;
-    gchar *summary;
-    gchar *body;
-    GdkPixbuf* icon;
-    gchar *action;
-    gchar *label;
-    NotifyActionCallback cb;
-    gpointer user_data;
-    GFreeFunc free_func;
-    gint timeout;
-    GTimeVal t;
-} msg;
-
-static msg *nwam_notification_msg_new(NotifyNotification *n,
-  const gchar *summary,
-  const gchar *body,
-  const GdkPixbuf* icon,
-  const gchar *action,
-  const gchar *label,
-  NotifyActionCallback callback,
-  gpointer user_data,
-  GFreeFunc free_func,
-  gint timeout);
-
-static void nwam_notification_msg_free(msg *m);
-
-static gboolean nwam_notification_show_message_cb(GQueue *q);
-
-static void nwam_notification_show_nth_message(GQueue *q, guint nth);
-
-static gboolean nwam_notification_hide_cb(NotifyNotification *n);
-
-static gboolean notify_notification_adjust_first(GQueue *q);
-
-static void notify_notification_adjust_nth(GQueue *q, guint nth, gint new_timeout);
-
 static void on_prof_notification_default_timeout(GObject *gobject, GParamSpec *arg1, gpointer data);
 
 static notification_style_t     notification_style = NOTIFICATION_STYLE_CREATE_ALWAYS;
@@ -102,105 +63,26 @@ notify_notification_set_notification_style( notification_style_t style )
     notification_style = style;
 }
 
-static msg *
-nwam_notification_msg_new(NotifyNotification *n,
-  const gchar *summary,
-  const gchar *body,
-  const GdkPixbuf* icon,
-  const gchar *action,
-  const gchar *label,
-  NotifyActionCallback callback,
-  gpointer user_data,
-  GFreeFunc free_func,
-  gint timeout)
-{
-    msg *m = g_new0(msg, 1);
-
-    m->n = n;
-    m->summary = g_strdup(summary);
-    m->body = g_strdup(body);
-    if (icon)
-        m->icon = g_object_ref(G_OBJECT(icon));
-    m->action = g_strdup(action);
-    m->label = g_strdup(label);
-    m->cb = callback;
-    m->user_data = user_data;
-    m->free_func = free_func;
-    m->timeout = (timeout == NOTIFY_EXPIRES_DEFAULT) ? NOTIFY_EXP_DEFAULT_FLAG : timeout;
-
-    nwamui_debug("NOTIFICATION_MESSAGE:\nSummary = '%s' ; Body = '%s' ; Action = '%s' ; Label = '%s'", 
-                 summary?summary:"NULL",
-                 body?body:"NULL",
-                 action?action:"NULL",
-                 label?label:"NULL");
-    return m;
-}
-
-static void
-nwam_notification_msg_free(msg *m)
-{
-    if ( notification_style != NOTIFICATION_STYLE_REUSE ) {
-        notify_notification_close(m->n, NULL); /* Close notification now! */
-        g_object_unref(m->n);
-        m->n = NULL;
-    }
-
-    g_free(m->summary);
-    g_free(m->body);
-    if (m->icon)
-        g_object_unref(m->icon);
-    g_free(m->action);
-    g_free(m->label);
-    g_free(m);
-}
-
 static void
 on_prof_notification_default_timeout(GObject *gobject, GParamSpec *arg1, gpointer data)
 {
-    NwamuiProf* prof = NWAMUI_PROF(gobject);
-    msg *m;
-    gint timeout;
-
     g_object_get(gobject, "notification_default_timeout", &gconf_exp_time, NULL);
-
-    timeout = g_queue_get_length(&msg_q) == 1 ?
-      DEFAULT_EXP_TIME : TIGHT_EXP_TIME;
+    if (gconf_exp_time <= 0) {
+        gconf_exp_time = FALLBACK_EXP_TIME;
+    }
 
     g_debug("#### Notification default timeout %d ####", DEFAULT_EXP_TIME);
 
-    /* restart the timer */
-    if (adjust_source_id > 0) {
-        g_source_remove(adjust_source_id);
-        adjust_source_id = 0;
+    if (msg_q != NULL) {
+        notify_queue_set_default_timeout(msg_q, DEFAULT_EXP_TIME);
     }
-    /* modify the first show */
-    notify_notification_adjust_nth(&msg_q, 0, timeout);
 }
 
 static void
 on_notification_closed(NotifyNotification *n,
   gpointer user_data)
 {
-    GQueue *q = (GQueue *)user_data;
-    msg *m = NULL;
-
-    /* Pop up the msg triggered this signal. */
-    if ((m = g_queue_pop_head(q)) != NULL) {
-        if (m->cb) {
-            notify_notification_clear_actions(m->n);
-        }
-
-        nwam_notification_msg_free(m);
-    }
-
-    /* Prepare the next show */
-    if ((m = g_queue_peek_head(q)) != NULL) {
-        g_timeout_add_full(G_PRIORITY_DEFAULT,
-          0,
-          (GSourceFunc)nwam_notification_show_message_cb,
-          (gpointer) q,
-          NULL);
-    }
+    notify_queue_closed(msg_q, n);
 }
 
 static NotifyNotification *
@@ -235,256 +117,145 @@ get_notification( void )
 
         g_signal_connect(notification, "closed",
           G_CALLBACK(on_notification_closed),
-          (gpointer) &msg_q);
-
-        /* nwamui preference signals */
-        {
-            NwamuiProf *prof = nwamui_prof_get_instance ();
-
-            g_object_get (prof,
-              "notification_default_timeout", &gconf_exp_time,
-              NULL);
-            
-            /* TODO remove it after gconf value is enabled */
-            if (gconf_exp_time <= 0) {
-                gconf_exp_time = 3000;
-            }
-
-/*             g_debug("#### Notification default timeout %d ####", DEFAULT_EXP_TIME); */
-
-            g_signal_connect(prof, "notify::notification-default-timeout",
-              G_CALLBACK(on_prof_notification_default_timeout), NULL);
-
-/*             nwamui_prof_notify_begin (prof); */
-
-            g_object_unref (prof);
-        }
-
-
+          NULL);
     }
     return notification;
 }
 
-/* We use NOTIFY_EXPIRES_DEFAULT as a flag which means to use gconf
- * timeout
+/*
+ * Backend of the message queue, on top of libnotify and the scheduler.
  */
-static void
-notify_notification_adjust_nth(GQueue *q, guint nth, gint new_timeout)
+static gint64
+notify_backend_now(gpointer data)
 {
-    msg *m;
-
-    if ((m = g_queue_peek_nth(q, nth)) != NULL) {
-        if (m->timeout == NOTIFY_EXP_DEFAULT_FLAG) {
-            m->timeout = NOTIFY_EXP_ADJUSTED_FLAG;
-        }
-    }
-
-    if (adjust_source_id == 0) {
-        adjust_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT,
-          0,
-          (GSourceFunc)notify_notification_adjust_first,
-          (gpointer) q,
-          NULL);
-    }
+    return gethrtime() / (NANOSEC / MILLISEC);
 }
 
-static gboolean
-notify_notification_adjust_first(GQueue *q)
+static void
+notify_backend_show(notify_msg_t *m, gint timeout, gpointer data)
 {
-    msg *m;
+    GError      *err = NULL;
+    const gchar *real_action = m->action;
+    const gchar *real_label = m->label;
 
-    g_assert(adjust_source_id > 0);
-
-    /* Do not show notifications if status icon is invisible. */
-    if (!gtk_status_icon_is_embedded(parent_status_icon) ||
-      !gtk_status_icon_get_visible(parent_status_icon)) {
-        adjust_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT,
-          NOTIFY_POLL_STATUS_ICON_INVISIBLE,
-          (GSourceFunc)notify_notification_adjust_first,
-          (gpointer) q,
-          NULL);
-
-        return FALSE;
+    if (m->backend_data == NULL) {
+        m->backend_data = get_notification();
     }
 
-    /* reset source id since the timer should always be deleted/updated */
-    adjust_source_id = 0;
-
-    if ((m = g_queue_peek_head(q)) == NULL) {
-        return FALSE;
-    }
-
-    if (m->t.tv_sec == 0 && m->t.tv_usec == 0) {
-        nwam_notification_show_nth_message(q, 0);
-        return FALSE;
-    }
+    notify_notification_update(m->backend_data, m->summary, m->body, NULL);
+    if (m->icon || default_icon)
+        notify_notification_set_icon_from_pixbuf(m->backend_data,
+          ((m->icon!=NULL) ? (m->icon) : (default_icon)));
 
-    /* It's showing */
-    if (m->t.tv_sec > 0) {
-        GTimeVal ct;
-        gint timeout = 0;
-
-        /* If adjustable */
-        switch (m->timeout) {
-        case NOTIFY_EXP_DEFAULT_FLAG:
-            timeout = DEFAULT_EXP_TIME;
-            break;
-        case NOTIFY_EXP_ADJUSTED_FLAG:
-            timeout = TIGHT_EXP_TIME;
-            break;
-        default:
-            timeout = m->timeout;
-            break;
+    notify_notification_clear_actions(m->backend_data);
+    if (m->cb) {
+        if (m->action == NULL || *(m->action) == '\0') {
+            real_action = "default";
         }
+        if (m->label == NULL || *(m->label) == '\0') {
+            real_label = "default";
+        }
+    
+        notify_notification_add_action(m->backend_data, real_action, real_label,
+          m->cb, m->user_data, m->free_func);
+    }
 
-        g_get_current_time(&ct);
-
-        timeout -= (gint) ((ct.tv_sec - m->t.tv_sec) * 1000 +
-          (ct.tv_usec - m->t.tv_usec) / 1000);
-
-/*         g_debug("#### %s adjust %d ####", __func__, timeout > 0 ? timeout : 0); */
+    notify_notification_set_timeout(m->backend_data, timeout);
 
-        if (timeout > 0) {
-            adjust_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT,
-              timeout,
-              (GSourceFunc)notify_notification_adjust_first,
-              (gpointer) q,
-              NULL);
-        } else {
-            /* terminate the current show if there are pending msgs */
-            if (g_queue_get_length(q) > 1) {
-/*                 notify_notification_close(m->n, NULL); */
-                nwam_notification_show_nth_message(q, 1);
-            }
-        }
+    if (!notify_notification_show(m->backend_data, &err)) {
+        g_warning(err->message);
+        g_error_free( err );
     }
-    return FALSE;
 }
 
 static void
-notification_cleanup( void )
+notify_backend_hide(notify_msg_t *m, gpointer data)
 {
-    if ( notification != NULL ) {
-        g_object_unref( parent_status_icon );
-        notify_notification_close(notification, NULL); /* Close notification now! */
-        notify_uninit();
+    /* A reused bubble is simply updated by the next message. */
+    if ( notification_style != NOTIFICATION_STYLE_REUSE ) {
+        notify_notification_close(m->backend_data, NULL); /* Close notification now! */
+        if (m->backend_data == notification) {
+            notification = NULL;
+        }
+        g_object_unref(m->backend_data);
     }
+    m->backend_data = NULL;
 }
 
 static gboolean
-nwam_notification_hide_cb(NotifyNotification *n)
+notify_backend_timeout_cb(gpointer data)
 {
-    GError              *err = NULL;
-    if (!notify_notification_close(n, &err)) {
-        g_warning(err->message);
-        g_error_free( err );
-    }
+    adjust_source_id = 0;
+    notify_queue_timeout(msg_q);
     return FALSE;
 }
 
 static void
-nwam_notification_show_nth_message(GQueue *q, guint nth)
+notify_backend_arm(gint64 delay, gpointer data)
 {
-    msg *m;
-
-    /* pop up 0 ~ nth - 1 msgs */
-    for (; nth > 0; nth--) {
-        m = g_queue_pop_head(q);
-        nwam_notification_msg_free(m);
+    if (adjust_source_id > 0) {
+        nwamui_scheduler_remove(adjust_source_id);
+        adjust_source_id = 0;
     }
-
-    if ((m = g_queue_peek_nth(q, nth)) != NULL) {
-        GError              *err = NULL;
-        const gchar* real_action = m->action;
-        const gchar* real_label = m->label;
-        gint timeout = 0;
-
-        notify_notification_update(m->n, m->summary, m->body, NULL);
-/*           ((m->icon!=NULL) ? (m->icon) : (default_icon))); */
-        if (m->icon || default_icon)
-            notify_notification_set_icon_from_pixbuf(m->n,
-              ((m->icon!=NULL) ? (m->icon) : (default_icon)));
-
-        if (m->cb) {
-            if (m->action == NULL || *(m->action) == '\0') {
-                real_action = "default";
-            }
-            if (m->label == NULL || *(m->label) == '\0') {
-                real_label = "default";
-            }
-    
-            notify_notification_add_action(m->n, real_action, real_label,
-              m->cb, m->user_data, m->free_func);
-        } else {
-            notify_notification_clear_actions(m->n);
-        }
-
-        /* Set the timeout */
-        switch (m->timeout) {
-        case NOTIFY_EXP_DEFAULT_FLAG:
-            timeout = DEFAULT_EXP_TIME;
-            break;
-        case NOTIFY_EXP_ADJUSTED_FLAG:
-            timeout = TIGHT_EXP_TIME;
-            break;
-        default:
-            timeout = m->timeout;
-            break;
-        }
-
-        notify_notification_set_timeout(m->n, timeout);
-
-        if (!notify_notification_show(m->n, &err)) {
-            g_warning(err->message);
-            g_error_free( err );
-        }
-
-        /* show time */
-        g_get_current_time(&m->t);
-
-        if (adjust_source_id == 0) {
-            adjust_source_id = g_timeout_add_full(G_PRIORITY_DEFAULT,
-              timeout,
-              (GSourceFunc)notify_notification_adjust_first,
-              (gpointer) q,
-              NULL);
-        }
+    if (delay >= 0) {
+        adjust_source_id = nwamui_scheduler_add((guint)delay,
+          FALSE,
+          notify_backend_timeout_cb,
+          NULL,
+          NULL);
     }
 }
 
-static gboolean
-nwam_notification_show_message_cb(GQueue *q)
-{
-    msg *m;
+static const notify_queue_backend_t notify_backend = {
+    notify_backend_now,
+    notify_backend_show,
+    notify_backend_hide,
+    notify_backend_arm
+};
 
-    nwam_notification_show_nth_message(q, 0);
+/* Do not show notifications if status icon is invisible, the messages wait
+ * in the queue without any timer until it is embedded and shown again.
+ */
+static void
+on_status_icon_visibility_changed(GObject *gobject, GParamSpec *arg1, gpointer data)
+{
+    GtkStatusIcon *status_icon = GTK_STATUS_ICON(gobject);
 
-    return FALSE;
+    notify_queue_set_visible(msg_q,
+      gtk_status_icon_is_embedded(status_icon) &&
+      gtk_status_icon_get_visible(status_icon));
 }
 
 static void
-nwam_notification_show_message(const gchar* summary,
-  const gchar* body,
-  const GdkPixbuf* icon,
-  gint timeout)
+notification_cleanup( void )
 {
-    NotifyNotification  *n = get_notification();
-    msg                 *m;
-    
-    g_assert (summary != NULL && *summary != '\0'); /* Must have a value! */
-    
-    m = nwam_notification_msg_new(n, summary, body, icon, NULL, NULL, NULL, NULL, NULL, timeout);
-
-    g_queue_push_tail(&msg_q, m);
+    g_signal_handlers_disconnect_by_func(nwamui_prof_get_instance_noref(),
+      (gpointer)on_prof_notification_default_timeout, NULL);
 
-    /* adjust the original last show */
-    notify_notification_adjust_nth(&msg_q,
-      g_queue_get_length(&msg_q) - 2,
-      TIGHT_EXP_TIME);
+    if (adjust_source_id > 0) {
+        nwamui_scheduler_remove(adjust_source_id);
+        adjust_source_id = 0;
+    }
+    if (msg_q != NULL) {
+        notify_queue_free(msg_q);
+        msg_q = NULL;
+    }
+    if ( notification != NULL ) {
+        notify_notification_close(notification, NULL); /* Close notification now! */
+    }
+    if ( parent_status_icon != NULL ) {
+        g_signal_handlers_disconnect_by_func(parent_status_icon,
+          (gpointer)on_status_icon_visibility_changed, NULL);
+        g_object_unref( parent_status_icon );
+        parent_status_icon = NULL;
+        notify_uninit();
+    }
 }
 
 static void
-nwam_notification_show_message_with_action (const gchar* summary,
+nwam_notification_show_message_with_action (notify_kind_t kind,
+  GObject *subject,
+  const gchar* summary,
   const gchar* body,
   const GdkPixbuf* icon,
   const gchar* action,
@@ -494,19 +265,31 @@ nwam_notification_show_message_with_action (const gchar* summary,
   GFreeFunc free_func,
   gint timeout)
 {
-    NotifyNotification  *n = get_notification();
-    msg                 *m;
+    notify_msg_t        *m;
 
     g_assert (summary != NULL && *summary != '\0'); /* Must have a value! */
     
-    m = nwam_notification_msg_new(n, summary, body, icon, action, label, callback, user_data, free_func, timeout);
+    nwamui_log_info(NWAMUI_LOG_CAT_NOTIFY, "Summary = '%s' ; Body = '%s' ; Action = '%s' ; Label = '%s'",
+                 summary?summary:"NULL",
+                 body?body:"NULL",
+                 action?action:"NULL",
+                 label?label:"NULL");
+
+    m = notify_msg_new(kind, subject, summary, body, icon, action, label, callback, user_data, free_func, timeout);
 
-    g_queue_push_tail(&msg_q, m);
+    notify_queue_push(msg_q, m);
+}
 
-    /* adjust the original last show */
-    notify_notification_adjust_nth(&msg_q,
-      g_queue_get_length(&msg_q) - 2,
-      TIGHT_EXP_TIME);
+static void
+nwam_notification_show_message(notify_kind_t kind,
+  GObject *subject,
+  const gchar* summary,
+  const gchar* body,
+  const GdkPixbuf* icon,
+  gint timeout)
+{
+    nwam_notification_show_message_with_action(kind, subject, summary, body, icon,
+      NULL, NULL, NULL, NULL, NULL, timeout);
 }
 
 /* 
@@ -528,7 +311,8 @@ nwam_notification_show_nwam_unavailable( void )
     if ( daemon ) {
         icon = nwamui_util_get_env_status_icon( NULL, nwamui_daemon_get_status_icon_type(daemon), NOTIFY_ICON_SIZE );
     }
-    nwam_notification_show_message(_("Automatic network configuration daemon is unavailable."),
+    nwam_notification_show_message(NOTIFY_KIND_NWAM_STATE, NULL,
+            _("Automatic network configuration daemon is unavailable."),
             _("For further information please refer to netadm(1) manual."),
             icon,
             NOTIFY_EXPIRES_DEFAULT);
@@ -626,7 +410,8 @@ nwam_notification_show_ncu_connected( NwamuiNcu* ncu )
             break;
     }
 
-    nwam_notification_show_message( summary_str, body_str,
+    nwam_notification_show_message(NOTIFY_KIND_NCU_STATE, G_OBJECT(ncu),
+                                    summary_str, body_str,
                                     icon, NOTIFY_EXPIRES_DEFAULT);
 
     g_free(display_name);
@@ -704,7 +489,8 @@ nwam_notification_show_ncu_disconnected( NwamuiNcu*           ncu,
     }
 
     if ( callback != NULL ) {
-        nwam_notification_show_message_with_action(summary_str, body_str,
+        nwam_notification_show_message_with_action(NOTIFY_KIND_NCU_STATE, G_OBJECT(ncu),
+          summary_str, body_str,
           NULL,
           NULL,	/* action */
           NULL,	/* label */
@@ -714,7 +500,8 @@ nwam_notification_show_ncu_disconnected( NwamuiNcu*           ncu,
           NOTIFY_EXPIRES_DEFAULT);
     }
     else {
-        nwam_notification_show_message( summary_str, body_str,
+        nwam_notification_show_message(NOTIFY_KIND_NCU_STATE, G_OBJECT(ncu),
+                                        summary_str, body_str,
                                         icon, NOTIFY_EXPIRES_DEFAULT);
     }
 
@@ -782,7 +569,8 @@ nwam_notification_show_ncu_wifi_connect_failed( NwamuiNcu* ncu )
     }
 
     if ( summary_str != NULL ) {
-        nwam_notification_show_message( summary_str, body_str,
+        nwam_notification_show_message(NOTIFY_KIND_NCU_WIFI_FAILED, G_OBJECT(ncu),
+                                        summary_str, body_str,
                                         icon, NOTIFY_EXPIRES_DEFAULT);
     }
 
@@ -811,7 +599,8 @@ nwam_notification_show_ncu_dup_address(NwamuiNcu* ncu)
     summary_str = g_strdup_printf(_("%s disconnected"), display_name );
     body_str = nwamui_ncu_get_connection_state_string(ncu);
 
-    nwam_notification_show_message(summary_str, body_str,
+    nwam_notification_show_message(NOTIFY_KIND_NCU_STATE, G_OBJECT(ncu),
+      summary_str, body_str,
       icon, NOTIFY_EXPIRES_DEFAULT);
 
     g_free(display_name);
@@ -849,7 +638,8 @@ nwam_notification_show_ncu_wifi_selection_needed(   NwamuiNcu           *ncu,
 
 
     /* XXXX - Need to also use dialog? */
-    nwam_notification_show_message_with_action(
+    nwam_notification_show_message_with_action(NOTIFY_KIND_NCU_WIFI_SELECTION,
+                G_OBJECT(ncu),
                 summary, 
                 body,
                 icon,
@@ -899,7 +689,8 @@ nwam_notification_show_ncu_wifi_key_needed( NwamuiWifiNet       *wifi_net,
 
     /* XXXX - Need to also use dialog? */
 
-    nwam_notification_show_message_with_action(
+    nwam_notification_show_message_with_action(NOTIFY_KIND_WIFI_KEY,
+                G_OBJECT(wifi_net),
                 summary, 
                 body,
                 icon,
@@ -936,7 +727,8 @@ nwam_notification_show_no_wifi_networks( NotifyActionCallback callback, GObject
     if ( daemon ) {
         icon = nwamui_util_get_env_status_icon( NULL, nwamui_daemon_get_status_icon_type(daemon), NOTIFY_ICON_SIZE );
     }
-    nwam_notification_show_message_with_action(_("No wireless networks found"),
+    nwam_notification_show_message_with_action(NOTIFY_KIND_NO_WIFI, NULL,
+      _("No wireless networks found"),
       _("Click this message to join an unlisted network"),
       icon,
       NULL,	/* action */
@@ -986,7 +778,8 @@ nwam_notification_show_ncp_changed( NwamuiNcp* ncp )
     summary_str = g_strdup_printf(_("Switched to network profile '%s'"),
       nwamui_object_get_name(NWAMUI_OBJECT(ncp)));
 
-    nwam_notification_show_message(summary_str,
+    nwam_notification_show_message(NOTIFY_KIND_NCP_CHANGED, NULL,
+            summary_str,
             "",
             icon,
             NOTIFY_EXPIRES_DEFAULT);
@@ -1030,7 +823,8 @@ nwam_notification_show_location_changed( NwamuiEnv* env )
      
     summary_str = g_strdup_printf(_("Switched to location '%s'"), nwamui_object_get_name(NWAMUI_OBJECT(env)));
 
-    nwam_notification_show_message(summary_str,
+    nwam_notification_show_message(NOTIFY_KIND_LOC_CHANGED, NULL,
+            summary_str,
             "",
             icon,
             NOTIFY_EXPIRES_DEFAULT);
@@ -1057,6 +851,33 @@ nwam_notification_init( GtkStatusIcon* status_icon )
 
     g_object_ref( status_icon );
     parent_status_icon = status_icon;
+
+    /* nwamui preference signals */
+    {
+        NwamuiProf *prof = nwamui_prof_get_instance ();
+
+        g_object_get (prof,
+          "notification_default_timeout", &gconf_exp_time,
+          NULL);
+            
+        /* TODO remove it after gconf value is enabled */
+        if (gconf_exp_time <= 0) {
+            gconf_exp_time = FALLBACK_EXP_TIME;
+        }
+
+        g_signal_connect(prof, "notify::notification-default-timeout",
+          G_CALLBACK(on_prof_notification_default_timeout), NULL);
+
+        g_object_unref (prof);
+    }
+
+    msg_q = notify_queue_new(&notify_backend, NULL, DEFAULT_EXP_TIME);
+
+    g_signal_connect(status_icon, "notify::embedded",
+      G_CALLBACK(on_status_icon_visibility_changed), NULL);
+    g_signal_connect(status_icon, "notify::visible",
+      G_CALLBACK(on_status_icon_visibility_changed), NULL);
+    on_status_icon_visibility_changed(G_OBJECT(status_icon), NULL, NULL);
 }
 
 void
@@ -60,6 +60,9 @@ static void nwam_menu_item_forall (GtkContainer   *container,
   gpointer        callback_data);
 static void nwam_menu_item_draw_indicator(GtkCheckMenuItem *check_menu_item,
   GdkRectangle *area);
+static GObject* nwam_menu_item_constructor(GType type,
+  guint n_construct_properties,
+  GObjectConstructParam *construct_properties);
 static void nwam_menu_item_finalize (NwamMenuItem *self);
 
 static void nwam_menu_item_parent_set(GtkWidget *widget,
@@ -128,6 +131,7 @@ nwam_menu_item_class_init (NwamMenuItemClass *klass)
 
 	gobject_class->set_property = nwam_menu_item_set_property;
 	gobject_class->get_property = nwam_menu_item_get_property;
+	gobject_class->constructor = nwam_menu_item_constructor;
 	gobject_class->finalize = (void (*)(GObject*)) nwam_menu_item_finalize;
 
 	container_class->forall = nwam_menu_item_forall;
@@ -493,6 +497,23 @@ nwam_menu_item_get_widget (NwamMenuItem *self,
     return prv->w[pos];
 }
 
+static GObject*
+nwam_menu_item_constructor(GType type,
+  guint n_construct_properties,
+  GObjectConstructParam *construct_properties)
+{
+	GObject *object;
+
+	object = G_OBJECT_CLASS(nwam_menu_item_parent_class)->constructor(type,
+	    n_construct_properties,
+	    construct_properties);
+
+	/* Counted here rather than in _init, where the subclass is not set yet. */
+	nwamui_instances_track(object);
+
+	return object;
+}
+
 static void
 nwam_menu_item_finalize (NwamMenuItem *self)
 {
@@ -1047,7 +1047,7 @@ join_wireless(NwamStatusIcon* self, NwamuiWifiNet *wifi, gboolean do_connect )
 
     /* wifi may be NULL -- join a wireless */
     if (wifi) {
-        g_debug("%s ## wifi 0x%p %s", __func__, wifi, nwamui_object_get_name(NWAMUI_OBJECT(wifi)));
+        nwamui_log_debug(NWAMUI_LOG_CAT_MENU, "## wifi 0x%p %s", wifi, nwamui_object_get_name(NWAMUI_OBJECT(wifi)));
     }
 
     nwam_pref_set_purpose(NWAM_PREF_IFACE(wifi_dialog), NWAMUI_DIALOG_PURPOSE_JOIN );
@@ -1126,11 +1126,11 @@ trigger_animation_panel_icon (GConfClient *client,
 	if (gconf_value_get_bool (value)) {
 		g_assert (prv->animation_icon_update_timeout_id == 0);
 		prv->animation_icon_update_timeout_id = 
-          g_timeout_add (333, animation_panel_icon_timeout, (gpointer)self);
+          nwamui_scheduler_add(333, FALSE, animation_panel_icon_timeout, (gpointer)self, NULL);
 		g_assert (prv->animation_icon_update_timeout_id > 0);
 	} else {
 		g_assert (prv->animation_icon_update_timeout_id > 0);
-		g_source_remove (prv->animation_icon_update_timeout_id);
+		nwamui_scheduler_remove (prv->animation_icon_update_timeout_id);
 		prv->animation_icon_update_timeout_id = 0;
 		/* reset everything of animation_panel_icon here */
 		gtk_status_icon_set_from_pixbuf(GTK_STATUS_ICON(self), 
@@ -1147,6 +1147,28 @@ nwam_status_icon_new( void )
     return self;
 }
 
+static gboolean
+status_icon_build_menus(gpointer data)
+{
+    NwamStatusIcon        *self = NWAM_STATUS_ICON(data);
+    NwamStatusIconPrivate *prv  = NWAM_STATUS_ICON_GET_PRIVATE(self);
+
+    nwamui_trace_begin("status_icon_build_menus");
+
+    nwam_menu_recreate_enm_menuitems(self);
+    daemon_online_enm_num_notify(NULL, NULL, (gpointer)self);
+    g_object_notify(G_OBJECT(prv->daemon), "active_ncp");
+    g_object_notify(G_OBJECT(prv->daemon), "active_env");
+    if (prv->active_ncp) {
+        nwamui_ncp_foreach_ncu(prv->active_ncp, (GFunc)initial_notify_nwam_object, (gpointer)self);
+    }
+
+    nwamui_trace_end("status_icon_build_menus");
+    nwamui_daemon_mark_stage(prv->daemon, NWAMUI_DAEMON_STAGE_MENUS);
+
+    return FALSE;
+}
+
 /*
  * nwam_status_icon_run:
  * Make sure this function only be RUN ONCE.
@@ -1194,15 +1216,15 @@ nwam_status_icon_run(NwamStatusIcon *self)
     /* Handle all daemon signals here */
     connect_nwam_object_signals(G_OBJECT(prv->daemon), G_OBJECT(self));
 
-    /* Initial place. Init code must be here. */
-    nwam_menu_recreate_enm_menuitems(self);
-    daemon_online_enm_num_notify(NULL, NULL, (gpointer)self);
+    /* Initial place. Init code must be here. Paint the icon first, the
+     * menus are built once it is shown. Objects the daemon loads later
+     * come in through the "add" signal.
+     */
     g_object_notify(G_OBJECT(prv->daemon), "status");
-    g_object_notify(G_OBJECT(prv->daemon), "active_ncp");
-    g_object_notify(G_OBJECT(prv->daemon), "active_env");
-    if (prv->active_ncp) {
-        nwamui_ncp_foreach_ncu(prv->active_ncp, (GFunc)initial_notify_nwam_object, (gpointer)self);
-    }
+    nwamui_daemon_mark_stage(prv->daemon, NWAMUI_DAEMON_STAGE_ICON);
+
+    g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, status_icon_build_menus,
+      g_object_ref(self), g_object_unref);
 }
 
 void
@@ -1441,6 +1463,10 @@ on_ncp_notify_many_wireless( GObject *gobject, GParamSpec *arg1, gpointer user_d
 
     g_debug("NCP %s has %d wireless NCUs", nwamui_object_get_name(NWAMUI_OBJECT(gobject)), wireless_num);
 
+    if (prv->update_wifi_timer_id > 0) {
+        nwamui_scheduler_set_suspended(prv->update_wifi_timer_id, wireless_num == 0);
+    }
+
     if (wireless_num > 0) {
         nwam_menu_section_foreach(NWAM_MENU(prv->menu), SECTION_WIFI,
           (GFunc)nwam_obj_proxy_refresh, NULL);
@@ -1518,7 +1544,7 @@ nwam_status_icon_finalize (NwamStatusIcon *self)
     nwam_notification_cleanup();
 
     if (prv->animation_icon_update_timeout_id > 0) {
-		g_source_remove (prv->animation_icon_update_timeout_id);
+		nwamui_scheduler_remove (prv->animation_icon_update_timeout_id);
 		prv->animation_icon_update_timeout_id = 0;
 /* 		/\* reset everything of animation_panel_icon here *\/ */
 /* 		prv->icon_stock_index = 0; */
@@ -1558,6 +1584,8 @@ nwam_menu_recreate_ncu_menuitems (NwamStatusIcon *self)
 
     g_return_if_fail(prv->active_ncp);
 
+    nwamui_trace_begin("menu_recreate_ncu");
+
     nwam_status_icon_move_menu_items_to_cache(self, SECTION_NCU);
 
     if (nwamui_ncp_get_ncu_num(prv->active_ncp) > 0) {
@@ -1574,11 +1602,13 @@ nwam_menu_recreate_ncu_menuitems (NwamStatusIcon *self)
 
     nwam_menu_section_set_visible(NWAM_MENU(prv->menu), SECTION_WIFI, TRUE);
     /* Sync all wlan menuitems */
-    g_debug("----------- menu item creation is started for NCP %s -------------",
+    nwamui_log_debug(NWAMUI_LOG_CAT_MENU, "----------- menu item creation is started for NCP %s -------------",
       nwamui_object_get_name(NWAMUI_OBJECT(prv->active_ncp)));
     nwamui_ncp_foreach_ncu_foreach_wifi_info(prv->active_ncp, foreach_wifi_in_ncu_add_to_menuitem, (gpointer)self);
-    g_debug("----------- menu item creation is over for NCP %s    -------------",
+    nwamui_log_debug(NWAMUI_LOG_CAT_MENU, "----------- menu item creation is over for NCP %s    -------------",
       nwamui_object_get_name(NWAMUI_OBJECT(prv->active_ncp)));
+
+    nwamui_trace_end("menu_recreate_ncu");
 }
 
 static void
@@ -1586,9 +1616,13 @@ nwam_menu_recreate_env_menuitems (NwamStatusIcon *self)
 {
     NwamStatusIconPrivate *prv = NWAM_STATUS_ICON_GET_PRIVATE(self);
 
+    nwamui_trace_begin("menu_recreate_loc");
+
     nwam_status_icon_move_menu_items_to_cache(self, SECTION_LOC);
 
     nwamui_daemon_foreach_loc(prv->daemon, foreach_nwam_object_create_menuitem, (gpointer)self);
+
+    nwamui_trace_end("menu_recreate_loc");
 }
 
 static void
@@ -1596,9 +1630,13 @@ nwam_menu_recreate_enm_menuitems (NwamStatusIcon *self)
 {
     NwamStatusIconPrivate *prv = NWAM_STATUS_ICON_GET_PRIVATE(self);
 
+    nwamui_trace_begin("menu_recreate_enm");
+
     nwam_status_icon_move_menu_items_to_cache(self, SECTION_ENM);
 
     nwamui_daemon_foreach_enm(prv->daemon, foreach_nwam_object_create_menuitem, (gpointer)self);
+
+    nwamui_trace_end("menu_recreate_enm");
 }
 
 static void
@@ -1607,15 +1645,19 @@ nwam_menu_start_update_wifi_timer(NwamStatusIcon *self)
     NwamStatusIconPrivate *prv = NWAM_STATUS_ICON_GET_PRIVATE(self);
 
     if (prv->update_wifi_timer_id > 0) {
-        g_source_remove(prv->update_wifi_timer_id);
+        nwamui_scheduler_remove(prv->update_wifi_timer_id);
         prv->update_wifi_timer_id = 0;
     }
 
-    prv->update_wifi_timer_id = g_timeout_add_full(G_PRIORITY_DEFAULT,
-      update_wifi_timer_interval,
+    prv->update_wifi_timer_id = nwamui_scheduler_add(update_wifi_timer_interval,
+      TRUE,
       update_wifi_timer_func,
       (gpointer)g_object_ref(self),
       (GDestroyNotify)g_object_unref);
+
+    /* Nothing to refresh without wireless links. */
+    nwamui_scheduler_set_suspended(prv->update_wifi_timer_id,
+      nwamui_ncp_get_wireless_link_num(prv->active_ncp) == 0);
 }
 
 static void
@@ -1624,7 +1666,7 @@ nwam_menu_stop_update_wifi_timer(NwamStatusIcon *self)
     NwamStatusIconPrivate *prv = NWAM_STATUS_ICON_GET_PRIVATE(self);
 
     if (prv->update_wifi_timer_id > 0) {
-        g_source_remove(prv->update_wifi_timer_id);
+        nwamui_scheduler_remove(prv->update_wifi_timer_id);
         prv->update_wifi_timer_id = 0;
     }
 }
@@ -1874,7 +1916,7 @@ nwam_status_icon_delete_menu_item(NwamStatusIcon *self, NwamuiObject *object)
 
     item = nwam_menu_section_get_item_by_proxy(NWAM_MENU(prv->menu), sec_id, G_OBJECT(object));
     if (item) {
-        g_object_ref(item);
+        nwamui_instances_ref(item);
         REMOVE_MENU_ITEM(NWAM_MENU(prv->menu), item);
         prv->cached_menuitem_list[sec_id] = g_list_prepend(prv->cached_menuitem_list[sec_id], item);
     }
@@ -0,0 +1,1345 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   bench.c
+ *
+ * Times libnwamui against the fake NWAM backend, without nwamd.
+ *
+ *   nwam-bench --fixture=FILE               the configuration of FILE
+ *   nwam-bench --topology=2x8x50x100x40     NCPSxNCUSxLOCSxWLANSxSCAN
+ *                                           synthetic configuration
+ *   nwam-bench --events=10000               events replayed through the
+ *                                           event thread
+ *   nwam-bench --prefs=FILE                 preferences in a keyfile
+ *   nwam-bench --connect=20                 wireless connection attempts
+ *   nwam-bench --soak=50                    replay the events, fail on
+ *                                           leaked instances
+ *   nwam-bench --replay=FILE                events of the script FILE
+ *                                           from the replay event source
+ *   nwam-bench --rtnetlink=500              the next 500 link, address and
+ *                                           route changes of the host,
+ *                                           Linux only
+ *   nwam-bench --capplet-start              a cold start of the capplet,
+ *                                           with and without a snapshot
+ *   nwam-bench --tray-start                 a cold start of the tray, to
+ *                                           its icon and to hydrated
+ *   nwam-bench --selection=500x20x10000     LOCSxCONDSxENVS location
+ *                                           selections, see
+ *                                           nwamui_cond_sim_select()
+ *   nwam-bench --fmri=10000                 SMF FMRI completion keystrokes
+ *                                           over N synthetic FMRIs
+ *
+ * nwam-bench-gtk is built from the same source against the GTK adapter:
+ *
+ *   nwam-bench-gtk --wifi-nets=2000         the list model of the wireless
+ *                                           chooser over N scan results
+ *   nwam-bench-gtk --ui-start               the first window of the capplet,
+ *                                           its UI file built on demand and
+ *                                           all at once, needs a display
+ *   nwam-bench-gtk --compare-rss            the peak RSS with GTK initialised
+ *                                           against that of nwam-bench run
+ *                                           with the same options
+ *
+ * Reports the startup, reload, event throughput and lane delays, the
+ * dispatch of cached scan results, and the peak resident set size.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <libdlwlan.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+#ifndef NWAMUI_CORE_ONLY
+#include "nwam_tree_view.h"
+#endif
+
+#define BENCH_NCP_FMT       "bench%u"
+#define BENCH_DEVICE_FMT    "net%u"
+#define BENCH_RELOADS       10
+#define BENCH_PREF_READS    100000
+#define BENCH_TRAY_SLICE_MSEC   8   /* As the tray, see daemon/main.c */
+#define BENCH_FMRI_MAX_ROWS     200 /* As the completion, see nwamui_gtk.c */
+#define BENCH_FMRI_LOOKUPS      100
+/* As nwam_capplet_dialog_init() asks for them, the first the window */
+#define BENCH_UI_WIDGETS        { "nwam_capplet", "show_combo", "mainview_notebook", \
+                                  "howto_edit_fixed_profile" }
+#ifndef NWAM_BENCH_CORE
+#define NWAM_BENCH_CORE         "nwam-bench"    /* Searched in PATH */
+#endif
+
+/* Command-line options */
+static gboolean debug = FALSE;
+static gchar   *fixture = NULL;
+static gchar   *topology = NULL;
+static gint     n_events = 1000;
+static gint     soak_rounds = 0;
+static gchar   *prefs = NULL;
+static gint     n_connects = 0;
+static gchar   *replay = NULL;
+static gint     n_kernel_events = 0;
+static gboolean capplet_start = FALSE;
+static gboolean tray_start = FALSE;
+static gchar   *selection = NULL;
+static gint     n_fmris = 0;
+#ifndef NWAMUI_CORE_ONLY
+static gint     n_wifi_nets = 0;
+static gboolean ui_start = FALSE;
+static gboolean compare_rss = FALSE;
+#endif
+
+GOptionEntry application_options[] = {
+        { "debug", 0, 0, G_OPTION_ARG_NONE, &debug, N_("Enable debugging messages"), NULL },
+        { "fixture", 'f', 0, G_OPTION_ARG_FILENAME, &fixture, N_("Load the fake backend from FILE"), N_("FILE") },
+        { "topology", 't', 0, G_OPTION_ARG_STRING, &topology, N_("Build NCPSxNCUSxLOCSxWLANSxSCAN synthetic objects"), N_("SIZE") },
+        { "events", 'e', 0, G_OPTION_ARG_INT, &n_events, N_("Replay N synthetic events"), N_("N") },
+        { "prefs", 'p', 0, G_OPTION_ARG_FILENAME, &prefs, N_("Time preference reads and writes against the keyfile FILE"), N_("FILE") },
+        { "connect", 'c', 0, G_OPTION_ARG_INT, &n_connects, N_("Make N wireless connection attempts driven by scripted events"), N_("N") },
+        { "soak", 's', 0, G_OPTION_ARG_INT, &soak_rounds, N_("Replay the events N more times and check no instances leak"), N_("N") },
+        { "replay", 'r', 0, G_OPTION_ARG_FILENAME, &replay, N_("Take the events from the script FILE, as fast as they are handled"), N_("FILE") },
+        { "capplet-start", 0, 0, G_OPTION_ARG_NONE, &capplet_start, N_("Time a cold start of the capplet, with and without a snapshot"), NULL },
+        { "selection", 0, 0, G_OPTION_ARG_STRING, &selection, N_("Time the location selection among LOCSxCONDSxENVS synthetic locations, conditions and environments"), N_("SIZE") },
+        { "tray-start", 0, 0, G_OPTION_ARG_NONE, &tray_start, N_("Time a cold start of the tray to its icon and to hydrated, staged and not"), NULL },
+        { "fmri", 0, 0, G_OPTION_ARG_INT, &n_fmris, N_("Time the SMF FMRI completion, keystroke by keystroke, over N synthetic FMRIs"), N_("N") },
+#ifndef NWAMUI_CORE_ONLY
+        { "wifi-nets", 0, 0, G_OPTION_ARG_INT, &n_wifi_nets, N_("Time the list model of the wireless chooser over N scan results"), N_("N") },
+        { "ui-start", 0, 0, G_OPTION_ARG_NONE, &ui_start, N_("Time the first window of the capplet, its UI file built on demand and all at once"), NULL },
+        { "compare-rss", 0, 0, G_OPTION_ARG_NONE, &compare_rss, N_("Compare the peak RSS, GTK initialised, with that of nwam-bench under the same options"), NULL },
+#endif
+#ifdef __linux__
+        { "rtnetlink", 'k', 0, G_OPTION_ARG_INT, &n_kernel_events, N_("Take the events from rtnetlink, until N are handled"), N_("N") },
+#endif
+        { NULL }
+};
+
+static gboolean
+build_topology(const gchar *size, guint *n_ncus)
+{
+    guint       n_ncps;
+    guint       n_locs;
+    guint       n_wlans;
+    guint       n_scan;
+    guint       i;
+    guint       j;
+    gchar      *name;
+    gchar      *device = NULL;
+    gchar      *conds[2] = { NULL, NULL };
+
+    if (sscanf(size, "%ux%ux%ux%ux%u", &n_ncps, n_ncus, &n_locs, &n_wlans, &n_scan) != 5 ||
+      n_ncps == 0 || *n_ncus == 0) {
+        fprintf(stderr, "Expected NCPSxNCUSxLOCSxWLANSxSCAN, e.g. 2x8x50x100x40\n");
+        return FALSE;
+    }
+
+    nwam_fake_reset();
+
+    /* Every fourth NCU is wireless, the first one included. */
+    for (i = 0; i < n_ncps; i++) {
+        name = g_strdup_printf(BENCH_NCP_FMT, i);
+        nwam_fake_add_ncp(name, FALSE);
+        for (j = 0; j < *n_ncus; j++) {
+            device = g_strdup_printf(BENCH_DEVICE_FMT, j);
+            nwam_fake_add_ncu(name, device, j % 4 == 0, j / 2);
+            g_free(device);
+        }
+        g_free(name);
+    }
+
+    for (i = 0; i < n_locs; i++) {
+        name = g_strdup_printf("loc%u", i);
+        conds[0] = g_strdup_printf("essid is wlan%u", i % MAX(n_wlans, 1));
+        nwam_fake_add_loc(name, i % 2 ? NWAM_ACTIVATION_MODE_CONDITIONAL_ANY :
+          NWAM_ACTIVATION_MODE_MANUAL, conds);
+        g_free(conds[0]);
+        g_free(name);
+    }
+
+    for (i = 0; i < n_wlans; i++) {
+        name = g_strdup_printf("wlan%u", i);
+        nwam_fake_add_known_wlan(name, i, i % 2 ? DLADM_WLAN_SECMODE_WPA : DLADM_WLAN_SECMODE_NONE);
+        g_free(name);
+    }
+
+    for (j = 0; j < *n_ncus; j += 4) {
+        device = g_strdup_printf(BENCH_DEVICE_FMT, j);
+        for (i = 0; i < n_scan; i++) {
+            gchar *essid = g_strdup_printf("wlan%u", i);
+            gchar *bssid = g_strdup_printf("0:1b:2c:%x:%x:%x", j & 0xff, (i >> 8) & 0xff, i & 0xff);
+
+            nwam_fake_add_scan_result(device, essid, bssid,
+              i % 2 ? DLADM_WLAN_SECMODE_WPA : DLADM_WLAN_SECMODE_NONE,
+              DLADM_WLAN_STRENGTH_VERY_WEAK + i % 5, 1 + i % 11);
+            g_free(essid);
+            g_free(bssid);
+        }
+        g_free(device);
+    }
+
+    name = g_strdup_printf(BENCH_NCP_FMT, 0);
+    nwam_fake_set_active_ncp(name);
+    g_free(name);
+
+    return TRUE;
+}
+
+static void
+print_lanes(NwamuiDaemon *daemon)
+{
+    static const gchar *names[] = { "critical", "state", "cosmetic" };
+    guint               count;
+    guint64             avg_usec;
+    guint64             max_usec;
+    gint                lane;
+
+    for (lane = 0; lane < NWAMUI_DAEMON_EVENT_LANE_LAST; lane++) {
+        nwamui_daemon_get_event_lane_stats(daemon, lane, &count, &avg_usec, &max_usec);
+        printf("  %-10s %8u events, delay avg %llu us, max %llu us\n",
+          lane < G_N_ELEMENTS(names) ? names[lane] : "?", count,
+          (unsigned long long)avg_usec, (unsigned long long)max_usec);
+    }
+}
+
+/*
+ * Connects the first wireless NCU to each scanned network in turn. The
+ * fake nwam_wlan_select() reports the association, the link and address
+ * events are queued once the attempt waits for them, as nwamd would.
+ */
+static gboolean
+bench_connect(NwamuiDaemon *daemon, guint n)
+{
+    NwamuiNcu      *ncu = nwamui_ncp_get_first_wireless_ncu_from_active_ncp(daemon);
+    nwam_wlan_t    *wlans = NULL;
+    gchar          *device;
+    gchar          *addr;
+    guint           num;
+    guint           done;
+    guint           failed;
+    guint64         avg_usec;
+    guint64         max_usec;
+    guint           i;
+
+    if (ncu == NULL) {
+        fprintf(stderr, "No wireless NCU in the active NCP, no connections made\n");
+        return FALSE;
+    }
+    device = nwamui_ncu_get_device_name(ncu);
+    g_object_unref(ncu);
+
+    if ((num = nwam_fake_get_scan_results(device, &wlans)) == 0) {
+        fprintf(stderr, "No scan results for %s, no connections made\n", device);
+        g_free(device);
+        return FALSE;
+    }
+
+    for (i = 0; i < n; i++) {
+        const nwam_wlan_t *wlan = &wlans[i % num];
+
+        if (wlan->nww_security_mode != DLADM_WLAN_SECMODE_NONE) {
+            nwamui_wifi_connect_store_key(device, wlan->nww_essid,
+              wlan->nww_security_mode, 1, "bench-key");
+        }
+        nwamui_wifi_connect_start(device, wlan->nww_essid, wlan->nww_security_mode, FALSE);
+
+        if (!nwam_test_wait_for_stage(device, NWAMUI_WIFI_CONNECT_STAGE_LINK_UP)) {
+            break;
+        }
+        if (nwamui_wifi_connect_get_stage(device) == NWAMUI_WIFI_CONNECT_STAGE_LINK_UP) {
+            nwam_fake_queue_link_state(device, TRUE);
+        }
+        if (!nwam_test_wait_for_stage(device, NWAMUI_WIFI_CONNECT_STAGE_ADDRESS)) {
+            break;
+        }
+        if (nwamui_wifi_connect_get_stage(device) == NWAMUI_WIFI_CONNECT_STAGE_ADDRESS) {
+            addr = g_strdup_printf("10.1.%u.%u", (i >> 8) & 0xff, 1 + i % 254);
+            (void) nwam_fake_queue_if_state(device, addr, 24);
+            g_free(addr);
+        }
+        if (!nwam_test_wait_for_stage(device, NWAMUI_WIFI_CONNECT_STAGE_LAST)) {
+            break;
+        }
+    }
+
+    nwamui_wifi_connect_get_stage_stats(NWAMUI_WIFI_CONNECT_STAGE_LAST,
+      &done, &failed, &avg_usec, &max_usec);
+    printf("connect:   %u of %u attempts done, %u failed, avg %.1f ms, max %.1f ms\n",
+      done, n, failed, avg_usec / 1000.0, max_usec / 1000.0);
+    nwamui_wifi_connect_dump(STDOUT_FILENO);
+
+    free(wlans);
+    g_free(device);
+
+    return done == n;
+}
+
+/* The reads done on each notification, and a preferences dialog apply. */
+static void
+bench_prefs(const gchar *path)
+{
+    NwamuiProf *prof;
+    GTimer     *timer = g_timer_new();
+    gint        timeout = 0;
+    gint        i;
+
+    nwamui_prof_set_store(&nwamui_prof_store_keyfile, nwamui_prof_store_keyfile_new(path));
+    prof = nwamui_prof_get_instance();
+    printf("prefs:     %.3f ms to load\n", g_timer_elapsed(timer, NULL) * 1000);
+
+    g_timer_start(timer);
+    for (i = 0; i < BENCH_PREF_READS; i++) {
+        timeout += nwamui_prof_get_notification_default_timeout(prof);
+        (void) nwamui_prof_get_notification_ncu_connected(prof);
+    }
+    printf("           %.3f us per read\n",
+      g_timer_elapsed(timer, NULL) * 1000000 / (BENCH_PREF_READS * 2));
+
+    g_timer_start(timer);
+    nwamui_prof_set_notification_ncu_connected(prof, !nwamui_prof_get_notification_ncu_connected(prof));
+    nwamui_prof_set_notification_ncu_disconnected(prof, !nwamui_prof_get_notification_ncu_disconnected(prof));
+    nwamui_prof_set_notification_default_timeout(prof, timeout / BENCH_PREF_READS + 1);
+    nwamui_prof_commit(prof);
+    printf("           %.3f ms to set and commit 3 keys\n", g_timer_elapsed(timer, NULL) * 1000);
+
+    g_object_unref(prof);
+    g_timer_destroy(timer);
+}
+
+static void
+collect_object(gpointer data, gpointer user_data)
+{
+    GList **objects = (GList **)user_data;
+
+    *objects = g_list_prepend(*objects, g_object_ref(data));
+}
+
+/*
+ * Duplicating every location, then a dialog apply over all of them with
+ * one changed: only that one is committed, with only what it holds.
+ */
+static void
+bench_edit(NwamuiDaemon *daemon)
+{
+    GList                  *locs = NULL;
+    GList                  *idx;
+    GList                  *sessions = NULL;
+    GTimer                 *timer;
+    NwamuiObject           *clone;
+    gchar                  *name;
+    guint                   n_locs;
+    guint                   commits;
+    guint                   props = 0;
+
+    nwamui_daemon_foreach_loc(daemon, collect_object, &locs);
+    if ((n_locs = g_list_length(locs)) == 0) {
+        return;
+    }
+
+    timer = g_timer_new();
+    for (idx = locs; idx; idx = idx->next) {
+        name = g_strdup_printf("%s-copy", nwamui_object_get_name(NWAMUI_OBJECT(idx->data)));
+        clone = nwamui_object_clone(NWAMUI_OBJECT(idx->data), name, NWAMUI_OBJECT(daemon));
+        if (clone != NULL) {
+            g_object_unref(clone);
+        }
+        g_free(name);
+    }
+    printf("clone:     %.3f ms per location (%u locations)\n",
+      g_timer_elapsed(timer, NULL) * 1000 / n_locs, n_locs);
+
+    for (idx = locs; idx; idx = idx->next) {
+        sessions = g_list_prepend(sessions, nwamui_edit_session_new(NWAMUI_OBJECT(idx->data)));
+    }
+    nwamui_edit_session_set((nwamui_edit_session_t *)sessions->data,
+      "default_domainname", "bench.example.com", NULL);
+
+    nwam_fake_reset_commits();
+    g_timer_start(timer);
+    for (idx = sessions; idx; idx = idx->next) {
+        (void) nwamui_edit_session_commit((nwamui_edit_session_t *)idx->data, NULL);
+        nwamui_edit_session_free((nwamui_edit_session_t *)idx->data);
+    }
+    commits = nwam_fake_get_commits(&props);
+    printf("edit:      %u of %u locations committed, %u properties written, %.3f ms\n",
+      commits, n_locs, props, g_timer_elapsed(timer, NULL) * 1000);
+
+    g_list_free(sessions);
+    nwamui_util_free_obj_list(locs);
+    g_timer_destroy(timer);
+}
+
+#define BENCH_GONE_LOC      "bench-gone"
+#define BENCH_ADDED_LOC     "bench-added"
+
+static void
+count_object(gpointer data, gpointer user_data)
+{
+    (*(guint *)user_data)++;
+}
+
+static guint
+count_objects(NwamuiDaemon *daemon)
+{
+    guint   n = 0;
+
+    nwamui_daemon_foreach_ncp(daemon, count_object, &n);
+    nwamui_daemon_foreach_loc(daemon, count_object, &n);
+    nwamui_daemon_foreach_enm(daemon, count_object, &n);
+    nwamui_daemon_foreach_fav_wifi(daemon, count_object, &n);
+    return n;
+}
+
+static gboolean
+hydrated(gpointer data)
+{
+    return nwamui_daemon_is_hydrated(NWAMUI_DAEMON(data));
+}
+
+/* Lists everything, like the capplet without a snapshot, and writes one. */
+static void
+capplet_start_writer(const gchar *path, int ready, int done)
+{
+    NwamuiDaemon   *daemon;
+    GTimer         *timer;
+    gchar           byte = 0;
+
+    /* Only this process knows it, so the snapshot names a location which
+     * has since been destroyed. */
+    nwam_fake_add_loc(BENCH_GONE_LOC, NWAM_ACTIVATION_MODE_MANUAL, NULL);
+
+    timer = g_timer_new();
+    daemon = nwamui_daemon_get_instance();
+    printf("capplet:   %.3f s to list %u objects without the snapshot\n",
+      g_timer_elapsed(timer, NULL), count_objects(daemon));
+    fflush(stdout);
+
+    if (!nwamui_snapshot_write(daemon, path)) {
+        _exit(EXIT_FAILURE);
+    }
+    (void) write(ready, &byte, 1);
+
+    /* The snapshot is only taken while its writer runs. */
+    while (read(done, &byte, 1) > 0)
+        ;
+    _exit(EXIT_SUCCESS);
+}
+
+/* Lists from the snapshot, then hydrates and reconciles with the store. */
+static void
+capplet_start_reader(const gchar *path)
+{
+    nwamui_snapshot_t  *snap;
+    NwamuiDaemon       *daemon;
+    NwamuiObject       *gone;
+    NwamuiObject       *added;
+    GTimer             *timer;
+    gdouble             secs;
+    guint               n;
+    gboolean            ok;
+
+    /* Only this process knows it, so it was added since the snapshot. */
+    nwam_fake_add_loc(BENCH_ADDED_LOC, NWAM_ACTIVATION_MODE_MANUAL, NULL);
+
+    if ((snap = nwamui_snapshot_open(path)) == NULL) {
+        fprintf(stderr, "capplet: the snapshot %s was not taken\n", path);
+        _exit(EXIT_FAILURE);
+    }
+    nwamui_daemon_set_staged_startup(TRUE, 0);
+    nwamui_daemon_set_startup_snapshot(snap);
+
+    timer = g_timer_new();
+    daemon = nwamui_daemon_get_instance();
+    secs = g_timer_elapsed(timer, NULL);
+    n = count_objects(daemon);
+
+    gone = nwamui_daemon_get_env_by_name(daemon, BENCH_GONE_LOC);
+    ok = gone != NULL && nwamui_object_is_stand_in(gone);
+    if (gone != NULL) {
+        g_object_unref(gone);
+    }
+
+    if (!nwam_test_run_until(hydrated, daemon, NWAM_TEST_TIMEOUT_SECS)) {
+        _exit(EXIT_FAILURE);
+    }
+    printf("capplet:   %.3f s to list %u objects from the snapshot, %.3f s to hydrated\n",
+      secs, n, g_timer_elapsed(timer, NULL));
+
+    gone = nwamui_daemon_get_env_by_name(daemon, BENCH_GONE_LOC);
+    added = nwamui_daemon_get_env_by_name(daemon, BENCH_ADDED_LOC);
+    if (gone != NULL) {
+        g_object_unref(gone);
+    }
+    if (gone != NULL || added == NULL) {
+        ok = FALSE;
+    }
+    if (added != NULL) {
+        g_object_unref(added);
+    }
+    if (!ok) {
+        fprintf(stderr, "capplet: the snapshot was not reconciled with the configuration\n");
+    }
+    fflush(stdout);
+    _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/*
+ * A cold start of the capplet, in processes of their own since the daemon
+ * is started once per process: one lists every object and writes the
+ * snapshot, which another lists from before it is hydrated. Each knows a
+ * location the other does not.
+ */
+static gboolean
+bench_capplet_start(void)
+{
+    gchar      *path;
+    int         ready[2];
+    int         done[2];
+    pid_t       writer;
+    pid_t       reader;
+    gchar       byte;
+    int         status = 0;
+    gboolean    ok = FALSE;
+
+    if (pipe(ready) != 0 || pipe(done) != 0) {
+        perror("pipe");
+        return FALSE;
+    }
+    path = g_strdup_printf("%s/nwam-bench.%d.snapshot", g_get_tmp_dir(), (int)getpid());
+    fflush(stdout);
+
+    if ((writer = fork()) == 0) {
+        close(ready[0]);
+        close(done[1]);
+        capplet_start_writer(path, ready[1], done[0]);
+    }
+    close(ready[1]);
+    close(done[0]);
+
+    if (writer > 0 && read(ready[0], &byte, 1) == 1) {
+        if ((reader = fork()) == 0) {
+            close(ready[0]);
+            close(done[1]);
+            capplet_start_reader(path);
+        }
+        ok = reader > 0 && waitpid(reader, &status, 0) == reader &&
+          WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+    close(ready[0]);
+    close(done[1]);
+    if (writer > 0) {
+        (void) waitpid(writer, &status, 0);
+    }
+
+    (void) unlink(path);
+    g_free(path);
+    return ok;
+}
+
+/* Starts the daemon the way the tray does, the icon shown on its status. */
+static void
+tray_start_child(gboolean staged)
+{
+    NwamuiDaemon   *daemon;
+
+    nwamui_daemon_set_staged_startup(staged, BENCH_TRAY_SLICE_MSEC);
+    daemon = nwamui_daemon_get_instance();
+    g_object_notify(G_OBJECT(daemon), "status");
+    nwamui_daemon_mark_stage(daemon, NWAMUI_DAEMON_STAGE_ICON);
+
+    if (!nwam_test_run_until(hydrated, daemon, NWAM_TEST_TIMEOUT_SECS)) {
+        fprintf(stderr, "tray: not hydrated after %d s\n", NWAM_TEST_TIMEOUT_SECS);
+        _exit(EXIT_FAILURE);
+    }
+    printf("tray:      %.3f ms to the icon, %.3f ms to hydrated, %u objects, %s\n",
+      nwamui_daemon_get_stage_usec(daemon, NWAMUI_DAEMON_STAGE_ICON) / 1000.0,
+      nwamui_daemon_get_stage_usec(daemon, NWAMUI_DAEMON_STAGE_HYDRATED) / 1000.0,
+      count_objects(daemon), staged ? "staged" : "synchronous");
+    fflush(stdout);
+    _exit(EXIT_SUCCESS);
+}
+
+/*
+ * A cold start of the tray, staged as it is and synchronous as it was, each
+ * in a process of its own since the daemon is started once per process.
+ */
+static gboolean
+bench_tray_start(void)
+{
+    gboolean    staged;
+    pid_t       child;
+    int         status;
+
+    for (staged = FALSE; staged <= TRUE; staged++) {
+        fflush(stdout);
+        if ((child = fork()) == 0) {
+            tray_start_child(staged);
+        }
+        status = 0;
+        if (child < 0 || waitpid(child, &status, 0) != child ||
+          !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* In the syntax of libnwam, see the [loc] sections of the fixtures. */
+static gchar*
+selection_cond(guint loc, guint cond)
+{
+    guint   n = loc * 31 + cond * 7;
+
+    switch (cond % 5) {
+    case 0:
+        return g_strdup_printf("essid is net-%u", n % 200);
+    case 1:
+        return g_strdup_printf("ip-address is-in-range 10.%u.%u.0/24", n % 16, (n / 16) % 16);
+    case 2:
+        return g_strdup_printf("system-domain contains dom%u", n % 50);
+    case 3:
+        return g_strdup_printf("ncu net%u is active", n % 4);
+    default:
+        return g_strdup_printf("bssid is-not 00:14:4f:00:%02x:%02x", n % 8, (n / 8) % 8);
+    }
+}
+
+static nwamui_cond_env_t*
+selection_env(GRand *rand)
+{
+    nwamui_cond_env_t  *env = nwamui_cond_env_new();
+    gchar              *value;
+
+    value = g_strdup_printf("net%d", g_rand_int_range(rand, 0, 4));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_NCU, value);
+    g_free(value);
+
+    value = g_strdup_printf("10.%d.%d.%d", g_rand_int_range(rand, 0, 16),
+      g_rand_int_range(rand, 0, 16), g_rand_int_range(rand, 1, 255));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_IP_ADDRESS, value);
+    g_free(value);
+
+    value = g_strdup_printf("net-%d", g_rand_int_range(rand, 0, 200));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_ESSID, value);
+    g_free(value);
+
+    value = g_strdup_printf("00:14:4f:00:%02x:%02x", g_rand_int_range(rand, 0, 8),
+      g_rand_int_range(rand, 0, 8));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_BSSID, value);
+    g_free(value);
+
+    value = g_strdup_printf("dom%d.example.com", g_rand_int_range(rand, 0, 50));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_SYS_DOMAIN, value);
+    g_free(value);
+
+    return env;
+}
+
+/*
+ * The locations go through the fake store and the daemon, like the
+ * "Why This Location?" dialog, then only the selections are timed.
+ */
+static void
+selection_child(guint n_locs, guint n_conds, guint n_envs)
+{
+    NwamuiDaemon       *daemon;
+    nwamui_cond_sim_t  *sim;
+    nwamui_cond_env_t **envs;
+    GRand              *rand;
+    GTimer             *timer;
+    gchar             **conds;
+    gchar              *name;
+    guint               n_loaded = 0;
+    guint               n_auto = 0;
+    guint               i;
+    guint               j;
+    gdouble             secs;
+
+    conds = g_new0(gchar *, n_conds + 1);
+    for (i = 0; i < n_locs; i++) {
+        for (j = 0; j < n_conds; j++) {
+            conds[j] = selection_cond(i, j);
+        }
+        name = g_strdup_printf("sel%u", i);
+        nwam_fake_add_loc(name, (i % 2) ? NWAM_ACTIVATION_MODE_CONDITIONAL_ALL :
+          NWAM_ACTIVATION_MODE_CONDITIONAL_ANY, conds);
+        g_free(name);
+        for (j = 0; j < n_conds; j++) {
+            g_free(conds[j]);
+            conds[j] = NULL;
+        }
+    }
+    g_free(conds);
+
+    daemon = nwamui_daemon_get_instance();
+    nwamui_daemon_foreach_loc(daemon, count_object, &n_loaded);
+
+    timer = g_timer_new();
+    sim = nwamui_cond_sim_new_from_daemon(daemon);
+    secs = g_timer_elapsed(timer, NULL);
+    if (nwamui_cond_sim_get_size(sim) != n_loaded || n_loaded < n_locs) {
+        fprintf(stderr, "selection: %u of %u locations compiled\n",
+          nwamui_cond_sim_get_size(sim), n_locs);
+        _exit(EXIT_FAILURE);
+    }
+    printf("selection: %.3f ms to compile %u locations of %u conditions\n",
+      secs * 1000, n_loaded, n_conds);
+
+    /* Built up front, only the selections are timed. */
+    rand = g_rand_new_with_seed(n_envs);
+    envs = g_new(nwamui_cond_env_t *, n_envs);
+    for (i = 0; i < n_envs; i++) {
+        envs[i] = selection_env(rand);
+    }
+    g_rand_free(rand);
+
+    g_timer_start(timer);
+    for (i = 0; i < n_envs; i++) {
+        if (g_strcmp0(nwamui_cond_sim_select(sim, envs[i], NULL), NWAM_LOC_NAME_AUTOMATIC) == 0) {
+            n_auto++;
+        }
+    }
+    secs = g_timer_elapsed(timer, NULL);
+    printf("selection: %.3f s for %u environments, %.1f us each, %u fell back to %s\n",
+      secs, n_envs, n_envs ? secs * 1000000.0 / n_envs : 0.0, n_auto, NWAM_LOC_NAME_AUTOMATIC);
+    fflush(stdout);
+    _exit(EXIT_SUCCESS);
+}
+
+/* In a process of its own, the locations are added before the daemon starts. */
+static gboolean
+bench_selection(const gchar *size)
+{
+    guint       n_locs;
+    guint       n_conds;
+    guint       n_envs;
+    pid_t       child;
+    int         status = 0;
+
+    if (sscanf(size, "%ux%ux%u", &n_locs, &n_conds, &n_envs) != 3) {
+        fprintf(stderr, "Expected LOCSxCONDSxENVS, e.g. 500x20x10000\n");
+        return FALSE;
+    }
+
+    fflush(stdout);
+    if ((child = fork()) == 0) {
+        selection_child(n_locs, n_conds, n_envs);
+    }
+    return child > 0 && waitpid(child, &status, 0) == child &&
+      WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+static const gchar *fmri_categories[] = {
+    "application", "milestone", "network", "platform", "site", "system"
+};
+static const gchar *fmri_words[] = {
+    "physical", "nwam", "netmask", "dns", "client", "name-service", "cache",
+    "filesystem", "console", "login", "device", "identity", "routing", "ssh",
+    "rpc", "bind", "smtp", "ntp", "ipfilter", "inetd", "location", "zones"
+};
+
+static void
+fmri_backend(GFunc callback, gpointer callback_data, gpointer user_data)
+{
+    guint   n = GPOINTER_TO_UINT(user_data);
+    guint   nw = G_N_ELEMENTS(fmri_words);
+    gchar  *fmri;
+    guint   i;
+
+    for (i = 0; i < n; i++) {
+        fmri = g_strdup_printf("svc:/%s/%s/%s-%u:%s",
+          fmri_categories[i % G_N_ELEMENTS(fmri_categories)],
+          fmri_words[(i / 3) % nw], fmri_words[(i / 7 + 5) % nw], i,
+          i % 4 ? "default" : fmri_words[i % nw]);
+        callback(fmri, callback_data);
+        g_free(fmri);
+    }
+}
+
+static gboolean
+fmri_index_ready(gpointer data)
+{
+    return nwamui_fmri_index_is_ready();
+}
+
+static void
+count_fmri(gpointer data, gpointer user_data)
+{
+    (*(guint *)user_data)++;
+}
+
+/* Rows of the completion for key, like smf_fmri_completion_refill(). */
+static guint
+fmri_keystroke(const gchar *key, gboolean prefix_only, gdouble *usec)
+{
+    GTimer *timer = g_timer_new();
+    guint   rows = 0;
+    guint   i;
+
+    for (i = 0; i < BENCH_FMRI_LOOKUPS; i++) {
+        rows = 0;
+        (void) nwamui_fmri_index_lookup(key, prefix_only, BENCH_FMRI_MAX_ROWS, count_fmri, &rows);
+    }
+    *usec = g_timer_elapsed(timer, NULL) * 1000000.0 / BENCH_FMRI_LOOKUPS;
+    g_timer_destroy(timer);
+    return rows;
+}
+
+/*
+ * The FMRIs are typed one character at a time, each keystroke refills the
+ * completion with up to BENCH_FMRI_MAX_ROWS matches. The shortest keys are
+ * the worst, they match nearly everything.
+ */
+static gboolean
+bench_fmri(guint n)
+{
+    static const gchar *typed[] = {
+        "svc:/network/physical",    /* From the start */
+        "physical",                 /* The middle, the way it is usually typed */
+        "zones-"                    /* Matching less with each keystroke */
+    };
+    GTimer     *timer;
+    gchar      *key;
+    gdouble     usec;
+    gdouble     worst;
+    gdouble     total;
+    guint       rows;
+    guint       i;
+    guint       len;
+    gint        prefix_only;
+
+    nwamui_fmri_index_set_backend(fmri_backend, GUINT_TO_POINTER(n));
+
+    timer = g_timer_new();
+    nwamui_fmri_index_build_async(NULL, NULL, NULL);
+    if (!nwam_test_run_until(fmri_index_ready, NULL, NWAM_TEST_TIMEOUT_SECS)) {
+        fprintf(stderr, "fmri: the index was not built after %d s\n", NWAM_TEST_TIMEOUT_SECS);
+        g_timer_destroy(timer);
+        return FALSE;
+    }
+    printf("fmri:      %.3f ms to index %u FMRIs\n",
+      g_timer_elapsed(timer, NULL) * 1000, nwamui_fmri_index_get_size());
+    g_timer_destroy(timer);
+
+    for (i = 0; i < G_N_ELEMENTS(typed); i++) {
+        for (prefix_only = (i == 0); prefix_only >= 0; prefix_only--) {
+            worst = total = 0;
+            for (len = 1; len <= strlen(typed[i]); len++) {
+                key = g_strndup(typed[i], len);
+                rows = fmri_keystroke(key, prefix_only, &usec);
+                if (debug) {
+                    printf("  %-24s %4u rows, %8.1f us\n", key, rows, usec);
+                }
+                worst = MAX(worst, usec);
+                total += usec;
+                g_free(key);
+            }
+            printf("  %-8s %-24s %2u keystrokes, %.1f us each, %.1f us at worst\n",
+              prefix_only ? "prefix" : "anywhere", typed[i], (guint)strlen(typed[i]),
+              total / strlen(typed[i]), worst);
+        }
+    }
+    return TRUE;
+}
+
+#ifndef NWAMUI_CORE_ONLY
+/* Row operations seen by a view of the model. */
+typedef struct {
+    guint   inserted;
+    guint   deleted;
+    guint   changed;
+} bench_rows_t;
+
+static void
+bench_row_inserted(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+    ((bench_rows_t *)data)->inserted++;
+}
+
+static void
+bench_row_deleted(GtkTreeModel *model, GtkTreePath *path, gpointer data)
+{
+    ((bench_rows_t *)data)->deleted++;
+}
+
+static void
+bench_row_changed(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+    ((bench_rows_t *)data)->changed++;
+}
+
+/* The n results of device, every tenth one weaker after the first round. */
+static void
+wifi_nets_scan(NwamuiDaemon *daemon, const gchar *device, guint n, guint round)
+{
+    guint   target;
+    guint   i;
+
+    nwam_fake_clear_scan_results(device);
+    for (i = 0; i < n; i++) {
+        gchar *essid = g_strdup_printf("scan%u", i);
+        gchar *bssid = g_strdup_printf("0:1b:2d:%x:%x:%x", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+
+        nwam_fake_add_scan_result(device, essid, bssid,
+          i % 2 ? DLADM_WLAN_SECMODE_WPA : DLADM_WLAN_SECMODE_NONE,
+          DLADM_WLAN_STRENGTH_VERY_WEAK + (i + (i % 10 == 0 ? round : 0)) % 5, 1 + i % 11);
+        g_free(essid);
+        g_free(bssid);
+    }
+
+    target = nwam_test_lane_count(daemon) + 1;
+    nwam_fake_queue_scan_report(device);
+    (void) nwam_test_wait_for_events(daemon, target);
+    /* And the idle flush of the changed rows */
+    nwam_test_iterate();
+}
+
+/*
+ * The wireless chooser over n scan results of the first wireless NCU: the
+ * memory of the model itself, a rescan where a tenth of the networks
+ * changed strength, and a reload.
+ */
+static gboolean
+bench_wifi_nets(NwamuiDaemon *daemon, guint n)
+{
+    NwamuiNcu      *ncu = nwamui_ncp_get_first_wireless_ncu_from_active_ncp(daemon);
+    GtkTreeModel   *model;
+    GTimer         *timer;
+    bench_rows_t    rows;
+    gchar          *device;
+    gsize           rss_kb;
+    gdouble         secs;
+
+    if (ncu == NULL) {
+        fprintf(stderr, "No wireless NCU in the active NCP, no scan results added\n");
+        return FALSE;
+    }
+    device = nwamui_ncu_get_device_name(ncu);
+    wifi_nets_scan(daemon, device, n, 0);
+
+    rss_kb = nwam_test_rss_kb();
+    timer = g_timer_new();
+    model = nwamui_object_list_model_new_for_wifi_nets(ncu);
+    secs = g_timer_elapsed(timer, NULL);
+    printf("wifi-nets: %d rows in %.3f ms, %ld KB resident for the model\n",
+      gtk_tree_model_iter_n_children(model, NULL), secs * 1000,
+      (glong)nwam_test_rss_kb() - (glong)rss_kb);
+
+    memset(&rows, 0, sizeof (rows));
+    g_signal_connect(model, "row-inserted", G_CALLBACK(bench_row_inserted), &rows);
+    g_signal_connect(model, "row-deleted", G_CALLBACK(bench_row_deleted), &rows);
+    g_signal_connect(model, "row-changed", G_CALLBACK(bench_row_changed), &rows);
+
+    g_timer_start(timer);
+    wifi_nets_scan(daemon, device, n, 1);
+    secs = g_timer_elapsed(timer, NULL);
+    printf("  rescan   %.3f ms, %u inserted, %u deleted, %u changed\n",
+      secs * 1000, rows.inserted, rows.deleted, rows.changed);
+
+    memset(&rows, 0, sizeof (rows));
+    g_timer_start(timer);
+    nwamui_object_list_model_reload(NWAMUI_OBJECT_LIST_MODEL(model));
+    nwam_test_iterate();
+    secs = g_timer_elapsed(timer, NULL);
+    printf("  reload   %.3f ms, %u inserted, %u deleted, %u changed\n",
+      secs * 1000, rows.inserted, rows.deleted, rows.changed);
+
+    g_timer_destroy(timer);
+    g_object_unref(model);
+    g_object_unref(ncu);
+    g_free(device);
+    return TRUE;
+}
+
+static gboolean
+ui_mapped(GtkWidget *widget, GdkEvent *event, gpointer data)
+{
+    *(gboolean *)data = TRUE;
+    return FALSE;
+}
+
+static gboolean
+ui_is_mapped(gpointer data)
+{
+    return *(gboolean *)data;
+}
+
+/* Shows the capplet window the way nwam-manager-properties builds it. */
+static void
+ui_start_child(gboolean on_demand)
+{
+    static const gchar *names[] = BENCH_UI_WIDGETS;
+    GtkWidget          *window = NULL;
+    GTimer             *timer;
+    gdouble             built;
+    gboolean            mapped = FALSE;
+    guint               i;
+
+#ifdef NWAM_BENCH_UI_DIR
+    /* The UI files of the source tree, unless installed. Before GTK
+     * reads the data directories. */
+    if (g_file_test(NWAM_BENCH_UI_DIR, G_FILE_TEST_IS_DIR)) {
+        gchar *dirs = g_strconcat(NWAM_BENCH_UI_DIR, ":",
+          g_getenv("XDG_DATA_DIRS") ? g_getenv("XDG_DATA_DIRS") : "/usr/share", NULL);
+
+        g_setenv("XDG_DATA_DIRS", dirs, TRUE);
+        g_free(dirs);
+    }
+#endif
+
+    if (!gtk_init_check(NULL, NULL)) {
+        printf("ui-start:  no display, the window was not shown\n");
+        fflush(stdout);
+        _exit(EXIT_SUCCESS);
+    }
+
+    /* The custom widget of the UI files, see capplet/main.c */
+    (void) g_type_class_ref(NWAM_TYPE_TREE_VIEW);
+    nwamui_util_ui_set_load_on_demand(on_demand);
+
+    timer = g_timer_new();
+    for (i = 0; i < G_N_ELEMENTS(names); i++) {
+        GtkWidget *widget = nwamui_util_glade_get_widget(names[i]);
+
+        if (window == NULL) {
+            window = widget;
+        }
+    }
+    built = g_timer_elapsed(timer, NULL);
+
+    g_signal_connect(window, "map-event", G_CALLBACK(ui_mapped), &mapped);
+    gtk_widget_show(window);
+    if (!nwam_test_run_until(ui_is_mapped, &mapped, NWAM_TEST_TIMEOUT_SECS)) {
+        fprintf(stderr, "ui-start: not mapped after %d s\n", NWAM_TEST_TIMEOUT_SECS);
+        _exit(EXIT_FAILURE);
+    }
+    printf("ui-start:  %.3f ms to build, %.3f ms to the window, %s\n",
+      built * 1000, g_timer_elapsed(timer, NULL) * 1000,
+      on_demand ? "on demand" : "all of the UI file");
+    fflush(stdout);
+    _exit(EXIT_SUCCESS);
+}
+
+/*
+ * The first window of the capplet, its UI file built all at once as it was
+ * and on demand as it is, each in a process of its own since the UI files
+ * are built once per process. The daemon is left out, see --capplet-start.
+ */
+static gboolean
+bench_ui_start(void)
+{
+    gboolean    on_demand;
+    pid_t       child;
+    int         status;
+
+    for (on_demand = FALSE; on_demand <= TRUE; on_demand++) {
+        fflush(stdout);
+        if ((child = fork()) == 0) {
+            ui_start_child(on_demand);
+        }
+        status = 0;
+        if (child < 0 || waitpid(child, &status, 0) != child ||
+          !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*
+ * The peak RSS reported by nwam-bench, the core-only build, run with args
+ * less the options of the GTK phases. 0 if it didn't report one.
+ */
+static gsize
+core_peak_rss_kb(gchar **args)
+{
+    GPtrArray  *core_argv = g_ptr_array_new();
+    gchar      *out = NULL;
+    gchar      *line;
+    gint        status = 0;
+    gsize       kb = 0;
+    gint        i;
+
+    g_ptr_array_add(core_argv, NWAM_BENCH_CORE);
+    for (i = 1; args[i] != NULL; i++) {
+        if (g_str_has_prefix(args[i], "--compare-rss") ||
+          g_str_has_prefix(args[i], "--ui-start")) {
+            continue;
+        }
+        if (g_str_has_prefix(args[i], "--wifi-nets")) {
+            /* And its value, if not given with '='. */
+            if (strchr(args[i], '=') == NULL && args[i + 1] != NULL) {
+                i++;
+            }
+            continue;
+        }
+        g_ptr_array_add(core_argv, args[i]);
+    }
+    g_ptr_array_add(core_argv, NULL);
+
+    if (g_spawn_sync(NULL, (gchar **)core_argv->pdata, NULL,
+      G_SPAWN_SEARCH_PATH | G_SPAWN_STDERR_TO_DEV_NULL, NULL, NULL,
+      &out, NULL, &status, NULL) &&
+      WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS &&
+      (line = strstr(out, "peak RSS:")) != NULL) {
+        kb = (gsize)strtoul(line + strlen("peak RSS:"), NULL, 10);
+    }
+
+    g_free(out);
+    g_ptr_array_free(core_argv, TRUE);
+    return kb;
+}
+#endif /* NWAMUI_CORE_ONLY */
+
+/* Every round must leave the live instances as the warm-up round did. */
+static gboolean
+soak(NwamuiDaemon *daemon, guint rounds)
+{
+    guint   changed;
+
+    if (!nwam_test_soak(daemon, rounds, (guint)n_events, &changed)) {
+        return FALSE;
+    }
+    printf("soak:      %u rounds of %d events, %u types changed\n", rounds, n_events, changed);
+    return changed == 0;
+}
+
+int
+main(int argc, char** argv)
+{
+    GOptionContext     *option_context;
+    GError             *err = NULL;
+    NwamuiDaemon       *daemon;
+    GTimer             *timer;
+    GTimer             *source_timer;
+    guint               n_ncus = 0;
+    guint               base;
+    guint               source_events = 0;
+    gsize               peak_rss_kb;
+    gint                i;
+    gdouble             secs;
+#ifndef NWAMUI_CORE_ONLY
+    gchar             **args;
+    gboolean            gtk_up = FALSE;
+#endif
+
+    g_thread_init( NULL );
+    g_type_init();
+
+    /* Setup log handler to trap debug messages */
+    nwamui_util_default_log_handler_init();
+
+#ifndef NWAMUI_CORE_ONLY
+    /* For nwam-bench, as given. */
+    args = g_strdupv(argv);
+#endif
+
+    option_context = g_option_context_new("nwam-bench");
+    g_option_context_add_main_entries(option_context, application_options, NULL);
+    if (!g_option_context_parse(option_context, &argc, &argv, &err)) {
+        fprintf(stderr, "%s\n", err->message);
+        g_error_free(err);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(option_context);
+
+    nwamui_util_set_debug_mode( debug );
+
+    if (replay != NULL || n_kernel_events > 0) {
+        const nwamui_event_source_t    *source = &nwamui_event_source_replay;
+        gpointer                        source_data = NULL;
+
+        /* The other phases are driven by the events of the fake backend. */
+        if (n_connects > 0 || soak_rounds > 0) {
+            fprintf(stderr, "--connect and --soak need the events of the fake backend, ignored\n");
+        }
+        n_events = n_connects = soak_rounds = 0;
+
+        if (replay != NULL) {
+            if ((source_data = nwamui_event_source_replay_new(replay, 0)) == NULL) {
+                return EXIT_FAILURE;
+            }
+            source_events = nwamui_event_source_replay_get_length(source_data);
+        } else {
+#ifdef __linux__
+            source = &nwamui_event_source_rtnetlink;
+            if ((source_data = nwamui_event_source_rtnetlink_new()) == NULL) {
+                return EXIT_FAILURE;
+            }
+            source_events = (guint)n_kernel_events;
+#endif
+        }
+        nwamui_daemon_set_event_source(source, source_data);
+    }
+
+    if (fixture != NULL) {
+        if (!nwam_fake_load_fixture(fixture, &err)) {
+            fprintf(stderr, "%s: %s\n", fixture, err->message);
+            g_error_free(err);
+            return EXIT_FAILURE;
+        }
+    } else if (!build_topology(topology ? topology : "1x4x10x10x20", &n_ncus)) {
+        return EXIT_FAILURE;
+    }
+    (void) nwam_test_peak_rss_kb();
+
+    /* Before the daemon of this process is started. */
+    if (capplet_start && !bench_capplet_start()) {
+        return EXIT_FAILURE;
+    }
+    if (tray_start && !bench_tray_start()) {
+        return EXIT_FAILURE;
+    }
+    if (selection != NULL && !bench_selection(selection)) {
+        return EXIT_FAILURE;
+    }
+    if (n_fmris > 0 && !bench_fmri((guint)n_fmris)) {
+        return EXIT_FAILURE;
+    }
+#ifndef NWAMUI_CORE_ONLY
+    if (ui_start && !bench_ui_start()) {
+        return EXIT_FAILURE;
+    }
+    /* Before the daemon, as the capplet and the tray do. Not before the
+     * forked phases, whose children can't share the display connection.
+     */
+    if (compare_rss && !(gtk_up = gtk_init_check(NULL, NULL))) {
+        fprintf(stderr, "--compare-rss: no display, GTK is loaded but not initialised\n");
+    }
+#endif
+
+    timer = g_timer_new();
+
+    /* Startup, up to the initial reload done on the INIT event. */
+    source_timer = g_timer_new();
+    daemon = nwamui_daemon_get_instance();
+    secs = g_timer_elapsed(timer, NULL);
+    if (!nwam_test_wait_for_events(daemon, 1)) {
+        return EXIT_FAILURE;
+    }
+    printf("startup:   %.3f s to the instance, %.3f s to the first event\n",
+      secs, g_timer_elapsed(timer, NULL));
+    (void) nwam_test_peak_rss_kb();
+
+    /* Reloads of the whole configuration, like a refresh from nwamd. */
+    g_timer_start(timer);
+    for (i = 0; i < BENCH_RELOADS; i++) {
+        nwamui_object_reload(NWAMUI_OBJECT(daemon));
+    }
+    secs = g_timer_elapsed(timer, NULL);
+    printf("reload:    %.3f ms per reload (%d reloads)\n", secs * 1000 / BENCH_RELOADS, BENCH_RELOADS);
+    (void) nwam_test_peak_rss_kb();
+
+    /* Event throughput, through the event thread and the lanes. */
+    if (n_events > 0) {
+        base = nwam_test_lane_count(daemon) + nwam_fake_get_queued_events();
+        g_timer_start(timer);
+        nwam_test_queue_events(daemon, (guint)n_events);
+        if (!nwam_test_wait_for_events(daemon, base + (guint)n_events)) {
+            return EXIT_FAILURE;
+        }
+        secs = g_timer_elapsed(timer, NULL);
+        printf("events:    %d events in %.3f s, %.0f events/s\n",
+          n_events, secs, secs > 0 ? n_events / secs : 0.0);
+        print_lanes(daemon);
+        (void) nwam_test_peak_rss_kb();
+    }
+
+    /* Events of the event source, which started with the daemon. The
+     * ACTIVE queued on connect is the first one handled. */
+    if (source_events > 0) {
+        if (!nwam_test_wait_for_events(daemon, source_events + 1)) {
+            return EXIT_FAILURE;
+        }
+        secs = g_timer_elapsed(source_timer, NULL);
+        printf("source:    %u events in %.3f s since startup, %.0f events/s\n",
+          source_events, secs, secs > 0 ? source_events / secs : 0.0);
+        print_lanes(daemon);
+        (void) nwam_test_peak_rss_kb();
+    }
+
+    /* The scan results the menu is rebuilt from. */
+    g_timer_start(timer);
+    for (i = 0; i < BENCH_RELOADS; i++) {
+        nwamui_daemon_dispatch_wifi_scan_events_from_cache(daemon);
+    }
+    secs = g_timer_elapsed(timer, NULL);
+    printf("scan:      %.3f ms per dispatch of %d scanned WLANs\n",
+      secs * 1000 / BENCH_RELOADS, nwamui_daemon_get_num_scanned_wifi(daemon));
+    (void) nwam_test_peak_rss_kb();
+
+#ifndef NWAMUI_CORE_ONLY
+    if (n_wifi_nets > 0 && !bench_wifi_nets(daemon, (guint)n_wifi_nets)) {
+        return EXIT_FAILURE;
+    }
+#endif
+
+    if (prefs != NULL) {
+        bench_prefs(prefs);
+    }
+
+    if (n_connects > 0 && !bench_connect(daemon, (guint)n_connects)) {
+        return EXIT_FAILURE;
+    }
+
+    if (soak_rounds > 0 && !soak(daemon, (guint)soak_rounds)) {
+        nwamui_instances_dump(STDERR_FILENO);
+        return EXIT_FAILURE;
+    }
+
+    /* After the soak, its commits queue events of their own. */
+    bench_edit(daemon);
+
+    if ((peak_rss_kb = nwam_test_peak_rss_kb()) > 0) {
+        printf("peak RSS:  %lu KB\n", (unsigned long)peak_rss_kb);
+    }
+#ifndef NWAMUI_CORE_ONLY
+    if (compare_rss) {
+        gsize core_kb = core_peak_rss_kb(args);
+
+        if (core_kb > 0 && peak_rss_kb > 0) {
+            printf("RSS:       %lu KB core only, %lu KB %s, %+ld KB\n",
+              (unsigned long)core_kb, (unsigned long)peak_rss_kb,
+              gtk_up ? "GTK initialised" : "GTK loaded",
+              (glong)peak_rss_kb - (glong)core_kb);
+        } else {
+            printf("RSS:       no peak RSS from %s to compare\n", NWAM_BENCH_CORE);
+        }
+    }
+    g_strfreev(args);
+#endif
+
+    g_timer_destroy(timer);
+    g_timer_destroy(source_timer);
+    g_object_unref(daemon);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   config_tool.c
+ *
+ * Export and import of the NWAM configuration.
+ *
+ *   nwam-config --export=FILE               export to FILE, "-" for stdout
+ *   nwam-config --import=FILE [--dry-run]   import FILE, "-" for stdin
+ *   nwam-config --import=loc.conf           import a libnwam conf file,
+ *                                           the section is taken from its
+ *                                           name unless --section is given
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include <libnwamui.h>
+
+/* Command-line options */
+static gboolean debug = FALSE;
+static gchar   *export_file = NULL;
+static gchar   *import_file = NULL;
+static gchar   *section = NULL;
+static gboolean dry_run = FALSE;
+static gboolean secrets = FALSE;
+
+GOptionEntry application_options[] = {
+        { "debug", 0, 0, G_OPTION_ARG_NONE, &debug, N_("Enable debugging messages"), NULL },
+        { "export", 'e', 0, G_OPTION_ARG_FILENAME, &export_file, N_("Export the configuration to FILE"), N_("FILE") },
+        { "import", 'i', 0, G_OPTION_ARG_FILENAME, &import_file, N_("Import the configuration from FILE"), N_("FILE") },
+        { "section", 's', 0, G_OPTION_ARG_STRING, &section, N_("Section of the lines before the first header"), N_("SECTION") },
+        { "dry-run", 'n', 0, G_OPTION_ARG_NONE, &dry_run, N_("Validate and report the changes only"), NULL },
+        { "secrets", 0, 0, G_OPTION_ARG_NONE, &secrets, N_("Include the known WLAN key references"), NULL },
+        { NULL }
+};
+
+static void
+print_report(gpointer data, gpointer user_data)
+{
+    printf("%s\n", (const gchar *)data);
+}
+
+int
+main(int argc, char** argv) 
+{
+    GOptionContext     *option_context;
+    GError             *err = NULL;
+    FILE               *fp;
+    guint               flags = 0;
+    gboolean            ok;
+
+    g_thread_init( NULL );
+    g_type_init();
+
+    /* Setup log handler to trap debug messages */
+    nwamui_util_default_log_handler_init();
+
+    option_context = g_option_context_new("nwam-config");
+    g_option_context_add_main_entries(option_context, application_options, NULL);
+    if (!g_option_context_parse(option_context, &argc, &argv, &err)) {
+        fprintf(stderr, "%s\n", err->message);
+        g_error_free(err);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(option_context);
+
+    nwamui_util_set_debug_mode( debug );
+
+    if ((export_file == NULL) == (import_file == NULL)) {
+        fprintf(stderr, _("Give one of --export or --import\n"));
+        return EXIT_FAILURE;
+    }
+
+    if (secrets) {
+        flags |= NWAMUI_CONFIG_SECRETS;
+    }
+    if (dry_run) {
+        flags |= NWAMUI_CONFIG_DRY_RUN;
+    }
+
+    if (export_file) {
+        if (strcmp(export_file, "-") == 0) {
+            fp = stdout;
+        } else if ((fp = fopen(export_file, "w")) == NULL) {
+            perror(export_file);
+            return EXIT_FAILURE;
+        }
+        ok = nwamui_config_export(fp, flags);
+        if (fp != stdout && fclose(fp) != 0) {
+            ok = FALSE;
+        }
+    } else {
+        if (strcmp(import_file, "-") == 0) {
+            fp = stdin;
+        } else if ((fp = fopen(import_file, "r")) == NULL) {
+            perror(import_file);
+            return EXIT_FAILURE;
+        }
+        if (section == NULL) {
+            section = nwamui_config_section_from_filename(import_file);
+        }
+        ok = nwamui_config_import(fp, section, flags, print_report, NULL);
+        if (fp != stdin) {
+            fclose(fp);
+        }
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,129 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   fake_backend.h
+ *
+ */
+
+#ifndef _FAKE_BACKEND_H
+#define	_FAKE_BACKEND_H
+
+#include <glib.h>
+#include <libnwam.h>
+
+G_BEGIN_DECLS
+
+/*
+ * An in-process stand-in for the parts of libnwam, libdladm, libscf and
+ * libkstat used by libnwamui, so the object model can be driven without
+ * nwamd. Programs link libnwamui-fake.la instead of the system libraries.
+ *
+ * The configuration lives in memory, it is built either with the calls
+ * below or from a fixture file, see tests/fixtures/laptop.fixture for the
+ * format. nwam_event_wait() only returns the events queued here, and
+ * nwam_wlan_scan() queues a scan report of the results added for the link.
+ *
+ * All the calls are thread safe, the store is shared by the libnwam, dladm,
+ * kstat and scf fakes.
+ */
+
+/* Store */
+extern void         nwam_fake_reset(void);
+extern gboolean     nwam_fake_load_fixture(const gchar *filename, GError **error);
+
+/* Objects committed since the last reset, and the properties they held. */
+extern void         nwam_fake_reset_commits(void);
+extern guint        nwam_fake_get_commits(guint *props);
+
+extern void         nwam_fake_set_online(gboolean online);
+extern gboolean     nwam_fake_get_online(void);
+extern void         nwam_fake_set_active_ncp(const gchar *name);
+extern gchar*       nwam_fake_get_active_ncp(void);
+extern void         nwam_fake_set_priority_group(int64_t priority_group);
+
+extern void         nwam_fake_add_ncp(const gchar *name, gboolean read_only);
+extern void         nwam_fake_add_ncu(const gchar *ncp, const gchar *device,
+                                      gboolean wireless, uint64_t priority_group);
+extern void         nwam_fake_add_loc(const gchar *name, uint64_t activation_mode,
+                                      gchar **conditions);
+extern void         nwam_fake_add_enm(const gchar *name, const gchar *fmri,
+                                      uint64_t activation_mode);
+extern void         nwam_fake_add_known_wlan(const gchar *essid, uint64_t priority,
+                                             uint32_t security_mode);
+
+/* NCUs are named by their typed name, e.g. "interface:net0". */
+extern gboolean     nwam_fake_set_prop(nwam_object_type_t type, const gchar *parent,
+                                       const gchar *name, const gchar *prop,
+                                       nwam_value_t value);
+extern gboolean     nwam_fake_set_state(nwam_object_type_t type, const gchar *parent,
+                                        const gchar *name, nwam_state_t state,
+                                        nwam_aux_state_t aux_state);
+
+/* Datalinks, for dladm and kstat */
+extern void         nwam_fake_add_link(const gchar *device, gboolean wireless,
+                                       uint64_t speed);
+extern gboolean     nwam_fake_link_exists(const gchar *device);
+extern void         nwam_fake_set_link_wlan(const gchar *device, const gchar *essid,
+                                            uint32_t strength);
+extern void         nwam_fake_add_scan_result(const gchar *device, const gchar *essid,
+                                              const gchar *bssid, uint32_t security_mode,
+                                              uint32_t strength, uint32_t channel);
+extern void         nwam_fake_clear_scan_results(const gchar *device);
+extern guint        nwam_fake_get_scan_results(const gchar *device, nwam_wlan_t **wlans);
+
+/* Events, returned in order by nwam_event_wait() */
+extern void         nwam_fake_queue_event(nwam_event_t event);
+extern void         nwam_fake_queue_object_action(nwam_object_type_t type, const gchar *parent,
+                                                  const gchar *name, nwam_action_t action);
+extern void         nwam_fake_queue_object_state(nwam_object_type_t type, const gchar *parent,
+                                                 const gchar *name, nwam_state_t state,
+                                                 nwam_aux_state_t aux_state);
+extern void         nwam_fake_queue_link_state(const gchar *device, gboolean up);
+extern void         nwam_fake_queue_need_key(const gchar *device, const gchar *essid);
+extern gboolean     nwam_fake_queue_if_state(const gchar *device, const gchar *address,
+                                             guint prefix_len);
+extern void         nwam_fake_queue_scan_report(const gchar *device);
+extern void         nwam_fake_queue_priority_group(int64_t priority_group);
+extern gboolean     nwam_fake_queue_script_line(const gchar *line, GError **error);
+extern guint        nwam_fake_get_queued_events(void);
+
+/* Used by the SCF fake */
+extern void         nwam_fake_scf_set(const gchar *fmri, const gchar *pg,
+                                      const gchar *prop, const gchar *value);
+extern void         nwam_fake_scf_reset(void);
+
+/* Used by the libnwam fake, the link takes the strength of the scan result */
+extern void         nwam_fake_links_reset(void);
+extern gboolean     nwam_fake_connect_link(const gchar *device, const gchar *essid);
+
+#define NWAM_FAKE_ERROR     (nwam_fake_error_quark())
+
+extern GQuark       nwam_fake_error_quark(void);
+
+G_END_DECLS
+
+#endif	/* _FAKE_BACKEND_H */
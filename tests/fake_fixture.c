@@ -0,0 +1,501 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   fake_fixture.c
+ *
+ * Loads the fake backend from a key file, and parses the event script
+ * lines, see tests/fixtures/laptop.fixture.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+#include <libnwam.h>
+#include <libdlwlan.h>
+
+#include "fake_backend.h"
+
+typedef struct {
+    const gchar    *name;
+    gint            value;
+} fake_keyword_t;
+
+static const fake_keyword_t object_types[] = {
+    { "ncp",            NWAM_OBJECT_TYPE_NCP },
+    { "ncu",            NWAM_OBJECT_TYPE_NCU },
+    { "loc",            NWAM_OBJECT_TYPE_LOC },
+    { "enm",            NWAM_OBJECT_TYPE_ENM },
+    { "wlan",           NWAM_OBJECT_TYPE_KNOWN_WLAN },
+    { NULL }
+};
+
+static const fake_keyword_t actions[] = {
+    { "add",            NWAM_ACTION_ADD },
+    { "remove",         NWAM_ACTION_REMOVE },
+    { "refresh",        NWAM_ACTION_REFRESH },
+    { "enable",         NWAM_ACTION_ENABLE },
+    { "disable",        NWAM_ACTION_DISABLE },
+    { "destroy",        NWAM_ACTION_DESTROY },
+    { NULL }
+};
+
+static const fake_keyword_t states[] = {
+    { "uninitialized",  NWAM_STATE_UNINITIALIZED },
+    { "initialized",    NWAM_STATE_INITIALIZED },
+    { "offline",        NWAM_STATE_OFFLINE },
+    { "offline*",       NWAM_STATE_OFFLINE_TO_ONLINE },
+    { "online*",        NWAM_STATE_ONLINE_TO_OFFLINE },
+    { "online",         NWAM_STATE_ONLINE },
+    { "maintenance",    NWAM_STATE_MAINTENANCE },
+    { "degraded",       NWAM_STATE_DEGRADED },
+    { "disabled",       NWAM_STATE_DISABLED },
+    { NULL }
+};
+
+static const fake_keyword_t aux_states[] = {
+    { "uninitialized",  NWAM_AUX_STATE_UNINITIALIZED },
+    { "conditions-not-met", NWAM_AUX_STATE_CONDITIONS_NOT_MET },
+    { "manual-disable", NWAM_AUX_STATE_MANUAL_DISABLE },
+    { "active",         NWAM_AUX_STATE_ACTIVE },
+    { "up",             NWAM_AUX_STATE_UP },
+    { "down",           NWAM_AUX_STATE_DOWN },
+    { "scanning",       NWAM_AUX_STATE_LINK_WIFI_SCANNING },
+    { "need-selection", NWAM_AUX_STATE_LINK_WIFI_NEED_SELECTION },
+    { "need-key",       NWAM_AUX_STATE_LINK_WIFI_NEED_KEY },
+    { "connecting",     NWAM_AUX_STATE_LINK_WIFI_CONNECTING },
+    { "waiting-for-addr", NWAM_AUX_STATE_IF_WAITING_FOR_ADDR },
+    { "dhcp-timed-out", NWAM_AUX_STATE_IF_DHCP_TIMED_OUT },
+    { "duplicate-addr", NWAM_AUX_STATE_IF_DUPLICATE_ADDR },
+    { NULL }
+};
+
+static const fake_keyword_t activation_modes[] = {
+    { "manual",         NWAM_ACTIVATION_MODE_MANUAL },
+    { "system",         NWAM_ACTIVATION_MODE_SYSTEM },
+    { "prioritized",    NWAM_ACTIVATION_MODE_PRIORITIZED },
+    { "conditional-any", NWAM_ACTIVATION_MODE_CONDITIONAL_ANY },
+    { "conditional-all", NWAM_ACTIVATION_MODE_CONDITIONAL_ALL },
+    { NULL }
+};
+
+static const fake_keyword_t security_modes[] = {
+    { "none",           DLADM_WLAN_SECMODE_NONE },
+    { "wep",            DLADM_WLAN_SECMODE_WEP },
+    { "wpa",            DLADM_WLAN_SECMODE_WPA },
+    { NULL }
+};
+
+static gboolean
+lookup_keyword(const fake_keyword_t *keywords, const gchar *name, gint *value,
+  GError **error)
+{
+    for (; keywords->name != NULL; keywords++) {
+        if (g_ascii_strcasecmp(keywords->name, name) == 0) {
+            *value = keywords->value;
+            return TRUE;
+        }
+    }
+    g_set_error(error, NWAM_FAKE_ERROR, 0, "unknown keyword '%s'", name);
+    return FALSE;
+}
+
+/* NCUs are given as "<ncp>/<typed name>", the other objects by name. */
+static gboolean
+split_object_name(gint type, const gchar *arg, gchar **parent, gchar **name,
+  GError **error)
+{
+    const gchar    *slash;
+
+    if (type != NWAM_OBJECT_TYPE_NCU) {
+        *parent = NULL;
+        *name = g_strdup(arg);
+        return TRUE;
+    }
+    if ((slash = strchr(arg, '/')) == NULL || slash == arg || slash[1] == '\0') {
+        g_set_error(error, NWAM_FAKE_ERROR, 0, "NCU '%s' is not <ncp>/<typed name>", arg);
+        return FALSE;
+    }
+    *parent = g_strndup(arg, slash - arg);
+    *name = g_strdup(slash + 1);
+    return TRUE;
+}
+
+/*
+ * One line of an event script:
+ *
+ *  init | shutdown
+ *  object-action <type> <name> <action>
+ *  object-state <type> <name> <state> [<aux state>]
+ *  link-state <device> up|down
+ *  if-state <device> <address>/<prefix length>
+ *  scan-report <device>
+ *  need-key <device> <essid>
+ *  priority-group <group>
+ *  nwamd online|offline
+ *
+ * Blank lines and lines starting with '#' are ignored.
+ */
+gboolean
+nwam_fake_queue_script_line(const gchar *line, GError **error)
+{
+    gchar     **argv = NULL;
+    gint        argc = 0;
+    gint        type;
+    gint        value;
+    gint        aux = NWAM_AUX_STATE_UNINITIALIZED;
+    gchar      *parent = NULL;
+    gchar      *name = NULL;
+    gchar     **addr = NULL;
+    gboolean    rval = FALSE;
+    const gchar *cmd;
+
+    line += strspn(line, " \t");
+    if (*line == '\0' || *line == '#') {
+        return TRUE;
+    }
+    if (!g_shell_parse_argv(line, &argc, &argv, error)) {
+        return FALSE;
+    }
+    cmd = argv[0];
+
+    if ((strcmp(cmd, "init") == 0 || strcmp(cmd, "shutdown") == 0) && argc == 1) {
+        nwam_event_t event = g_malloc0(sizeof (struct nwam_event));
+
+        event->nwe_type = (strcmp(cmd, "init") == 0) ?
+          NWAM_EVENT_TYPE_INIT : NWAM_EVENT_TYPE_SHUTDOWN;
+        event->nwe_size = sizeof (struct nwam_event);
+        nwam_fake_queue_event(event);
+        rval = TRUE;
+    } else if (strcmp(cmd, "object-action") == 0 && argc == 4) {
+        if (lookup_keyword(object_types, argv[1], &type, error) &&
+          lookup_keyword(actions, argv[3], &value, error) &&
+          split_object_name(type, argv[2], &parent, &name, error)) {
+            nwam_fake_queue_object_action(type, parent, name, value);
+            rval = TRUE;
+        }
+    } else if (strcmp(cmd, "object-state") == 0 && (argc == 4 || argc == 5)) {
+        if (lookup_keyword(object_types, argv[1], &type, error) &&
+          lookup_keyword(states, argv[3], &value, error) &&
+          (argc == 4 || lookup_keyword(aux_states, argv[4], &aux, error)) &&
+          split_object_name(type, argv[2], &parent, &name, error)) {
+            (void) nwam_fake_set_state(type, parent, name, value, aux);
+            nwam_fake_queue_object_state(type, parent, name, value, aux);
+            rval = TRUE;
+        }
+    } else if (strcmp(cmd, "link-state") == 0 && argc == 3) {
+        if (strcmp(argv[2], "up") == 0 || strcmp(argv[2], "down") == 0) {
+            nwam_fake_queue_link_state(argv[1], strcmp(argv[2], "up") == 0);
+            rval = TRUE;
+        } else {
+            g_set_error(error, NWAM_FAKE_ERROR, 0, "link state '%s' is not up or down", argv[2]);
+        }
+    } else if (strcmp(cmd, "if-state") == 0 && argc == 3) {
+        addr = g_strsplit(argv[2], "/", 2);
+        if (addr[1] != NULL &&
+          nwam_fake_queue_if_state(argv[1], addr[0], (guint)strtoul(addr[1], NULL, 10))) {
+            rval = TRUE;
+        } else {
+            g_set_error(error, NWAM_FAKE_ERROR, 0, "address '%s' is not <address>/<prefix length>", argv[2]);
+        }
+    } else if (strcmp(cmd, "need-key") == 0 && argc == 3) {
+        nwam_fake_queue_need_key(argv[1], argv[2]);
+        rval = TRUE;
+    } else if (strcmp(cmd, "scan-report") == 0 && argc == 2) {
+        nwam_fake_queue_scan_report(argv[1]);
+        rval = TRUE;
+    } else if (strcmp(cmd, "priority-group") == 0 && argc == 2) {
+        nwam_fake_queue_priority_group(g_ascii_strtoll(argv[1], NULL, 10));
+        rval = TRUE;
+    } else if (strcmp(cmd, "nwamd") == 0 && argc == 2) {
+        if (strcmp(argv[1], "online") == 0 || strcmp(argv[1], "offline") == 0) {
+            nwam_fake_set_online(strcmp(argv[1], "online") == 0);
+            rval = TRUE;
+        } else {
+            g_set_error(error, NWAM_FAKE_ERROR, 0, "nwamd state '%s' is not online or offline", argv[1]);
+        }
+    } else {
+        g_set_error(error, NWAM_FAKE_ERROR, 0, "can't parse '%s'", line);
+    }
+
+    g_strfreev(addr);
+    g_free(parent);
+    g_free(name);
+    g_strfreev(argv);
+
+    return rval;
+}
+
+static gchar *
+get_string(GKeyFile *keyfile, const gchar *group, const gchar *key, const gchar *def)
+{
+    gchar  *value = g_key_file_get_string(keyfile, group, key, NULL);
+
+    return value ? value : g_strdup(def);
+}
+
+static guint64
+get_uint64(GKeyFile *keyfile, const gchar *group, const gchar *key, guint64 def)
+{
+    gchar      *value = g_key_file_get_string(keyfile, group, key, NULL);
+    guint64     rval = def;
+
+    if (value != NULL) {
+        rval = g_ascii_strtoull(value, NULL, 10);
+        g_free(value);
+    }
+    return rval;
+}
+
+static gboolean
+get_keyword(GKeyFile *keyfile, const gchar *group, const gchar *key,
+  const fake_keyword_t *keywords, gint *value, GError **error)
+{
+    gchar      *str = g_key_file_get_string(keyfile, group, key, NULL);
+    gboolean    rval = TRUE;
+
+    if (str != NULL) {
+        rval = lookup_keyword(keywords, str, value, error);
+        if (!rval) {
+            g_prefix_error(error, "[%s] %s: ", group, key);
+        }
+        g_free(str);
+    }
+    return rval;
+}
+
+static gboolean
+load_ncu(GKeyFile *keyfile, const gchar *group, const gchar *arg, GError **error)
+{
+    gchar      *ncp;
+    gchar      *device;
+    gchar      *media = get_string(keyfile, group, "media", "ether");
+    gboolean    wireless = (g_ascii_strcasecmp(media, "wifi") == 0);
+    gint        state;
+    gint        aux = NWAM_AUX_STATE_UNINITIALIZED;
+    gchar      *typed;
+    gboolean    rval = TRUE;
+
+    g_free(media);
+
+    if (!split_object_name(NWAM_OBJECT_TYPE_NCU, arg, &ncp, &device, error)) {
+        return FALSE;
+    }
+    nwam_fake_add_ncp(ncp, FALSE);
+    nwam_fake_add_ncu(ncp, device, wireless,
+      get_uint64(keyfile, group, "priority-group", 0));
+    nwam_fake_add_link(device, wireless,
+      get_uint64(keyfile, group, "speed", wireless ? 54000000 : 1000000000));
+
+    /* Overrides the state of the link NCU. */
+    if (g_key_file_has_key(keyfile, group, "state", NULL)) {
+        if (get_keyword(keyfile, group, "state", states, &state, error) &&
+          get_keyword(keyfile, group, "aux-state", aux_states, &aux, error)) {
+            typed = g_strconcat("link:", device, NULL);
+            (void) nwam_fake_set_state(NWAM_OBJECT_TYPE_NCU, ncp, typed, state, aux);
+            g_free(typed);
+        } else {
+            rval = FALSE;
+        }
+    }
+
+    g_free(ncp);
+    g_free(device);
+    return rval;
+}
+
+static gboolean
+load_loc(GKeyFile *keyfile, const gchar *group, const gchar *name, GError **error)
+{
+    gint        mode = NWAM_ACTIVATION_MODE_MANUAL;
+    gchar     **conditions;
+    gsize       n = 0;
+
+    if (!get_keyword(keyfile, group, "activation-mode", activation_modes, &mode, error)) {
+        return FALSE;
+    }
+    conditions = g_key_file_get_string_list(keyfile, group, "conditions", &n, NULL);
+    nwam_fake_add_loc(name, mode, conditions);
+    g_strfreev(conditions);
+
+    if (g_key_file_get_boolean(keyfile, group, "enabled", NULL)) {
+        nwam_loc_handle_t   loch;
+
+        if (nwam_loc_read(name, 0, &loch) == NWAM_SUCCESS) {
+            (void) nwam_loc_enable(loch);
+            nwam_loc_free(loch);
+        }
+    }
+    return TRUE;
+}
+
+static gboolean
+load_enm(GKeyFile *keyfile, const gchar *group, const gchar *name, GError **error)
+{
+    gint    mode = NWAM_ACTIVATION_MODE_MANUAL;
+    gchar  *fmri;
+
+    if (!get_keyword(keyfile, group, "activation-mode", activation_modes, &mode, error)) {
+        return FALSE;
+    }
+    fmri = get_string(keyfile, group, "fmri", NULL);
+    nwam_fake_add_enm(name, fmri, mode);
+    g_free(fmri);
+    return TRUE;
+}
+
+static gboolean
+load_wlan(GKeyFile *keyfile, const gchar *group, const gchar *essid, GError **error)
+{
+    gint    secmode = DLADM_WLAN_SECMODE_NONE;
+
+    if (!get_keyword(keyfile, group, "security-mode", security_modes, &secmode, error)) {
+        return FALSE;
+    }
+    nwam_fake_add_known_wlan(essid, get_uint64(keyfile, group, "priority", 0), secmode);
+    return TRUE;
+}
+
+/* results=<essid>,<bssid>,<security>,<strength>,<channel>;... */
+static gboolean
+load_scan(GKeyFile *keyfile, const gchar *group, const gchar *device, GError **error)
+{
+    gchar     **results = g_key_file_get_string_list(keyfile, group, "results", NULL, NULL);
+    gchar     **result;
+    gboolean    rval = TRUE;
+
+    nwam_fake_clear_scan_results(device);
+
+    for (result = results; rval && result != NULL && *result != NULL; result++) {
+        gchar **fields = g_strsplit(*result, ",", 0);
+        gint    secmode;
+
+        if (g_strv_length(fields) != 5) {
+            g_set_error(error, NWAM_FAKE_ERROR, 0, "[%s] results: can't parse '%s'",
+              group, *result);
+            rval = FALSE;
+        } else if (!lookup_keyword(security_modes, fields[2], &secmode, error)) {
+            g_prefix_error(error, "[%s] results: ", group);
+            rval = FALSE;
+        } else {
+            nwam_fake_add_scan_result(device, fields[0], fields[1], secmode,
+              (uint32_t)strtoul(fields[3], NULL, 10),
+              (uint32_t)strtoul(fields[4], NULL, 10));
+        }
+        g_strfreev(fields);
+    }
+    g_strfreev(results);
+
+    return rval;
+}
+
+static gboolean
+load_events(GKeyFile *keyfile, const gchar *group, GError **error)
+{
+    gchar     **lines = g_key_file_get_string_list(keyfile, group, "script", NULL, NULL);
+    gchar     **line;
+    gboolean    rval = TRUE;
+
+    for (line = lines; rval && line != NULL && *line != NULL; line++) {
+        if (!(rval = nwam_fake_queue_script_line(*line, error))) {
+            g_prefix_error(error, "[%s] script: ", group);
+        }
+    }
+    g_strfreev(lines);
+
+    return rval;
+}
+
+/*
+ * Replaces the store with the content of the fixture. The [nwam] group
+ * is applied last, so the active NCP and the state of nwamd win over the
+ * defaults of the objects.
+ */
+gboolean
+nwam_fake_load_fixture(const gchar *filename, GError **error)
+{
+    GKeyFile   *keyfile = g_key_file_new();
+    gchar     **groups = NULL;
+    gchar     **group;
+    gchar      *active_ncp = NULL;
+    gboolean    rval;
+
+    g_key_file_set_list_separator(keyfile, ';');
+
+    nwam_fake_reset();
+
+    if ((rval = g_key_file_load_from_file(keyfile, filename, G_KEY_FILE_NONE, error))) {
+        groups = g_key_file_get_groups(keyfile, NULL);
+    }
+
+    for (group = groups; rval && group != NULL && *group != NULL; group++) {
+        const gchar *arg = strchr(*group, ' ');
+
+        if (arg != NULL) {
+            arg++;
+        }
+
+        if (strcmp(*group, "nwam") == 0 || strcmp(*group, "events") == 0) {
+            continue;
+        } else if (arg != NULL && g_str_has_prefix(*group, "ncp ")) {
+            nwam_fake_add_ncp(arg, g_key_file_get_boolean(keyfile, *group, "read-only", NULL));
+        } else if (arg != NULL && g_str_has_prefix(*group, "ncu ")) {
+            rval = load_ncu(keyfile, *group, arg, error);
+        } else if (arg != NULL && g_str_has_prefix(*group, "loc ")) {
+            rval = load_loc(keyfile, *group, arg, error);
+        } else if (arg != NULL && g_str_has_prefix(*group, "enm ")) {
+            rval = load_enm(keyfile, *group, arg, error);
+        } else if (arg != NULL && g_str_has_prefix(*group, "wlan ")) {
+            rval = load_wlan(keyfile, *group, arg, error);
+        } else if (arg != NULL && g_str_has_prefix(*group, "scan ")) {
+            rval = load_scan(keyfile, *group, arg, error);
+        } else {
+            g_set_error(error, NWAM_FAKE_ERROR, 0, "unknown group [%s]", *group);
+            rval = FALSE;
+        }
+    }
+
+    if (rval && g_key_file_has_group(keyfile, "nwam")) {
+        if ((active_ncp = g_key_file_get_string(keyfile, "nwam", "active-ncp", NULL)) != NULL) {
+            nwam_fake_set_active_ncp(active_ncp);
+            g_free(active_ncp);
+        }
+        nwam_fake_set_priority_group(get_uint64(keyfile, "nwam", "priority-group", 0));
+        if (g_key_file_has_key(keyfile, "nwam", "online", NULL)) {
+            nwam_fake_set_online(g_key_file_get_boolean(keyfile, "nwam", "online", NULL));
+        }
+    }
+    if (rval && g_key_file_has_group(keyfile, "events")) {
+        rval = load_events(keyfile, "events", error);
+    }
+
+    g_strfreev(groups);
+    g_key_file_free(keyfile);
+
+    return rval;
+}
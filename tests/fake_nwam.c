@@ -0,0 +1,2921 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   fake_nwam.c
+ *
+ * The subset of libnwam used by libnwamui, over an in-memory store.
+ *
+ * Handles are private copies of the properties of an object, they are
+ * written back by the commit calls like with libnwam. Enabling or
+ * disabling objects updates their state in the store and queues the
+ * object state events nwamd would have sent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <inet/ip.h>
+
+#include <glib.h>
+#include <libnwam.h>
+#include <libdlwlan.h>
+
+#include "nwam-scf.h"
+#include "fake_backend.h"
+
+#define NCU_LINK_PREFIX         "link:"
+#define NCU_INTERFACE_PREFIX    "interface:"
+
+struct nwam_value {
+    nwam_value_type_t   type;
+    uint_t              num;
+    union {
+        boolean_t      *b;
+        int64_t        *i;
+        uint64_t       *u;
+        char          **s;
+    } v;
+};
+
+typedef struct {
+    nwam_object_type_t  type;
+    gchar              *parent;         /* NCP of an NCU */
+    gchar              *name;           /* Typed name of an NCU */
+    nwam_ncu_class_t    ncu_class;
+    gboolean            read_only;
+    nwam_state_t        state;
+    nwam_aux_state_t    aux_state;
+    GHashTable         *props;          /* gchar* -> nwam_value_t */
+} fake_obj_t;
+
+struct nwam_handle {
+    nwam_object_type_t  type;
+    gchar              *parent;
+    gchar              *name;
+    nwam_ncu_class_t    ncu_class;
+    GHashTable         *props;
+};
+
+typedef int (*fake_walk_cb_t)(struct nwam_handle *, void *);
+
+typedef struct {
+    const gchar        *name;
+    nwam_value_type_t   type;
+    gboolean            read_only;
+} fake_prop_t;
+
+static const fake_prop_t ncu_props[] = {
+    { NWAM_NCU_PROP_TYPE,                   NWAM_VALUE_TYPE_UINT64,     TRUE },
+    { NWAM_NCU_PROP_CLASS,                  NWAM_VALUE_TYPE_UINT64,     TRUE },
+    { NWAM_NCU_PROP_ACTIVATION_MODE,        NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_ENABLED,                NWAM_VALUE_TYPE_BOOLEAN,    FALSE },
+    { NWAM_NCU_PROP_PRIORITY_GROUP,         NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_PRIORITY_MODE,          NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_LINK_MAC_ADDR,          NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_LINK_AUTOPUSH,          NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_LINK_MTU,               NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_IP_VERSION,             NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_IPV4_ADDRSRC,           NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_IPV4_ADDR,              NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_IPV4_DEFAULT_ROUTE,     NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_IPV6_ADDRSRC,           NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_IPV6_ADDR,              NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_IPV6_DEFAULT_ROUTE,     NWAM_VALUE_TYPE_STRING,     FALSE },
+#ifdef TUNNEL_SUPPORT
+    { NWAM_NCU_PROP_IPTUN_TYPE,             NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_NCU_PROP_IPTUN_TSRC,             NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_IPTUN_TDST,             NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_IPTUN_ENCR,             NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_IPTUN_ENCR_AUTH,        NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_NCU_PROP_IPTUN_AUTH,             NWAM_VALUE_TYPE_STRING,     FALSE },
+#endif /* TUNNEL_SUPPORT */
+    { NULL }
+};
+
+static const fake_prop_t loc_props[] = {
+    { NWAM_LOC_PROP_ACTIVATION_MODE,            NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_LOC_PROP_CONDITIONS,                 NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_ENABLED,                    NWAM_VALUE_TYPE_BOOLEAN,    FALSE },
+    { NWAM_LOC_PROP_NAMESERVICES,               NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_LOC_PROP_NAMESERVICES_CONFIG_FILE,   NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_DNS_NAMESERVICE_CONFIGSRC,  NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_LOC_PROP_DNS_NAMESERVICE_DOMAIN,     NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_DNS_NAMESERVICE_SERVERS,    NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_DNS_NAMESERVICE_SEARCH,     NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_DNS_NAMESERVICE_OPTIONS,    NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_DNS_NAMESERVICE_SORTLIST,   NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_NIS_NAMESERVICE_CONFIGSRC,  NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_LOC_PROP_NIS_NAMESERVICE_SERVERS,    NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_LDAP_NAMESERVICE_CONFIGSRC, NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_LOC_PROP_LDAP_NAMESERVICE_SERVERS,   NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_DEFAULT_DOMAIN,             NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_NFSV4_DOMAIN,               NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_IPFILTER_CONFIG_FILE,       NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_IPFILTER_V6_CONFIG_FILE,    NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_IPNAT_CONFIG_FILE,          NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_IPPOOL_CONFIG_FILE,         NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_IKE_CONFIG_FILE,            NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_LOC_PROP_IPSECPOLICY_CONFIG_FILE,    NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NULL }
+};
+
+static const fake_prop_t enm_props[] = {
+    { NWAM_ENM_PROP_ACTIVATION_MODE,        NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_ENM_PROP_CONDITIONS,             NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_ENM_PROP_ENABLED,                NWAM_VALUE_TYPE_BOOLEAN,    FALSE },
+    { NWAM_ENM_PROP_FMRI,                   NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_ENM_PROP_START,                  NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_ENM_PROP_STOP,                   NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NULL }
+};
+
+static const fake_prop_t known_wlan_props[] = {
+    { NWAM_KNOWN_WLAN_PROP_BSSIDS,          NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_KNOWN_WLAN_PROP_PRIORITY,        NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_KNOWN_WLAN_PROP_KEYNAME,         NWAM_VALUE_TYPE_STRING,     FALSE },
+    { NWAM_KNOWN_WLAN_PROP_KEYSLOT,         NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NWAM_KNOWN_WLAN_PROP_SECURITY_MODE,   NWAM_VALUE_TYPE_UINT64,     FALSE },
+    { NULL }
+};
+
+/* The store, objects are kept in creation order for the walks. */
+static GStaticMutex store_mutex = G_STATIC_MUTEX_INIT;
+static GList       *store_objects = NULL;
+static GHashTable  *store_index = NULL;
+static gboolean     store_online = TRUE;
+static gchar       *store_active_ncp = NULL;
+static int64_t      store_priority_group = 0;
+static guint        store_commits = 0;
+static guint        store_commit_props = 0;
+static GHashTable  *store_wlan_keys = NULL;     /* ESSIDs given a key */
+
+/* The events returned by nwam_event_wait() */
+static GStaticMutex event_mutex = G_STATIC_MUTEX_INIT;
+static GCond       *event_cond = NULL;
+static GQueue      *event_queue = NULL;
+static gboolean     events_bound = FALSE;
+
+static void         queue_event(nwam_event_t event, gboolean head);
+
+GQuark
+nwam_fake_error_quark(void)
+{
+    return g_quark_from_static_string("nwam-fake-error-quark");
+}
+
+/* Values */
+
+static nwam_value_t
+value_new(nwam_value_type_t type, uint_t num)
+{
+    nwam_value_t value = g_new0(struct nwam_value, 1);
+
+    value->type = type;
+    value->num = num;
+
+    switch (type) {
+    case NWAM_VALUE_TYPE_BOOLEAN:
+        value->v.b = g_new0(boolean_t, num);
+        break;
+    case NWAM_VALUE_TYPE_INT64:
+        value->v.i = g_new0(int64_t, num);
+        break;
+    case NWAM_VALUE_TYPE_UINT64:
+        value->v.u = g_new0(uint64_t, num);
+        break;
+    case NWAM_VALUE_TYPE_STRING:
+        value->v.s = g_new0(char *, num + 1);
+        break;
+    default:
+        g_assert_not_reached();
+    }
+    return value;
+}
+
+static nwam_value_t
+value_dup(nwam_value_t src)
+{
+    nwam_value_t    value = value_new(src->type, src->num);
+    uint_t          i;
+
+    switch (src->type) {
+    case NWAM_VALUE_TYPE_BOOLEAN:
+        memcpy(value->v.b, src->v.b, src->num * sizeof (boolean_t));
+        break;
+    case NWAM_VALUE_TYPE_INT64:
+        memcpy(value->v.i, src->v.i, src->num * sizeof (int64_t));
+        break;
+    case NWAM_VALUE_TYPE_UINT64:
+        memcpy(value->v.u, src->v.u, src->num * sizeof (uint64_t));
+        break;
+    case NWAM_VALUE_TYPE_STRING:
+        for (i = 0; i < src->num; i++) {
+            value->v.s[i] = g_strdup(src->v.s[i]);
+        }
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+void
+nwam_value_free(nwam_value_t value)
+{
+    if (value == NULL) {
+        return;
+    }
+
+    switch (value->type) {
+    case NWAM_VALUE_TYPE_BOOLEAN:
+        g_free(value->v.b);
+        break;
+    case NWAM_VALUE_TYPE_INT64:
+        g_free(value->v.i);
+        break;
+    case NWAM_VALUE_TYPE_UINT64:
+        g_free(value->v.u);
+        break;
+    case NWAM_VALUE_TYPE_STRING:
+        g_strfreev(value->v.s);
+        break;
+    default:
+        break;
+    }
+    g_free(value);
+}
+
+nwam_error_t
+nwam_value_create_boolean(boolean_t b, nwam_value_t *valuep)
+{
+    return nwam_value_create_boolean_array(&b, 1, valuep);
+}
+
+nwam_error_t
+nwam_value_create_boolean_array(boolean_t *values, uint_t num, nwam_value_t *valuep)
+{
+    if (values == NULL || num == 0 || valuep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *valuep = value_new(NWAM_VALUE_TYPE_BOOLEAN, num);
+    memcpy((*valuep)->v.b, values, num * sizeof (boolean_t));
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_value_create_int64(int64_t i, nwam_value_t *valuep)
+{
+    return nwam_value_create_int64_array(&i, 1, valuep);
+}
+
+nwam_error_t
+nwam_value_create_int64_array(int64_t *values, uint_t num, nwam_value_t *valuep)
+{
+    if (values == NULL || num == 0 || valuep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *valuep = value_new(NWAM_VALUE_TYPE_INT64, num);
+    memcpy((*valuep)->v.i, values, num * sizeof (int64_t));
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_value_create_uint64(uint64_t u, nwam_value_t *valuep)
+{
+    return nwam_value_create_uint64_array(&u, 1, valuep);
+}
+
+nwam_error_t
+nwam_value_create_uint64_array(uint64_t *values, uint_t num, nwam_value_t *valuep)
+{
+    if (values == NULL || num == 0 || valuep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *valuep = value_new(NWAM_VALUE_TYPE_UINT64, num);
+    memcpy((*valuep)->v.u, values, num * sizeof (uint64_t));
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_value_create_string(char *s, nwam_value_t *valuep)
+{
+    return nwam_value_create_string_array(&s, 1, valuep);
+}
+
+nwam_error_t
+nwam_value_create_string_array(char **values, uint_t num, nwam_value_t *valuep)
+{
+    uint_t  i;
+
+    if (values == NULL || num == 0 || valuep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    for (i = 0; i < num; i++) {
+        if (values[i] == NULL) {
+            return NWAM_INVALID_ARG;
+        }
+    }
+    *valuep = value_new(NWAM_VALUE_TYPE_STRING, num);
+    for (i = 0; i < num; i++) {
+        (*valuep)->v.s[i] = g_strdup(values[i]);
+    }
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_value_get_type(nwam_value_t value, nwam_value_type_t *typep)
+{
+    if (value == NULL || typep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *typep = value->type;
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_value_get_numvalues(nwam_value_t value, uint_t *nump)
+{
+    if (value == NULL || nump == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *nump = value->num;
+    return NWAM_SUCCESS;
+}
+
+/* The single value getters fail on arrays, like libnwam. */
+static nwam_error_t
+value_check(nwam_value_t value, nwam_value_type_t type, gboolean single)
+{
+    if (value == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (value->type != type) {
+        return NWAM_ENTITY_TYPE_MISMATCH;
+    }
+    if (single && value->num > 1) {
+        return NWAM_ENTITY_MULTIPLE_VALUES;
+    }
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_value_get_boolean(nwam_value_t value, boolean_t *bp)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_BOOLEAN, TRUE)) == NWAM_SUCCESS) {
+        *bp = value->v.b[0];
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_value_get_boolean_array(nwam_value_t value, boolean_t **valuesp, uint_t *nump)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_BOOLEAN, FALSE)) == NWAM_SUCCESS) {
+        *valuesp = value->v.b;
+        *nump = value->num;
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_value_get_int64(nwam_value_t value, int64_t *ip)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_INT64, TRUE)) == NWAM_SUCCESS) {
+        *ip = value->v.i[0];
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_value_get_int64_array(nwam_value_t value, int64_t **valuesp, uint_t *nump)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_INT64, FALSE)) == NWAM_SUCCESS) {
+        *valuesp = value->v.i;
+        *nump = value->num;
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_value_get_uint64(nwam_value_t value, uint64_t *up)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_UINT64, TRUE)) == NWAM_SUCCESS) {
+        *up = value->v.u[0];
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_value_get_uint64_array(nwam_value_t value, uint64_t **valuesp, uint_t *nump)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_UINT64, FALSE)) == NWAM_SUCCESS) {
+        *valuesp = value->v.u;
+        *nump = value->num;
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_value_get_string(nwam_value_t value, char **sp)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_STRING, TRUE)) == NWAM_SUCCESS) {
+        *sp = value->v.s[0];
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_value_get_string_array(nwam_value_t value, char ***valuesp, uint_t *nump)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = value_check(value, NWAM_VALUE_TYPE_STRING, FALSE)) == NWAM_SUCCESS) {
+        *valuesp = value->v.s;
+        *nump = value->num;
+    }
+    return nerr;
+}
+
+/* Strings */
+
+const char *
+nwam_strerror(nwam_error_t err)
+{
+    switch (err) {
+    case NWAM_SUCCESS:                  return "no error";
+    case NWAM_INVALID_ARG:              return "invalid argument";
+    case NWAM_INVALID_HANDLE:           return "invalid handle";
+    case NWAM_ENTITY_EXISTS:            return "entity exists";
+    case NWAM_ENTITY_NOT_FOUND:         return "entity not found";
+    case NWAM_ENTITY_TYPE_MISMATCH:     return "entity type mismatch";
+    case NWAM_ENTITY_INVALID:           return "validation of entity failed";
+    case NWAM_ENTITY_INVALID_STATE:     return "entity is in wrong state for modification";
+    case NWAM_ENTITY_MULTIPLE_VALUES:   return "multiple values present for single-valued property";
+    case NWAM_ENTITY_READ_ONLY:         return "entity is marked read only";
+    case NWAM_WALK_HALTED:              return "callback function returned nonzero";
+    case NWAM_ERROR_BIND:               return "could not bind to backend server";
+    default:                            return "unknown error";
+    }
+}
+
+const char *
+nwam_object_type_to_string(nwam_object_type_t type)
+{
+    switch (type) {
+    case NWAM_OBJECT_TYPE_NCP:          return "ncp";
+    case NWAM_OBJECT_TYPE_NCU:          return "ncu";
+    case NWAM_OBJECT_TYPE_LOC:          return "loc";
+    case NWAM_OBJECT_TYPE_ENM:          return "enm";
+    case NWAM_OBJECT_TYPE_KNOWN_WLAN:   return "known wlan";
+    default:                            return "unknown";
+    }
+}
+
+const char *
+nwam_event_type_to_string(int type)
+{
+    switch (type) {
+    case NWAM_EVENT_TYPE_INIT:                      return "INIT";
+    case NWAM_EVENT_TYPE_SHUTDOWN:                  return "SHUTDOWN";
+    case NWAM_EVENT_TYPE_OBJECT_ACTION:             return "OBJECT_ACTION";
+    case NWAM_EVENT_TYPE_OBJECT_STATE:              return "OBJECT_STATE";
+    case NWAM_EVENT_TYPE_PRIORITY_GROUP:            return "PRIORITY_GROUP";
+    case NWAM_EVENT_TYPE_WLAN_SCAN_REPORT:          return "WLAN_SCAN_REPORT";
+    case NWAM_EVENT_TYPE_WLAN_NEED_CHOICE:          return "WLAN_NEED_CHOICE";
+    case NWAM_EVENT_TYPE_WLAN_NEED_KEY:             return "WLAN_NEED_KEY";
+    case NWAM_EVENT_TYPE_WLAN_CONNECTION_REPORT:    return "WLAN_CONNECTION_REPORT";
+    case NWAM_EVENT_TYPE_IF_STATE:                  return "IF_STATE";
+    case NWAM_EVENT_TYPE_LINK_STATE:                return "LINK_STATE";
+    case NWAM_EVENT_TYPE_LINK_ACTION:               return "LINK_ACTION";
+    case NWAM_EVENT_TYPE_QUEUE_QUIET:               return "QUEUE_QUIET";
+    default:                                        return "UNKNOWN";
+    }
+}
+
+const char *
+nwam_state_to_string(nwam_state_t state)
+{
+    switch (state) {
+    case NWAM_STATE_UNINITIALIZED:      return "uninitialized";
+    case NWAM_STATE_INITIALIZED:        return "initialized";
+    case NWAM_STATE_OFFLINE:            return "offline";
+    case NWAM_STATE_OFFLINE_TO_ONLINE:  return "offline*";
+    case NWAM_STATE_ONLINE_TO_OFFLINE:  return "online*";
+    case NWAM_STATE_ONLINE:             return "online";
+    case NWAM_STATE_MAINTENANCE:        return "maintenance";
+    case NWAM_STATE_DEGRADED:           return "degraded";
+    case NWAM_STATE_DISABLED:           return "disabled";
+    default:                            return "unknown";
+    }
+}
+
+const char *
+nwam_aux_state_to_string(nwam_aux_state_t aux_state)
+{
+    switch (aux_state) {
+    case NWAM_AUX_STATE_UNINITIALIZED:              return "uninitialized";
+    case NWAM_AUX_STATE_CONDITIONS_NOT_MET:         return "conditions for activation are unmet";
+    case NWAM_AUX_STATE_ACTIVE:                     return "active";
+    case NWAM_AUX_STATE_UP:                         return "interface/link is up";
+    case NWAM_AUX_STATE_DOWN:                       return "interface/link is down";
+    case NWAM_AUX_STATE_LINK_WIFI_SCANNING:         return "scanning for WiFi networks";
+    case NWAM_AUX_STATE_LINK_WIFI_NEED_SELECTION:   return "need WiFi network selection";
+    case NWAM_AUX_STATE_LINK_WIFI_NEED_KEY:         return "need WiFi security key";
+    case NWAM_AUX_STATE_LINK_WIFI_CONNECTING:       return "connecting to WiFi network";
+    case NWAM_AUX_STATE_IF_WAITING_FOR_ADDR:        return "waiting for IP address to be set";
+    case NWAM_AUX_STATE_IF_DHCP_TIMED_OUT:          return "DHCP wait timeout";
+    case NWAM_AUX_STATE_IF_DUPLICATE_ADDR:          return "duplicate address detected";
+    default:                                        return "unknown";
+    }
+}
+
+const char *
+nwam_action_to_string(nwam_action_t action)
+{
+    switch (action) {
+    case NWAM_ACTION_ADD:       return "add";
+    case NWAM_ACTION_REMOVE:    return "remove";
+    case NWAM_ACTION_REFRESH:   return "refresh";
+    case NWAM_ACTION_ENABLE:    return "enable";
+    case NWAM_ACTION_DISABLE:   return "disable";
+    case NWAM_ACTION_DESTROY:   return "destroy";
+    default:                    return "unknown";
+    }
+}
+
+/* Properties */
+
+static const fake_prop_t *
+props_for_type(nwam_object_type_t type)
+{
+    switch (type) {
+    case NWAM_OBJECT_TYPE_NCU:          return ncu_props;
+    case NWAM_OBJECT_TYPE_LOC:          return loc_props;
+    case NWAM_OBJECT_TYPE_ENM:          return enm_props;
+    case NWAM_OBJECT_TYPE_KNOWN_WLAN:   return known_wlan_props;
+    default:                            return NULL;
+    }
+}
+
+static const fake_prop_t *
+find_prop(nwam_object_type_t type, const char *name)
+{
+    const fake_prop_t *prop = props_for_type(type);
+
+    for (; prop != NULL && prop->name != NULL; prop++) {
+        if (strcmp(prop->name, name) == 0) {
+            return prop;
+        }
+    }
+    return NULL;
+}
+
+static nwam_error_t
+prop_get_type(nwam_object_type_t type, const char *name, nwam_value_type_t *typep)
+{
+    const fake_prop_t *prop;
+
+    if (name == NULL || typep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if ((prop = find_prop(type, name)) == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *typep = prop->type;
+    return NWAM_SUCCESS;
+}
+
+static nwam_error_t
+prop_read_only(nwam_object_type_t type, const char *name, boolean_t *readp)
+{
+    const fake_prop_t *prop;
+
+    if (name == NULL || readp == NULL || (prop = find_prop(type, name)) == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *readp = prop->read_only ? B_TRUE : B_FALSE;
+    return NWAM_SUCCESS;
+}
+
+typedef struct {
+    int   (*cb)(const char *, nwam_value_t, void *);
+    void   *data;
+    int     ret;
+} walk_props_data_t;
+
+static void
+walk_props_foreach(gpointer key, gpointer value, gpointer user_data)
+{
+    walk_props_data_t *wp = (walk_props_data_t *)user_data;
+
+    if (wp->ret == 0) {
+        wp->ret = wp->cb((const char *)key, (nwam_value_t)value, wp->data);
+    }
+}
+
+static nwam_error_t
+obj_walk_props(struct nwam_handle *h, int (*cb)(const char *, nwam_value_t, void *),
+  void *data, int *retp)
+{
+    walk_props_data_t   wp = { cb, data, 0 };
+
+    if (h == NULL || cb == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    g_hash_table_foreach(h->props, walk_props_foreach, &wp);
+    if (retp != NULL) {
+        *retp = wp.ret;
+    }
+    return wp.ret == 0 ? NWAM_SUCCESS : NWAM_WALK_HALTED;
+}
+
+static GHashTable *
+props_new(void)
+{
+    return g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+      (GDestroyNotify)nwam_value_free);
+}
+
+static void
+props_copy_foreach(gpointer key, gpointer value, gpointer user_data)
+{
+    g_hash_table_insert((GHashTable *)user_data, g_strdup((gchar *)key),
+      value_dup((nwam_value_t)value));
+}
+
+static GHashTable *
+props_dup(GHashTable *src)
+{
+    GHashTable *props = props_new();
+
+    g_hash_table_foreach(src, props_copy_foreach, props);
+    return props;
+}
+
+static void
+props_set_uint64(GHashTable *props, const gchar *prop, uint64_t u)
+{
+    nwam_value_t    value;
+
+    (void) nwam_value_create_uint64(u, &value);
+    g_hash_table_replace(props, g_strdup(prop), value);
+}
+
+static void
+props_set_boolean(GHashTable *props, const gchar *prop, boolean_t b)
+{
+    nwam_value_t    value;
+
+    (void) nwam_value_create_boolean(b, &value);
+    g_hash_table_replace(props, g_strdup(prop), value);
+}
+
+static void
+props_set_string(GHashTable *props, const gchar *prop, const gchar *s)
+{
+    nwam_value_t    value;
+
+    (void) nwam_value_create_string((char *)s, &value);
+    g_hash_table_replace(props, g_strdup(prop), value);
+}
+
+/* Store */
+
+static gchar *
+obj_key(nwam_object_type_t type, const gchar *parent, const gchar *name)
+{
+    return g_strdup_printf("%d/%s/%s", (gint)type, parent ? parent : "", name);
+}
+
+static void
+obj_free(fake_obj_t *obj)
+{
+    g_free(obj->parent);
+    g_free(obj->name);
+    g_hash_table_destroy(obj->props);
+    g_free(obj);
+}
+
+static void
+store_init_locked(void)
+{
+    if (store_index == NULL) {
+        store_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+}
+
+static fake_obj_t *
+store_lookup_locked(nwam_object_type_t type, const gchar *parent, const gchar *name)
+{
+    gchar      *key;
+    fake_obj_t *obj;
+
+    store_init_locked();
+    key = obj_key(type, parent, name);
+    obj = (fake_obj_t *)g_hash_table_lookup(store_index, key);
+    g_free(key);
+    return obj;
+}
+
+static fake_obj_t *
+store_insert_locked(nwam_object_type_t type, const gchar *parent, const gchar *name,
+  GHashTable *props)
+{
+    fake_obj_t *obj = g_new0(fake_obj_t, 1);
+
+    store_init_locked();
+
+    obj->type = type;
+    obj->parent = g_strdup(parent);
+    obj->name = g_strdup(name);
+    obj->ncu_class = NWAM_NCU_CLASS_PHYS;
+    obj->state = NWAM_STATE_UNINITIALIZED;
+    obj->aux_state = NWAM_AUX_STATE_UNINITIALIZED;
+    obj->props = props ? props : props_new();
+
+    store_objects = g_list_append(store_objects, obj);
+    g_hash_table_insert(store_index, obj_key(type, parent, name), obj);
+
+    return obj;
+}
+
+static void
+store_remove_locked(fake_obj_t *obj)
+{
+    gchar  *key = obj_key(obj->type, obj->parent, obj->name);
+
+    g_hash_table_remove(store_index, key);
+    g_free(key);
+    store_objects = g_list_remove(store_objects, obj);
+    obj_free(obj);
+}
+
+void
+nwam_fake_reset(void)
+{
+    g_static_mutex_lock(&store_mutex);
+    if (store_index) {
+        g_hash_table_destroy(store_index);
+        store_index = NULL;
+    }
+    g_list_foreach(store_objects, (GFunc)obj_free, NULL);
+    g_list_free(store_objects);
+    store_objects = NULL;
+    g_free(store_active_ncp);
+    store_active_ncp = NULL;
+    store_priority_group = 0;
+    store_online = TRUE;
+    store_commits = 0;
+    store_commit_props = 0;
+    if (store_wlan_keys) {
+        g_hash_table_remove_all(store_wlan_keys);
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    g_static_mutex_lock(&event_mutex);
+    if (event_queue) {
+        g_queue_foreach(event_queue, (GFunc)g_free, NULL);
+        g_queue_clear(event_queue);
+    }
+    g_static_mutex_unlock(&event_mutex);
+
+    nwam_fake_links_reset();
+    nwam_fake_scf_reset();
+}
+
+void
+nwam_fake_reset_commits(void)
+{
+    g_static_mutex_lock(&store_mutex);
+    store_commits = 0;
+    store_commit_props = 0;
+    g_static_mutex_unlock(&store_mutex);
+}
+
+guint
+nwam_fake_get_commits(guint *props)
+{
+    guint   commits;
+
+    g_static_mutex_lock(&store_mutex);
+    commits = store_commits;
+    if (props != NULL) {
+        *props = store_commit_props;
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return commits;
+}
+
+void
+nwam_fake_set_online(gboolean online)
+{
+    g_static_mutex_lock(&store_mutex);
+    store_online = online;
+    g_static_mutex_unlock(&store_mutex);
+
+    nwam_fake_scf_set(NWAMUI_FMRI, NULL, NULL,
+      online ? SCF_STATE_STRING_ONLINE : SCF_STATE_STRING_OFFLINE);
+
+    if (!online) {
+        /* nwamd went away, so does the connection. */
+        nwam_events_fini();
+    }
+}
+
+gboolean
+nwam_fake_get_online(void)
+{
+    gboolean    online;
+
+    g_static_mutex_lock(&store_mutex);
+    online = store_online;
+    g_static_mutex_unlock(&store_mutex);
+
+    return online;
+}
+
+static void
+set_state_locked(fake_obj_t *obj, nwam_state_t state, nwam_aux_state_t aux_state)
+{
+    if (obj->state == state && obj->aux_state == aux_state) {
+        return;
+    }
+    obj->state = state;
+    obj->aux_state = aux_state;
+    nwam_fake_queue_object_state(obj->type, obj->parent, obj->name, state, aux_state);
+}
+
+static void
+set_active_ncp_locked(const gchar *name)
+{
+    GList      *idx;
+
+    g_free(store_active_ncp);
+    store_active_ncp = g_strdup(name);
+
+    for (idx = store_objects; idx; idx = idx->next) {
+        fake_obj_t *obj = (fake_obj_t *)idx->data;
+
+        if (obj->type == NWAM_OBJECT_TYPE_NCP) {
+            if (g_strcmp0(obj->name, name) == 0) {
+                set_state_locked(obj, NWAM_STATE_ONLINE, NWAM_AUX_STATE_ACTIVE);
+            } else {
+                set_state_locked(obj, NWAM_STATE_DISABLED, NWAM_AUX_STATE_MANUAL_DISABLE);
+            }
+        }
+    }
+}
+
+void
+nwam_fake_set_active_ncp(const gchar *name)
+{
+    g_static_mutex_lock(&store_mutex);
+    set_active_ncp_locked(name);
+    g_static_mutex_unlock(&store_mutex);
+
+    nwam_fake_scf_set(NWAMUI_FMRI, NWAM_NETCFG_PG, NWAM_NETCFG_ACTIVE_NCP_PROP, name);
+}
+
+gchar *
+nwam_fake_get_active_ncp(void)
+{
+    gchar  *name;
+
+    g_static_mutex_lock(&store_mutex);
+    name = g_strdup(store_active_ncp);
+    g_static_mutex_unlock(&store_mutex);
+
+    return name;
+}
+
+void
+nwam_fake_set_priority_group(int64_t priority_group)
+{
+    g_static_mutex_lock(&store_mutex);
+    store_priority_group = priority_group;
+    g_static_mutex_unlock(&store_mutex);
+}
+
+void
+nwam_fake_add_ncp(const gchar *name, gboolean read_only)
+{
+    fake_obj_t *obj;
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(NWAM_OBJECT_TYPE_NCP, NULL, name)) == NULL) {
+        obj = store_insert_locked(NWAM_OBJECT_TYPE_NCP, NULL, name, NULL);
+        obj->state = NWAM_STATE_DISABLED;
+        obj->aux_state = NWAM_AUX_STATE_MANUAL_DISABLE;
+    }
+    obj->read_only = read_only;
+    g_static_mutex_unlock(&store_mutex);
+}
+
+static gchar *
+typed_name(const gchar *device, nwam_ncu_type_t type)
+{
+    return g_strconcat(type == NWAM_NCU_TYPE_LINK ? NCU_LINK_PREFIX : NCU_INTERFACE_PREFIX,
+      device, NULL);
+}
+
+static fake_obj_t *
+add_ncu_locked(const gchar *ncp, const gchar *device, nwam_ncu_class_t ncu_class)
+{
+    nwam_ncu_type_t type = nwam_ncu_class_to_type(ncu_class);
+    gchar          *name = typed_name(device, type);
+    fake_obj_t     *obj;
+
+    if ((obj = store_lookup_locked(NWAM_OBJECT_TYPE_NCU, ncp, name)) == NULL) {
+        obj = store_insert_locked(NWAM_OBJECT_TYPE_NCU, ncp, name, NULL);
+        obj->ncu_class = ncu_class;
+        props_set_uint64(obj->props, NWAM_NCU_PROP_TYPE, type);
+        props_set_uint64(obj->props, NWAM_NCU_PROP_CLASS, ncu_class);
+        props_set_boolean(obj->props, NWAM_NCU_PROP_ENABLED, B_TRUE);
+    }
+    g_free(name);
+    return obj;
+}
+
+void
+nwam_fake_add_ncu(const gchar *ncp, const gchar *device, gboolean wireless,
+  uint64_t priority_group)
+{
+    fake_obj_t *link;
+    fake_obj_t *iface;
+    uint64_t    ip_versions[] = { IPV4_VERSION, IPV6_VERSION };
+    uint64_t    v4_src[] = { NWAM_ADDRSRC_DHCP };
+    uint64_t    v6_src[] = { NWAM_ADDRSRC_DHCP, NWAM_ADDRSRC_AUTOCONF };
+    nwam_value_t value;
+
+    nwam_fake_add_link(device, wireless, wireless ? 54000000 : 1000000000);
+
+    g_static_mutex_lock(&store_mutex);
+
+    link = add_ncu_locked(ncp, device, NWAM_NCU_CLASS_PHYS);
+    props_set_uint64(link->props, NWAM_NCU_PROP_ACTIVATION_MODE, NWAM_ACTIVATION_MODE_PRIORITIZED);
+    props_set_uint64(link->props, NWAM_NCU_PROP_PRIORITY_GROUP, priority_group);
+    props_set_uint64(link->props, NWAM_NCU_PROP_PRIORITY_MODE, NWAM_PRIORITY_MODE_EXCLUSIVE);
+
+    iface = add_ncu_locked(ncp, device, NWAM_NCU_CLASS_IP);
+    (void) nwam_value_create_uint64_array(ip_versions, 2, &value);
+    g_hash_table_replace(iface->props, g_strdup(NWAM_NCU_PROP_IP_VERSION), value);
+    (void) nwam_value_create_uint64_array(v4_src, 1, &value);
+    g_hash_table_replace(iface->props, g_strdup(NWAM_NCU_PROP_IPV4_ADDRSRC), value);
+    (void) nwam_value_create_uint64_array(v6_src, 2, &value);
+    g_hash_table_replace(iface->props, g_strdup(NWAM_NCU_PROP_IPV6_ADDRSRC), value);
+
+    /* Wired links come up by themselves, wireless ones wait for a choice. */
+    if (wireless) {
+        link->state = NWAM_STATE_OFFLINE_TO_ONLINE;
+        link->aux_state = NWAM_AUX_STATE_LINK_WIFI_NEED_SELECTION;
+        iface->state = NWAM_STATE_OFFLINE;
+        iface->aux_state = NWAM_AUX_STATE_CONDITIONS_NOT_MET;
+    } else {
+        link->state = NWAM_STATE_ONLINE;
+        link->aux_state = NWAM_AUX_STATE_UP;
+        iface->state = NWAM_STATE_ONLINE;
+        iface->aux_state = NWAM_AUX_STATE_ACTIVE;
+    }
+
+    g_static_mutex_unlock(&store_mutex);
+}
+
+void
+nwam_fake_add_loc(const gchar *name, uint64_t activation_mode, gchar **conditions)
+{
+    fake_obj_t     *obj;
+    nwam_value_t    value;
+    uint64_t        ns[] = { NWAM_NAMESERVICES_DNS };
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(NWAM_OBJECT_TYPE_LOC, NULL, name)) == NULL) {
+        obj = store_insert_locked(NWAM_OBJECT_TYPE_LOC, NULL, name, NULL);
+        obj->state = NWAM_STATE_OFFLINE;
+        obj->aux_state = NWAM_AUX_STATE_CONDITIONS_NOT_MET;
+        (void) nwam_value_create_uint64_array(ns, 1, &value);
+        g_hash_table_replace(obj->props, g_strdup(NWAM_LOC_PROP_NAMESERVICES), value);
+        props_set_uint64(obj->props, NWAM_LOC_PROP_DNS_NAMESERVICE_CONFIGSRC, NWAM_CONFIGSRC_DHCP);
+    }
+    props_set_uint64(obj->props, NWAM_LOC_PROP_ACTIVATION_MODE, activation_mode);
+    props_set_boolean(obj->props, NWAM_LOC_PROP_ENABLED, B_FALSE);
+    if (conditions != NULL && g_strv_length(conditions) > 0 &&
+      nwam_value_create_string_array(conditions, g_strv_length(conditions), &value) == NWAM_SUCCESS) {
+        g_hash_table_replace(obj->props, g_strdup(NWAM_LOC_PROP_CONDITIONS), value);
+    }
+    g_static_mutex_unlock(&store_mutex);
+}
+
+void
+nwam_fake_add_enm(const gchar *name, const gchar *fmri, uint64_t activation_mode)
+{
+    fake_obj_t *obj;
+    char       *state = NULL;
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(NWAM_OBJECT_TYPE_ENM, NULL, name)) == NULL) {
+        obj = store_insert_locked(NWAM_OBJECT_TYPE_ENM, NULL, name, NULL);
+        obj->state = NWAM_STATE_DISABLED;
+        obj->aux_state = NWAM_AUX_STATE_MANUAL_DISABLE;
+    }
+    props_set_uint64(obj->props, NWAM_ENM_PROP_ACTIVATION_MODE, activation_mode);
+    props_set_boolean(obj->props, NWAM_ENM_PROP_ENABLED, B_FALSE);
+    if (fmri != NULL) {
+        props_set_string(obj->props, NWAM_ENM_PROP_FMRI, fmri);
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    /* So the service can be looked up by nwamui_svc_new(). */
+    if (fmri != NULL && (state = smf_get_state(fmri)) == NULL) {
+        nwam_fake_scf_set(fmri, NULL, NULL, SCF_STATE_STRING_DISABLED);
+    }
+    free(state);
+}
+
+void
+nwam_fake_add_known_wlan(const gchar *essid, uint64_t priority, uint32_t security_mode)
+{
+    fake_obj_t *obj;
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(NWAM_OBJECT_TYPE_KNOWN_WLAN, NULL, essid)) == NULL) {
+        obj = store_insert_locked(NWAM_OBJECT_TYPE_KNOWN_WLAN, NULL, essid, NULL);
+    }
+    props_set_uint64(obj->props, NWAM_KNOWN_WLAN_PROP_PRIORITY, priority);
+    props_set_uint64(obj->props, NWAM_KNOWN_WLAN_PROP_SECURITY_MODE, security_mode);
+    g_static_mutex_unlock(&store_mutex);
+}
+
+gboolean
+nwam_fake_set_prop(nwam_object_type_t type, const gchar *parent, const gchar *name,
+  const gchar *prop, nwam_value_t value)
+{
+    const fake_prop_t  *p = find_prop(type, prop);
+    fake_obj_t         *obj;
+    gboolean            rval = FALSE;
+
+    if (p == NULL || value == NULL || value->type != p->type) {
+        return FALSE;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(type, parent, name)) != NULL) {
+        g_hash_table_replace(obj->props, g_strdup(prop), value_dup(value));
+        rval = TRUE;
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return rval;
+}
+
+gboolean
+nwam_fake_set_state(nwam_object_type_t type, const gchar *parent, const gchar *name,
+  nwam_state_t state, nwam_aux_state_t aux_state)
+{
+    fake_obj_t *obj;
+    gboolean    rval = FALSE;
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(type, parent, name)) != NULL) {
+        obj->state = state;
+        obj->aux_state = aux_state;
+        rval = TRUE;
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return rval;
+}
+
+/* Handles */
+
+static struct nwam_handle *
+handle_new(nwam_object_type_t type, const gchar *parent, const gchar *name,
+  nwam_ncu_class_t ncu_class, GHashTable *props)
+{
+    struct nwam_handle *h = g_new0(struct nwam_handle, 1);
+
+    h->type = type;
+    h->parent = g_strdup(parent);
+    h->name = g_strdup(name);
+    h->ncu_class = ncu_class;
+    h->props = props ? props : props_new();
+    return h;
+}
+
+static struct nwam_handle *
+handle_from_obj_locked(fake_obj_t *obj)
+{
+    return handle_new(obj->type, obj->parent, obj->name, obj->ncu_class, props_dup(obj->props));
+}
+
+static void
+handle_free(struct nwam_handle *h)
+{
+    if (h == NULL) {
+        return;
+    }
+    g_free(h->parent);
+    g_free(h->name);
+    g_hash_table_destroy(h->props);
+    g_free(h);
+}
+
+static nwam_error_t
+obj_read(nwam_object_type_t type, const gchar *parent, const gchar *name,
+  struct nwam_handle **hp)
+{
+    fake_obj_t     *obj;
+    nwam_error_t    nerr = NWAM_ENTITY_NOT_FOUND;
+
+    if (name == NULL || hp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(type, parent, name)) != NULL) {
+        *hp = handle_from_obj_locked(obj);
+        nerr = NWAM_SUCCESS;
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return nerr;
+}
+
+static nwam_error_t
+obj_create(nwam_object_type_t type, const gchar *parent, const gchar *name,
+  struct nwam_handle **hp)
+{
+    nwam_error_t    nerr = NWAM_SUCCESS;
+
+    if (name == NULL || *name == '\0' || hp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if (store_lookup_locked(type, parent, name) != NULL) {
+        nerr = NWAM_ENTITY_EXISTS;
+    } else {
+        *hp = handle_new(type, parent, name, NWAM_NCU_CLASS_PHYS, NULL);
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return nerr;
+}
+
+static gboolean
+ncp_read_only_locked(const gchar *ncp)
+{
+    fake_obj_t *obj = store_lookup_locked(NWAM_OBJECT_TYPE_NCP, NULL, ncp);
+
+    return obj != NULL && obj->read_only;
+}
+
+static nwam_error_t
+obj_commit(struct nwam_handle *h)
+{
+    fake_obj_t     *obj;
+    nwam_action_t   action = NWAM_ACTION_REFRESH;
+    nwam_error_t    nerr = NWAM_SUCCESS;
+
+    if (h == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if (h->type == NWAM_OBJECT_TYPE_NCU && ncp_read_only_locked(h->parent)) {
+        nerr = NWAM_ENTITY_READ_ONLY;
+    } else {
+        if ((obj = store_lookup_locked(h->type, h->parent, h->name)) == NULL) {
+            obj = store_insert_locked(h->type, h->parent, h->name, NULL);
+            obj->ncu_class = h->ncu_class;
+            obj->state = NWAM_STATE_DISABLED;
+            obj->aux_state = NWAM_AUX_STATE_MANUAL_DISABLE;
+            action = NWAM_ACTION_ADD;
+        }
+        g_hash_table_destroy(obj->props);
+        obj->props = props_dup(h->props);
+        store_commits++;
+        store_commit_props += g_hash_table_size(h->props);
+        nwam_fake_queue_object_action(h->type, h->parent, h->name, action);
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return nerr;
+}
+
+static nwam_error_t
+obj_destroy(struct nwam_handle *h)
+{
+    fake_obj_t     *obj;
+    GList          *idx;
+    GList          *next;
+    nwam_error_t    nerr = NWAM_ENTITY_NOT_FOUND;
+
+    if (h == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(h->type, h->parent, h->name)) != NULL) {
+        if (obj->read_only ||
+          (h->type == NWAM_OBJECT_TYPE_NCU && ncp_read_only_locked(h->parent))) {
+            nerr = NWAM_ENTITY_READ_ONLY;
+        } else {
+            if (h->type == NWAM_OBJECT_TYPE_NCP) {
+                /* Takes its NCUs with it. */
+                for (idx = store_objects; idx; idx = next) {
+                    fake_obj_t *ncu = (fake_obj_t *)idx->data;
+
+                    next = idx->next;
+                    if (ncu->type == NWAM_OBJECT_TYPE_NCU && g_strcmp0(ncu->parent, h->name) == 0) {
+                        store_remove_locked(ncu);
+                    }
+                }
+            }
+            store_remove_locked(obj);
+            nwam_fake_queue_object_action(h->type, h->parent, h->name, NWAM_ACTION_DESTROY);
+            nerr = NWAM_SUCCESS;
+        }
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    if (nerr == NWAM_SUCCESS) {
+        handle_free(h);
+    }
+    return nerr;
+}
+
+static nwam_error_t
+obj_copy(struct nwam_handle *h, const char *name, struct nwam_handle **hp)
+{
+    fake_obj_t     *obj;
+    GList          *idx;
+    GList          *ncus = NULL;
+    nwam_error_t    nerr = NWAM_SUCCESS;
+
+    if (h == NULL || name == NULL || hp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if (store_lookup_locked(h->type, h->parent, name) != NULL) {
+        nerr = NWAM_ENTITY_EXISTS;
+    } else if (h->type == NWAM_OBJECT_TYPE_NCP) {
+        /* NCPs are copied with their NCUs, and committed straight away. */
+        obj = store_insert_locked(NWAM_OBJECT_TYPE_NCP, NULL, name, NULL);
+        obj->state = NWAM_STATE_DISABLED;
+        obj->aux_state = NWAM_AUX_STATE_MANUAL_DISABLE;
+
+        for (idx = store_objects; idx; idx = idx->next) {
+            fake_obj_t *ncu = (fake_obj_t *)idx->data;
+
+            if (ncu->type == NWAM_OBJECT_TYPE_NCU && g_strcmp0(ncu->parent, h->name) == 0) {
+                ncus = g_list_prepend(ncus, ncu);
+            }
+        }
+        for (idx = g_list_reverse(ncus); idx; idx = g_list_delete_link(idx, idx)) {
+            fake_obj_t *ncu = (fake_obj_t *)idx->data;
+            fake_obj_t *copy;
+
+            copy = store_insert_locked(NWAM_OBJECT_TYPE_NCU, name, ncu->name, props_dup(ncu->props));
+            copy->ncu_class = ncu->ncu_class;
+            copy->state = NWAM_STATE_DISABLED;
+            copy->aux_state = NWAM_AUX_STATE_MANUAL_DISABLE;
+        }
+        *hp = handle_from_obj_locked(obj);
+        nwam_fake_queue_object_action(NWAM_OBJECT_TYPE_NCP, NULL, name, NWAM_ACTION_ADD);
+    } else {
+        *hp = handle_new(h->type, h->parent, name, h->ncu_class, props_dup(h->props));
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return nerr;
+}
+
+static nwam_error_t
+obj_walk(nwam_object_type_t type, const gchar *parent, fake_walk_cb_t cb, void *data,
+  int *retp)
+{
+    GPtrArray      *handles = g_ptr_array_new();
+    GList          *idx;
+    guint           i;
+    int             ret = 0;
+    nwam_error_t    nerr = NWAM_SUCCESS;
+
+    if (cb == NULL) {
+        g_ptr_array_free(handles, TRUE);
+        return NWAM_INVALID_ARG;
+    }
+
+    /* The callbacks read other objects, so they run unlocked. */
+    g_static_mutex_lock(&store_mutex);
+    for (idx = store_objects; idx; idx = idx->next) {
+        fake_obj_t *obj = (fake_obj_t *)idx->data;
+
+        if (obj->type == type && (parent == NULL || g_strcmp0(obj->parent, parent) == 0)) {
+            g_ptr_array_add(handles, handle_from_obj_locked(obj));
+        }
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    for (i = 0; i < handles->len; i++) {
+        struct nwam_handle *h = (struct nwam_handle *)g_ptr_array_index(handles, i);
+
+        if (nerr == NWAM_SUCCESS && (ret = cb(h, data)) != 0) {
+            nerr = NWAM_WALK_HALTED;
+        }
+        handle_free(h);
+    }
+    g_ptr_array_free(handles, TRUE);
+
+    if (retp != NULL) {
+        *retp = ret;
+    }
+    return nerr;
+}
+
+static nwam_error_t
+obj_get_name(struct nwam_handle *h, char **namep)
+{
+    if (h == NULL || namep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *namep = strdup(h->name);
+    return NWAM_SUCCESS;
+}
+
+static nwam_error_t
+obj_set_name(struct nwam_handle *h, const char *name)
+{
+    nwam_error_t    nerr = NWAM_SUCCESS;
+
+    if (h == NULL || name == NULL || *name == '\0') {
+        return NWAM_INVALID_ARG;
+    }
+
+    /* Only objects which aren't committed yet can be renamed. */
+    g_static_mutex_lock(&store_mutex);
+    if (store_lookup_locked(h->type, h->parent, h->name) != NULL) {
+        nerr = NWAM_ENTITY_NOT_DESTROYABLE;
+    } else if (store_lookup_locked(h->type, h->parent, name) != NULL) {
+        nerr = NWAM_ENTITY_EXISTS;
+    } else {
+        g_free(h->name);
+        h->name = g_strdup(name);
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return nerr;
+}
+
+static boolean_t
+obj_can_set_name(struct nwam_handle *h)
+{
+    boolean_t   rval;
+
+    if (h == NULL) {
+        return B_FALSE;
+    }
+    g_static_mutex_lock(&store_mutex);
+    rval = store_lookup_locked(h->type, h->parent, h->name) == NULL ? B_TRUE : B_FALSE;
+    g_static_mutex_unlock(&store_mutex);
+
+    return rval;
+}
+
+static nwam_error_t
+obj_get_prop_value(struct nwam_handle *h, const char *prop, nwam_value_t *valuep)
+{
+    nwam_value_t    value;
+
+    if (h == NULL || prop == NULL || valuep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (find_prop(h->type, prop) == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if ((value = (nwam_value_t)g_hash_table_lookup(h->props, prop)) == NULL) {
+        return NWAM_ENTITY_NOT_FOUND;
+    }
+    *valuep = value_dup(value);
+    return NWAM_SUCCESS;
+}
+
+static nwam_error_t
+obj_validate_prop(struct nwam_handle *h, const char *prop, nwam_value_t value)
+{
+    const fake_prop_t  *p;
+
+    if (h == NULL || prop == NULL || value == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if ((p = find_prop(h->type, prop)) == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (value->type != p->type) {
+        return NWAM_ENTITY_TYPE_MISMATCH;
+    }
+    /* Like libnwam, the methods of an ENM are absolute paths and its
+     * service is an FMRI.
+     */
+    if (h->type == NWAM_OBJECT_TYPE_ENM && value->num > 0) {
+        if ((strcmp(prop, NWAM_ENM_PROP_START) == 0 ||
+          strcmp(prop, NWAM_ENM_PROP_STOP) == 0) && value->v.s[0][0] != '/') {
+            return NWAM_ENTITY_INVALID_VALUE;
+        }
+        if (strcmp(prop, NWAM_ENM_PROP_FMRI) == 0 &&
+          strncmp(value->v.s[0], "svc:/", 5) != 0) {
+            return NWAM_ENTITY_INVALID_VALUE;
+        }
+    }
+    return NWAM_SUCCESS;
+}
+
+static nwam_error_t
+obj_set_prop_value(struct nwam_handle *h, const char *prop, nwam_value_t value)
+{
+    const fake_prop_t  *p;
+    nwam_error_t        err;
+
+    if ((err = obj_validate_prop(h, prop, value)) != NWAM_SUCCESS) {
+        return err;
+    }
+    if ((p = find_prop(h->type, prop)) != NULL && p->read_only) {
+        return NWAM_ENTITY_READ_ONLY;
+    }
+    g_hash_table_replace(h->props, g_strdup(prop), value_dup(value));
+    return NWAM_SUCCESS;
+}
+
+static nwam_error_t
+obj_delete_prop(struct nwam_handle *h, const char *prop)
+{
+    const fake_prop_t  *p;
+
+    if (h == NULL || prop == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if ((p = find_prop(h->type, prop)) == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (p->read_only) {
+        return NWAM_ENTITY_READ_ONLY;
+    }
+    if (!g_hash_table_remove(h->props, prop)) {
+        return NWAM_ENTITY_NOT_FOUND;
+    }
+    return NWAM_SUCCESS;
+}
+
+/* Conditional activation needs conditions, the other modes don't. */
+static nwam_error_t
+obj_validate(struct nwam_handle *h, const char *mode_prop, const char *conditions_prop,
+  const char **errpropp)
+{
+    nwam_value_t    value;
+    uint64_t        mode;
+
+    if (h == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (mode_prop == NULL ||
+      (value = (nwam_value_t)g_hash_table_lookup(h->props, mode_prop)) == NULL ||
+      nwam_value_get_uint64(value, &mode) != NWAM_SUCCESS) {
+        return NWAM_SUCCESS;
+    }
+    if ((mode == NWAM_ACTIVATION_MODE_CONDITIONAL_ANY ||
+      mode == NWAM_ACTIVATION_MODE_CONDITIONAL_ALL) &&
+      g_hash_table_lookup(h->props, conditions_prop) == NULL) {
+        if (errpropp != NULL) {
+            *errpropp = conditions_prop;
+        }
+        return NWAM_ENTITY_INVALID;
+    }
+    return NWAM_SUCCESS;
+}
+
+static nwam_error_t
+obj_get_state(struct nwam_handle *h, nwam_state_t *statep, nwam_aux_state_t *auxp)
+{
+    fake_obj_t     *obj;
+    nwam_error_t    nerr = NWAM_ENTITY_NOT_FOUND;
+
+    if (h == NULL || statep == NULL || auxp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(h->type, h->parent, h->name)) != NULL) {
+        *statep = obj->state;
+        *auxp = obj->aux_state;
+        nerr = NWAM_SUCCESS;
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return nerr;
+}
+
+/*
+ * Enabling a location or an ENM brings it online, like a manual selection
+ * would. Only one location can be online, the previous one goes offline.
+ */
+static nwam_error_t
+obj_set_enabled(struct nwam_handle *h, const char *enabled_prop, gboolean enabled)
+{
+    fake_obj_t     *obj;
+    GList          *idx;
+    nwam_error_t    nerr = NWAM_ENTITY_NOT_FOUND;
+
+    if (h == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if ((obj = store_lookup_locked(h->type, h->parent, h->name)) != NULL) {
+        if (enabled_prop != NULL) {
+            props_set_boolean(obj->props, enabled_prop, enabled ? B_TRUE : B_FALSE);
+            props_set_boolean(h->props, enabled_prop, enabled ? B_TRUE : B_FALSE);
+        }
+        if (enabled && obj->type == NWAM_OBJECT_TYPE_LOC) {
+            for (idx = store_objects; idx; idx = idx->next) {
+                fake_obj_t *loc = (fake_obj_t *)idx->data;
+
+                if (loc != obj && loc->type == NWAM_OBJECT_TYPE_LOC && loc->state == NWAM_STATE_ONLINE) {
+                    set_state_locked(loc, NWAM_STATE_OFFLINE, NWAM_AUX_STATE_CONDITIONS_NOT_MET);
+                }
+            }
+        }
+        if (enabled) {
+            set_state_locked(obj, NWAM_STATE_ONLINE,
+              obj->type == NWAM_OBJECT_TYPE_NCU && obj->ncu_class == NWAM_NCU_CLASS_PHYS ?
+              NWAM_AUX_STATE_UP : NWAM_AUX_STATE_ACTIVE);
+        } else {
+            set_state_locked(obj, NWAM_STATE_DISABLED, NWAM_AUX_STATE_MANUAL_DISABLE);
+        }
+        nerr = NWAM_SUCCESS;
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    return nerr;
+}
+
+/* NCPs */
+
+nwam_error_t
+nwam_walk_ncps(int (*cb)(nwam_ncp_handle_t, void *), void *data, uint64_t flags, int *retp)
+{
+    return obj_walk(NWAM_OBJECT_TYPE_NCP, NULL, (fake_walk_cb_t)cb, data, retp);
+}
+
+nwam_error_t
+nwam_ncp_create(const char *name, uint64_t flags, nwam_ncp_handle_t *ncphp)
+{
+    nwam_error_t    nerr;
+
+    /* NCPs have no properties, they exist once created. */
+    if ((nerr = obj_create(NWAM_OBJECT_TYPE_NCP, NULL, name, ncphp)) == NWAM_SUCCESS) {
+        nerr = obj_commit(*ncphp);
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_ncp_read(const char *name, uint64_t flags, nwam_ncp_handle_t *ncphp)
+{
+    return obj_read(NWAM_OBJECT_TYPE_NCP, NULL, name, ncphp);
+}
+
+nwam_error_t
+nwam_ncp_copy(nwam_ncp_handle_t ncph, const char *name, nwam_ncp_handle_t *ncphp)
+{
+    return obj_copy(ncph, name, ncphp);
+}
+
+nwam_error_t
+nwam_ncp_get_name(nwam_ncp_handle_t ncph, char **namep)
+{
+    return obj_get_name(ncph, namep);
+}
+
+nwam_error_t
+nwam_ncp_get_read_only(nwam_ncp_handle_t ncph, boolean_t *readp)
+{
+    if (ncph == NULL || readp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    g_static_mutex_lock(&store_mutex);
+    *readp = ncp_read_only_locked(ncph->name) ? B_TRUE : B_FALSE;
+    g_static_mutex_unlock(&store_mutex);
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_ncp_destroy(nwam_ncp_handle_t ncph, uint64_t flags)
+{
+    return obj_destroy(ncph);
+}
+
+nwam_error_t
+nwam_ncp_enable(nwam_ncp_handle_t ncph)
+{
+    if (ncph == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&store_mutex);
+    if (store_lookup_locked(NWAM_OBJECT_TYPE_NCP, NULL, ncph->name) == NULL) {
+        g_static_mutex_unlock(&store_mutex);
+        return NWAM_ENTITY_NOT_FOUND;
+    }
+    g_static_mutex_unlock(&store_mutex);
+
+    nwam_fake_set_active_ncp(ncph->name);
+    return NWAM_SUCCESS;
+}
+
+void
+nwam_ncp_free(nwam_ncp_handle_t ncph)
+{
+    handle_free(ncph);
+}
+
+nwam_error_t
+nwam_ncp_get_state(nwam_ncp_handle_t ncph, nwam_state_t *statep, nwam_aux_state_t *auxp)
+{
+    return obj_get_state(ncph, statep, auxp);
+}
+
+nwam_error_t
+nwam_ncp_get_active_priority_group(int64_t *pgp)
+{
+    if (pgp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    g_static_mutex_lock(&store_mutex);
+    *pgp = store_priority_group;
+    g_static_mutex_unlock(&store_mutex);
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_ncp_walk_ncus(nwam_ncp_handle_t ncph, int (*cb)(nwam_ncu_handle_t, void *), void *data,
+  uint64_t flags, int *retp)
+{
+    if (ncph == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    return obj_walk(NWAM_OBJECT_TYPE_NCU, ncph->name, (fake_walk_cb_t)cb, data, retp);
+}
+
+/* NCUs */
+
+nwam_ncu_type_t
+nwam_ncu_class_to_type(nwam_ncu_class_t ncu_class)
+{
+    switch (ncu_class) {
+    case NWAM_NCU_CLASS_PHYS:
+    case NWAM_NCU_CLASS_IPTUN:
+        return NWAM_NCU_TYPE_LINK;
+    case NWAM_NCU_CLASS_IP:
+        return NWAM_NCU_TYPE_INTERFACE;
+    default:
+        return NWAM_NCU_TYPE_ANY;
+    }
+}
+
+nwam_error_t
+nwam_ncu_name_to_typed_name(const char *name, nwam_ncu_type_t type, char **typednamep)
+{
+    gchar  *typed;
+
+    if (name == NULL || typednamep == NULL ||
+      (type != NWAM_NCU_TYPE_LINK && type != NWAM_NCU_TYPE_INTERFACE)) {
+        return NWAM_INVALID_ARG;
+    }
+    typed = typed_name(name, type);
+    *typednamep = strdup(typed);
+    g_free(typed);
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_ncu_typed_name_to_name(const char *typed_name, nwam_ncu_type_t *typep, char **namep)
+{
+    if (typed_name == NULL || namep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (g_str_has_prefix(typed_name, NCU_LINK_PREFIX)) {
+        if (typep != NULL) {
+            *typep = NWAM_NCU_TYPE_LINK;
+        }
+        *namep = strdup(typed_name + strlen(NCU_LINK_PREFIX));
+    } else if (g_str_has_prefix(typed_name, NCU_INTERFACE_PREFIX)) {
+        if (typep != NULL) {
+            *typep = NWAM_NCU_TYPE_INTERFACE;
+        }
+        *namep = strdup(typed_name + strlen(NCU_INTERFACE_PREFIX));
+    } else {
+        return NWAM_INVALID_ARG;
+    }
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_ncu_create(nwam_ncp_handle_t ncph, const char *name, nwam_ncu_type_t type,
+  nwam_ncu_class_t ncu_class, nwam_ncu_handle_t *ncuhp)
+{
+    gchar          *typed;
+    nwam_error_t    nerr;
+
+    if (ncph == NULL || name == NULL ||
+      (type != NWAM_NCU_TYPE_LINK && type != NWAM_NCU_TYPE_INTERFACE)) {
+        return NWAM_INVALID_ARG;
+    }
+
+    typed = typed_name(name, type);
+    if ((nerr = obj_create(NWAM_OBJECT_TYPE_NCU, ncph->name, typed, ncuhp)) == NWAM_SUCCESS) {
+        (*ncuhp)->ncu_class = ncu_class;
+        props_set_uint64((*ncuhp)->props, NWAM_NCU_PROP_TYPE, type);
+        props_set_uint64((*ncuhp)->props, NWAM_NCU_PROP_CLASS, ncu_class);
+        props_set_boolean((*ncuhp)->props, NWAM_NCU_PROP_ENABLED, B_TRUE);
+    }
+    g_free(typed);
+
+    return nerr;
+}
+
+nwam_error_t
+nwam_ncu_read(nwam_ncp_handle_t ncph, const char *name, nwam_ncu_type_t type,
+  uint64_t flags, nwam_ncu_handle_t *ncuhp)
+{
+    gchar          *typed;
+    nwam_error_t    nerr;
+
+    if (ncph == NULL || name == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    if (type == NWAM_NCU_TYPE_ANY) {
+        if ((nerr = nwam_ncu_read(ncph, name, NWAM_NCU_TYPE_INTERFACE, flags, ncuhp)) != NWAM_SUCCESS) {
+            nerr = nwam_ncu_read(ncph, name, NWAM_NCU_TYPE_LINK, flags, ncuhp);
+        }
+        return nerr;
+    }
+
+    typed = typed_name(name, type);
+    nerr = obj_read(NWAM_OBJECT_TYPE_NCU, ncph->name, typed, ncuhp);
+    g_free(typed);
+
+    return nerr;
+}
+
+nwam_error_t
+nwam_ncu_get_name(nwam_ncu_handle_t ncuh, char **namep)
+{
+    if (ncuh == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    return nwam_ncu_typed_name_to_name(ncuh->name, NULL, namep);
+}
+
+nwam_error_t
+nwam_ncu_get_ncu_type(nwam_ncu_handle_t ncuh, nwam_ncu_type_t *typep)
+{
+    if (ncuh == NULL || typep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    *typep = g_str_has_prefix(ncuh->name, NCU_LINK_PREFIX) ?
+      NWAM_NCU_TYPE_LINK : NWAM_NCU_TYPE_INTERFACE;
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_ncu_get_read_only(nwam_ncu_handle_t ncuh, boolean_t *readp)
+{
+    if (ncuh == NULL || readp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    g_static_mutex_lock(&store_mutex);
+    *readp = ncp_read_only_locked(ncuh->parent) ? B_TRUE : B_FALSE;
+    g_static_mutex_unlock(&store_mutex);
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_ncu_prop_read_only(const char *prop, boolean_t *readp)
+{
+    return prop_read_only(NWAM_OBJECT_TYPE_NCU, prop, readp);
+}
+
+nwam_error_t
+nwam_ncu_get_prop_type(const char *prop, nwam_value_type_t *typep)
+{
+    return prop_get_type(NWAM_OBJECT_TYPE_NCU, prop, typep);
+}
+
+nwam_error_t
+nwam_ncu_get_prop_value(nwam_ncu_handle_t ncuh, const char *prop, nwam_value_t *valuep)
+{
+    return obj_get_prop_value(ncuh, prop, valuep);
+}
+
+nwam_error_t
+nwam_ncu_set_prop_value(nwam_ncu_handle_t ncuh, const char *prop, nwam_value_t value)
+{
+    return obj_set_prop_value(ncuh, prop, value);
+}
+
+nwam_error_t
+nwam_ncu_delete_prop(nwam_ncu_handle_t ncuh, const char *prop)
+{
+    return obj_delete_prop(ncuh, prop);
+}
+
+nwam_error_t
+nwam_ncu_walk_props(nwam_ncu_handle_t ncuh, int (*cb)(const char *, nwam_value_t, void *),
+  void *data, uint64_t flags, int *retp)
+{
+    return obj_walk_props(ncuh, cb, data, retp);
+}
+
+nwam_error_t
+nwam_ncu_validate(nwam_ncu_handle_t ncuh, const char **errpropp)
+{
+    return obj_validate(ncuh, NULL, NULL, errpropp);
+}
+
+nwam_error_t
+nwam_ncu_commit(nwam_ncu_handle_t ncuh, uint64_t flags)
+{
+    return obj_commit(ncuh);
+}
+
+nwam_error_t
+nwam_ncu_destroy(nwam_ncu_handle_t ncuh, uint64_t flags)
+{
+    return obj_destroy(ncuh);
+}
+
+nwam_error_t
+nwam_ncu_enable(nwam_ncu_handle_t ncuh)
+{
+    return obj_set_enabled(ncuh, NWAM_NCU_PROP_ENABLED, TRUE);
+}
+
+nwam_error_t
+nwam_ncu_disable(nwam_ncu_handle_t ncuh)
+{
+    return obj_set_enabled(ncuh, NWAM_NCU_PROP_ENABLED, FALSE);
+}
+
+nwam_error_t
+nwam_ncu_get_state(nwam_ncu_handle_t ncuh, nwam_state_t *statep, nwam_aux_state_t *auxp)
+{
+    return obj_get_state(ncuh, statep, auxp);
+}
+
+void
+nwam_ncu_free(nwam_ncu_handle_t ncuh)
+{
+    handle_free(ncuh);
+}
+
+/* Locations */
+
+nwam_error_t
+nwam_walk_locs(int (*cb)(nwam_loc_handle_t, void *), void *data, uint64_t flags, int *retp)
+{
+    return obj_walk(NWAM_OBJECT_TYPE_LOC, NULL, (fake_walk_cb_t)cb, data, retp);
+}
+
+nwam_error_t
+nwam_loc_create(const char *name, nwam_loc_handle_t *lochp)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = obj_create(NWAM_OBJECT_TYPE_LOC, NULL, name, lochp)) == NWAM_SUCCESS) {
+        props_set_uint64((*lochp)->props, NWAM_LOC_PROP_ACTIVATION_MODE, NWAM_ACTIVATION_MODE_MANUAL);
+        props_set_boolean((*lochp)->props, NWAM_LOC_PROP_ENABLED, B_FALSE);
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_loc_read(const char *name, uint64_t flags, nwam_loc_handle_t *lochp)
+{
+    return obj_read(NWAM_OBJECT_TYPE_LOC, NULL, name, lochp);
+}
+
+nwam_error_t
+nwam_loc_copy(nwam_loc_handle_t loch, const char *name, nwam_loc_handle_t *lochp)
+{
+    return obj_copy(loch, name, lochp);
+}
+
+nwam_error_t
+nwam_loc_get_name(nwam_loc_handle_t loch, char **namep)
+{
+    return obj_get_name(loch, namep);
+}
+
+nwam_error_t
+nwam_loc_set_name(nwam_loc_handle_t loch, const char *name)
+{
+    return obj_set_name(loch, name);
+}
+
+boolean_t
+nwam_loc_can_set_name(nwam_loc_handle_t loch)
+{
+    return obj_can_set_name(loch);
+}
+
+nwam_error_t
+nwam_loc_get_prop_type(const char *prop, nwam_value_type_t *typep)
+{
+    return prop_get_type(NWAM_OBJECT_TYPE_LOC, prop, typep);
+}
+
+nwam_error_t
+nwam_loc_prop_read_only(const char *prop, boolean_t *readp)
+{
+    return prop_read_only(NWAM_OBJECT_TYPE_LOC, prop, readp);
+}
+
+nwam_error_t
+nwam_loc_walk_props(nwam_loc_handle_t h, int (*cb)(const char *, nwam_value_t, void *),
+  void *data, uint64_t flags, int *retp)
+{
+    return obj_walk_props(h, cb, data, retp);
+}
+
+nwam_error_t
+nwam_loc_get_prop_value(nwam_loc_handle_t loch, const char *prop, nwam_value_t *valuep)
+{
+    return obj_get_prop_value(loch, prop, valuep);
+}
+
+nwam_error_t
+nwam_loc_set_prop_value(nwam_loc_handle_t loch, const char *prop, nwam_value_t value)
+{
+    return obj_set_prop_value(loch, prop, value);
+}
+
+nwam_error_t
+nwam_loc_delete_prop(nwam_loc_handle_t loch, const char *prop)
+{
+    return obj_delete_prop(loch, prop);
+}
+
+nwam_error_t
+nwam_loc_validate(nwam_loc_handle_t loch, const char **errpropp)
+{
+    return obj_validate(loch, NWAM_LOC_PROP_ACTIVATION_MODE, NWAM_LOC_PROP_CONDITIONS, errpropp);
+}
+
+nwam_error_t
+nwam_loc_commit(nwam_loc_handle_t loch, uint64_t flags)
+{
+    return obj_commit(loch);
+}
+
+nwam_error_t
+nwam_loc_destroy(nwam_loc_handle_t loch, uint64_t flags)
+{
+    return obj_destroy(loch);
+}
+
+nwam_error_t
+nwam_loc_enable(nwam_loc_handle_t loch)
+{
+    return obj_set_enabled(loch, NWAM_LOC_PROP_ENABLED, TRUE);
+}
+
+nwam_error_t
+nwam_loc_disable(nwam_loc_handle_t loch)
+{
+    return obj_set_enabled(loch, NWAM_LOC_PROP_ENABLED, FALSE);
+}
+
+nwam_error_t
+nwam_loc_get_state(nwam_loc_handle_t loch, nwam_state_t *statep, nwam_aux_state_t *auxp)
+{
+    return obj_get_state(loch, statep, auxp);
+}
+
+void
+nwam_loc_free(nwam_loc_handle_t loch)
+{
+    handle_free(loch);
+}
+
+/* ENMs */
+
+nwam_error_t
+nwam_walk_enms(int (*cb)(nwam_enm_handle_t, void *), void *data, uint64_t flags, int *retp)
+{
+    return obj_walk(NWAM_OBJECT_TYPE_ENM, NULL, (fake_walk_cb_t)cb, data, retp);
+}
+
+nwam_error_t
+nwam_enm_create(const char *name, const char *fmri, nwam_enm_handle_t *enmhp)
+{
+    nwam_error_t    nerr;
+
+    if ((nerr = obj_create(NWAM_OBJECT_TYPE_ENM, NULL, name, enmhp)) == NWAM_SUCCESS) {
+        props_set_uint64((*enmhp)->props, NWAM_ENM_PROP_ACTIVATION_MODE, NWAM_ACTIVATION_MODE_MANUAL);
+        props_set_boolean((*enmhp)->props, NWAM_ENM_PROP_ENABLED, B_FALSE);
+        if (fmri != NULL) {
+            props_set_string((*enmhp)->props, NWAM_ENM_PROP_FMRI, fmri);
+        }
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_enm_read(const char *name, uint64_t flags, nwam_enm_handle_t *enmhp)
+{
+    return obj_read(NWAM_OBJECT_TYPE_ENM, NULL, name, enmhp);
+}
+
+nwam_error_t
+nwam_enm_copy(nwam_enm_handle_t enmh, const char *name, nwam_enm_handle_t *enmhp)
+{
+    return obj_copy(enmh, name, enmhp);
+}
+
+nwam_error_t
+nwam_enm_get_name(nwam_enm_handle_t enmh, char **namep)
+{
+    return obj_get_name(enmh, namep);
+}
+
+nwam_error_t
+nwam_enm_set_name(nwam_enm_handle_t enmh, const char *name)
+{
+    return obj_set_name(enmh, name);
+}
+
+boolean_t
+nwam_enm_can_set_name(nwam_enm_handle_t enmh)
+{
+    return obj_can_set_name(enmh);
+}
+
+nwam_error_t
+nwam_enm_get_prop_type(const char *prop, nwam_value_type_t *typep)
+{
+    return prop_get_type(NWAM_OBJECT_TYPE_ENM, prop, typep);
+}
+
+nwam_error_t
+nwam_enm_prop_read_only(const char *prop, boolean_t *readp)
+{
+    return prop_read_only(NWAM_OBJECT_TYPE_ENM, prop, readp);
+}
+
+nwam_error_t
+nwam_enm_walk_props(nwam_enm_handle_t h, int (*cb)(const char *, nwam_value_t, void *),
+  void *data, uint64_t flags, int *retp)
+{
+    return obj_walk_props(h, cb, data, retp);
+}
+
+nwam_error_t
+nwam_enm_get_prop_value(nwam_enm_handle_t enmh, const char *prop, nwam_value_t *valuep)
+{
+    return obj_get_prop_value(enmh, prop, valuep);
+}
+
+nwam_error_t
+nwam_enm_set_prop_value(nwam_enm_handle_t enmh, const char *prop, nwam_value_t value)
+{
+    return obj_set_prop_value(enmh, prop, value);
+}
+
+nwam_error_t
+nwam_enm_delete_prop(nwam_enm_handle_t enmh, const char *prop)
+{
+    return obj_delete_prop(enmh, prop);
+}
+
+nwam_error_t
+nwam_enm_validate_prop(nwam_enm_handle_t enmh, const char *prop, nwam_value_t value)
+{
+    return obj_validate_prop(enmh, prop, value);
+}
+
+nwam_error_t
+nwam_enm_validate(nwam_enm_handle_t enmh, const char **errpropp)
+{
+    return obj_validate(enmh, NWAM_ENM_PROP_ACTIVATION_MODE, NWAM_ENM_PROP_CONDITIONS, errpropp);
+}
+
+nwam_error_t
+nwam_enm_commit(nwam_enm_handle_t enmh, uint64_t flags)
+{
+    return obj_commit(enmh);
+}
+
+nwam_error_t
+nwam_enm_destroy(nwam_enm_handle_t enmh, uint64_t flags)
+{
+    return obj_destroy(enmh);
+}
+
+nwam_error_t
+nwam_enm_enable(nwam_enm_handle_t enmh)
+{
+    return obj_set_enabled(enmh, NWAM_ENM_PROP_ENABLED, TRUE);
+}
+
+nwam_error_t
+nwam_enm_disable(nwam_enm_handle_t enmh)
+{
+    return obj_set_enabled(enmh, NWAM_ENM_PROP_ENABLED, FALSE);
+}
+
+nwam_error_t
+nwam_enm_get_state(nwam_enm_handle_t enmh, nwam_state_t *statep, nwam_aux_state_t *auxp)
+{
+    return obj_get_state(enmh, statep, auxp);
+}
+
+void
+nwam_enm_free(nwam_enm_handle_t enmh)
+{
+    handle_free(enmh);
+}
+
+/* Known WLANs */
+
+static uint64_t
+known_wlan_priority(struct nwam_handle *h)
+{
+    nwam_value_t    value = (nwam_value_t)g_hash_table_lookup(h->props, NWAM_KNOWN_WLAN_PROP_PRIORITY);
+    uint64_t        priority = G_MAXUINT64;
+
+    if (value != NULL) {
+        (void) nwam_value_get_uint64(value, &priority);
+    }
+    return priority;
+}
+
+static gint
+known_wlan_compare(gconstpointer a, gconstpointer b)
+{
+    uint64_t    pa = known_wlan_priority(*(struct nwam_handle **)a);
+    uint64_t    pb = known_wlan_priority(*(struct nwam_handle **)b);
+
+    return pa < pb ? -1 : pa > pb ? 1 : 0;
+}
+
+typedef struct {
+    GPtrArray  *handles;
+    int       (*cb)(nwam_known_wlan_handle_t, void *);
+    void       *data;
+} known_wlan_walk_t;
+
+static int
+known_wlan_collect(struct nwam_handle *h, void *data)
+{
+    known_wlan_walk_t *walk = (known_wlan_walk_t *)data;
+
+    g_ptr_array_add(walk->handles,
+      handle_new(h->type, h->parent, h->name, h->ncu_class, props_dup(h->props)));
+    return 0;
+}
+
+nwam_error_t
+nwam_walk_known_wlans(int (*cb)(nwam_known_wlan_handle_t, void *), void *data,
+  uint64_t flags, int *retp)
+{
+    known_wlan_walk_t   walk;
+    guint               i;
+    int                 ret = 0;
+    nwam_error_t        nerr = NWAM_SUCCESS;
+
+    if (!(flags & NWAM_FLAG_KNOWN_WLAN_WALK_PRIORITY_ORDER)) {
+        return obj_walk(NWAM_OBJECT_TYPE_KNOWN_WLAN, NULL, (fake_walk_cb_t)cb, data, retp);
+    }
+    if (cb == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    walk.handles = g_ptr_array_new();
+    walk.cb = cb;
+    walk.data = data;
+    (void) obj_walk(NWAM_OBJECT_TYPE_KNOWN_WLAN, NULL, known_wlan_collect, &walk, NULL);
+    g_ptr_array_sort(walk.handles, known_wlan_compare);
+
+    for (i = 0; i < walk.handles->len; i++) {
+        struct nwam_handle *h = (struct nwam_handle *)g_ptr_array_index(walk.handles, i);
+
+        if (nerr == NWAM_SUCCESS && (ret = cb(h, data)) != 0) {
+            nerr = NWAM_WALK_HALTED;
+        }
+        handle_free(h);
+    }
+    g_ptr_array_free(walk.handles, TRUE);
+
+    if (retp != NULL) {
+        *retp = ret;
+    }
+    return nerr;
+}
+
+nwam_error_t
+nwam_known_wlan_create(const char *name, nwam_known_wlan_handle_t *kwhp)
+{
+    return obj_create(NWAM_OBJECT_TYPE_KNOWN_WLAN, NULL, name, kwhp);
+}
+
+nwam_error_t
+nwam_known_wlan_read(const char *name, uint64_t flags, nwam_known_wlan_handle_t *kwhp)
+{
+    return obj_read(NWAM_OBJECT_TYPE_KNOWN_WLAN, NULL, name, kwhp);
+}
+
+nwam_error_t
+nwam_known_wlan_get_name(nwam_known_wlan_handle_t kwh, char **namep)
+{
+    return obj_get_name(kwh, namep);
+}
+
+nwam_error_t
+nwam_known_wlan_set_name(nwam_known_wlan_handle_t kwh, const char *name)
+{
+    return obj_set_name(kwh, name);
+}
+
+boolean_t
+nwam_known_wlan_can_set_name(nwam_known_wlan_handle_t kwh)
+{
+    return obj_can_set_name(kwh);
+}
+
+nwam_error_t
+nwam_known_wlan_get_prop_type(const char *prop, nwam_value_type_t *typep)
+{
+    return prop_get_type(NWAM_OBJECT_TYPE_KNOWN_WLAN, prop, typep);
+}
+
+nwam_error_t
+nwam_known_wlan_walk_props(nwam_known_wlan_handle_t h, int (*cb)(const char *, nwam_value_t, void *),
+  void *data, uint64_t flags, int *retp)
+{
+    return obj_walk_props(h, cb, data, retp);
+}
+
+nwam_error_t
+nwam_known_wlan_get_prop_value(nwam_known_wlan_handle_t kwh, const char *prop,
+  nwam_value_t *valuep)
+{
+    return obj_get_prop_value(kwh, prop, valuep);
+}
+
+nwam_error_t
+nwam_known_wlan_set_prop_value(nwam_known_wlan_handle_t kwh, const char *prop,
+  nwam_value_t value)
+{
+    return obj_set_prop_value(kwh, prop, value);
+}
+
+nwam_error_t
+nwam_known_wlan_delete_prop(nwam_known_wlan_handle_t kwh, const char *prop)
+{
+    return obj_delete_prop(kwh, prop);
+}
+
+nwam_error_t
+nwam_known_wlan_validate(nwam_known_wlan_handle_t kwh, const char **errpropp)
+{
+    return obj_validate(kwh, NULL, NULL, errpropp);
+}
+
+nwam_error_t
+nwam_known_wlan_commit(nwam_known_wlan_handle_t kwh, uint64_t flags)
+{
+    return obj_commit(kwh);
+}
+
+nwam_error_t
+nwam_known_wlan_destroy(nwam_known_wlan_handle_t kwh, uint64_t flags)
+{
+    return obj_destroy(kwh);
+}
+
+void
+nwam_known_wlan_free(nwam_known_wlan_handle_t kwh)
+{
+    handle_free(kwh);
+}
+
+/* Conditions, "<object> <condition> <value>" or "<object> <name> <condition> active" */
+
+static const gchar *condition_objects[] = {
+    "ncp", "ncu", "enm", "loc", "ip-address", "advertised-domain",
+    "system-domain", "essid", "bssid", NULL
+};
+
+static const nwam_condition_object_type_t condition_object_types[] = {
+    NWAM_CONDITION_OBJECT_TYPE_NCP,
+    NWAM_CONDITION_OBJECT_TYPE_NCU,
+    NWAM_CONDITION_OBJECT_TYPE_ENM,
+    NWAM_CONDITION_OBJECT_TYPE_LOC,
+    NWAM_CONDITION_OBJECT_TYPE_IP_ADDRESS,
+    NWAM_CONDITION_OBJECT_TYPE_ADV_DOMAIN,
+    NWAM_CONDITION_OBJECT_TYPE_SYS_DOMAIN,
+    NWAM_CONDITION_OBJECT_TYPE_ESSID,
+    NWAM_CONDITION_OBJECT_TYPE_BSSID,
+};
+
+static const gchar *conditions[] = {
+    "is", "is-not", "is-in-range", "is-not-in-range", "contains",
+    "does-not-contain", NULL
+};
+
+static const nwam_condition_t condition_types[] = {
+    NWAM_CONDITION_IS,
+    NWAM_CONDITION_IS_NOT,
+    NWAM_CONDITION_IS_IN_RANGE,
+    NWAM_CONDITION_IS_NOT_IN_RANGE,
+    NWAM_CONDITION_CONTAINS,
+    NWAM_CONDITION_DOES_NOT_CONTAIN,
+};
+
+static gboolean
+condition_is_object(nwam_condition_object_type_t object_type)
+{
+    return object_type == NWAM_CONDITION_OBJECT_TYPE_NCP ||
+      object_type == NWAM_CONDITION_OBJECT_TYPE_NCU ||
+      object_type == NWAM_CONDITION_OBJECT_TYPE_ENM ||
+      object_type == NWAM_CONDITION_OBJECT_TYPE_LOC;
+}
+
+nwam_error_t
+nwam_condition_to_condition_string(nwam_condition_object_type_t object_type,
+  nwam_condition_t condition, const char *object_name, char **stringp)
+{
+    const gchar    *object_str = NULL;
+    const gchar    *condition_str = NULL;
+    gchar          *str;
+    gint            i;
+
+    for (i = 0; condition_objects[i] != NULL; i++) {
+        if (condition_object_types[i] == object_type) {
+            object_str = condition_objects[i];
+        }
+    }
+    for (i = 0; conditions[i] != NULL; i++) {
+        if (condition_types[i] == condition) {
+            condition_str = conditions[i];
+        }
+    }
+    if (object_str == NULL || condition_str == NULL || object_name == NULL || stringp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    if (condition_is_object(object_type)) {
+        str = g_strdup_printf("%s %s %s active", object_str, object_name, condition_str);
+    } else {
+        str = g_strdup_printf("%s %s %s", object_str, condition_str, object_name);
+    }
+    *stringp = strdup(str);
+    g_free(str);
+
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_condition_string_to_condition(const char *string,
+  nwam_condition_object_type_t *object_typep, nwam_condition_t *conditionp,
+  char **object_namep)
+{
+    gchar         **tokens;
+    const gchar    *name;
+    const gchar    *condition;
+    gint            i;
+    gint            object = -1;
+    gint            cond = -1;
+    nwam_error_t    nerr = NWAM_INVALID_ARG;
+
+    if (string == NULL || object_typep == NULL || conditionp == NULL || object_namep == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    tokens = g_strsplit_set(string, " \t", 0);
+    if (g_strv_length(tokens) >= 3) {
+        for (i = 0; condition_objects[i] != NULL; i++) {
+            if (strcmp(tokens[0], condition_objects[i]) == 0) {
+                object = i;
+            }
+        }
+        if (object >= 0 && condition_is_object(condition_object_types[object])) {
+            name = tokens[1];
+            condition = tokens[2];
+        } else {
+            condition = tokens[1];
+            name = tokens[2];
+        }
+        for (i = 0; conditions[i] != NULL; i++) {
+            if (strcmp(condition, conditions[i]) == 0) {
+                cond = i;
+            }
+        }
+        if (object >= 0 && cond >= 0) {
+            *object_typep = condition_object_types[object];
+            *conditionp = condition_types[cond];
+            *object_namep = strdup(name);
+            nerr = NWAM_SUCCESS;
+        }
+    }
+    g_strfreev(tokens);
+
+    return nerr;
+}
+
+/*
+ * Specific objects rate higher than broad ones, and matches higher than
+ * exclusions, the same order as nwamd.
+ */
+nwam_error_t
+nwam_condition_rate(nwam_condition_object_type_t object_type, nwam_condition_t condition,
+  uint64_t *ratingp)
+{
+    uint64_t    object_rating;
+    uint64_t    condition_rating;
+
+    if (ratingp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    switch (object_type) {
+    case NWAM_CONDITION_OBJECT_TYPE_BSSID:          object_rating = 9; break;
+    case NWAM_CONDITION_OBJECT_TYPE_ESSID:          object_rating = 8; break;
+    case NWAM_CONDITION_OBJECT_TYPE_IP_ADDRESS:     object_rating = 7; break;
+    case NWAM_CONDITION_OBJECT_TYPE_SYS_DOMAIN:     object_rating = 6; break;
+    case NWAM_CONDITION_OBJECT_TYPE_ADV_DOMAIN:     object_rating = 5; break;
+    case NWAM_CONDITION_OBJECT_TYPE_NCU:            object_rating = 4; break;
+    case NWAM_CONDITION_OBJECT_TYPE_ENM:            object_rating = 3; break;
+    case NWAM_CONDITION_OBJECT_TYPE_LOC:            object_rating = 2; break;
+    case NWAM_CONDITION_OBJECT_TYPE_NCP:            object_rating = 1; break;
+    default:                                        return NWAM_INVALID_ARG;
+    }
+
+    switch (condition) {
+    case NWAM_CONDITION_IS:                 condition_rating = 4; break;
+    case NWAM_CONDITION_CONTAINS:           condition_rating = 3; break;
+    case NWAM_CONDITION_IS_IN_RANGE:        condition_rating = 2; break;
+    case NWAM_CONDITION_IS_NOT:
+    case NWAM_CONDITION_IS_NOT_IN_RANGE:
+    case NWAM_CONDITION_DOES_NOT_CONTAIN:   condition_rating = 1; break;
+    default:                                return NWAM_INVALID_ARG;
+    }
+
+    *ratingp = object_rating * 10 + condition_rating;
+    return NWAM_SUCCESS;
+}
+
+/* Events */
+
+static nwam_event_t
+event_new(int type, guint num_wlans)
+{
+    size_t          size = sizeof (struct nwam_event);
+    nwam_event_t    event;
+
+    if (num_wlans > 1) {
+        size += (num_wlans - 1) * sizeof (nwam_wlan_t);
+    }
+    event = (nwam_event_t)g_malloc0(size);
+    event->nwe_type = type;
+    event->nwe_size = size;
+    return event;
+}
+
+static void
+event_init_locked(void)
+{
+    if (event_cond == NULL) {
+        event_cond = g_cond_new();
+        event_queue = g_queue_new();
+    }
+}
+
+static void
+queue_event(nwam_event_t event, gboolean head)
+{
+    g_static_mutex_lock(&event_mutex);
+    event_init_locked();
+    if (head) {
+        g_queue_push_head(event_queue, event);
+    } else {
+        g_queue_push_tail(event_queue, event);
+    }
+    g_cond_broadcast(event_cond);
+    g_static_mutex_unlock(&event_mutex);
+}
+
+void
+nwam_fake_queue_event(nwam_event_t event)
+{
+    queue_event(event, FALSE);
+}
+
+guint
+nwam_fake_get_queued_events(void)
+{
+    guint   len;
+
+    g_static_mutex_lock(&event_mutex);
+    event_init_locked();
+    len = g_queue_get_length(event_queue);
+    g_static_mutex_unlock(&event_mutex);
+
+    return len;
+}
+
+void
+nwam_fake_queue_object_action(nwam_object_type_t type, const gchar *parent,
+  const gchar *name, nwam_action_t action)
+{
+    nwam_event_t    event = event_new(NWAM_EVENT_TYPE_OBJECT_ACTION, 0);
+
+    event->nwe_data.nwe_object_action.nwe_object_type = type;
+    event->nwe_data.nwe_object_action.nwe_action = action;
+    (void) g_strlcpy(event->nwe_data.nwe_object_action.nwe_name, name,
+      sizeof (event->nwe_data.nwe_object_action.nwe_name));
+    if (parent != NULL) {
+        (void) g_strlcpy(event->nwe_data.nwe_object_action.nwe_parent, parent,
+          sizeof (event->nwe_data.nwe_object_action.nwe_parent));
+    }
+    queue_event(event, FALSE);
+}
+
+void
+nwam_fake_queue_object_state(nwam_object_type_t type, const gchar *parent,
+  const gchar *name, nwam_state_t state, nwam_aux_state_t aux_state)
+{
+    nwam_event_t    event = event_new(NWAM_EVENT_TYPE_OBJECT_STATE, 0);
+
+    event->nwe_data.nwe_object_state.nwe_object_type = type;
+    event->nwe_data.nwe_object_state.nwe_state = state;
+    event->nwe_data.nwe_object_state.nwe_aux_state = aux_state;
+    (void) g_strlcpy(event->nwe_data.nwe_object_state.nwe_name, name,
+      sizeof (event->nwe_data.nwe_object_state.nwe_name));
+    if (parent != NULL) {
+        (void) g_strlcpy(event->nwe_data.nwe_object_state.nwe_parent, parent,
+          sizeof (event->nwe_data.nwe_object_state.nwe_parent));
+    }
+    queue_event(event, FALSE);
+}
+
+void
+nwam_fake_queue_need_key(const gchar *device, const gchar *essid)
+{
+    nwam_wlan_t    *wlans = NULL;
+    guint           num = nwam_fake_get_scan_results(device, &wlans);
+    nwam_event_t    event = event_new(NWAM_EVENT_TYPE_WLAN_NEED_KEY, 1);
+    guint           i;
+
+    (void) g_strlcpy(event->nwe_data.nwe_wlan_info.nwe_name, device,
+      sizeof (event->nwe_data.nwe_wlan_info.nwe_name));
+    event->nwe_data.nwe_wlan_info.nwe_num_wlans = 1;
+    (void) g_strlcpy(event->nwe_data.nwe_wlan_info.nwe_wlans[0].nww_essid, essid,
+      sizeof (event->nwe_data.nwe_wlan_info.nwe_wlans[0].nww_essid));
+    for (i = 0; i < num; i++) {
+        if (strcmp(wlans[i].nww_essid, essid) == 0) {
+            event->nwe_data.nwe_wlan_info.nwe_wlans[0] = wlans[i];
+            break;
+        }
+    }
+    event->nwe_data.nwe_wlan_info.nwe_wlans[0].nww_selected = B_TRUE;
+    free(wlans);
+    queue_event(event, FALSE);
+}
+
+void
+nwam_fake_queue_link_state(const gchar *device, gboolean up)
+{
+    nwam_event_t    event = event_new(NWAM_EVENT_TYPE_LINK_STATE, 0);
+
+    (void) g_strlcpy(event->nwe_data.nwe_link_state.nwe_name, device,
+      sizeof (event->nwe_data.nwe_link_state.nwe_name));
+    event->nwe_data.nwe_link_state.nwe_link_up = up ? B_TRUE : B_FALSE;
+    queue_event(event, FALSE);
+}
+
+static void
+prefix_to_mask(int family, guint prefix_len, struct sockaddr_storage *mask)
+{
+    guint8 *bytes;
+    guint   len;
+    guint   i;
+
+    memset(mask, 0, sizeof (*mask));
+    mask->ss_family = family;
+    if (family == AF_INET) {
+        bytes = (guint8 *)&((struct sockaddr_in *)mask)->sin_addr;
+        len = 4;
+    } else {
+        bytes = (guint8 *)&((struct sockaddr_in6 *)mask)->sin6_addr;
+        len = 16;
+    }
+    for (i = 0; i < len && prefix_len > 0; i++) {
+        guint bits = MIN(prefix_len, 8);
+
+        bytes[i] = (guint8)(0xff << (8 - bits));
+        prefix_len -= bits;
+    }
+}
+
+gboolean
+nwam_fake_queue_if_state(const gchar *device, const gchar *address, guint prefix_len)
+{
+    nwam_event_t                event = event_new(NWAM_EVENT_TYPE_IF_STATE, 0);
+    struct sockaddr_storage    *addr = &event->nwe_data.nwe_if_state.nwe_addr;
+
+    (void) g_strlcpy(event->nwe_data.nwe_if_state.nwe_name, device,
+      sizeof (event->nwe_data.nwe_if_state.nwe_name));
+    event->nwe_data.nwe_if_state.nwe_flags = IFF_UP | IFF_RUNNING;
+
+    if (inet_pton(AF_INET, address, &((struct sockaddr_in *)addr)->sin_addr) == 1) {
+        addr->ss_family = AF_INET;
+        prefix_to_mask(AF_INET, MIN(prefix_len, 32), &event->nwe_data.nwe_if_state.nwe_netmask);
+    } else if (inet_pton(AF_INET6, address, &((struct sockaddr_in6 *)addr)->sin6_addr) == 1) {
+        addr->ss_family = AF_INET6;
+        prefix_to_mask(AF_INET6, MIN(prefix_len, 128), &event->nwe_data.nwe_if_state.nwe_netmask);
+    } else {
+        g_free(event);
+        return FALSE;
+    }
+    event->nwe_data.nwe_if_state.nwe_addr_valid = B_TRUE;
+    event->nwe_data.nwe_if_state.nwe_addr_added = B_TRUE;
+    queue_event(event, FALSE);
+
+    return TRUE;
+}
+
+void
+nwam_fake_queue_scan_report(const gchar *device)
+{
+    nwam_wlan_t    *wlans = NULL;
+    guint           num = nwam_fake_get_scan_results(device, &wlans);
+    nwam_event_t    event;
+
+    num = MIN(num, G_MAXUINT16);
+    event = event_new(NWAM_EVENT_TYPE_WLAN_SCAN_REPORT, num);
+    (void) g_strlcpy(event->nwe_data.nwe_wlan_info.nwe_name, device,
+      sizeof (event->nwe_data.nwe_wlan_info.nwe_name));
+    event->nwe_data.nwe_wlan_info.nwe_num_wlans = num;
+    if (num > 0) {
+        memcpy(event->nwe_data.nwe_wlan_info.nwe_wlans, wlans, num * sizeof (nwam_wlan_t));
+    }
+    free(wlans);
+    queue_event(event, FALSE);
+}
+
+void
+nwam_fake_queue_priority_group(int64_t priority_group)
+{
+    nwam_event_t    event = event_new(NWAM_EVENT_TYPE_PRIORITY_GROUP, 0);
+
+    nwam_fake_set_priority_group(priority_group);
+    event->nwe_data.nwe_priority_group_info.nwe_priority = priority_group;
+    queue_event(event, FALSE);
+}
+
+nwam_error_t
+nwam_events_init(void)
+{
+    if (!nwam_fake_get_online()) {
+        return NWAM_ERROR_BIND;
+    }
+
+    g_static_mutex_lock(&event_mutex);
+    event_init_locked();
+    events_bound = TRUE;
+    g_static_mutex_unlock(&event_mutex);
+
+    /* nwamd greets every new listener. */
+    queue_event(event_new(NWAM_EVENT_TYPE_INIT, 0), TRUE);
+
+    return NWAM_SUCCESS;
+}
+
+void
+nwam_events_fini(void)
+{
+    g_static_mutex_lock(&event_mutex);
+    event_init_locked();
+    events_bound = FALSE;
+    g_cond_broadcast(event_cond);
+    g_static_mutex_unlock(&event_mutex);
+}
+
+nwam_error_t
+nwam_event_wait(nwam_event_t *eventp)
+{
+    nwam_error_t    nerr = NWAM_SUCCESS;
+
+    if (eventp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+
+    g_static_mutex_lock(&event_mutex);
+    event_init_locked();
+    while (events_bound && g_queue_is_empty(event_queue)) {
+        g_cond_wait(event_cond, g_static_mutex_get_mutex(&event_mutex));
+    }
+    if (events_bound) {
+        *eventp = (nwam_event_t)g_queue_pop_head(event_queue);
+    } else {
+        nerr = NWAM_ERROR_BIND;
+    }
+    g_static_mutex_unlock(&event_mutex);
+
+    return nerr;
+}
+
+void
+nwam_event_free(nwam_event_t event)
+{
+    g_free(event);
+}
+
+/* WLANs */
+
+nwam_error_t
+nwam_wlan_scan(const char *linkname)
+{
+    if (linkname == NULL || !nwam_fake_link_exists(linkname)) {
+        return NWAM_ENTITY_NOT_FOUND;
+    }
+    nwam_fake_queue_scan_report(linkname);
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_wlan_get_scan_results(const char *linkname, uint_t *nump, nwam_wlan_t **wlansp)
+{
+    if (linkname == NULL || nump == NULL || wlansp == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (!nwam_fake_link_exists(linkname)) {
+        return NWAM_ENTITY_NOT_FOUND;
+    }
+    *nump = nwam_fake_get_scan_results(linkname, wlansp);
+    return NWAM_SUCCESS;
+}
+
+/*
+ * Connects at once, the link comes up and a connection report is queued.
+ * Selecting a network which wasn't scanned fails like it does with nwamd,
+ * and one which needs a key nwamd doesn't have asks for it.
+ */
+nwam_error_t
+nwam_wlan_select(const char *linkname, const char *essid, const char *bssid,
+  uint32_t secmode, boolean_t add_to_known_wlans)
+{
+    nwam_wlan_t    *wlans = NULL;
+    nwam_wlan_t    *found = NULL;
+    nwam_event_t    event;
+    guint           num;
+    guint           i;
+    gchar          *link_name;
+    gchar          *ncp;
+
+    if (linkname == NULL || essid == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (!nwam_fake_link_exists(linkname)) {
+        return NWAM_ENTITY_NOT_FOUND;
+    }
+
+    num = nwam_fake_get_scan_results(linkname, &wlans);
+    for (i = 0; i < num && found == NULL; i++) {
+        if (strcmp(wlans[i].nww_essid, essid) == 0 &&
+          (bssid == NULL || strcmp(wlans[i].nww_bssid, bssid) == 0)) {
+            found = &wlans[i];
+        }
+    }
+    if (found == NULL) {
+        free(wlans);
+        return NWAM_ENTITY_INVALID_STATE;
+    }
+
+    if (found->nww_security_mode != DLADM_WLAN_SECMODE_NONE) {
+        gboolean    has_key;
+
+        g_static_mutex_lock(&store_mutex);
+        has_key = (store_wlan_keys != NULL && g_hash_table_lookup(store_wlan_keys, essid) != NULL) ||
+          store_lookup_locked(NWAM_OBJECT_TYPE_KNOWN_WLAN, NULL, essid) != NULL;
+        g_static_mutex_unlock(&store_mutex);
+
+        if (!has_key) {
+            free(wlans);
+            nwam_fake_queue_need_key(linkname, essid);
+            return NWAM_SUCCESS;
+        }
+    }
+
+    if (add_to_known_wlans) {
+        nwam_fake_add_known_wlan(essid, 0, secmode);
+    }
+    (void) nwam_fake_connect_link(linkname, essid);
+
+    event = event_new(NWAM_EVENT_TYPE_WLAN_CONNECTION_REPORT, 1);
+    (void) g_strlcpy(event->nwe_data.nwe_wlan_info.nwe_name, linkname,
+      sizeof (event->nwe_data.nwe_wlan_info.nwe_name));
+    event->nwe_data.nwe_wlan_info.nwe_connected = B_TRUE;
+    event->nwe_data.nwe_wlan_info.nwe_num_wlans = 1;
+    event->nwe_data.nwe_wlan_info.nwe_wlans[0] = *found;
+    event->nwe_data.nwe_wlan_info.nwe_wlans[0].nww_selected = B_TRUE;
+    event->nwe_data.nwe_wlan_info.nwe_wlans[0].nww_connected = B_TRUE;
+    free(wlans);
+    queue_event(event, FALSE);
+
+    if ((ncp = nwam_fake_get_active_ncp()) != NULL) {
+        link_name = typed_name(linkname, NWAM_NCU_TYPE_LINK);
+        g_static_mutex_lock(&store_mutex);
+        {
+            fake_obj_t *obj = store_lookup_locked(NWAM_OBJECT_TYPE_NCU, ncp, link_name);
+
+            if (obj != NULL) {
+                set_state_locked(obj, NWAM_STATE_ONLINE, NWAM_AUX_STATE_UP);
+            }
+        }
+        g_static_mutex_unlock(&store_mutex);
+        g_free(link_name);
+        g_free(ncp);
+    }
+
+    return NWAM_SUCCESS;
+}
+
+nwam_error_t
+nwam_wlan_set_key(const char *linkname, const char *essid, const char *bssid,
+  uint32_t secmode, uint_t keyslot, const char *key)
+{
+    if (linkname == NULL || essid == NULL || key == NULL) {
+        return NWAM_INVALID_ARG;
+    }
+    if (!nwam_fake_link_exists(linkname)) {
+        return NWAM_ENTITY_NOT_FOUND;
+    }
+
+    /* Like nwamd, the next select of the network uses it. */
+    g_static_mutex_lock(&store_mutex);
+    if (store_wlan_keys == NULL) {
+        store_wlan_keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+    g_hash_table_replace(store_wlan_keys, g_strdup(essid), GINT_TO_POINTER(TRUE));
+    g_static_mutex_unlock(&store_mutex);
+
+    return NWAM_SUCCESS;
+}
@@ -0,0 +1,1050 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   fake_sys.c
+ *
+ * The datalinks of the fake backend behind the dladm and kstat calls, the
+ * SMF repository behind the libscf calls, and the RBAC check used by
+ * libnwamui.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/types.h>
+#include <sys/dlpi.h>
+#include <kstat.h>
+#include <libdllink.h>
+#include <libdlwlan.h>
+#include <libscf.h>
+#include <secdb.h>
+
+#include <glib.h>
+#include <libnwam.h>
+
+#include "nwam-scf.h"
+#include "fake_backend.h"
+
+typedef struct {
+    gchar          *device;
+    gboolean        wireless;
+    uint64_t        speed;
+    gchar          *essid;              /* Connected WLAN */
+    uint32_t        strength;           /* A dladm_wlan_strength_t */
+    GArray         *scan;               /* nwam_wlan_t */
+} fake_link_t;
+
+static GStaticMutex link_mutex = G_STATIC_MUTEX_INIT;
+static GPtrArray   *links = NULL;       /* Indexed by linkid - 1 */
+
+/* Datalinks */
+
+static fake_link_t *
+find_link_locked(const gchar *device, datalink_id_t *linkidp)
+{
+    guint   i;
+
+    if (links == NULL || device == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < links->len; i++) {
+        fake_link_t *link = (fake_link_t *)g_ptr_array_index(links, i);
+
+        if (strcmp(link->device, device) == 0) {
+            if (linkidp != NULL) {
+                *linkidp = (datalink_id_t)(i + 1);
+            }
+            return link;
+        }
+    }
+    return NULL;
+}
+
+static void
+link_free(fake_link_t *link)
+{
+    g_free(link->device);
+    g_free(link->essid);
+    g_array_free(link->scan, TRUE);
+    g_free(link);
+}
+
+void
+nwam_fake_links_reset(void)
+{
+    g_static_mutex_lock(&link_mutex);
+    if (links != NULL) {
+        g_ptr_array_foreach(links, (GFunc)link_free, NULL);
+        g_ptr_array_free(links, TRUE);
+        links = NULL;
+    }
+    g_static_mutex_unlock(&link_mutex);
+}
+
+void
+nwam_fake_add_link(const gchar *device, gboolean wireless, uint64_t speed)
+{
+    fake_link_t *link;
+
+    g_static_mutex_lock(&link_mutex);
+    if ((link = find_link_locked(device, NULL)) == NULL) {
+        if (links == NULL) {
+            links = g_ptr_array_new();
+        }
+        link = g_new0(fake_link_t, 1);
+        link->device = g_strdup(device);
+        link->scan = g_array_new(FALSE, TRUE, sizeof (nwam_wlan_t));
+        g_ptr_array_add(links, link);
+    }
+    link->wireless = wireless;
+    link->speed = speed;
+    g_static_mutex_unlock(&link_mutex);
+}
+
+gboolean
+nwam_fake_link_exists(const gchar *device)
+{
+    gboolean    rval;
+
+    g_static_mutex_lock(&link_mutex);
+    rval = (find_link_locked(device, NULL) != NULL);
+    g_static_mutex_unlock(&link_mutex);
+
+    return rval;
+}
+
+void
+nwam_fake_set_link_wlan(const gchar *device, const gchar *essid, uint32_t strength)
+{
+    fake_link_t *link;
+
+    g_static_mutex_lock(&link_mutex);
+    if ((link = find_link_locked(device, NULL)) != NULL) {
+        g_free(link->essid);
+        link->essid = g_strdup(essid);
+        link->strength = strength;
+    }
+    g_static_mutex_unlock(&link_mutex);
+}
+
+/* The names used by dladm, and by nwamui_wifi_net_strength_map(). */
+static const gchar *
+strength_to_string(uint32_t strength)
+{
+    switch (strength) {
+    case DLADM_WLAN_STRENGTH_VERY_WEAK:     return "very weak";
+    case DLADM_WLAN_STRENGTH_WEAK:          return "weak";
+    case DLADM_WLAN_STRENGTH_GOOD:          return "good";
+    case DLADM_WLAN_STRENGTH_VERY_GOOD:     return "very good";
+    case DLADM_WLAN_STRENGTH_EXCELLENT:     return "excellent";
+    default:                                return "";
+    }
+}
+
+static uint32_t
+strength_from_string(const gchar *strength)
+{
+    uint32_t    i;
+
+    for (i = DLADM_WLAN_STRENGTH_VERY_WEAK; i <= DLADM_WLAN_STRENGTH_EXCELLENT; i++) {
+        if (g_ascii_strcasecmp(strength, strength_to_string(i)) == 0) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+void
+nwam_fake_add_scan_result(const gchar *device, const gchar *essid, const gchar *bssid,
+  uint32_t security_mode, uint32_t strength, uint32_t channel)
+{
+    fake_link_t    *link;
+    nwam_wlan_t     wlan;
+
+    memset(&wlan, 0, sizeof (wlan));
+    (void) g_strlcpy(wlan.nww_essid, essid, sizeof (wlan.nww_essid));
+    (void) g_strlcpy(wlan.nww_bssid, bssid, sizeof (wlan.nww_bssid));
+    (void) g_strlcpy(wlan.nww_signal_strength, strength_to_string(strength),
+      sizeof (wlan.nww_signal_strength));
+    wlan.nww_security_mode = security_mode;
+    wlan.nww_channel = channel;
+    wlan.nww_speed = 108;            /* 54 Mb/s, in 500 kb/s */
+    wlan.nww_bsstype = DLADM_WLAN_BSSTYPE_BSS;
+
+    g_static_mutex_lock(&link_mutex);
+    if ((link = find_link_locked(device, NULL)) != NULL) {
+        g_array_append_val(link->scan, wlan);
+    }
+    g_static_mutex_unlock(&link_mutex);
+}
+
+void
+nwam_fake_clear_scan_results(const gchar *device)
+{
+    fake_link_t *link;
+
+    g_static_mutex_lock(&link_mutex);
+    if ((link = find_link_locked(device, NULL)) != NULL) {
+        g_array_set_size(link->scan, 0);
+    }
+    g_static_mutex_unlock(&link_mutex);
+}
+
+/* Returns a malloc()ed copy, like nwam_wlan_get_scan_results(). */
+guint
+nwam_fake_get_scan_results(const gchar *device, nwam_wlan_t **wlans)
+{
+    fake_link_t    *link;
+    guint           num = 0;
+    guint           i;
+
+    *wlans = NULL;
+
+    g_static_mutex_lock(&link_mutex);
+    if ((link = find_link_locked(device, NULL)) != NULL && link->scan->len > 0) {
+        num = link->scan->len;
+        *wlans = calloc(num, sizeof (nwam_wlan_t));
+        memcpy(*wlans, link->scan->data, num * sizeof (nwam_wlan_t));
+        for (i = 0; i < num; i++) {
+            (*wlans)[i].nww_connected = (link->essid != NULL &&
+              strcmp(link->essid, (*wlans)[i].nww_essid) == 0);
+        }
+    }
+    g_static_mutex_unlock(&link_mutex);
+
+    return num;
+}
+
+gboolean
+nwam_fake_connect_link(const gchar *device, const gchar *essid)
+{
+    fake_link_t    *link;
+    nwam_wlan_t    *wlan;
+    guint           i;
+    gboolean        rval = FALSE;
+
+    g_static_mutex_lock(&link_mutex);
+    if ((link = find_link_locked(device, NULL)) != NULL) {
+        for (i = 0; i < link->scan->len && !rval; i++) {
+            wlan = &g_array_index(link->scan, nwam_wlan_t, i);
+            if (strcmp(wlan->nww_essid, essid) == 0) {
+                g_free(link->essid);
+                link->essid = g_strdup(essid);
+                link->strength = strength_from_string(wlan->nww_signal_strength);
+                rval = TRUE;
+            }
+        }
+    }
+    g_static_mutex_unlock(&link_mutex);
+
+    return rval;
+}
+
+struct dladm_handle {
+    gint    unused;
+};
+
+dladm_status_t
+dladm_open(dladm_handle_t *handlep)
+{
+    *handlep = g_new0(struct dladm_handle, 1);
+    return DLADM_STATUS_OK;
+}
+
+void
+dladm_close(dladm_handle_t handle)
+{
+    g_free(handle);
+}
+
+dladm_status_t
+dladm_name2info(dladm_handle_t handle, const char *link, datalink_id_t *linkidp,
+  uint32_t *flagp, datalink_class_t *classp, uint32_t *mediap)
+{
+    fake_link_t    *fl;
+    dladm_status_t  status = DLADM_STATUS_NOTFOUND;
+
+    g_static_mutex_lock(&link_mutex);
+    if ((fl = find_link_locked(link, linkidp)) != NULL) {
+        if (flagp != NULL) {
+            *flagp = DLADM_OPT_ACTIVE | DLADM_OPT_PERSIST;
+        }
+        if (classp != NULL) {
+            *classp = DATALINK_CLASS_PHYS;
+        }
+        if (mediap != NULL) {
+            *mediap = fl->wireless ? DL_WIFI : DL_ETHER;
+        }
+        status = DLADM_STATUS_OK;
+    }
+    g_static_mutex_unlock(&link_mutex);
+
+    return status;
+}
+
+dladm_status_t
+dladm_wlan_get_linkattr(dladm_handle_t handle, datalink_id_t linkid,
+  dladm_wlan_linkattr_t *attrp)
+{
+    fake_link_t    *link;
+    dladm_status_t  status = DLADM_STATUS_NOTFOUND;
+
+    memset(attrp, 0, sizeof (*attrp));
+
+    g_static_mutex_lock(&link_mutex);
+    if (links != NULL && linkid > 0 && linkid <= links->len) {
+        link = (fake_link_t *)g_ptr_array_index(links, linkid - 1);
+        if (!link->wireless) {
+            status = DLADM_STATUS_LINKINVAL;
+        } else {
+            attrp->la_status = DLADM_WLAN_LINK_DISCONNECTED;
+            if (link->essid != NULL) {
+                attrp->la_status = DLADM_WLAN_LINK_CONNECTED;
+                attrp->la_valid |= DLADM_WLAN_LINKATTR_WLAN;
+                attrp->la_wlan_attr.wa_valid = DLADM_WLAN_ATTR_ESSID | DLADM_WLAN_ATTR_STRENGTH;
+                (void) g_strlcpy(attrp->la_wlan_attr.wa_essid.we_bytes, link->essid,
+                  sizeof (attrp->la_wlan_attr.wa_essid.we_bytes));
+                attrp->la_wlan_attr.wa_strength = link->strength;
+            }
+            attrp->la_valid |= DLADM_WLAN_LINKATTR_STATUS;
+            status = DLADM_STATUS_OK;
+        }
+    }
+    g_static_mutex_unlock(&link_mutex);
+
+    return status;
+}
+
+const char *
+dladm_wlan_essid2str(dladm_wlan_essid_t *essid, char *buf)
+{
+    (void) g_strlcpy(buf, essid->we_bytes, DLADM_STRSIZE);
+    return buf;
+}
+
+/*
+ * kstat, only the "ifspeed" statistic of the "link" module. The kstats
+ * looked up are chained on the control structure, and freed with it.
+ */
+
+kstat_ctl_t *
+kstat_open(void)
+{
+    return g_new0(kstat_ctl_t, 1);
+}
+
+int
+kstat_close(kstat_ctl_t *kc)
+{
+    kstat_t    *ksp;
+    kstat_t    *next;
+
+    for (ksp = kc->kc_chain; ksp != NULL; ksp = next) {
+        next = ksp->ks_next;
+        g_free(ksp->ks_data);
+        g_free(ksp);
+    }
+    g_free(kc);
+    return 0;
+}
+
+kstat_t *
+kstat_lookup(kstat_ctl_t *kc, char *module, int instance, char *name)
+{
+    fake_link_t    *link;
+    kstat_t        *ksp = NULL;
+    kstat_named_t  *kn;
+
+    if (module == NULL || strcmp(module, "link") != 0) {
+        return NULL;
+    }
+
+    g_static_mutex_lock(&link_mutex);
+    if ((link = find_link_locked(name, NULL)) != NULL) {
+        ksp = g_new0(kstat_t, 1);
+        (void) g_strlcpy(ksp->ks_module, module, sizeof (ksp->ks_module));
+        (void) g_strlcpy(ksp->ks_name, name, sizeof (ksp->ks_name));
+        ksp->ks_type = KSTAT_TYPE_NAMED;
+        ksp->ks_ndata = 1;
+
+        kn = g_new0(kstat_named_t, 1);
+        (void) g_strlcpy(kn->name, "ifspeed", sizeof (kn->name));
+        kn->data_type = KSTAT_DATA_UINT64;
+        kn->value.ui64 = link->speed;
+        ksp->ks_data = kn;
+        ksp->ks_data_size = sizeof (kstat_named_t);
+
+        ksp->ks_next = kc->kc_chain;
+        kc->kc_chain = ksp;
+    }
+    g_static_mutex_unlock(&link_mutex);
+
+    return ksp;
+}
+
+kid_t
+kstat_read(kstat_ctl_t *kc, kstat_t *ksp, void *buf)
+{
+    return ksp != NULL ? 0 : -1;
+}
+
+void *
+kstat_data_lookup(kstat_t *ksp, char *name)
+{
+    kstat_named_t  *kn = (kstat_named_t *)ksp->ks_data;
+    uint_t          i;
+
+    for (i = 0; i < ksp->ks_ndata; i++) {
+        if (strcmp(kn[i].name, name) == 0) {
+            return &kn[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * SMF. Instances are kept with their state, properties as
+ * "<fmri>/<pg>/<prop>". Service states changed through
+ * nwam_fake_scf_set() wake up _scf_notify_wait().
+ */
+
+struct scf_handle {
+    gboolean        bound;
+};
+
+struct scf_scope {
+    gint            unused;
+};
+
+struct scf_service {
+    gchar          *name;
+};
+
+struct scf_instance {
+    gchar          *fmri;
+};
+
+struct scf_snapshot {
+    gint            unused;
+};
+
+struct scf_propertygroup {
+    gchar          *fmri;
+    gchar          *name;
+};
+
+struct scf_property {
+    gchar          *key;
+};
+
+struct scf_value {
+    gchar          *value;
+};
+
+struct scf_transaction {
+    gint            unused;
+};
+
+struct scf_transaction_entry {
+    gint            unused;
+};
+
+struct scf_iter {
+    GList          *names;
+    GList          *next;
+};
+
+static GStaticMutex scf_mutex = G_STATIC_MUTEX_INIT;
+static GCond       *scf_cond = NULL;
+static GHashTable  *scf_states = NULL;      /* fmri -> state */
+static GHashTable  *scf_props = NULL;       /* fmri/pg/prop -> value */
+static GQueue      *scf_changes = NULL;     /* fmris changed */
+static scf_error_t  scf_last_error = SCF_ERROR_NONE;
+
+static void
+scf_init_locked(void)
+{
+    if (scf_states == NULL) {
+        scf_cond = g_cond_new();
+        scf_states = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+        scf_props = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+        scf_changes = g_queue_new();
+        g_hash_table_insert(scf_states, g_strdup(NWAMUI_FMRI), g_strdup(SCF_STATE_STRING_ONLINE));
+    }
+}
+
+static gint
+scf_fail(scf_error_t err)
+{
+    scf_last_error = err;
+    return -1;
+}
+
+void
+nwam_fake_scf_reset(void)
+{
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    g_hash_table_remove_all(scf_states);
+    g_hash_table_remove_all(scf_props);
+    g_hash_table_insert(scf_states, g_strdup(NWAMUI_FMRI), g_strdup(SCF_STATE_STRING_ONLINE));
+    g_static_mutex_unlock(&scf_mutex);
+}
+
+/* With no property group, sets the state of the instance. */
+void
+nwam_fake_scf_set(const gchar *fmri, const gchar *pg, const gchar *prop, const gchar *value)
+{
+    const gchar    *old;
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    if (pg == NULL || prop == NULL) {
+        old = (const gchar *)g_hash_table_lookup(scf_states, fmri);
+        if (g_strcmp0(old, value) != 0) {
+            g_hash_table_replace(scf_states, g_strdup(fmri), g_strdup(value));
+            g_queue_push_tail(scf_changes, g_strdup(fmri));
+            g_cond_broadcast(scf_cond);
+        }
+    } else {
+        if (g_hash_table_lookup(scf_states, fmri) == NULL) {
+            g_hash_table_insert(scf_states, g_strdup(fmri), g_strdup(SCF_STATE_STRING_DISABLED));
+        }
+        if (value != NULL) {
+            g_hash_table_replace(scf_props, g_strdup_printf("%s/%s/%s", fmri, pg, prop),
+              g_strdup(value));
+        } else {
+            gchar *key = g_strdup_printf("%s/%s/%s", fmri, pg, prop);
+
+            g_hash_table_remove(scf_props, key);
+            g_free(key);
+        }
+    }
+    g_static_mutex_unlock(&scf_mutex);
+}
+
+char *
+smf_get_state(const char *fmri)
+{
+    const gchar    *state;
+    char           *rval = NULL;
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    if ((state = (const gchar *)g_hash_table_lookup(scf_states, fmri)) != NULL) {
+        rval = strdup(state);
+    } else {
+        scf_last_error = SCF_ERROR_NOT_FOUND;
+    }
+    g_static_mutex_unlock(&scf_mutex);
+
+    return rval;
+}
+
+scf_error_t
+scf_error(void)
+{
+    return scf_last_error;
+}
+
+const char *
+scf_strerror(scf_error_t err)
+{
+    switch (err) {
+    case SCF_ERROR_NONE:                return "No error";
+    case SCF_ERROR_NOT_BOUND:           return "Repository handle is not bound";
+    case SCF_ERROR_NOT_FOUND:           return "The repository entity does not exist";
+    case SCF_ERROR_INVALID_ARGUMENT:    return "Invalid argument";
+    case SCF_ERROR_NOT_SET:             return "Entity is not set";
+    default:                            return "Unknown error";
+    }
+}
+
+ssize_t
+scf_limit(uint32_t limit)
+{
+    switch (limit) {
+    case SCF_LIMIT_MAX_NAME_LENGTH:
+    case SCF_LIMIT_MAX_VALUE_LENGTH:
+        return 4095;
+    case SCF_LIMIT_MAX_FMRI_LENGTH:
+        return 8191;
+    default:
+        return scf_fail(SCF_ERROR_INVALID_ARGUMENT);
+    }
+}
+
+scf_handle_t *
+scf_handle_create(scf_version_t version)
+{
+    return g_new0(scf_handle_t, 1);
+}
+
+int
+scf_handle_bind(scf_handle_t *handle)
+{
+    handle->bound = TRUE;
+    return 0;
+}
+
+int
+scf_handle_unbind(scf_handle_t *handle)
+{
+    if (!handle->bound) {
+        return scf_fail(SCF_ERROR_NOT_BOUND);
+    }
+    handle->bound = FALSE;
+    return 0;
+}
+
+void
+scf_handle_destroy(scf_handle_t *handle)
+{
+    g_free(handle);
+}
+
+int
+scf_handle_get_scope(scf_handle_t *handle, const char *name, scf_scope_t *scope)
+{
+    if (!handle->bound) {
+        return scf_fail(SCF_ERROR_NOT_BOUND);
+    }
+    return 0;
+}
+
+int
+scf_handle_decode_fmri(scf_handle_t *handle, const char *fmri, scf_scope_t *scope,
+  scf_service_t *service, scf_instance_t *instance, scf_propertygroup_t *pg,
+  scf_property_t *prop, int flags)
+{
+    gboolean    found;
+
+    if (!handle->bound) {
+        return scf_fail(SCF_ERROR_NOT_BOUND);
+    }
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    found = (g_hash_table_lookup(scf_states, fmri) != NULL);
+    g_static_mutex_unlock(&scf_mutex);
+
+    if (!found) {
+        return scf_fail(SCF_ERROR_NOT_FOUND);
+    }
+    if (instance != NULL) {
+        g_free(instance->fmri);
+        instance->fmri = g_strdup(fmri);
+    }
+    return 0;
+}
+
+scf_scope_t *
+scf_scope_create(scf_handle_t *handle)
+{
+    return g_new0(scf_scope_t, 1);
+}
+
+void
+scf_scope_destroy(scf_scope_t *scope)
+{
+    g_free(scope);
+}
+
+scf_service_t *
+scf_service_create(scf_handle_t *handle)
+{
+    return g_new0(scf_service_t, 1);
+}
+
+void
+scf_service_destroy(scf_service_t *service)
+{
+    if (service != NULL) {
+        g_free(service->name);
+        g_free(service);
+    }
+}
+
+static ssize_t
+copy_name(const gchar *name, char *buf, size_t size)
+{
+    if (name == NULL) {
+        return scf_fail(SCF_ERROR_NOT_SET);
+    }
+    return (ssize_t)g_strlcpy(buf, name, size);
+}
+
+ssize_t
+scf_service_get_name(const scf_service_t *service, char *buf, size_t size)
+{
+    return copy_name(service->name, buf, size);
+}
+
+scf_instance_t *
+scf_instance_create(scf_handle_t *handle)
+{
+    return g_new0(scf_instance_t, 1);
+}
+
+void
+scf_instance_destroy(scf_instance_t *instance)
+{
+    if (instance != NULL) {
+        g_free(instance->fmri);
+        g_free(instance);
+    }
+}
+
+ssize_t
+scf_instance_get_name(const scf_instance_t *instance, char *buf, size_t size)
+{
+    const gchar    *colon;
+
+    if (instance->fmri == NULL || (colon = strrchr(instance->fmri, ':')) == NULL) {
+        return scf_fail(SCF_ERROR_NOT_SET);
+    }
+    return copy_name(colon + 1, buf, size);
+}
+
+int
+scf_instance_get_pg(const scf_instance_t *instance, const char *name,
+  scf_propertygroup_t *pg)
+{
+    if (instance->fmri == NULL) {
+        return scf_fail(SCF_ERROR_NOT_SET);
+    }
+    g_free(pg->fmri);
+    g_free(pg->name);
+    pg->fmri = g_strdup(instance->fmri);
+    pg->name = g_strdup(name);
+    return 0;
+}
+
+int
+scf_instance_get_pg_composed(const scf_instance_t *instance, const scf_snapshot_t *snapshot,
+  const char *name, scf_propertygroup_t *pg)
+{
+    return scf_instance_get_pg(instance, name, pg);
+}
+
+int
+scf_instance_get_snapshot(const scf_instance_t *instance, const char *name,
+  scf_snapshot_t *snapshot)
+{
+    return instance->fmri != NULL ? 0 : scf_fail(SCF_ERROR_NOT_SET);
+}
+
+scf_snapshot_t *
+scf_snapshot_create(scf_handle_t *handle)
+{
+    return g_new0(scf_snapshot_t, 1);
+}
+
+void
+scf_snapshot_destroy(scf_snapshot_t *snapshot)
+{
+    g_free(snapshot);
+}
+
+scf_propertygroup_t *
+scf_pg_create(scf_handle_t *handle)
+{
+    return g_new0(scf_propertygroup_t, 1);
+}
+
+void
+scf_pg_destroy(scf_propertygroup_t *pg)
+{
+    if (pg != NULL) {
+        g_free(pg->fmri);
+        g_free(pg->name);
+        g_free(pg);
+    }
+}
+
+int
+scf_pg_get_property(const scf_propertygroup_t *pg, const char *name, scf_property_t *prop)
+{
+    gchar      *key;
+    gboolean    found;
+
+    if (pg->fmri == NULL) {
+        return scf_fail(SCF_ERROR_NOT_SET);
+    }
+    key = g_strdup_printf("%s/%s/%s", pg->fmri, pg->name, name);
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    found = (g_hash_table_lookup(scf_props, key) != NULL);
+    g_static_mutex_unlock(&scf_mutex);
+
+    if (!found) {
+        g_free(key);
+        return scf_fail(SCF_ERROR_NOT_FOUND);
+    }
+    g_free(prop->key);
+    prop->key = key;
+    return 0;
+}
+
+scf_property_t *
+scf_property_create(scf_handle_t *handle)
+{
+    return g_new0(scf_property_t, 1);
+}
+
+void
+scf_property_destroy(scf_property_t *prop)
+{
+    if (prop != NULL) {
+        g_free(prop->key);
+        g_free(prop);
+    }
+}
+
+int
+scf_property_get_value(const scf_property_t *prop, scf_value_t *value)
+{
+    const gchar    *v = NULL;
+
+    if (prop->key == NULL) {
+        return scf_fail(SCF_ERROR_NOT_SET);
+    }
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    v = (const gchar *)g_hash_table_lookup(scf_props, prop->key);
+    g_free(value->value);
+    value->value = g_strdup(v);
+    g_static_mutex_unlock(&scf_mutex);
+
+    return v != NULL ? 0 : scf_fail(SCF_ERROR_NOT_FOUND);
+}
+
+scf_value_t *
+scf_value_create(scf_handle_t *handle)
+{
+    return g_new0(scf_value_t, 1);
+}
+
+void
+scf_value_destroy(scf_value_t *value)
+{
+    if (value != NULL) {
+        g_free(value->value);
+        g_free(value);
+    }
+}
+
+ssize_t
+scf_value_get_astring(const scf_value_t *value, char *buf, size_t size)
+{
+    return copy_name(value->value, buf, size);
+}
+
+ssize_t
+scf_value_get_ustring(const scf_value_t *value, char *buf, size_t size)
+{
+    return copy_name(value->value, buf, size);
+}
+
+scf_transaction_t *
+scf_transaction_create(scf_handle_t *handle)
+{
+    return g_new0(scf_transaction_t, 1);
+}
+
+void
+scf_transaction_destroy(scf_transaction_t *tx)
+{
+    g_free(tx);
+}
+
+scf_transaction_entry_t *
+scf_entry_create(scf_handle_t *handle)
+{
+    return g_new0(scf_transaction_entry_t, 1);
+}
+
+void
+scf_entry_destroy(scf_transaction_entry_t *entry)
+{
+    g_free(entry);
+}
+
+scf_iter_t *
+scf_iter_create(scf_handle_t *handle)
+{
+    return g_new0(scf_iter_t, 1);
+}
+
+static void
+iter_reset(scf_iter_t *iter)
+{
+    g_list_foreach(iter->names, (GFunc)g_free, NULL);
+    g_list_free(iter->names);
+    iter->names = NULL;
+    iter->next = NULL;
+}
+
+void
+scf_iter_destroy(scf_iter_t *iter)
+{
+    if (iter != NULL) {
+        iter_reset(iter);
+        g_free(iter);
+    }
+}
+
+/* Services are "<service>" of "svc:/<service>:<instance>". */
+static gchar *
+fmri_to_service(const gchar *fmri)
+{
+    const gchar    *colon;
+
+    if (!g_str_has_prefix(fmri, "svc:/") || (colon = strrchr(fmri, ':')) == fmri + 3) {
+        return NULL;
+    }
+    return g_strndup(fmri + strlen("svc:/"), colon - fmri - strlen("svc:/"));
+}
+
+int
+scf_iter_scope_services(scf_iter_t *iter, const scf_scope_t *scope)
+{
+    GHashTableIter  hiter;
+    gpointer        key;
+
+    iter_reset(iter);
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    g_hash_table_iter_init(&hiter, scf_states);
+    while (g_hash_table_iter_next(&hiter, &key, NULL)) {
+        gchar  *service = fmri_to_service((const gchar *)key);
+
+        if (service == NULL ||
+          g_list_find_custom(iter->names, service, (GCompareFunc)strcmp) != NULL) {
+            g_free(service);
+        } else {
+            iter->names = g_list_insert_sorted(iter->names, service, (GCompareFunc)strcmp);
+        }
+    }
+    g_static_mutex_unlock(&scf_mutex);
+
+    iter->next = iter->names;
+    return 0;
+}
+
+int
+scf_iter_next_service(scf_iter_t *iter, scf_service_t *service)
+{
+    if (iter->next == NULL) {
+        return 0;
+    }
+    g_free(service->name);
+    service->name = g_strdup((const gchar *)iter->next->data);
+    iter->next = iter->next->next;
+    return 1;
+}
+
+int
+scf_iter_service_instances(scf_iter_t *iter, const scf_service_t *service)
+{
+    GHashTableIter  hiter;
+    gpointer        key;
+
+    if (service->name == NULL) {
+        return scf_fail(SCF_ERROR_NOT_SET);
+    }
+
+    iter_reset(iter);
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    g_hash_table_iter_init(&hiter, scf_states);
+    while (g_hash_table_iter_next(&hiter, &key, NULL)) {
+        gchar  *name = fmri_to_service((const gchar *)key);
+
+        if (g_strcmp0(name, service->name) == 0) {
+            iter->names = g_list_insert_sorted(iter->names, g_strdup((const gchar *)key),
+              (GCompareFunc)strcmp);
+        }
+        g_free(name);
+    }
+    g_static_mutex_unlock(&scf_mutex);
+
+    iter->next = iter->names;
+    return 0;
+}
+
+int
+scf_iter_next_instance(scf_iter_t *iter, scf_instance_t *instance)
+{
+    if (iter->next == NULL) {
+        return 0;
+    }
+    g_free(instance->fmri);
+    instance->fmri = g_strdup((const gchar *)iter->next->data);
+    iter->next = iter->next->next;
+    return 1;
+}
+
+int
+_scf_notify_add_pgname(scf_handle_t *handle, const char *name)
+{
+    return handle->bound ? SCF_SUCCESS : scf_fail(SCF_ERROR_NOT_BOUND);
+}
+
+/* Blocks until the state of an instance changes, like svc.startd's restarter. */
+int
+_scf_notify_wait(scf_propertygroup_t *pg, char *buf, size_t size)
+{
+    gchar  *fmri;
+
+    g_static_mutex_lock(&scf_mutex);
+    scf_init_locked();
+    while (g_queue_is_empty(scf_changes)) {
+        g_cond_wait(scf_cond, g_static_mutex_get_mutex(&scf_mutex));
+    }
+    fmri = (gchar *)g_queue_pop_head(scf_changes);
+    g_static_mutex_unlock(&scf_mutex);
+
+    (void) g_snprintf(buf, size, "%s/:properties/%s", fmri, SCF_PG_RESTARTER);
+    g_free(fmri);
+
+    return 0;
+}
+
+/* RBAC */
+
+/* Every user holds every authorization, unless NWAM_FAKE_NO_AUTHS is set. */
+int
+chkauthattr(const char *auth, const char *user)
+{
+    return g_getenv("NWAM_FAKE_NO_AUTHS") == NULL ? 1 : 0;
+}
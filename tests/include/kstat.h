@@ -0,0 +1,95 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   kstat.h
+ *
+ * Stand-in for the named kstats of the Solaris <kstat.h>, the calls are in
+ * libnwamui-fake.
+ */
+
+#ifndef _KSTAT_H
+#define	_KSTAT_H
+
+#include <solaris_compat.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define	KSTAT_STRLEN	31
+
+#define	KSTAT_TYPE_RAW		0
+#define	KSTAT_TYPE_NAMED	1
+
+#define	KSTAT_DATA_CHAR		0
+#define	KSTAT_DATA_INT32	1
+#define	KSTAT_DATA_UINT32	2
+#define	KSTAT_DATA_INT64	3
+#define	KSTAT_DATA_UINT64	4
+
+typedef int	kid_t;
+
+typedef struct kstat {
+	struct kstat	*ks_next;
+	char		ks_module[KSTAT_STRLEN];
+	int		ks_instance;
+	char		ks_name[KSTAT_STRLEN];
+	uchar_t		ks_type;
+	uint_t		ks_ndata;
+	size_t		ks_data_size;
+	void		*ks_data;
+} kstat_t;
+
+typedef struct kstat_named {
+	char	name[KSTAT_STRLEN];
+	uchar_t	data_type;
+	union {
+		char		c[16];
+		int32_t		i32;
+		uint32_t	ui32;
+		int64_t		i64;
+		uint64_t	ui64;
+	} value;
+} kstat_named_t;
+
+typedef struct kstat_ctl {
+	kid_t	kc_chain_id;
+	kstat_t	*kc_chain;
+	int	kc_kd;
+} kstat_ctl_t;
+
+extern kstat_ctl_t	*kstat_open(void);
+extern int		kstat_close(kstat_ctl_t *);
+extern kstat_t		*kstat_lookup(kstat_ctl_t *, char *, int, char *);
+extern kid_t		kstat_read(kstat_ctl_t *, kstat_t *, void *);
+extern void		*kstat_data_lookup(kstat_t *, char *);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* _KSTAT_H */
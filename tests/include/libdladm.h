@@ -0,0 +1,78 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   libdladm.h
+ *
+ * Stand-in for the part of the Solaris <libdladm.h> used with
+ * <libdlwlan.h>, the calls are in libnwamui-fake.
+ */
+
+#ifndef _LIBDLADM_H
+#define	_LIBDLADM_H
+
+#include <solaris_compat.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define	DLADM_STRSIZE		256
+
+#define	DLADM_OPT_ACTIVE	0x00000001
+#define	DLADM_OPT_PERSIST	0x00000002
+
+typedef enum {
+	DLADM_STATUS_OK = 0,
+	DLADM_STATUS_BADARG,
+	DLADM_STATUS_FAILED,
+	DLADM_STATUS_TOOSMALL,
+	DLADM_STATUS_NOTSUP,
+	DLADM_STATUS_NOTFOUND,
+	DLADM_STATUS_BADVAL,
+	DLADM_STATUS_NOMEM,
+	DLADM_STATUS_EXIST,
+	DLADM_STATUS_LINKINVAL
+} dladm_status_t;
+
+typedef enum {
+	DATALINK_CLASS_PHYS	= 0x01,
+	DATALINK_CLASS_VLAN	= 0x02,
+	DATALINK_CLASS_AGGR	= 0x04,
+	DATALINK_CLASS_VNIC	= 0x08
+} datalink_class_t;
+
+typedef uint32_t		datalink_id_t;
+typedef struct dladm_handle	*dladm_handle_t;
+
+extern dladm_status_t	dladm_open(dladm_handle_t *);
+extern void		dladm_close(dladm_handle_t);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* _LIBDLADM_H */
@@ -0,0 +1,181 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   libscf.h
+ *
+ * Stand-in for the part of the Solaris <libscf.h> used by libnwamui, the
+ * calls are in libnwamui-fake.
+ */
+
+#ifndef _LIBSCF_H
+#define	_LIBSCF_H
+
+#include <solaris_compat.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+typedef unsigned long	scf_version_t;
+#define	SCF_VERSION		1UL
+
+#define	SCF_SUCCESS		0
+#define	SCF_FAILED		-1
+
+#define	SCF_SCOPE_LOCAL		"localhost"
+#define	SCF_PG_RESTARTER	"restarter"
+
+#define	SCF_STATE_STRING_UNINIT		"uninitialized"
+#define	SCF_STATE_STRING_MAINT		"maintenance"
+#define	SCF_STATE_STRING_OFFLINE	"offline"
+#define	SCF_STATE_STRING_DISABLED	"disabled"
+#define	SCF_STATE_STRING_ONLINE		"online"
+#define	SCF_STATE_STRING_DEGRADED	"degraded"
+
+#define	SCF_DECODE_FMRI_EXACT			0x00000001
+#define	SCF_DECODE_FMRI_TRUNCATE		0x00000002
+#define	SCF_DECODE_FMRI_REQUIRE_INSTANCE	0x00000004
+#define	SCF_DECODE_FMRI_REQUIRE_NO_INSTANCE	0x00000008
+
+#define	SCF_LIMIT_MAX_NAME_LENGTH	-2000U
+#define	SCF_LIMIT_MAX_VALUE_LENGTH	-2001U
+#define	SCF_LIMIT_MAX_PG_TYPE_LENGTH	-2002U
+#define	SCF_LIMIT_MAX_FMRI_LENGTH	-2003U
+
+typedef enum scf_error {
+	SCF_ERROR_NONE = 1000,
+	SCF_ERROR_NOT_SET,
+	SCF_ERROR_NOT_FOUND,
+	SCF_ERROR_TYPE_MISMATCH,
+	SCF_ERROR_IN_USE,
+	SCF_ERROR_CONNECTION_BROKEN,
+	SCF_ERROR_INVALID_ARGUMENT,
+	SCF_ERROR_NO_MEMORY,
+	SCF_ERROR_CONSTRAINT_VIOLATED,
+	SCF_ERROR_EXISTS,
+	SCF_ERROR_NO_SERVER,
+	SCF_ERROR_NO_RESOURCES,
+	SCF_ERROR_PERMISSION_DENIED,
+	SCF_ERROR_BACKEND_ACCESS,
+	SCF_ERROR_HANDLE_MISMATCH,
+	SCF_ERROR_HANDLE_DESTROYED,
+	SCF_ERROR_VERSION_MISMATCH,
+	SCF_ERROR_BACKEND_READONLY,
+	SCF_ERROR_DELETED,
+	SCF_ERROR_TEMPLATE_INVALID,
+	SCF_ERROR_CALLBACK_FAILED = 1080,
+	SCF_ERROR_INTERNAL = 1101,
+	SCF_ERROR_NOT_BOUND = 1102
+} scf_error_t;
+
+typedef struct scf_handle		scf_handle_t;
+typedef struct scf_scope		scf_scope_t;
+typedef struct scf_service		scf_service_t;
+typedef struct scf_instance		scf_instance_t;
+typedef struct scf_snapshot		scf_snapshot_t;
+typedef struct scf_propertygroup	scf_propertygroup_t;
+typedef struct scf_property		scf_property_t;
+typedef struct scf_value		scf_value_t;
+typedef struct scf_transaction		scf_transaction_t;
+typedef struct scf_transaction_entry	scf_transaction_entry_t;
+typedef struct scf_iter			scf_iter_t;
+
+extern scf_error_t	scf_error(void);
+extern const char	*scf_strerror(scf_error_t);
+extern ssize_t		scf_limit(uint32_t);
+
+extern scf_handle_t	*scf_handle_create(scf_version_t);
+extern int		scf_handle_bind(scf_handle_t *);
+extern int		scf_handle_unbind(scf_handle_t *);
+extern void		scf_handle_destroy(scf_handle_t *);
+extern int		scf_handle_get_scope(scf_handle_t *, const char *,
+			    scf_scope_t *);
+extern int		scf_handle_decode_fmri(scf_handle_t *, const char *,
+			    scf_scope_t *, scf_service_t *, scf_instance_t *,
+			    scf_propertygroup_t *, scf_property_t *, int);
+
+extern scf_scope_t	*scf_scope_create(scf_handle_t *);
+extern void		scf_scope_destroy(scf_scope_t *);
+
+extern scf_service_t	*scf_service_create(scf_handle_t *);
+extern void		scf_service_destroy(scf_service_t *);
+extern ssize_t		scf_service_get_name(const scf_service_t *, char *,
+			    size_t);
+
+extern scf_instance_t	*scf_instance_create(scf_handle_t *);
+extern void		scf_instance_destroy(scf_instance_t *);
+extern ssize_t		scf_instance_get_name(const scf_instance_t *, char *,
+			    size_t);
+extern int		scf_instance_get_pg(const scf_instance_t *,
+			    const char *, scf_propertygroup_t *);
+extern int		scf_instance_get_pg_composed(const scf_instance_t *,
+			    const scf_snapshot_t *, const char *,
+			    scf_propertygroup_t *);
+extern int		scf_instance_get_snapshot(const scf_instance_t *,
+			    const char *, scf_snapshot_t *);
+
+extern scf_snapshot_t	*scf_snapshot_create(scf_handle_t *);
+extern void		scf_snapshot_destroy(scf_snapshot_t *);
+
+extern scf_propertygroup_t *scf_pg_create(scf_handle_t *);
+extern void		scf_pg_destroy(scf_propertygroup_t *);
+extern int		scf_pg_get_property(const scf_propertygroup_t *,
+			    const char *, scf_property_t *);
+
+extern scf_property_t	*scf_property_create(scf_handle_t *);
+extern void		scf_property_destroy(scf_property_t *);
+extern int		scf_property_get_value(const scf_property_t *,
+			    scf_value_t *);
+
+extern scf_value_t	*scf_value_create(scf_handle_t *);
+extern void		scf_value_destroy(scf_value_t *);
+extern ssize_t		scf_value_get_astring(const scf_value_t *, char *,
+			    size_t);
+extern ssize_t		scf_value_get_ustring(const scf_value_t *, char *,
+			    size_t);
+
+extern scf_transaction_t *scf_transaction_create(scf_handle_t *);
+extern void		scf_transaction_destroy(scf_transaction_t *);
+extern scf_transaction_entry_t *scf_entry_create(scf_handle_t *);
+extern void		scf_entry_destroy(scf_transaction_entry_t *);
+
+extern scf_iter_t	*scf_iter_create(scf_handle_t *);
+extern void		scf_iter_destroy(scf_iter_t *);
+extern int		scf_iter_scope_services(scf_iter_t *,
+			    const scf_scope_t *);
+extern int		scf_iter_next_service(scf_iter_t *, scf_service_t *);
+extern int		scf_iter_service_instances(scf_iter_t *,
+			    const scf_service_t *);
+extern int		scf_iter_next_instance(scf_iter_t *, scf_instance_t *);
+
+extern char		*smf_get_state(const char *);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* _LIBSCF_H */
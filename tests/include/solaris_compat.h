@@ -0,0 +1,87 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   solaris_compat.h
+ *
+ * The Solaris types and calls the stand-in headers of this directory rely
+ * on. These headers let libnwamui-core and libnwamui-fake build on other
+ * systems, they only declare what libnwamui uses and the fake implements.
+ */
+
+#ifndef _SOLARIS_COMPAT_H
+#define	_SOLARIS_COMPAT_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <time.h>
+#include <net/if.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+typedef enum { B_FALSE = 0, B_TRUE = 1 } boolean_t;
+
+typedef unsigned char   uchar_t;
+typedef unsigned short  ushort_t;
+typedef unsigned int    uint_t;
+typedef unsigned long   ulong_t;
+typedef long long       hrtime_t;
+
+#define	MILLISEC	1000
+#define	MICROSEC	1000000
+#define	NANOSEC		1000000000LL
+
+static inline hrtime_t
+gethrtime(void)
+{
+	struct timespec ts;
+
+	(void) clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((hrtime_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+/*
+ * Interface flags nwamd reports in IF_STATE events. They are above the
+ * flags of other systems, the Solaris IFF_DHCPRUNNING would be taken for
+ * IFF_AUTOMEDIA on Linux.
+ */
+#ifndef IFF_DHCPRUNNING
+#define	IFF_DHCPRUNNING	0x04000000
+#endif
+#ifndef IFF_IPV4
+#define	IFF_IPV4	0x01000000
+#endif
+#ifndef IFF_IPV6
+#define	IFF_IPV6	0x02000000
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* _SOLARIS_COMPAT_H */
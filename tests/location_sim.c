@@ -0,0 +1,338 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   location_sim.c
+ *
+ * Headless front end of the location activation simulator.
+ *
+ *   nwam-location-sim                       current environment
+ *   nwam-location-sim --env=essid=home,...  what-if environment
+ *   nwam-location-sim --env-file=FILE       one environment per line
+ *   nwam-location-sim --synthetic=500x20x10000
+ *                                           time synthetic locations
+ *                                           against synthetic environments
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include <libnwamui.h>
+
+/* Command-line options */
+static gboolean debug = FALSE;
+static gboolean verbose = FALSE;
+static gchar   *env_spec = NULL;
+static gchar   *env_file = NULL;
+static gchar   *synthetic = NULL;
+
+GOptionEntry application_options[] = {
+        { "debug", 0, 0, G_OPTION_ARG_NONE, &debug, N_("Enable debugging messages"), NULL },
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose, N_("Show the outcome of each condition"), NULL },
+        { "env", 'e', 0, G_OPTION_ARG_STRING, &env_spec, N_("Evaluate SPEC instead of the current environment"), N_("SPEC") },
+        { "env-file", 'f', 0, G_OPTION_ARG_FILENAME, &env_file, N_("Evaluate each line of FILE as an environment"), N_("FILE") },
+        { "synthetic", 0, 0, G_OPTION_ARG_STRING, &synthetic, N_("Time LOCSxCONDSxENVS synthetic locations, conditions and environments"), N_("SIZE") },
+        { NULL }
+};
+
+static const gchar*
+activation_mode_to_str(nwamui_cond_activation_mode_t mode)
+{
+    switch (mode) {
+    case NWAMUI_COND_ACTIVATION_MODE_MANUAL:            return "manual";
+    case NWAMUI_COND_ACTIVATION_MODE_SYSTEM:            return "system";
+    case NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY:   return "conditional-any";
+    case NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL:   return "conditional-all";
+    default:                                            return "unknown";
+    }
+}
+
+static void
+print_results(const nwamui_cond_sim_t *sim, const nwamui_cond_env_t *env)
+{
+    GList  *results = nwamui_cond_sim_run(sim, env, verbose);
+    GList  *idx;
+    GList  *reason;
+    gchar  *spec = nwamui_cond_env_to_string(env);
+
+    printf("Environment: %s\n", spec);
+    g_free(spec);
+
+    for (idx = results; idx; idx = idx->next) {
+        nwamui_cond_sim_result_t *result = (nwamui_cond_sim_result_t *)idx->data;
+
+        printf("%c %-24s %-16s %-14s %" G_GUINT64_FORMAT "\n",
+          result->selected ? '*' : ' ',
+          result->name,
+          activation_mode_to_str(result->activation_mode),
+          result->selected ? "selected" : result->matches ? "matches" : "no match",
+          result->score);
+
+        for (reason = result->reasons; reason; reason = reason->next) {
+            printf("      %s\n", (gchar *)reason->data);
+        }
+    }
+
+    nwamui_cond_sim_free_results(results);
+}
+
+static gint
+run_env_file(const nwamui_cond_sim_t *sim, const gchar *filename)
+{
+    nwamui_cond_env_t  *env;
+    const gchar        *selected;
+    GError             *error = NULL;
+    gchar              *contents;
+    gchar             **lines;
+    gchar             **line;
+    guint64             score;
+    gint                ret = EXIT_SUCCESS;
+
+    if (!g_file_get_contents(filename, &contents, NULL, &error)) {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+        return EXIT_FAILURE;
+    }
+
+    lines = g_strsplit(contents, "\n", 0);
+    for (line = lines; *line != NULL; line++) {
+        g_strstrip(*line);
+        if (**line == '\0' || **line == '#') {
+            continue;
+        }
+
+        env = nwamui_cond_env_new();
+        if (nwamui_cond_env_parse(env, *line)) {
+            selected = nwamui_cond_sim_select(sim, env, &score);
+            printf("%s\t%" G_GUINT64_FORMAT "\t%s\n", selected, score, *line);
+        } else {
+            fprintf(stderr, "Invalid environment: %s\n", *line);
+            ret = EXIT_FAILURE;
+        }
+        nwamui_cond_env_free(env);
+    }
+
+    g_strfreev(lines);
+    g_free(contents);
+
+    return ret;
+}
+
+static NwamuiCond*
+synthetic_cond(guint loc, guint cond)
+{
+    NwamuiCond *ret;
+    gchar      *value;
+    guint       n = loc * 31 + cond * 7;
+
+    switch (cond % 5) {
+    case 0:
+        value = g_strdup_printf("net-%u", n % 200);
+        ret = nwamui_cond_new_with_args(NWAMUI_COND_FIELD_ESSID, NWAMUI_COND_OP_IS, value);
+        break;
+    case 1:
+        value = g_strdup_printf("10.%u.%u.0/24", n % 16, (n / 16) % 16);
+        ret = nwamui_cond_new_with_args(NWAMUI_COND_FIELD_IP_ADDRESS, NWAMUI_COND_OP_IS_IN_RANGE, value);
+        break;
+    case 2:
+        value = g_strdup_printf("dom%u", n % 50);
+        ret = nwamui_cond_new_with_args(NWAMUI_COND_FIELD_SYS_DOMAIN, NWAMUI_COND_OP_CONTAINS, value);
+        break;
+    case 3:
+        value = g_strdup_printf("net%u", n % 4);
+        ret = nwamui_cond_new_with_args(NWAMUI_COND_FIELD_NCU, NWAMUI_COND_OP_INCLUDE, value);
+        break;
+    default:
+        value = g_strdup_printf("00:14:4f:00:%02x:%02x", n % 8, (n / 8) % 8);
+        ret = nwamui_cond_new_with_args(NWAMUI_COND_FIELD_BSSID, NWAMUI_COND_OP_IS_NOT, value);
+        break;
+    }
+    g_free(value);
+
+    return ret;
+}
+
+static nwamui_cond_env_t*
+synthetic_env(GRand *rand)
+{
+    nwamui_cond_env_t  *env = nwamui_cond_env_new();
+    gchar              *value;
+
+    value = g_strdup_printf("net%d", g_rand_int_range(rand, 0, 4));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_NCU, value);
+    g_free(value);
+
+    value = g_strdup_printf("10.%d.%d.%d", g_rand_int_range(rand, 0, 16),
+      g_rand_int_range(rand, 0, 16), g_rand_int_range(rand, 1, 255));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_IP_ADDRESS, value);
+    g_free(value);
+
+    value = g_strdup_printf("net-%d", g_rand_int_range(rand, 0, 200));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_ESSID, value);
+    g_free(value);
+
+    value = g_strdup_printf("00:14:4f:00:%02x:%02x", g_rand_int_range(rand, 0, 8),
+      g_rand_int_range(rand, 0, 8));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_BSSID, value);
+    g_free(value);
+
+    value = g_strdup_printf("dom%d.example.com", g_rand_int_range(rand, 0, 50));
+    nwamui_cond_env_add(env, NWAMUI_COND_FIELD_SYS_DOMAIN, value);
+    g_free(value);
+
+    return env;
+}
+
+static gint
+run_synthetic(const gchar *size)
+{
+    nwamui_cond_sim_t  *sim;
+    nwamui_cond_env_t **envs;
+    GList              *conds;
+    GRand              *rand;
+    GTimer             *timer;
+    gchar              *name;
+    guint               n_locs;
+    guint               n_conds;
+    guint               n_envs;
+    guint               n_auto = 0;
+    guint               i;
+    guint               j;
+    gdouble             compile_secs;
+    gdouble             eval_secs;
+
+    if (sscanf(size, "%ux%ux%u", &n_locs, &n_conds, &n_envs) != 3) {
+        fprintf(stderr, "Expected LOCSxCONDSxENVS, e.g. 500x20x10000\n");
+        return EXIT_FAILURE;
+    }
+
+    timer = g_timer_new();
+
+    sim = nwamui_cond_sim_new();
+    for (i = 0; i < n_locs; i++) {
+        conds = NULL;
+        for (j = 0; j < n_conds; j++) {
+            conds = g_list_prepend(conds, synthetic_cond(i, j));
+        }
+        name = g_strdup_printf("loc%u", i);
+        nwamui_cond_sim_add_location(sim, name,
+          (i % 2) ? NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL :
+          NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY,
+          FALSE, conds);
+        g_free(name);
+        nwamui_util_free_obj_list(conds);
+    }
+    compile_secs = g_timer_elapsed(timer, NULL);
+
+    /* Environments are built up front, only the evaluation is timed */
+    rand = g_rand_new_with_seed(n_envs);
+    envs = g_new(nwamui_cond_env_t *, n_envs);
+    for (i = 0; i < n_envs; i++) {
+        envs[i] = synthetic_env(rand);
+    }
+    g_rand_free(rand);
+
+    g_timer_start(timer);
+    for (i = 0; i < n_envs; i++) {
+        if (g_strcmp0(nwamui_cond_sim_select(sim, envs[i], NULL), NWAM_LOC_NAME_AUTOMATIC) == 0) {
+            n_auto++;
+        }
+    }
+    eval_secs = g_timer_elapsed(timer, NULL);
+
+    printf("Compiled %u locations of %u conditions in %.3f s\n", n_locs, n_conds, compile_secs);
+    printf("Evaluated %u environments in %.3f s, %.1f us each, %u fell back to %s\n",
+      n_envs, eval_secs, n_envs ? eval_secs * 1000000.0 / n_envs : 0.0,
+      n_auto, NWAM_LOC_NAME_AUTOMATIC);
+
+    for (i = 0; i < n_envs; i++) {
+        nwamui_cond_env_free(envs[i]);
+    }
+    g_free(envs);
+    nwamui_cond_sim_free(sim);
+    g_timer_destroy(timer);
+
+    return EXIT_SUCCESS;
+}
+
+int
+main(int argc, char** argv) 
+{
+    GOptionContext     *option_context;
+    GError             *err = NULL;
+    NwamuiDaemon       *daemon;
+    nwamui_cond_sim_t  *sim;
+    nwamui_cond_env_t  *env;
+    gint                ret = EXIT_SUCCESS;
+
+    g_thread_init( NULL );
+    g_type_init();
+
+    /* Setup log handler to trap debug messages */
+    nwamui_util_default_log_handler_init();
+
+    option_context = g_option_context_new("nwam-location-sim");
+    g_option_context_add_main_entries(option_context, application_options, NULL);
+    if (!g_option_context_parse(option_context, &argc, &argv, &err)) {
+        fprintf(stderr, "%s\n", err->message);
+        g_error_free(err);
+        return EXIT_FAILURE;
+    }
+    g_option_context_free(option_context);
+
+    nwamui_util_set_debug_mode( debug );
+
+    if (synthetic) {
+        return run_synthetic(synthetic);
+    }
+
+    daemon = nwamui_daemon_get_instance();
+    sim = nwamui_cond_sim_new_from_daemon(daemon);
+
+    if (env_file) {
+        ret = run_env_file(sim, env_file);
+    } else {
+        if (env_spec) {
+            env = nwamui_cond_env_new();
+            if (!nwamui_cond_env_parse(env, env_spec)) {
+                ret = EXIT_FAILURE;
+            }
+        } else {
+            env = nwamui_cond_env_new_from_daemon(daemon);
+        }
+        if (ret == EXIT_SUCCESS) {
+            print_results(sim, env);
+        }
+        nwamui_cond_env_free(env);
+    }
+
+    nwamui_cond_sim_free(sim);
+    g_object_unref(daemon);
+
+    return ret;
+}
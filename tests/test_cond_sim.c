@@ -0,0 +1,303 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_cond_sim.c
+ *
+ * The location selection of the what-if simulator, over hand-built
+ * locations and environments, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+/* Adds a location with conditions in the libnwam form, separated by ';'. */
+static void
+add_loc(nwamui_cond_sim_t *sim, const gchar *name, nwamui_cond_activation_mode_t mode,
+  gboolean enabled, const gchar *conditions)
+{
+    gchar **strs = g_strsplit(conditions ? conditions : "", ";", 0);
+    gchar **str;
+    GList  *conds = NULL;
+
+    for (str = strs; *str != NULL; str++) {
+        conds = g_list_append(conds, nwamui_cond_new_from_str(*str));
+    }
+    nwamui_cond_sim_add_location(sim, name, mode, enabled, conds);
+
+    nwamui_util_free_obj_list(conds);
+    g_strfreev(strs);
+}
+
+/* The location selected in the environment spec, see nwamui_cond_env_parse(). */
+static const gchar*
+select_in(const nwamui_cond_sim_t *sim, const gchar *spec, guint64 *score)
+{
+    nwamui_cond_env_t  *env = nwamui_cond_env_new();
+    const gchar        *name;
+
+    g_assert(nwamui_cond_env_parse(env, spec));
+    name = nwamui_cond_sim_select(sim, env, score);
+    nwamui_cond_env_free(env);
+
+    return name;
+}
+
+/* The result of the location name when run in the environment spec. */
+static nwamui_cond_sim_result_t*
+run_in(const nwamui_cond_sim_t *sim, const gchar *spec, const gchar *name)
+{
+    nwamui_cond_env_t          *env = nwamui_cond_env_new();
+    nwamui_cond_sim_result_t   *found = NULL;
+    GList                      *results;
+    GList                      *idx;
+
+    g_assert(nwamui_cond_env_parse(env, spec));
+    results = nwamui_cond_sim_run(sim, env, FALSE);
+    for (idx = results; idx; idx = idx->next) {
+        nwamui_cond_sim_result_t *result = (nwamui_cond_sim_result_t *)idx->data;
+
+        if (strcmp(result->name, name) == 0) {
+            found = result;
+        } else {
+            nwamui_cond_sim_result_free(result);
+        }
+    }
+    g_list_free(results);
+    nwamui_cond_env_free(env);
+
+    g_assert(found != NULL);
+    return found;
+}
+
+static guint64
+rating(const gchar *condition)
+{
+    NwamuiCond *cond = nwamui_cond_new_from_str(condition);
+    guint64     rating = nwamui_cond_get_rating(cond);
+
+    g_object_unref(cond);
+    g_assert_cmpuint(rating, >, 0);
+    return rating;
+}
+
+/* A /20 ends inside the third byte, 192.168.16.0 to 192.168.31.255. */
+static void
+test_ipv4_range(void)
+{
+    nwamui_cond_sim_t  *sim = nwamui_cond_sim_new();
+
+    add_loc(sim, "Office", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY, TRUE,
+      "ip-address is-in-range 192.168.20.0/20");
+
+    g_assert_cmpstr(select_in(sim, "ip-address=192.168.16.0", NULL), ==, "Office");
+    g_assert_cmpstr(select_in(sim, "ip-address=192.168.31.255", NULL), ==, "Office");
+    /* The prefix length of an address of the environment is ignored. */
+    g_assert_cmpstr(select_in(sim, "ip-address=192.168.24.7/24", NULL), ==, "Office");
+    g_assert_cmpstr(select_in(sim, "ip-address=192.168.15.255", NULL), ==, NWAM_LOC_NAME_AUTOMATIC);
+    g_assert_cmpstr(select_in(sim, "ip-address=192.168.32.0", NULL), ==, NWAM_LOC_NAME_AUTOMATIC);
+    /* Not an IPv4 address, whatever its bytes. */
+    g_assert_cmpstr(select_in(sim, "ip-address=c0a8:1000::1", NULL), ==, NWAM_LOC_NAME_AUTOMATIC);
+
+    nwamui_cond_sim_free(sim);
+}
+
+/* A /61 ends inside the fourth group, 2001:db8:0:8:: to 2001:db8:0:f:ffff:... */
+static void
+test_ipv6_range(void)
+{
+    nwamui_cond_sim_t  *sim = nwamui_cond_sim_new();
+
+    add_loc(sim, "Lab", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY, TRUE,
+      "ip-address is-in-range 2001:db8:0:a::/61");
+
+    g_assert_cmpstr(select_in(sim, "ip-address=2001:db8:0:8::1", NULL), ==, "Lab");
+    g_assert_cmpstr(select_in(sim, "ip-address=2001:db8:0:f:ffff:ffff:ffff:ffff", NULL), ==, "Lab");
+    g_assert_cmpstr(select_in(sim, "ip-address=2001:db8:0:7:ffff::1", NULL), ==, NWAM_LOC_NAME_AUTOMATIC);
+    g_assert_cmpstr(select_in(sim, "ip-address=2001:db8:0:10::1", NULL), ==, NWAM_LOC_NAME_AUTOMATIC);
+    g_assert_cmpstr(select_in(sim, "ip-address=10.0.0.1", NULL), ==, NWAM_LOC_NAME_AUTOMATIC);
+
+    nwamui_cond_sim_free(sim);
+}
+
+/* Each negated condition fails on what it excludes, and holds without it. */
+static void
+test_negated(void)
+{
+    nwamui_cond_sim_t  *sim = nwamui_cond_sim_new();
+
+    add_loc(sim, "Away", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL, TRUE,
+      "essid is-not home;"
+      "ip-address is-not-in-range 10.0.0.0/8;"
+      "system-domain does-not-contain corp");
+
+    g_assert_cmpstr(select_in(sim, "essid=cafe,ip-address=192.168.1.2,system-domain=example.com", NULL),
+      ==, "Away");
+    /* Nothing to exclude holds too. */
+    g_assert_cmpstr(select_in(sim, "", NULL), ==, "Away");
+
+    g_assert_cmpstr(select_in(sim, "essid=home,ip-address=192.168.1.2", NULL),
+      ==, NWAM_LOC_NAME_AUTOMATIC);
+    g_assert_cmpstr(select_in(sim, "essid=cafe,ip-address=10.1.2.3", NULL),
+      ==, NWAM_LOC_NAME_AUTOMATIC);
+    g_assert_cmpstr(select_in(sim, "essid=cafe,ip-address=192.168.1.2,system-domain=corp.example.com", NULL),
+      ==, NWAM_LOC_NAME_AUTOMATIC);
+
+    nwamui_cond_sim_free(sim);
+}
+
+/* "any" scores its best rated satisfied condition, "all" the sum of them. */
+static void
+test_any_and_all(void)
+{
+    nwamui_cond_sim_t          *sim = nwamui_cond_sim_new();
+    nwamui_cond_sim_result_t   *result;
+    guint64                     essid = rating("essid is home");
+    guint64                     ncu = rating("ncu net0 is active");
+    guint64                     domain = rating("advertised-domain is home.example.com");
+    guint64                     score;
+
+    /* So that the sum of "all" beats the best of "any". */
+    g_assert_cmpuint(ncu + domain, >, essid);
+    g_assert_cmpuint(essid, >, ncu);
+
+    add_loc(sim, "Any", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY, TRUE,
+      "ncu net0 is active;essid is home");
+    add_loc(sim, "All", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ALL, TRUE,
+      "ncu net0 is active;advertised-domain is home.example.com");
+
+    result = run_in(sim, "ncu=net0,essid=home,advertised-domain=home.example.com", "Any");
+    g_assert(result->matches);
+    g_assert_cmpuint(result->score, ==, essid);
+    nwamui_cond_sim_result_free(result);
+
+    result = run_in(sim, "ncu=net0,essid=home,advertised-domain=home.example.com", "All");
+    g_assert(result->matches);
+    g_assert(result->selected);
+    g_assert_cmpuint(result->score, ==, ncu + domain);
+    nwamui_cond_sim_result_free(result);
+
+    g_assert_cmpstr(select_in(sim, "ncu=net0,essid=home,advertised-domain=home.example.com", &score),
+      ==, "All");
+    g_assert_cmpuint(score, ==, ncu + domain);
+
+    /* One condition of "all" fails, the best of "any" wins. */
+    g_assert_cmpstr(select_in(sim, "ncu=net0,essid=home", &score), ==, "Any");
+    g_assert_cmpuint(score, ==, essid);
+
+    /* Only the lesser condition of "any" holds. */
+    g_assert_cmpstr(select_in(sim, "ncu=net0", &score), ==, "Any");
+    g_assert_cmpuint(score, ==, ncu);
+
+    nwamui_cond_sim_free(sim);
+}
+
+/* A disabled manual location is never selected. */
+static void
+test_disabled(void)
+{
+    nwamui_cond_sim_t          *sim = nwamui_cond_sim_new();
+    nwamui_cond_sim_result_t   *result;
+
+    add_loc(sim, "Cafe", NWAMUI_COND_ACTIVATION_MODE_MANUAL, FALSE, NULL);
+    add_loc(sim, "Home", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY, TRUE, "essid is home");
+
+    g_assert_cmpstr(select_in(sim, "essid=home", NULL), ==, "Home");
+    g_assert_cmpstr(select_in(sim, "essid=cafe", NULL), ==, NWAM_LOC_NAME_NO_NET);
+
+    result = run_in(sim, "essid=home", "Cafe");
+    g_assert(!result->matches);
+    g_assert(!result->selected);
+    nwamui_cond_sim_result_free(result);
+
+    nwamui_cond_sim_free(sim);
+}
+
+/* An enabled manual location overrides every condition. */
+static void
+test_manual(void)
+{
+    nwamui_cond_sim_t  *sim = nwamui_cond_sim_new();
+    guint64             score = 1;
+
+    add_loc(sim, "Home", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY, TRUE, "essid is home");
+    add_loc(sim, "Cafe", NWAMUI_COND_ACTIVATION_MODE_MANUAL, TRUE, NULL);
+
+    g_assert_cmpstr(select_in(sim, "essid=home,ip-address=192.168.1.2", &score), ==, "Cafe");
+    g_assert_cmpuint(score, ==, 0);
+    g_assert_cmpstr(select_in(sim, "", NULL), ==, "Cafe");
+
+    nwamui_cond_sim_free(sim);
+}
+
+/* Without a match, Automatic if there is an address, else NoNet. */
+static void
+test_fallback(void)
+{
+    nwamui_cond_sim_t          *sim = nwamui_cond_sim_new();
+    nwamui_cond_sim_result_t   *result;
+
+    add_loc(sim, NWAM_LOC_NAME_AUTOMATIC, NWAMUI_COND_ACTIVATION_MODE_SYSTEM, TRUE, NULL);
+    add_loc(sim, NWAM_LOC_NAME_NO_NET, NWAMUI_COND_ACTIVATION_MODE_SYSTEM, TRUE, NULL);
+    add_loc(sim, "Home", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY, TRUE, "essid is home");
+
+    g_assert_cmpstr(select_in(sim, "essid=home,ip-address=192.168.1.2", NULL), ==, "Home");
+    g_assert_cmpstr(select_in(sim, "essid=cafe,ip-address=192.168.1.2", NULL), ==, NWAM_LOC_NAME_AUTOMATIC);
+    g_assert_cmpstr(select_in(sim, "essid=cafe", NULL), ==, NWAM_LOC_NAME_NO_NET);
+
+    result = run_in(sim, "essid=cafe", NWAM_LOC_NAME_NO_NET);
+    g_assert(result->selected);
+    g_assert(result->matches);
+    nwamui_cond_sim_result_free(result);
+
+    result = run_in(sim, "essid=cafe", NWAM_LOC_NAME_AUTOMATIC);
+    g_assert(!result->selected);
+    nwamui_cond_sim_result_free(result);
+
+    nwamui_cond_sim_free(sim);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/cond-sim/ipv4-range", test_ipv4_range);
+    g_test_add_func("/cond-sim/ipv6-range", test_ipv6_range);
+    g_test_add_func("/cond-sim/negated", test_negated);
+    g_test_add_func("/cond-sim/any-and-all", test_any_and_all);
+    g_test_add_func("/cond-sim/disabled", test_disabled);
+    g_test_add_func("/cond-sim/manual", test_manual);
+    g_test_add_func("/cond-sim/fallback", test_fallback);
+
+    return g_test_run();
+}
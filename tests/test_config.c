@@ -0,0 +1,271 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_config.c
+ *
+ * nwamui_config_export() and nwamui_config_import() on the fake backend,
+ * run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <libdlwlan.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+#define LARGE_NCPS          10
+#define LARGE_NCUS          40
+#define LARGE_LOCS          500
+#define LARGE_WLANS         500
+
+/* A new NCP with a link and the interface on it. */
+static const gchar new_ncp[] =
+    "[ncp Work]\n"
+    "ip:net9\ttype=uint64,1;class=uint64,2;enabled=boolean,true;\n"
+    "datalink:net9\ttype=uint64,0;class=uint64,0;enabled=boolean,true;priority-group=uint64,0;\n";
+
+/* The same, with a property NCUs don't have. */
+static const gchar new_ncp_invalid[] =
+    "[ncp Work]\n"
+    "datalink:net9\ttype=uint64,0;class=uint64,0;enabled=boolean,true;essid=string,cafe;\n";
+
+static void
+count_report(gpointer data, gpointer user_data)
+{
+    g_test_message("%s", (const gchar *)data);
+    (*(guint *)user_data)++;
+}
+
+static void
+load_fixture(const gchar *name)
+{
+    gchar      *path = nwam_test_fixture_path(name);
+    GError     *err = NULL;
+
+    if (!nwam_fake_load_fixture(path, &err)) {
+        g_error("%s: %s", path, err->message);
+    }
+    g_free(path);
+}
+
+static FILE*
+export_store(void)
+{
+    FILE   *fp = tmpfile();
+
+    g_assert(fp != NULL);
+    g_assert(nwamui_config_export(fp, NWAMUI_CONFIG_SECRETS));
+    return fp;
+}
+
+static FILE*
+stream_new(const gchar *str)
+{
+    FILE   *fp = tmpfile();
+
+    g_assert(fp != NULL);
+    g_assert(fputs(str, fp) != EOF);
+    return fp;
+}
+
+static gboolean
+import_stream(FILE *fp, guint flags, guint *n_reports)
+{
+    guint   n = 0;
+
+    rewind(fp);
+    if (n_reports == NULL) {
+        n_reports = &n;
+    }
+    *n_reports = 0;
+    return nwamui_config_import(fp, NULL, flags, count_report, n_reports);
+}
+
+static gboolean
+ncp_exists(const gchar *name)
+{
+    nwam_ncp_handle_t   ncp;
+
+    if (nwam_ncp_read(name, 0, &ncp) != NWAM_SUCCESS) {
+        return FALSE;
+    }
+    nwam_ncp_free(ncp);
+    return TRUE;
+}
+
+/*
+ * Exported and imported into an empty store, the objects are created; a
+ * second import of the same stream then finds nothing to change.
+ */
+static void
+test_round_trip(void)
+{
+    FILE   *fp;
+    guint   n_reports;
+
+    load_fixture("laptop.fixture");
+    fp = export_store();
+
+    nwam_fake_reset();
+    g_assert(import_stream(fp, 0, NULL));
+    g_assert(ncp_exists("Automatic"));
+    g_assert(ncp_exists("User"));
+
+    nwam_fake_reset_commits();
+    g_assert(import_stream(fp, NWAMUI_CONFIG_DRY_RUN, &n_reports));
+    g_assert_cmpuint(n_reports, ==, 0);
+    g_assert(import_stream(fp, 0, &n_reports));
+    g_assert_cmpuint(n_reports, ==, 0);
+    g_assert_cmpuint(nwam_fake_get_commits(NULL), ==, 0);
+
+    fclose(fp);
+}
+
+/* A dry run checks the NCUs of a new NCP, but creates nothing. */
+static void
+test_new_ncp_dry_run(void)
+{
+    FILE   *fp;
+    guint   n_reports;
+
+    load_fixture("laptop.fixture");
+    nwam_fake_reset_commits();
+
+    fp = stream_new(new_ncp);
+    g_assert(import_stream(fp, NWAMUI_CONFIG_DRY_RUN, &n_reports));
+    g_assert_cmpuint(n_reports, ==, 3);
+    fclose(fp);
+
+    fp = stream_new(new_ncp_invalid);
+    g_assert(!import_stream(fp, NWAMUI_CONFIG_DRY_RUN, NULL));
+    g_assert(!import_stream(fp, 0, NULL));
+    fclose(fp);
+
+    g_assert(!ncp_exists("Work"));
+    g_assert_cmpuint(nwam_fake_get_commits(NULL), ==, 0);
+}
+
+/* The NCP is created with its NCUs, links first. */
+static void
+test_new_ncp(void)
+{
+    FILE               *fp;
+    nwam_ncp_handle_t   ncp;
+    nwam_ncu_handle_t   ncu;
+
+    load_fixture("laptop.fixture");
+
+    fp = stream_new(new_ncp);
+    g_assert(import_stream(fp, 0, NULL));
+
+    g_assert(nwam_ncp_read("Work", 0, &ncp) == NWAM_SUCCESS);
+    g_assert(nwam_ncu_read(ncp, "net9", NWAM_NCU_TYPE_LINK, 0, &ncu) == NWAM_SUCCESS);
+    nwam_ncu_free(ncu);
+    g_assert(nwam_ncu_read(ncp, "net9", NWAM_NCU_TYPE_INTERFACE, 0, &ncu) == NWAM_SUCCESS);
+    nwam_ncu_free(ncu);
+    nwam_ncp_free(ncp);
+
+    nwam_fake_reset_commits();
+    g_assert(import_stream(fp, 0, NULL));
+    g_assert_cmpuint(nwam_fake_get_commits(NULL), ==, 0);
+    fclose(fp);
+}
+
+/* A store the size of a busy site, through a round trip. */
+static void
+test_large(void)
+{
+    FILE   *fp;
+    gchar  *name;
+    gchar  *device;
+    gchar  *conds[2] = { NULL, NULL };
+    guint   n_reports;
+    guint   i;
+    guint   j;
+
+    nwam_fake_reset();
+    for (i = 0; i < LARGE_NCPS; i++) {
+        name = g_strdup_printf("ncp%u", i);
+        nwam_fake_add_ncp(name, FALSE);
+        for (j = 0; j < LARGE_NCUS; j++) {
+            device = g_strdup_printf("net%u", j);
+            nwam_fake_add_ncu(name, device, j % 4 == 0, j / 2);
+            g_free(device);
+        }
+        g_free(name);
+    }
+    for (i = 0; i < LARGE_LOCS; i++) {
+        name = g_strdup_printf("loc%u", i);
+        conds[0] = g_strdup_printf("essid is wlan%u", i);
+        nwam_fake_add_loc(name, NWAM_ACTIVATION_MODE_CONDITIONAL_ANY, conds);
+        g_free(conds[0]);
+        g_free(name);
+    }
+    for (i = 0; i < LARGE_WLANS; i++) {
+        name = g_strdup_printf("wlan%u", i);
+        nwam_fake_add_known_wlan(name, i, DLADM_WLAN_SECMODE_NONE);
+        g_free(name);
+    }
+
+    g_test_timer_start();
+    fp = export_store();
+    g_test_message("export %.3f s", g_test_timer_elapsed());
+
+    nwam_fake_reset();
+    g_test_timer_start();
+    g_assert(import_stream(fp, 0, NULL));
+    g_test_message("import into an empty store %.3f s", g_test_timer_elapsed());
+
+    nwam_fake_reset_commits();
+    g_test_timer_start();
+    g_assert(import_stream(fp, 0, &n_reports));
+    g_test_message("import of no changes %.3f s", g_test_timer_elapsed());
+    g_assert_cmpuint(n_reports, ==, 0);
+    g_assert_cmpuint(nwam_fake_get_commits(NULL), ==, 0);
+
+    fclose(fp);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/config/round-trip", test_round_trip);
+    g_test_add_func("/config/new-ncp-dry-run", test_new_ncp_dry_run);
+    g_test_add_func("/config/new-ncp", test_new_ncp);
+    g_test_add_func("/config/large", test_large);
+
+    return g_test_run();
+}
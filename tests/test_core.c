@@ -0,0 +1,372 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_core.c
+ *
+ * The object model loaded from tests/fixtures/laptop.fixture, run by
+ * make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+static NwamuiDaemon *test_daemon = NULL;
+
+static void
+count_object(gpointer data, gpointer user_data)
+{
+    (*(guint *)user_data)++;
+}
+
+static void
+assert_counts(void)
+{
+    guint   n;
+
+    n = 0;
+    nwamui_daemon_foreach_ncp(test_daemon, count_object, &n);
+    g_assert_cmpuint(n, ==, 2);
+    n = 0;
+    nwamui_daemon_foreach_loc(test_daemon, count_object, &n);
+    g_assert_cmpuint(n, ==, 4);
+    n = 0;
+    nwamui_daemon_foreach_enm(test_daemon, count_object, &n);
+    g_assert_cmpuint(n, ==, 1);
+    n = 0;
+    nwamui_daemon_foreach_fav_wifi(test_daemon, count_object, &n);
+    g_assert_cmpuint(n, ==, 2);
+}
+
+static void
+test_fixture(void)
+{
+    NwamuiObject   *ncp;
+
+    assert_counts();
+
+    ncp = nwamui_daemon_get_active_ncp(test_daemon);
+    g_assert(ncp != NULL);
+    g_assert_cmpstr(nwamui_object_get_name(ncp), ==, "Automatic");
+    g_object_unref(ncp);
+
+    g_assert(nwamui_daemon_is_hydrated(test_daemon));
+}
+
+static void
+compare_live(gpointer key, gpointer value, gpointer user_data)
+{
+    GHashTable *before = (GHashTable *)user_data;
+
+    g_assert_cmpuint(GPOINTER_TO_UINT(value), ==,
+      GPOINTER_TO_UINT(g_hash_table_lookup(before, key)));
+}
+
+/* A reload updates the objects in place, it neither adds nor leaks any. */
+static void
+test_reload(void)
+{
+    GHashTable *before;
+    GHashTable *after;
+
+    before = nwamui_instances_get_live_counts();
+    nwamui_object_reload(NWAMUI_OBJECT(test_daemon));
+    nwamui_object_reload(NWAMUI_OBJECT(test_daemon));
+    nwam_test_iterate();
+    after = nwamui_instances_get_live_counts();
+
+    assert_counts();
+    g_hash_table_foreach(after, compare_live, before);
+
+    g_hash_table_destroy(before);
+    g_hash_table_destroy(after);
+}
+
+static void
+test_object_state(void)
+{
+    NwamuiObject   *env;
+    guint           target = nwam_test_lane_count(test_daemon) + 1;
+
+    nwam_fake_queue_object_state(NWAM_OBJECT_TYPE_LOC, NULL, "Office",
+      NWAM_STATE_ONLINE, NWAM_AUX_STATE_ACTIVE);
+    g_assert(nwam_test_wait_for_events(test_daemon, target));
+    nwam_test_iterate();
+
+    env = nwamui_daemon_get_env_by_name(test_daemon, "Office");
+    g_assert(env != NULL);
+    g_assert_cmpint(nwamui_object_get_nwam_state(env, NULL, NULL), ==, NWAM_STATE_ONLINE);
+    g_object_unref(env);
+}
+
+typedef struct {
+    GString    *names;
+    guint       state;      /* Events of the state lane seen so far */
+} dispatch_order_t;
+
+/* Records an event, after the events of the state lane handled before it. */
+static void
+record_dispatch(dispatch_order_t *order, const gchar *name)
+{
+    guint   state;
+
+    nwamui_daemon_get_event_lane_stats(test_daemon, NWAMUI_DAEMON_EVENT_LANE_STATE,
+      &state, NULL, NULL);
+    for (; order->state < state; order->state++) {
+        g_string_append(order->names, "link-state ");
+    }
+    if (name) {
+        g_string_append_printf(order->names, "%s ", name);
+    }
+}
+
+static void
+record_add(NwamuiObject *daemon, NwamuiObject *child, gpointer user_data)
+{
+    gchar  *name = g_strdup_printf("add-%s", nwamui_object_get_name(child));
+
+    record_dispatch((dispatch_order_t *)user_data, name);
+    g_free(name);
+}
+
+static void
+record_active_env(GObject *daemon, GParamSpec *pspec, gpointer user_data)
+{
+    record_dispatch((dispatch_order_t *)user_data, "active-env");
+}
+
+/* The state of a new location follows its creation, in the critical lane,
+ * ahead of the link state queued before them.
+ */
+static void
+test_action_then_state(void)
+{
+    NwamuiObject       *env;
+    dispatch_order_t    order;
+    gulong              add_handler;
+    gulong              env_handler;
+    guint               critical;
+    guint               count;
+    guint               target = nwam_test_lane_count(test_daemon) + 3;
+
+    nwamui_daemon_get_event_lane_stats(test_daemon, NWAMUI_DAEMON_EVENT_LANE_CRITICAL,
+      &critical, NULL, NULL);
+
+    order.names = g_string_new(NULL);
+    nwamui_daemon_get_event_lane_stats(test_daemon, NWAMUI_DAEMON_EVENT_LANE_STATE,
+      &order.state, NULL, NULL);
+    add_handler = g_signal_connect(test_daemon, "add", G_CALLBACK(record_add), &order);
+    env_handler = g_signal_connect(test_daemon, "notify::active-env",
+      G_CALLBACK(record_active_env), &order);
+
+    nwam_fake_add_loc("Cafe", NWAM_ACTIVATION_MODE_MANUAL, NULL);
+    nwam_fake_queue_link_state("net0", TRUE);
+    nwam_fake_queue_object_action(NWAM_OBJECT_TYPE_LOC, NULL, "Cafe", NWAM_ACTION_ADD);
+    nwam_fake_queue_object_state(NWAM_OBJECT_TYPE_LOC, NULL, "Cafe",
+      NWAM_STATE_ONLINE, NWAM_AUX_STATE_ACTIVE);
+    g_assert(nwam_test_wait_for_events(test_daemon, target));
+    nwam_test_iterate();
+    record_dispatch(&order, NULL);
+
+    g_signal_handler_disconnect(test_daemon, add_handler);
+    g_signal_handler_disconnect(test_daemon, env_handler);
+
+    g_test_message("dispatch order: %s", order.names->str);
+    g_assert_cmpstr(order.names->str, ==, "add-Cafe active-env link-state ");
+    g_string_free(order.names, TRUE);
+
+    nwamui_daemon_get_event_lane_stats(test_daemon, NWAMUI_DAEMON_EVENT_LANE_CRITICAL,
+      &count, NULL, NULL);
+    g_assert_cmpuint(count, ==, critical + 2);
+
+    env = nwamui_daemon_get_env_by_name(test_daemon, "Cafe");
+    g_assert(env != NULL);
+    g_assert_cmpint(nwamui_object_get_nwam_state(env, NULL, NULL), ==, NWAM_STATE_ONLINE);
+    g_object_unref(env);
+}
+
+static void
+count_changed(NwamuiObject *object, guint n_pspecs, GParamSpec **pspecs, gpointer user_data)
+{
+    guint  *counts = (guint *)user_data;
+
+    counts[0]++;
+    counts[1] = n_pspecs;
+}
+
+/* However many sets an update holds, its end emits one "changed", and so
+ * does a reload.
+ */
+static void
+test_update_changed(void)
+{
+    NwamuiObject   *env;
+    guint           counts[2] = { 0, 0 };
+    gulong          handler;
+    gint            i;
+
+    env = nwamui_daemon_get_env_by_name(test_daemon, "Home");
+    g_assert(env != NULL);
+    handler = g_signal_connect(env, "changed", G_CALLBACK(count_changed), counts);
+
+    nwamui_object_begin_update(env);
+    for (i = 0; i < 10; i++) {
+        nwamui_env_set_default_domainname(NWAMUI_ENV(env), i % 2 ? "a.example.com" : "b.example.com");
+        nwamui_env_set_nfsv4_domain(NWAMUI_ENV(env), i % 2 ? "a.example.com" : "b.example.com");
+    }
+    g_assert_cmpuint(counts[0], ==, 0);
+    nwamui_object_end_update(env);
+    g_assert_cmpuint(counts[0], ==, 1);
+    g_assert_cmpuint(counts[1], ==, 2);
+
+    /* Discards the sets too. */
+    nwamui_object_reload(env);
+    g_assert_cmpuint(counts[0], ==, 2);
+    g_assert(!nwamui_object_has_modifications(env));
+
+    g_signal_handler_disconnect(env, handler);
+    g_object_unref(env);
+}
+
+static void
+add_session(gpointer data, gpointer user_data)
+{
+    GList **sessions = (GList **)user_data;
+
+    *sessions = g_list_prepend(*sessions, nwamui_edit_session_new(NWAMUI_OBJECT(data)));
+}
+
+/* Committing the sessions of every location writes the one changed. */
+static void
+test_edit_session(void)
+{
+    GList                  *sessions = NULL;
+    GList                  *idx;
+    nwamui_edit_session_t  *changed;
+    gchar                  *domain = NULL;
+
+    nwamui_daemon_foreach_loc(test_daemon, add_session, &sessions);
+    g_assert_cmpuint(g_list_length(sessions), ==, 4);
+
+    changed = (nwamui_edit_session_t *)sessions->data;
+    nwamui_edit_session_set(changed, "default_domainname", "test.example.com", NULL);
+    g_assert(nwamui_edit_session_has_changes(changed));
+    nwamui_edit_session_get(changed, "default_domainname", &domain, NULL);
+    g_assert_cmpstr(domain, ==, "test.example.com");
+    g_free(domain);
+
+    nwam_fake_reset_commits();
+    for (idx = sessions; idx; idx = idx->next) {
+        g_assert(nwamui_edit_session_commit((nwamui_edit_session_t *)idx->data, NULL));
+        nwamui_edit_session_free((nwamui_edit_session_t *)idx->data);
+    }
+    g_list_free(sessions);
+    g_assert_cmpuint(nwam_fake_get_commits(NULL), ==, 1);
+}
+
+/* A commit failing validation leaves the location as it was, the session
+ * keeps the changes to be corrected.
+ */
+static void
+test_edit_session_rollback(void)
+{
+    NwamuiObject           *nonet;
+    nwamui_edit_session_t  *session;
+    gchar                  *prop_name = NULL;
+    gchar                  *domain = NULL;
+
+    nonet = nwamui_daemon_get_env_by_name(test_daemon, "NoNet");
+    g_assert(nonet != NULL);
+    g_assert_cmpint(nwamui_object_get_activation_mode(nonet), ==, NWAMUI_COND_ACTIVATION_MODE_SYSTEM);
+
+    /* Conditional activation without conditions doesn't validate. */
+    session = nwamui_edit_session_new(nonet);
+    nwamui_edit_session_set(session,
+      "default_domainname", "rollback.example.com",
+      "activation_mode", NWAMUI_COND_ACTIVATION_MODE_CONDITIONAL_ANY,
+      NULL);
+    nwam_fake_reset_commits();
+    g_assert(!nwamui_edit_session_commit(session, &prop_name));
+    g_assert_cmpstr(prop_name, ==, NWAM_LOC_PROP_CONDITIONS);
+    g_free(prop_name);
+    g_assert_cmpuint(nwam_fake_get_commits(NULL), ==, 0);
+
+    g_assert_cmpint(nwamui_object_get_activation_mode(nonet), ==, NWAMUI_COND_ACTIVATION_MODE_SYSTEM);
+    g_object_get(nonet, "default_domainname", &domain, NULL);
+    g_assert_cmpstr(domain, !=, "rollback.example.com");
+    g_free(domain);
+    g_assert(nwamui_edit_session_has_changes(session));
+
+    /* Corrected, the rest of the changes commit. */
+    nwamui_edit_session_set(session, "activation_mode", NWAMUI_COND_ACTIVATION_MODE_SYSTEM, NULL);
+    g_assert(nwamui_edit_session_commit(session, NULL));
+    g_assert_cmpuint(nwam_fake_get_commits(NULL), ==, 1);
+    g_object_get(nonet, "default_domainname", &domain, NULL);
+    g_assert_cmpstr(domain, ==, "rollback.example.com");
+    g_free(domain);
+
+    nwamui_edit_session_free(session);
+    g_object_unref(nonet);
+}
+
+/* Reported only, nwam-bench-gtk --compare-rss sets it against GTK. */
+static void
+test_rss(void)
+{
+    g_test_message("peak RSS %lu KB", (unsigned long)nwam_test_peak_rss_kb());
+}
+
+int
+main(int argc, char** argv)
+{
+    int     rval;
+
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    test_daemon = nwam_test_daemon_from_fixture("laptop.fixture");
+
+    g_test_add_func("/core/fixture", test_fixture);
+    g_test_add_func("/core/reload", test_reload);
+    g_test_add_func("/core/object-state", test_object_state);
+    g_test_add_func("/core/update-changed", test_update_changed);
+    g_test_add_func("/core/edit-session", test_edit_session);
+    g_test_add_func("/core/edit-session-rollback", test_edit_session_rollback);
+    g_test_add_func("/core/action-then-state", test_action_then_state);
+    g_test_add_func("/core/rss", test_rss);
+
+    rval = g_test_run();
+
+    g_object_unref(test_daemon);
+    return rval;
+}
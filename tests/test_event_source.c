@@ -0,0 +1,288 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_event_source.c
+ *
+ * Throughput and delays of the replay event source, on its own and
+ * through the event thread and the lanes of the daemon, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+#define THROUGHPUT_EVENTS   20000
+#define DAEMON_EVENTS       5000
+#define DELAY_EVENTS        20
+#define DELAY_MSEC          10
+/* How late a delayed event may be, generous for loaded build machines. */
+#define DELAY_SLACK_MSEC    500
+
+static const nwamui_event_source_t *replay = &nwamui_event_source_replay;
+
+/* An init, then n - 1 link-state events alternating over net0 and wpi0. */
+static gchar*
+write_script(guint n, guint delay_msec)
+{
+    GString    *script = g_string_new("init\n");
+    gchar      *path = NULL;
+    GError     *err = NULL;
+    gint        fd;
+    guint       i;
+
+    for (i = 1; i < n; i++) {
+        if (delay_msec > 0) {
+            g_string_append_printf(script, "+%u ", delay_msec);
+        }
+        g_string_append_printf(script, "link-state %s %s\n",
+          i % 2 ? "net0" : "wpi0", (i / 2) % 2 ? "up" : "down");
+    }
+
+    fd = g_file_open_tmp("nwam-replay-XXXXXX", &path, &err);
+    g_assert_no_error(err);
+    (void) close(fd);
+    (void) g_file_set_contents(path, script->str, script->len, &err);
+    g_assert_no_error(err);
+
+    g_string_free(script, TRUE);
+    return path;
+}
+
+static void
+assert_event(gpointer data, guint i)
+{
+    nwam_event_t    event = NULL;
+
+    g_assert_cmpint(replay->wait(data, &event), ==, NWAM_SUCCESS);
+    g_assert(event != NULL);
+    g_assert_cmpint(event->nwe_type, ==, i == 0 ? NWAM_EVENT_TYPE_INIT : NWAM_EVENT_TYPE_LINK_STATE);
+    nwam_event_free(event);
+}
+
+static void
+test_parse(void)
+{
+    gchar      *path = nwam_test_fixture_path("laptop.replay");
+    gpointer    data = nwamui_event_source_replay_new(path, 0);
+
+    g_assert(data != NULL);
+    g_assert_cmpuint(nwamui_event_source_replay_get_length(data), ==, 14);
+    replay->free(data);
+    g_free(path);
+}
+
+static void
+test_throughput(void)
+{
+    gchar      *path = write_script(THROUGHPUT_EVENTS, 0);
+    gpointer    data = nwamui_event_source_replay_new(path, 0);
+    GTimer     *timer;
+    gdouble     secs;
+    guint       i;
+
+    g_assert(data != NULL);
+    g_assert_cmpuint(nwamui_event_source_replay_get_length(data), ==, THROUGHPUT_EVENTS);
+    g_assert(replay->open(data));
+
+    timer = g_timer_new();
+    for (i = 0; i < THROUGHPUT_EVENTS; i++) {
+        assert_event(data, i);
+    }
+    secs = g_timer_elapsed(timer, NULL);
+    g_test_message("replay: %u events in %.3f s, %.0f events/s",
+      THROUGHPUT_EVENTS, secs, secs > 0 ? THROUGHPUT_EVENTS / secs : 0.0);
+
+    g_timer_destroy(timer);
+    replay->close(data);
+    replay->free(data);
+    (void) g_unlink(path);
+    g_free(path);
+}
+
+/* Each event comes no sooner than its delay, and not much later. */
+static void
+test_delay(void)
+{
+    gchar      *path = write_script(DELAY_EVENTS, DELAY_MSEC);
+    gpointer    data = nwamui_event_source_replay_new(path, 1.0);
+    GTimer     *timer = g_timer_new();
+    gdouble     msec;
+    gdouble     max_late = 0;
+    gdouble     total_late = 0;
+    guint       i;
+
+    g_assert(data != NULL);
+    g_assert(replay->open(data));
+
+    assert_event(data, 0);
+    for (i = 1; i < DELAY_EVENTS; i++) {
+        g_timer_start(timer);
+        assert_event(data, i);
+        msec = g_timer_elapsed(timer, NULL) * 1000;
+
+        /* GTimeVal deadlines are in usec, allow for the rounding. */
+        g_assert_cmpfloat(msec, >=, DELAY_MSEC - 1);
+        g_assert_cmpfloat(msec, <, DELAY_MSEC + DELAY_SLACK_MSEC);
+        max_late = MAX(max_late, msec - DELAY_MSEC);
+        total_late += msec - DELAY_MSEC;
+    }
+    g_test_message("replay: %u events %u ms apart, late avg %.3f ms, max %.3f ms",
+      DELAY_EVENTS - 1, DELAY_MSEC, total_late / (DELAY_EVENTS - 1), max_late);
+
+    g_timer_destroy(timer);
+    replay->close(data);
+    replay->free(data);
+    (void) g_unlink(path);
+    g_free(path);
+}
+
+static gpointer
+close_later(gpointer data)
+{
+    g_usleep(50 * 1000);
+    replay->close(data);
+    return NULL;
+}
+
+/* A wait past the end blocks until closed, the next open starts over. */
+static void
+test_close(void)
+{
+    gchar          *path = write_script(2, 0);
+    gpointer        data = nwamui_event_source_replay_new(path, 0);
+    nwam_event_t    event = NULL;
+    GThread        *thread;
+
+    g_assert(data != NULL);
+    g_assert(replay->open(data));
+    assert_event(data, 0);
+    assert_event(data, 1);
+
+    thread = g_thread_create(close_later, data, TRUE, NULL);
+    g_assert(thread != NULL);
+    g_assert_cmpint(replay->wait(data, &event), ==, NWAM_ERROR_BIND);
+    g_thread_join(thread);
+
+    g_assert(replay->open(data));
+    assert_event(data, 0);
+
+    replay->close(data);
+    replay->free(data);
+    (void) g_unlink(path);
+    g_free(path);
+}
+
+#ifdef __linux__
+/* Needs a netlink socket, which some build sandboxes refuse. */
+static void
+test_rtnetlink(void)
+{
+    const nwamui_event_source_t    *source = NULL;
+    gpointer                        data = NULL;
+    nwam_event_t                    event = NULL;
+
+    g_assert(nwamui_event_source_parse("rtnetlink", &source, &data));
+    g_assert(source == &nwamui_event_source_rtnetlink);
+
+    if (source->open(data)) {
+        source->close(data);
+        g_assert_cmpint(source->wait(data, &event), ==, NWAM_ERROR_BIND);
+    } else {
+        g_test_message("rtnetlink: no netlink socket, only parsed");
+    }
+    source->free(data);
+}
+#endif
+
+/*
+ * Through the event thread and the lanes, the daemon is created here with
+ * the replay source and this test is the only one using it.
+ */
+static void
+test_daemon(void)
+{
+    NwamuiDaemon   *test_daemon;
+    gchar          *path = write_script(DAEMON_EVENTS, 0);
+    gchar          *fixture = nwam_test_fixture_path("laptop.fixture");
+    GError         *err = NULL;
+    GTimer         *timer;
+    gdouble         secs;
+    guint           count;
+    guint64         avg_usec;
+    guint64         max_usec;
+    gint            lane;
+
+    g_assert(nwam_fake_load_fixture(fixture, &err));
+    g_assert_no_error(err);
+    nwamui_daemon_set_event_source(replay, nwamui_event_source_replay_new(path, 0));
+
+    timer = g_timer_new();
+    test_daemon = nwamui_daemon_get_instance();
+    /* The ACTIVE queued on connect, then the script. */
+    g_assert(nwam_test_wait_for_events(test_daemon, DAEMON_EVENTS + 1));
+    secs = g_timer_elapsed(timer, NULL);
+
+    g_test_message("daemon: %u events in %.3f s since startup, %.0f events/s",
+      DAEMON_EVENTS, secs, secs > 0 ? DAEMON_EVENTS / secs : 0.0);
+    for (lane = 0; lane < NWAMUI_DAEMON_EVENT_LANE_LAST; lane++) {
+        nwamui_daemon_get_event_lane_stats(test_daemon, lane, &count, &avg_usec, &max_usec);
+        g_test_message("  lane %d: %u events, delay avg %llu us, max %llu us",
+          lane, count, (unsigned long long)avg_usec, (unsigned long long)max_usec);
+    }
+
+    g_timer_destroy(timer);
+    g_object_unref(test_daemon);
+    (void) g_unlink(path);
+    g_free(path);
+    g_free(fixture);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/event-source/replay/parse", test_parse);
+    g_test_add_func("/event-source/replay/throughput", test_throughput);
+    g_test_add_func("/event-source/replay/delay", test_delay);
+    g_test_add_func("/event-source/replay/close", test_close);
+#ifdef __linux__
+    g_test_add_func("/event-source/rtnetlink", test_rtnetlink);
+#endif
+    g_test_add_func("/event-source/replay/daemon", test_daemon);
+
+    return g_test_run();
+}
@@ -0,0 +1,269 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_fmri_index.c
+ *
+ * The SMF FMRI index over a fixed list, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+#include "test_util.h"
+
+/* Unsorted, with duplicates and an empty one. */
+static const gchar *test_fmris[] = {
+    "svc:/network/physical:nwam",
+    "svc:/network/nwam:default",
+    "svc:/system/name-service-cache:default",
+    "svc:/network/netmask:default",
+    "svc:/network/physical:default",
+    "svc:/network/nwam:default",
+    "",
+    "svc:/network/dns/client:default",
+    "svc:/network/physical:nwam",
+    "svc:/milestone/network:default",
+};
+
+#define TEST_N_FMRIS    7   /* Once deduplicated */
+
+static guint    ready_calls = 0;
+static guint    notify_calls = 0;
+
+static void
+test_backend(GFunc callback, gpointer callback_data, gpointer user_data)
+{
+    guint   i;
+
+    for (i = 0; i < G_N_ELEMENTS(test_fmris); i++) {
+        callback((gpointer)test_fmris[i], callback_data);
+    }
+}
+
+static gboolean
+index_ready(gpointer data)
+{
+    g_assert(nwamui_fmri_index_is_ready());
+    ready_calls++;
+    return FALSE;
+}
+
+static void
+index_notify(gpointer data)
+{
+    g_assert_cmpuint(GPOINTER_TO_UINT(data), ==, ready_calls);
+    notify_calls++;
+}
+
+static gboolean
+all_ready(gpointer data)
+{
+    return notify_calls >= GPOINTER_TO_UINT(data);
+}
+
+static void
+add_match(gpointer data, gpointer user_data)
+{
+    g_ptr_array_add((GPtrArray *)user_data, g_strdup((gchar *)data));
+}
+
+static gint
+compare_string(gconstpointer a, gconstpointer b)
+{
+    return strcmp(*(const gchar **)a, *(const gchar **)b);
+}
+
+/* What a scan of every FMRI finds, in sorted order. */
+static GPtrArray*
+scan(const gchar *key, gboolean prefix_only, guint max)
+{
+    GPtrArray  *fmris = g_ptr_array_new();
+    GPtrArray  *matches = g_ptr_array_new();
+    guint       i;
+
+    for (i = 0; i < G_N_ELEMENTS(test_fmris); i++) {
+        guint j;
+
+        for (j = 0; j < fmris->len; j++) {
+            if (strcmp(fmris->pdata[j], test_fmris[i]) == 0) {
+                break;
+            }
+        }
+        if (*test_fmris[i] != '\0' && j == fmris->len) {
+            g_ptr_array_add(fmris, (gpointer)test_fmris[i]);
+        }
+    }
+    g_ptr_array_sort(fmris, compare_string);
+
+    for (i = 0; i < fmris->len && (max == 0 || matches->len < max); i++) {
+        const gchar *fmri = fmris->pdata[i];
+
+        if (prefix_only ? g_str_has_prefix(fmri, key) : strstr(fmri, key) != NULL) {
+            g_ptr_array_add(matches, g_strdup(fmri));
+        }
+    }
+    g_ptr_array_free(fmris, TRUE);
+
+    return matches;
+}
+
+static GPtrArray*
+lookup(const gchar *key, gboolean prefix_only, guint max)
+{
+    GPtrArray  *matches = g_ptr_array_new();
+    guint       found;
+
+    found = nwamui_fmri_index_lookup(key, prefix_only, max, add_match, matches);
+    g_assert_cmpuint(found, ==, matches->len);
+    return matches;
+}
+
+static void
+free_matches(GPtrArray *matches)
+{
+    g_ptr_array_foreach(matches, (GFunc)g_free, NULL);
+    g_ptr_array_free(matches, TRUE);
+}
+
+static void
+assert_lookup(const gchar *key, gboolean prefix_only, guint max, guint expected)
+{
+    GPtrArray  *got = lookup(key, prefix_only, max);
+    GPtrArray  *want = scan(key, prefix_only, max);
+    guint       i;
+
+    g_assert_cmpuint(got->len, ==, expected);
+    g_assert_cmpuint(got->len, ==, want->len);
+    for (i = 0; i < got->len; i++) {
+        g_assert_cmpstr(got->pdata[i], ==, want->pdata[i]);
+    }
+    free_matches(got);
+    free_matches(want);
+}
+
+/* The waiters are called once each, from the main loop, then released. */
+static void
+test_ready(void)
+{
+    GPtrArray  *matches;
+
+    g_assert(!nwamui_fmri_index_is_ready());
+    g_assert_cmpuint(nwamui_fmri_index_get_size(), ==, 0);
+    matches = lookup("svc", TRUE, 0);
+    g_assert_cmpuint(matches->len, ==, 0);
+    free_matches(matches);
+
+    /* The second joins the build the first started. */
+    nwamui_fmri_index_build_async(index_ready, GUINT_TO_POINTER(1), index_notify);
+    nwamui_fmri_index_build_async(index_ready, GUINT_TO_POINTER(2), index_notify);
+    g_assert(nwam_test_run_until(all_ready, GUINT_TO_POINTER(2), NWAM_TEST_TIMEOUT_SECS));
+    nwam_test_iterate();
+    g_assert_cmpuint(ready_calls, ==, 2);
+    g_assert_cmpuint(notify_calls, ==, 2);
+
+    /* Once built, a waiter is called without building it again. */
+    nwamui_fmri_index_build_async(index_ready, GUINT_TO_POINTER(3), index_notify);
+    g_assert(nwam_test_run_until(all_ready, GUINT_TO_POINTER(3), NWAM_TEST_TIMEOUT_SECS));
+    nwam_test_iterate();
+    g_assert_cmpuint(ready_calls, ==, 3);
+    g_assert_cmpuint(notify_calls, ==, 3);
+}
+
+static void
+test_dedup(void)
+{
+    g_assert_cmpuint(nwamui_fmri_index_get_size(), ==, TEST_N_FMRIS);
+    assert_lookup("svc:/network/physical:nwam", TRUE, 0, 1);
+    assert_lookup("svc:/network/nwam:default", FALSE, 0, 1);
+}
+
+static void
+test_prefix(void)
+{
+    assert_lookup("svc:/network/", TRUE, 0, 5);
+    assert_lookup("svc:/network/physical", TRUE, 0, 2);
+    assert_lookup("svc:/network/physical", TRUE, 1, 1);
+    assert_lookup("svc:/network/n", TRUE, 0, 2);
+    assert_lookup("svc:/milestone/network:default", TRUE, 0, 1);
+    /* Past the end, before the start, and not at the start */
+    assert_lookup("svc:/zzz", TRUE, 0, 0);
+    assert_lookup("svc:/a", TRUE, 0, 0);
+    assert_lookup("network", TRUE, 0, 0);
+}
+
+/* An FMRI is reported once, however many of its suffixes match. */
+static void
+test_substring(void)
+{
+    /* network and netmask, network:default and network/... */
+    assert_lookup("net", FALSE, 0, 6);
+    assert_lookup("network", FALSE, 0, 6);
+    assert_lookup("nwam", FALSE, 0, 2);
+    assert_lookup(":default", FALSE, 0, 6);
+    assert_lookup("physical:", FALSE, 0, 2);
+    assert_lookup("mask", FALSE, 0, 1);
+    assert_lookup("notthere", FALSE, 0, 0);
+
+    /* More suffixes than FMRIs, the FMRIs are scanned up to max. */
+    assert_lookup("t", FALSE, 0, TEST_N_FMRIS);
+    assert_lookup("t", FALSE, 2, 2);
+    assert_lookup("e", FALSE, 3, 3);
+    assert_lookup("net", FALSE, 4, 4);
+}
+
+static void
+test_empty(void)
+{
+    assert_lookup("", TRUE, 0, TEST_N_FMRIS);
+    assert_lookup("", FALSE, 0, TEST_N_FMRIS);
+    assert_lookup("", TRUE, 3, 3);
+    assert_lookup("", FALSE, 3, 3);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    nwamui_fmri_index_set_backend(test_backend, NULL);
+
+    /* In order, the first builds the index. */
+    g_test_add_func("/fmri-index/ready", test_ready);
+    g_test_add_func("/fmri-index/dedup", test_dedup);
+    g_test_add_func("/fmri-index/prefix", test_prefix);
+    g_test_add_func("/fmri-index/substring", test_substring);
+    g_test_add_func("/fmri-index/empty", test_empty);
+
+    return g_test_run();
+}
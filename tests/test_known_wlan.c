@@ -0,0 +1,168 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_known_wlan.c
+ *
+ * Reordering the known WLANs of tests/fixtures/laptop.fixture and more,
+ * run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <libdlwlan.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+#define TEST_WLANS      200
+#define TEST_WLAN_FMT   "wlan%03u"
+
+static NwamuiDaemon *test_daemon = NULL;
+
+static void
+add_wlan(gpointer data, gpointer user_data)
+{
+    GList **wlans = (GList **)user_data;
+
+    *wlans = g_list_prepend(*wlans, g_object_ref(data));
+}
+
+static gint
+compare_priority(gconstpointer a, gconstpointer b)
+{
+    guint64 pa = nwamui_wifi_net_get_priority(NWAMUI_WIFI_NET(a));
+    guint64 pb = nwamui_wifi_net_get_priority(NWAMUI_WIFI_NET(b));
+
+    return pa < pb ? -1 : pa > pb;
+}
+
+/* The known WLANs, most preferred first. */
+static GList*
+get_wlans(void)
+{
+    GList  *wlans = NULL;
+
+    nwamui_daemon_foreach_fav_wifi(test_daemon, add_wlan, &wlans);
+    g_assert_cmpuint(g_list_length(wlans), ==, TEST_WLANS + 2);
+    return g_list_sort(wlans, compare_priority);
+}
+
+static GList*
+move_wlan(GList *wlans, guint from, guint to)
+{
+    GList  *link = g_list_nth(wlans, from);
+    gpointer wlan = link->data;
+
+    wlans = g_list_delete_link(wlans, link);
+    return g_list_insert(wlans, wlan, to);
+}
+
+/* Reorders, then checks what was committed is the order asked for. */
+static guint
+reorder(GList *wlans)
+{
+    GList  *sorted;
+    GList  *idx;
+    GList  *jdx;
+    guint   commits;
+
+    nwam_fake_reset_commits();
+    g_assert(nwamui_known_wlan_reorder(wlans));
+    commits = nwam_fake_get_commits(NULL);
+
+    nwamui_object_reload(NWAMUI_OBJECT(test_daemon));
+    sorted = get_wlans();
+    for (idx = wlans, jdx = sorted; idx && jdx; idx = idx->next, jdx = jdx->next) {
+        g_assert_cmpstr(nwamui_object_get_name(NWAMUI_OBJECT(idx->data)), ==,
+          nwamui_object_get_name(NWAMUI_OBJECT(jdx->data)));
+    }
+    nwamui_util_free_obj_list(sorted);
+
+    return commits;
+}
+
+/* Dense priorities leave no room, the first move renumbers them all. */
+static void
+test_renumber(void)
+{
+    GList  *wlans = get_wlans();
+
+    wlans = move_wlan(wlans, TEST_WLANS + 1, 1);
+    g_assert_cmpuint(reorder(wlans), >, 1);
+    nwamui_util_free_obj_list(wlans);
+}
+
+/* Once spaced, a single move commits the one WLAN moved, wherever to. */
+static void
+test_move(void)
+{
+    static const guint  moves[][2] = {
+        { TEST_WLANS + 1, 1 },              /* Last, to the second */
+        { 5, TEST_WLANS + 1 },              /* To the end */
+        { 10, TEST_WLANS / 2 },             /* Down the middle */
+        { TEST_WLANS / 2, 10 },             /* And back up */
+    };
+    GList  *wlans;
+    guint   i;
+
+    for (i = 0; i < G_N_ELEMENTS(moves); i++) {
+        wlans = move_wlan(get_wlans(), moves[i][0], moves[i][1]);
+        g_assert_cmpuint(reorder(wlans), ==, 1);
+        nwamui_util_free_obj_list(wlans);
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    gchar  *essid;
+    guint   i;
+
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    test_daemon = nwam_test_daemon_from_fixture("laptop.fixture");
+
+    /* After home and cafe, at 0 and 1. */
+    for (i = 0; i < TEST_WLANS; i++) {
+        essid = g_strdup_printf(TEST_WLAN_FMT, i);
+        nwam_fake_add_known_wlan(essid, 2 + i, DLADM_WLAN_SECMODE_NONE);
+        g_free(essid);
+    }
+    nwamui_object_reload(NWAMUI_OBJECT(test_daemon));
+    nwam_test_iterate();
+
+    g_test_add_func("/known-wlan/renumber", test_renumber);
+    g_test_add_func("/known-wlan/move", test_move);
+
+    return g_test_run();
+}
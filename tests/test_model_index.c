@@ -0,0 +1,379 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_model_index.c
+ *
+ * The object index of the capplet list and tree stores, see
+ * capplet_model_find_object(), without a display, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include <libnwamui.h>
+
+#include "capplet-utils.h"
+
+#define TEST_ROWS       50
+#define TEST_REMOVALS   5000
+
+static GObject*
+new_object(void)
+{
+    return g_object_new(G_TYPE_OBJECT, NULL);
+}
+
+static GtkListStore*
+new_list(GObject **objects, guint n)
+{
+    GtkListStore   *store = gtk_list_store_new(1, G_TYPE_OBJECT);
+    GtkTreeIter     iter;
+    guint           i;
+
+    for (i = 0; i < n; i++) {
+        objects[i] = new_object();
+        gtk_list_store_insert_with_values(store, &iter, -1, 0, objects[i], -1);
+    }
+    return store;
+}
+
+static void
+free_objects(GObject **objects, guint n)
+{
+    guint   i;
+
+    for (i = 0; i < n; i++) {
+        g_object_unref(objects[i]);
+    }
+}
+
+/* Where the index finds object, NULL if nowhere. */
+static gchar*
+find(GtkTreeModel *model, GtkTreeIter *parent, gboolean any_parent, GObject *object)
+{
+    GtkTreeIter     iter;
+    GObject        *row_object;
+    gboolean        found;
+
+    if (any_parent) {
+        found = capplet_model_find_object(model, object, &iter);
+    } else {
+        found = capplet_model_find_object_with_parent(model, parent, object, &iter);
+    }
+    if (!found) {
+        return NULL;
+    }
+
+    gtk_tree_model_get(model, &iter, 0, &row_object, -1);
+    g_assert(row_object == object);
+    g_object_unref(row_object);
+
+    return gtk_tree_model_get_string_from_iter(model, &iter);
+}
+
+static void
+assert_found(GtkTreeModel *model, GObject *object, const gchar *expected)
+{
+    gchar  *path = find(model, NULL, TRUE, object);
+
+    if (expected == NULL) {
+        g_assert(path == NULL);
+    } else {
+        g_assert_cmpstr(path, ==, expected);
+    }
+    g_free(path);
+}
+
+/* Every row of a list holds its own object. */
+static void
+assert_list(GtkTreeModel *model)
+{
+    GtkTreeIter     iter;
+    GObject        *object;
+    gboolean        valid;
+    gchar          *expected;
+
+    for (valid = gtk_tree_model_get_iter_first(model, &iter);
+         valid;
+         valid = gtk_tree_model_iter_next(model, &iter)) {
+        gtk_tree_model_get(model, &iter, 0, &object, -1);
+        expected = gtk_tree_model_get_string_from_iter(model, &iter);
+        assert_found(model, object, expected);
+        g_free(expected);
+        g_object_unref(object);
+    }
+}
+
+static void
+test_list(void)
+{
+    GObject        *objects[TEST_ROWS];
+    GtkListStore   *store = new_list(objects, TEST_ROWS);
+    GtkTreeModel   *model = GTK_TREE_MODEL(store);
+    GObject        *added = new_object();
+    GtkTreeIter     iter;
+    GtkTreeIter     other;
+    gint            order[TEST_ROWS];
+    gint            n;
+    gint            i;
+
+    /* Built on the first lookup */
+    assert_list(model);
+
+    /* Inserted and set after, through row-inserted and row-changed */
+    gtk_list_store_insert_with_values(store, &iter, 0, 0, added, -1);
+    assert_found(model, added, "0");
+    assert_found(model, objects[0], "1");
+    gtk_list_store_set(store, &iter, 0, objects[1], -1);
+    assert_found(model, added, NULL);
+    assert_found(model, objects[1], "0");
+    gtk_list_store_set(store, &iter, 0, added, -1);
+    assert_list(model);
+
+    /* Removed through the index, then behind its back */
+    g_assert(capplet_model_find_object(model, objects[10], &iter));
+    capplet_model_remove_row(model, &iter);
+    assert_found(model, objects[10], NULL);
+    g_assert(capplet_model_find_object(model, objects[20], &iter));
+    gtk_list_store_remove(store, &iter);
+    assert_found(model, objects[20], NULL);
+    assert_list(model);
+
+    /* Swapped and reordered, the iters stay valid */
+    g_assert(capplet_model_find_object(model, objects[0], &iter));
+    g_assert(capplet_model_find_object(model, objects[TEST_ROWS - 1], &other));
+    gtk_list_store_swap(store, &iter, &other);
+    assert_found(model, objects[TEST_ROWS - 1], "1");
+    assert_list(model);
+
+    n = gtk_tree_model_iter_n_children(model, NULL);
+    for (i = 0; i < n; i++) {
+        order[i] = n - 1 - i;
+    }
+    gtk_list_store_reorder(store, order);
+    assert_found(model, added, "48");
+    assert_list(model);
+
+    gtk_list_store_clear(store);
+    assert_found(model, added, NULL);
+    assert_found(model, objects[0], NULL);
+
+    g_object_unref(store);
+    g_object_unref(added);
+    free_objects(objects, TEST_ROWS);
+}
+
+/* An object held twice is found at the first row in the model order. */
+static void
+test_list_twice(void)
+{
+    GObject        *objects[TEST_ROWS];
+    GtkListStore   *store = new_list(objects, TEST_ROWS);
+    GtkTreeModel   *model = GTK_TREE_MODEL(store);
+    GtkTreeIter     iter;
+    GtkTreeIter     first;
+
+    assert_list(model);
+
+    /* Indexed after the row it follows */
+    gtk_list_store_insert_with_values(store, &iter, 30, 0, objects[5], -1);
+    assert_found(model, objects[5], "5");
+
+    /* Indexed after the row it precedes */
+    gtk_list_store_insert_with_values(store, &iter, 2, 0, objects[40], -1);
+    assert_found(model, objects[40], "2");
+
+    /* Moves change which one is first */
+    g_assert(gtk_tree_model_get_iter_first(model, &first));
+    g_assert(gtk_tree_model_iter_nth_child(model, &iter, NULL, 31));
+    gtk_list_store_move_before(store, &iter, &first);
+    assert_found(model, objects[5], "0");
+    gtk_list_store_move_before(store, &iter, NULL);
+    assert_found(model, objects[5], "6");
+
+    /* Once rebuilt too */
+    g_assert(gtk_tree_model_iter_nth_child(model, &iter, NULL, 0));
+    gtk_list_store_remove(store, &iter);
+    assert_found(model, objects[40], "1");
+
+    g_object_unref(store);
+    free_objects(objects, TEST_ROWS);
+}
+
+static void
+test_tree(void)
+{
+    GtkTreeStore   *store = gtk_tree_store_new(1, G_TYPE_OBJECT);
+    GtkTreeModel   *model = GTK_TREE_MODEL(store);
+    GObject        *parents[2];
+    GObject        *children[2][3];
+    GtkTreeIter     parent_iters[2];
+    GtkTreeIter     iter;
+    GtkTreeIter     moved;
+    gchar          *path;
+    guint           i;
+    guint           j;
+
+    for (i = 0; i < 2; i++) {
+        parents[i] = new_object();
+        gtk_tree_store_insert_with_values(store, &parent_iters[i], NULL, -1, 0, parents[i], -1);
+        for (j = 0; j < 3; j++) {
+            children[i][j] = new_object();
+            gtk_tree_store_insert_with_values(store, &iter, &parent_iters[i], -1,
+              0, children[i][j], -1);
+        }
+    }
+
+    assert_found(model, parents[1], "1");
+    assert_found(model, children[1][2], "1:2");
+
+    path = find(model, NULL, FALSE, parents[0]);
+    g_assert_cmpstr(path, ==, "0");
+    g_free(path);
+    path = find(model, &parent_iters[0], FALSE, children[0][1]);
+    g_assert_cmpstr(path, ==, "0:1");
+    g_free(path);
+    g_assert(find(model, &parent_iters[1], FALSE, children[0][1]) == NULL);
+    g_assert(find(model, NULL, FALSE, children[0][1]) == NULL);
+
+    /* Moved to the other parent the way the capplet does, copied first */
+    g_assert(capplet_model_find_object_with_parent(model, &parent_iters[0], children[0][1], &iter));
+    gtk_tree_store_insert_before(store, &moved, &parent_iters[1], NULL);
+    capplet_tree_store_move_object(model, &moved, &iter);
+    assert_found(model, children[0][1], "0:1");
+    path = find(model, &parent_iters[1], FALSE, children[0][1]);
+    g_assert_cmpstr(path, ==, "1:3");
+    g_free(path);
+
+    capplet_model_remove_row(model, &iter);
+    assert_found(model, children[0][1], "1:3");
+    g_assert(find(model, &parent_iters[0], FALSE, children[0][1]) == NULL);
+    assert_found(model, children[0][2], "0:1");
+
+    /* A parent removed takes its children along */
+    capplet_model_remove_row(model, &parent_iters[0]);
+    assert_found(model, parents[0], NULL);
+    assert_found(model, children[0][0], NULL);
+    assert_found(model, children[0][2], NULL);
+    assert_found(model, children[1][0], "0:0");
+    assert_found(model, children[0][1], "0:3");
+
+    g_object_unref(store);
+    for (i = 0; i < 2; i++) {
+        g_object_unref(parents[i]);
+        free_objects(children[i], 3);
+    }
+}
+
+static gboolean
+walk_find(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer user_data)
+{
+    gpointer   *data = (gpointer *)user_data;
+    GObject    *object;
+
+    gtk_tree_model_get(model, iter, 0, &object, -1);
+    g_object_unref(object);
+    if (object == data[0]) {
+        *(GtkTreeIter *)data[1] = *iter;
+        data[2] = object;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* Remove the objects one by one, in random order, each found first. */
+static void
+test_remove_timing(void)
+{
+    GObject        *objects[TEST_REMOVALS];
+    GtkListStore   *store;
+    GtkTreeIter     iter;
+    gpointer        data[3];
+    guint           order[TEST_REMOVALS];
+    GRand          *rand = g_rand_new_with_seed(TEST_REMOVALS);
+    gdouble         indexed;
+    gdouble         walked;
+    guint           i;
+
+    for (i = 0; i < TEST_REMOVALS; i++) {
+        order[i] = i;
+    }
+    for (i = TEST_REMOVALS - 1; i > 0; i--) {
+        guint j = g_rand_int_range(rand, 0, i + 1);
+        guint t = order[i];
+
+        order[i] = order[j];
+        order[j] = t;
+    }
+    g_rand_free(rand);
+
+    store = new_list(objects, TEST_REMOVALS);
+    g_test_timer_start();
+    for (i = 0; i < TEST_REMOVALS; i++) {
+        capplet_model_remove_object(GTK_TREE_MODEL(store), objects[order[i]]);
+    }
+    indexed = g_test_timer_elapsed();
+    g_assert_cmpint(gtk_tree_model_iter_n_children(GTK_TREE_MODEL(store), NULL), ==, 0);
+    g_object_unref(store);
+    free_objects(objects, TEST_REMOVALS);
+
+    /* As before the index, a walk of the model for each */
+    store = new_list(objects, TEST_REMOVALS);
+    g_test_timer_start();
+    for (i = 0; i < TEST_REMOVALS; i++) {
+        data[0] = objects[order[i]];
+        data[1] = &iter;
+        data[2] = NULL;
+        gtk_tree_model_foreach(GTK_TREE_MODEL(store), walk_find, data);
+        g_assert(data[2] != NULL);
+        gtk_list_store_remove(store, &iter);
+    }
+    walked = g_test_timer_elapsed();
+    g_object_unref(store);
+    free_objects(objects, TEST_REMOVALS);
+
+    g_test_message("%d removals: %.3f s indexed, %.3f s walking the model",
+      TEST_REMOVALS, indexed, walked);
+    g_assert_cmpfloat(indexed, <, walked);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/model-index/list", test_list);
+    g_test_add_func("/model-index/list-twice", test_list_twice);
+    g_test_add_func("/model-index/tree", test_tree);
+    g_test_add_func("/model-index/remove-timing", test_remove_timing);
+
+    return g_test_run();
+}
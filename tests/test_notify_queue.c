@@ -0,0 +1,345 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_notify_queue.c
+ *
+ * The notification queue of the tray, driven by a fake backend with a
+ * virtual clock, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include "notify-queue.h"
+
+#define DEFAULT_TIMEOUT     3000
+
+/* The bubbles of the fake notification server, and the virtual clock. */
+typedef struct {
+    gint64          now;
+    gint64          deadline;       /* 0 if not armed */
+    guint           shows;
+    guint           hides;
+    guint           arms;
+    guint           wakeups;        /* Timer fired */
+    gint            last_timeout;
+    gchar          *last_summary;
+    guint           last_count;
+    guint           next_bubble;
+} fake_server_t;
+
+static notify_queue_t  *q = NULL;
+static fake_server_t    server;
+
+static gint64
+fake_now(gpointer data)
+{
+    return ((fake_server_t *)data)->now;
+}
+
+static void
+fake_show(notify_msg_t *m, gint timeout, gpointer data)
+{
+    fake_server_t  *srv = (fake_server_t *)data;
+
+    if (m->backend_data == NULL) {
+        m->backend_data = GUINT_TO_POINTER(++srv->next_bubble);
+    }
+    srv->shows++;
+    srv->last_timeout = timeout;
+    srv->last_count = m->count;
+    g_free(srv->last_summary);
+    srv->last_summary = g_strdup(m->summary);
+}
+
+static void
+fake_hide(notify_msg_t *m, gpointer data)
+{
+    ((fake_server_t *)data)->hides++;
+}
+
+static void
+fake_arm(gint64 delay, gpointer data)
+{
+    fake_server_t  *srv = (fake_server_t *)data;
+
+    srv->arms++;
+    srv->deadline = delay >= 0 ? srv->now + delay : 0;
+}
+
+static const notify_queue_backend_t fake_backend = {
+    fake_now,
+    fake_show,
+    fake_hide,
+    fake_arm
+};
+
+/* Moves the clock, firing the timer on its way like the main loop would. */
+static void
+advance(gint64 msec)
+{
+    gint64  end = server.now + msec;
+
+    while (server.deadline > 0 && server.deadline <= end) {
+        server.now = server.deadline;
+        server.deadline = 0;
+        server.wakeups++;
+        notify_queue_timeout(q);
+    }
+    server.now = end;
+}
+
+static void
+push(notify_kind_t kind, GObject *subject, const gchar *summary)
+{
+    notify_queue_push(q, notify_msg_new(kind, subject, summary, NULL, NULL,
+      NULL, NULL, NULL, NULL, NULL, NOTIFY_EXPIRES_DEFAULT));
+}
+
+static void
+setup(void)
+{
+    g_free(server.last_summary);
+    memset(&server, 0, sizeof (server));
+    server.now = 1000000;
+    q = notify_queue_new(&fake_backend, &server, DEFAULT_TIMEOUT);
+}
+
+static void
+teardown(void)
+{
+    notify_queue_free(q);
+    q = NULL;
+}
+
+static void
+test_show(void)
+{
+    setup();
+    push(NOTIFY_KIND_LOC_CHANGED, NULL, "Home");
+
+    g_assert_cmpuint(server.shows, ==, 1);
+    g_assert_cmpint(server.last_timeout, ==, DEFAULT_TIMEOUT);
+    g_assert_cmpstr(server.last_summary, ==, "Home");
+    g_assert_cmpuint(notify_queue_get_length(q), ==, 1);
+    /* Nobody waits, the server expires it. */
+    g_assert_cmpint(server.deadline, ==, 0);
+
+    notify_queue_closed(q, GUINT_TO_POINTER(1));
+    g_assert_cmpuint(notify_queue_get_length(q), ==, 0);
+    teardown();
+}
+
+/* A message of the same key updates the showing bubble in place. */
+static void
+test_supersede(void)
+{
+    GObject    *ncu = g_object_new(G_TYPE_OBJECT, NULL);
+
+    setup();
+    push(NOTIFY_KIND_NCU_STATE, ncu, "net0 disconnected");
+    push(NOTIFY_KIND_NCU_STATE, ncu, "net0 connected");
+
+    g_assert_cmpuint(server.shows, ==, 2);
+    g_assert_cmpuint(server.hides, ==, 0);
+    g_assert_cmpuint(server.next_bubble, ==, 1);
+    g_assert_cmpstr(server.last_summary, ==, "net0 connected");
+    g_assert_cmpuint(notify_queue_get_length(q), ==, 1);
+    teardown();
+    g_object_unref(ncu);
+}
+
+/* A waiting message cuts the showing bubble to half its timeout. */
+static void
+test_tight_timeout(void)
+{
+    setup();
+    push(NOTIFY_KIND_NCP_CHANGED, NULL, "User");
+    push(NOTIFY_KIND_LOC_CHANGED, NULL, "Home");
+
+    g_assert_cmpuint(server.shows, ==, 1);
+    g_assert_cmpint(server.deadline, ==, server.now + DEFAULT_TIMEOUT / 2);
+
+    advance(DEFAULT_TIMEOUT / 2 - 1);
+    g_assert_cmpuint(server.shows, ==, 1);
+    advance(1);
+    g_assert_cmpuint(server.hides, ==, 1);
+    g_assert_cmpuint(server.shows, ==, 2);
+    g_assert_cmpstr(server.last_summary, ==, "Home");
+    g_assert_cmpint(server.last_timeout, ==, DEFAULT_TIMEOUT);
+    teardown();
+}
+
+/* Past its burst a key is limited, the rest is summarized once. */
+static void
+test_rate_limit(void)
+{
+    GObject    *ncu = g_object_new(G_TYPE_OBJECT, NULL);
+    gchar      *summary;
+    guint       i;
+
+    setup();
+    for (i = 0; i < 20; i++) {
+        summary = g_strdup_printf("wpi0 state %u", i);
+        push(NOTIFY_KIND_NCU_STATE, ncu, summary);
+        g_free(summary);
+        advance(10);
+    }
+    /* The burst of 3 updated the bubble, the other 17 wait. */
+    g_assert_cmpuint(server.shows, ==, 3);
+    g_assert_cmpuint(server.next_bubble, ==, 1);
+
+    advance(10000);
+    g_assert_cmpuint(server.shows, ==, 4);
+    g_assert_cmpuint(server.last_count, ==, 17);
+    g_assert_cmpstr(server.last_summary, ==, "wpi0 state 19");
+    g_assert_cmpuint(notify_queue_get_length(q), ==, 1);
+    teardown();
+    g_object_unref(ncu);
+}
+
+/* Too many pending messages without actions are folded into a summary. */
+static void
+test_fold(void)
+{
+    setup();
+    push(NOTIFY_KIND_NWAM_STATE, NULL, "NWAM is running");
+    push(NOTIFY_KIND_NCP_CHANGED, NULL, "User");
+    push(NOTIFY_KIND_LOC_CHANGED, NULL, "Home");
+    push(NOTIFY_KIND_NO_WIFI, NULL, "No wireless networks");
+    push(NOTIFY_KIND_NCU_WIFI_FAILED, NULL, "Connection failed");
+
+    /* The showing one, and one summary of the four others. */
+    g_assert_cmpuint(notify_queue_get_length(q), ==, 2);
+
+    advance(DEFAULT_TIMEOUT / 2);
+    g_assert_cmpuint(server.shows, ==, 2);
+    g_assert_cmpuint(server.last_count, ==, 4);
+    teardown();
+}
+
+static void
+test_invisible(void)
+{
+    setup();
+    notify_queue_set_visible(q, FALSE);
+    push(NOTIFY_KIND_NCP_CHANGED, NULL, "User");
+    push(NOTIFY_KIND_NCP_CHANGED, NULL, "Automatic");
+    g_assert_cmpuint(server.shows, ==, 0);
+    g_assert_cmpuint(notify_queue_get_length(q), ==, 1);
+
+    notify_queue_set_visible(q, TRUE);
+    g_assert_cmpuint(server.shows, ==, 1);
+    g_assert_cmpstr(server.last_summary, ==, "Automatic");
+    g_assert_cmpuint(server.last_count, ==, 2);
+    teardown();
+}
+
+/* An hour of a flapping link wakes the timer up once per summary. */
+static void
+test_wakeups(void)
+{
+    GObject    *ncu = g_object_new(G_TYPE_OBJECT, NULL);
+    guint       i;
+
+    setup();
+    for (i = 0; i < 3600; i++) {
+        push(NOTIFY_KIND_NCU_STATE, ncu, i % 2 ? "net0 connected" : "net0 disconnected");
+        advance(1000);
+    }
+    g_test_message("%u shows, %u timer arms in an hour of 1 Hz flapping",
+      server.shows, server.arms);
+    /* One per burst window of 10 s, plus the first burst. */
+    g_assert_cmpuint(server.shows, <=, 3 + 3600 / 10 + 1);
+    g_assert_cmpuint(server.arms, <=, 2 * (3600 / 10 + 1));
+    teardown();
+    g_object_unref(ncu);
+}
+
+/* Idle, or with the icon not embedded yet, an hour passes without a wakeup. */
+static void
+test_idle_hour(void)
+{
+    GObject    *ncu = g_object_new(G_TYPE_OBJECT, NULL);
+    guint       i;
+
+    setup();
+    advance(3600 * 1000);
+    g_assert_cmpuint(server.arms, ==, 0);
+    g_assert_cmpuint(server.wakeups, ==, 0);
+
+    /* A message a minute waits for the icon, nothing is armed for it. */
+    notify_queue_set_visible(q, FALSE);
+    for (i = 0; i < 60; i++) {
+        push(NOTIFY_KIND_NCU_STATE, ncu, i % 2 ? "net0 connected" : "net0 disconnected");
+        advance(60 * 1000);
+    }
+    g_test_message("%u timer arms, %u wakeups in an hour not embedded",
+      server.arms, server.wakeups);
+    g_assert_cmpuint(server.shows, ==, 0);
+    g_assert_cmpuint(server.arms, ==, 0);
+    g_assert_cmpuint(server.wakeups, ==, 0);
+    g_assert_cmpuint(notify_queue_get_length(q), ==, 1);
+
+    /* Once embedded the latest is shown, and the server expires it. */
+    notify_queue_set_visible(q, TRUE);
+    g_assert_cmpuint(server.shows, ==, 1);
+    g_assert_cmpstr(server.last_summary, ==, "net0 connected");
+    g_assert_cmpint(server.deadline, ==, 0);
+    notify_queue_closed(q, GUINT_TO_POINTER(1));
+    advance(3600 * 1000);
+    g_assert_cmpuint(server.wakeups, ==, 0);
+
+    teardown();
+    g_object_unref(ncu);
+}
+
+int
+main(int argc, char** argv)
+{
+    int     rval;
+
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/notify-queue/show", test_show);
+    g_test_add_func("/notify-queue/supersede", test_supersede);
+    g_test_add_func("/notify-queue/tight-timeout", test_tight_timeout);
+    g_test_add_func("/notify-queue/rate-limit", test_rate_limit);
+    g_test_add_func("/notify-queue/fold", test_fold);
+    g_test_add_func("/notify-queue/invisible", test_invisible);
+    g_test_add_func("/notify-queue/wakeups", test_wakeups);
+    g_test_add_func("/notify-queue/idle-hour", test_idle_hour);
+
+    rval = g_test_run();
+
+    g_free(server.last_summary);
+    return rval;
+}
@@ -0,0 +1,185 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_prof.c
+ *
+ * NwamuiProf on the keyfile store, run by make check: whatever is set is
+ * in the file by the time the instance or the main loop is gone.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <libnwamui.h>
+
+#define KEY_ADD_ANY_NEW_WIFI        "/apps/nwam-manager/add_any_new_wifi_to_fav"
+#define KEY_DEFAULT_TIMEOUT         "/apps/nwam-manager/notification_default_timeout"
+
+static gchar*
+store_path(const gchar *name)
+{
+    gchar  *base = g_strdup_printf("test-prof-%d-%s", (int)getpid(), name);
+    gchar  *path = g_build_filename(g_get_tmp_dir(), base, NULL);
+
+    g_free(base);
+    (void) g_unlink(path);
+    return path;
+}
+
+static NwamuiProf*
+prof_new(const gchar *path)
+{
+    nwamui_prof_set_store(&nwamui_prof_store_keyfile,
+      nwamui_prof_store_keyfile_new(path));
+    return nwamui_prof_get_instance();
+}
+
+/* Reads a key back from the file, as the next run would. */
+static gboolean
+stored_boolean(const gchar *path, const gchar *key, gboolean *valuep)
+{
+    gpointer    store = nwamui_prof_store_keyfile_new(path);
+    GValue      value = { 0 };
+    gboolean    found;
+
+    g_value_init(&value, G_TYPE_BOOLEAN);
+    if ((found = nwamui_prof_store_keyfile.get(store, key, &value))) {
+        *valuep = g_value_get_boolean(&value);
+    }
+    g_value_unset(&value);
+    nwamui_prof_store_keyfile.free(store);
+    return found;
+}
+
+static gboolean
+stored_int(const gchar *path, const gchar *key, gint *valuep)
+{
+    gpointer    store = nwamui_prof_store_keyfile_new(path);
+    GValue      value = { 0 };
+    gboolean    found;
+
+    g_value_init(&value, G_TYPE_INT);
+    if ((found = nwamui_prof_store_keyfile.get(store, key, &value))) {
+        *valuep = g_value_get_int(&value);
+    }
+    g_value_unset(&value);
+    nwamui_prof_store_keyfile.free(store);
+    return found;
+}
+
+/* Without a main loop nothing would run the idle write, so it is immediate. */
+static void
+test_write_through(void)
+{
+    gchar      *path = store_path("write-through");
+    NwamuiProf *prof = prof_new(path);
+    gboolean    add = TRUE;
+
+    g_object_set(prof, "add_any_new_wifi_to_fav", FALSE, NULL);
+    g_assert(stored_boolean(path, KEY_ADD_ANY_NEW_WIFI, &add));
+    g_assert(!add);
+
+    g_object_unref(prof);
+    (void) g_unlink(path);
+    g_free(path);
+}
+
+static gboolean
+set_and_quit(gpointer data)
+{
+    g_object_set(nwamui_prof_get_instance_noref(),
+      "add_any_new_wifi_to_fav", FALSE,
+      "notification_default_timeout", 4500,
+      NULL);
+    g_main_loop_quit((GMainLoop *)data);
+    return FALSE;
+}
+
+/* Set from the main loop, which is gone before it is idle again, like the
+ * capplet on OK.
+ */
+static void
+test_set_then_exit(void)
+{
+    gchar      *path = store_path("exit");
+    NwamuiProf *prof = prof_new(path);
+    GMainLoop  *loop = g_main_loop_new(NULL, FALSE);
+    gboolean    add = TRUE;
+    gint        timeout = 0;
+
+    g_idle_add_full(G_PRIORITY_HIGH, set_and_quit, loop, NULL);
+    g_main_loop_run(loop);
+    g_main_loop_unref(loop);
+
+    nwamui_prof_commit(prof);
+    g_assert(stored_boolean(path, KEY_ADD_ANY_NEW_WIFI, &add));
+    g_assert(!add);
+    g_assert(stored_int(path, KEY_DEFAULT_TIMEOUT, &timeout));
+    g_assert_cmpint(timeout, ==, 4500);
+
+    g_object_unref(prof);
+    (void) g_unlink(path);
+    g_free(path);
+}
+
+/* A write still waiting for idle is not lost on teardown. */
+static void
+test_set_then_teardown(void)
+{
+    gchar      *path = store_path("teardown");
+    NwamuiProf *prof = prof_new(path);
+    GMainLoop  *loop = g_main_loop_new(NULL, FALSE);
+    gint        timeout = 0;
+
+    g_idle_add_full(G_PRIORITY_HIGH, set_and_quit, loop, NULL);
+    g_main_loop_run(loop);
+    g_main_loop_unref(loop);
+
+    g_object_unref(prof);
+    g_assert(stored_int(path, KEY_DEFAULT_TIMEOUT, &timeout));
+    g_assert_cmpint(timeout, ==, 4500);
+
+    (void) g_unlink(path);
+    g_free(path);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/prof/write-through", test_write_through);
+    g_test_add_func("/prof/set-then-exit", test_set_then_exit);
+    g_test_add_func("/prof/set-then-teardown", test_set_then_teardown);
+
+    return g_test_run();
+}
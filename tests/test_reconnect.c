@@ -0,0 +1,104 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_reconnect.c
+ *
+ * The reconnect backoff of the event thread, against an event source which
+ * opens fine but fails every wait, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+/* Long enough for the opens at about 0, 1 and 3 s of a 1 s backoff. */
+#define RECONNECT_RUN_MSEC  2500
+
+static volatile gint opens = 0;
+
+static gboolean
+failing_open(gpointer data)
+{
+    g_atomic_int_inc(&opens);
+    return TRUE;
+}
+
+static nwam_error_t
+failing_wait(gpointer data, nwam_event_t *event)
+{
+    return NWAM_ERROR_INTERNAL;
+}
+
+static void
+failing_close(gpointer data)
+{
+}
+
+static void
+failing_free(gpointer data)
+{
+}
+
+static const nwamui_event_source_t failing_source = {
+    failing_open,
+    failing_wait,
+    failing_close,
+    failing_free
+};
+
+/* Without a backoff after a failed wait this would be thousands. */
+static void
+test_backoff(void)
+{
+    NwamuiDaemon   *test_daemon;
+    gint            n;
+
+    nwamui_daemon_set_event_source(&failing_source, NULL);
+    test_daemon = nwamui_daemon_get_instance();
+
+    g_usleep(RECONNECT_RUN_MSEC * 1000);
+    n = g_atomic_int_get(&opens);
+    g_test_message("%d opens in %d ms", n, RECONNECT_RUN_MSEC);
+    g_assert_cmpint(n, >=, 1);
+    g_assert_cmpint(n, <=, 3);
+
+    g_object_unref(test_daemon);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/reconnect/backoff", test_backoff);
+
+    return g_test_run();
+}
@@ -0,0 +1,237 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_scan_replay.c
+ *
+ * Scans of tests/fixtures/laptop.fixture replayed into the list model of
+ * the wireless chooser, without a display, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libdlwlan.h>
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+#define DEVICE          "wpi0"
+#define TEST_REPLAYS    10
+
+/* Row operations seen by a view of the model. */
+typedef struct {
+    guint   inserted;
+    guint   deleted;
+    guint   changed;
+    gchar  *changed_name;   /* Of the last row changed */
+} rows_t;
+
+static NwamuiDaemon    *test_daemon = NULL;
+static GtkTreeModel    *model = NULL;
+static rows_t           rows;
+
+static void
+row_inserted(GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+    rows.inserted++;
+}
+
+static void
+row_deleted(GtkTreeModel *tree_model, GtkTreePath *path, gpointer data)
+{
+    rows.deleted++;
+}
+
+static void
+row_changed(GtkTreeModel *tree_model, GtkTreePath *path, GtkTreeIter *iter, gpointer data)
+{
+    NwamuiObject   *object;
+
+    object = nwamui_object_list_model_get_object(NWAMUI_OBJECT_LIST_MODEL(tree_model), iter);
+    g_free(rows.changed_name);
+    rows.changed_name = g_strdup(nwamui_object_get_name(object));
+    g_object_unref(object);
+    rows.changed++;
+}
+
+static void
+reset_rows(void)
+{
+    g_free(rows.changed_name);
+    memset(&rows, 0, sizeof (rows));
+}
+
+/* The results of the fixture, the strength of cafe and the extra ones aside. */
+static void
+set_scan_results(guint cafe_strength, gboolean neighbour, gboolean extra)
+{
+    nwam_fake_clear_scan_results(DEVICE);
+    nwam_fake_add_scan_result(DEVICE, "home", "0:1b:2c:3d:4e:5f", DLADM_WLAN_SECMODE_WPA, 5, 6);
+    nwam_fake_add_scan_result(DEVICE, "cafe", "0:1b:2c:3d:4e:60", DLADM_WLAN_SECMODE_NONE, cafe_strength, 11);
+    if (neighbour) {
+        nwam_fake_add_scan_result(DEVICE, "neighbour", "0:1b:2c:3d:4e:61", DLADM_WLAN_SECMODE_WEP, 1, 1);
+    }
+    if (extra) {
+        nwam_fake_add_scan_result(DEVICE, "extra", "0:1b:2c:3d:4e:62", DLADM_WLAN_SECMODE_NONE, 2, 1);
+    }
+}
+
+/* Replays a scan report, and the idle row-changed it leads to. */
+static void
+scan(void)
+{
+    guint   target = nwam_test_lane_count(test_daemon) + 1;
+
+    reset_rows();
+    nwam_fake_queue_scan_report(DEVICE);
+    g_assert(nwam_test_wait_for_events(test_daemon, target));
+    nwam_test_iterate();
+}
+
+static gint
+n_rows(void)
+{
+    return gtk_tree_model_iter_n_children(model, NULL);
+}
+
+/* The same results again don't touch any row. */
+static void
+test_replay(void)
+{
+    NwamuiObject   *home = NULL;
+    NwamuiObject   *object;
+    GtkTreeIter     iter;
+    gboolean        valid;
+    guint           i;
+
+    valid = gtk_tree_model_get_iter_first(model, &iter);
+    while (valid) {
+        object = nwamui_object_list_model_get_object(NWAMUI_OBJECT_LIST_MODEL(model), &iter);
+        if (g_strcmp0(nwamui_object_get_name(object), "home") == 0) {
+            home = object;
+            break;
+        }
+        g_object_unref(object);
+        valid = gtk_tree_model_iter_next(model, &iter);
+    }
+    g_assert(home != NULL);
+
+    for (i = 0; i < TEST_REPLAYS; i++) {
+        scan();
+        g_assert_cmpuint(rows.inserted, ==, 0);
+        g_assert_cmpuint(rows.deleted, ==, 0);
+        g_assert_cmpuint(rows.changed, ==, 0);
+    }
+    g_assert_cmpint(n_rows(), ==, 3);
+
+    /* The row of home kept its iter, a selection on it stays put. */
+    object = nwamui_object_list_model_get_object(NWAMUI_OBJECT_LIST_MODEL(model), &iter);
+    g_assert(object == home);
+    g_object_unref(object);
+    g_object_unref(home);
+}
+
+/* A new strength redraws the row of that network, not the others. */
+static void
+test_strength(void)
+{
+    set_scan_results(1, TRUE, FALSE);
+    scan();
+    g_assert_cmpuint(rows.inserted, ==, 0);
+    g_assert_cmpuint(rows.deleted, ==, 0);
+    g_assert_cmpuint(rows.changed, ==, 1);
+    g_assert_cmpstr(rows.changed_name, ==, "cafe");
+}
+
+static void
+test_appear_and_go(void)
+{
+    set_scan_results(3, TRUE, TRUE);
+    scan();
+    g_assert_cmpuint(rows.inserted, ==, 1);
+    g_assert_cmpuint(rows.deleted, ==, 0);
+    g_assert_cmpint(n_rows(), ==, 4);
+
+    set_scan_results(3, FALSE, FALSE);
+    scan();
+    g_assert_cmpuint(rows.inserted, ==, 0);
+    g_assert_cmpuint(rows.deleted, ==, 2);
+    g_assert_cmpint(n_rows(), ==, 2);
+}
+
+/* A refresh of the chooser only touches what differs, here nothing. */
+static void
+test_reload(void)
+{
+    reset_rows();
+    nwamui_object_list_model_reload(NWAMUI_OBJECT_LIST_MODEL(model));
+    nwam_test_iterate();
+    g_assert_cmpuint(rows.inserted, ==, 0);
+    g_assert_cmpuint(rows.deleted, ==, 0);
+    g_assert_cmpuint(rows.changed, ==, 0);
+}
+
+int
+main(int argc, char** argv)
+{
+    NwamuiObject   *ncp;
+    NwamuiObject   *ncu;
+    int             rval;
+
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    test_daemon = nwam_test_daemon_from_fixture("laptop.fixture");
+
+    ncp = nwamui_daemon_get_active_ncp(test_daemon);
+    ncu = nwamui_ncp_get_ncu_by_device_name(NWAMUI_NCP(ncp), DEVICE);
+    g_assert(ncu != NULL);
+    model = nwamui_object_list_model_new_for_wifi_nets(NWAMUI_NCU(ncu));
+    g_assert_cmpint(n_rows(), ==, 3);
+    g_signal_connect(model, "row-inserted", G_CALLBACK(row_inserted), NULL);
+    g_signal_connect(model, "row-deleted", G_CALLBACK(row_deleted), NULL);
+    g_signal_connect(model, "row-changed", G_CALLBACK(row_changed), NULL);
+
+    g_test_add_func("/scan-replay/replay", test_replay);
+    g_test_add_func("/scan-replay/strength", test_strength);
+    g_test_add_func("/scan-replay/appear-and-go", test_appear_and_go);
+    g_test_add_func("/scan-replay/reload", test_reload);
+
+    rval = g_test_run();
+
+    reset_rows();
+    g_object_unref(model);
+    g_object_unref(ncu);
+    g_object_unref(ncp);
+    return rval;
+}
@@ -0,0 +1,77 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_soak.c
+ *
+ * The events of a busy laptop replayed over tests/fixtures/laptop.fixture
+ * without leaking instances, run by make check. nwam-bench --soak runs it
+ * longer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+#define TEST_SOAK_ROUNDS    5
+#define TEST_SOAK_EVENTS    400
+
+static NwamuiDaemon *test_daemon = NULL;
+
+static void
+test_live_instances(void)
+{
+    GHashTable *live;
+    guint       changed;
+
+    g_assert(nwam_test_soak(test_daemon, TEST_SOAK_ROUNDS, TEST_SOAK_EVENTS, &changed));
+    g_assert_cmpuint(changed, ==, 0);
+
+    /* The objects are accounted, or nothing was checked. */
+    live = nwamui_instances_get_live_counts();
+    g_assert_cmpuint(g_hash_table_size(live), >, 0);
+    g_hash_table_destroy(live);
+}
+
+int
+main(int argc, char** argv)
+{
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    test_daemon = nwam_test_daemon_from_fixture("laptop.fixture");
+
+    g_test_add_func("/soak/live-instances", test_live_instances);
+
+    return g_test_run();
+}
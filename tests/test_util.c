@@ -0,0 +1,389 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_util.c
+ *
+ * Helpers for driving libnwamui against the fake backend.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#if defined(sun) || defined(__sun)
+#include <procfs.h>
+#else
+#include <sys/resource.h>
+#endif
+#include <glib.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+typedef struct {
+    GMainLoop      *loop;
+    GSourceFunc     check;
+    gpointer        data;
+    GTimer         *timer;
+    guint           timeout_secs;
+    gboolean        timed_out;
+} run_until_t;
+
+static gboolean
+run_until_check(gpointer user_data)
+{
+    run_until_t *run = (run_until_t *)user_data;
+
+    if (run->check(run->data)) {
+        g_main_loop_quit(run->loop);
+        return FALSE;
+    }
+    if (g_timer_elapsed(run->timer, NULL) > run->timeout_secs) {
+        run->timed_out = TRUE;
+        g_main_loop_quit(run->loop);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+extern gboolean
+nwam_test_run_until(GSourceFunc check, gpointer data, guint timeout_secs)
+{
+    run_until_t run;
+
+    if (check(data)) {
+        return TRUE;
+    }
+
+    run.loop = g_main_loop_new(NULL, FALSE);
+    run.check = check;
+    run.data = data;
+    run.timer = g_timer_new();
+    run.timeout_secs = timeout_secs;
+    run.timed_out = FALSE;
+
+    g_timeout_add(1, run_until_check, &run);
+    g_main_loop_run(run.loop);
+
+    g_main_loop_unref(run.loop);
+    g_timer_destroy(run.timer);
+
+    return !run.timed_out;
+}
+
+extern void
+nwam_test_iterate(void)
+{
+    while (g_main_context_iteration(NULL, FALSE))
+        ;
+}
+
+extern gchar*
+nwam_test_fixture_path(const gchar *name)
+{
+    const gchar *srcdir = g_getenv("srcdir");
+
+    return g_build_filename(srcdir ? srcdir : ".", "fixtures", name, NULL);
+}
+
+extern NwamuiDaemon*
+nwam_test_daemon_from_fixture(const gchar *name)
+{
+    NwamuiDaemon   *daemon;
+    gchar          *path = nwam_test_fixture_path(name);
+    GError         *err = NULL;
+    guint           target;
+
+    if (!nwam_fake_load_fixture(path, &err)) {
+        g_error("%s: %s", path, err->message);
+    }
+    g_free(path);
+
+    /* The ACTIVE queued on connect, then the script of the fixture. */
+    target = 1 + nwam_fake_get_queued_events();
+    daemon = nwamui_daemon_get_instance();
+    if (!nwam_test_wait_for_events(daemon, target)) {
+        g_error("Timed out waiting for the events of %s", name);
+    }
+    nwam_test_iterate();
+    return daemon;
+}
+
+extern guint
+nwam_test_lane_count(NwamuiDaemon *daemon)
+{
+    guint   total = 0;
+    guint   count;
+    gint    lane;
+
+    for (lane = 0; lane < NWAMUI_DAEMON_EVENT_LANE_LAST; lane++) {
+        nwamui_daemon_get_event_lane_stats(daemon, lane, &count, NULL, NULL);
+        total += count;
+    }
+    return total;
+}
+
+typedef struct {
+    NwamuiDaemon   *daemon;
+    guint           target;
+} events_wait_t;
+
+static gboolean
+events_handled(gpointer user_data)
+{
+    events_wait_t *wait = (events_wait_t *)user_data;
+
+    return nwam_test_lane_count(wait->daemon) >= wait->target;
+}
+
+/* Runs the main loop until @target events have been handled. */
+extern gboolean
+nwam_test_wait_for_events(NwamuiDaemon *daemon, guint target)
+{
+    events_wait_t   wait = { daemon, target };
+
+    if (!nwam_test_run_until(events_handled, &wait, NWAM_TEST_TIMEOUT_SECS)) {
+        fprintf(stderr, "Timed out, %u of %u events handled\n",
+          nwam_test_lane_count(daemon), target);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+typedef struct {
+    const gchar                *device;
+    nwamui_wifi_connect_stage_t stage;
+} stage_wait_t;
+
+static gboolean
+stage_reached(gpointer user_data)
+{
+    stage_wait_t *wait = (stage_wait_t *)user_data;
+
+    return nwamui_wifi_connect_get_stage(wait->device) >= wait->stage;
+}
+
+extern gboolean
+nwam_test_wait_for_stage(const gchar *device, nwamui_wifi_connect_stage_t stage)
+{
+    stage_wait_t    wait = { device, stage };
+
+    if (!nwam_test_run_until(stage_reached, &wait, NWAM_TEST_TIMEOUT_SECS)) {
+        fprintf(stderr, "Timed out waiting for %s on %s\n",
+          nwamui_wifi_connect_stage_to_string(stage), device);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void
+collect_device(gpointer data, gpointer user_data)
+{
+    GPtrArray  *devices = (GPtrArray *)user_data;
+
+    g_ptr_array_add(devices, nwamui_ncu_get_device_name(NWAMUI_NCU(data)));
+}
+
+/*
+ * Object state, link, interface and scan events over the devices of the
+ * active NCP, in the proportions of a busy wireless laptop.
+ */
+extern void
+nwam_test_queue_events(NwamuiDaemon *daemon, guint n)
+{
+    NwamuiObject   *ncp = nwamui_daemon_get_active_ncp(daemon);
+    GPtrArray      *devices = g_ptr_array_new();
+    gchar          *ncp_name = NULL;
+    guint           i;
+
+    if (ncp != NULL) {
+        nwamui_ncp_foreach_ncu(NWAMUI_NCP(ncp), collect_device, devices);
+        ncp_name = g_strdup(nwamui_object_get_name(ncp));
+        g_object_unref(ncp);
+    }
+
+    for (i = 0; i < n && devices->len > 0; i++) {
+        const gchar    *device = (const gchar *)g_ptr_array_index(devices, i % devices->len);
+        gchar          *typed;
+        gchar          *addr;
+
+        switch (i % 8) {
+        case 0:
+        case 1:
+        case 2:
+            typed = g_strconcat("link:", device, NULL);
+            nwam_fake_queue_object_state(NWAM_OBJECT_TYPE_NCU, ncp_name, typed,
+              i % 2 ? NWAM_STATE_ONLINE : NWAM_STATE_OFFLINE_TO_ONLINE,
+              i % 2 ? NWAM_AUX_STATE_UP : NWAM_AUX_STATE_LINK_WIFI_CONNECTING);
+            g_free(typed);
+            break;
+        case 3:
+        case 4:
+            nwam_fake_queue_link_state(device, i % 2);
+            break;
+        case 5:
+            addr = g_strdup_printf("10.%u.%u.%u", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+            (void) nwam_fake_queue_if_state(device, addr, 24);
+            g_free(addr);
+            break;
+        default:
+            nwam_fake_queue_scan_report(device);
+            break;
+        }
+    }
+    if (devices->len == 0) {
+        fprintf(stderr, "No NCUs in the active NCP, no events queued\n");
+    }
+
+    g_ptr_array_foreach(devices, (GFunc)g_free, NULL);
+    g_ptr_array_free(devices, TRUE);
+    g_free(ncp_name);
+}
+
+static void
+print_live_diff(gpointer key, gpointer value, gpointer user_data)
+{
+    GHashTable *baseline = (GHashTable *)user_data;
+    guint       before = GPOINTER_TO_UINT(g_hash_table_lookup(baseline, key));
+    guint       after = GPOINTER_TO_UINT(value);
+
+    if (before != after) {
+        printf("  %-32s %8u live, %u at baseline\n", (const gchar *)key, after, before);
+        g_hash_table_replace(baseline, key, GUINT_TO_POINTER(G_MAXUINT));
+    }
+}
+
+static void
+count_mismatch(gpointer key, gpointer value, gpointer user_data)
+{
+    if (GPOINTER_TO_UINT(value) == G_MAXUINT) {
+        (*(guint *)user_data)++;
+    }
+}
+
+/* Handles the events queued by a round, and whatever they left on idle. */
+static gboolean
+soak_round(NwamuiDaemon *daemon, guint n_events)
+{
+    guint   base = nwam_test_lane_count(daemon) + nwam_fake_get_queued_events();
+
+    nwam_test_queue_events(daemon, n_events);
+    if (!nwam_test_wait_for_events(daemon, base + n_events)) {
+        return FALSE;
+    }
+    nwamui_daemon_dispatch_wifi_scan_events_from_cache(daemon);
+    nwam_test_iterate();
+    return TRUE;
+}
+
+/*
+ * Every round replays the same events over the same objects, so once a
+ * warm-up round has created them the live instances must not change.
+ */
+extern gboolean
+nwam_test_soak(NwamuiDaemon *daemon, guint rounds, guint n_events, guint *changed)
+{
+    GHashTable *baseline;
+    GHashTable *live;
+    guint       i;
+
+    *changed = 0;
+    if (!soak_round(daemon, n_events)) {
+        return FALSE;
+    }
+    baseline = nwamui_instances_get_live_counts();
+
+    for (i = 0; i < rounds; i++) {
+        if (!soak_round(daemon, n_events)) {
+            g_hash_table_destroy(baseline);
+            return FALSE;
+        }
+    }
+
+    live = nwamui_instances_get_live_counts();
+    g_hash_table_foreach(live, print_live_diff, baseline);
+    g_hash_table_foreach(baseline, count_mismatch, changed);
+
+    g_hash_table_destroy(live);
+    g_hash_table_destroy(baseline);
+
+    return TRUE;
+}
+
+/* Resident set size of the process now, in KB, 0 if unknown. */
+extern gsize
+nwam_test_rss_kb(void)
+{
+    gsize           rss_kb = 0;
+#if defined(sun) || defined(__sun)
+    psinfo_t        psinfo;
+    int             fd;
+
+    if ((fd = open("/proc/self/psinfo", O_RDONLY)) >= 0) {
+        if (read(fd, &psinfo, sizeof (psinfo)) == sizeof (psinfo)) {
+            rss_kb = (gsize)psinfo.pr_rssize;
+        }
+        (void) close(fd);
+    }
+#else
+    FILE           *statm;
+    unsigned long   size;
+    unsigned long   resident;
+
+    if ((statm = fopen("/proc/self/statm", "r")) != NULL) {
+        if (fscanf(statm, "%lu %lu", &size, &resident) == 2) {
+            rss_kb = (gsize)resident * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+        (void) fclose(statm);
+    }
+#endif
+    return rss_kb;
+}
+
+/*
+ * Solaris only has the current size in /proc/self/psinfo, so the peak is
+ * that of the calls made, at the end of each phase. Elsewhere the kernel
+ * keeps the peak, in KB.
+ */
+extern gsize
+nwam_test_peak_rss_kb(void)
+{
+#if defined(sun) || defined(__sun)
+    static gsize    peak_rss_kb = 0;
+
+    peak_rss_kb = MAX(peak_rss_kb, nwam_test_rss_kb());
+    return peak_rss_kb;
+#else
+    struct rusage   usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (gsize)usage.ru_maxrss;
+#endif
+}
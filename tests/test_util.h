@@ -0,0 +1,85 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_util.h
+ *
+ */
+
+#ifndef _TEST_UTIL_H
+#define	_TEST_UTIL_H
+
+#include <glib.h>
+
+#include <libnwamui.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Shared by the make check programs and nwam-bench. They all run against
+ * the fake backend, fixtures are looked up in $srcdir/fixtures as set by
+ * the automake test driver.
+ */
+
+#define NWAM_TEST_TIMEOUT_SECS  60
+
+/* Runs the main loop until check returns TRUE, FALSE on timeout. */
+extern gboolean     nwam_test_run_until(GSourceFunc check, gpointer data,
+                                        guint timeout_secs);
+/* Dispatches whatever is pending, idles included. */
+extern void         nwam_test_iterate(void);
+
+extern gchar*       nwam_test_fixture_path(const gchar *name);
+/* Loads the fixture and waits for the daemon to handle its events. */
+extern NwamuiDaemon* nwam_test_daemon_from_fixture(const gchar *name);
+
+/* Events handled by all the lanes of the daemon. */
+extern guint        nwam_test_lane_count(NwamuiDaemon *daemon);
+extern gboolean     nwam_test_wait_for_events(NwamuiDaemon *daemon, guint target);
+/* Until the connection attempt on device waits for stage, or is over. */
+extern gboolean     nwam_test_wait_for_stage(const gchar *device,
+                                             nwamui_wifi_connect_stage_t stage);
+
+/*
+ * Object state, link, interface and scan events over the devices of the
+ * active NCP, in the proportions of a busy wireless laptop.
+ */
+extern void         nwam_test_queue_events(NwamuiDaemon *daemon, guint n);
+/* Replays n_events after a warm-up round, rounds times. The types whose
+ * live instances changed are listed on stdout and counted in changed.
+ * FALSE if the events timed out.
+ */
+extern gboolean     nwam_test_soak(NwamuiDaemon *daemon, guint rounds,
+                                   guint n_events, guint *changed);
+
+/* Peak resident set size of the process in KB, 0 if unknown. */
+extern gsize        nwam_test_peak_rss_kb(void);
+/* The same, now. */
+extern gsize        nwam_test_rss_kb(void);
+
+G_END_DECLS
+
+#endif	/* _TEST_UTIL_H */
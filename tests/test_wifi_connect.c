@@ -0,0 +1,164 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/* vim:set expandtab ts=4 shiftwidth=4: */
+
+/* 
+ * CDDL HEADER START
+ *
+ * The contents of this file are subject to the terms of the
+ * Common Development and Distribution License (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * You can obtain a copy of the license at usr/src/OPENSOLARIS.LICENSE
+ * or http://www.opensolaris.org/os/licensing.
+ * See the License for the specific language governing permissions
+ * and limitations under the License.
+ *
+ * When distributing Covered Code, include this CDDL HEADER in each
+ * file and include the License file at usr/src/OPENSOLARIS.LICENSE.
+ * If applicable, add the following below this CDDL HEADER, with the
+ * fields enclosed by brackets "[]" replaced with your own identifying
+ * information: Portions Copyright [yyyy] [name of copyright owner]
+ *
+ * CDDL HEADER END
+ */
+
+
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ *
+ * File:   test_wifi_connect.c
+ *
+ * Wireless connection attempts driven by the scripted events of the fake
+ * backend, run by make check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <libdlwlan.h>
+#include <glib.h>
+
+#include <libnwamui.h>
+
+#include "fake_backend.h"
+#include "test_util.h"
+
+#define DEVICE          "wpi0"
+
+static NwamuiDaemon *test_daemon = NULL;
+
+static guint
+attempts(guint *failed)
+{
+    guint   count;
+
+    nwamui_wifi_connect_get_stage_stats(NWAMUI_WIFI_CONNECT_STAGE_LAST,
+      &count, failed, NULL, NULL);
+    return count;
+}
+
+/* The link and the address nwamd would report once associated. */
+static void
+bring_up(void)
+{
+    g_assert(nwam_test_wait_for_stage(DEVICE, NWAMUI_WIFI_CONNECT_STAGE_LINK_UP));
+    g_assert_cmpint(nwamui_wifi_connect_get_stage(DEVICE), ==, NWAMUI_WIFI_CONNECT_STAGE_LINK_UP);
+    nwam_fake_queue_link_state(DEVICE, TRUE);
+
+    g_assert(nwam_test_wait_for_stage(DEVICE, NWAMUI_WIFI_CONNECT_STAGE_ADDRESS));
+    g_assert_cmpint(nwamui_wifi_connect_get_stage(DEVICE), ==, NWAMUI_WIFI_CONNECT_STAGE_ADDRESS);
+    g_assert(nwam_fake_queue_if_state(DEVICE, "10.1.0.5", 24));
+
+    g_assert(nwam_test_wait_for_stage(DEVICE, NWAMUI_WIFI_CONNECT_STAGE_LAST));
+}
+
+static void
+test_open(void)
+{
+    guint   done = attempts(NULL);
+
+    nwamui_wifi_connect_start(DEVICE, "cafe", DLADM_WLAN_SECMODE_NONE, FALSE);
+    bring_up();
+
+    g_assert_cmpuint(attempts(NULL), ==, done + 1);
+}
+
+/*
+ * nwamd asks for the key of a network it doesn't know, the attempt waits
+ * for it; selected again without one it asks again. With the key set the
+ * next select connects, the earlier tries are neither done nor failed.
+ */
+static void
+test_need_key(void)
+{
+    guint   failed;
+    guint   done = attempts(&failed);
+    guint   base = nwam_test_lane_count(test_daemon) + nwam_fake_get_queued_events();
+    guint   keys;
+    guint   now_keys;
+    guint   now_failed;
+
+    nwamui_wifi_connect_start(DEVICE, "neighbour", DLADM_WLAN_SECMODE_WEP, FALSE);
+    g_assert(nwam_test_wait_for_events(test_daemon, base + 1));
+    g_assert(nwam_test_wait_for_stage(DEVICE, NWAMUI_WIFI_CONNECT_STAGE_KEY));
+    g_assert_cmpint(nwamui_wifi_connect_get_stage(DEVICE), ==, NWAMUI_WIFI_CONNECT_STAGE_KEY);
+
+    nwamui_wifi_connect_start(DEVICE, "neighbour", DLADM_WLAN_SECMODE_WEP, FALSE);
+    g_assert(nwam_test_wait_for_events(test_daemon, base + 2));
+    g_assert(nwam_test_wait_for_stage(DEVICE, NWAMUI_WIFI_CONNECT_STAGE_KEY));
+    g_assert_cmpint(nwamui_wifi_connect_get_stage(DEVICE), ==, NWAMUI_WIFI_CONNECT_STAGE_KEY);
+
+    /* As the key dialog does, the key then the select, which times the
+     * attempt again so the key is set outside of it. */
+    nwamui_wifi_connect_get_stage_stats(NWAMUI_WIFI_CONNECT_STAGE_KEY, &keys, NULL, NULL, NULL);
+    nwamui_wifi_connect_store_key(DEVICE, "neighbour", DLADM_WLAN_SECMODE_WEP, 1, "secret");
+    nwamui_wifi_connect_start(DEVICE, "neighbour", DLADM_WLAN_SECMODE_WEP, FALSE);
+    bring_up();
+
+    g_assert_cmpuint(attempts(&now_failed), ==, done + 1);
+    g_assert_cmpuint(now_failed, ==, failed);
+    nwamui_wifi_connect_get_stage_stats(NWAMUI_WIFI_CONNECT_STAGE_KEY, &now_keys, NULL, NULL, NULL);
+    g_assert_cmpuint(now_keys, ==, keys + 1);
+}
+
+/*
+ * Another network cancels the attempt, the results of its calls are
+ * ignored: nwamd asking for the key of the first is not for the second.
+ */
+static void
+test_supersede(void)
+{
+    guint   failed;
+    guint   done = attempts(&failed);
+    guint   now_failed;
+
+    nwamui_wifi_connect_start(DEVICE, "neighbour", DLADM_WLAN_SECMODE_WEP, FALSE);
+    nwamui_wifi_connect_start(DEVICE, "cafe", DLADM_WLAN_SECMODE_NONE, FALSE);
+    bring_up();
+
+    g_assert_cmpuint(attempts(&now_failed), ==, done + 1);
+    g_assert_cmpuint(now_failed, ==, failed + 1);
+}
+
+int
+main(int argc, char** argv)
+{
+    int     rval;
+
+    g_thread_init( NULL );
+    g_type_init();
+    g_test_init(&argc, &argv, NULL);
+
+    test_daemon = nwam_test_daemon_from_fixture("laptop.fixture");
+
+    g_test_add_func("/wifi-connect/open", test_open);
+    g_test_add_func("/wifi-connect/supersede", test_supersede);
+    g_test_add_func("/wifi-connect/need-key", test_need_key);
+
+    rval = g_test_run();
+
+    /* Nothing is left in flight once the daemon is gone. */
+    g_object_unref(test_daemon);
+    g_assert_cmpint(nwamui_wifi_connect_get_stage(DEVICE), ==, NWAMUI_WIFI_CONNECT_STAGE_LAST);
+
+    return rval;
+}